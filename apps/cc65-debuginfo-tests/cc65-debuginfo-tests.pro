@@ -0,0 +1,53 @@
+#-------------------------------------------------
+#
+# Benchmark for the IDE's cc65 debug information lookups.
+#
+#-------------------------------------------------
+
+QT = core
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TOP = ../..
+
+macx {
+    QMAKE_MAC_SDK = macosx10.14
+}
+
+CONFIG(release, debug|release) {
+   DESTDIR = release
+} else {
+   DESTDIR = debug
+}
+
+# Remove crap we do not need!
+CONFIG -= rtti exceptions
+
+OBJECTS_DIR = $$DESTDIR
+MOC_DIR = $$DESTDIR
+RCC_DIR = $$DESTDIR
+UI_DIR = $$DESTDIR
+
+TARGET = "cc65-debuginfo-tests"
+
+TEMPLATE = app
+
+win32 {
+   QMAKE_LFLAGS += -static-libgcc
+}
+
+INCLUDEPATH += \
+   $$TOP/common \
+   $$TOP/libs/nes \
+   $$TOP/libs/nes/common \
+   $$TOP/libs/nes/emulator \
+   $$TOP/apps/ide/compilers/cc65
+
+# Only the debug information half of CCC65Interface is built; the class is
+# never instantiated so its header is left out of HEADERS to keep it from
+# being run through moc.
+SOURCES += \
+   main.cpp \
+   $$TOP/apps/ide/compilers/cc65/ccc65debuginfo.cpp \
+   $$TOP/apps/ide/compilers/cc65/dbginfo.c
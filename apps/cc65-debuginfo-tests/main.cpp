@@ -0,0 +1,137 @@
+#include <QElapsedTimer>
+#include <QString>
+
+#include <stdio.h>
+
+#include "ccc65interface.h"
+
+// The debug information and the lookup tables built from it are protected;
+// the benchmark reaches them the way a derived class would.
+class DebugInfoBenchmark : public CCC65Interface
+{
+public:
+   static bool run ( const char* fileName );
+};
+
+static void errorFunc ( const struct cc65_parseerror* E )
+{
+   fprintf(stderr,"%s(%lu): %s - %s\n",
+           E->name,
+           (unsigned long) E->line,
+           E->type? "Error" : "Warning",
+           E->errormsg);
+}
+
+// Reads a .dbg file and times building the lookup tables from it and then
+// the lookups the debugger models make as they repaint: every byte of every
+// NES PRG-ROM span by address, every file:line and every symbol.
+bool DebugInfoBenchmark::run ( const char* fileName )
+{
+   QHash<quint64,LineEntry>::const_iterator line;
+   QHash<QString,SymbolEntry>::const_iterator symbol;
+   QElapsedTimer timer;
+   qint64 readTime;
+   qint64 indexTime;
+   qint64 lookupTime;
+   uint32_t addr;
+   uint32_t absAddr;
+   int rows;
+   int span;
+   int sum = 0;
+
+   printf("%s\n",fileName);
+
+   timer.start();
+   dbgInfo = cc65_read_dbginfo(fileName,errorFunc);
+   readTime = timer.nsecsElapsed();
+
+   if ( dbgInfo == 0 )
+   {
+      printf("   cannot read\n");
+      return false;
+   }
+
+   timer.restart();
+   indexDebugInfo();
+   indexTime = timer.nsecsElapsed();
+
+   printf("   read %.1f ms, indexed %d spans, %d lines and %d symbols in %.1f ms\n",
+          readTime/1000000.0,spanTable.count(),lineTable.count(),symbolTable.count(),
+          indexTime/1000000.0);
+
+   // What the code browser asks for each row it shows.
+   rows = 0;
+   timer.restart();
+   for ( span = 0; span < spanTable.count(); span++ )
+   {
+      const SpanEntry& dbgSpan = spanTable.at(span);
+
+      if ( dbgSpan.hasSegment && dbgSpan.hasOutputName )
+      {
+         for ( addr = dbgSpan.spanStart; addr <= dbgSpan.spanEnd; addr++ )
+         {
+            absAddr = dbgSpan.outputOffs-0x10+(addr-dbgSpan.segmentStart);
+            sum += nesGetSourceLineFromAbsoluteAddress(addr,absAddr);
+            sum += nesGetSourceFileFromAbsoluteAddress(addr,absAddr).length();
+            sum += nesIsAbsoluteAddressAnOpcode(absAddr);
+            rows++;
+         }
+      }
+   }
+   lookupTime = timer.nsecsElapsed();
+   printf("   address lookups    %6d rows  %6.2f us/row\n",rows,rows?lookupTime/1000.0/rows:0.0);
+
+   // What the code editor asks for each line it shows.
+   rows = 0;
+   timer.restart();
+   for ( line = lineTable.constBegin(); line != lineTable.constEnd(); ++line )
+   {
+      QString file = sourceNames.value(line.key()>>32);
+
+      sum += getLineMatchCount(file,(quint32)line.key());
+      sum += nesGetAbsoluteAddressFromFileAndLine(file,(quint32)line.key());
+      rows++;
+   }
+   lookupTime = timer.nsecsElapsed();
+   printf("   file:line lookups  %6d rows  %6.2f us/row\n",rows,rows?lookupTime/1000.0/rows:0.0);
+
+   // What the symbol watch asks for each symbol it shows.
+   rows = 0;
+   timer.restart();
+   for ( symbol = symbolTable.constBegin(); symbol != symbolTable.constEnd(); ++symbol )
+   {
+      sum += getSymbolMatchCount(symbol.key());
+      sum += nesGetSymbolAbsoluteAddress(symbol.key());
+      sum += getSourceLineFromFileAndSymbol(getSourceFileFromSymbol(symbol.key()),symbol.key());
+      rows++;
+   }
+   lookupTime = timer.nsecsElapsed();
+   printf("   symbol lookups     %6d rows  %6.2f us/row  (checksum %d)\n",
+          rows,rows?lookupTime/1000.0/rows:0.0,sum);
+
+   clearDebugInfoIndex();
+   cc65_free_dbginfo(dbgInfo);
+   dbgInfo = 0;
+
+   return true;
+}
+
+int main(int argc, char* argv[])
+{
+   bool failed = false;
+   int arg;
+
+   if ( argc < 2 )
+   {
+      printf("usage: cc65-debuginfo-tests <file.dbg> ...\n\n"
+             "   Times indexing cc65 debug information and the debuggers' lookups on it.\n");
+      return 1;
+   }
+
+   for ( arg = 1; arg < argc; arg++ )
+   {
+      failed |= !DebugInfoBenchmark::run(argv[arg]);
+   }
+
+   return failed ? 1 : 0;
+}
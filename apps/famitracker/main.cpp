@@ -1,14 +1,108 @@
 #include <QApplication>
+#include <QElapsedTimer>
 #include "mainwindow.h"
 
+#include "cqtmfc_famitracker.h"
+
 #include "Source/FamiTracker.h"
+#include "Source/FamiTrackerDoc.h"
+#include "Source/FamiTrackerView.h"
+#include "Source/PatternEditor.h"
+
+#include <stdio.h>
+
+// Window size the repaint benchmark runs at, about what the tracker gets
+// on a 1080p desktop.  Keep it fixed so runs can be compared.
+#define BENCHMARK_WIDTH  1280
+#define BENCHMARK_HEIGHT 800
+
+// Repaints the pattern editor at a fixed window size through the same
+// paint event the window system sends, first redrawing the whole pattern
+// each time and then only moving the cursor, and prints the average time
+// per repaint.  Runs without a display with QT_QPA_PLATFORM=offscreen.
+//
+// famitracker --benchmark-repaint [repaints] [module.ftm]
+static int benchmarkRepaint(MainWindow* w, int repaints, QString module)
+{
+    CFamiTrackerView* pView;
+    CPatternEditor* pEditor;
+    QElapsedTimer timer;
+    qint64 fullTime;
+    qint64 cursorTime;
+    int repaint;
+
+    if ( !module.isEmpty() )
+    {
+        if ( !AfxGetApp()->OpenDocumentFile(module.toLatin1().constData()) )
+        {
+            printf("cannot open %s\n",module.toLatin1().constData());
+            return 1;
+        }
+    }
+
+    w->resize(BENCHMARK_WIDTH,BENCHMARK_HEIGHT);
+    QApplication::processEvents();
+
+    pView = CFamiTrackerView::GetView();
+    if ( !pView )
+    {
+        printf("no pattern editor\n");
+        return 1;
+    }
+    pEditor = pView->GetPatternEditor();
+
+    // Warm up: the first paint makes the buffers and lays out the fonts.
+    pView->toQWidget()->repaint();
+
+    timer.start();
+    for ( repaint = 0; repaint < repaints; repaint++ )
+    {
+        pEditor->InvalidateBackground();
+        pEditor->InvalidatePatternData();
+        pView->toQWidget()->repaint();
+    }
+    fullTime = timer.nsecsElapsed();
+
+    timer.restart();
+    for ( repaint = 0; repaint < repaints; repaint++ )
+    {
+        pEditor->InvalidateCursor();
+        pView->toQWidget()->repaint();
+    }
+    cursorTime = timer.nsecsElapsed();
+
+    printf("window %dx%d, pattern view %dx%d\n",
+           w->width(),w->height(),
+           pView->toQWidget()->width(),pView->toQWidget()->height());
+    printf("full redraw    %8.1f us/repaint\n",fullTime/1000.0/repaints);
+    printf("cursor redraw  %8.1f us/repaint\n",cursorTime/1000.0/repaints);
+
+    return 0;
+}
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
     MainWindow w;
+    QStringList args = a.arguments();
+    int benchmark = args.indexOf("--benchmark-repaint");
 
     w.show();
 
+    if ( benchmark >= 0 )
+    {
+        int repaints = 200;
+        int result;
+
+        if ( args.value(benchmark+1).toInt() > 0 )
+        {
+            repaints = args.value(++benchmark).toInt();
+        }
+        result = benchmarkRepaint(&w,repaints,args.value(benchmark+1));
+
+        theApp.ExitInstance();
+        return result;
+    }
+
     return a.exec();
 }
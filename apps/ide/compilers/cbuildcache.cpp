@@ -0,0 +1,421 @@
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegExp>
+#include <QTextStream>
+
+#include "cbuildcache.h"
+
+#include "cnesicideproject.h"
+#include "cbuildertextlogger.h"
+
+#include "main.h"
+
+QHash<QString,CBuildCache::FileEntry> CBuildCache::files;
+QMutex                                CBuildCache::filesMutex(QMutex::Recursive);
+QList<CBuildCache::ObjectEntry>       CBuildCache::objects;
+
+const CBuildCache::FileEntry* CBuildCache::fileEntry(QString fileName)
+{
+   QFileInfo fileInfo(fileName);
+   QString   path = fileInfo.absoluteFilePath();
+   QFile     file(path);
+   QHash<QString,FileEntry>::iterator cached;
+   FileEntry entry;
+   QRegExp   cInclude("^\\s*#\\s*include\\s*[\"<]([^\">]+)[\">]");
+   QRegExp   asmInclude("^\\s*\\.(include|incbin)\\s+\"([^\"]+)\"",Qt::CaseInsensitive);
+   QByteArray content;
+   QStringList lines;
+
+   if ( !fileInfo.exists() )
+   {
+      return NULL;
+   }
+
+   // Files are only read again once they've changed.
+   cached = files.find(path);
+   if ( (cached != files.end()) &&
+        (cached->modified == fileInfo.lastModified()) &&
+        (cached->size == fileInfo.size()) )
+   {
+      return &(*cached);
+   }
+
+   if ( !file.open(QIODevice::ReadOnly) )
+   {
+      return NULL;
+   }
+   content = file.readAll();
+   file.close();
+
+   entry.modified = fileInfo.lastModified();
+   entry.size = fileInfo.size();
+   entry.hash = QCryptographicHash::hash(content,QCryptographicHash::Sha1);
+
+   lines = QString(content).split(QRegExp("[\r\n]"),QString::SkipEmptyParts);
+   foreach ( const QString& line, lines )
+   {
+      if ( cInclude.indexIn(line) >= 0 )
+      {
+         entry.includes.append(cInclude.cap(1));
+      }
+      else if ( asmInclude.indexIn(line) >= 0 )
+      {
+         entry.includes.append(asmInclude.cap(2));
+      }
+   }
+
+   return &(*files.insert(path,entry));
+}
+
+QByteArray CBuildCache::fileHash(QString fileName)
+{
+   QMutexLocker locker(&filesMutex);
+   const FileEntry* entry = fileEntry(fileName);
+
+   if ( entry )
+   {
+      return entry->hash;
+   }
+   return QByteArray();
+}
+
+void CBuildCache::addDependencies(QString fileName,const QStringList& includePaths,QStringList& dependencies)
+{
+   QMutexLocker locker(&filesMutex);
+   const FileEntry* entry = fileEntry(fileName);
+   QDir        baseDir(QDir::currentPath());
+   QStringList searchPaths;
+   QStringList includes;
+   QString     dependency;
+
+   if ( !entry )
+   {
+      return;
+   }
+
+   // Included files are looked for next to the including file, then where
+   // the build is run, then on the include paths.  Anything not found is
+   // part of the toolchain, which the flags already stand for.
+   searchPaths.append(QFileInfo(fileName).path());
+   searchPaths.append(".");
+   searchPaths += includePaths;
+
+   includes = entry->includes;
+   foreach ( const QString& include, includes )
+   {
+      foreach ( const QString& searchPath, searchPaths )
+      {
+         QFileInfo fileInfo(QDir(searchPath).filePath(include));
+
+         if ( fileInfo.exists() )
+         {
+            dependency = baseDir.fromNativeSeparators(baseDir.relativeFilePath(fileInfo.absoluteFilePath()));
+            if ( !dependencies.contains(dependency) )
+            {
+               dependencies.append(dependency);
+               addDependencies(dependency,includePaths,dependencies);
+            }
+            break;
+         }
+      }
+   }
+}
+
+QByteArray CBuildCache::objectKey(QString source,QString flags)
+{
+   QCryptographicHash key(QCryptographicHash::Sha1);
+   QRegExp     includePath("(?:-I|--include-dir)\\s*(\\S+)");
+   QStringList includePaths;
+   QStringList dependencies;
+   int         pos = 0;
+
+   while ( (pos = includePath.indexIn(flags,pos)) >= 0 )
+   {
+      includePaths.append(includePath.cap(1));
+      pos += includePath.matchedLength();
+   }
+
+   addDependencies(source,includePaths,dependencies);
+   dependencies.sort();
+
+   // The source's name goes into the object's debug information, so it's
+   // part of the key along with its contents.
+   key.addData(source.toUtf8());
+   key.addData(fileHash(source));
+   key.addData(flags.toUtf8());
+   foreach ( const QString& dependency, dependencies )
+   {
+      key.addData(dependency.toUtf8());
+      key.addData(fileHash(dependency));
+   }
+   return key.result();
+}
+
+QList<CBuildCache::ObjectEntry> CBuildCache::objectsFor(QStringList cSources,QString cFlags,QStringList asmSources,QString asmFlags)
+{
+   QString            objectDir = QDir::fromNativeSeparators(nesicideProject->getProjectOutputBasePath());
+   QList<ObjectEntry> entries;
+   ObjectEntry        entry;
+
+   // Objects are named as the makefile names them.
+   foreach ( const QString& source, cSources )
+   {
+      entry.object = objectDir+"/"+QFileInfo(source).completeBaseName()+".o";
+      entry.key = objectKey(source,cFlags);
+      entry.clang = true;
+      entry.state = Object_Build;
+      entries.append(entry);
+   }
+   foreach ( const QString& source, asmSources )
+   {
+      entry.object = objectDir+"/"+QFileInfo(source).completeBaseName()+".o";
+      entry.key = objectKey(source,asmFlags);
+      entry.clang = false;
+      entry.state = Object_Build;
+      entries.append(entry);
+   }
+   return entries;
+}
+
+QByteArray CBuildCache::programKey(const QList<ObjectEntry>& objects,QString linkerConfig,QString linkerFlags)
+{
+   QCryptographicHash key(QCryptographicHash::Sha1);
+
+   foreach ( const ObjectEntry& entry, objects )
+   {
+      key.addData(entry.object.toUtf8());
+      key.addData(entry.key);
+   }
+   key.addData(linkerConfig.toUtf8());
+   key.addData(fileHash(linkerConfig));
+   key.addData(linkerFlags.toUtf8());
+   return key.result();
+}
+
+QString CBuildCache::cacheDir()
+{
+   return QDir::fromNativeSeparators(nesicideProject->getProjectOutputBasePath())+"/.buildcache";
+}
+
+QString CBuildCache::manifestName()
+{
+   return QDir::fromNativeSeparators(nesicideProject->getProjectOutputBasePath())+"/nesicide.cache";
+}
+
+QHash<QString,QByteArray> CBuildCache::readManifest()
+{
+   QHash<QString,QByteArray> manifest;
+   QFile   file(manifestName());
+   QString line;
+   int     split;
+
+   if ( file.open(QIODevice::ReadOnly|QIODevice::Text) )
+   {
+      QTextStream stream(&file);
+
+      // Each line is a key in hex followed by the output it was built for.
+      while ( !stream.atEnd() )
+      {
+         line = stream.readLine();
+         split = line.indexOf(' ');
+         if ( split > 0 )
+         {
+            manifest.insert(line.mid(split+1),QByteArray::fromHex(line.left(split).toLatin1()));
+         }
+      }
+      file.close();
+   }
+   return manifest;
+}
+
+void CBuildCache::writeManifest(const QHash<QString,QByteArray>& manifest)
+{
+   QFile file(manifestName());
+   QHash<QString,QByteArray>::const_iterator entry;
+
+   QDir().mkpath(QFileInfo(file).path());
+   if ( file.open(QIODevice::WriteOnly|QIODevice::Truncate|QIODevice::Text) )
+   {
+      QTextStream stream(&file);
+
+      for ( entry = manifest.constBegin(); entry != manifest.constEnd(); ++entry )
+      {
+         stream << entry.value().toHex() << " " << entry.key() << "\n";
+      }
+      file.close();
+   }
+}
+
+// Copies a file by writing its contents, so the copy is newer than the
+// sources make compares it with.
+static bool copyContent(QString from,QString to)
+{
+   QFile fromFile(from);
+   QFile toFile(to);
+
+   if ( !fromFile.open(QIODevice::ReadOnly) )
+   {
+      return false;
+   }
+   if ( !toFile.open(QIODevice::WriteOnly|QIODevice::Truncate) )
+   {
+      return false;
+   }
+   return toFile.write(fromFile.readAll()) == fromFile.size();
+}
+
+QStringList CBuildCache::prepare(QStringList cSources,QString cFlags,QStringList asmSources,QString asmFlags)
+{
+   QHash<QString,QByteArray> manifest = readManifest();
+   QStringList upToDate;
+   QString     cached;
+   int         idx;
+
+   objects = objectsFor(cSources,cFlags,asmSources,asmFlags);
+
+   QDir().mkpath(QDir::fromNativeSeparators(nesicideProject->getProjectOutputBasePath()));
+
+   for ( idx = 0; idx < objects.count(); idx++ )
+   {
+      ObjectEntry& entry = objects[idx];
+
+      cached = cacheDir()+"/"+entry.key.toHex()+".o";
+
+      if ( (manifest.value(entry.object) == entry.key) &&
+           (QFile::exists(entry.object)) )
+      {
+         entry.state = Object_UpToDate;
+         upToDate.append(entry.object);
+      }
+      else if ( (QFile::exists(cached)) &&
+                (copyContent(cached,entry.object)) &&
+                ((!entry.clang) || (copyContent(cached.left(cached.length()-2)+".s",entry.object.left(entry.object.length()-2)+".s"))) )
+      {
+         entry.state = Object_Restored;
+         manifest.insert(entry.object,entry.key);
+      }
+      else
+      {
+         // make only compares times with the source, so an object that is
+         // stale because of an included file has to go for it to be rebuilt.
+         entry.state = Object_Build;
+         QFile::remove(entry.object);
+         manifest.remove(entry.object);
+      }
+   }
+
+   writeManifest(manifest);
+
+   return upToDate;
+}
+
+void CBuildCache::commit(QString program,QString linkerConfig,QString linkerFlags)
+{
+   QHash<QString,QByteArray> manifest = readManifest();
+   QString cached;
+
+   QDir().mkpath(cacheDir());
+
+   foreach ( const ObjectEntry& entry, objects )
+   {
+      if ( (entry.state == Object_Build) &&
+           (QFile::exists(entry.object)) )
+      {
+         cached = cacheDir()+"/"+entry.key.toHex()+".o";
+         copyContent(entry.object,cached);
+         if ( entry.clang )
+         {
+            copyContent(entry.object.left(entry.object.length()-2)+".s",cached.left(cached.length()-2)+".s");
+         }
+         manifest.insert(entry.object,entry.key);
+      }
+   }
+   manifest.insert(program,programKey(objects,linkerConfig,linkerFlags));
+
+   writeManifest(manifest);
+
+   pruneCache();
+}
+
+void CBuildCache::pruneCache()
+{
+   QDir dir(cacheDir());
+   QFileInfoList entries = dir.entryInfoList(QStringList("*.o"),QDir::Files,QDir::Time);
+   int idx;
+
+   // Newest first, so the objects least recently built go.
+   for ( idx = BUILD_CACHE_MAX_ENTRIES; idx < entries.count(); idx++ )
+   {
+      QFile::remove(entries.at(idx).filePath());
+      QFile::remove(dir.filePath(entries.at(idx).completeBaseName()+".s"));
+   }
+}
+
+void CBuildCache::report()
+{
+   int upToDate = 0;
+   int restored = 0;
+   int built = 0;
+
+   foreach ( const ObjectEntry& entry, objects )
+   {
+      switch ( entry.state )
+      {
+      case Object_UpToDate:
+         upToDate++;
+         break;
+      case Object_Restored:
+         restored++;
+         break;
+      case Object_Build:
+         built++;
+         break;
+      }
+   }
+
+   if ( objects.count() )
+   {
+      buildTextLogger->write("<b>Build cache: "+QString::number(upToDate)+" of "+QString::number(objects.count())+" objects up to date, "+
+                             QString::number(restored)+" restored from cache, "+QString::number(built)+" built ("+
+                             QString::number(((upToDate+restored)*100)/objects.count())+"% served from cache).</b>");
+   }
+}
+
+bool CBuildCache::isUpToDate(QStringList cSources,QString cFlags,QStringList asmSources,QString asmFlags,
+                             QString program,QString linkerConfig,QString linkerFlags)
+{
+   QHash<QString,QByteArray> manifest = readManifest();
+   QList<ObjectEntry> current = objectsFor(cSources,cFlags,asmSources,asmFlags);
+
+   foreach ( const ObjectEntry& entry, current )
+   {
+      if ( (manifest.value(entry.object) != entry.key) ||
+           (!QFile::exists(entry.object)) )
+      {
+         return false;
+      }
+   }
+
+   return QFile::exists(program) &&
+          (manifest.value(program) == programKey(current,linkerConfig,linkerFlags));
+}
+
+void CBuildCache::clean()
+{
+   QFile::remove(manifestName());
+}
+
+QByteArray CBuildCache::recordedKey(QString output)
+{
+   return readManifest().value(output);
+}
+
+void CBuildCache::recordKey(QString output,QByteArray key)
+{
+   QHash<QString,QByteArray> manifest = readManifest();
+
+   manifest.insert(output,key);
+   writeManifest(manifest);
+}
@@ -0,0 +1,96 @@
+#ifndef CBUILDCACHE_H
+#define CBUILDCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+
+// Maximum number of objects kept in the build cache.
+#define BUILD_CACHE_MAX_ENTRIES 512
+
+// The build cache keeps track of what each output of a build was built
+// from, so builds only redo what has actually changed.
+//
+// Each object is keyed by a hash of its source, the sources it includes
+// (found by scanning for include directives, so headers are tracked even
+// though the generated makefile doesn't use the compiler's dependency
+// files) and the flags it's built with.  An object whose key matches the
+// one it was last built with is left alone.  Otherwise it's restored from
+// the cache if it has been built with that key before, or built again.
+// Keys for the program (objects plus linker configuration) and for other
+// outputs such as CHR-ROM are kept the same way, in a manifest in the
+// project's output directory.
+class CBuildCache
+{
+public:
+   // Works out the state of each object before make is run, restoring
+   // objects from the cache and removing stale ones so make rebuilds them.
+   // Returns the objects make should not touch.
+   static QStringList prepare(QStringList cSources,QString cFlags,QStringList asmSources,QString asmFlags);
+
+   // After a successful build, stores the objects that were built in the
+   // cache and records what the program was built from.
+   static void commit(QString program,QString linkerConfig,QString linkerFlags);
+
+   // Logs how much of the last build was served from the cache.
+   static void report();
+
+   // Whether the program is built from the current sources, flags and
+   // linker configuration.
+   static bool isUpToDate(QStringList cSources,QString cFlags,QStringList asmSources,QString asmFlags,
+                          QString program,QString linkerConfig,QString linkerFlags);
+
+   // Forgets what the outputs were built from; cached objects are kept.
+   static void clean();
+
+   // The key an output other than an object was last built with, and
+   // recording a new one.
+   static QByteArray recordedKey(QString output);
+   static void recordKey(QString output,QByteArray key);
+
+protected:
+   typedef struct
+   {
+      QDateTime   modified;
+      qint64      size;
+      QByteArray  hash;
+      QStringList includes;
+   } FileEntry;
+
+   typedef enum
+   {
+      Object_UpToDate,
+      Object_Restored,
+      Object_Build
+   } ObjectState;
+
+   typedef struct
+   {
+      QString     object;
+      QByteArray  key;
+      bool        clang;
+      ObjectState state;
+   } ObjectEntry;
+
+   static const FileEntry* fileEntry(QString fileName);
+   static QByteArray fileHash(QString fileName);
+   static void addDependencies(QString fileName,const QStringList& includePaths,QStringList& dependencies);
+   static QByteArray objectKey(QString source,QString flags);
+   static QList<ObjectEntry> objectsFor(QStringList cSources,QString cFlags,QStringList asmSources,QString asmFlags);
+   static QByteArray programKey(const QList<ObjectEntry>& objects,QString linkerConfig,QString linkerFlags);
+   static QString cacheDir();
+   static QString manifestName();
+   static QHash<QString,QByteArray> readManifest();
+   static void writeManifest(const QHash<QString,QByteArray>& manifest);
+   static void pruneCache();
+
+   static QHash<QString,FileEntry> files;
+   static QMutex                   filesMutex;
+   static QList<ObjectEntry>       objects;
+};
+
+#endif // CBUILDCACHE_H
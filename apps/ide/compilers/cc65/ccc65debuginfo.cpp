@@ -0,0 +1,1051 @@
+#include <QDir>
+
+#include "ccc65interface.h"
+
+#include "nes_emulator_core.h"
+
+// The debug information read from a build and the lookup tables built from
+// it.  These are kept apart from the build and project code so they can be
+// built on their own, as the benchmark in apps/cc65-debuginfo-tests does.
+cc65_dbginfo        CCC65Interface::dbgInfo = NULL;
+QString             CCC65Interface::targetMachine = "none";
+
+QVector<CCC65Interface::SpanEntry>           CCC65Interface::spanTable;
+QVector<CCC65Interface::AddressRange>        CCC65Interface::addressRanges;
+QVector<int>                                 CCC65Interface::spanPool;
+QHash<unsigned,QString>                      CCC65Interface::sourceNames;
+QHash<QString,unsigned>                      CCC65Interface::sourceIds;
+QHash<quint64,CCC65Interface::LineEntry>     CCC65Interface::lineTable;
+QHash<QString,CCC65Interface::SymbolEntry>   CCC65Interface::symbolTable;
+QHash<unsigned,CCC65Interface::SegmentEntry> CCC65Interface::segmentTable;
+
+// This utility compares two file paths regardless of original slashery.
+bool fileNamesAreIdentical(QString file1, QString file2)
+{
+   file1 = QDir::fromNativeSeparators(file1);
+   file2 = QDir::fromNativeSeparators(file2);
+   return ( file1 == file2 );
+}
+
+static quint64 lineKey(unsigned source_id,int source_line)
+{
+   return (((quint64)source_id)<<32)|((quint32)source_line);
+}
+
+void CCC65Interface::clearDebugInfoIndex()
+{
+   spanTable.clear();
+   addressRanges.clear();
+   spanPool.clear();
+   sourceNames.clear();
+   sourceIds.clear();
+   lineTable.clear();
+   symbolTable.clear();
+   segmentTable.clear();
+}
+
+void CCC65Interface::indexDebugInfo()
+{
+   const cc65_segmentinfo* dbgSegments;
+   const cc65_sourceinfo* dbgSources;
+   const cc65_spaninfo* dbgSpans;
+   const cc65_lineinfo* dbgLines;
+   const cc65_lineinfo* dbgLine;
+   const cc65_symbolinfo* dbgSymbols;
+   const cc65_symbolinfo* dbgSymbol;
+   QHash<unsigned,int> spanIndex;
+   QHash<unsigned,QString>::const_iterator source;
+   QVector<int> spans;
+   QVector<int> lastSpans;
+   QString name;
+   uint32_t addr;
+   unsigned id;
+   int idx;
+   int line;
+   int span;
+
+   clearDebugInfoIndex();
+
+   if ( !dbgInfo )
+   {
+      return;
+   }
+
+   dbgSegments = cc65_get_segmentlist(dbgInfo);
+   if ( dbgSegments )
+   {
+      for ( idx = 0; idx < dbgSegments->count; idx++ )
+      {
+         SegmentEntry segment;
+
+         segment.name = dbgSegments->data[idx].segment_name;
+         segment.start = dbgSegments->data[idx].segment_start;
+         segment.hasOutputName = (dbgSegments->data[idx].output_name != NULL);
+         segment.outputOffs = dbgSegments->data[idx].output_offs;
+         segmentTable.insert(dbgSegments->data[idx].segment_id,segment);
+      }
+
+      cc65_free_segmentinfo(dbgInfo,dbgSegments);
+   }
+
+   // Files are matched by name with the first one of that name winning.
+   dbgSources = cc65_get_sourcelist(dbgInfo);
+   if ( dbgSources )
+   {
+      for ( idx = 0; idx < dbgSources->count; idx++ )
+      {
+         name = QDir::fromNativeSeparators(dbgSources->data[idx].source_name);
+         sourceNames.insert(dbgSources->data[idx].source_id,name);
+         if ( !sourceIds.contains(name) )
+         {
+            sourceIds.insert(name,dbgSources->data[idx].source_id);
+         }
+      }
+
+      cc65_free_sourceinfo(dbgInfo,dbgSources);
+   }
+
+   dbgSpans = cc65_get_spanlist(dbgInfo);
+   if ( dbgSpans )
+   {
+      spanTable.reserve(dbgSpans->count);
+      for ( idx = 0; idx < dbgSpans->count; idx++ )
+      {
+         SpanEntry entry;
+
+         entry.spanStart = dbgSpans->data[idx].span_start;
+         entry.spanEnd = dbgSpans->data[idx].span_end;
+         entry.lineCount = dbgSpans->data[idx].line_count;
+
+         dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[idx].segment_id);
+         entry.hasSegment = dbgSegments && (dbgSegments->count == 1);
+         entry.segmentStart = 0;
+         entry.segmentSize = 0;
+         entry.hasOutputName = false;
+         entry.outputOffs = 0;
+         if ( entry.hasSegment )
+         {
+            entry.segmentStart = dbgSegments->data[0].segment_start;
+            entry.segmentSize = dbgSegments->data[0].segment_size;
+            entry.hasOutputName = (dbgSegments->data[0].output_name != NULL);
+            entry.outputOffs = dbgSegments->data[0].output_offs;
+         }
+         if ( dbgSegments )
+         {
+            cc65_free_segmentinfo(dbgInfo,dbgSegments);
+         }
+
+         dbgLines = cc65_line_byspan(dbgInfo,dbgSpans->data[idx].span_id);
+         entry.hasLines = dbgLines && (dbgLines->count > 0);
+         entry.lineType = -1;
+         entry.sourceId = CC65_INV_ID;
+         entry.sourceLine = -1;
+         if ( entry.hasLines )
+         {
+            for ( line = 0; line < dbgLines->count; line++ )
+            {
+               if ( (int)dbgLines->data[line].line_type >= entry.lineType )
+               {
+                  entry.lineType = dbgLines->data[line].line_type;
+                  entry.sourceId = dbgLines->data[line].source_id;
+                  entry.sourceLine = dbgLines->data[line].source_line;
+               }
+            }
+         }
+         if ( dbgLines )
+         {
+            cc65_free_lineinfo(dbgInfo,dbgLines);
+         }
+
+         spanIndex.insert(dbgSpans->data[idx].span_id,spanTable.count());
+         spanTable.append(entry);
+      }
+
+      cc65_free_spaninfo(dbgInfo,dbgSpans);
+   }
+
+   // Neighbouring addresses are mostly covered by the same spans, so the
+   // address table only records where the list of spans changes.
+   for ( addr = 0; addr < MEM_64KB; addr++ )
+   {
+      spans.clear();
+
+      dbgSpans = cc65_span_byaddr(dbgInfo,addr);
+      if ( dbgSpans )
+      {
+         for ( idx = 0; idx < dbgSpans->count; idx++ )
+         {
+            span = spanIndex.value(dbgSpans->data[idx].span_id,-1);
+            if ( span >= 0 )
+            {
+               spans.append(span);
+            }
+         }
+
+         cc65_free_spaninfo(dbgInfo,dbgSpans);
+      }
+
+      if ( (addr == 0) || (spans != lastSpans) )
+      {
+         AddressRange range;
+
+         range.start = addr;
+         range.first = spanPool.count();
+         range.count = spans.count();
+         addressRanges.append(range);
+         spanPool += spans;
+         lastSpans = spans;
+      }
+   }
+   AddressRange end;
+   end.start = MEM_64KB;
+   end.first = spanPool.count();
+   end.count = 0;
+   addressRanges.append(end);
+
+   for ( source = sourceNames.constBegin(); source != sourceNames.constEnd(); ++source )
+   {
+      dbgLines = cc65_line_bysource(dbgInfo,source.key());
+      if ( dbgLines )
+      {
+         for ( idx = 0; idx < dbgLines->count; idx++ )
+         {
+            quint64 key = lineKey(source.key(),dbgLines->data[idx].source_line);
+
+            if ( lineTable.contains(key) )
+            {
+               continue;
+            }
+
+            dbgLine = cc65_line_bynumber(dbgInfo,source.key(),dbgLines->data[idx].source_line);
+            if ( dbgLine && (dbgLine->count == 1) )
+            {
+               dbgSpans = cc65_span_byline(dbgInfo,dbgLine->data[0].line_id);
+
+               if ( dbgSpans )
+               {
+                  LineEntry entry;
+
+                  entry.lineType = dbgLine->data[0].line_type;
+                  for ( span = 0; span < dbgSpans->count; span++ )
+                  {
+                     entry.spans.append(spanIndex.value(dbgSpans->data[span].span_id,-1));
+                  }
+                  lineTable.insert(key,entry);
+
+                  cc65_free_spaninfo(dbgInfo,dbgSpans);
+               }
+            }
+            if ( dbgLine )
+            {
+               cc65_free_lineinfo(dbgInfo,dbgLine);
+            }
+         }
+
+         cc65_free_lineinfo(dbgInfo,dbgLines);
+      }
+   }
+
+   // Walk the symbols by id to find their names, then ask for each name
+   // once so the symbols with that name are in the order dbginfo gives.
+   for ( id = 0; (dbgSymbol = cc65_symbol_byid(dbgInfo,id)) != NULL; id++ )
+   {
+      name = QString::fromLatin1(dbgSymbol->data[0].symbol_name);
+
+      if ( !symbolTable.contains(name) )
+      {
+         dbgSymbols = cc65_symbol_byname(dbgInfo,dbgSymbol->data[0].symbol_name);
+
+         if ( dbgSymbols )
+         {
+            SymbolEntry entry;
+
+            entry.definitionLine = -1;
+            for ( idx = 0; idx < dbgSymbols->count; idx++ )
+            {
+               entry.symbols.append(dbgSymbols->data[idx]);
+               if ( dbgSymbols->data[idx].export_id == CC65_INV_ID )
+               {
+                  entry.definitions.append(idx);
+               }
+            }
+
+            if ( entry.definitions.count() )
+            {
+               dbgLines = cc65_line_bysymdef(dbgInfo,entry.symbols.at(entry.definitions.at(0)).symbol_id);
+
+               if ( dbgLines && (dbgLines->count == 1) &&
+                    sourceNames.contains(dbgLines->data[0].source_id) )
+               {
+                  entry.definitionFile = sourceNames.value(dbgLines->data[0].source_id);
+                  entry.definitionLine = dbgLines->data[0].source_line;
+               }
+               if ( dbgLines )
+               {
+                  cc65_free_lineinfo(dbgInfo,dbgLines);
+               }
+            }
+
+            symbolTable.insert(name,entry);
+
+            cc65_free_symbolinfo(dbgInfo,dbgSymbols);
+         }
+      }
+
+      cc65_free_symbolinfo(dbgInfo,dbgSymbol);
+   }
+}
+
+int CCC65Interface::spansAtAddress(uint32_t addr,const int** spans)
+{
+   int low = 0;
+   int high = addressRanges.count()-1;
+   int mid;
+
+   if ( (high < 0) || (addr >= MEM_64KB) )
+   {
+      return 0;
+   }
+
+   // Find the last range starting at or before the address.
+   while ( low < high )
+   {
+      mid = (low+high+1)>>1;
+      if ( addressRanges.at(mid).start <= addr )
+      {
+         low = mid;
+      }
+      else
+      {
+         high = mid-1;
+      }
+   }
+
+   (*spans) = spanPool.constData()+addressRanges.at(low).first;
+   return addressRanges.at(low).count;
+}
+
+// Of the spans at a virtual address whose segment holds the absolute
+// address, the one with the highest type of line.
+int CCC65Interface::lineSpanAtAbsoluteAddress(uint32_t addr,uint32_t absAddr,bool nes)
+{
+   const int* spans;
+   int count;
+   int span;
+   int highestTypeMatch = 0;
+   int indexOfHighestTypeMatch = -1;
+   bool inSegment;
+
+   count = spansAtAddress(addr,&spans);
+   for ( span = 0; span < count; span++ )
+   {
+      const SpanEntry& dbgSpan = spanTable.at(spans[span]);
+
+      if ( dbgSpan.lineCount && dbgSpan.hasSegment && dbgSpan.hasLines )
+      {
+         if ( !nes )
+         {
+            inSegment = (absAddr >= dbgSpan.segmentStart) &&
+                        (absAddr < (dbgSpan.segmentStart+dbgSpan.segmentSize));
+         }
+         else if ( dbgSpan.hasOutputName )
+         {
+            inSegment = (absAddr >= dbgSpan.outputOffs-0x10) &&
+                        (absAddr < (dbgSpan.outputOffs-0x10+dbgSpan.segmentSize));
+         }
+         else
+         {
+            inSegment = (absAddr >= dbgSpan.outputOffs) &&
+                        (absAddr < (dbgSpan.outputOffs+dbgSpan.segmentSize));
+         }
+
+         if ( inSegment && (dbgSpan.lineType >= highestTypeMatch) )
+         {
+            highestTypeMatch = dbgSpan.lineType;
+            indexOfHighestTypeMatch = spans[span];
+         }
+      }
+   }
+
+   return indexOfHighestTypeMatch;
+}
+
+// Of the spans at a virtual address that themselves cover the absolute
+// address, the one with the highest type of line.
+int CCC65Interface::endSpanAtAbsoluteAddress(uint32_t addr,uint32_t absAddr,bool nes)
+{
+   const int* spans;
+   int count;
+   int span;
+   int highestTypeMatch = 0;
+   int indexOfHighestTypeMatch = -1;
+   bool inSpan;
+
+   count = spansAtAddress(addr,&spans);
+   for ( span = 0; span < count; span++ )
+   {
+      const SpanEntry& dbgSpan = spanTable.at(spans[span]);
+
+      if ( dbgSpan.hasSegment && dbgSpan.hasLines )
+      {
+         if ( !nes )
+         {
+            inSpan = (absAddr >= dbgSpan.segmentStart+(dbgSpan.spanStart-dbgSpan.segmentStart)) &&
+                     (absAddr <= dbgSpan.segmentStart+(dbgSpan.spanEnd-dbgSpan.segmentStart));
+         }
+         else if ( dbgSpan.hasOutputName )
+         {
+            inSpan = (absAddr >= dbgSpan.outputOffs+(dbgSpan.spanStart-dbgSpan.segmentStart)-0x10) &&
+                     (absAddr <= dbgSpan.outputOffs+(dbgSpan.spanEnd-dbgSpan.segmentStart)-0x10);
+         }
+         else
+         {
+            inSpan = (absAddr >= dbgSpan.outputOffs+(dbgSpan.spanStart-dbgSpan.segmentStart)) &&
+                     (absAddr <= dbgSpan.outputOffs+(dbgSpan.spanEnd-dbgSpan.segmentStart));
+         }
+
+         if ( inSpan && (dbgSpan.lineType >= highestTypeMatch) )
+         {
+            highestTypeMatch = dbgSpan.lineType;
+            indexOfHighestTypeMatch = spans[span];
+         }
+      }
+   }
+
+   return indexOfHighestTypeMatch;
+}
+
+const CCC65Interface::LineEntry* CCC65Interface::lineEntryFromFileAndLine(QString file,int source_line)
+{
+   QHash<QString,unsigned>::const_iterator source;
+   QHash<quint64,LineEntry>::const_iterator line;
+
+   source = sourceIds.constFind(QDir::fromNativeSeparators(file));
+   if ( source == sourceIds.constEnd() )
+   {
+      return NULL;
+   }
+
+   line = lineTable.constFind(lineKey(source.value(),source_line));
+   if ( line == lineTable.constEnd() )
+   {
+      return NULL;
+   }
+
+   return &(line.value());
+}
+
+// The span of the given entry of a file:line, or the last one if there
+// aren't that many.
+int CCC65Interface::spanFromFileAndLine(QString file,int source_line,int entry)
+{
+   const LineEntry* line;
+
+   line = lineEntryFromFileAndLine(file,source_line);
+   if ( (!line) || line->spans.isEmpty() )
+   {
+      return -1;
+   }
+
+   if ( (entry >= 0) && (entry < line->spans.count()) )
+   {
+      return line->spans.at(entry);
+   }
+   return line->spans.last();
+}
+
+// Looking a symbol up by name gets all the def and ref entries for the
+// symbol; index counts only the defs.
+const cc65_symboldata* CCC65Interface::symbolDefinition(QString symbol,int index)
+{
+   QHash<QString,SymbolEntry>::const_iterator entry = symbolTable.constFind(symbol);
+
+   if ( (entry == symbolTable.constEnd()) ||
+        (index < 0) || (index >= entry->definitions.count()) )
+   {
+      return NULL;
+   }
+
+   return &(entry->symbols.at(entry->definitions.at(index)));
+}
+
+QStringList CCC65Interface::getSourceFiles()
+{
+   const cc65_sourceinfo* dbgSources;
+   QStringList files;
+   int file;
+
+   if ( dbgInfo )
+   {
+      dbgSources = cc65_get_sourcelist(dbgInfo);
+
+      if ( dbgSources )
+      {
+         for ( file = 0; file < dbgSources->count; file++ )
+         {
+            files.append(QDir::fromNativeSeparators(dbgSources->data[file].source_name));
+         }
+
+         cc65_free_sourceinfo(dbgInfo,dbgSources);
+      }
+   }
+   return files;
+}
+
+uint32_t CCC65Interface::getSegmentBase(QString segment)
+{
+   const cc65_segmentinfo* dbgSegments;
+   int seg;
+   int addr = -1;
+
+   if ( dbgInfo )
+   {
+      dbgSegments = cc65_get_segmentlist(dbgInfo);
+      if ( dbgSegments )
+      {
+         for ( seg = 0; seg < dbgSegments->count; seg++ )
+         {
+            if ( dbgSegments->data[seg].segment_name == segment )
+            {
+               addr = dbgSegments->data[seg].segment_start;
+            }
+         }
+
+         cc65_free_segmentinfo(dbgInfo,dbgSegments);
+      }
+   }
+
+   return addr;
+}
+
+unsigned int CCC65Interface::getSourceFileModificationTime(QString sourceFile)
+{
+   const cc65_sourceinfo* dbgSources;
+   unsigned int mtime = -1;
+   int file;
+
+   if ( dbgInfo )
+   {
+      dbgSources = cc65_get_sourcelist(dbgInfo);
+
+      if ( dbgSources )
+      {
+         for ( file = 0; file < dbgSources->count; file++ )
+         {
+            if ( fileNamesAreIdentical(dbgSources->data[file].source_name,sourceFile) )
+            {
+               mtime = dbgSources->data[file].source_mtime;
+               break;
+            }
+         }
+
+         cc65_free_sourceinfo(dbgInfo,dbgSources);
+      }
+   }
+   return mtime;
+}
+
+QStringList CCC65Interface::getSymbolsForSourceFile(QString /*sourceFile*/)
+{
+   const cc65_symbolinfo* dbgSymbols;
+   QStringList symbols;
+   int sym;
+
+   if ( dbgInfo )
+   {
+      dbgSymbols = cc65_symbol_inrange(dbgInfo,0,0xFFFF);
+
+      if ( dbgSymbols )
+      {
+         for ( sym = 0; sym < dbgSymbols->count; sym++ )
+         {
+            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
+            {
+               symbols.append(dbgSymbols->data[sym].symbol_name);
+            }
+         }
+
+         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
+      }
+   }
+   return symbols;
+}
+
+cc65_symbol_type CCC65Interface::getSymbolType(QString symbol, int index)
+{
+   QHash<QString,SymbolEntry>::const_iterator entry = symbolTable.constFind(symbol);
+   cc65_symbol_type type = (cc65_symbol_type)CC65_INV_ID;
+
+   if ( (entry != symbolTable.constEnd()) &&
+        (index >= 0) && (index < entry->symbols.count()) )
+   {
+      type = entry->symbols.at(index).symbol_type;
+   }
+   return type;
+}
+
+unsigned int CCC65Interface::getSymbolAddress(QString symbol, int index)
+{
+   const cc65_symboldata* dbgSymbol;
+   unsigned int addr = 0xFFFFFFFF;
+
+   dbgSymbol = symbolDefinition(symbol,index);
+   if ( dbgSymbol )
+   {
+      addr = dbgSymbol->symbol_value;
+   }
+   return addr;
+}
+
+unsigned int CCC65Interface::getSymbolAbsoluteAddress(QString symbol, int index)
+{
+   // Dispatch to appropriate target machine handler.
+   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
+   {
+      return nesGetSymbolAbsoluteAddress(symbol,index);
+   }
+   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
+   {
+      return c64GetSymbolAbsoluteAddress(symbol,index);
+   }
+}
+
+unsigned int CCC65Interface::nesGetSymbolAbsoluteAddress(QString symbol, int index)
+{
+   const cc65_symboldata* dbgSymbol;
+   QHash<unsigned,SegmentEntry>::const_iterator segment;
+   unsigned int addr;
+   unsigned int absAddr = 0xFFFFFFFF;
+   unsigned int addrOffset;
+
+   dbgSymbol = symbolDefinition(symbol,index);
+   if ( dbgSymbol )
+   {
+      addr = dbgSymbol->symbol_value;
+
+      if ( dbgSymbol->segment_id != CC65_INV_ID )
+      {
+         segment = segmentTable.constFind(dbgSymbol->segment_id);
+
+         if ( segment != segmentTable.constEnd() )
+         {
+            addrOffset = addr-segment->start;
+            absAddr = segment->outputOffs+addrOffset;
+         }
+      }
+   }
+   return absAddr;
+}
+
+unsigned int CCC65Interface::c64GetSymbolAbsoluteAddress(QString symbol, int index)
+{
+   const cc65_symboldata* dbgSymbol;
+   QHash<unsigned,SegmentEntry>::const_iterator segment;
+   unsigned int addr;
+   unsigned int absAddr = 0xFFFFFFFF;
+   unsigned int addrOffset;
+
+   dbgSymbol = symbolDefinition(symbol,index);
+   if ( dbgSymbol )
+   {
+      addr = dbgSymbol->symbol_value;
+
+      if ( dbgSymbol->segment_id != CC65_INV_ID )
+      {
+         segment = segmentTable.constFind(dbgSymbol->segment_id);
+
+         if ( segment != segmentTable.constEnd() )
+         {
+            addrOffset = addr-segment->start;
+            absAddr = segment->start+addrOffset;
+         }
+      }
+   }
+   return absAddr;
+}
+
+unsigned int CCC65Interface::getSymbolSegment(QString symbol, int index)
+{
+   const cc65_symboldata* dbgSymbol;
+   unsigned int seg = 0;
+
+   dbgSymbol = symbolDefinition(symbol,index);
+   if ( dbgSymbol )
+   {
+      seg = dbgSymbol->segment_id;
+   }
+   return seg;
+}
+
+QString CCC65Interface::getSymbolSegmentName(QString symbol, int index)
+{
+   const cc65_symboldata* dbgSymbol;
+   QHash<unsigned,SegmentEntry>::const_iterator segment;
+   QString seg = "?";
+
+   dbgSymbol = symbolDefinition(symbol,index);
+   if ( dbgSymbol && (dbgSymbol->segment_id != CC65_INV_ID) )
+   {
+      segment = segmentTable.constFind(dbgSymbol->segment_id);
+
+      if ( segment != segmentTable.constEnd() )
+      {
+         seg = segment->name;
+      }
+   }
+   return seg;
+}
+
+unsigned int CCC65Interface::getSymbolIndexFromSegment(QString symbol, int segment)
+{
+   QHash<QString,SymbolEntry>::const_iterator entry = symbolTable.constFind(symbol);
+   unsigned int index = 0;
+   int idx;
+
+   if ( entry != symbolTable.constEnd() )
+   {
+      for ( idx = 0; idx < entry->symbols.count(); idx++ )
+      {
+         if ( entry->symbols.at(idx).segment_id == segment )
+         {
+            index = idx;
+            break;
+         }
+      }
+   }
+   return index;
+}
+
+unsigned int CCC65Interface::getSymbolSize(QString symbol, int index)
+{
+   const cc65_symboldata* dbgSymbol;
+   unsigned int size = 0;
+
+   dbgSymbol = symbolDefinition(symbol,index);
+   if ( dbgSymbol )
+   {
+      size = dbgSymbol->symbol_size;
+   }
+   return size;
+}
+
+int CCC65Interface::getSymbolMatchCount(QString symbol)
+{
+   QHash<QString,SymbolEntry>::const_iterator entry = symbolTable.constFind(symbol);
+   int count = 0;
+
+   if ( entry != symbolTable.constEnd() )
+   {
+      count = entry->definitions.count();
+   }
+   return count;
+}
+
+QString CCC65Interface::getSourceFileFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
+{
+   // Dispatch to appropriate target machine handler.
+   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
+   {
+      return QDir::fromNativeSeparators(nesGetSourceFileFromAbsoluteAddress(addr,absAddr));
+   }
+   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
+   {
+      return QDir::fromNativeSeparators(c64GetSourceFileFromAbsoluteAddress(addr,absAddr));
+   }
+}
+
+QString CCC65Interface::nesGetSourceFileFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
+{
+   int span;
+   QString file = "";
+
+   span = lineSpanAtAbsoluteAddress(addr,absAddr,true);
+   if ( span >= 0 )
+   {
+      file = sourceNames.value(spanTable.at(span).sourceId);
+   }
+   return file;
+}
+
+QString CCC65Interface::c64GetSourceFileFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
+{
+   int span;
+   QString file = "";
+
+   span = lineSpanAtAbsoluteAddress(addr,absAddr,false);
+   if ( span >= 0 )
+   {
+      file = sourceNames.value(spanTable.at(span).sourceId);
+   }
+   return file;
+}
+
+int CCC65Interface::getSourceLineFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
+{
+   // Dispatch to appropriate target machine handler.
+   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
+   {
+      return nesGetSourceLineFromAbsoluteAddress(addr,absAddr);
+   }
+   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
+   {
+      return c64GetSourceLineFromAbsoluteAddress(addr,absAddr);
+   }
+}
+
+int CCC65Interface::nesGetSourceLineFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
+{
+   int span;
+   int source_line = -1;
+
+   span = lineSpanAtAbsoluteAddress(addr,absAddr,true);
+   if ( span >= 0 )
+   {
+      source_line = spanTable.at(span).sourceLine;
+   }
+   return source_line;
+}
+
+int CCC65Interface::c64GetSourceLineFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
+{
+   int span;
+   int source_line = -1;
+
+   span = lineSpanAtAbsoluteAddress(addr,absAddr,false);
+   if ( span >= 0 )
+   {
+      source_line = spanTable.at(span).sourceLine;
+   }
+   return source_line;
+}
+
+QString CCC65Interface::getSourceFileFromSymbol(QString symbol)
+{
+   QHash<QString,SymbolEntry>::const_iterator entry = symbolTable.constFind(symbol);
+   QString file = "";
+
+   if ( entry != symbolTable.constEnd() )
+   {
+      file = entry->definitionFile;
+   }
+
+   return file;
+}
+
+int CCC65Interface::getSourceLineFromFileAndSymbol(QString file,QString symbol)
+{
+   QHash<QString,SymbolEntry>::const_iterator entry = symbolTable.constFind(symbol);
+   int source_line = -1;
+
+   if ( (entry != symbolTable.constEnd()) &&
+        (entry->definitionLine >= 0) &&
+        fileNamesAreIdentical(entry->definitionFile,file) )
+   {
+      source_line = entry->definitionLine;
+   }
+
+   return source_line;
+}
+
+int CCC65Interface::getLineMatchCount(QString file, int source_line)
+{
+   const LineEntry* line;
+   int count = 0;
+
+   line = lineEntryFromFileAndLine(file,source_line);
+   if ( line )
+   {
+      count = line->spans.count();
+   }
+
+   return count;
+}
+
+unsigned int CCC65Interface::getAddressFromFileAndLine(QString file,int source_line,int entry)
+{
+   int span;
+   int addr = -1;
+
+   span = spanFromFileAndLine(file,source_line,entry);
+   if ( span >= 0 )
+   {
+      addr = spanTable.at(span).spanStart;
+   }
+   return addr;
+}
+
+unsigned int CCC65Interface::getAbsoluteAddressFromFileAndLine(QString file,int source_line,int entry)
+{
+   // Dispatch to appropriate target machine handler.
+   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
+   {
+      return nesGetAbsoluteAddressFromFileAndLine(file,source_line,entry);
+   }
+   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
+   {
+      return c64GetAbsoluteAddressFromFileAndLine(file,source_line,entry);
+   }
+}
+
+unsigned int CCC65Interface::nesGetAbsoluteAddressFromFileAndLine(QString file,int source_line,int entry)
+{
+   int span;
+   int absAddr = -1;
+
+   span = spanFromFileAndLine(file,source_line,entry);
+   if ( (span >= 0) && spanTable.at(span).hasSegment )
+   {
+      const SpanEntry& dbgSpan = spanTable.at(span);
+
+      if ( dbgSpan.hasOutputName )
+      {
+         absAddr = dbgSpan.outputOffs+(dbgSpan.spanStart-dbgSpan.segmentStart)-0x10;
+      }
+      else
+      {
+         absAddr = dbgSpan.outputOffs+(dbgSpan.spanStart-dbgSpan.segmentStart);
+      }
+   }
+   return absAddr;
+}
+
+unsigned int CCC65Interface::c64GetAbsoluteAddressFromFileAndLine(QString file,int source_line,int entry)
+{
+   int span;
+   int absAddr = -1;
+
+   span = spanFromFileAndLine(file,source_line,entry);
+   if ( (span >= 0) && spanTable.at(span).hasSegment )
+   {
+      const SpanEntry& dbgSpan = spanTable.at(span);
+
+      absAddr = dbgSpan.segmentStart+(dbgSpan.spanStart-dbgSpan.segmentStart);
+   }
+   return absAddr;
+}
+
+unsigned int CCC65Interface::getEndAddressFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
+{
+   // Dispatch to appropriate target machine handler.
+   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
+   {
+      return nesGetEndAddressFromAbsoluteAddress(addr,absAddr);
+   }
+   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
+   {
+      return c64GetEndAddressFromAbsoluteAddress(addr,absAddr);
+   }
+}
+
+unsigned int CCC65Interface::nesGetEndAddressFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
+{
+   int span;
+   int endAddr = -1;
+
+   span = endSpanAtAbsoluteAddress(addr,absAddr,true);
+   if ( span >= 0 )
+   {
+      endAddr = spanTable.at(span).spanEnd;
+   }
+
+   return endAddr;
+}
+
+unsigned int CCC65Interface::c64GetEndAddressFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
+{
+   int span;
+   int endAddr = -1;
+
+   span = endSpanAtAbsoluteAddress(addr,absAddr,false);
+   if ( span >= 0 )
+   {
+      endAddr = spanTable.at(span).spanEnd;
+   }
+
+   return endAddr;
+}
+
+bool CCC65Interface::isAbsoluteAddressAnOpcode(uint32_t absAddr)
+{
+   // Dispatch to appropriate target machine handler.
+   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
+   {
+      return nesIsAbsoluteAddressAnOpcode(absAddr);
+   }
+   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
+   {
+      return c64IsAbsoluteAddressAnOpcode(absAddr);
+   }
+   return false;
+}
+
+bool CCC65Interface::nesIsAbsoluteAddressAnOpcode(uint32_t absAddr)
+{
+   const int* spans;
+   uint32_t addr;
+   int      count;
+   int      span;
+   bool     opcode = false;
+
+   // Make addresses for where code might be in PRG-ROM space.
+   addr = (absAddr&MASK_8KB);
+   for ( ; addr < MEM_64KB; addr += MEM_8KB )
+   {
+      count = spansAtAddress(addr,&spans);
+
+      for ( span = 0; span < count; span++ )
+      {
+         const SpanEntry& dbgSpan = spanTable.at(spans[span]);
+
+         if ( dbgSpan.hasSegment )
+         {
+            if ( dbgSpan.hasOutputName )
+            {
+               if ( absAddr == dbgSpan.outputOffs+(dbgSpan.spanStart-dbgSpan.segmentStart)-0x10 )
+               {
+                  opcode = true;
+               }
+            }
+            else
+            {
+               if ( absAddr == dbgSpan.outputOffs+(dbgSpan.spanStart-dbgSpan.segmentStart) )
+               {
+                  opcode = true;
+               }
+            }
+         }
+      }
+   }
+
+   return opcode;
+}
+
+bool CCC65Interface::c64IsAbsoluteAddressAnOpcode(uint32_t absAddr)
+{
+   const int* spans;
+   int      count;
+   int      span;
+   bool     opcode = false;
+
+   count = spansAtAddress(absAddr,&spans);
+
+   for ( span = 0; span < count; span++ )
+   {
+      const SpanEntry& dbgSpan = spanTable.at(spans[span]);
+
+      if ( dbgSpan.hasSegment )
+      {
+         if ( absAddr == dbgSpan.segmentStart+(dbgSpan.spanStart-dbgSpan.segmentStart) )
+         {
+            opcode = true;
+         }
+      }
+   }
+
+   return opcode;
+}
+
+bool CCC65Interface::isStringASymbol(QString string)
+{
+   return symbolTable.contains(string);
+}
@@ -1,4 +1,7 @@
+#include <QThread>
+
 #include "ccc65interface.h"
+#include "cbuildcache.h"
 
 #include "cnesicideproject.h"
 #include "iprojecttreeviewitem.h"
@@ -7,29 +10,32 @@
 
 #include "main.h"
 
-cc65_dbginfo        CCC65Interface::dbgInfo = NULL;
 QStringList         CCC65Interface::errors;
-QString             CCC65Interface::targetMachine = "none";
 
-// This utility compares two file paths regardless of original slashery.
-bool fileNamesAreIdentical(QString file1, QString file2)
-{
-   file1 = QDir::fromNativeSeparators(file1);
-   file2 = QDir::fromNativeSeparators(file2);
-   return ( file1 == file2 );
-}
+QList<QPair<QString,int> > CCC65Interface::buildTimes;
+QHash<QString,qint64>      CCC65Interface::buildStarts;
+QElapsedTimer              CCC65Interface::buildTimer;
+
+// The target rules announce when they start and finish building a source
+// so each source's build can be timed, even with several built at once.
+#define BUILD_STARTED  "nesicide-build-started:"
+#define BUILD_FINISHED "nesicide-build-finished:"
 
 static const char* clangTargetRuleFmt =
       "vpath %<!extension!> $(foreach <!extension!>,$(SOURCES),$(dir $<!extension!>))\r\n\r\n"
       "$(OBJDIR)/%.o: %.<!extension!>\r\n"
+      "\t@echo " BUILD_STARTED " $<\r\n"
       "\t$(COMPILE) --create-dep $(@:.o=.d) -S $(CFLAGS) -o $(@:.o=.s) $<\r\n"
-      "\t$(ASSEMBLE) $(ASFLAGS) -o $@ $(@:.o=.s)\r\n\r\n"
+      "\t$(ASSEMBLE) $(ASFLAGS) -o $@ $(@:.o=.s)\r\n"
+      "\t@echo " BUILD_FINISHED " $<\r\n\r\n"
       ;
 
 static const char* asmTargetRuleFmt =
       "vpath %<!extension!> $(foreach <!extension!>,$(SOURCES),$(dir $<!extension!>))\r\n\r\n"
       "$(OBJDIR)/%.o: %.<!extension!>\r\n"
-      "\t$(ASSEMBLE) $(ASFLAGS) -o $@ $<\r\n\r\n"
+      "\t@echo " BUILD_STARTED " $<\r\n"
+      "\t$(ASSEMBLE) $(ASFLAGS) -o $@ $<\r\n"
+      "\t@echo " BUILD_FINISHED " $<\r\n\r\n"
       ;
 
 CCC65Interface::CCC65Interface()
@@ -48,6 +54,7 @@ void CCC65Interface::updateTargetMachine(QString target)
 
 void CCC65Interface::clear()
 {
+   clearDebugInfoIndex();
    cc65_free_dbginfo(dbgInfo);
    dbgInfo = 0;
 }
@@ -242,104 +249,225 @@ bool CCC65Interface::createMakefile()
 }
 
 void CCC65Interface::clean()
+{
+   // Clear the error storage.
+   errors.clear();
+
+   createMakefile();
+
+   make("clean",1);
+
+   CBuildCache::clean();
+}
+
+// Splits off the complete lines in buffer, or all of them if the output
+// is finished, leaving any partial line for the next read.
+static QStringList takeLines(QString& buffer,bool finished)
+{
+   QStringList lines;
+   int end;
+
+   if ( finished )
+   {
+      lines = buffer.split(QRegExp("[\r\n]"),QString::SkipEmptyParts);
+      buffer.clear();
+   }
+   else
+   {
+      end = buffer.lastIndexOf(QRegExp("[\r\n]"));
+      if ( end >= 0 )
+      {
+         lines = buffer.left(end).split(QRegExp("[\r\n]"),QString::SkipEmptyParts);
+         buffer.remove(0,end+1);
+      }
+   }
+   return lines;
+}
+
+static bool slowestFirst(const QPair<QString,int>& time1,const QPair<QString,int>& time2)
+{
+   return time1.second > time2.second;
+}
+
+int CCC65Interface::make(QString target,int jobs)
 {
    QProcess                     make;
    QStringList                  env = QProcess::systemEnvironment();
    QString                      invocationStr;
-   QString                      stdioStr;
+   QString                      stdoutStr;
+   QString                      stderrStr;
    QStringList                  stdioList;
-   int                          exitCode;
+   bool                         finished;
+   int                          idx;
 
    // Copy the system environment to the child process.
    make.setEnvironment(env);
    make.setWorkingDirectory(QDir::currentPath());
 
-   // Clear the error storage.
-   errors.clear();
-
-   createMakefile();
-
-   invocationStr = "make -f nesicide.mk clean";
+   if ( jobs > 1 )
+   {
+      invocationStr = "make -j "+QString::number(jobs)+" -f nesicide.mk "+target;
+   }
+   else
+   {
+      invocationStr = "make -f nesicide.mk "+target;
+   }
 
    buildTextLogger->write(invocationStr);
 
+   buildTimes.clear();
+   buildStarts.clear();
+   buildTimer.start();
+
    make.start(invocationStr);
-   make.waitForFinished();
-   make.waitForReadyRead();
-   exitCode = make.exitCode();
-   stdioStr = QString(make.readAllStandardOutput());
-   stdioList = stdioStr.split(QRegExp("[\r\n]"),QString::SkipEmptyParts);
-   foreach ( const QString& str, stdioList )
+   if ( !make.waitForStarted() )
+   {
+      makeOutput(make.errorString(),true);
+      return -1;
+   }
+
+   do
+   {
+      // Wakes on output or, with nothing to read, to check for output on
+      // the other channel and for make having finished.
+      make.waitForReadyRead(100);
+      finished = (make.state() == QProcess::NotRunning);
+      stdoutStr += QString(make.readAllStandardOutput());
+      stderrStr += QString(make.readAllStandardError());
+
+      stdioList = takeLines(stdoutStr,finished);
+      foreach ( const QString& str, stdioList )
+      {
+         makeOutput(str,false);
+      }
+      stdioList = takeLines(stderrStr,finished);
+      foreach ( const QString& str, stdioList )
+      {
+         makeOutput(str,true);
+      }
+   } while ( !finished );
+
+   if ( !buildTimes.isEmpty() )
    {
-      buildTextLogger->write("<font color='blue'>"+str+"</font>");
+      qSort(buildTimes.begin(),buildTimes.end(),slowestFirst);
+      buildTextLogger->write("<b>Build times:</b>");
+      for ( idx = 0; idx < buildTimes.count(); idx++ )
+      {
+         buildTextLogger->write(buildTimes.at(idx).first+": "+QString::number(buildTimes.at(idx).second)+" ms");
+      }
    }
-   stdioStr = QString(make.readAllStandardError());
-   stdioList = stdioStr.split(QRegExp("[\r\n]"),QString::SkipEmptyParts);
-   errors.append(stdioList);
-   foreach ( const QString& str, stdioList )
+
+   // The exit code means nothing if make crashed or was killed.
+   if ( make.exitStatus() != QProcess::NormalExit )
    {
-      buildTextLogger->write("<font color='red'>"+str+"</font>");
+      makeOutput(make.errorString(),true);
+      return -1;
    }
 
-   return;
+   return make.exitCode();
 }
 
-bool CCC65Interface::assemble()
+void CCC65Interface::makeOutput(QString line,bool error)
 {
-   QProcess                     make;
-   QStringList                  env = QProcess::systemEnvironment();
-   QString                      invocationStr;
-   QString                      stdioStr;
-   QStringList                  stdioList;
-   QDir                         outputDir(nesicideProject->getProjectLinkerOutputBasePath());
-   QString                      outputName;
-   int                          exitCode;
-   bool                         ok = true;
+   QString source;
 
-   if ( nesicideProject->getProjectLinkerOutputName().isEmpty() )
+   if ( line.startsWith(BUILD_STARTED) )
+   {
+      source = line.mid(QString(BUILD_STARTED).length()).trimmed();
+      buildStarts.insert(source,buildTimer.elapsed());
+   }
+   else if ( line.startsWith(BUILD_FINISHED) )
    {
-      outputName = outputDir.fromNativeSeparators(outputDir.filePath(nesicideProject->getProjectOutputName()+".prg"));
+      source = line.mid(QString(BUILD_FINISHED).length()).trimmed();
+      if ( buildStarts.contains(source) )
+      {
+         buildTimes.append(qMakePair(source,(int)(buildTimer.elapsed()-buildStarts.take(source))));
+      }
+   }
+   else if ( error )
+   {
+      errors.append(line);
+      buildTextLogger->write("<font color='red'>"+line+"</font>");
    }
    else
    {
-      outputName = outputDir.fromNativeSeparators(outputDir.filePath(nesicideProject->getProjectLinkerOutputName()));
+      buildTextLogger->write("<font color='blue'>"+line+"</font>");
    }
-   buildTextLogger->write("<b>Building: "+outputName+"</b>");
+}
 
-   // Copy the system environment to the child process.
-   make.setEnvironment(env);
-   make.setWorkingDirectory(QDir::currentPath());
+QString CCC65Interface::getProgramName()
+{
+   QDir                         outputDir(nesicideProject->getProjectLinkerOutputBasePath());
+
+   if ( nesicideProject->getProjectLinkerOutputName().isEmpty() )
+   {
+      return outputDir.fromNativeSeparators(outputDir.filePath(nesicideProject->getProjectOutputName()+".prg"));
+   }
+   return outputDir.fromNativeSeparators(outputDir.filePath(nesicideProject->getProjectLinkerOutputName()));
+}
+
+// The flags the makefile builds with, as far as they change what is built.
+QString CCC65Interface::getCompilerFlags()
+{
+   return targetMachine+" "+
+          nesicideProject->getCompilerDefinedSymbols()+" "+
+          nesicideProject->getCompilerAdditionalOptions()+" "+
+          nesicideProject->getCompilerIncludePaths();
+}
+
+QString CCC65Interface::getAssemblerFlags()
+{
+   return targetMachine+" "+
+          nesicideProject->getAssemblerDefinedSymbols()+" "+
+          nesicideProject->getAssemblerAdditionalOptions()+" "+
+          nesicideProject->getAssemblerIncludePaths();
+}
+
+QString CCC65Interface::getLinkerFlags()
+{
+   return targetMachine+" "+
+          nesicideProject->getLinkerAdditionalOptions()+" "+
+          nesicideProject->getLinkerAdditionalDependencies();
+}
+
+bool CCC65Interface::assemble()
+{
+   QString                      outputName = getProgramName();
+   QStringList                  upToDate;
+   QString                      target;
+   int                          jobs;
+   bool                         ok;
+
+   buildTextLogger->write("<b>Building: "+outputName+"</b>");
 
    // Clear the error storage.
    errors.clear();
 
    createMakefile();
 
-   invocationStr = "make -f nesicide.mk all";
-
-   buildTextLogger->write(invocationStr);
-
-   make.start(invocationStr);
-   make.waitForFinished();
-   make.waitForReadyRead();
-   exitCode = make.exitCode();
-   stdioStr = QString(make.readAllStandardOutput());
-   stdioList = stdioStr.split(QRegExp("[\r\n]"),QString::SkipEmptyParts);
-   foreach ( const QString& str, stdioList )
+   // Objects the build cache knows are current are left out of make's
+   // decisions; it has restored or removed the rest as needed.
+   upToDate = CBuildCache::prepare(getCLanguageSourcesFromProject(),getCompilerFlags(),
+                                   getAssemblerSourcesFromProject(),getAssemblerFlags());
+   foreach ( const QString& object, upToDate )
    {
-      buildTextLogger->write("<font color='blue'>"+str+"</font>");
+      target += "-o \""+object+"\" ";
    }
-   stdioStr = QString(make.readAllStandardError());
-   stdioList = stdioStr.split(QRegExp("[\r\n]"),QString::SkipEmptyParts);
-   errors.append(stdioList);
-   foreach ( const QString& str, stdioList )
+   target += "all";
+
+   // Build as many sources at once as there are cores unless told otherwise.
+   jobs = EnvironmentSettingsDialog::buildJobs();
+   if ( jobs <= 0 )
    {
-      buildTextLogger->write("<font color='red'>"+str+"</font>");
+      jobs = QThread::idealThreadCount();
    }
-   if ( exitCode )
+
+   ok = (make(target,jobs) == 0);
+   if ( ok )
    {
-      ok = false;
+      CBuildCache::commit(outputName,nesicideProject->getLinkerConfigFile(),getLinkerFlags());
    }
+   CBuildCache::report();
 
    return ok;
 }
@@ -381,6 +509,8 @@ bool CCC65Interface::captureDebugInfo()
       return false;
    }
 
+   indexDebugInfo();
+
    // Check consistency of debug information when it's loaded.
    CCC65Interface::isBuildUpToDate();
 
@@ -404,25 +534,41 @@ bool CCC65Interface::isBuildUpToDate()
    if ( (getCLanguageSourcesFromProject().count() ||
         (getAssemblerSourcesFromProject().count())) )
    {
-      // Copy the system environment to the child process.
-      make.setProcessEnvironment(env);
-      make.setWorkingDirectory(QDir::currentPath());
+      // The build cache can tell without running make unless there are
+      // sources built by custom rules it doesn't know about.
+      if ( !getCustomSourcesFromProject().count() )
+      {
+         ok = CBuildCache::isUpToDate(getCLanguageSourcesFromProject(),getCompilerFlags(),
+                                      getAssemblerSourcesFromProject(),getAssemblerFlags(),
+                                      getProgramName(),nesicideProject->getLinkerConfigFile(),getLinkerFlags());
+      }
+      else
+      {
+         // Copy the system environment to the child process.
+         make.setProcessEnvironment(env);
+         make.setWorkingDirectory(QDir::currentPath());
+
+         // Clear the error storage.
+         errors.clear();
 
-      // Clear the error storage.
-      errors.clear();
+         createMakefile();
 
-      createMakefile();
+         invocationStr = "make -f nesicide.mk -q all";
 
-      invocationStr = "make -f nesicide.mk -q all";
+         make.start(invocationStr);
+         make.waitForFinished();
+         exitCode = make.exitCode();
 
-      make.start(invocationStr);
-      make.waitForFinished();
-      exitCode = make.exitCode();
+         // If make crashed its exit code means nothing; assume the worst.
+         if ( (make.exitStatus() != QProcess::NormalExit) || (exitCode == 1) )
+         {
+            ok = false;
+         }
+      }
 
-      if ( exitCode == 1 )
+      if ( !ok )
       {
          QMessageBox::warning(NULL,"Consistency problem!",outdated);
-         ok = false;
       }
    }
 
@@ -448,1557 +594,20 @@ bool CCC65Interface::captureINESImage()
    return nesicideProject->createProjectFromRom(nesName,true);
 }
 
-QStringList CCC65Interface::getSourceFiles()
-{
-   const cc65_sourceinfo* dbgSources;
-   QStringList files;
-   int file;
-
-   if ( dbgInfo )
-   {
-      dbgSources = cc65_get_sourcelist(dbgInfo);
-
-      if ( dbgSources )
-      {
-         for ( file = 0; file < dbgSources->count; file++ )
-         {
-            files.append(QDir::fromNativeSeparators(dbgSources->data[file].source_name));
-         }
-
-         cc65_free_sourceinfo(dbgInfo,dbgSources);
-      }
-   }
-   return files;
-}
-
-uint32_t CCC65Interface::getSegmentBase(QString segment)
-{
-   const cc65_segmentinfo* dbgSegments;
-   int seg;
-   int addr = -1;
-
-   if ( dbgInfo )
-   {
-      dbgSegments = cc65_get_segmentlist(dbgInfo);
-      if ( dbgSegments )
-      {
-         for ( seg = 0; seg < dbgSegments->count; seg++ )
-         {
-            if ( dbgSegments->data[seg].segment_name == segment )
-            {
-               addr = dbgSegments->data[seg].segment_start;
-            }
-         }
-
-         cc65_free_segmentinfo(dbgInfo,dbgSegments);
-      }
-   }
-
-   return addr;
-}
-
-unsigned int CCC65Interface::getSourceFileModificationTime(QString sourceFile)
-{
-   const cc65_sourceinfo* dbgSources;
-   unsigned int mtime = -1;
-   int file;
-
-   if ( dbgInfo )
-   {
-      dbgSources = cc65_get_sourcelist(dbgInfo);
-
-      if ( dbgSources )
-      {
-         for ( file = 0; file < dbgSources->count; file++ )
-         {
-            if ( fileNamesAreIdentical(dbgSources->data[file].source_name,sourceFile) )
-            {
-               mtime = dbgSources->data[file].source_mtime;
-               break;
-            }
-         }
-
-         cc65_free_sourceinfo(dbgInfo,dbgSources);
-      }
-   }
-   return mtime;
-}
-
-QStringList CCC65Interface::getSymbolsForSourceFile(QString /*sourceFile*/)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   QStringList symbols;
-   int sym;
-
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_inrange(dbgInfo,0,0xFFFF);
-
-      if ( dbgSymbols )
-      {
-         for ( sym = 0; sym < dbgSymbols->count; sym++ )
-         {
-            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
-            {
-               symbols.append(dbgSymbols->data[sym].symbol_name);
-            }
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-   return symbols;
-}
-
-cc65_symbol_type CCC65Interface::getSymbolType(QString symbol, int index)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   cc65_symbol_type type = (cc65_symbol_type)CC65_INV_ID;
-
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      if ( dbgSymbols )
-      {
-         if ( dbgSymbols->count > index )
-         {
-            type = dbgSymbols->data[index].symbol_type;
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-   return type;
-}
-
-unsigned int CCC65Interface::getSymbolAddress(QString symbol, int index)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   unsigned int addr = 0xFFFFFFFF;
-   int sym;
-
-   // Getting a symbol by name gets all the def and ref entries for the symbol, so
-   // we need to ignore the symbol count.  Move the 'sym' reference variable to the
-   // proper symbol in the returned pile.
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      if ( dbgSymbols )
-      {
-         for ( sym = 0; sym < dbgSymbols->count; sym++ )
-         {
-            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
-            {
-               if ( !index )
-               {
-                  break;
-               }
-               index--;
-            }
-         }
-         if ( sym < dbgSymbols->count )
-         {
-            addr = dbgSymbols->data[sym].symbol_value;
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-   return addr;
-}
-
-unsigned int CCC65Interface::getSymbolAbsoluteAddress(QString symbol, int index)
-{
-   // Dispatch to appropriate target machine handler.
-   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
-   {
-      return nesGetSymbolAbsoluteAddress(symbol,index);
-   }
-   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
-   {
-      return c64GetSymbolAbsoluteAddress(symbol,index);
-   }
-}
-
-unsigned int CCC65Interface::nesGetSymbolAbsoluteAddress(QString symbol, int index)
+bool CCC65Interface::isErrorOnLineOfFile(QString file,int source_line)
 {
-   const cc65_symbolinfo* dbgSymbols;
-   const cc65_segmentinfo* dbgSegments;
-   unsigned int addr;
-   unsigned int absAddr = 0xFFFFFFFF;
-   unsigned int addrOffset;
-   int sym;
-
-   // Getting a symbol by name gets all the def and ref entries for the symbol, so
-   // we need to ignore the symbol count.  Move the 'sym' reference variable to the
-   // proper symbol in the returned pile.
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      if ( dbgSymbols )
-      {
-         for ( sym = 0; sym < dbgSymbols->count; sym++ )
-         {
-            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
-            {
-               if ( !index )
-               {
-                  break;
-               }
-               index--;
-            }
-         }
-
-         if ( sym < dbgSymbols->count )
-         {
-            addr = dbgSymbols->data[sym].symbol_value;
-
-            if ( dbgSymbols->data[sym].segment_id != CC65_INV_ID )
-            {
-               dbgSegments = cc65_segment_byid(dbgInfo,dbgSymbols->data[sym].segment_id);
-
-               if ( dbgSegments )
-               {
-                  if ( dbgSegments->count == 1 )
-                  {
-                     addrOffset = addr-dbgSegments->data[0].segment_start;
-                     absAddr = dbgSegments->data[0].output_offs+addrOffset;
-                  }
-
-                  cc65_free_segmentinfo(dbgInfo,dbgSegments);
-               }
-            }
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-   return absAddr;
-}
+   QString errorLookup;
+   bool    found = false;
 
-unsigned int CCC65Interface::c64GetSymbolAbsoluteAddress(QString symbol, int index)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   const cc65_segmentinfo* dbgSegments;
-   unsigned int addr;
-   unsigned int absAddr = 0xFFFFFFFF;
-   unsigned int addrOffset;
-   int sym;
-
-   // Getting a symbol by name gets all the def and ref entries for the symbol, so
-   // we need to ignore the symbol count.  Move the 'sym' reference variable to the
-   // proper symbol in the returned pile.
-   if ( dbgInfo )
+   // Form error string key.
+   errorLookup = QDir::fromNativeSeparators(file)+'('+QString::number(source_line)+"):";
+   foreach ( const QString error, errors )
    {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      if ( dbgSymbols )
+      if ( error.contains(errorLookup) )
       {
-         for ( sym = 0; sym < dbgSymbols->count; sym++ )
-         {
-            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
-            {
-               if ( !index )
-               {
-                  break;
-               }
-               index--;
-            }
-         }
-
-         if ( sym < dbgSymbols->count )
-         {
-            addr = dbgSymbols->data[sym].symbol_value;
-
-            if ( dbgSymbols->data[sym].segment_id != CC65_INV_ID )
-            {
-               dbgSegments = cc65_segment_byid(dbgInfo,dbgSymbols->data[sym].segment_id);
-
-               if ( dbgSegments )
-               {
-                  if ( dbgSegments->count == 1 )
-                  {
-                     addrOffset = addr-dbgSegments->data[0].segment_start;
-                     absAddr = dbgSegments->data[0].segment_start+addrOffset;
-                  }
-
-                  cc65_free_segmentinfo(dbgInfo,dbgSegments);
-               }
-            }
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-   return absAddr;
-}
-
-unsigned int CCC65Interface::getSymbolSegment(QString symbol, int index)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   unsigned int seg = 0;
-   int sym;
-
-   // Getting a symbol by name gets all the def and ref entries for the symbol, so
-   // we need to ignore the symbol count.  Move the 'sym' reference variable to the
-   // proper symbol in the returned pile.
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      if ( dbgSymbols )
-      {
-         for ( sym = 0; sym < dbgSymbols->count; sym++ )
-         {
-            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
-            {
-               if ( !index )
-               {
-                  break;
-               }
-               index--;
-            }
-         }
-         if ( sym < dbgSymbols->count )
-         {
-            seg = dbgSymbols->data[sym].segment_id;
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-   return seg;
-}
-
-QString CCC65Interface::getSymbolSegmentName(QString symbol, int index)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   const cc65_segmentinfo* dbgSegments;
-   QString seg = "?";
-   int sym;
-
-   // Getting a symbol by name gets all the def and ref entries for the symbol, so
-   // we need to ignore the symbol count.  Move the 'sym' reference variable to the
-   // proper symbol in the returned pile.
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      if ( dbgSymbols )
-      {
-         for ( sym = 0; sym < dbgSymbols->count; sym++ )
-         {
-            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
-            {
-               if ( !index )
-               {
-                  break;
-               }
-               index--;
-            }
-         }
-         if ( sym < dbgSymbols->count )
-         {
-            if ( dbgSymbols->data[sym].segment_id != CC65_INV_ID )
-            {
-               dbgSegments = cc65_segment_byid(dbgInfo,dbgSymbols->data[sym].segment_id);
-               if ( dbgSegments )
-               {
-                  seg = dbgSegments->data[0].segment_name;
-
-                  cc65_free_segmentinfo(dbgInfo,dbgSegments);
-               }
-            }
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-   return seg;
-}
-
-unsigned int CCC65Interface::getSymbolIndexFromSegment(QString symbol, int segment)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   unsigned int index = 0;
-   unsigned int idx;
-
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      if ( dbgSymbols )
-      {
-         for ( idx = 0; idx < dbgSymbols->count; idx++ )
-         {
-            if ( /*(dbgSymbols->data[idx].export_id == CC65_INV_ID) &&*/
-                 (dbgSymbols->data[idx].segment_id == segment) )
-            {
-               index = idx;
-               break;
-            }
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-   return index;
-}
-
-unsigned int CCC65Interface::getSymbolSize(QString symbol, int index)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   unsigned int size = 0;
-   int sym;
-
-   // Getting a symbol by name gets all the def and ref entries for the symbol, so
-   // we need to ignore the symbol count.  Move the 'sym' reference variable to the
-   // proper symbol in the returned pile.
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      if ( dbgSymbols )
-      {
-         for ( sym = 0; sym < dbgSymbols->count; sym++ )
-         {
-            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
-            {
-               if ( !index )
-               {
-                  break;
-               }
-               index--;
-            }
-         }
-         if ( sym < dbgSymbols->count )
-         {
-            size = dbgSymbols->data[sym].symbol_size;
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-   return size;
-}
-
-int CCC65Interface::getSymbolMatchCount(QString symbol)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   int sym;
-   int count = 0;
-
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      if ( dbgSymbols )
-      {
-         for ( sym = 0; sym < dbgSymbols->count; sym++ )
-         {
-            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
-            {
-               count++;
-            }
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-   return count;
-}
-
-QString CCC65Interface::getSourceFileFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
-{
-   // Dispatch to appropriate target machine handler.
-   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
-   {
-      return QDir::fromNativeSeparators(nesGetSourceFileFromAbsoluteAddress(addr,absAddr));
-   }
-   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
-   {
-      return QDir::fromNativeSeparators(c64GetSourceFileFromAbsoluteAddress(addr,absAddr));
-   }
-}
-
-QString CCC65Interface::nesGetSourceFileFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
-{
-   const cc65_spaninfo* dbgSpans;
-   const cc65_segmentinfo* dbgSegments;
-   const cc65_lineinfo* dbgLines;
-   const cc65_sourceinfo* dbgSources;
-   int span;
-   int line;
-   int highestTypeMatch = 0;
-   int indexOfHighestTypeMatch = -1;
-   QString file = "";
-
-   if ( dbgInfo )
-   {
-      // Get the span containing this virtual address.
-      dbgSpans = cc65_span_byaddr(dbgInfo,addr);
-
-      if ( dbgSpans )
-      {
-         for ( span = 0; span < dbgSpans->count; span++ )
-         {
-            if ( dbgSpans->data[span].line_count )
-            {
-               // Get the segment potentially containing this absolute address.
-               dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[span].segment_id);
-
-               // Get the line potentially containing this absolute address.
-               dbgLines = cc65_line_byspan(dbgInfo,dbgSpans->data[span].span_id);
-
-               if ( dbgSegments && (dbgSegments->count == 1) &&
-                    dbgLines && (dbgLines->count > 0) )
-               {
-                  if ( dbgSegments->data[0].output_name )
-                  {
-                     if ( (absAddr >= dbgSegments->data[0].output_offs-0x10) &&
-                          (absAddr < (dbgSegments->data[0].output_offs-0x10+dbgSegments->data[0].segment_size)) )
-                     {
-                        for ( line = 0; line < dbgLines->count; line++ )
-                        {
-                           if ( dbgLines->data[line].line_type >= highestTypeMatch )
-                           {
-                              highestTypeMatch = dbgLines->data[line].line_type;
-                              indexOfHighestTypeMatch = dbgLines->data[line].line_id;
-                           }
-                        }
-                     }
-                  }
-                  else
-                  {
-                     if ( (absAddr >= dbgSegments->data[0].output_offs) &&
-                          (absAddr < (dbgSegments->data[0].output_offs+dbgSegments->data[0].segment_size)) )
-                     {
-                        for ( line = 0; line < dbgLines->count; line++ )
-                        {
-                           if ( dbgLines->data[line].line_type >= highestTypeMatch )
-                           {
-                              highestTypeMatch = dbgLines->data[line].line_type;
-                              indexOfHighestTypeMatch = dbgLines->data[line].line_id;
-                           }
-                        }
-                     }
-                  }
-               }
-               if ( dbgSegments )
-               {
-                  cc65_free_segmentinfo(dbgInfo,dbgSegments);
-               }
-               if ( dbgLines )
-               {
-                  cc65_free_lineinfo(dbgInfo,dbgLines);
-               }
-            }
-         }
-
-         cc65_free_spaninfo(dbgInfo,dbgSpans);
-
-         if ( indexOfHighestTypeMatch >= 0 )
-         {
-            // Get the picked line.
-            dbgLines = cc65_line_byid(dbgInfo,indexOfHighestTypeMatch);
-
-            // Get the source file of the picked line.
-            dbgSources = cc65_source_byid(dbgInfo,dbgLines->data[0].source_id);
-            file = dbgSources->data[0].source_name;
-
-            cc65_free_sourceinfo(dbgInfo,dbgSources);
-            cc65_free_lineinfo(dbgInfo,dbgLines);
-         }
-      }
-   }
-   return QDir::fromNativeSeparators(file);
-}
-
-QString CCC65Interface::c64GetSourceFileFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
-{
-   const cc65_spaninfo* dbgSpans;
-   const cc65_segmentinfo* dbgSegments;
-   const cc65_lineinfo* dbgLines;
-   const cc65_sourceinfo* dbgSources;
-   int span;
-   int line;
-   int highestTypeMatch = 0;
-   int indexOfHighestTypeMatch = -1;
-   QString file = "";
-
-   if ( dbgInfo )
-   {
-      // Get the span containing this virtual address.
-      dbgSpans = cc65_span_byaddr(dbgInfo,addr);
-
-      if ( dbgSpans )
-      {
-         for ( span = 0; span < dbgSpans->count; span++ )
-         {
-            if ( dbgSpans->data[span].line_count )
-            {
-               // Get the segment potentially containing this absolute address.
-               dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[span].segment_id);
-
-               // Get the line potentially containing this absolute address.
-               dbgLines = cc65_line_byspan(dbgInfo,dbgSpans->data[span].span_id);
-
-               if ( dbgSegments && (dbgSegments->count == 1) &&
-                    dbgLines && (dbgLines->count > 0) )
-               {
-                  if ( (absAddr >= dbgSegments->data[0].segment_start) &&
-                       (absAddr < (dbgSegments->data[0].segment_start+dbgSegments->data[0].segment_size)) )
-                  {
-                     for ( line = 0; line < dbgLines->count; line++ )
-                     {
-                        if ( dbgLines->data[line].line_type >= highestTypeMatch )
-                        {
-                           highestTypeMatch = dbgLines->data[line].line_type;
-                           indexOfHighestTypeMatch = dbgLines->data[line].line_id;
-                        }
-                     }
-                  }
-               }
-               if ( dbgSegments )
-               {
-                  cc65_free_segmentinfo(dbgInfo,dbgSegments);
-               }
-               if ( dbgLines )
-               {
-                  cc65_free_lineinfo(dbgInfo,dbgLines);
-               }
-            }
-         }
-
-         cc65_free_spaninfo(dbgInfo,dbgSpans);
-
-         if ( indexOfHighestTypeMatch >= 0 )
-         {
-            // Get the picked line.
-            dbgLines = cc65_line_byid(dbgInfo,indexOfHighestTypeMatch);
-
-            // Get the source file of the picked line.
-            dbgSources = cc65_source_byid(dbgInfo,dbgLines->data[0].source_id);
-            file = dbgSources->data[0].source_name;
-
-            cc65_free_sourceinfo(dbgInfo,dbgSources);
-            cc65_free_lineinfo(dbgInfo,dbgLines);
-         }
-      }
-   }
-   return QDir::fromNativeSeparators(file);
-}
-
-int CCC65Interface::getSourceLineFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
-{
-   // Dispatch to appropriate target machine handler.
-   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
-   {
-      return nesGetSourceLineFromAbsoluteAddress(addr,absAddr);
-   }
-   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
-   {
-      return c64GetSourceLineFromAbsoluteAddress(addr,absAddr);
-   }
-}
-
-int CCC65Interface::nesGetSourceLineFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
-{
-   const cc65_spaninfo* dbgSpans;
-   const cc65_lineinfo* dbgLines;
-   const cc65_segmentinfo* dbgSegments;
-   int span;
-   int line;
-   int highestTypeMatch = 0;
-   int indexOfHighestTypeMatch = -1;
-   int source_line = -1;
-
-   if ( dbgInfo )
-   {
-      // Get the span containing this virtual address.
-      dbgSpans = cc65_span_byaddr(dbgInfo,addr);
-
-      if ( dbgSpans )
-      {
-         for ( span = 0; span < dbgSpans->count; span++ )
-         {
-            if ( dbgSpans->data[span].line_count )
-            {
-               // Get the segment potentially containing this absolute address.
-               dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[span].segment_id);
-
-               // Get the line potentially containing this absolute address.
-               dbgLines = cc65_line_byspan(dbgInfo,dbgSpans->data[span].span_id);
-
-               if ( dbgSegments && (dbgSegments->count == 1) &&
-                    dbgLines && (dbgLines->count > 0) )
-               {
-                  if ( dbgSegments->data[0].output_name )
-                  {
-                     if ( (absAddr >= dbgSegments->data[0].output_offs-0x10) &&
-                          (absAddr < (dbgSegments->data[0].output_offs-0x10+dbgSegments->data[0].segment_size)) )
-                     {
-                        for ( line = 0; line < dbgLines->count; line++ )
-                        {
-                           if ( dbgLines->data[line].line_type >= highestTypeMatch )
-                           {
-                              highestTypeMatch = dbgLines->data[line].line_type;
-                              indexOfHighestTypeMatch = dbgLines->data[line].line_id;
-                           }
-                        }
-                     }
-                  }
-                  else
-                  {
-                     if ( (absAddr >= dbgSegments->data[0].output_offs) &&
-                          (absAddr < (dbgSegments->data[0].output_offs+dbgSegments->data[0].segment_size)) )
-                     {
-                        for ( line = 0; line < dbgLines->count; line++ )
-                        {
-                           if ( dbgLines->data[line].line_type >= highestTypeMatch )
-                           {
-                              highestTypeMatch = dbgLines->data[line].line_type;
-                              indexOfHighestTypeMatch = dbgLines->data[line].line_id;
-                           }
-                        }
-                     }
-                  }
-               }
-               if ( dbgSegments )
-               {
-                  cc65_free_segmentinfo(dbgInfo,dbgSegments);
-               }
-               if ( dbgLines )
-               {
-                  cc65_free_lineinfo(dbgInfo,dbgLines);
-               }
-            }
-         }
-         if ( indexOfHighestTypeMatch >= 0 )
-         {
-            // Get the picked line.
-            dbgLines = cc65_line_byid(dbgInfo,indexOfHighestTypeMatch);
-            source_line = dbgLines->data[0].source_line;
-            cc65_free_lineinfo(dbgInfo,dbgLines);
-         }
-
-         cc65_free_spaninfo(dbgInfo,dbgSpans);
-      }
-   }
-   return source_line;
-}
-
-int CCC65Interface::c64GetSourceLineFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
-{
-   const cc65_spaninfo* dbgSpans;
-   const cc65_lineinfo* dbgLines;
-   const cc65_segmentinfo* dbgSegments;
-   int span;
-   int line;
-   int highestTypeMatch = 0;
-   int indexOfHighestTypeMatch = -1;
-   int source_line = -1;
-
-   if ( dbgInfo )
-   {
-      // Get the span containing this virtual address.
-      dbgSpans = cc65_span_byaddr(dbgInfo,addr);
-
-      if ( dbgSpans )
-      {
-         for ( span = 0; span < dbgSpans->count; span++ )
-         {
-            if ( dbgSpans->data[span].line_count )
-            {
-               // Get the segment potentially containing this absolute address.
-               dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[span].segment_id);
-
-               // Get the line potentially containing this absolute address.
-               dbgLines = cc65_line_byspan(dbgInfo,dbgSpans->data[span].span_id);
-
-               if ( dbgSegments && (dbgSegments->count == 1) &&
-                    dbgLines && (dbgLines->count > 0) )
-               {
-                  if ( (absAddr >= dbgSegments->data[0].segment_start) &&
-                       (absAddr < (dbgSegments->data[0].segment_start+dbgSegments->data[0].segment_size)) )
-                  {
-                     for ( line = 0; line < dbgLines->count; line++ )
-                     {
-                        if ( dbgLines->data[line].line_type >= highestTypeMatch )
-                        {
-                           highestTypeMatch = dbgLines->data[line].line_type;
-                           indexOfHighestTypeMatch = dbgLines->data[line].line_id;
-                        }
-                     }
-                  }
-               }
-               if ( dbgSegments )
-               {
-                  cc65_free_segmentinfo(dbgInfo,dbgSegments);
-               }
-               if ( dbgLines )
-               {
-                  cc65_free_lineinfo(dbgInfo,dbgLines);
-               }
-            }
-         }
-         if ( indexOfHighestTypeMatch >= 0 )
-         {
-            // Get the picked line.
-            dbgLines = cc65_line_byid(dbgInfo,indexOfHighestTypeMatch);
-            source_line = dbgLines->data[0].source_line;
-            cc65_free_lineinfo(dbgInfo,dbgLines);
-         }
-
-         cc65_free_spaninfo(dbgInfo,dbgSpans);
-      }
-   }
-   return source_line;
-}
-
-QString CCC65Interface::getSourceFileFromSymbol(QString symbol)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   const cc65_lineinfo* dbgLines;
-   const cc65_sourceinfo* dbgSources;
-   int sym;
-   QString file = "";
-
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      // Getting a symbol by name gets all the def and ref entries for the symbol, so
-      // we need to ignore the symbol count.  Move the 'sym' reference variable to the
-      // proper symbol in the returned pile.
-      if ( dbgSymbols )
-      {
-         for ( sym = 0; sym < dbgSymbols->count; sym++ )
-         {
-            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
-            {
-               break;
-            }
-         }
-         if ( sym < dbgSymbols->count )
-         {
-            dbgLines = cc65_line_bysymdef(dbgInfo,dbgSymbols->data[sym].symbol_id);
-
-            if ( dbgLines && (dbgLines->count == 1) )
-            {
-               dbgSources = cc65_source_byid(dbgInfo,dbgLines->data[0].source_id);
-
-               if ( dbgSources && (dbgSources->count == 1) )
-               {
-                  file = dbgSources->data[0].source_name;
-               }
-
-               if ( dbgSources )
-               {
-                  cc65_free_sourceinfo(dbgInfo,dbgSources);
-               }
-            }
-
-            if ( dbgLines )
-            {
-               cc65_free_lineinfo(dbgInfo,dbgLines);
-            }
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-
-   return QDir::fromNativeSeparators(file);
-}
-
-int CCC65Interface::getSourceLineFromFileAndSymbol(QString file,QString symbol)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   const cc65_lineinfo* dbgLines;
-   const cc65_sourceinfo* dbgSources;
-   int sym;
-   int source_line = -1;
-
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,symbol.toLatin1().constData());
-
-      // Getting a symbol by name gets all the def and ref entries for the symbol, so
-      // we need to ignore the symbol count.  Move the 'sym' reference variable to the
-      // proper symbol in the returned pile.
-      if ( dbgSymbols )
-      {
-         for ( sym = 0; sym < dbgSymbols->count; sym++ )
-         {
-            if ( dbgSymbols->data[sym].export_id == CC65_INV_ID )
-            {
-               break;
-            }
-         }
-         if ( sym < dbgSymbols->count )
-         {
-            dbgLines = cc65_line_bysymdef(dbgInfo,dbgSymbols->data[sym].symbol_id);
-
-            if ( dbgLines && (dbgLines->count == 1) )
-            {
-               dbgSources = cc65_source_byid(dbgInfo,dbgLines->data[0].source_id);
-
-               if ( dbgSources && (dbgSources->count == 1) )
-               {
-                  if ( fileNamesAreIdentical(dbgSources->data[0].source_name,file) )
-                  {
-                     source_line = dbgLines->data[0].source_line;
-                  }
-               }
-
-               if ( dbgSources )
-               {
-                  cc65_free_sourceinfo(dbgInfo,dbgSources);
-               }
-            }
-
-            if ( dbgLines )
-            {
-               cc65_free_lineinfo(dbgInfo,dbgLines);
-            }
-         }
-
-         cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-      }
-   }
-
-   return source_line;
-}
-
-int CCC65Interface::getLineMatchCount(QString file, int source_line)
-{
-   const cc65_sourceinfo* dbgSources;
-   const cc65_lineinfo* dbgLines;
-   const cc65_spaninfo* dbgSpans;
-   int fidx;
-   int count = 0;
-
-   if ( dbgInfo )
-   {
-      // Get source ID from file.
-      dbgSources = cc65_get_sourcelist(dbgInfo);
-
-      // Get the appropriate file.
-      for ( fidx = 0; fidx < dbgSources->count; fidx++ )
-      {
-         if ( fileNamesAreIdentical(dbgSources->data[fidx].source_name,file) )
-         {
-            break;
-         }
-      }
-
-      dbgLines = cc65_line_bynumber(dbgInfo,dbgSources->data[fidx].source_id,source_line);
-      if ( dbgLines && (dbgLines->count == 1) )
-      {
-         // Get the spans for this line.
-         dbgSpans = cc65_span_byline(dbgInfo,dbgLines->data[0].line_id);
-
-         if ( dbgSpans )
-         {
-            count = dbgSpans->count;
-
-            cc65_free_spaninfo(dbgInfo,dbgSpans);
-         }
-      }
-
-      if ( dbgLines )
-      {
-         cc65_free_lineinfo(dbgInfo,dbgLines);
-      }
-
-      cc65_free_sourceinfo(dbgInfo,dbgSources);
-   }
-
-   return count;
-}
-
-unsigned int CCC65Interface::getAddressFromFileAndLine(QString file,int source_line,int entry)
-{
-   const cc65_sourceinfo* dbgSources;
-   const cc65_lineinfo* dbgLines;
-   const cc65_spaninfo* dbgSpans;
-   int highestTypeMatch = 0;
-   int indexOfHighestTypeMatch = -1;
-   int span;
-   int fidx;
-   int count = 0;
-   int addr = -1;
-
-   if ( dbgInfo )
-   {
-      dbgSources = cc65_get_sourcelist(dbgInfo);
-
-      if ( dbgSources )
-      {
-         // Get the appropriate file.
-         for ( fidx = 0; fidx < dbgSources->count; fidx++ )
-         {
-            if ( fileNamesAreIdentical(dbgSources->data[fidx].source_name,file) )
-            {
-               break;
-            }
-         }
-
-         // Get line information from source file.
-         dbgLines = cc65_line_bynumber(dbgInfo,dbgSources->data[fidx].source_id,source_line);
-
-         if ( dbgLines && (dbgLines->count == 1) )
-         {
-            // Get the spans for this line.
-            dbgSpans = cc65_span_byline(dbgInfo,dbgLines->data[0].line_id);
-
-            if ( dbgSpans )
-            {
-               for ( span = 0; span < dbgSpans->count; span++ )
-               {
-                  // Inject preference for MACRO expansions over C language over assembly...
-                  if ( dbgLines->data[0].line_type >= highestTypeMatch )
-                  {
-                     highestTypeMatch = dbgLines->data[0].line_type;
-                     indexOfHighestTypeMatch = dbgSpans->data[span].span_id;
-                  }
-
-                  if ( count == entry )
-                  {
-                     highestTypeMatch = dbgLines->data[0].line_type;
-                     indexOfHighestTypeMatch = dbgSpans->data[span].span_id;
-                     break;
-                  }
-
-                  // Keep track of when to return data if asked to break early.
-                  count++;
-               }
-
-               cc65_free_spaninfo(dbgInfo,dbgSpans);
-            }
-         }
-
-         if ( dbgLines )
-         {
-            cc65_free_lineinfo(dbgInfo,dbgLines);
-         }
-
-         cc65_free_sourceinfo(dbgInfo,dbgSources);
-
-         if ( indexOfHighestTypeMatch >= 0 )
-         {
-            // Get span information to return.
-            dbgSpans = cc65_span_byid(dbgInfo,indexOfHighestTypeMatch);
-
-            addr = dbgSpans->data[0].span_start;
-
-            cc65_free_spaninfo(dbgInfo,dbgSpans);
-         }
-      }
-   }
-   return addr;
-}
-
-unsigned int CCC65Interface::getAbsoluteAddressFromFileAndLine(QString file,int source_line,int entry)
-{
-   // Dispatch to appropriate target machine handler.
-   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
-   {
-      return nesGetAbsoluteAddressFromFileAndLine(file,source_line,entry);
-   }
-   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
-   {
-      return c64GetAbsoluteAddressFromFileAndLine(file,source_line,entry);
-   }
-}
-
-unsigned int CCC65Interface::nesGetAbsoluteAddressFromFileAndLine(QString file,int source_line,int entry)
-{
-   const cc65_sourceinfo* dbgSources;
-   const cc65_lineinfo* dbgLines;
-   const cc65_spaninfo* dbgSpans;
-   const cc65_segmentinfo* dbgSegments;
-   int highestTypeMatch = 0;
-   int indexOfHighestTypeMatch = -1;
-   int span;
-   int fidx;
-   int count = 0;
-   int absAddr = -1;
-   
-   if ( dbgInfo )
-   {
-      dbgSources = cc65_get_sourcelist(dbgInfo);
-
-      if ( dbgSources )
-      {
-         // Get the appropriate file.
-         for ( fidx = 0; fidx < dbgSources->count; fidx++ )
-         {
-            if ( fileNamesAreIdentical(dbgSources->data[fidx].source_name,file) )
-            {
-               break;
-            }
-         }
-
-         // Get line information from source file.
-         dbgLines = cc65_line_bynumber(dbgInfo,dbgSources->data[fidx].source_id,source_line);
-
-         if ( dbgLines && (dbgLines->count == 1) )
-         {
-            // Get the spans for this line.
-            dbgSpans = cc65_span_byline(dbgInfo,dbgLines->data[0].line_id);
-
-            if ( dbgSpans )
-            {
-               for ( span = 0; span < dbgSpans->count; span++ )
-               {
-                  // Inject preference for MACRO expansions over C language over assembly...
-                  if ( dbgLines->data[0].line_type >= highestTypeMatch )
-                  {
-                     highestTypeMatch = dbgLines->data[0].line_type;
-                     indexOfHighestTypeMatch = dbgSpans->data[span].span_id;
-                  }
-
-                  if ( count == entry )
-                  {
-                     highestTypeMatch = dbgLines->data[0].line_type;
-                     indexOfHighestTypeMatch = dbgSpans->data[span].span_id;
-                     break;
-                  }
-
-                  // Keep track of when to return data if asked to break early.
-                  count++;
-               }
-
-               cc65_free_spaninfo(dbgInfo,dbgSpans);
-            }
-         }
-
-         if ( dbgLines )
-         {
-            cc65_free_lineinfo(dbgInfo,dbgLines);
-         }
-
-         cc65_free_sourceinfo(dbgInfo,dbgSources);
-
-         if ( indexOfHighestTypeMatch >= 0 )
-         {
-            // Get span information.
-            dbgSpans = cc65_span_byid(dbgInfo,indexOfHighestTypeMatch);
-
-            // Get segment information from span.
-            dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[0].segment_id);
-            if ( dbgSegments->data[0].output_name )
-            {
-               absAddr = dbgSegments->data[0].output_offs+(dbgSpans->data[0].span_start-dbgSegments->data[0].segment_start)-0x10;
-            }
-            else
-            {
-               absAddr = dbgSegments->data[0].output_offs+(dbgSpans->data[0].span_start-dbgSegments->data[0].segment_start);
-            }
-
-            cc65_free_spaninfo(dbgInfo,dbgSpans);
-            cc65_free_segmentinfo(dbgInfo,dbgSegments);
-         }
-      }
-   }
-   return absAddr;
-}
-
-unsigned int CCC65Interface::c64GetAbsoluteAddressFromFileAndLine(QString file,int source_line,int entry)
-{
-   const cc65_sourceinfo* dbgSources;
-   const cc65_lineinfo* dbgLines;
-   const cc65_spaninfo* dbgSpans;
-   const cc65_segmentinfo* dbgSegments;
-   int highestTypeMatch = 0;
-   int indexOfHighestTypeMatch = -1;
-   int span;
-   int fidx;
-   int count = 0;
-   int absAddr = -1;
-
-   if ( dbgInfo )
-   {
-      dbgSources = cc65_get_sourcelist(dbgInfo);
-
-      if ( dbgSources )
-      {
-         // Get the appropriate file.
-         for ( fidx = 0; fidx < dbgSources->count; fidx++ )
-         {
-            if ( fileNamesAreIdentical(dbgSources->data[fidx].source_name,file) )
-            {
-               break;
-            }
-         }
-
-         // Get line information from source file.
-         dbgLines = cc65_line_bynumber(dbgInfo,dbgSources->data[fidx].source_id,source_line);
-
-         if ( dbgLines && (dbgLines->count == 1) )
-         {
-            // Get the spans for this line.
-            dbgSpans = cc65_span_byline(dbgInfo,dbgLines->data[0].line_id);
-
-            if ( dbgSpans )
-            {
-               for ( span = 0; span < dbgSpans->count; span++ )
-               {
-                  // Inject preference for MACRO expansions over C language over assembly...
-                  if ( dbgLines->data[0].line_type >= highestTypeMatch )
-                  {
-                     highestTypeMatch = dbgLines->data[0].line_type;
-                     indexOfHighestTypeMatch = dbgSpans->data[span].span_id;
-                  }
-
-                  if ( count == entry )
-                  {
-                     highestTypeMatch = dbgLines->data[0].line_type;
-                     indexOfHighestTypeMatch = dbgSpans->data[span].span_id;
-                     break;
-                  }
-
-                  // Keep track of when to return data if asked to break early.
-                  count++;
-               }
-
-               cc65_free_spaninfo(dbgInfo,dbgSpans);
-            }
-         }
-
-         if ( dbgLines )
-         {
-            cc65_free_lineinfo(dbgInfo,dbgLines);
-         }
-
-         cc65_free_sourceinfo(dbgInfo,dbgSources);
-
-         if ( indexOfHighestTypeMatch >= 0 )
-         {
-            // Get span information.
-            dbgSpans = cc65_span_byid(dbgInfo,indexOfHighestTypeMatch);
-
-            // Get segment information from span.
-            dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[0].segment_id);
-            absAddr = dbgSegments->data[0].segment_start+(dbgSpans->data[0].span_start-dbgSegments->data[0].segment_start);
-
-            cc65_free_spaninfo(dbgInfo,dbgSpans);
-            cc65_free_segmentinfo(dbgInfo,dbgSegments);
-         }
-      }
-   }
-   return absAddr;
-}
-
-unsigned int CCC65Interface::getEndAddressFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
-{
-   // Dispatch to appropriate target machine handler.
-   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
-   {
-      return nesGetEndAddressFromAbsoluteAddress(addr,absAddr);
-   }
-   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
-   {
-      return c64GetEndAddressFromAbsoluteAddress(addr,absAddr);
-   }
-}
-
-unsigned int CCC65Interface::nesGetEndAddressFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
-{
-   const cc65_lineinfo* dbgLines;
-   const cc65_spaninfo* dbgSpans;
-   const cc65_segmentinfo* dbgSegments;
-   int      span;
-   int      line;
-   int highestTypeMatch = 0;
-   int indexOfHighestTypeMatch = -1;
-   int endAddr = -1;
-
-   if ( dbgInfo )
-   {
-      dbgSpans = cc65_span_byaddr(dbgInfo,addr);
-
-      if ( dbgSpans )
-      {
-         for ( span = 0; span < dbgSpans->count; span++ )
-         {
-            dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[span].segment_id);
-
-            dbgLines = cc65_line_byspan(dbgInfo,dbgSpans->data[span].span_id);
-
-            if ( dbgSegments && (dbgSegments->count == 1) &&
-                 dbgLines && (dbgLines->count > 0) )
-            {
-               if ( dbgSegments->data[0].output_name )
-               {
-                  if ( (absAddr >= dbgSegments->data[0].output_offs+(dbgSpans->data[span].span_start-dbgSegments->data[0].segment_start)-0x10) &&
-                       (absAddr <= dbgSegments->data[0].output_offs+(dbgSpans->data[span].span_end-dbgSegments->data[0].segment_start)-0x10) )
-                  {
-                     for ( line = 0; line < dbgLines->count; line++ )
-                     {
-                        if ( dbgLines->data[line].line_type >= highestTypeMatch )
-                        {
-                           highestTypeMatch = dbgLines->data[line].line_type;
-                           indexOfHighestTypeMatch = dbgSpans->data[span].span_id;
-                        }
-                     }
-                  }
-               }
-               else
-               {
-                  if ( (absAddr >= dbgSegments->data[0].output_offs+(dbgSpans->data[span].span_start-dbgSegments->data[0].segment_start)) &&
-                       (absAddr <= dbgSegments->data[0].output_offs+(dbgSpans->data[span].span_end-dbgSegments->data[0].segment_start)) )
-                  {
-                     for ( line = 0; line < dbgLines->count; line++ )
-                     {
-                        if ( dbgLines->data[line].line_type >= highestTypeMatch )
-                        {
-                           highestTypeMatch = dbgLines->data[line].line_type;
-                           indexOfHighestTypeMatch = dbgSpans->data[span].span_id;
-                        }
-                     }
-                  }
-               }
-            }
-
-            if ( dbgLines )
-            {
-               cc65_free_lineinfo(dbgInfo,dbgLines);
-            }
-            if ( dbgSegments )
-            {
-               cc65_free_segmentinfo(dbgInfo,dbgSegments);
-            }
-         }
-
-         cc65_free_spaninfo(dbgInfo,dbgSpans);
-
-         if ( indexOfHighestTypeMatch >= 0 )
-         {
-            dbgSpans = cc65_span_byid(dbgInfo,indexOfHighestTypeMatch);
-
-            endAddr = dbgSpans->data[0].span_end;
-
-            cc65_free_spaninfo(dbgInfo,dbgSpans);
-         }
-      }
-   }
-
-   return endAddr;
-}
-
-unsigned int CCC65Interface::c64GetEndAddressFromAbsoluteAddress(uint32_t addr,uint32_t absAddr)
-{
-   const cc65_lineinfo* dbgLines;
-   const cc65_spaninfo* dbgSpans;
-   const cc65_segmentinfo* dbgSegments;
-   int      span;
-   int      line;
-   int highestTypeMatch = 0;
-   int indexOfHighestTypeMatch = -1;
-   int endAddr = -1;
-
-   if ( dbgInfo )
-   {
-      dbgSpans = cc65_span_byaddr(dbgInfo,addr);
-
-      if ( dbgSpans )
-      {
-         for ( span = 0; span < dbgSpans->count; span++ )
-         {
-            dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[span].segment_id);
-
-            dbgLines = cc65_line_byspan(dbgInfo,dbgSpans->data[span].span_id);
-
-            if ( dbgSegments && (dbgSegments->count == 1) &&
-                 dbgLines && (dbgLines->count > 0) )
-            {
-               if ( (absAddr >= dbgSegments->data[0].segment_start+(dbgSpans->data[span].span_start-dbgSegments->data[0].segment_start)) &&
-                    (absAddr <= dbgSegments->data[0].segment_start+(dbgSpans->data[span].span_end-dbgSegments->data[0].segment_start)) )
-               {
-                  for ( line = 0; line < dbgLines->count; line++ )
-                  {
-                     if ( dbgLines->data[line].line_type >= highestTypeMatch )
-                     {
-                        highestTypeMatch = dbgLines->data[line].line_type;
-                        indexOfHighestTypeMatch = dbgSpans->data[span].span_id;
-                     }
-                  }
-               }
-            }
-
-            if ( dbgLines )
-            {
-               cc65_free_lineinfo(dbgInfo,dbgLines);
-            }
-            if ( dbgSegments )
-            {
-               cc65_free_segmentinfo(dbgInfo,dbgSegments);
-            }
-         }
-
-         cc65_free_spaninfo(dbgInfo,dbgSpans);
-
-         if ( indexOfHighestTypeMatch >= 0 )
-         {
-            dbgSpans = cc65_span_byid(dbgInfo,indexOfHighestTypeMatch);
-
-            endAddr = dbgSpans->data[0].span_end;
-
-            cc65_free_spaninfo(dbgInfo,dbgSpans);
-         }
-      }
-   }
-
-   return endAddr;
-}
-
-bool CCC65Interface::isAbsoluteAddressAnOpcode(uint32_t absAddr)
-{
-   // Dispatch to appropriate target machine handler.
-   if ( !targetMachine.compare("nes",Qt::CaseInsensitive) )
-   {
-      return nesIsAbsoluteAddressAnOpcode(absAddr);
-   }
-   else if ( !targetMachine.compare("c64",Qt::CaseInsensitive) )
-   {
-      return c64IsAbsoluteAddressAnOpcode(absAddr);
-   }
-   return false;
-}
-
-bool CCC65Interface::nesIsAbsoluteAddressAnOpcode(uint32_t absAddr)
-{
-   const cc65_spaninfo* dbgSpans;
-   const cc65_segmentinfo* dbgSegments;
-   uint32_t addr;
-   int      span;
-   bool     opcode = false;
-
-   if ( dbgInfo )
-   {
-      // Make addresses for where code might be in PRG-ROM space.
-      addr = (absAddr&MASK_8KB);
-      for ( ; addr < MEM_64KB; addr += MEM_8KB )
-      {
-         dbgSpans = cc65_span_byaddr(dbgInfo,addr);
-
-         if ( dbgSpans )
-         {
-            for ( span = 0; span < dbgSpans->count; span++ )
-            {
-               dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[span].segment_id);
-
-               if ( dbgSegments && (dbgSegments->count == 1) )
-               {
-                  if ( dbgSegments->data[0].output_name )
-                  {
-                     if ( absAddr == dbgSegments->data[0].output_offs+(dbgSpans->data[span].span_start-dbgSegments->data[0].segment_start)-0x10 )
-                     {
-                        opcode = true;
-                     }
-                  }
-                  else
-                  {
-                     if ( absAddr == dbgSegments->data[0].output_offs+(dbgSpans->data[span].span_start-dbgSegments->data[0].segment_start) )
-                     {
-                        opcode = true;
-                     }
-                  }
-               }
-
-               if ( dbgSegments )
-               {
-                  cc65_free_segmentinfo(dbgInfo,dbgSegments);
-               }
-            }
-
-            cc65_free_spaninfo(dbgInfo,dbgSpans);
-         }
-      }
-   }
-
-   return opcode;
-}
-
-bool CCC65Interface::c64IsAbsoluteAddressAnOpcode(uint32_t absAddr)
-{
-   const cc65_spaninfo* dbgSpans;
-   const cc65_segmentinfo* dbgSegments;
-   uint32_t addr;
-   int      span;
-   bool     opcode = false;
-
-   if ( dbgInfo )
-   {
-      // Make addresses for where code might be in PRG-ROM space.
-      dbgSpans = cc65_span_byaddr(dbgInfo,absAddr);
-
-      if ( dbgSpans )
-      {
-         for ( span = 0; span < dbgSpans->count; span++ )
-         {
-            dbgSegments = cc65_segment_byid(dbgInfo,dbgSpans->data[span].segment_id);
-
-            if ( dbgSegments && (dbgSegments->count == 1) )
-            {
-               if ( absAddr == dbgSegments->data[0].segment_start+(dbgSpans->data[span].span_start-dbgSegments->data[0].segment_start) )
-               {
-                  opcode = true;
-               }
-            }
-
-            if ( dbgSegments )
-            {
-               cc65_free_segmentinfo(dbgInfo,dbgSegments);
-            }
-         }
-
-         cc65_free_spaninfo(dbgInfo,dbgSpans);
-      }
-   }
-
-   return opcode;
-}
-
-bool CCC65Interface::isErrorOnLineOfFile(QString file,int source_line)
-{
-   QString errorLookup;
-   bool    found = false;
-
-   // Form error string key.
-   errorLookup = QDir::fromNativeSeparators(file)+'('+QString::number(source_line)+"):";
-   foreach ( const QString error, errors )
-   {
-      if ( error.contains(errorLookup) )
-      {
-         found = true;
-         break;
+         found = true;
+         break;
       }
    }
    return found;
 }
-
-bool CCC65Interface::isStringASymbol(QString string)
-{
-   const cc65_symbolinfo* dbgSymbols;
-   bool symbol = false;
-
-   if ( dbgInfo )
-   {
-      dbgSymbols = cc65_symbol_byname(dbgInfo,string.toLatin1().constData());
-
-      if ( dbgSymbols )
-      {
-         symbol = true;
-      }
-
-      cc65_free_symbolinfo(dbgInfo,dbgSymbols);
-   }
-   return symbol;
-}
@@ -2,6 +2,10 @@
 #define CCC65INTERFACE_H
 
 #include <QProcess>
+#include <QHash>
+#include <QVector>
+#include <QPair>
+#include <QElapsedTimer>
 
 #include "stdint.h"
 
@@ -45,6 +49,7 @@ public:
    static int getLineMatchCount(QString file,int source_line);
    static unsigned int getAddressFromFileAndLine(QString file,int source_line,int entry = -1);
    static QStringList getErrors() { return errors; }
+   static QList<QPair<QString,int> > getBuildTimes() { return buildTimes; }
    static bool isErrorOnLineOfFile(QString file,int source_line);
    static bool isStringASymbol(QString string);
 
@@ -73,9 +78,100 @@ public:
    static unsigned int c64GetSymbolAbsoluteAddress(QString symbol,int index = 0);
 
 protected:
+   // The lookups above are made per row per repaint by the debugger
+   // models, so rather than query (and allocate from) the debug
+   // information each time, indexDebugInfo builds these tables once when
+   // the debug information is read.
+   typedef struct
+   {
+      cc65_addr     spanStart;
+      cc65_addr     spanEnd;
+      unsigned      lineCount;
+      // The span's segment, if it has exactly one.
+      bool          hasSegment;
+      cc65_addr     segmentStart;
+      cc65_size     segmentSize;
+      bool          hasOutputName;
+      unsigned long outputOffs;
+      // Of the lines attached to the span, the last one of the highest
+      // line type (macro over C over assembly).
+      bool          hasLines;
+      int           lineType;
+      unsigned      sourceId;
+      int           sourceLine;
+   } SpanEntry;
+
+   // Runs of addresses covered by the same spans, sorted by start
+   // address.  The spans are listed in spanPool from first, in the order
+   // dbginfo gives them.
+   typedef struct
+   {
+      uint32_t start;
+      int      first;
+      int      count;
+   } AddressRange;
+
+   // The spans of a file:line, in the order dbginfo gives them.
+   typedef struct
+   {
+      int          lineType;
+      QVector<int> spans;
+   } LineEntry;
+
+   // All the symbols with a name, definitions and references, in the
+   // order dbginfo gives them, and where the first definition is.
+   typedef struct
+   {
+      QVector<cc65_symboldata> symbols;
+      QVector<int>             definitions;
+      QString                  definitionFile;
+      int                      definitionLine;
+   } SymbolEntry;
+
+   typedef struct
+   {
+      QString       name;
+      cc65_addr     start;
+      bool          hasOutputName;
+      unsigned long outputOffs;
+   } SegmentEntry;
+
+   // Runs make on the project's makefile, passing each line of its output
+   // to the build log as it arrives rather than when make is done.
+   static int make(QString target,int jobs);
+   static QString getProgramName();
+   static QString getCompilerFlags();
+   static QString getAssemblerFlags();
+   static QString getLinkerFlags();
+   static void makeOutput(QString line,bool error);
+
+   static void indexDebugInfo();
+   static void clearDebugInfoIndex();
+   static int spansAtAddress(uint32_t addr,const int** spans);
+   static int lineSpanAtAbsoluteAddress(uint32_t addr,uint32_t absAddr,bool nes);
+   static int endSpanAtAbsoluteAddress(uint32_t addr,uint32_t absAddr,bool nes);
+   static const LineEntry* lineEntryFromFileAndLine(QString file,int source_line);
+   static int spanFromFileAndLine(QString file,int source_line,int entry);
+   static const cc65_symboldata* symbolDefinition(QString symbol,int index);
+
    static cc65_dbginfo        dbgInfo;
    static QStringList         errors;
    static QString             targetMachine;
+
+   // Milliseconds taken to build each source in the last build, slowest
+   // first, and when each source still building was started.
+   static QList<QPair<QString,int> > buildTimes;
+   static QHash<QString,qint64>      buildStarts;
+   static QElapsedTimer              buildTimer;
+
+   static QVector<SpanEntry>           spanTable;
+   static QVector<AddressRange>        addressRanges;
+   static QVector<int>                 spanPool;
+   static QHash<unsigned,QString>      sourceNames;
+   static QHash<QString,unsigned>      sourceIds;
+   static QHash<quint64,LineEntry>     lineTable;
+   static QHash<QString,SymbolEntry>   symbolTable;
+   static QHash<unsigned,SegmentEntry> segmentTable;
 };
 
 #endif // CCC65INTERFACE_H
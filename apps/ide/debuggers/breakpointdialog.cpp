@@ -1,3 +1,5 @@
+#include <QMessageBox>
+
 #include "breakpointdialog.h"
 #include "ui_breakpointdialog.h"
 
@@ -53,6 +55,9 @@ BreakpointDialog::BreakpointDialog(CBreakpointInfo* pBreakpoints,int bp, QWidget
    ui->mask->setText("FFFF");
 
    ui->enabled->setChecked(true);
+   ui->hitCondition->setCurrentIndex ( eBreakpointHitAlways );
+   ui->hitCountTarget->setValue ( 1 );
+   ui->logOnly->setChecked ( false );
 
    if ( !nesicideProject->getProjectTarget().compare("nes",Qt::CaseInsensitive) )
    {
@@ -525,6 +530,14 @@ void BreakpointDialog::DisplayBreakpoint ( int idx )
 
    ui->enabled->setChecked(pBreakpoint->enabled);
 
+   ui->expression->setText ( pBreakpoint->expression );
+   ui->hitCondition->setCurrentIndex ( pBreakpoint->hitCondition );
+   if ( pBreakpoint->hitCondition != eBreakpointHitAlways )
+   {
+      ui->hitCountTarget->setValue ( pBreakpoint->hitCountTarget );
+   }
+   ui->logOnly->setChecked ( pBreakpoint->action == eBreakpointActionLog );
+
    // Turn resolver on so it populates if the absolute address is known.
    // Only do this for NES platform until it is known whether it is needed
    // for other platforms.
@@ -635,6 +648,7 @@ void BreakpointDialog::on_addBreakpoint_clicked()
    int  data = 0;
    int  event = 0;
    bool maskExclusive = true;
+   char error [ BREAKPOINT_ERROR_LENGTH ];
 
    switch ( ui->itemWidget->currentIndex() )
    {
@@ -739,6 +753,21 @@ void BreakpointDialog::on_addBreakpoint_clicked()
                                        data,
                                        ui->enabled->isChecked() );
 
+   strncpy ( m_breakpoint.expression, ui->expression->text().trimmed().toLatin1().constData(), BREAKPOINT_EXPRESSION_LENGTH );
+   m_breakpoint.expression[BREAKPOINT_EXPRESSION_LENGTH-1] = 0;
+   m_breakpoint.hitCondition = (eBreakpointHitCondition)ui->hitCondition->currentIndex();
+   m_breakpoint.hitCountTarget = ui->hitCountTarget->value();
+   m_breakpoint.action = ui->logOnly->isChecked()?eBreakpointActionLog:eBreakpointActionBreak;
+
+   // Don't let a condition that doesn't compile through; it would never
+   // be true.
+   if ( !m_pBreakpoints->CompileExpression(&m_breakpoint,error) )
+   {
+      QMessageBox::information(0, "Error", QString("Condition: ")+error);
+      ui->expression->setFocus();
+      return;
+   }
+
    accept();
 }
 
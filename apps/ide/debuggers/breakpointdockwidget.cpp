@@ -450,6 +450,10 @@ bool BreakpointDockWidget::serialize(QDomDocument& doc, QDomNode& node)
       breakpointElement.setAttribute("condition",pBreakpoint->condition);
       breakpointElement.setAttribute("datatype",pBreakpoint->dataType);
       breakpointElement.setAttribute("data",pBreakpoint->data);
+      breakpointElement.setAttribute("expression",pBreakpoint->expression);
+      breakpointElement.setAttribute("hitcondition",pBreakpoint->hitCondition);
+      breakpointElement.setAttribute("hitcounttarget",pBreakpoint->hitCountTarget);
+      breakpointElement.setAttribute("action",pBreakpoint->action);
    }
 
    return true;
@@ -496,6 +500,11 @@ bool BreakpointDockWidget::deserialize(QDomDocument& /*doc*/, QDomNode& node, QS
                breakpoint.condition = element.attribute("condition").toInt();
                breakpoint.dataType = (eBreakpointDataType)element.attribute("datatype").toInt();
                breakpoint.data = element.attribute("data").toInt();
+               strncpy(breakpoint.expression,element.attribute("expression").toLatin1().constData(),BREAKPOINT_EXPRESSION_LENGTH);
+               breakpoint.expression[BREAKPOINT_EXPRESSION_LENGTH-1] = 0;
+               breakpoint.hitCondition = (eBreakpointHitCondition)element.attribute("hitcondition").toInt();
+               breakpoint.hitCountTarget = element.attribute("hitcounttarget").toInt();
+               breakpoint.action = (eBreakpointAction)element.attribute("action").toInt();
                m_pBreakpoints->AddBreakpoint(&breakpoint);
                breakpointNode = breakpointNode.nextSibling();
             }
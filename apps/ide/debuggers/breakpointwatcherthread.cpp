@@ -7,6 +7,8 @@
 
 BreakpointWatcherThread::BreakpointWatcherThread(QObject*)
 {
+   m_logEntry = 0;
+
    pThread = new QThread();
 
    moveToThread(pThread);
@@ -21,11 +23,9 @@ BreakpointWatcherThread::~BreakpointWatcherThread()
    delete pThread;
 }
 
-void BreakpointWatcherThread::breakpoint()
+CBreakpointInfo* BreakpointWatcherThread::breakpointDatabase()
 {
    CBreakpointInfo* pBreakpoints = NULL;
-   int idx;
-   char hitMsg [ 512 ];
 
    if ( !nesicideProject->getProjectTarget().compare("nes",Qt::CaseInsensitive) )
    {
@@ -36,6 +36,44 @@ void BreakpointWatcherThread::breakpoint()
       pBreakpoints = c64GetBreakpointDatabase();
    }
 
+   return pBreakpoints;
+}
+
+void BreakpointWatcherThread::updateLog()
+{
+   CBreakpointInfo* pBreakpoints = breakpointDatabase();
+   char logMsg [ BREAKPOINT_LOG_LENGTH ];
+   uint32_t logCount;
+
+   if ( pBreakpoints )
+   {
+      logCount = pBreakpoints->GetLogCount();
+
+      // If the emulator has logged more than the log holds since we last
+      // looked, skip to the oldest entry it still has.
+      if ( (logCount-m_logEntry) > BREAKPOINT_LOG_ENTRIES )
+      {
+         m_logEntry = logCount-BREAKPOINT_LOG_ENTRIES;
+      }
+      for ( ; m_logEntry != logCount; m_logEntry++ )
+      {
+         if ( pBreakpoints->GetLogEntry(m_logEntry,logMsg) )
+         {
+            debugTextLogger->write ( logMsg );
+         }
+      }
+   }
+}
+
+void BreakpointWatcherThread::breakpoint()
+{
+   CBreakpointInfo* pBreakpoints = breakpointDatabase();
+   int idx;
+   char hitMsg [ 512 ];
+
+   // Anything logged before the break goes out first.
+   updateLog();
+
    if ( pBreakpoints )
    {
       for ( idx = 0; idx < pBreakpoints->GetNumBreakpoints(); idx++ )
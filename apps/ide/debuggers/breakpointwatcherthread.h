@@ -4,6 +4,8 @@
 #include <QThread>
 #include <QSemaphore>
 
+#include "cbreakpointinfo.h"
+
 class BreakpointWatcherThread : public QObject
 {
    Q_OBJECT
@@ -17,9 +19,13 @@ signals:
 
 public slots:
    void breakpoint();
+   void updateLog();
 
 protected:
+   CBreakpointInfo* breakpointDatabase();
+
    QThread* pThread;
+   uint32_t m_logEntry;
 };
 
 #endif // BREAKPOINTWATCHERTHREAD_H
@@ -21,9 +21,6 @@ signals:
 
 public slots:
    void snapToHandler(QString item) {};
-
-protected:
-   NesStateSnapshot m_nesState;
 };
 
 #endif // CDEBUGGERBASE_H
@@ -1,4 +1,4 @@
-#include <QFileInfo>
+#include <algorithm>
 
 #include "cdebuggercodeprofilermodel.h"
 
@@ -9,12 +9,101 @@
 
 static char modelStringBuffer [ 2048 ];
 
+// The Code/Data Logger database the code at an address is logged in.
+static CCodeDataLogger* loggerForAddress(unsigned int addr,unsigned int absAddr)
+{
+   if ( addr >= 0x8000 )
+   {
+      return nesGetPhysicalPRGROMCodeDataLoggerDatabase(absAddr);
+   }
+   else if ( addr >= 0x6000 )
+   {
+      return nesGetPhysicalSRAMCodeDataLoggerDatabase(absAddr);
+   }
+   else if ( addr >= 0x5C00 )
+   {
+      return nesGetEXRAMCodeDataLoggerDatabase();
+   }
+   else if ( addr < 0x800 )
+   {
+      return nesGetCpuCodeDataLoggerDatabase();
+   }
+   return NULL;
+}
+
+static bool symbolOrder(const ProfiledItem& item1,const ProfiledItem& item2)
+{
+   if ( item1.pLogger != item2.pLogger )
+   {
+      return std::less<CCodeDataLogger*>()(item1.pLogger,item2.pLogger);
+   }
+   return item1.start < item2.start;
+}
+
+// Orders rows on the raw values of a column.
+class ProfiledItemLessThan
+{
+public:
+   ProfiledItemLessThan(const QVector<ProfiledItem>& symbols,int column,Qt::SortOrder order)
+      : m_symbols(symbols), m_column(column), m_order(order) {}
+
+   bool operator()(int idx1,int idx2) const
+   {
+      const ProfiledItem& item1 = m_symbols.at((m_order == Qt::AscendingOrder)?idx1:idx2);
+      const ProfiledItem& item2 = m_symbols.at((m_order == Qt::AscendingOrder)?idx2:idx1);
+
+      switch ( m_column )
+      {
+      case CodeProfilerCol_Address:
+         if ( item1.pLogger != item2.pLogger )
+         {
+            return symbolOrder(item1,item2);
+         }
+         if ( item1.start != item2.start )
+         {
+            return item1.start < item2.start;
+         }
+         break;
+      case CodeProfilerCol_Size:
+         if ( item1.size != item2.size )
+         {
+            return item1.size < item2.size;
+         }
+         break;
+      case CodeProfilerCol_Calls:
+         if ( item1.count != item2.count )
+         {
+            return item1.count < item2.count;
+         }
+         break;
+      case CodeProfilerCol_Cycles:
+         if ( item1.cycles != item2.cycles )
+         {
+            return item1.cycles < item2.cycles;
+         }
+         break;
+      case CodeProfilerCol_File:
+         if ( item1.file != item2.file )
+         {
+            return item1.file < item2.file;
+         }
+         break;
+      }
+      return item1.symbol < item2.symbol;
+   }
+
+private:
+   const QVector<ProfiledItem>& m_symbols;
+   int m_column;
+   Qt::SortOrder m_order;
+};
+
 CDebuggerCodeProfilerModel::CDebuggerCodeProfilerModel(QObject *parent) :
     QAbstractTableModel(parent)
 {
-   m_currentSortColumn = CodeProfilerCol_Symbol;
+   m_currentSortColumn = CodeProfilerCol_Cycles;
    m_currentSortOrder = Qt::DescendingOrder;
-   m_currentItemCount = 0;
+   m_symbolsLoaded = false;
 }
 
 CDebuggerCodeProfilerModel::~CDebuggerCodeProfilerModel()
@@ -31,55 +120,36 @@ Qt::ItemFlags CDebuggerCodeProfilerModel::flags(const QModelIndex& index) const
    return flags;
 }
 
-QModelIndex CDebuggerCodeProfilerModel::index(int row, int column, const QModelIndex &/*parent*/) const
-{
-   if ( (row >= 0) && (row < m_items.count()) )
-   {
-      CCodeDataLogger* pLogger;
-      unsigned int addr;
-      unsigned int absAddr;
-
-      addr = CCC65Interface::getSymbolAddress(m_items.at(row).symbol);
-      absAddr = CCC65Interface::getSymbolAbsoluteAddress(m_items.at(row).symbol);
-
-      if ( addr >= MEM_32KB )
-      {
-         pLogger = nesGetPhysicalPRGROMCodeDataLoggerDatabase(absAddr);
-         return createIndex(row,column,pLogger);
-      }
-      return QModelIndex();
-   }
-   return QModelIndex();
-}
-
 QVariant CDebuggerCodeProfilerModel::data(const QModelIndex& index, int role) const
 {
-   CCodeDataLogger* pLogger = reinterpret_cast<CCodeDataLogger*>(index.internalPointer());
-   unsigned int addr;
-   unsigned int absAddr;
-
-   if (role != Qt::DisplayRole)
+   if ( (role != Qt::DisplayRole) ||
+        (index.row() < 0) || (index.row() >= m_items.count()) )
    {
       return QVariant();
    }
 
+   const ProfiledItem& profiledItem = item(index.row());
+
    // Get data for columns...
    switch ( index.column() )
    {
    case CodeProfilerCol_Symbol:
-      return m_items.at(index.row()).symbol;
+      return profiledItem.symbol;
       break;
    case CodeProfilerCol_Address:
-      return m_items.at(index.row()).address;
+      return profiledItem.address;
       break;
    case CodeProfilerCol_Size:
-      return QVariant(m_items.at(index.row()).size);
+      return QVariant(profiledItem.size);
       break;
    case CodeProfilerCol_Calls:
-      return QVariant(m_items.at(index.row()).count);
+      return QVariant(profiledItem.count);
+      break;
+   case CodeProfilerCol_Cycles:
+      return QVariant(profiledItem.cycles);
       break;
    case CodeProfilerCol_File:
-      return m_items.at(index.row()).file;
+      return profiledItem.file;
       break;
    }
    return QVariant();
@@ -108,6 +178,9 @@ QVariant CDebuggerCodeProfilerModel::headerData(int section, Qt::Orientation ori
       case CodeProfilerCol_Calls:
          return QString("# Calls");
          break;
+      case CodeProfilerCol_Cycles:
+         return QString("Cycles");
+         break;
       case CodeProfilerCol_File:
          return QString("File");
          break;
@@ -126,15 +199,25 @@ int CDebuggerCodeProfilerModel::columnCount(const QModelIndex&) const
    return CodeProfilerCol_MAX;
 }
 
-void CDebuggerCodeProfilerModel::update()
+void CDebuggerCodeProfilerModel::clear()
+{
+   beginResetModel();
+   m_items.clear();
+   m_symbols.clear();
+   m_symbolsLoaded = false;
+   endResetModel();
+}
+
+void CDebuggerCodeProfilerModel::loadSymbols()
 {
    QStringList symbols = CCC65Interface::getSymbolsForSourceFile(""); // CPTODO: File doesn't matter (yet).
-   CCodeDataLogger* pLogger;
+   ProfiledItem item;
    unsigned int addr;
    unsigned int absAddr;
-   ProfiledItem item;
-   QFileInfo fileInfo;
-   unsigned int mask;
+   unsigned int end;
+   int idx;
+
+   m_symbols.clear();
 
    foreach ( QString symbol, symbols )
    {
@@ -146,122 +229,189 @@ void CDebuggerCodeProfilerModel::update()
 
          if ( absAddr != -1 )
          {
-            pLogger = NULL;
-            if ( addr >= 0x8000 )
-            {
-               pLogger = nesGetPhysicalPRGROMCodeDataLoggerDatabase(absAddr);
-            }
-            else if ( addr >= 0x6000 )
-            {
-               pLogger = nesGetPhysicalSRAMCodeDataLoggerDatabase(absAddr);
-            }
-            else if ( addr >= 0x5C00 )
-            {
-               pLogger = nesGetEXRAMCodeDataLoggerDatabase();
-            }
-            else if ( addr < 0x800 )
+            item.pLogger = loggerForAddress(addr,absAddr);
+            if ( item.pLogger )
             {
-               pLogger = nesGetCpuCodeDataLoggerDatabase();
-            }
-            if ( pLogger )
-            {
-               mask = pLogger->GetMask();
-               if ( (pLogger->GetCount(addr&mask)) &&
-                    (pLogger->GetType(addr&mask) == eLogger_InstructionFetch) )
-               {
-                  item.symbol = symbol;
-                  item.size = CCC65Interface::getSymbolSize(symbol);
-                  item.file = CCC65Interface::getSourceFileFromSymbol(symbol);
-                  fileInfo.setFile(item.file);
-
-                  nesGetPrintableAddressWithAbsolute(modelStringBuffer,addr,absAddr);
-                  item.address = modelStringBuffer;
-                  item.count = pLogger->GetCount(addr&mask);
-                  if ( !m_items.contains(item) )
-                  {
-                     m_items.append(item);
-                  }
-                  else
-                  {
-                     m_items.replace(m_items.indexOf(item),item);
-                  }
-               }
+               item.symbol = symbol;
+               item.size = CCC65Interface::getSymbolSize(symbol);
+               item.file = CCC65Interface::getSourceFileFromSymbol(symbol);
+
+               nesGetPrintableAddressWithAbsolute(modelStringBuffer,addr,absAddr);
+               item.address = modelStringBuffer;
+               item.start = addr&item.pLogger->GetMask();
+               item.end = item.start;
+               item.count = 0;
+               item.cycles = 0;
+               item.profiled = false;
+               m_symbols.append(item);
             }
          }
       }
    }
 
-   sort(m_currentSortColumn,m_currentSortOrder);
+   // A symbol's cycles are those of the code up to the next symbol (at a
+   // different address) logged in the same place.
+   std::sort(m_symbols.begin(),m_symbols.end(),symbolOrder);
+   for ( idx = m_symbols.count()-1; idx >= 0; idx-- )
+   {
+      ProfiledItem& symbol = m_symbols[idx];
+
+      end = symbol.pLogger->GetSize();
+      if ( (idx+1 < m_symbols.count()) &&
+           (m_symbols.at(idx+1).pLogger == symbol.pLogger) )
+      {
+         if ( m_symbols.at(idx+1).start != symbol.start )
+         {
+            end = m_symbols.at(idx+1).start;
+         }
+         else
+         {
+            end = m_symbols.at(idx+1).end;
+         }
+      }
+      symbol.end = end;
+   }
+
+   // Nothing to profile until there is debug information.
+   m_symbolsLoaded = !m_symbols.isEmpty();
 }
 
-void CDebuggerCodeProfilerModel::sort(int column, Qt::SortOrder order)
+void CDebuggerCodeProfilerModel::update()
 {
-   int idx1;
-   int idx2;
-   QString strData1;
-   QString strData2;
-   unsigned int uiData1;
-   unsigned int uiData2;
-
-   if ( (column != m_currentSortColumn) ||
-        (order != m_currentSortOrder) ||
-        (m_items.count() != m_currentItemCount) )
+   QVector<int> newItems;
+   unsigned int offset;
+   quint64 cycles;
+   int idx;
+
+   if ( !m_symbolsLoaded )
    {
-      for ( idx1 = 0; idx1 < m_items.count(); idx1++ )
+      beginResetModel();
+      m_items.clear();
+      loadSymbols();
+      endResetModel();
+   }
+
+   for ( idx = 0; idx < m_symbols.count(); idx++ )
+   {
+      ProfiledItem& symbol = m_symbols[idx];
+
+      if ( (symbol.pLogger->GetCount(symbol.start)) &&
+           (symbol.pLogger->GetType(symbol.start) == eLogger_InstructionFetch) )
       {
-         for ( idx2 = idx1; idx2 < m_items.count(); idx2++ )
+         cycles = 0;
+         for ( offset = symbol.start; offset < symbol.end; offset++ )
          {
-            switch ( column )
-            {
-            case CodeProfilerCol_Size:
-            case CodeProfilerCol_Calls:
-               // These columns require integer sorting.
-               uiData1 = data(index(idx1,column),Qt::DisplayRole).toInt();
-               uiData2 = data(index(idx2,column),Qt::DisplayRole).toInt();
-               switch ( order )
-               {
-               case Qt::AscendingOrder:
-                  if ( uiData1 > uiData2 )
-                  {
-                     m_items.swap(idx1,idx2);
-                  }
-                  break;
-               case Qt::DescendingOrder:
-                  if ( uiData2 > uiData1 )
-                  {
-                     m_items.swap(idx1,idx2);
-                  }
-                  break;
-               }
-               break;
-            default:
-               // Every other column can use string sorting.
-               strData1 = data(index(idx1,column),Qt::DisplayRole).toString();
-               strData2 = data(index(idx2,column),Qt::DisplayRole).toString();
-               switch ( order )
-               {
-               case Qt::AscendingOrder:
-                  if ( strData1 > strData2 )
-                  {
-                     m_items.swap(idx1,idx2);
-                  }
-                  break;
-               case Qt::DescendingOrder:
-                  if ( strData2 > strData1 )
-                  {
-                     m_items.swap(idx1,idx2);
-                  }
-                  break;
-               }
-               break;
-            }
+            cycles += symbol.pLogger->GetCycles(offset);
+         }
+
+         symbol.count = symbol.pLogger->GetCount(symbol.start);
+         symbol.cycles = cycles;
+
+         if ( !symbol.profiled )
+         {
+            symbol.profiled = true;
+            newItems.append(idx);
          }
       }
    }
 
+   if ( !newItems.isEmpty() )
+   {
+      beginInsertRows(QModelIndex(),m_items.count(),m_items.count()+newItems.count()-1);
+      m_items += newItems;
+      endInsertRows();
+   }
+
+   sort(m_currentSortColumn,m_currentSortOrder);
+}
+
+void CDebuggerCodeProfilerModel::sort(int column, Qt::SortOrder order)
+{
+   emit layoutAboutToBeChanged();
+
+   std::sort(m_items.begin(),m_items.end(),ProfiledItemLessThan(m_symbols,column,order));
+
    m_currentSortColumn = column;
    m_currentSortOrder = order;
-   m_currentItemCount = m_items.count();
 
    emit layoutChanged();
 }
+
+int CDebuggerCodeProfilerModel::findSymbol(CCodeDataLogger* pLogger,unsigned int offset) const
+{
+   ProfiledItem key;
+   QVector<ProfiledItem>::const_iterator pSymbol;
+
+   key.pLogger = pLogger;
+   key.start = offset;
+
+   // The last symbol at or before the offset, if its code runs to the offset.
+   pSymbol = std::upper_bound(m_symbols.constBegin(),m_symbols.constEnd(),key,symbolOrder);
+   if ( pSymbol != m_symbols.constBegin() )
+   {
+      pSymbol--;
+      if ( (pSymbol->pLogger == pLogger) &&
+           (offset < pSymbol->end) )
+      {
+         return pSymbol-m_symbols.constBegin();
+      }
+   }
+   return -1;
+}
+
+QString CDebuggerCodeProfilerModel::routineName(unsigned int addr,unsigned int absAddr) const
+{
+   CCodeDataLogger* pLogger = loggerForAddress(addr,absAddr);
+   unsigned int offset;
+   int idx = -1;
+
+   if ( pLogger )
+   {
+      offset = addr&pLogger->GetMask();
+      idx = findSymbol(pLogger,offset);
+   }
+
+   if ( idx < 0 )
+   {
+      return QString("$%1").arg(addr,4,16,QChar('0')).toUpper();
+   }
+   if ( m_symbols.at(idx).start != offset )
+   {
+      return m_symbols.at(idx).symbol+"+"+QString::number(offset-m_symbols.at(idx).start);
+   }
+   return m_symbols.at(idx).symbol;
+}
+
+void CDebuggerCodeProfilerModel::exportCallStacks(QTextStream& stream)
+{
+   CCallProfiler* pProfiler = nesGetCallProfilerDatabase();
+   QVector<QString> stacks;
+   int node;
+
+   if ( !m_symbolsLoaded )
+   {
+      loadSymbols();
+   }
+
+   // Nodes are always added after their caller, so one pass in order
+   // has every caller's stack ready for its callees.
+   stacks.resize(pProfiler->GetNumNodes());
+   for ( node = 0; node < pProfiler->GetNumNodes(); node++ )
+   {
+      const CallProfilerNode* pNode = pProfiler->GetNode(node);
+
+      if ( node == CALL_PROFILER_ROOT )
+      {
+         stacks[node] = "RESET";
+      }
+      else
+      {
+         stacks[node] = stacks.at(pNode->parent)+";"+routineName(pNode->addr,pNode->absAddr);
+      }
+
+      if ( pNode->cycles )
+      {
+         stream << stacks.at(node) << " " << pNode->cycles << "\n";
+      }
+   }
+}
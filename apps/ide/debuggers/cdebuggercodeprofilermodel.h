@@ -2,7 +2,10 @@
 #define CDEBUGGERCODEPROFILERMODEL_H
 
 #include <QAbstractTableModel>
-#include <QList>
+#include <QTextStream>
+#include <QVector>
+
+class CCodeDataLogger;
 
 enum
 {
@@ -10,6 +13,7 @@ enum
    CodeProfilerCol_Address,
    CodeProfilerCol_Size,
    CodeProfilerCol_Calls,
+   CodeProfilerCol_Cycles,
    CodeProfilerCol_File,
    CodeProfilerCol_MAX
 };
@@ -21,17 +25,16 @@ struct ProfiledItem
    QString address;
    unsigned int size;
    unsigned int count;
-   bool operator==(const ProfiledItem& rI)
-   {
-      if ( (rI.file == file) &&
-           (rI.symbol == symbol) &&
-           (rI.address == address) &&
-           (rI.size == size) )
-      {
-         return true;
-      }
-      return false;
-   }
+   quint64 cycles;
+
+   // Where the symbol's code is logged, and the range of the logger from
+   // the symbol up to the next symbol that its cycles are counted over.
+   CCodeDataLogger* pLogger;
+   unsigned int start;
+   unsigned int end;
+
+   // Whether the symbol has run, and so has a row.
+   bool profiled;
 };
 
 class CDebuggerCodeProfilerModel : public QAbstractTableModel
@@ -41,14 +44,18 @@ public:
    explicit CDebuggerCodeProfilerModel(QObject *parent = 0);
    virtual ~CDebuggerCodeProfilerModel();
    Qt::ItemFlags flags(const QModelIndex& index) const;
-   QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
    QVariant data(const QModelIndex& index, int role) const;
    QVariant headerData(int section, Qt::Orientation orientation, int role) const;
    int columnCount(const QModelIndex& parent = QModelIndex()) const;
    int rowCount(const QModelIndex& parent = QModelIndex()) const;
 
-   QList<ProfiledItem> getItems() { return m_items; }
-   void clear() { m_items.clear(); }
+   const ProfiledItem& item(int row) const { return m_symbols.at(m_items.at(row)); }
+   void clear();
+
+   // Writes the call stacks seen by the emulator's call profiler in the
+   // "folded" format flame graph tools read: one line per call chain,
+   // callers first separated by semicolons, followed by the cycles spent.
+   void exportCallStacks(QTextStream& stream);
 
 signals:
 
@@ -57,10 +64,20 @@ public slots:
    void sort(int column, Qt::SortOrder order);
 
 private:
-   QList<ProfiledItem> m_items;
+   void loadSymbols();
+   int findSymbol(CCodeDataLogger* pLogger,unsigned int offset) const;
+   QString routineName(unsigned int addr,unsigned int absAddr) const;
+
+   // Every symbol that can be profiled, in logger and address order.  They
+   // are looked up once per debug information rather than once per update.
+   QVector<ProfiledItem> m_symbols;
+   bool m_symbolsLoaded;
+
+   // The rows, as indexes into m_symbols, in display order.
+   QVector<int> m_items;
+
    int m_currentSortColumn;
    Qt::SortOrder m_currentSortOrder;
-   int m_currentItemCount;
 };
 
 #endif // CDEBUGGERCODEPROFILERMODEL_H
@@ -30,7 +30,18 @@ QVariant CDebuggerExecutionTracerModel::data(const QModelIndex& index, int role)
       return QVariant();
    }
 
-   GetPrintable((TracerInfo*)index.internalPointer(), index.column(), modelStringBuffer);
+   // Fetch the sample from the tracer only now that it's to be shown.
+   // The index holds just the sample number.
+   TracerInfo sample;
+
+   if ( m_pTracer->GetRecord((uint32_t)index.internalId(), &sample) )
+   {
+      GetPrintable(&sample, index.column(), modelStringBuffer);
+   }
+   else
+   {
+      modelStringBuffer[0] = 0;
+   }
 
    return QVariant(modelStringBuffer);
 }
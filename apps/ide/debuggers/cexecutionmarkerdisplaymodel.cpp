@@ -33,15 +33,14 @@ Qt::ItemFlags CExecutionMarkerDisplayModel::flags(const QModelIndex& index) cons
 QVariant CExecutionMarkerDisplayModel::data(const QModelIndex& index, int role) const
 {
 //   int cycles = nesGetSystemMode()==SYSTEM_NTSC?
-   CMarker* pMarkers = nesGetExecutionMarkerDatabase();
-   MarkerSetInfo* pMarker;
+   const MarkerSetInfo* pMarker;
 
    if ( !index.isValid() )
    {
       return QVariant();
    }
 
-   pMarker = pMarkers->GetMarker(index.row());
+   pMarker = nesGetExecutionMarker(index.row());
    if (role == Qt::BackgroundColorRole)
    {
       if ( index.column() == ExecutionVisualizerCol_Color )
@@ -1,3 +1,5 @@
+#include <QFileDialog>
+
 #include "codeprofilerdockwidget.h"
 #include "ui_codeprofilerdockwidget.h"
 
@@ -18,7 +20,7 @@ CodeProfilerDockWidget::CodeProfilerDockWidget(QWidget *parent) :
    ui->tableView->setModel(model);
    ui->tableView->resizeColumnsToContents();
 
-   ui->tableView->sortByColumn(CodeProfilerCol_Calls,Qt::DescendingOrder);
+   ui->tableView->sortByColumn(CodeProfilerCol_Cycles,Qt::DescendingOrder);
 
    QObject::connect(ui->tableView->horizontalHeader(),SIGNAL(sortIndicatorChanged(int,Qt::SortOrder)),model,SLOT(sort(int,Qt::SortOrder)));
 
@@ -67,13 +69,13 @@ void CodeProfilerDockWidget::hideEvent(QHideEvent */*event*/)
 
 void CodeProfilerDockWidget::updateUi()
 {
-   ui->symbolsProfiled->setText(QString::number(model->getItems().count()));
+   ui->symbolsProfiled->setText(QString::number(model->rowCount()));
 }
 
 void CodeProfilerDockWidget::on_tableView_doubleClicked(QModelIndex index)
 {
-   QString symbol = model->getItems().at(index.row()).symbol;
-   QString file = model->getItems().at(index.row()).file;
+   QString symbol = model->item(index.row()).symbol;
+   QString file = model->item(index.row()).file;
 
    emit snapTo("SourceNavigatorFile,"+file);
    emit snapTo("SourceNavigatorSymbol,"+symbol);
@@ -82,7 +84,26 @@ void CodeProfilerDockWidget::on_tableView_doubleClicked(QModelIndex index)
 void CodeProfilerDockWidget::on_clear_clicked()
 {
    nesClearCodeDataLoggerDatabases();
+   nesGetCallProfilerDatabase()->Clear();
 
    model->clear();
    model->update();
 }
+
+void CodeProfilerDockWidget::on_exportCallStacks_clicked()
+{
+   QString fileName = QFileDialog::getSaveFileName(this,"Export Call Stacks",QDir::currentPath(),"Folded Call Stacks (*.folded *.txt)");
+
+   if ( !fileName.isEmpty() )
+   {
+      QFile file(fileName);
+
+      if ( file.open(QIODevice::WriteOnly|QIODevice::Truncate|QIODevice::Text) )
+      {
+         QTextStream stream(&file);
+
+         model->exportCallStacks(stream);
+         file.close();
+      }
+   }
+}
@@ -30,6 +30,7 @@ signals:
 
 private slots:
    void on_clear_clicked();
+   void on_exportCallStacks_clicked();
    void on_tableView_doubleClicked(QModelIndex index);
    void updateUi();
    void updateTargetMachine(QString target);
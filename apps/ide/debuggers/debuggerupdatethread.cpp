@@ -1,31 +1,270 @@
+#include <QRunnable>
+#include <QThread>
+
 #include "debuggerupdatethread.h"
 
-#include "dbg_cnesppu.h"
+#include "cbuildertextlogger.h"
+
+#include "nes_emulator_core.h"
 
 #include "main.h"
 
-DebuggerUpdateThread::DebuggerUpdateThread(void (*func)(),QObject */*parent*/) :
-    QObject(),_func(func)
+QList<DebuggerUpdateThread*> DebuggerUpdateThread::updaters;
+QMutex                       DebuggerUpdateThread::updatersMutex;
+QThreadPool*                 DebuggerUpdateThread::pool = NULL;
+QElapsedTimer                DebuggerUpdateThread::clock;
+
+// Draws an inspector on one of the pool's threads.
+class DebuggerUpdateThread::Renderer : public QRunnable
 {
-   pThread = new QThread();
+public:
+   Renderer(DebuggerUpdateThread* updater,void (*func)()) : m_updater(updater), _func(func) {}
+
+   void run()
+   {
+      QElapsedTimer timer;
+
+      // The inspector may have gone away while this was waiting for a thread.
+      updatersMutex.lock();
+      if ( !updaters.contains(m_updater) )
+      {
+         updatersMutex.unlock();
+         return;
+      }
+      m_updater->m_rendering.lock();
+      updatersMutex.unlock();
+
+      timer.start();
 
-   moveToThread(pThread);
+      // Draw from the machine as it was last published rather than as it
+      // is while the emulator keeps running.
+      nesAcquireDebuggerSnapshot();
+      _func();
+      nesReleaseDebuggerSnapshot();
+
+      m_updater->m_workTime = timer.nsecsElapsed()/1000;
+
+      QMetaObject::invokeMethod(m_updater,"rendered",Qt::QueuedConnection);
 
-   pThread->start();
+      m_updater->m_rendering.unlock();
+   }
+
+private:
+   DebuggerUpdateThread* m_updater;
+   void (*_func)();
+};
+
+DebuggerUpdateThread::DebuggerUpdateThread(void (*func)(),QWidget* widget,QObject *parent) :
+    QObject(parent),
+    _func(func),
+    m_widget(widget),
+    m_budget(DEBUGGER_UPDATE_BUDGET),
+    m_pending(false),
+    m_running(false),
+    m_started(0),
+    m_nextStart(0),
+    m_averageRender(0),
+    m_workTime(0),
+    m_requests(0),
+    m_coalesced(0),
+    m_hidden(0),
+    m_renders(0),
+    m_renderTime(0),
+    m_longestRender(0),
+    m_lastRender(0)
+{
+   if ( !pool )
+   {
+      // Leave the emulator and the UI a core each.
+      pool = new QThreadPool();
+      pool->setMaxThreadCount(qMax(1,QThread::idealThreadCount()-2));
+      clock.start();
+   }
+
+   m_holdOff.setSingleShot(true);
+   QObject::connect(&m_holdOff,SIGNAL(timeout()),this,SLOT(schedule()));
+
+   updatersMutex.lock();
+   updaters.append(this);
+   updatersMutex.unlock();
 }
 
 DebuggerUpdateThread::~DebuggerUpdateThread()
 {
-   _func = NULL;
-   pThread->exit(0);
-   pThread->wait();
-   delete pThread;
+   updatersMutex.lock();
+   updaters.removeAll(this);
+   updatersMutex.unlock();
+
+   // Wait for a drawing that's already started.
+   m_rendering.lock();
+   m_rendering.unlock();
+
+   // Anyone waiting for this inspector to finish drawing can go ahead.
+   if ( m_running )
+   {
+      foreach ( DebuggerUpdateThread* updater, updaters )
+      {
+         if ( updater->m_pending )
+         {
+            QMetaObject::invokeMethod(updater,"schedule",Qt::QueuedConnection);
+         }
+      }
+   }
 }
 
 void DebuggerUpdateThread::updateDebuggers()
 {
+   m_requests++;
+
+   // Inspectors that can't be seen are drawn when they're shown.
+   if ( m_widget && (!m_widget->isVisible()) )
+   {
+      m_hidden++;
+      return;
+   }
+
+   if ( m_pending || m_running )
+   {
+      m_coalesced++;
+      m_pending = true;
+      return;
+   }
+
+   m_pending = true;
+   schedule();
+}
+
+bool DebuggerUpdateThread::isBlocked() const
+{
+   // Inspectors that share a drawing function share what it draws into,
+   // so only one of them may be drawn at a time.
+   foreach ( DebuggerUpdateThread* updater, updaters )
+   {
+      if ( (updater != this) && updater->m_running && _func && (updater->_func == _func) )
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+void DebuggerUpdateThread::schedule()
+{
+   qint64 now = clock.nsecsElapsed()/1000;
+
+   if ( (!m_pending) || m_running || isBlocked() )
+   {
+      return;
+   }
+
+   // Hold back an inspector that's been taking more than its share.
+   if ( now < m_nextStart )
+   {
+      if ( !m_holdOff.isActive() )
+      {
+         m_holdOff.start((int)(((m_nextStart-now)+999)/1000));
+      }
+      return;
+   }
+
+   m_pending = false;
+   m_running = true;
+   m_started = now;
+
    if ( _func )
-      _func();
+   {
+      pool->start(new Renderer(this,_func));
+   }
+   else
+   {
+      m_workTime = 0;
+      QMetaObject::invokeMethod(this,"rendered",Qt::QueuedConnection);
+   }
+}
 
+void DebuggerUpdateThread::rendered()
+{
+   QElapsedTimer timer;
+   qint64 total;
+
+   timer.start();
    emit updateComplete();
+   total = m_workTime+(timer.nsecsElapsed()/1000);
+
+   m_running = false;
+   m_renders++;
+   m_renderTime += total;
+   m_lastRender = total;
+   if ( total > m_longestRender )
+   {
+      m_longestRender = total;
+   }
+
+   // Spread drawings out so they take no more than the budget per frame
+   // on average.
+   if ( m_averageRender )
+   {
+      m_averageRender += (total-m_averageRender)/DEBUGGER_UPDATE_AVERAGE_RENDERS;
+   }
+   else
+   {
+      m_averageRender = total;
+   }
+   m_nextStart = m_started+((m_averageRender*DEBUGGER_UPDATE_FRAME_PERIOD)/qMax(1,m_budget));
+
+   schedule();
+
+   // Let inspectors that were waiting on this drawing function go.
+   foreach ( DebuggerUpdateThread* updater, updaters )
+   {
+      if ( (updater != this) && updater->m_pending && (updater->_func == _func) )
+      {
+         updater->schedule();
+      }
+   }
+}
+
+void DebuggerUpdateThread::report()
+{
+   int renders = 0;
+
+   foreach ( DebuggerUpdateThread* updater, updaters )
+   {
+      renders += updater->m_renders;
+   }
+
+   if ( renders < DEBUGGER_UPDATE_REPORT_AFTER )
+   {
+      return;
+   }
+
+   foreach ( DebuggerUpdateThread* updater, updaters )
+   {
+      if ( updater->m_requests )
+      {
+         QString name = updater->m_widget?updater->m_widget->windowTitle():updater->objectName();
+
+         if ( updater->m_renders )
+         {
+            debugTextLogger->write("<b>"+name+":</b> drawn "+QString::number(updater->m_renders)+" times, "+
+                                   QString::number(updater->m_renderTime/updater->m_renders)+"us average, "+
+                                   QString::number(updater->m_longestRender)+"us longest, "+
+                                   QString::number(updater->m_lastRender)+"us last; "+
+                                   QString::number(updater->m_coalesced)+" updates coalesced, "+
+                                   QString::number(updater->m_hidden)+" skipped while hidden.");
+         }
+         else
+         {
+            debugTextLogger->write("<b>"+name+":</b> not drawn; "+
+                                   QString::number(updater->m_hidden)+" updates skipped while hidden.");
+         }
+      }
+
+      updater->m_requests = 0;
+      updater->m_coalesced = 0;
+      updater->m_hidden = 0;
+      updater->m_renders = 0;
+      updater->m_renderTime = 0;
+      updater->m_longestRender = 0;
+   }
 }
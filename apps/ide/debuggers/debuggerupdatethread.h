@@ -1,16 +1,55 @@
 #ifndef DEBUGGERUPDATETHREAD_H
 #define DEBUGGERUPDATETHREAD_H
 
-#include <QThread>
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QThreadPool>
+#include <QTimer>
+#include <QWidget>
 
+// Time each inspector may spend drawing per emulated frame, in microseconds.
+// An inspector that takes longer is drawn less often than it's asked to be.
+#define DEBUGGER_UPDATE_BUDGET       2000
+
+// Length of an emulated frame, in microseconds.
+#define DEBUGGER_UPDATE_FRAME_PERIOD 16639
+
+// Number of drawings the running average of an inspector's drawing time
+// is taken over, roughly; each drawing moves the average 1/N of the way
+// toward it.  A single slow drawing doesn't hold an inspector back for
+// long, but one that's slow every time is.
+#define DEBUGGER_UPDATE_AVERAGE_RENDERS 8
+
+// Number of drawings since the last report before the scheduler reports
+// again; stepping through code shouldn't log a report for every step.
+#define DEBUGGER_UPDATE_REPORT_AFTER 60
+
+// Each inspector that draws the emulated machine owns one of these to get
+// its drawing done.  The drawing function runs on a pool of threads shared
+// by all inspectors, from the snapshot of the machine the emulator last
+// published, and updateComplete() is emitted on the UI thread when it's
+// done so the inspector can show what was drawn.  An inspector without a
+// drawing function just gets updateComplete() and does its work there.
+//
+// Updates asked for while one is waiting or being drawn are coalesced into
+// one more drawing afterwards.  An inspector that isn't visible isn't drawn;
+// it's drawn when it's shown.  An inspector whose drawing takes more than
+// its budget per frame on average is held back so it can't take time from
+// the emulator.
 class DebuggerUpdateThread : public QObject
 {
    Q_OBJECT
 public:
-   explicit DebuggerUpdateThread(void (*func)(),QObject *parent = 0);
+   explicit DebuggerUpdateThread(void (*func)(),QWidget* widget,QObject *parent = 0);
    ~DebuggerUpdateThread();
 
    void changeFunction(void (*func)()) { _func = func; }
+   void setBudget(int budget) { m_budget = budget; }
+
+   // Logs how long each inspector has spent drawing since the last report.
+   static void report();
 
 signals:
    void updateComplete();
@@ -18,9 +57,47 @@ signals:
 public slots:
    void updateDebuggers();
 
+private slots:
+   void schedule();
+   void rendered();
+
 private:
+   class Renderer;
+   friend class Renderer;
+
+   bool isBlocked() const;
+
    void (*_func)();
-   QThread* pThread;
+   QWidget* m_widget;
+   int      m_budget;
+
+   // Owned by the UI thread.
+   bool     m_pending;
+   bool     m_running;
+   qint64   m_started;
+   qint64   m_nextStart;
+   qint64   m_averageRender;
+   QTimer   m_holdOff;
+
+   // Written by the drawing thread before rendered() is posted.
+   qint64   m_workTime;
+
+   // Held by the drawing thread while it uses this object.
+   QMutex   m_rendering;
+
+   // Statistics since the last report.
+   int      m_requests;
+   int      m_coalesced;
+   int      m_hidden;
+   int      m_renders;
+   qint64   m_renderTime;
+   qint64   m_longestRender;
+   qint64   m_lastRender;
+
+   static QList<DebuggerUpdateThread*> updaters;
+   static QMutex                       updatersMutex;
+   static QThreadPool*                 pool;
+   static QElapsedTimer                clock;
 };
 
 #endif // DEBUGGERUPDATETHREAD_H
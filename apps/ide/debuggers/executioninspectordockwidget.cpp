@@ -2,10 +2,14 @@
 #include "ui_executioninspectordockwidget.h"
 
 #include "dbg_cnes.h"
+#include "ctracer.h"
 
 #include "cobjectregistry.h"
 #include "main.h"
 
+#include <QFileDialog>
+#include <QMessageBox>
+
 ExecutionInspectorDockWidget::ExecutionInspectorDockWidget(QWidget *parent) :
     CDebuggerBase(parent),
     ui(new Ui::ExecutionInspectorDockWidget)
@@ -17,6 +21,10 @@ ExecutionInspectorDockWidget::ExecutionInspectorDockWidget(QWidget *parent) :
    ui->showCPU->setChecked(true);
    ui->showPPU->setChecked(true);
    ui->tableView->setModel(model);
+
+   ui->traceEnabled->setChecked(nesGetExecutionTracerDatabase()->IsEnabled());
+   ui->traceCPU->setChecked(true);
+   ui->tracePPU->setChecked(true);
 }
 
 ExecutionInspectorDockWidget::~ExecutionInspectorDockWidget()
@@ -32,11 +40,14 @@ void ExecutionInspectorDockWidget::updateTargetMachine(QString /*target*/)
 
    QObject::connect ( breakpointWatcher, SIGNAL(breakpointHit()), this, SLOT(updateTracer()) );
    QObject::connect ( breakpointWatcher, SIGNAL(breakpointHit()), model, SLOT(update()) );
+   QObject::connect ( breakpointWatcher, SIGNAL(breakpointHit()), this, SLOT(emulatorPaused()) );
    if ( emulator )
    {
       QObject::connect ( emulator, SIGNAL(machineReady()), model, SLOT(update()));
       QObject::connect ( emulator, SIGNAL(emulatorReset()), model, SLOT(update()) );
       QObject::connect ( emulator, SIGNAL(emulatorPaused(bool)), model, SLOT(update()) );
+      QObject::connect ( emulator, SIGNAL(emulatorStarted()), this, SLOT(emulatorStarted()) );
+      QObject::connect ( emulator, SIGNAL(emulatorPaused(bool)), this, SLOT(emulatorPaused()) );
    }
 }
 
@@ -128,3 +139,138 @@ void ExecutionInspectorDockWidget::on_showPPU_toggled(bool checked)
 void ExecutionInspectorDockWidget::on_actionBreak_on_CPU_execution_here_triggered()
 {
 }
+
+void ExecutionInspectorDockWidget::applyFilter()
+{
+   uint32_t sourceMask = 0;
+   uint32_t typeMask;
+
+   // The inspector shows APU and mapper cycles along with the CPU's.
+   if ( ui->traceCPU->isChecked() )
+   {
+      sourceMask |= (1<<eNESSource_CPU)|(1<<eNESSource_APU)|(1<<eNESSource_Mapper);
+   }
+   if ( ui->tracePPU->isChecked() )
+   {
+      sourceMask |= (1<<eNESSource_PPU);
+   }
+   if ( sourceMask == ((1<<eNESSource_CPU)|(1<<eNESSource_PPU)|(1<<eNESSource_APU)|(1<<eNESSource_Mapper)) )
+   {
+      sourceMask = TRACER_SOURCE_ALL;
+   }
+
+   switch ( ui->traceTypes->currentIndex() )
+   {
+      case 1:
+         typeMask = TRACER_TYPE_BIT(eTracer_InstructionFetch);
+         break;
+      case 2:
+         typeMask = TRACER_TYPE_BIT(eTracer_DataRead)|
+                    TRACER_TYPE_BIT(eTracer_DataWrite);
+         break;
+      case 3:
+         typeMask = TRACER_TYPE_BIT(eTracer_RESET)|
+                    TRACER_TYPE_BIT(eTracer_NMI)|
+                    TRACER_TYPE_BIT(eTracer_IRQ)|
+                    TRACER_TYPE_BIT(eTracer_IRQRelease)|
+                    TRACER_TYPE_BIT(eTracer_DMA)|
+                    TRACER_TYPE_BIT(eTracer_StolenCycle);
+         break;
+      default:
+         typeMask = TRACER_TYPE_ALL;
+         break;
+   }
+
+   nesGetExecutionTracerDatabase()->SetFilter(sourceMask,
+                                              typeMask,
+                                              ui->traceAddrLow->text().toInt(0,16),
+                                              ui->traceAddrHigh->text().toInt(0,16));
+}
+
+void ExecutionInspectorDockWidget::on_traceEnabled_toggled(bool checked)
+{
+   nesGetExecutionTracerDatabase()->Enable(checked);
+}
+
+void ExecutionInspectorDockWidget::on_traceCPU_toggled(bool /*checked*/)
+{
+   applyFilter();
+}
+
+void ExecutionInspectorDockWidget::on_tracePPU_toggled(bool /*checked*/)
+{
+   applyFilter();
+}
+
+void ExecutionInspectorDockWidget::on_traceTypes_currentIndexChanged(int /*index*/)
+{
+   applyFilter();
+}
+
+void ExecutionInspectorDockWidget::on_traceAddrLow_editingFinished()
+{
+   applyFilter();
+}
+
+void ExecutionInspectorDockWidget::on_traceAddrHigh_editingFinished()
+{
+   applyFilter();
+}
+
+void ExecutionInspectorDockWidget::on_capture_clicked(bool checked)
+{
+   CTracer* pTracer = nesGetExecutionTracerDatabase();
+
+   if ( checked )
+   {
+      QString fileName = QFileDialog::getSaveFileName(this,"Capture Execution Trace",QDir::currentPath(),"Execution Trace (*.trace)");
+
+      if ( fileName.isEmpty() )
+      {
+         ui->capture->setChecked(false);
+         return;
+      }
+      if ( !pTracer->MapTracerFile(QDir::toNativeSeparators(fileName).toLocal8Bit().constData(),
+                                   ui->captureDepth->value()*1024,
+                                   ui->captureWrap->isChecked()) )
+      {
+         QMessageBox::warning(this,"Capture Execution Trace","Cannot create "+fileName);
+         ui->capture->setChecked(false);
+         return;
+      }
+      ui->capture->setText("Stop Capture");
+   }
+   else
+   {
+      pTracer->UnmapTracerFile();
+      ui->capture->setText("Capture to File...");
+   }
+   ui->captureDepth->setEnabled(!checked);
+   ui->captureWrap->setEnabled(!checked);
+   model->update();
+}
+
+void ExecutionInspectorDockWidget::emulatorStarted()
+{
+   // The tracer's columns move when a capture starts or stops, so that
+   // can only be done while the emulator isn't writing them.  The filter
+   // is likewise only changed between runs.
+   ui->traceEnabled->setEnabled(false);
+   ui->traceCPU->setEnabled(false);
+   ui->tracePPU->setEnabled(false);
+   ui->traceTypes->setEnabled(false);
+   ui->traceAddrLow->setEnabled(false);
+   ui->traceAddrHigh->setEnabled(false);
+   ui->capture->setEnabled(false);
+}
+
+void ExecutionInspectorDockWidget::emulatorPaused()
+{
+   ui->traceEnabled->setEnabled(true);
+   ui->traceCPU->setEnabled(true);
+   ui->tracePPU->setEnabled(true);
+   ui->traceTypes->setEnabled(true);
+   ui->traceAddrLow->setEnabled(true);
+   ui->traceAddrHigh->setEnabled(true);
+   ui->capture->setEnabled(true);
+}
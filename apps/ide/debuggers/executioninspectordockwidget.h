@@ -30,11 +30,21 @@ public slots:
 private:
    Ui::ExecutionInspectorDockWidget *ui;
    CDebuggerExecutionTracerModel* model;
+   void applyFilter();
 
 private slots:
    void on_actionBreak_on_CPU_execution_here_triggered();
    void on_showCPU_toggled(bool checked);
    void on_showPPU_toggled(bool checked);
+   void on_traceEnabled_toggled(bool checked);
+   void on_traceCPU_toggled(bool checked);
+   void on_tracePPU_toggled(bool checked);
+   void on_traceTypes_currentIndexChanged(int index);
+   void on_traceAddrLow_editingFinished();
+   void on_traceAddrHigh_editingFinished();
+   void on_capture_clicked(bool checked);
+   void emulatorStarted();
+   void emulatorPaused();
 };
 
 #endif // EXECUTIONINSPECTORDOCKWIDGET_H
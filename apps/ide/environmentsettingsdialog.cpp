@@ -13,6 +13,7 @@ bool EnvironmentSettingsDialog::m_useInternalGameDatabase;
 QString EnvironmentSettingsDialog::m_gameDatabase;
 bool EnvironmentSettingsDialog::m_showWelcomeOnStart;
 bool EnvironmentSettingsDialog::m_saveAllOnCompile;
+int EnvironmentSettingsDialog::m_buildJobs;
 bool EnvironmentSettingsDialog::m_rememberWindowSettings;
 bool EnvironmentSettingsDialog::m_trackRecentProjects;
 QString EnvironmentSettingsDialog::m_romPath;
@@ -110,6 +111,7 @@ EnvironmentSettingsDialog::EnvironmentSettingsDialog(QWidget* parent) :
 
    ui->showWelcomeOnStart->setChecked(m_showWelcomeOnStart);
    ui->saveAllOnCompile->setChecked(m_saveAllOnCompile);
+   ui->buildJobs->setValue(m_buildJobs);
    ui->rememberWindowSettings->setChecked(m_rememberWindowSettings);
    ui->trackRecentProjects->setChecked(m_trackRecentProjects);
 
@@ -208,6 +210,7 @@ void EnvironmentSettingsDialog::readSettings()
    m_gameDatabase = settings.value("GameDatabase").toString();
    m_showWelcomeOnStart = settings.value("showWelcomeOnStart",QVariant(true)).toBool();
    m_saveAllOnCompile = settings.value("saveAllOnCompile",QVariant(true)).toBool();
+   m_buildJobs = settings.value("buildJobs",QVariant(0)).toInt();
    m_rememberWindowSettings = settings.value("rememberWindowSettings",QVariant(true)).toBool();
    m_trackRecentProjects = settings.value("trackRecentProjects",QVariant(true)).toBool();
    m_romPath = settings.value("romPath").toString();
@@ -287,6 +290,7 @@ void EnvironmentSettingsDialog::writeSettings()
    m_gameDatabase = ui->GameDatabasePathEdit->text();
    m_showWelcomeOnStart = ui->showWelcomeOnStart->isChecked();
    m_saveAllOnCompile = ui->saveAllOnCompile->isChecked();
+   m_buildJobs = ui->buildJobs->value();
    m_rememberWindowSettings = ui->rememberWindowSettings->isChecked();
    m_trackRecentProjects = ui->trackRecentProjects->isChecked();
    m_romPath = ui->ROMPath->text();
@@ -329,6 +333,7 @@ void EnvironmentSettingsDialog::writeSettings()
    settings.beginGroup("Environment");
    settings.setValue("showWelcomeOnStart",m_showWelcomeOnStart);
    settings.setValue("saveAllOnCompile",m_saveAllOnCompile);
+   settings.setValue("buildJobs",m_buildJobs);
    settings.setValue("rememberWindowSettings",m_rememberWindowSettings);
    settings.setValue("trackRecentProjects",m_trackRecentProjects);
 
@@ -2,28 +2,100 @@
 
 #include <QResource>
 #include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QHash>
+#include <QVector>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QXmlStreamReader>
 #include <QCryptographicHash>
 
+#include <algorithm>
+#include <string.h>
+
 #include "nes_emulator_core.h"
 
+static quint32 crc32Table [ 256 ];
+
+static quint32 crc32(quint32 crc,const uchar* data,int length)
+{
+   quint32 entry;
+   int bit;
+
+   if ( !crc32Table[1] )
+   {
+      for ( entry = 0; entry < 256; entry++ )
+      {
+         crc32Table[entry] = entry;
+         for ( bit = 0; bit < 8; bit++ )
+         {
+            crc32Table[entry] = (crc32Table[entry]&1)?(0xEDB88320^(crc32Table[entry]>>1)):(crc32Table[entry]>>1);
+         }
+      }
+   }
+
+   crc = ~crc;
+   while ( length-- )
+   {
+      crc = crc32Table[(crc^(*data++))&0xFF]^(crc>>8);
+   }
+   return ~crc;
+}
+
+static bool sha1Less(const GameDBIndexCartridge& cartridge1,const GameDBIndexCartridge& cartridge2)
+{
+   return memcmp(cartridge1.sha1,cartridge2.sha1,20) < 0;
+}
+
+static bool crcLess(const GameDBIndexCRC& crc1,const GameDBIndexCRC& crc2)
+{
+   return crc1.crc32 < crc2.crc32;
+}
+
 CGameDatabaseHandler::CGameDatabaseHandler()
 {
+   m_pIndex = NULL;
+   m_pHeader = NULL;
+   m_pCartridge = NULL;
+}
+
+CGameDatabaseHandler::~CGameDatabaseHandler()
+{
+   close();
+}
+
+void CGameDatabaseHandler::close()
+{
+   if ( m_indexFile.isOpen() )
+   {
+      m_indexFile.close();
+   }
+   m_index.clear();
+   m_pIndex = NULL;
+   m_pHeader = NULL;
+   m_pCartridge = NULL;
 }
 
 bool CGameDatabaseHandler::initialize(QString fileName)
 {
    QFile file(fileName);
    QFile res(":/GameDatabase");
+   QFile* source = &file;
+   QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+   QString indexName;
+   QByteArray index;
+   QCryptographicHash sourceHash(QCryptographicHash::Sha1);
+   QByteArray sourceSHA1;
    bool openedFile = false;
 
+   close();
+
    // First attempt to open the user-specified game database...
    file.open(QIODevice::ReadOnly);
 
    if ( file.isOpen() )
    {
-      m_db.clear();
-      m_db.setContent(&file);
-      file.close();
       openedFile = true;
    }
    else
@@ -31,82 +103,293 @@ bool CGameDatabaseHandler::initialize(QString fileName)
       // Couldn't open the user-specified game database, resort
       // to using the internal resource...
       res.open(QIODevice::ReadOnly);
+      source = &res;
+   }
+
+   // Each database gets its own index, which is remade if the database
+   // is changed.  The index is checked against a hash of the database's
+   // content rather than its size and modification time, which the
+   // database built into the IDE doesn't have.  Hashing a few megabytes
+   // is still much quicker than parsing them.
+   QFileInfo sourceInfo(*source);
+   sourceHash.addData(source);
+   sourceSHA1 = sourceHash.result();
+   source->seek(0);
+   indexName = QDir(cacheDir).filePath("gamedb-"+
+                                       QCryptographicHash::hash(sourceInfo.absoluteFilePath().toUtf8(),QCryptographicHash::Sha1).toHex().left(16)+
+                                       ".idx");
+
+   if ( !openIndex(indexName,sourceSHA1) )
+   {
+      if ( createIndex(source,sourceSHA1,index) )
+      {
+         QSaveFile indexFile(indexName);
+
+         QDir().mkpath(cacheDir);
+         if ( indexFile.open(QIODevice::WriteOnly) )
+         {
+            indexFile.write(index);
+            indexFile.commit();
+         }
+      }
 
-      m_db.clear();
-      m_db.setContent(&res);
-      res.close();
+      // Use the index as written if it could be, otherwise from memory.
+      if ( !openIndex(indexName,sourceSHA1) )
+      {
+         m_index = index;
+         useIndex((const uchar*)m_index.constData(),m_index.size(),sourceSHA1);
+      }
    }
+
+   source->close();
+
    return openedFile;
 }
 
+bool CGameDatabaseHandler::openIndex(QString indexName,const QByteArray& sourceSHA1)
+{
+   uchar* pIndex;
+
+   m_indexFile.setFileName(indexName);
+   if ( !m_indexFile.open(QIODevice::ReadOnly) )
+   {
+      return false;
+   }
+
+   pIndex = m_indexFile.map(0,m_indexFile.size());
+   if ( !pIndex ||
+        !useIndex(pIndex,m_indexFile.size(),sourceSHA1) )
+   {
+      m_indexFile.close();
+      return false;
+   }
+   return true;
+}
+
+bool CGameDatabaseHandler::useIndex(const uchar* pIndex,qint64 size,const QByteArray& sourceSHA1)
+{
+   const GameDBIndexHeader* pHeader = (const GameDBIndexHeader*)pIndex;
+
+   // Only an index made by this version from this database, and that
+   // doesn't point outside itself, is used.
+   if ( (size < (qint64)sizeof(GameDBIndexHeader)) ||
+        (pHeader->magic != GAME_DB_INDEX_MAGIC) ||
+        (pHeader->version != GAME_DB_INDEX_VERSION) ||
+        (pHeader->size != size) ||
+        (sourceSHA1.size() != 20) ||
+        memcmp(pHeader->sourceSHA1,sourceSHA1.constData(),20) ||
+        (pHeader->cartridgesOffset+(quint64)pHeader->numCartridges*sizeof(GameDBIndexCartridge) > pHeader->stringsOffset) ||
+        (pHeader->crcsOffset+(quint64)pHeader->numCRCs*sizeof(GameDBIndexCRC) > pHeader->stringsOffset) ||
+        (pHeader->stringsOffset >= pHeader->size) ||
+        (pIndex[pHeader->size-1] != 0) )
+   {
+      return false;
+   }
+
+   m_pIndex = pIndex;
+   m_pHeader = pHeader;
+   return true;
+}
+
+// Adds a string to the index's string table, once.
+static quint32 addString(QByteArray& strings,QHash<QString,quint32>& offsets,QString str)
+{
+   QHash<QString,quint32>::const_iterator offset = offsets.constFind(str);
+
+   if ( offset != offsets.constEnd() )
+   {
+      return offset.value();
+   }
+   offsets.insert(str,strings.size());
+   strings.append(str.toUtf8());
+   strings.append('\0');
+   return offsets.value(str);
+}
+
+bool CGameDatabaseHandler::createIndex(QIODevice* source,const QByteArray& sourceSHA1,QByteArray& index)
+{
+   QXmlStreamReader              xml(source);
+   GameDBIndexHeader             header;
+   GameDBIndexCartridge          cartridge;
+   GameDBIndexCRC                crc;
+   QVector<GameDBIndexCartridge> cartridges;
+   QVector<GameDBIndexCRC>       crcs;
+   QByteArray                    strings;
+   QHash<QString,quint32>        stringOffsets;
+   QByteArray                    sha1;
+   quint32                       name = 0;
+   quint32                       publisher = 0;
+   quint32                       date = 0;
+   bool                          ok;
+   int                           idx;
+
+   memset(&header,0,sizeof(header));
+
+   // Offset 0 is the empty string.
+   addString(strings,stringOffsets,QString());
+
+   while ( !xml.atEnd() )
+   {
+      if ( xml.readNext() == QXmlStreamReader::StartElement )
+      {
+         if ( xml.name() == "database" )
+         {
+            header.author = addString(strings,stringOffsets,xml.attributes().value("author").toString());
+            header.timestamp = addString(strings,stringOffsets,xml.attributes().value("timestamp").toString());
+         }
+         else if ( xml.name() == "game" )
+         {
+            name = addString(strings,stringOffsets,xml.attributes().value("name").toString());
+            publisher = addString(strings,stringOffsets,xml.attributes().value("publisher").toString());
+            date = addString(strings,stringOffsets,xml.attributes().value("date").toString());
+         }
+         else if ( xml.name() == "cartridge" )
+         {
+            memset(&cartridge,0,sizeof(cartridge));
+            sha1 = QByteArray::fromHex(xml.attributes().value("sha1").toString().toLatin1());
+            cartridge.crc32 = xml.attributes().value("crc").toString().toUInt(&ok,16);
+            if ( (sha1.size() == 20) || ok )
+            {
+               if ( sha1.size() == 20 )
+               {
+                  memcpy(cartridge.sha1,sha1.constData(),20);
+               }
+               cartridge.name = name;
+               cartridge.publisher = publisher;
+               cartridge.date = date;
+               cartridge.system = addString(strings,stringOffsets,xml.attributes().value("system").toString());
+               cartridges.append(cartridge);
+            }
+         }
+      }
+   }
+
+   if ( xml.hasError() )
+   {
+      return false;
+   }
+
+   // The same ROM can be listed more than once; the first listed is the
+   // one found, as when the XML itself was searched.
+   std::stable_sort(cartridges.begin(),cartridges.end(),sha1Less);
+
+   for ( idx = 0; idx < cartridges.size(); idx++ )
+   {
+      if ( cartridges.at(idx).crc32 )
+      {
+         crc.crc32 = cartridges.at(idx).crc32;
+         crc.cartridge = idx;
+         crcs.append(crc);
+      }
+   }
+   std::stable_sort(crcs.begin(),crcs.end(),crcLess);
+
+   header.magic = GAME_DB_INDEX_MAGIC;
+   header.version = GAME_DB_INDEX_VERSION;
+   memcpy(header.sourceSHA1,sourceSHA1.constData(),qMin(sourceSHA1.size(),20));
+   header.numCartridges = cartridges.size();
+   header.cartridgesOffset = sizeof(GameDBIndexHeader);
+   header.numCRCs = crcs.size();
+   header.crcsOffset = header.cartridgesOffset+header.numCartridges*sizeof(GameDBIndexCartridge);
+   header.stringsOffset = header.crcsOffset+header.numCRCs*sizeof(GameDBIndexCRC);
+   header.size = header.stringsOffset+strings.size();
+
+   index.clear();
+   index.reserve(header.size);
+   index.append((const char*)&header,sizeof(header));
+   index.append((const char*)cartridges.constData(),cartridges.size()*sizeof(GameDBIndexCartridge));
+   index.append((const char*)crcs.constData(),crcs.size()*sizeof(GameDBIndexCRC));
+   index.append(strings);
+
+   return true;
+}
+
+QString CGameDatabaseHandler::string(quint32 offset) const
+{
+   if ( !m_pHeader ||
+        (m_pHeader->stringsOffset+(quint64)offset >= m_pHeader->size) )
+   {
+      return QString();
+   }
+   return QString::fromUtf8((const char*)m_pIndex+m_pHeader->stringsOffset+offset);
+}
+
 QString CGameDatabaseHandler::getGameDBTimestamp()
 {
-   QDomElement        docElem = m_db.documentElement();
-   return docElem.attribute("timestamp");
+   return string(m_pHeader?m_pHeader->timestamp:0);
 }
 
 QString CGameDatabaseHandler::getGameDBAuthor()
 {
-   QDomElement        docElem = m_db.documentElement();
-   return docElem.attribute("author");
+   return string(m_pHeader?m_pHeader->author:0);
 }
 
 bool CGameDatabaseHandler::find(CCartridge* pCartridge)
 {
-   QDomElement        docElem = m_db.documentElement();
    QCryptographicHash sha1alg(QCryptographicHash::Sha1);
    QByteArray         sha1key;
+   GameDBIndexCartridge key;
+   GameDBIndexCRC     crcKey;
+   const GameDBIndexCartridge* pCartridges;
+   const GameDBIndexCartridge* pFound;
+   const GameDBIndexCRC* pCRCs;
+   const GameDBIndexCRC* pFoundCRC;
+   quint32            crc = 0;
    int                i;
 
    // Reset the crypto...
    sha1alg.reset();
 
    // Clear the found elements...
-   m_game.clear();
-   m_cartridge.clear();
+   m_pCartridge = NULL;
+
+   if ( !m_pHeader )
+   {
+      return false;
+   }
 
    // Pump ROM data into crypto to get SHA1...
    for ( i = 0; i < pCartridge->getPrgRomBanks()->getPrgRomBanks().count(); i++ )
    {
       sha1alg.addData((char*)pCartridge->getPrgRomBanks()->getPrgRomBanks().at(i)->getBankData(),MEM_8KB);
+      crc = crc32(crc,(uchar*)pCartridge->getPrgRomBanks()->getPrgRomBanks().at(i)->getBankData(),MEM_8KB);
    }
 
    for ( i = 0; i < pCartridge->getChrRomBanks()->getChrRomBanks().count(); i++ )
    {
       sha1alg.addData((char*)pCartridge->getChrRomBanks()->getChrRomBanks().at(i)->getBankData(),MEM_8KB);
+      crc = crc32(crc,(uchar*)pCartridge->getChrRomBanks()->getChrRomBanks().at(i)->getBankData(),MEM_8KB);
    }
 
    // Get the resulting hash value from the crypto...
    sha1key = sha1alg.result();
 
-   // Search the loaded game database for the corresponding hash value...
-   QDomNode gameNode = docElem.firstChild();
-
-   while (!gameNode.isNull())
+   // Search the index for the corresponding hash value...
+   memcpy(key.sha1,sha1key.constData(),20);
+   pCartridges = (const GameDBIndexCartridge*)(m_pIndex+m_pHeader->cartridgesOffset);
+   pFound = std::lower_bound(pCartridges,pCartridges+m_pHeader->numCartridges,key,sha1Less);
+   if ( (pFound != pCartridges+m_pHeader->numCartridges) &&
+        (!memcmp(pFound->sha1,key.sha1,20)) )
    {
-      QDomElement gameElem = gameNode.toElement(); // try to convert the node to an element.
+      // Save found game for later reference...
+      m_pCartridge = pFound;
+      return true;
+   }
 
-      if (!gameElem.isNull())
+   // Cartridges listed with only a CRC32 are found by that instead.
+   memset(key.sha1,0,20);
+   crcKey.crc32 = crc;
+   pCRCs = (const GameDBIndexCRC*)(m_pIndex+m_pHeader->crcsOffset);
+   for ( pFoundCRC = std::lower_bound(pCRCs,pCRCs+m_pHeader->numCRCs,crcKey,crcLess);
+         (pFoundCRC != pCRCs+m_pHeader->numCRCs) && (pFoundCRC->crc32 == crc);
+         pFoundCRC++ )
+   {
+      if ( (pFoundCRC->cartridge < m_pHeader->numCartridges) &&
+           (!memcmp(pCartridges[pFoundCRC->cartridge].sha1,key.sha1,20)) )
       {
-         QDomNode cartridgeNode = gameElem.firstChild();
-
-         while (!cartridgeNode.isNull())
-         {
-            QDomElement cartridgeElem = cartridgeNode.toElement(); // try to convert the node to an element.
-
-            if ( sha1key.toHex().toUpper() == cartridgeElem.attribute("sha1").toUpper() )
-            {
-               // Save found game for later reference...
-               m_game = gameNode.cloneNode();
-               m_cartridge = cartridgeNode.cloneNode();
-               return true;
-            }
-
-            cartridgeNode = cartridgeNode.nextSibling();
-         }
+         m_pCartridge = pCartridges+pFoundCRC->cartridge;
+         return true;
       }
-
-      gameNode = gameNode.nextSibling();
    }
 
    return false;
@@ -114,8 +397,7 @@ bool CGameDatabaseHandler::find(CCartridge* pCartridge)
 
 int CGameDatabaseHandler::getRegion()
 {
-   QDomElement cartridgeElem = m_cartridge.toElement();
-   QString str = cartridgeElem.attribute("system");
+   QString str = getSystem();
 
    if ( str.contains("USA") )
    {
@@ -1,19 +1,58 @@
 #ifndef CGAMEDATABASEHANDLER_H
 #define CGAMEDATABASEHANDLER_H
 
-#include <QDomDocument>
-#include <QDomElement>
+#include <QByteArray>
+#include <QFile>
 #include <QString>
 
 #include "ccartridge.h"
 
-#define GAME_DATA(attr)  QDomElement gameElem = m_game.toElement(); return gameElem.attribute(attr)
-#define CART_DATA(attr)  QDomElement cartridgeElem = m_cartridge.toElement(); return cartridgeElem.attribute(attr)
+#define GAME_DB_INDEX_MAGIC   0x4244474E // "NGDB"
+#define GAME_DB_INDEX_VERSION 2
+
+// The game database is an XML file of a few megabytes.  Rather than parse
+// it on every start, it is converted on first load into an index that
+// is written to the cache directory and memory-mapped on later starts.
+// The index is laid out as a header, the cartridges sorted by SHA1, the
+// cartridges' positions sorted by CRC32, and a table of NUL-terminated
+// UTF-8 strings the cartridges refer to by offset.
+typedef struct
+{
+   quint32 magic;
+   quint32 version;
+   // The SHA1 of the XML the index was made from.
+   quint8  sourceSHA1 [ 20 ];
+   quint32 size;
+   quint32 numCartridges;
+   quint32 cartridgesOffset;
+   quint32 numCRCs;
+   quint32 crcsOffset;
+   quint32 stringsOffset;
+   quint32 author;
+   quint32 timestamp;
+} GameDBIndexHeader;
+
+typedef struct
+{
+   quint8  sha1 [ 20 ];
+   quint32 crc32;
+   quint32 name;
+   quint32 publisher;
+   quint32 date;
+   quint32 system;
+} GameDBIndexCartridge;
+
+typedef struct
+{
+   quint32 crc32;
+   quint32 cartridge;
+} GameDBIndexCRC;
 
 class CGameDatabaseHandler
 {
 public:
    CGameDatabaseHandler();
+   virtual ~CGameDatabaseHandler();
    bool initialize(QString fileName);
 
    // Database information.
@@ -26,32 +65,48 @@ public:
    // Game values.
    QString getName()
    {
-      GAME_DATA("name");
+      return string(m_pCartridge?m_pCartridge->name:0);
    }
    QString getPublisher()
    {
-      GAME_DATA("publisher");
+      return string(m_pCartridge?m_pCartridge->publisher:0);
    }
    QString getDate()
    {
-      GAME_DATA("date");
+      return string(m_pCartridge?m_pCartridge->date:0);
    }
    int getRegion();
 
    // Cartridge values.
    QString getSystem()
    {
-      CART_DATA("system");
+      return string(m_pCartridge?m_pCartridge->system:0);
    }
    QString getSHA1()
    {
-      CART_DATA("sha1").toUpper();
+      if ( m_pCartridge )
+      {
+         return QString(QByteArray((const char*)m_pCartridge->sha1,20).toHex().toUpper());
+      }
+      return QString();
    }
 
 protected:
-   QDomDocument m_db;
-   QDomNode     m_game;
-   QDomNode     m_cartridge;
+   void close();
+   bool openIndex(QString indexName,const QByteArray& sourceSHA1);
+   bool useIndex(const uchar* pIndex,qint64 size,const QByteArray& sourceSHA1);
+   static bool createIndex(QIODevice* source,const QByteArray& sourceSHA1,QByteArray& index);
+   QString string(quint32 offset) const;
+
+   // The index, either mapped from the cache or, if it couldn't be
+   // written there, held in memory.
+   QFile                       m_indexFile;
+   QByteArray                  m_index;
+   const uchar*                m_pIndex;
+   const GameDBIndexHeader*    m_pHeader;
+
+   // The cartridge the last find found.
+   const GameDBIndexCartridge* m_pCartridge;
 };
 
 #endif // CGAMEDATABASEHANDLER_H
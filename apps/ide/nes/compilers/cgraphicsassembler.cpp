@@ -1,5 +1,8 @@
+#include <QCryptographicHash>
+
 #include "cgraphicsassembler.h"
 #include "cnesicideproject.h"
+#include "cbuildcache.h"
 
 #include "main.h"
 
@@ -38,6 +41,28 @@ bool CGraphicsAssembler::assemble()
 
    if ( gfxBanks->getGraphicsBanks().count() )
    {
+      QCryptographicHash key(QCryptographicHash::Sha1);
+
+      // The CHR-ROM only needs writing if what goes into it has changed.
+      for (int gfxBankIdx = 0; gfxBankIdx < gfxBanks->getGraphicsBanks().count(); gfxBankIdx++)
+      {
+         CGraphicsBank* curGfxBank = gfxBanks->getGraphicsBanks().at(gfxBankIdx);
+
+         key.addData(QByteArray::number(curGfxBank->getGraphics().count()));
+         for (int bankItemIdx = 0; bankItemIdx < curGfxBank->getGraphics().count(); bankItemIdx++)
+         {
+            IChrRomBankItem* bankItem = curGfxBank->getGraphics().at(bankItemIdx);
+
+            key.addData(bankItem->getChrRomBankItemData().data(), bankItem->getChrRomBankItemSize());
+         }
+      }
+      if ( (QFile::exists(outputName)) &&
+           (CBuildCache::recordedKey(outputName) == key.result()) )
+      {
+         buildTextLogger->write("<b>Graphics Banks unchanged, skipping: "+outputName+"</b>");
+         return true;
+      }
+
       buildTextLogger->write("<b>Building: "+outputName+"</b>");
 
       chrRomFile.setFileName(outputName);
@@ -70,6 +95,8 @@ bool CGraphicsAssembler::assemble()
 
          chrRomFile.close();
 
+         CBuildCache::recordKey(outputName,key.result());
+
          return true;
       }
    }
@@ -12,10 +12,15 @@ APUInformationDockWidget::APUInformationDockWidget(QWidget *parent) :
     ui(new Ui::APUInformationDockWidget)
 {
    ui->setupUi(this);
+
+   // Nothing to draw off the UI thread, but updates are coalesced and timed.
+   pThread = new DebuggerUpdateThread(NULL,this);
+   QObject::connect(pThread,SIGNAL(updateComplete()),this,SLOT(updateInformation()));
 }
 
 APUInformationDockWidget::~APUInformationDockWidget()
 {
+    delete pThread;
     delete ui;
 }
 
@@ -46,56 +51,91 @@ void APUInformationDockWidget::changeEvent(QEvent* e)
 void APUInformationDockWidget::showEvent(QShowEvent* /*e*/)
 {
    QObject* emulator = CObjectRegistry::getObject("Emulator");
-   QObject::connect ( emulator, SIGNAL(updateDebuggers()), this, SLOT(updateInformation()) );
+   QObject::connect ( emulator, SIGNAL(updateDebuggers()), pThread, SLOT(updateDebuggers()) );
    updateInformation();
 }
 
 void APUInformationDockWidget::hideEvent(QHideEvent* /*e*/)
 {
    QObject* emulator = CObjectRegistry::getObject("Emulator");
-   QObject::disconnect ( emulator, SIGNAL(updateDebuggers()), this, SLOT(updateInformation()) );
+   QObject::disconnect ( emulator, SIGNAL(updateDebuggers()), pThread, SLOT(updateDebuggers()) );
 }
 
 void APUInformationDockWidget::updateInformation()
 {
    CBreakpointInfo* pBreakpoints = nesGetBreakpointDatabase();
+   const nesDebuggerSnapshot* pSnapshot = nesGetDebuggerSnapshot();
+   const ApuStateSnapshot* pApuState;
+   ApuStateSnapshot apuState;
+   nesAudioInfo audioInfo;
    int idx;
-   char buffer[16];
+   char buffer[32];
 
-   nesGetNesSnapshot(&m_nesState);
+   // Show the APU as the emulator last published it, if it has yet.
+   if ( pSnapshot )
+   {
+      pApuState = &pSnapshot->apu;
+   }
+   else
+   {
+      nesGetApuSnapshot(&apuState);
+      pApuState = &apuState;
+   }
 
-   sprintf ( buffer, "%d", m_nesState.apu.cycle );
+   sprintf ( buffer, "%d", pApuState->cycle );
    ui->apuCycle->setText ( buffer );
 
-   ui->apuSequencerMode->setText ( m_nesState.apu.sequencerMode==0?"4-step":"5-step" );
+   ui->apuSequencerMode->setText ( pApuState->sequencerMode==0?"4-step":"5-step" );
 
-   ui->lengthCounter1->setValue ( m_nesState.apu.lengthCounter[0] );
-   ui->lengthCounter2->setValue ( m_nesState.apu.lengthCounter[1] );
-   ui->lengthCounter3->setValue ( m_nesState.apu.lengthCounter[2] );
-   ui->lengthCounter4->setValue ( m_nesState.apu.lengthCounter[3] );
-   ui->lengthCounter5->setValue ( m_nesState.apu.lengthCounter[4] );
+   ui->lengthCounter1->setValue ( pApuState->lengthCounter[0] );
+   ui->lengthCounter2->setValue ( pApuState->lengthCounter[1] );
+   ui->lengthCounter3->setValue ( pApuState->lengthCounter[2] );
+   ui->lengthCounter4->setValue ( pApuState->lengthCounter[3] );
+   ui->lengthCounter5->setValue ( pApuState->lengthCounter[4] );
 
-   ui->linearCounter3->setValue ( m_nesState.apu.triangleLinearCounter );
+   ui->linearCounter3->setValue ( pApuState->triangleLinearCounter );
 
-   ui->dac1->setValue ( m_nesState.apu.dac[0] );
-   ui->dac2->setValue ( m_nesState.apu.dac[1] );
-   ui->dac3->setValue ( m_nesState.apu.dac[2] );
-   ui->dac4->setValue ( m_nesState.apu.dac[3] );
-   ui->dac5->setValue ( m_nesState.apu.dac[4] );
+   ui->dac1->setValue ( pApuState->dac[0] );
+   ui->dac2->setValue ( pApuState->dac[1] );
+   ui->dac3->setValue ( pApuState->dac[2] );
+   ui->dac4->setValue ( pApuState->dac[3] );
+   ui->dac5->setValue ( pApuState->dac[4] );
 
-   ui->irqEnabled5->setChecked ( m_nesState.apu.dmcIrqEnabled );
-   ui->irqAsserted5->setChecked ( m_nesState.apu.dmcIrqAsserted );
+   ui->irqEnabled5->setChecked ( pApuState->dmcIrqEnabled );
+   ui->irqAsserted5->setChecked ( pApuState->dmcIrqAsserted );
 
-   sprintf ( buffer, "%04X", m_nesState.apu.dmaSampleAddress );
+   sprintf ( buffer, "%04X", pApuState->dmaSampleAddress );
    ui->sampleAddr5->setText ( buffer );
-   sprintf ( buffer, "%04X", m_nesState.apu.dmaSampleLength );
+   sprintf ( buffer, "%04X", pApuState->dmaSampleLength );
    ui->sampleLength5->setText ( buffer );
-   sprintf ( buffer, "%04X", m_nesState.apu.dmaSamplePosition );
+   sprintf ( buffer, "%04X", pApuState->dmaSamplePosition );
    ui->samplePos5->setText ( buffer );
 
-   sprintf ( buffer, "%02X", m_nesState.apu.dmcDmaBuffer );
+   sprintf ( buffer, "%02X", pApuState->dmcDmaBuffer );
    ui->sampleBufferContents5->setText ( buffer );
-   ui->sampleBufferFull5->setChecked ( m_nesState.apu.dmcDmaFull );
+   ui->sampleBufferFull5->setChecked ( pApuState->dmcDmaFull );
+
+   nesGetAudioInformation(&audioInfo);
+
+   sprintf ( buffer, "%d / %d", audioInfo.fill, audioInfo.bufferSize );
+   ui->audioFill->setText ( buffer );
+   sprintf ( buffer, "%d", audioInfo.fillAverage );
+   ui->audioFillAverage->setText ( buffer );
+   if ( audioInfo.latency )
+   {
+      sprintf ( buffer, "%d", audioInfo.latency );
+   }
+   else
+   {
+      sprintf ( buffer, "None" );
+   }
+   ui->audioLatency->setText ( buffer );
+   sprintf ( buffer, "%+d ppm", audioInfo.rateAdjust );
+   ui->audioRateAdjust->setText ( buffer );
+   sprintf ( buffer, "%u", audioInfo.underruns );
+   ui->audioUnderruns->setText ( buffer );
+   sprintf ( buffer, "%u", audioInfo.overruns );
+   ui->audioOverruns->setText ( buffer );
 
    // Check breakpoints for hits and highlight if necessary...
    for ( idx = 0; idx < pBreakpoints->GetNumBreakpoints(); idx++ )
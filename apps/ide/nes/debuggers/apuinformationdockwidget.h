@@ -3,6 +3,8 @@
 
 #include "cdebuggerbase.h"
 
+#include "debuggerupdatethread.h"
+
 namespace Ui {
    class APUInformationDockWidget;
 }
@@ -26,6 +28,7 @@ public slots:
 
 private:
    Ui::APUInformationDockWidget *ui;
+   DebuggerUpdateThread* pThread;
 };
 
 #endif // APUINFORMATIONDOCKWIDGET_H
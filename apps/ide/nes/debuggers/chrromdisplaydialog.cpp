@@ -46,7 +46,7 @@ CHRROMDisplayDialog::CHRROMDisplayDialog(bool usePPU,qint8* data,IProjectTreeVie
       CPPUDBG::SetCHRMEMInspectorColor(2,renderer->getColor(2));
       CPPUDBG::SetCHRMEMInspectorColor(3,renderer->getColor(3));
 
-      pThread = new DebuggerUpdateThread(&CPPUDBG::RENDERCHRMEM);
+      pThread = new DebuggerUpdateThread(&CPPUDBG::RENDERCHRMEM,this);
       QObject::connect(pThread,SIGNAL(updateComplete()),this,SLOT(renderData()));
    }
    else
@@ -31,7 +31,7 @@ CodeDataLoggerDockWidget::CodeDataLoggerDockWidget(QWidget *parent) :
    ui->frame->layout()->addWidget(renderer);
    ui->frame->layout()->update();
 
-   pThread = new DebuggerUpdateThread(&C6502DBG::RENDERCODEDATALOGGER);
+   pThread = new DebuggerUpdateThread(&C6502DBG::RENDERCODEDATALOGGER,this);
    QObject::connect(pThread,SIGNAL(updateComplete()),this,SLOT(renderData()));
 }
 
@@ -25,10 +25,23 @@
 
 #include <QColor>
 
+#include <string.h>
+
 int8_t*          C6502DBG::m_pCodeDataLoggerInspectorTV = NULL;
 
 int8_t*          C6502DBG::m_pExecutionVisualizerInspectorTV = NULL;
 
+int32_t          C6502DBG::m_executionVisualizerHeatFrames = 1;
+int32_t          C6502DBG::m_executionHeatFrames = 0;
+uint32_t         C6502DBG::m_executionHeatCycles = 0;
+uint32_t         C6502DBG::m_executionHeatLastFrame = MARKER_NOT_MARKED;
+int32_t          C6502DBG::m_executionHeatHistoryHead = 0;
+int32_t          C6502DBG::m_executionHeatHistoryCount = 0;
+int32_t          C6502DBG::m_executionHeatHistorySpans [ EXECUTION_VISUALIZER_MAX_HEAT_FRAMES ];
+ExecutionVisualizerSpan C6502DBG::m_executionHeatHistory [ EXECUTION_VISUALIZER_MAX_HEAT_FRAMES ][ EXECUTION_VISUALIZER_MAX_SPANS ];
+uint16_t         C6502DBG::m_executionHeat [ EXECUTION_VISUALIZER_MAX_CYCLES ];
+int8_t           C6502DBG::m_executionHeatMarker [ EXECUTION_VISUALIZER_MAX_CYCLES ];
+
 static int32_t opcode_size [ NUM_ADDRESSING_MODES ] =
 {
    1, // AM_IMPLIED
@@ -2638,22 +2651,27 @@ void C6502DBG::RENDERCODEDATALOGGER ( void )
 {
    uint32_t idxx, idxy;
    uint32_t cycleDiff;
-   uint32_t curCycle = CCodeDataLogger::GetCurCycle ();
+   const nesDebuggerSnapshot* pSnapshot = nesGetDebuggerSnapshot();
+   uint32_t curCycle;
    QColor lcolor;
-   CCodeDataLogger* pLogger;
-   LoggerInfo* pLogEntry;
+   const nesDebuggerLogEntry* pLogEntry;
    int8_t* pTV;
 
-   // Show CPU RAM...
-   pLogger = nesGetCpuCodeDataLoggerDatabase();
+   if ( !pSnapshot )
+   {
+      return;
+   }
 
+   curCycle = pSnapshot->logCycle;
+
+   // Show CPU RAM...
    pTV = (int8_t*)m_pCodeDataLoggerInspectorTV;
 
    for ( idxx = 0; idxx < MEM_2KB; idxx++ )
    {
-      pLogEntry = pLogger->GetLogEntry(idxx);
+      pLogEntry = pSnapshot->cpuLog+idxx;
 
-      if ( pLogEntry->count )
+      if ( pLogEntry->accessed )
       {
          cycleDiff = (curCycle-pLogEntry->cycle)/30000;
          if ( cycleDiff > 220 )
@@ -2702,15 +2720,13 @@ void C6502DBG::RENDERCODEDATALOGGER ( void )
    }
 
    // Show I/O region...
-   pLogger = nesGetCpuCodeDataLoggerDatabase();
-
    pTV = (int8_t*)(m_pCodeDataLoggerInspectorTV+(MEM_8KB<<2));
 
    for ( idxx = MEM_8KB; idxx < 0x5C00; idxx++ )
    {
-      pLogEntry = pLogger->GetLogEntry(idxx);
+      pLogEntry = pSnapshot->cpuLog+idxx;
 
-      if ( pLogEntry->count )
+      if ( pLogEntry->accessed )
       {
          cycleDiff = (curCycle-pLogEntry->cycle)/30000;
          if ( cycleDiff > 220 )
@@ -2759,15 +2775,13 @@ void C6502DBG::RENDERCODEDATALOGGER ( void )
    }
 
    // Show cartrige EXRAM memory...
-   pLogger = nesGetEXRAMCodeDataLoggerDatabase();
-
    pTV = (int8_t*)(m_pCodeDataLoggerInspectorTV+(0x5C00<<2));
 
    for ( idxx = 0; idxx < MEM_1KB; idxx++ )
    {
-      pLogEntry = pLogger->GetLogEntry(idxx);
+      pLogEntry = pSnapshot->cpuLog+EXRAM_START+idxx;
 
-      if ( pLogEntry->count )
+      if ( pLogEntry->accessed )
       {
          cycleDiff = (curCycle-pLogEntry->cycle)/30000;
          if ( cycleDiff > 220 )
@@ -2820,11 +2834,9 @@ void C6502DBG::RENDERCODEDATALOGGER ( void )
 
    for ( idxx = 0; idxx < MEM_8KB; idxx++ )
    {
-      pLogger = nesGetVirtualSRAMCodeDataLoggerDatabase(0x6000);
+      pLogEntry = pSnapshot->cpuLog+SRAM_START+idxx;
 
-      pLogEntry = pLogger->GetLogEntry(idxx);
-
-      if ( pLogEntry->count )
+      if ( pLogEntry->accessed )
       {
          cycleDiff = (curCycle-pLogEntry->cycle)/30000;
          if ( cycleDiff > 220 )
@@ -2879,11 +2891,9 @@ void C6502DBG::RENDERCODEDATALOGGER ( void )
    {
       for ( idxx = 0; idxx < MEM_8KB; idxx++ )
       {
-         pLogger = nesGetVirtualPRGROMCodeDataLoggerDatabase(MEM_32KB+(idxy*MEM_8KB)+idxx);
-
-         pLogEntry = pLogger->GetLogEntry(idxx);
+         pLogEntry = pSnapshot->cpuLog+MEM_32KB+(idxy*MEM_8KB)+idxx;
 
-         if ( pLogEntry->count )
+         if ( pLogEntry->accessed )
          {
             cycleDiff = (curCycle-pLogEntry->cycle)/30000;
             if ( cycleDiff > 220 )
@@ -2933,78 +2943,323 @@ void C6502DBG::RENDERCODEDATALOGGER ( void )
    }
 }
 
-void C6502DBG::RENDEREXECUTIONVISUALIZER ( void )
+int32_t C6502DBG::EXECUTIONVISUALIZERSPANS ( uint32_t numCycles, ExecutionVisualizerSpan* pSpans )
 {
-   uint32_t idxx, idxy;
-   MarkerSetInfo* pMarker;
+   const MarkerSetInfo* pMarker;
+   uint32_t start [ MAX_MARKER_SETS*2 ];
+   uint32_t end [ MAX_MARKER_SETS*2 ];
+   int32_t owner [ MAX_MARKER_SETS*2 ];
+   uint32_t bounds [ (MAX_MARKER_SETS*4)+2 ];
+   uint32_t bound;
+   int32_t numIntervals = 0;
+   int32_t numBounds = 0;
+   int32_t numSpans = 0;
    int32_t marker;
    int32_t frameDiff;
-   int8_t marked;
+   int32_t idx1, idx2;
+
+   // The cycles each marker covers in the last frame it was seen in.  A
+   // marker that ran over the end of the frame covers both ends of it.
+   for ( marker = 0; marker < MAX_MARKER_SETS; marker++ )
+   {
+      pMarker = nesGetExecutionMarker(marker);
+      frameDiff = pMarker->endPpuFrame-pMarker->startPpuFrame;
+
+      if ( ((pMarker->state != eMarkerSet_Started) &&
+            (pMarker->state != eMarkerSet_Complete)) ||
+           (pMarker->endPpuCycle == MARKER_NOT_MARKED) )
+      {
+         continue;
+      }
+
+      if ( frameDiff == 0 )
+      {
+         if ( pMarker->startPpuCycle <= pMarker->endPpuCycle )
+         {
+            start[numIntervals] = pMarker->startPpuCycle;
+            end[numIntervals] = pMarker->endPpuCycle+1;
+            owner[numIntervals++] = marker;
+         }
+      }
+      else if ( frameDiff == 1 )
+      {
+         if ( pMarker->startPpuCycle > pMarker->endPpuCycle )
+         {
+            start[numIntervals] = pMarker->startPpuCycle;
+            end[numIntervals] = numCycles;
+            owner[numIntervals++] = marker;
+            start[numIntervals] = 0;
+            end[numIntervals] = pMarker->endPpuCycle+1;
+            owner[numIntervals++] = marker;
+         }
+      }
+      else if ( frameDiff > 1 )
+      {
+         start[numIntervals] = 0;
+         end[numIntervals] = numCycles;
+         owner[numIntervals++] = marker;
+      }
+   }
+
+   // The frame changes hands only where an interval starts or ends.
+   bounds[numBounds++] = 0;
+   bounds[numBounds++] = numCycles;
+   for ( idx1 = 0; idx1 < numIntervals; idx1++ )
+   {
+      if ( start[idx1] > numCycles )
+      {
+         start[idx1] = numCycles;
+      }
+      if ( end[idx1] > numCycles )
+      {
+         end[idx1] = numCycles;
+      }
+      bounds[numBounds++] = start[idx1];
+      bounds[numBounds++] = end[idx1];
+   }
+   for ( idx1 = 1; idx1 < numBounds; idx1++ )
+   {
+      bound = bounds[idx1];
+      for ( idx2 = idx1; (idx2 > 0) && (bounds[idx2-1] > bound); idx2-- )
+      {
+         bounds[idx2] = bounds[idx2-1];
+      }
+      bounds[idx2] = bound;
+   }
+
+   for ( idx1 = 0; idx1+1 < numBounds; idx1++ )
+   {
+      if ( bounds[idx1] == bounds[idx1+1] )
+      {
+         continue;
+      }
+
+      // The last marker covering this run wins.
+      marker = -1;
+      for ( idx2 = 0; idx2 < numIntervals; idx2++ )
+      {
+         if ( (start[idx2] <= bounds[idx1]) && (bounds[idx1] < end[idx2]) )
+         {
+            marker = owner[idx2];
+         }
+      }
+
+      if ( numSpans && (pSpans[numSpans-1].marker == marker) )
+      {
+         pSpans[numSpans-1].end = bounds[idx1+1];
+      }
+      else
+      {
+         pSpans[numSpans].start = bounds[idx1];
+         pSpans[numSpans].end = bounds[idx1+1];
+         pSpans[numSpans].marker = marker;
+         numSpans++;
+      }
+   }
+
+   return numSpans;
+}
+
+void C6502DBG::EXECUTIONVISUALIZERHEAT ( uint32_t numCycles, ExecutionVisualizerSpan* pSpans, int32_t numSpans )
+{
+   ExecutionVisualizerSpan* pOldSpans;
+   int32_t frames = m_executionVisualizerHeatFrames;
+   int32_t span;
+   uint32_t cycle;
+
+   if ( frames > EXECUTION_VISUALIZER_MAX_HEAT_FRAMES )
+   {
+      frames = EXECUTION_VISUALIZER_MAX_HEAT_FRAMES;
+   }
+
+   // Start over if what's being accumulated has changed.
+   if ( (frames != m_executionHeatFrames) ||
+        (numCycles != m_executionHeatCycles) )
+   {
+      memset(m_executionHeat,0,sizeof(m_executionHeat));
+      m_executionHeatFrames = frames;
+      m_executionHeatCycles = numCycles;
+      m_executionHeatLastFrame = MARKER_NOT_MARKED;
+      m_executionHeatHistoryHead = 0;
+      m_executionHeatHistoryCount = 0;
+   }
+
+   // Each emulated frame is only counted once however often it's drawn.
+   if ( nesGetPPUFrame() == m_executionHeatLastFrame )
+   {
+      return;
+   }
+   m_executionHeatLastFrame = nesGetPPUFrame();
+
+   // Take the oldest frame back out once there are enough.
+   if ( m_executionHeatHistoryCount == frames )
+   {
+      pOldSpans = m_executionHeatHistory[m_executionHeatHistoryHead];
+      for ( span = 0; span < m_executionHeatHistorySpans[m_executionHeatHistoryHead]; span++ )
+      {
+         if ( pOldSpans[span].marker >= 0 )
+         {
+            for ( cycle = pOldSpans[span].start; cycle < pOldSpans[span].end; cycle++ )
+            {
+               m_executionHeat[cycle]--;
+            }
+         }
+      }
+      m_executionHeatHistoryCount--;
+   }
+
+   for ( span = 0; span < numSpans; span++ )
+   {
+      if ( pSpans[span].marker >= 0 )
+      {
+         for ( cycle = pSpans[span].start; cycle < pSpans[span].end; cycle++ )
+         {
+            m_executionHeat[cycle]++;
+         }
+         memset(m_executionHeatMarker+pSpans[span].start,pSpans[span].marker,pSpans[span].end-pSpans[span].start);
+      }
+   }
+
+   memcpy(m_executionHeatHistory[m_executionHeatHistoryHead],pSpans,numSpans*sizeof(ExecutionVisualizerSpan));
+   m_executionHeatHistorySpans[m_executionHeatHistoryHead] = numSpans;
+   m_executionHeatHistoryHead = (m_executionHeatHistoryHead+1)%frames;
+   m_executionHeatHistoryCount++;
+}
+
+void C6502DBG::RENDEREXECUTIONVISUALIZER ( void )
+{
+   ExecutionVisualizerSpan spans [ EXECUTION_VISUALIZER_MAX_SPANS ];
+   int32_t numSpans;
+   int32_t span = 0;
+   const MarkerSetInfo* pMarker;
+   uint32_t idxx, idxy;
+   uint32_t x1, x2;
+   uint32_t rowStart;
+   uint32_t heat;
    uint32_t numScanlines = CPPUDBG::SCANLINES();
+   uint32_t numCycles;
    int8_t* pTV = (int8_t*)m_pExecutionVisualizerInspectorTV;
    int8_t* pNESTV = nesGetTVOut();
+   int8_t* pRow;
+
+   if ( numScanlines > 512 )
+   {
+      numScanlines = 512;
+   }
+   numCycles = numScanlines*PPU_CYCLES_PER_SCANLINE;
+
+   numSpans = EXECUTIONVISUALIZERSPANS(numCycles,spans);
+
+   if ( m_executionVisualizerHeatFrames > 1 )
+   {
+      EXECUTIONVISUALIZERHEAT(numCycles,spans,numSpans);
+   }
 
    for ( idxy = 0; idxy < 512; idxy++ )
    {
-      for ( idxx = 0; idxx < 512; idxx++ )
+      pRow = pTV+((idxy<<9)<<2);
+
+      if ( idxy >= numScanlines )
       {
-         if ( (idxx >= PPU_CYCLES_PER_SCANLINE) || (idxy >= numScanlines) )
+         // Black otherwise...
+         for ( idxx = 0; idxx < 512; idxx++ )
          {
-            // Black otherwise...
-            *pTV = 0;
-            *(pTV+1) = 0;
-            *(pTV+2) = 0;
+            *(pRow+(idxx<<2)) = 0;
+            *(pRow+(idxx<<2)+1) = 0;
+            *(pRow+(idxx<<2)+2) = 0;
          }
+         continue;
+      }
 
-         if ( (idxx < PPU_CYCLES_PER_SCANLINE) && (idxy < numScanlines) )
-         {
-            marked = 0;
+      rowStart = idxy*PPU_CYCLES_PER_SCANLINE;
 
-            for ( marker = 0; marker < nesGetExecutionMarkerDatabase()->GetNumMarkers(); marker++ )
+      if ( m_executionVisualizerHeatFrames > 1 )
+      {
+         // Marker color, as bright as the share of frames it was seen in.
+         for ( idxx = 0; idxx < PPU_CYCLES_PER_SCANLINE; idxx++ )
+         {
+            heat = m_executionHeat[rowStart+idxx];
+            if ( heat )
             {
-               pMarker = nesGetExecutionMarkerDatabase()->GetMarker(marker);
-               frameDiff = pMarker->endPpuFrame-pMarker->startPpuFrame;
-
-               if ( ((pMarker->state == eMarkerSet_Started) ||
-                     (pMarker->state == eMarkerSet_Complete)) &&
-                     (pMarker->endPpuCycle != MARKER_NOT_MARKED) &&
-                     (((frameDiff == 0) &&
-                       (VISY_VISX_TO_CYCLE(idxy,idxx) >= pMarker->startPpuCycle) &&
-                       (VISY_VISX_TO_CYCLE(idxy,idxx) <= pMarker->endPpuCycle)) ||
-                      ((frameDiff == 1) &&
-                       ((pMarker->startPpuCycle > pMarker->endPpuCycle) &&
-                        ((VISY_VISX_TO_CYCLE(idxy,idxx) >= pMarker->startPpuCycle) ||
-                         (VISY_VISX_TO_CYCLE(idxy,idxx) <= pMarker->endPpuCycle)))) ||
-                      (frameDiff > 1)) )
-               {
-                  // Marker color!
-                  *pTV = pMarker->red;
-                  *(pTV+1) = pMarker->green;
-                  *(pTV+2) = pMarker->blue;
-                  marked++;
-               }
+               pMarker = nesGetExecutionMarker(m_executionHeatMarker[rowStart+idxx]);
+               *(pRow+(idxx<<2)) = (pMarker->red*heat)/m_executionHeatFrames;
+               *(pRow+(idxx<<2)+1) = (pMarker->green*heat)/m_executionHeatFrames;
+               *(pRow+(idxx<<2)+2) = (pMarker->blue*heat)/m_executionHeatFrames;
+            }
+            else if ( (idxx < 256) && (idxy < 240) )
+            {
+               // Screen...
+               *(pRow+(idxx<<2)) = *(pNESTV+(((idxy<<8)<<2) + (idxx<<2) + 0));
+               *(pRow+(idxx<<2)+1) = *(pNESTV+(((idxy<<8)<<2) + (idxx<<2) + 1));
+               *(pRow+(idxx<<2)+2) = *(pNESTV+(((idxy<<8)<<2) + (idxx<<2) + 2));
+            }
+            else
+            {
+               // Darker gray backdrop PPU-off time outline...
+               *(pRow+(idxx<<2)) = 105;
+               *(pRow+(idxx<<2)+1) = 105;
+               *(pRow+(idxx<<2)+2) = 105;
+            }
+         }
+      }
+      else
+      {
+         // Fill each run of the scanline in one go.
+         for ( ; (span < numSpans) && (spans[span].start < rowStart+PPU_CYCLES_PER_SCANLINE); span++ )
+         {
+            x1 = (spans[span].start > rowStart)?spans[span].start-rowStart:0;
+            x2 = spans[span].end-rowStart;
+            if ( x2 > PPU_CYCLES_PER_SCANLINE )
+            {
+               x2 = PPU_CYCLES_PER_SCANLINE;
             }
 
-            if ( !marked  )
+            if ( spans[span].marker >= 0 )
             {
-               if ( (idxx < 256) && (idxy < 240) )
+               // Marker color!
+               pMarker = nesGetExecutionMarker(spans[span].marker);
+               for ( idxx = x1; idxx < x2; idxx++ )
                {
-                  // Screen...
-                  *pTV = *(pNESTV+(((idxy<<8)<<2) + (idxx<<2) + 0));
-                  *(pTV+1) = *(pNESTV+(((idxy<<8)<<2) + (idxx<<2) + 1));
-                  *(pTV+2) = *(pNESTV+(((idxy<<8)<<2) + (idxx<<2) + 2));
+                  *(pRow+(idxx<<2)) = pMarker->red;
+                  *(pRow+(idxx<<2)+1) = pMarker->green;
+                  *(pRow+(idxx<<2)+2) = pMarker->blue;
                }
-               else
+            }
+            else
+            {
+               for ( idxx = x1; idxx < x2; idxx++ )
                {
-                  // Darker gray backdrop PPU-off time outline...
-                  *pTV = 105;
-                  *(pTV+1) = 105;
-                  *(pTV+2) = 105;
+                  if ( (idxx < 256) && (idxy < 240) )
+                  {
+                     // Screen...
+                     *(pRow+(idxx<<2)) = *(pNESTV+(((idxy<<8)<<2) + (idxx<<2) + 0));
+                     *(pRow+(idxx<<2)+1) = *(pNESTV+(((idxy<<8)<<2) + (idxx<<2) + 1));
+                     *(pRow+(idxx<<2)+2) = *(pNESTV+(((idxy<<8)<<2) + (idxx<<2) + 2));
+                  }
+                  else
+                  {
+                     // Darker gray backdrop PPU-off time outline...
+                     *(pRow+(idxx<<2)) = 105;
+                     *(pRow+(idxx<<2)+1) = 105;
+                     *(pRow+(idxx<<2)+2) = 105;
+                  }
                }
             }
+
+            // A run that carries on into the next scanline is picked up again there.
+            if ( spans[span].end > rowStart+PPU_CYCLES_PER_SCANLINE )
+            {
+               break;
+            }
          }
+      }
 
-         pTV += 4;
+      // Black otherwise...
+      for ( idxx = PPU_CYCLES_PER_SCANLINE; idxx < 512; idxx++ )
+      {
+         *(pRow+(idxx<<2)) = 0;
+         *(pRow+(idxx<<2)+1) = 0;
+         *(pRow+(idxx<<2)+2) = 0;
       }
    }
 }
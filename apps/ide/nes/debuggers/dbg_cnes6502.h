@@ -7,6 +7,27 @@
 
 #include "nes_emulator_core.h"
 
+#include "cmarker.h"
+
+// The most frames the Execution Visualizer can accumulate marker heat over.
+#define EXECUTION_VISUALIZER_MAX_HEAT_FRAMES 120
+
+// Each marker covers at most two runs of a frame's cycles, so a frame
+// splits into at most this many runs of marked and unmarked cycles.
+#define EXECUTION_VISUALIZER_MAX_SPANS ((MAX_MARKER_SETS*4)+1)
+
+// The cycles of the visualized frame, limited to the rows of the display.
+#define EXECUTION_VISUALIZER_MAX_CYCLES (512*PPU_CYCLES_PER_SCANLINE)
+
+// A run of a frame's PPU cycles that are all covered by the same marker,
+// or by none (marker is -1).
+typedef struct _ExecutionVisualizerSpan
+{
+   uint32_t start;
+   uint32_t end;
+   int32_t  marker;
+} ExecutionVisualizerSpan;
+
 // Routines to retrieve the ToolTip information for a particular opcode.
 const char* OPCODEINFO ( uint8_t op );
 const char* OPCODEINFO ( const char* op );
@@ -41,7 +62,25 @@ public:
    }
    static void RENDEREXECUTIONVISUALIZER ( void );
 
+   // The Execution Visualizer can show marker heat: how many of the
+   // last few frames each cycle was covered by a marker in.  One frame
+   // shows only the latest marked frame.
+   static inline void ExecutionVisualizerHeatFrames ( int32_t frames )
+   {
+      m_executionVisualizerHeatFrames = frames;
+   }
+   static inline int32_t ExecutionVisualizerHeatFrames ( void )
+   {
+      return m_executionVisualizerHeatFrames;
+   }
+
 protected:
+   // Splits the first numCycles cycles of a frame into the runs covered
+   // by each marker, a later marker covering an earlier one.
+   static int32_t EXECUTIONVISUALIZERSPANS ( uint32_t numCycles, ExecutionVisualizerSpan* pSpans );
+   static void EXECUTIONVISUALIZERHEAT ( uint32_t numCycles, ExecutionVisualizerSpan* pSpans, int32_t numSpans );
+
+
    // The memory for the Code/Data Logger display.  It is allocated
    // by the debugger inspector and passed to the CPU core for use
    // during emulation.
@@ -51,6 +90,19 @@ protected:
    // by the debugger inspector and passed to the CPU core for use
    // during emulation.
    static int8_t*          m_pExecutionVisualizerInspectorTV;
+
+   // Marker heat.  The marked runs of the frames heat is accumulated
+   // over are kept so each can be taken back out when it gets too old.
+   static int32_t          m_executionVisualizerHeatFrames;
+   static int32_t          m_executionHeatFrames;
+   static uint32_t         m_executionHeatCycles;
+   static uint32_t         m_executionHeatLastFrame;
+   static int32_t          m_executionHeatHistoryHead;
+   static int32_t          m_executionHeatHistoryCount;
+   static int32_t          m_executionHeatHistorySpans [ EXECUTION_VISUALIZER_MAX_HEAT_FRAMES ];
+   static ExecutionVisualizerSpan m_executionHeatHistory [ EXECUTION_VISUALIZER_MAX_HEAT_FRAMES ][ EXECUTION_VISUALIZER_MAX_SPANS ];
+   static uint16_t         m_executionHeat [ EXECUTION_VISUALIZER_MAX_CYCLES ];
+   static int8_t           m_executionHeatMarker [ EXECUTION_VISUALIZER_MAX_CYCLES ];
 };
 
 // Structure representing each instruction and
@@ -22,6 +22,8 @@
 
 #include <QColor>
 
+#include <string.h>
+
 int8_t*          CPPUDBG::m_pCodeDataLoggerInspectorTV = NULL;
 
 int8_t*          CPPUDBG::m_pCHRMEMInspectorTV = NULL;
@@ -34,7 +36,13 @@ uint32_t CPPUDBG::m_iOAMViewerScanline = 0;
 bool CPPUDBG::m_bPPUViewerShowVisible = true;
 bool CPPUDBG::m_bOAMViewerShowVisible = false;
 
-PpuStateSnapshot CPPUDBG::m_ppuState;
+int8_t   CPPUDBG::m_nameTableImage [ 512*480*4 ];
+int8_t   CPPUDBG::m_nameTableTiles [ 512 ][ 4 ][ PATTERN_SIZE*PATTERN_SIZE*4 ];
+bool     CPPUDBG::m_nameTableTileValid [ 512 ][ 4 ];
+uint8_t  CPPUDBG::m_nameTableMemory [ 0x3000 ];
+int8_t   CPPUDBG::m_nameTableColors [ 16 ][ 3 ];
+uint32_t CPPUDBG::m_nameTablePatternBase = 0;
+bool     CPPUDBG::m_nameTableDrawn = false;
 
 CPPUDBG::CPPUDBG()
 {
@@ -63,21 +71,22 @@ void CPPUDBG::RENDERCODEDATALOGGER ( void )
 {
    uint32_t idxx;
    uint32_t cycleDiff;
-   uint32_t curCycle = CCodeDataLogger::GetCurCycle ();
+   uint32_t curCycle;
    QColor lcolor;
-   CCodeDataLogger* pLogger;
-   LoggerInfo* pLogEntry;
+   const nesDebuggerSnapshot* pSnapshot = nesGetDebuggerSnapshot();
+   const nesDebuggerLogEntry* pLogEntry;
    int8_t* pTV;
 
    pTV = (int8_t*)m_pCodeDataLoggerInspectorTV;
    if ( !pTV ) return;
+   if ( !pSnapshot ) return;
 
-   // Show PPU memory...
-   pLogger = nesGetPpuCodeDataLoggerDatabase();
+   curCycle = pSnapshot->logCycle;
 
+   // Show PPU memory...
    for ( idxx = 0; idxx < 0x4000; idxx++ )
    {
-      pLogEntry = pLogger->GetLogEntry(idxx);
+      pLogEntry = pSnapshot->ppuLog+idxx;
       cycleDiff = (curCycle-pLogEntry->cycle)/10000;
 
       if ( cycleDiff > 199 )
@@ -86,7 +95,7 @@ void CPPUDBG::RENDERCODEDATALOGGER ( void )
       }
       cycleDiff = 255-cycleDiff;
 
-      if ( pLogEntry->count )
+      if ( pLogEntry->accessed )
       {
          // PPU fetches are one color, CPU fetches are others...
          if ( pLogEntry->source == eNESSource_PPU )
@@ -137,11 +146,15 @@ void CPPUDBG::RENDERCHRMEM ( void )
    uint8_t colorIdx;
    int32_t color[4][3];
    int8_t* pTV;
+   const nesDebuggerSnapshot* pSnapshot;
+   const PpuStateSnapshot* pPpuState;
 
    pTV = (int8_t*)m_pCHRMEMInspectorTV;
    if ( !pTV ) return;
 
-   nesGetPpuSnapshot(&m_ppuState);
+   pSnapshot = nesGetDebuggerSnapshot();
+   if ( !pSnapshot ) return;
+   pPpuState = &pSnapshot->ppu;
 
    color[0][0] = m_chrMemColor[0].red();
    color[0][1] = m_chrMemColor[0].green();
@@ -167,8 +180,8 @@ void CPPUDBG::RENDERCHRMEM ( void )
             ppuAddr += 0x1000;
          }
 
-         patternData1 = m_ppuState.memory[ppuAddr];
-         patternData2 = m_ppuState.memory[ppuAddr+8];
+         patternData1 = pPpuState->memory[ppuAddr];
+         patternData2 = pPpuState->memory[ppuAddr+8];
 
          for ( int32_t xf = 0; xf < 8; xf++ )
          {
@@ -203,22 +216,26 @@ void CPPUDBG::RENDEROAM ( void )
    uint8_t spriteY;
    QColor color[4];
    int8_t* pTV;
+   const nesDebuggerSnapshot* pSnapshot;
+   const PpuStateSnapshot* pPpuState;
 
    pTV = (int8_t*)m_pOAMInspectorTV;
    if ( !pTV ) return;
 
-   nesGetPpuSnapshot(&m_ppuState);
+   pSnapshot = nesGetDebuggerSnapshot();
+   if ( !pSnapshot ) return;
+   pPpuState = &pSnapshot->ppu;
 
    color[0] = CBasePalette::GetPalette ( 0x0D );
    color[1] = CBasePalette::GetPalette ( 0x10 );
    color[2] = CBasePalette::GetPalette ( 0x20 );
    color[3] = CBasePalette::GetPalette ( 0x30 );
 
-   spriteSize = ((!!(m_ppuState.reg[PPUCTRL_REG]&PPUCTRL_SPRITE_SIZE))+1)<<3;
+   spriteSize = ((!!(pPpuState->reg[PPUCTRL_REG]&PPUCTRL_SPRITE_SIZE))+1)<<3;
 
    if ( spriteSize == 8 )
    {
-      spritePatBase = (!!(m_ppuState.reg[PPUCTRL_REG]&PPUCTRL_SPRITE_PAT_TBL_ADDR))<<12;
+      spritePatBase = (!!(pPpuState->reg[PPUCTRL_REG]&PPUCTRL_SPRITE_PAT_TBL_ADDR))<<12;
    }
 
    for ( y = 0; y < spriteSize<<1; y++ )
@@ -227,12 +244,12 @@ void CPPUDBG::RENDEROAM ( void )
       {
          sprite = (spriteSize==8)?((y>>3)<<5)+(x>>3):
                   ((y>>4)<<5)+(x>>3);
-         spriteY = m_ppuState.oamMemory[(sprite<<2)+SPRITEY];
+         spriteY = pPpuState->oamMemory[(sprite<<2)+SPRITEY];
 
          if ( ((m_bOAMViewerShowVisible) && ((spriteY+1) < SPRITE_YMAX)) ||
                (!m_bOAMViewerShowVisible) )
          {
-            patternIdx = m_ppuState.oamMemory[(sprite<<2)+SPRITEPAT];
+            patternIdx = pPpuState->oamMemory[(sprite<<2)+SPRITEPAT];
 
             if ( spriteSize == 16 )
             {
@@ -240,7 +257,7 @@ void CPPUDBG::RENDEROAM ( void )
                patternIdx &= 0xFE;
             }
 
-            spriteAttr = m_ppuState.oamMemory[(sprite<<2)+SPRITEATT];
+            spriteAttr = pPpuState->oamMemory[(sprite<<2)+SPRITEATT];
             spriteFlipVert = !!(spriteAttr&SPRITE_FLIP_VERT);
             spriteFlipHoriz = !!(spriteAttr&SPRITE_FLIP_HORIZ);
             attribData = (spriteAttr&SPRITE_PALETTE_IDX_MSK)<<2;
@@ -260,8 +277,8 @@ void CPPUDBG::RENDEROAM ( void )
                yf = (7-yf);
             }
 
-            patternData1 = m_ppuState.memory[spritePatBase+(patternIdx<<4)+(yf)];
-            patternData2 = m_ppuState.memory[spritePatBase+(patternIdx<<4)+(yf)+PATTERN_SIZE];
+            patternData1 = pPpuState->memory[spritePatBase+(patternIdx<<4)+(yf)];
+            patternData2 = pPpuState->memory[spritePatBase+(patternIdx<<4)+(yf)+PATTERN_SIZE];
 
             for ( xf = 0; xf < PATTERN_SIZE; xf++ )
             {
@@ -277,9 +294,9 @@ void CPPUDBG::RENDEROAM ( void )
                }
 
                colorIdx = (attribData|bit1|(bit2<<1));
-               *pTV = CBasePalette::GetPaletteR(m_ppuState.paletteMemory[0x10+colorIdx]);
-               *(pTV+1) = CBasePalette::GetPaletteG(m_ppuState.paletteMemory[0x10+colorIdx]);
-               *(pTV+2) = CBasePalette::GetPaletteB(m_ppuState.paletteMemory[0x10+colorIdx]);
+               *pTV = CBasePalette::GetPaletteR(pPpuState->paletteMemory[0x10+colorIdx]);
+               *(pTV+1) = CBasePalette::GetPaletteG(pPpuState->paletteMemory[0x10+colorIdx]);
+               *(pTV+2) = CBasePalette::GetPaletteB(pPpuState->paletteMemory[0x10+colorIdx]);
 
                pTV += 4;
             }
@@ -299,131 +316,225 @@ void CPPUDBG::RENDEROAM ( void )
    }
 }
 
+// Whether a nametable coordinate is within the range, possibly wrapping,
+// visible on the TV.
+static inline bool isInWindow ( int32_t v, int32_t lb, int32_t ub )
+{
+   return ((lb <= ub) && (v >= lb) && (v <= ub)) ||
+          ((lb > ub) && (!((v <= lb) && (v >= ub))));
+}
+
+static inline void dimSpan ( int8_t* pTV, int32_t from, int32_t to )
+{
+   int32_t x;
+
+   if ( from < 0 )
+   {
+      from = 0;
+   }
+   if ( to > 511 )
+   {
+      to = 511;
+   }
+   for ( x = from; x <= to; x++ )
+   {
+      *(pTV+(x<<2)) &= 0xCF;
+      *(pTV+(x<<2)+1) &= 0xCF;
+      *(pTV+(x<<2)+2) &= 0xCF;
+   }
+}
+
 void CPPUDBG::RENDERNAMETABLE ( void )
 {
-   int32_t x, xf, y;
+   int32_t x, y, xf, yf;
    int32_t lbx, ubx, lby, uby;
-
-   uint32_t ppuAddr = 0x0000;
-   uint16_t patternIdx;
+   int32_t nameTable;
    int32_t tileX;
    int32_t tileY;
    int32_t nameAddr;
    int32_t attribAddr;
-   int32_t bkgndPatBase;
+   uint32_t patternBase;
+   uint32_t pattern;
    uint8_t attribData;
    uint8_t patternData1;
    uint8_t patternData2;
-   uint8_t bit1, bit2;
    uint8_t colorIdx;
+   uint8_t palette;
+   bool redrawAll;
+   bool patternChanged [ 512 ];
+   bool paletteChanged [ 4 ];
+   bool sameScroll;
+   int8_t colors [ 16 ][ 3 ];
+   int8_t* pTile;
+   int8_t* pImage;
    int8_t* pTV;
+   const nesDebuggerSnapshot* pSnapshot;
+   const PpuStateSnapshot* pPpuState;
 
    pTV = (int8_t*)m_pNameTableInspectorTV;
    if ( !pTV ) return;
 
-   nesGetPpuSnapshot(&m_ppuState);
+   pSnapshot = nesGetDebuggerSnapshot();
+   if ( !pSnapshot ) return;
+   pPpuState = &pSnapshot->ppu;
 
-   for ( y = 0; y < 480; y++ )
+   patternBase = (!!(pPpuState->reg[PPUCTRL_REG]&PPUCTRL_BKGND_PAT_TBL_ADDR))<<8;
+   redrawAll = (!m_nameTableDrawn) || (patternBase != m_nameTablePatternBase);
+
+   // Find the palettes whose colors have changed, in the PPU or in the
+   // system palette, and forget the tiles decoded in them.
+   for ( colorIdx = 0; colorIdx < 16; colorIdx++ )
    {
-      for ( x = 0; x < 512; x += PATTERN_SIZE ) // pattern-slice rendering...
+      colors[colorIdx][0] = CBasePalette::GetPaletteR(pPpuState->paletteMemory[colorIdx]);
+      colors[colorIdx][1] = CBasePalette::GetPaletteG(pPpuState->paletteMemory[colorIdx]);
+      colors[colorIdx][2] = CBasePalette::GetPaletteB(pPpuState->paletteMemory[colorIdx]);
+   }
+   for ( palette = 0; palette < 4; palette++ )
+   {
+      paletteChanged[palette] = (!m_nameTableDrawn) ||
+                                memcmp(colors[palette<<2],m_nameTableColors[palette<<2],sizeof(colors[0])*4);
+      if ( paletteChanged[palette] )
       {
-         tileX = ppuAddr&0x001F;
-         tileY = (ppuAddr&0x03E0)>>5;
-         nameAddr = 0x2000 + (ppuAddr&0x0FFF);
-         attribAddr = 0x2000 + (ppuAddr&0x0C00) + 0x03C0 + ((tileY&0xFFFC)<<1) + (tileX>>2);
-         bkgndPatBase = (!!(m_ppuState.reg[PPUCTRL_REG]&PPUCTRL_BKGND_PAT_TBL_ADDR))<<12;
-
-         patternIdx = bkgndPatBase+(m_ppuState.memory[nameAddr]<<4)+((ppuAddr&0x7000)>>12);
-         attribData = m_ppuState.memory[attribAddr];
-         patternData1 = m_ppuState.memory[patternIdx];
-         patternData2 = m_ppuState.memory[patternIdx+PATTERN_SIZE];
-
-         if ( (tileY&0x0002) == 0 )
+         for ( pattern = 0; pattern < 512; pattern++ )
          {
-            if ( (tileX&0x0002) == 0 )
-            {
-               attribData = (attribData&0x03)<<2;
-            }
-            else
-            {
-               attribData = (attribData&0x0C);
-            }
+            m_nameTableTileValid[pattern][palette] = false;
          }
-         else
+      }
+   }
+   memcpy(m_nameTableColors,colors,sizeof(colors));
+
+   // Likewise for the patterns whose CHR bytes have changed.
+   for ( pattern = 0; pattern < 512; pattern++ )
+   {
+      patternChanged[pattern] = (!m_nameTableDrawn) ||
+                                memcmp(pPpuState->memory+(pattern<<4),m_nameTableMemory+(pattern<<4),PATTERN_SIZE<<1);
+      if ( patternChanged[pattern] )
+      {
+         for ( palette = 0; palette < 4; palette++ )
          {
-            if ( (tileX&0x0002) == 0 )
-            {
-               attribData = (attribData&0x30)>>2;
-            }
-            else
-            {
-               attribData = (attribData&0xC0)>>4;
-            }
+            m_nameTableTileValid[pattern][palette] = false;
          }
+      }
+   }
 
-         for ( xf = 0; xf < PATTERN_SIZE; xf++ )
+   // Redraw the tiles whose nametable or attribute byte has changed, or
+   // that are drawn with a changed pattern or palette.
+   for ( nameTable = 0; nameTable < 4; nameTable++ )
+   {
+      for ( tileY = 0; tileY < 30; tileY++ )
+      {
+         for ( tileX = 0; tileX < 32; tileX++ )
          {
-            bit1 = (patternData1>>(7-(xf)))&0x1;
-            bit2 = (patternData2>>(7-(xf)))&0x1;
-            colorIdx = (attribData|bit1|(bit2<<1));
-            *pTV = CBasePalette::GetPaletteR(m_ppuState.paletteMemory[colorIdx]);
-            *(pTV+1) = CBasePalette::GetPaletteG(m_ppuState.paletteMemory[colorIdx]);
-            *(pTV+2) = CBasePalette::GetPaletteB(m_ppuState.paletteMemory[colorIdx]);
-
-            if ( m_bPPUViewerShowVisible )
+            nameAddr = 0x2000 + (nameTable<<10) + (tileY<<5) + tileX;
+            attribAddr = 0x2000 + (nameTable<<10) + 0x03C0 + ((tileY&0xFFFC)<<1) + (tileX>>2);
+
+            pattern = patternBase + pPpuState->memory[nameAddr];
+            attribData = pPpuState->memory[attribAddr];
+            palette = (attribData>>((((tileY&0x0002)<<1)|(tileX&0x0002))))&0x03;
+
+            if ( !( redrawAll ||
+                    patternChanged[pattern] ||
+                    paletteChanged[palette] ||
+                    (pPpuState->memory[nameAddr] != m_nameTableMemory[nameAddr]) ||
+                    (attribData != m_nameTableMemory[attribAddr]) ) )
             {
-               lbx = *(*(m_ppuState.xOffset+((x+xf)&0xFF))+(y%240));
-               ubx = lbx>>8?lbx&0xFF:lbx+255;
-               lby = *(*(m_ppuState.yOffset+((x+xf)&0xFF))+(y%240));
-               uby = lby/240?lby%240:lby+239;
+               continue;
+            }
 
-               if ( !( (((lbx <= ubx) && ((x+xf) >= lbx) && ((x+xf) <= ubx)) ||
-                        ((lbx > ubx) && (!(((x+xf) <= lbx) && ((x+xf) >= ubx))))) &&
-                       (((lby <= uby) && (y >= lby) && (y <= uby)) ||
-                        ((lby > uby) && (!((y <= lby) && (y >= uby))))) ) )
+            pTile = m_nameTableTiles[pattern][palette];
+            if ( !m_nameTableTileValid[pattern][palette] )
+            {
+               for ( yf = 0; yf < PATTERN_SIZE; yf++ )
                {
-                  *pTV &= 0xCF;
-                  *(pTV+1) &= 0xCF;
-                  *(pTV+2) &= 0xCF;
+                  patternData1 = pPpuState->memory[(pattern<<4)+yf];
+                  patternData2 = pPpuState->memory[(pattern<<4)+yf+PATTERN_SIZE];
+
+                  for ( xf = 0; xf < PATTERN_SIZE; xf++ )
+                  {
+                     colorIdx = (palette<<2)|((patternData1>>(7-xf))&0x1)|(((patternData2>>(7-xf))&0x1)<<1);
+                     *(pTile+(((yf<<3)+xf)<<2)) = colors[colorIdx][0];
+                     *(pTile+(((yf<<3)+xf)<<2)+1) = colors[colorIdx][1];
+                     *(pTile+(((yf<<3)+xf)<<2)+2) = colors[colorIdx][2];
+                     *(pTile+(((yf<<3)+xf)<<2)+3) = 0xFF;
+                  }
                }
+               m_nameTableTileValid[pattern][palette] = true;
             }
 
-            pTV += 4;
+            x = ((nameTable&1)<<8) + (tileX<<3);
+            y = ((nameTable>>1)*240) + (tileY<<3);
+            for ( yf = 0; yf < PATTERN_SIZE; yf++ )
+            {
+               memcpy(m_nameTableImage+((((y+yf)<<9)+x)<<2),pTile+((yf<<3)<<2),PATTERN_SIZE<<2);
+            }
          }
+      }
+   }
 
-         ppuAddr++;
+   memcpy(m_nameTableMemory,pPpuState->memory,sizeof(m_nameTableMemory));
+   m_nameTablePatternBase = patternBase;
+   m_nameTableDrawn = true;
 
-         if ( x == 248 || x == 504 )
-         {
-            ppuAddr ^= 0x400;
-            ppuAddr -= 0x20;
-         }
-      }
+   // Decorate the invisible regions.  When the scroll didn't change
+   // across a scanline the visible region of that row of the nametables
+   // is an interval, so the rows are decorated a span at a time.
+   for ( y = 0; y < 480; y++ )
+   {
+      pImage = m_nameTableImage+((y<<9)<<2);
+      memcpy(pTV,pImage,512<<2);
 
-      if ( (ppuAddr&0x7000) == 0x7000 )
+      if ( m_bPPUViewerShowVisible )
       {
-         ppuAddr &= 0x8FFF;
+         lbx = pPpuState->xOffset[0][y%240];
+         lby = pPpuState->yOffset[0][y%240];
 
-         if ( (ppuAddr&0x03E0) == 0x03A0 )
+         sameScroll = true;
+         for ( x = 1; x < 256; x++ )
          {
-            ppuAddr ^= 0x0800;
-            ppuAddr &= 0xFC1F;
+            if ( (pPpuState->xOffset[x][y%240] != lbx) ||
+                 (pPpuState->yOffset[x][y%240] != lby) )
+            {
+               sameScroll = false;
+               break;
+            }
          }
-         else
+
+         if ( sameScroll )
          {
-            if ( (ppuAddr&0x03E0) == 0x03E0 )
+            ubx = lbx>>8?lbx&0xFF:lbx+255;
+            uby = lby/240?lby%240:lby+239;
+
+            if ( !isInWindow(y,lby,uby) )
+            {
+               dimSpan(pTV,0,511);
+            }
+            else if ( lbx <= ubx )
             {
-               ppuAddr &= 0xFC1F;
+               dimSpan(pTV,0,lbx-1);
+               dimSpan(pTV,ubx+1,511);
             }
             else
             {
-               ppuAddr += 0x0020;
+               dimSpan(pTV,ubx,lbx);
+            }
+         }
+         else
+         {
+            for ( x = 0; x < 512; x++ )
+            {
+               lbx = *(*(pPpuState->xOffset+(x&0xFF))+(y%240));
+               ubx = lbx>>8?lbx&0xFF:lbx+255;
+               lby = *(*(pPpuState->yOffset+(x&0xFF))+(y%240));
+               uby = lby/240?lby%240:lby+239;
+
+               if ( !(isInWindow(x,lbx,ubx) && isInWindow(y,lby,uby)) )
+               {
+                  dimSpan(pTV,x,x);
+               }
             }
          }
       }
-      else
-      {
-         ppuAddr += 0x1000;
-      }
+
+      pTV += 512<<2;
    }
 }
@@ -144,7 +144,18 @@ public:
    // Flag indicating whether or not to decorate invisible TV region(s).
    static bool           m_bPPUViewerShowVisible;
 
-   static PpuStateSnapshot m_ppuState;
+   // The nametable inspector keeps the nametables drawn, without the
+   // invisible region decoration, between updates and only redraws the
+   // tiles whose nametable, attribute, pattern or palette bytes differ
+   // from those it last drew with.  Tiles are copied from a cache of the
+   // patterns decoded in each of the background palettes.
+   static int8_t         m_nameTableImage [ 512*480*4 ];
+   static int8_t         m_nameTableTiles [ 512 ][ 4 ][ PATTERN_SIZE*PATTERN_SIZE*4 ];
+   static bool           m_nameTableTileValid [ 512 ][ 4 ];
+   static uint8_t        m_nameTableMemory [ 0x3000 ];
+   static int8_t         m_nameTableColors [ 16 ][ 3 ];
+   static uint32_t       m_nameTablePatternBase;
+   static bool           m_nameTableDrawn;
 };
 
 #endif
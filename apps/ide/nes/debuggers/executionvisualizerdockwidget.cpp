@@ -48,8 +48,11 @@ ExecutionVisualizerDockWidget::ExecutionVisualizerDockWidget(QWidget *parent) :
    sizes.append(200);
    ui->splitter->setSizes(sizes);
 
-   pThread = new DebuggerUpdateThread(&C6502DBG::RENDEREXECUTIONVISUALIZER);
+   pThread = new DebuggerUpdateThread(&C6502DBG::RENDEREXECUTIONVISUALIZER,this);
    QObject::connect(pThread,SIGNAL(updateComplete()),this,SLOT(renderData()));
+
+   ui->heatFrames->setMaximum(EXECUTION_VISUALIZER_MAX_HEAT_FRAMES);
+   ui->heatFrames->setValue(C6502DBG::ExecutionVisualizerHeatFrames());
 }
 
 ExecutionVisualizerDockWidget::~ExecutionVisualizerDockWidget()
@@ -144,6 +147,8 @@ bool ExecutionVisualizerDockWidget::serialize(QDomDocument& doc, QDomNode& node)
    CMarker* pMarkers = nesGetExecutionMarkerDatabase();
    int marker;
 
+   element.setAttribute("heatframes",ui->heatFrames->value());
+
    for ( marker = 0; marker < pMarkers->GetNumMarkers(); marker++ )
    {
       QDomElement markerElement = addElement( doc, element, "marker" );
@@ -197,6 +202,12 @@ bool ExecutionVisualizerDockWidget::deserialize(QDomDocument& /*doc*/, QDomNode&
       {
          if (childNode.nodeName() == "markers")
          {
+            // Loading the setting doesn't change the project.
+            ui->heatFrames->blockSignals(true);
+            ui->heatFrames->setValue(childNode.toElement().attribute("heatframes","1").toInt());
+            ui->heatFrames->blockSignals(false);
+            C6502DBG::ExecutionVisualizerHeatFrames(ui->heatFrames->value());
+
             markerNode = childNode.firstChild();
             while ( !(markerNode.isNull()) )
             {
@@ -269,3 +280,11 @@ void ExecutionVisualizerDockWidget::on_actionRemove_Marker_triggered()
       emit markProjectDirty(true);
    }
 }
+
+void ExecutionVisualizerDockWidget::on_heatFrames_valueChanged(int frames)
+{
+   C6502DBG::ExecutionVisualizerHeatFrames(frames);
+   pThread->updateDebuggers();
+
+   emit markProjectDirty(true);
+}
@@ -41,6 +41,7 @@ public slots:
 private slots:
    void on_actionRemove_Marker_triggered();
    void on_actionReset_Marker_Data_triggered();
+   void on_heatFrames_valueChanged(int frames);
    void tableView_currentChanged(QModelIndex index,QModelIndex);
 
 signals:
@@ -24,6 +24,10 @@ MapperInformationDockWidget::MapperInformationDockWidget(QWidget *parent) :
 
    ui->setupUi(this);
 
+   // Nothing to draw off the UI thread, but updates are coalesced and timed.
+   pThread = new DebuggerUpdateThread(NULL,this);
+   QObject::connect(pThread,SIGNAL(updateComplete()),this,SLOT(updateInformation()));
+
    ui->tabWidget->setCurrentIndex(InternalsPage);
 
    // Set up default mapper internal info page map.
@@ -50,6 +54,7 @@ MapperInformationDockWidget::MapperInformationDockWidget(QWidget *parent) :
 
 MapperInformationDockWidget::~MapperInformationDockWidget()
 {
+    delete pThread;
     delete ui;
 }
 
@@ -82,7 +87,7 @@ void MapperInformationDockWidget::showEvent(QShowEvent* /*e*/)
 {
    QObject* emulator = CObjectRegistry::getObject("Emulator");
 
-   QObject::connect ( emulator, SIGNAL(updateDebuggers()), this, SLOT(updateInformation()) );
+   QObject::connect ( emulator, SIGNAL(updateDebuggers()), pThread, SLOT(updateDebuggers()) );
    updateInformation();
 }
 
@@ -90,7 +95,7 @@ void MapperInformationDockWidget::hideEvent(QHideEvent* /*e*/)
 {
    QObject* emulator = CObjectRegistry::getObject("Emulator");
 
-   QObject::disconnect ( emulator, SIGNAL(updateDebuggers()), this, SLOT(updateInformation()) );
+   QObject::disconnect ( emulator, SIGNAL(updateDebuggers()), pThread, SLOT(updateDebuggers()) );
 }
 
 void MapperInformationDockWidget::machineReady()
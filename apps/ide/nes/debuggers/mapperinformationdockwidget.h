@@ -5,6 +5,8 @@
 
 #include "cdebuggerbase.h"
 
+#include "debuggerupdatethread.h"
+
 namespace Ui {
     class MapperInformationDockWidget;
 }
@@ -29,6 +31,7 @@ public slots:
 
 private:
    Ui::MapperInformationDockWidget *ui;
+   DebuggerUpdateThread* pThread;
    QMap<int,QWidget*> internalPageMap;
 };
 
@@ -32,7 +32,7 @@ NameTableVisualizerDockWidget::NameTableVisualizerDockWidget(QWidget *parent) :
 
    ui->showVisible->setChecked ( true );
 
-   pThread = new DebuggerUpdateThread(&CPPUDBG::RENDERNAMETABLE);
+   pThread = new DebuggerUpdateThread(&CPPUDBG::RENDERNAMETABLE,this);
    QObject::connect(pThread,SIGNAL(updateComplete()),this,SLOT(renderData()));
 }
 
@@ -35,7 +35,7 @@ OAMVisualizerDockWidget::OAMVisualizerDockWidget(QWidget *parent) :
    ui->updateScanline->setText ( "0" );
    ui->showVisible->setChecked ( false );
 
-   pThread = new DebuggerUpdateThread(&CPPUDBG::RENDEROAM);
+   pThread = new DebuggerUpdateThread(&CPPUDBG::RENDEROAM,this);
    QObject::connect(pThread,SIGNAL(updateComplete()),this,SLOT(renderData()));
 }
 
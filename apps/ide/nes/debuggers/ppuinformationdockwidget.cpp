@@ -12,10 +12,15 @@ PPUInformationDockWidget::PPUInformationDockWidget(QWidget *parent) :
     ui(new Ui::PPUInformationDockWidget)
 {
    ui->setupUi(this);
+
+   // Nothing to draw off the UI thread, but updates are coalesced and timed.
+   pThread = new DebuggerUpdateThread(NULL,this);
+   QObject::connect(pThread,SIGNAL(updateComplete()),this,SLOT(updateInformation()));
 }
 
 PPUInformationDockWidget::~PPUInformationDockWidget()
 {
+   delete pThread;
    delete ui;
 }
 
@@ -48,7 +53,7 @@ void PPUInformationDockWidget::showEvent(QShowEvent* /*e*/)
 {
    QObject* emulator = CObjectRegistry::getObject("Emulator");
 
-   QObject::connect ( emulator, SIGNAL(updateDebuggers()), this, SLOT(updateInformation()) );
+   QObject::connect ( emulator, SIGNAL(updateDebuggers()), pThread, SLOT(updateDebuggers()) );
    updateInformation();
 }
 
@@ -56,13 +61,14 @@ void PPUInformationDockWidget::hideEvent(QHideEvent* /*e*/)
 {
    QObject* emulator = CObjectRegistry::getObject("Emulator");
 
-   QObject::disconnect ( emulator, SIGNAL(updateDebuggers()), this, SLOT(updateInformation()) );
+   QObject::disconnect ( emulator, SIGNAL(updateDebuggers()), pThread, SLOT(updateDebuggers()) );
 }
 
 void PPUInformationDockWidget::updateInformation()
 {
    const char* ppuFlipFlopStr [] = { "Low", "High" };
    CBreakpointInfo* pBreakpoints = nesGetBreakpointDatabase();
+   nesVideoInfo videoInfo;
    int idx;
    char buffer[16];
    unsigned char x,y;
@@ -107,6 +113,17 @@ void PPUInformationDockWidget::updateInformation()
       ui->ppuAddrLatch->setText(buffer);
 
       ui->ppuFlipFlop->setText(ppuFlipFlopStr[nesGetPPUFlipFlop()]);
+
+      nesGetVideoInformation(&videoInfo);
+
+      sprintf ( buffer, "%u", videoInfo.frames );
+      ui->videoFrames->setText(buffer);
+
+      sprintf ( buffer, "%u", videoInfo.dropped );
+      ui->videoDropped->setText(buffer);
+
+      sprintf ( buffer, "%u", videoInfo.duplicated );
+      ui->videoDuplicated->setText(buffer);
    }
 
    // Check breakpoints for hits and highlight if necessary...
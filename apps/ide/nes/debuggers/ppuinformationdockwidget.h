@@ -3,6 +3,8 @@
 
 #include "cdebuggerbase.h"
 
+#include "debuggerupdatethread.h"
+
 namespace Ui {
    class PPUInformationDockWidget;
 }
@@ -26,6 +28,7 @@ public slots:
 
 private:
    Ui::PPUInformationDockWidget *ui;
+   DebuggerUpdateThread* pThread;
 };
 
 #endif // PPUINFORMATIONDOCKWIDGET_H
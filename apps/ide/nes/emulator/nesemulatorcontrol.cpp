@@ -2,6 +2,7 @@
 #include "ui_nesemulatorcontrol.h"
 
 #include "ccc65interface.h"
+#include "debuggerupdatethread.h"
 
 #include "nes_emulator_core.h"
 
@@ -45,6 +46,7 @@ NESEmulatorControl::NESEmulatorControl(QWidget *parent) :
    QObject::connect(this,SIGNAL(stepOutCPUEmulation()),emulator,SLOT(stepOutCPUEmulation()));
    QObject::connect(this,SIGNAL(stepPPUEmulation()),emulator,SLOT(stepPPUEmulation()));
    QObject::connect(this,SIGNAL(advanceFrame()),emulator,SLOT(advanceFrame()));
+   QObject::connect(this,SIGNAL(stepBackFrame()),emulator,SLOT(stepBackFrame()));
    QObject::connect(this,SIGNAL(resetEmulator()),emulator,SLOT(resetEmulator()));
    QObject::connect(this,SIGNAL(softResetEmulator()),emulator,SLOT(softResetEmulator()));
 
@@ -67,6 +69,7 @@ QList<QAction*> NESEmulatorControl::menu()
    items.append(ui->actionStep_Out);
    items.append(ui->actionStep_PPU);
    items.append(ui->actionFrame_Advance);
+   items.append(ui->actionFrame_Back);
    items.append(ui->actionReset);
    items.append(ui->actionSoft_Reset);
    return items;
@@ -88,6 +91,7 @@ void NESEmulatorControl::internalPlay()
    ui->actionStep_Out->setEnabled(false);
    ui->actionStep_PPU->setEnabled(false);
    ui->actionFrame_Advance->setEnabled(false);
+   ui->actionFrame_Back->setEnabled(false);
 }
 
 void NESEmulatorControl::internalPause()
@@ -108,6 +112,7 @@ void NESEmulatorControl::internalPause()
       ui->actionStep_Out->setEnabled(debugging);
       ui->actionStep_PPU->setEnabled(debugging);
       ui->actionFrame_Advance->setEnabled(debugging);
+      ui->actionFrame_Back->setEnabled(debugging);
    }
    else
    {
@@ -125,7 +130,11 @@ void NESEmulatorControl::internalPause()
       ui->actionStep_Out->setEnabled(false);
       ui->actionStep_PPU->setEnabled(false);
       ui->actionFrame_Advance->setEnabled(false);
+      ui->actionFrame_Back->setEnabled(false);
    }
+
+   // Say what the inspectors cost while the emulator was running.
+   DebuggerUpdateThread::report();
 }
 
 void NESEmulatorControl::on_playButton_clicked()
@@ -177,6 +186,11 @@ void NESEmulatorControl::on_frameAdvance_clicked()
    emit advanceFrame();
 }
 
+void NESEmulatorControl::on_actionFrame_Back_triggered()
+{
+   emit stepBackFrame();
+}
+
 void NESEmulatorControl::on_stepOverButton_clicked()
 {
    CCC65Interface::isBuildUpToDate();
@@ -204,6 +218,7 @@ void NESEmulatorControl::on_debugButton_toggled(bool checked)
    ui->actionStep_Out->setEnabled(checked);
    ui->actionStep_PPU->setEnabled(checked);
    ui->actionFrame_Advance->setEnabled(checked);
+   ui->actionFrame_Back->setEnabled(checked);
 
    if ( debugging )
    {
@@ -29,6 +29,7 @@ signals:
    void stepOutCPUEmulation();
    void stepPPUEmulation();
    void advanceFrame();
+   void stepBackFrame();
    void resetEmulator();
    void softResetEmulator();
 
@@ -38,6 +39,7 @@ private slots:
    void on_stepOutButton_clicked();
    void on_stepOverButton_clicked();
    void on_frameAdvance_clicked();
+   void on_actionFrame_Back_triggered();
    void on_resetButton_clicked();
    void on_stepPPUButton_clicked();
    void on_stepCPUButton_clicked();
@@ -14,7 +14,9 @@ NESEmulatorDockWidget::NESEmulatorDockWidget(QWidget *parent) :
 {
    int32_t i;
 
-   imgData = new char[256*256*4];
+   // The PPU and the renderer share three frames so neither waits on,
+   // or draws over, the other.
+   imgData = new char[3*256*256*4];
 
    ui->setupUi(this);
 
@@ -36,14 +38,14 @@ NESEmulatorDockWidget::NESEmulatorDockWidget(QWidget *parent) :
    m_joy [ CONTROLLER2 ] = 0;
 
    // Clear image to set alpha channel...
-   for ( i = 0; i < 256*256*4; i+=4 )
+   for ( i = 0; i < 3*256*256*4; i+=4 )
    {
       imgData[i] = 0;
       imgData[i+1] = 0;
       imgData[i+2] = 0;
       imgData[i+3] = 0xFF;
    }
-   nesSetTVOut((int8_t*)imgData);
+   nesSetTVOutQueue((int8_t*)imgData,(int8_t*)imgData+256*256*4,(int8_t*)imgData+2*256*256*4);
 }
 
 NESEmulatorDockWidget::~NESEmulatorDockWidget()
@@ -91,7 +93,7 @@ void NESEmulatorDockWidget::updateTargetMachine(QString target)
       QObject::connect(this,SIGNAL(controllerInput(uint32_t*)),emulator,SLOT(controllerInput(uint32_t*)));
    }
    QObject::connect(emulator, SIGNAL(emulatedFrame()), this, SLOT(renderData()));
-   QObject::connect(breakpointWatcher, SIGNAL(breakpointHit()), this, SLOT(renderData()));
+   QObject::connect(breakpointWatcher, SIGNAL(breakpointHit()), this, SLOT(renderCurrentData()));
 }
 
 void NESEmulatorDockWidget::changeEvent(QEvent* e)
@@ -440,5 +442,13 @@ void NESEmulatorDockWidget::keyReleaseEvent(QKeyEvent* event)
 
 void NESEmulatorDockWidget::renderData()
 {
+   renderer->reloadData((char*)nesAcquireTVOut());
+   renderer->update();
+}
+
+void NESEmulatorDockWidget::renderCurrentData()
+{
+   // Stopped in the middle of a frame, so show as much of it as is drawn.
+   renderer->reloadData((char*)nesGetTVOut());
    renderer->update();
 }
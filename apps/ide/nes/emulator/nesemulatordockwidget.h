@@ -42,6 +42,7 @@ private:
 
 private slots:
    void renderData();
+   void renderCurrentData();
    void updateTargetMachine(QString target);
 };
 
@@ -21,10 +21,12 @@ public:
    void setBGColor(QColor clr);
    void setLinearInterpolation(bool enabled) { linearInterpolation = enabled; }
    void set43Aspect(bool enabled) { aspect43 = enabled; }
+   void reloadData(char* imgData);
    int zoom;
    int scrollX;
    int scrollY;
    char* imageData;
+   bool imageChanged;
    GLuint textureID;
    QRect renderRect;
    bool linearInterpolation;
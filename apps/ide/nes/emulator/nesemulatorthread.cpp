@@ -76,15 +76,27 @@ extern "C" void SDL_Emulator(void* userdata, uint8_t* stream, int32_t len)
    to = t;
    qDebug(str.toLatin1().constData());
 #endif
-   if ( nesGetAudioSamplesAvailable() >= (len>>1) )
-   {
-      SDL_MixAudio(stream,nesGetAudioSamples(len>>1),len,SDL_MIX_MAXVOLUME);
-   }
-   else
+   int16_t samples [ APU_SAMPLES ];
+   int32_t chunk;
+
+   // The FamiTracker callback owns the stream; mix the NES in on top of it.
+   while ( len > 0 )
    {
-//      qDebug("UNDERRUN");
+      chunk = len>>1;
+      if ( chunk > APU_SAMPLES )
+      {
+         chunk = APU_SAMPLES;
+      }
+      nesReadAudioSamples(samples,chunk);
+      SDL_MixAudio(stream,(uint8_t*)samples,chunk<<1,SDL_MIX_MAXVOLUME);
+      stream += chunk<<1;
+      len -= chunk<<1;
    }
-   if ( emulator && emulator->nesAudioSemaphore )
+
+   // Let the emulator go on if it's waiting for room.  Don't bank wakeups
+   // while it isn't, or it would later run ahead of the audio.
+   if ( emulator && emulator->nesAudioSemaphore &&
+        (!emulator->nesAudioSemaphore->available()) )
       emulator->nesAudioSemaphore->release();
 }
 
@@ -101,6 +113,7 @@ NESEmulatorThread::NESEmulatorThread(QObject*)
    m_isStarting = false;
    m_isTerminating = false;
    m_isResetting = false;
+   m_isSteppingBack = false;
    m_debugFrame = 0;
    m_pCartridge = NULL;
    
@@ -111,15 +124,26 @@ NESEmulatorThread::NESEmulatorThread(QObject*)
    nesSetBreakpointHook(breakpointHook);
    nesSetAudioHook(audioHook);
 
+   // Keep a history of the emulation to step back through.
+   nesRewindEnable(REWIND_ARENA_SIZE,REWIND_INTERVAL);
+
    nesSDLCallback._user = this;
    nesSDLCallback._func = SDL_Emulator;
    nesSDLCallback._valid = true;
    sdlHooks.append(nesSDLCallback);
 
+   // Keep a couple of SDL buffers' worth of audio queued.
+   nesSetAudioLatency(APU_BUFFER_PRERENDER);
    nesClearAudioSamplesAvailable();
 
    BreakpointWatcherThread* breakpointWatcher = dynamic_cast<BreakpointWatcherThread*>(CObjectRegistry::getObject("Breakpoint Watcher"));
    QObject::connect(this,SIGNAL(breakpoint()),breakpointWatcher,SLOT(breakpoint()));
+   QObject::connect(this,SIGNAL(emulatedFrame()),breakpointWatcher,SLOT(updateLog()));
+
+   // The UI thread takes the snapshot each update is for before any of the
+   // inspectors connected after this handle it.
+   QObject::connect(this,SIGNAL(updateDebuggers()),this,SLOT(acquireDebuggerSnapshot()));
+   QObject::connect(this,SIGNAL(breakpoint()),this,SLOT(acquireDebuggerSnapshot()));
 }
 
 NESEmulatorThread::~NESEmulatorThread()
@@ -133,6 +157,14 @@ NESEmulatorThread::~NESEmulatorThread()
    nesAudioSemaphore = NULL;
 }
 
+void NESEmulatorThread::acquireDebuggerSnapshot()
+{
+   // What the UI thread shows of the NES from here until the next update,
+   // repaints included, comes from the snapshot just published, so no view
+   // of it is torn.
+   nesAcquireDebuggerSnapshot();
+}
+
 void NESEmulatorThread::kill()
 {
    // Force hard-reset of the machine...
@@ -384,6 +416,26 @@ void NESEmulatorThread::advanceFrame ()
    start();
 }
 
+void NESEmulatorThread::stepBackFrame ()
+{
+   // Stepping back can only be done between frames.  If we're stopped at
+   // a breakpoint the frame is finished first, so stepping back lands at
+   // the start of the frame the breakpoint was in.
+   nesEnableBreakpoints(false);
+
+   m_isSteppingBack = true;
+   m_isStarting = false;
+   m_isRunning = false;
+   m_isPaused = true;
+   m_showOnPause = false;
+
+   if ( !(nesBreakpointSemaphore->available()) )
+   {
+      nesBreakpointSemaphore->release();
+   }
+   start();
+}
+
 void NESEmulatorThread::pauseEmulation (bool show)
 {
    m_isStarting = false;
@@ -461,6 +513,7 @@ void NESEmulatorThread::loadCartridge()
 
       // Trigger inspector updates...
       nesDisassemble();
+      nesPublishDebuggerSnapshot();
       emit updateDebuggers();
 
       // Trigger UI updates...
@@ -477,6 +530,7 @@ void NESEmulatorThread::run ()
    int emuX;
    int emuY;
    int32_t samplesAvailable;
+   nesRewindInfo rewindInfo;
    int32_t debuggerUpdateRate = EnvironmentSettingsDialog::debuggerUpdateRate();
 
    // Special case for 1Hz debugger update to match system mode.
@@ -539,6 +593,7 @@ void NESEmulatorThread::run ()
 
          // Trigger inspector updates...
          nesDisassemble();
+         nesPublishDebuggerSnapshot();
          emit updateDebuggers();
 
          // Trigger UI updates...
@@ -548,11 +603,37 @@ void NESEmulatorThread::run ()
          m_isResetting = false;
       }
 
+      // Step back a frame...
+      if ( m_isSteppingBack )
+      {
+         m_isSteppingBack = false;
+
+         if ( nesRewindStepBack(1) )
+         {
+            nesRewindGetInformation(&rewindInfo);
+
+            // Report what the history is costing.
+            debugTextLogger->write("Stepped back one frame; "+QString::number(rewindInfo.framesAvailable)+
+                                   " frames of history in "+QString::number(rewindInfo.arenaUsed/1024)+
+                                   "KB of "+QString::number(rewindInfo.arenaSize/1024)+
+                                   "KB, "+QString::number(rewindInfo.lastSnapshotSize)+
+                                   " bytes and "+QString::number(rewindInfo.captureTime/1000.0,'f',1)+
+                                   "us per snapshot.");
+         }
+         else
+         {
+            debugTextLogger->write("<font color='red'>No earlier frame to step back to.</font>");
+         }
+
+         emit emulatedFrame();
+      }
+
       // Pause?
       if ( m_isPaused || (m_pauseAfterFrames == 0) )
       {
          // Trigger inspector updates...
          nesDisassemble();
+         nesPublishDebuggerSnapshot();
          emit updateDebuggers();
 
          // Trigger UI updates...
@@ -637,6 +718,7 @@ void NESEmulatorThread::run ()
             m_debugFrame = debuggerUpdateRate;
             if ( nesIsDebuggable() )
             {
+               nesPublishDebuggerSnapshot();
                emit updateDebuggers();
             }
          }
@@ -653,6 +735,9 @@ bool NESEmulatorThread::serialize(QDomDocument& doc, QDomNode& node)
    char byte[3];
    int  idx;
 
+   // Save the NES itself rather than the debuggers' snapshot of it.
+   nesReleaseDebuggerSnapshot();
+
    // Save state.
    QDomElement saveElement = addElement ( doc, node, "save" );
    // Serialize the CPU state.
@@ -770,6 +855,9 @@ bool NESEmulatorThread::serialize(QDomDocument& doc, QDomNode& node)
    cartExramMemDataSect = doc.createCDATASection(cartMem);
    cartExramMemElement.appendChild(cartExramMemDataSect);
 
+   // Go back to showing the debuggers' snapshot.
+   nesAcquireDebuggerSnapshot();
+
    return true;
 }
 
@@ -914,6 +1002,7 @@ bool NESEmulatorThread::deserialize(QDomDocument& doc, QDomNode& /*node*/, QStri
    }
    while (!(child = child.nextSibling()).isNull());
 
+   nesPublishDebuggerSnapshot();
    emit updateDebuggers();
 
    return true;
@@ -10,6 +10,10 @@
 
 #include "ccartridge.h"
 
+// Rewind history kept so the debugger can step back frame by frame.
+#define REWIND_ARENA_SIZE ( 32*1024*1024 )
+#define REWIND_INTERVAL   1
+
 class NESEmulatorThread : public QThread, public IXMLSerializable
 {
    Q_OBJECT
@@ -41,6 +45,7 @@ public slots:
    void stepOutCPUEmulation ();
    void stepPPUEmulation ();
    void advanceFrame ();
+   void stepBackFrame ();
    void adjustAudio ( int32_t bufferDepth );
    void controllerInput ( uint32_t* joy )
    {
@@ -49,6 +54,10 @@ public slots:
    }
 
    void _breakpointHook();
+
+private slots:
+   void acquireDebuggerSnapshot ();
+
 signals:
    void breakpoint ();
    void emulatedFrame ();
@@ -74,6 +83,7 @@ protected:
    bool          m_isResetting;
    bool          m_isSoftReset;
    bool          m_isStarting;
+   bool          m_isSteppingBack;
    int           m_debugFrame;
    uint32_t      m_joy [ NUM_CONTROLLERS ];
 };
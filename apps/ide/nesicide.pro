@@ -254,6 +254,7 @@ INCLUDEPATH += \
    resources \
 
 SOURCES += \
+   $$TOP/common/cbreakpointexpression.cpp \
    $$TOP/common/cbreakpointinfo.cpp \
    $$TOP/common/xmlhelpers.cpp \
    aboutdialog.cpp \
@@ -277,11 +278,13 @@ SOURCES += \
    common/sourcenavigator.cpp \
    nes/common/tilificationthread.cpp \
    compilers/cc65/ccc65interface.cpp \
+   compilers/cc65/ccc65debuginfo.cpp \
    compilers/cc65/dbginfo.c \
    nes/compilers/ccartridgebuilder.cpp \
    nes/compilers/cgraphicsassembler.cpp \
    compilers/compilerthread.cpp \
    compilers/csourceassembler.cpp \
+   compilers/cbuildcache.cpp \
    nes/debuggers/apuinformationdockwidget.cpp \
    debuggers/breakpointdialog.cpp \
    debuggers/breakpointdockwidget.cpp \
@@ -402,6 +405,7 @@ SOURCES += \
 
 HEADERS += \
    aboutdialog.h \
+   $$TOP/common/cbreakpointexpression.h \
    $$TOP/common/cbreakpointinfo.h \
    common/cbuildertextlogger.h \
    common/cdesignercommon.h \
@@ -430,6 +434,7 @@ HEADERS += \
    nes/compilers/cgraphicsassembler.h \
    compilers/compilerthread.h \
    compilers/csourceassembler.h \
+   compilers/cbuildcache.h \
    nes/debuggers/apuinformationdockwidget.h \
    debuggers/breakpointdialog.h \
    debuggers/breakpointdockwidget.h \
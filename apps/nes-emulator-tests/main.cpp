@@ -0,0 +1,47 @@
+#include "testcommon.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+   const char* name;
+   int (*func)(int argc,char* argv[]);
+   const char* description;
+} TestInfo;
+
+static TestInfo tests [] =
+{
+   { "contexts", testContexts, "Runs ROMs in separate contexts at once and checks they match serial runs." },
+   { "breakpoints", testBreakpoints, "Measures frames/s with 0, 10 and 100 breakpoints set." },
+   { "startup", testStartup, "Measures the time and memory taken to create contexts and load a ROM." },
+   { "bus", testBus, "Measures the time taken by a CPU bus read on each cartridge." },
+   { "render", testRender, "Measures frames/s drawing the screen with and without the debugger." },
+   { "tracer", testTracer, "Fills, wraps and filters an execution tracer capture file and reads it back." },
+};
+
+#define NUM_TESTS (sizeof(tests)/sizeof(tests[0]))
+
+int main(int argc, char* argv[])
+{
+   uint32_t test;
+
+   if ( argc >= 2 )
+   {
+      for ( test = 0; test < NUM_TESTS; test++ )
+      {
+         if ( !strcmp(argv[1],tests[test].name) )
+         {
+            return tests[test].func(argc-2,argv+2);
+         }
+      }
+   }
+
+   printf("usage: nes-emulator-tests <test> [options]\n\n");
+   for ( test = 0; test < NUM_TESTS; test++ )
+   {
+      printf("   %-12s %s\n",tests[test].name,tests[test].description);
+   }
+
+   return 1;
+}
@@ -0,0 +1,65 @@
+#-------------------------------------------------
+#
+# Tests and benchmarks for the NES emulator core.
+#
+#-------------------------------------------------
+
+# Remove Qt libraries
+QT =
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TOP = ../..
+
+macx {
+    QMAKE_MAC_SDK = macosx10.14
+}
+
+CONFIG(release, debug|release) {
+   DESTDIR = release
+} else {
+   DESTDIR = debug
+}
+
+# Remove crap we do not need!
+CONFIG -= rtti exceptions
+
+OBJECTS_DIR = $$DESTDIR
+MOC_DIR = $$DESTDIR
+RCC_DIR = $$DESTDIR
+UI_DIR = $$DESTDIR
+
+TARGET = "nes-emulator-tests"
+
+TEMPLATE = app
+
+NESICIDE_CXXFLAGS = -I$$TOP/libs/nes -I$$TOP/libs/nes/common -I$$TOP/libs/nes/emulator
+NESICIDE_LIBS = -L$$TOP/libs/nes/$$DESTDIR -lnes-emulator
+
+win32 {
+   QMAKE_LFLAGS += -static-libgcc
+}
+
+unix {
+   LIBS += -lpthread
+}
+
+QMAKE_CXXFLAGS += $$NESICIDE_CXXFLAGS
+LIBS += $$NESICIDE_LIBS
+
+INCLUDEPATH += \
+   $$TOP/common
+
+SOURCES += \
+   main.cpp \
+   testcommon.cpp \
+   testcontexts.cpp \
+   testbreakpoints.cpp \
+   teststartup.cpp \
+   testbus.cpp \
+   testrender.cpp \
+   testtracer.cpp
+
+HEADERS += \
+   testcommon.h
@@ -0,0 +1,136 @@
+#include "testcommon.h"
+
+#include "nes_emulator_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Measures how much the breakpoints the debugger checks on every CPU access
+// cost while the emulator runs.  The ROM is run without the debugger, then
+// with it and 0, 10 and 100 breakpoints that never fire: half on execution of
+// code the program never runs and half on writes to RAM it never touches, so
+// every one of them is looked at and none of them stops the run.
+//
+// breakpoints [-f frames] [rom.nes]
+//
+// With no ROM given the built-in test program is run on MMC3.
+int testBreakpoints ( int argc, char* argv[] )
+{
+   static const int32_t counts [] = { 0, 10, 100 };
+   TestROMImage image;
+   const char* name = testROMName(eTestROM_MMC3);
+   int32_t frames = 600;
+   int32_t run;
+   int32_t bp;
+   int32_t addr;
+   uint64_t hash;
+   uint64_t baseHash = 0;
+   double start;
+   double seconds;
+   double baseSeconds = 0.0;
+   bool failed = false;
+   int arg;
+
+   for ( arg = 0; arg < argc; arg++ )
+   {
+      if ( !strcmp(argv[arg],"-f") && (arg+1 < argc) )
+      {
+         frames = atoi(argv[++arg]);
+      }
+      else
+      {
+         if ( !testReadROM(argv[arg],image) )
+         {
+            printf("cannot read %s\n",argv[arg]);
+            return 1;
+         }
+         name = argv[arg];
+      }
+   }
+   if ( image.empty() )
+   {
+      testBuildROM(eTestROM_MMC3,image);
+   }
+
+   printf("%s, %d frames\n",name,frames);
+
+   // Run -1 is the run without the debugger.
+   for ( run = -1; run < (int32_t)(sizeof(counts)/sizeof(counts[0])); run++ )
+   {
+      NESContext* pContext = nesCreateContext();
+
+      nesSetContext(pContext);
+      if ( run >= 0 )
+      {
+         nesEnableDebug();
+      }
+      if ( !testLoadROM(image) )
+      {
+         printf("cannot load %s\n",name);
+         nesSetContext(NULL);
+         nesDestroyContext(pContext);
+         return 1;
+      }
+      for ( bp = 0; (run >= 0) && (bp < counts[run]); bp++ )
+      {
+         if ( bp&1 )
+         {
+            addr = 0x0600+bp;
+            nesGetBreakpointDatabase()->AddBreakpoint(eBreakOnCPUMemoryWrite,
+                                                      eBreakpointItemAddress,
+                                                      0,
+                                                      addr,
+                                                      addr,
+                                                      addr,
+                                                      0xFFFF,
+                                                      false,
+                                                      eBreakpointConditionNone,
+                                                      0,
+                                                      eBreakpointDataNone,
+                                                      0,
+                                                      true);
+         }
+         else
+         {
+            addr = 0x8000+bp;
+            nesGetBreakpointDatabase()->AddBreakpoint(eBreakOnCPUExecution,
+                                                      eBreakpointItemAddress,
+                                                      0,
+                                                      addr,
+                                                      -1,
+                                                      addr,
+                                                      0xFFFF,
+                                                      false,
+                                                      eBreakpointConditionNone,
+                                                      0,
+                                                      eBreakpointDataNone,
+                                                      0,
+                                                      true);
+         }
+      }
+
+      start = testSeconds();
+      hash = testRunFrames(frames);
+      seconds = testSeconds()-start;
+
+      nesSetContext(NULL);
+      nesDestroyContext(pContext);
+
+      if ( run < 0 )
+      {
+         baseHash = hash;
+         baseSeconds = seconds;
+         printf("   no debugger      %8.1f frames/s\n",frames/seconds);
+      }
+      else
+      {
+         printf("   %3d breakpoints  %8.1f frames/s  %5.1f%% of no debugger%s\n",
+                counts[run],frames/seconds,100.0*baseSeconds/seconds,
+                (hash != baseHash) ? "  MISMATCH" : "");
+         failed |= (hash != baseHash);
+      }
+   }
+
+   return failed ? 1 : 0;
+}
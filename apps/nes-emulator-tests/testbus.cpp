@@ -0,0 +1,133 @@
+#include "testcommon.h"
+
+#include "nes_emulator_core.h"
+#include "cnes6502.h"
+#include "cnescontext.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+// The CPU core's bus read is protected; the benchmark reaches it the way a
+// derived class would.
+class TestCPU : public C6502
+{
+public:
+   using C6502::LOAD;
+};
+
+// Measures the cost of a CPU bus read through the page tables on each
+// cartridge.  The accesses follow the mix the CPU makes running code from
+// ROM: mostly sequential opcode and operand fetches from PRG-ROM with some
+// RAM and SRAM in between.  The best of five passes is reported.
+//
+// bus [-n accesses] [rom.nes ...]
+//
+// With no ROMs given the built-in test program is run on each cartridge.
+int testBus ( int argc, char* argv[] )
+{
+   std::vector<TestROMImage> images;
+   std::vector<std::string> names;
+   int32_t accesses = 20000000;
+   int32_t access;
+   int32_t pass;
+   uint32_t rom;
+   uint32_t addr;
+   uint32_t pc;
+   uint32_t sum = 0;
+   int8_t target;
+   double start;
+   double seconds;
+   double best;
+   bool failed = false;
+   int arg;
+
+   for ( arg = 0; arg < argc; arg++ )
+   {
+      if ( !strcmp(argv[arg],"-n") && (arg+1 < argc) )
+      {
+         accesses = atoi(argv[++arg]);
+      }
+      else
+      {
+         images.push_back(TestROMImage());
+         if ( !testReadROM(argv[arg],images.back()) )
+         {
+            printf("cannot read %s\n",argv[arg]);
+            return 1;
+         }
+         names.push_back(argv[arg]);
+      }
+   }
+   if ( images.empty() )
+   {
+      for ( rom = 0; rom < eTestROM_MAX; rom++ )
+      {
+         images.push_back(TestROMImage());
+         testBuildROM(rom,images.back());
+         names.push_back(testROMName(rom));
+      }
+   }
+   if ( accesses < 1 )
+   {
+      accesses = 1;
+   }
+
+   for ( rom = 0; rom < images.size(); rom++ )
+   {
+      NESContext* pContext = nesCreateContext();
+
+      nesSetContext(pContext);
+      if ( testLoadROM(images[rom]) )
+      {
+         // Let the program set up its banks first.
+         testRunFrames(3);
+
+         best = 0.0;
+         for ( pass = 0; pass < 5; pass++ )
+         {
+            pc = 0x8000;
+            start = testSeconds();
+            for ( access = 0; access < accesses; access++ )
+            {
+               if ( (access&31) < 26 )
+               {
+                  addr = 0x8000|(pc&0x7FFF);
+                  pc++;
+               }
+               else if ( (access&31) < 30 )
+               {
+                  addr = (access*7)&0x7FF;
+               }
+               else
+               {
+                  addr = 0x6000|((access*13)&0x1FFF);
+               }
+               sum += TestCPU::LOAD(addr,&target);
+            }
+            seconds = testSeconds()-start;
+            if ( (pass == 0) || (seconds < best) )
+            {
+               best = seconds;
+            }
+         }
+         printf("%-20s %6.2f ns/access\n",names[rom].c_str(),1000000000.0*best/accesses);
+      }
+      else
+      {
+         printf("%-20s cannot load\n",names[rom].c_str());
+         failed = true;
+      }
+      nesSetContext(NULL);
+      nesDestroyContext(pContext);
+   }
+
+   // Keep the reads from being optimized away.
+   if ( sum == 0xFFFFFFFF )
+   {
+      printf("\n");
+   }
+
+   return failed ? 1 : 0;
+}
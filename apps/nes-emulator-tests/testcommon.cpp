@@ -0,0 +1,489 @@
+#include "testcommon.h"
+
+#include "nes_emulator_core.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+// Where the built-in test program calls its cartridge's bank switching code.
+#define TEST_MAPPER_INIT 0xFF00
+#define TEST_MAPPER_NMI  0xFF40
+#define TEST_MAPPER_IRQ  0xFF80
+
+#define TEST_RESET 0xC000
+#define TEST_NMI   0xC0B1
+#define TEST_IRQ   0xC0EC
+
+#define FLAG_MIRROR_VERT     0x01
+#define FLAG_TRAINER         0x04
+#define FLAG_FOURSCREEN_VRAM 0x08
+
+// The built-in test program, assembled at $C000 in the last 16KB bank.
+static const uint8_t testProgram [] =
+{
+   // reset:
+   0x78,                // C000 SEI
+   0xD8,                // C001 CLD
+   0xA2, 0xFF,          // C002 LDX #$FF
+   0x9A,                // C004 TXS
+   0xA9, 0x00,          // C005 LDA #$00
+   0x8D, 0x00, 0x20,    // C007 STA $2000
+   0x8D, 0x01, 0x20,    // C00A STA $2001
+   // vw1:
+   0x2C, 0x02, 0x20,    // C00D BIT $2002
+   0x10, 0xFB,          // C010 BPL vw1
+   // vw2:
+   0x2C, 0x02, 0x20,    // C012 BIT $2002
+   0x10, 0xFB,          // C015 BPL vw2
+   0xA2, 0x00,          // C017 LDX #$00
+   // spr:
+   0x8A,                // C019 TXA
+   0x0A,                // C01A ASL A
+   0x0A,                // C01B ASL A
+   0x9D, 0x00, 0x02,    // C01C STA $0200,x
+   0xE8,                // C01F INX
+   0xD0, 0xF7,          // C020 BNE spr
+   0xA9, 0x3F,          // C022 LDA #$3F
+   0x8D, 0x06, 0x20,    // C024 STA $2006
+   0xA9, 0x00,          // C027 LDA #$00
+   0x8D, 0x06, 0x20,    // C029 STA $2006
+   0xA2, 0x00,          // C02C LDX #$00
+   // pal:
+   0x8A,                // C02E TXA
+   0x49, 0x15,          // C02F EOR #$15
+   0x29, 0x3F,          // C031 AND #$3F
+   0x8D, 0x07, 0x20,    // C033 STA $2007
+   0xE8,                // C036 INX
+   0xE0, 0x20,          // C037 CPX #$20
+   0xD0, 0xF3,          // C039 BNE pal
+   0xA9, 0x20,          // C03B LDA #$20
+   0x8D, 0x06, 0x20,    // C03D STA $2006
+   0xA9, 0x00,          // C040 LDA #$00
+   0x8D, 0x06, 0x20,    // C042 STA $2006
+   0xA0, 0x08,          // C045 LDY #$08
+   0xA2, 0x00,          // C047 LDX #$00
+   // nt:
+   0x8A,                // C049 TXA
+   0x65, 0x10,          // C04A ADC $10
+   0x8D, 0x07, 0x20,    // C04C STA $2007
+   0xE8,                // C04F INX
+   0xD0, 0xF7,          // C050 BNE nt
+   0xE6, 0x10,          // C052 INC $10
+   0x88,                // C054 DEY
+   0xD0, 0xF2,          // C055 BNE nt
+   0xA9, 0x0F,          // C057 LDA #$0F
+   0x8D, 0x15, 0x40,    // C059 STA $4015
+   0xA9, 0xBF,          // C05C LDA #$BF
+   0x8D, 0x00, 0x40,    // C05E STA $4000
+   0xA9, 0x08,          // C061 LDA #$08
+   0x8D, 0x01, 0x40,    // C063 STA $4001
+   0xA9, 0x81,          // C066 LDA #$81
+   0x8D, 0x08, 0x40,    // C068 STA $4008
+   0xA9, 0x3C,          // C06B LDA #$3C
+   0x8D, 0x0C, 0x40,    // C06D STA $400C
+   0xA9, 0x05,          // C070 LDA #$05
+   0x8D, 0x0E, 0x40,    // C072 STA $400E
+   0xA9, 0x08,          // C075 LDA #$08
+   0x8D, 0x0F, 0x40,    // C077 STA $400F
+   0xA9, 0x40,          // C07A LDA #$40
+   0x8D, 0x17, 0x40,    // C07C STA $4017
+   0x20, 0x00, 0xFF,    // C07F JSR $FF00
+   0xA9, 0x90,          // C082 LDA #$90
+   0x8D, 0x00, 0x20,    // C084 STA $2000
+   0xA9, 0x1E,          // C087 LDA #$1E
+   0x8D, 0x01, 0x20,    // C089 STA $2001
+   0x58,                // C08C CLI
+   // main:
+   0xA5, 0x20,          // C08D LDA $20
+   0x0A,                // C08F ASL A
+   0x26, 0x21,          // C090 ROL $21
+   0x45, 0x21,          // C092 EOR $21
+   0x69, 0x37,          // C094 ADC #$37
+   0x85, 0x20,          // C096 STA $20
+   0x66, 0x22,          // C098 ROR $22
+   0xA4, 0x20,          // C09A LDY $20
+   0xB1, 0x20,          // C09C LDA ($20),y
+   0x99, 0x00, 0x03,    // C09E STA $0300,y
+   0xE6, 0x23,          // C0A1 INC $23
+   0xD0, 0xE8,          // C0A3 BNE main
+   0xE6, 0x24,          // C0A5 INC $24
+   0xA5, 0x24,          // C0A7 LDA $24
+   0x29, 0x03,          // C0A9 AND #$03
+   0x8D, 0x02, 0x40,    // C0AB STA $4002
+   0x4C, 0x8D, 0xC0,    // C0AE JMP main
+   // nmi:
+   0x48,                // C0B1 PHA
+   0x8A,                // C0B2 TXA
+   0x48,                // C0B3 PHA
+   0x98,                // C0B4 TYA
+   0x48,                // C0B5 PHA
+   0xA9, 0x02,          // C0B6 LDA #$02
+   0x8D, 0x14, 0x40,    // C0B8 STA $4014
+   0xE6, 0x30,          // C0BB INC $30
+   0xA5, 0x30,          // C0BD LDA $30
+   0x8D, 0x05, 0x20,    // C0BF STA $2005
+   0x4A,                // C0C2 LSR A
+   0x8D, 0x05, 0x20,    // C0C3 STA $2005
+   0xA5, 0x30,          // C0C6 LDA $30
+   0x29, 0x7F,          // C0C8 AND #$7F
+   0x09, 0x10,          // C0CA ORA #$10
+   0x8D, 0x02, 0x40,    // C0CC STA $4002
+   0xA9, 0x00,          // C0CF LDA #$00
+   0x8D, 0x03, 0x40,    // C0D1 STA $4003
+   0xA2, 0x00,          // C0D4 LDX #$00
+   // mv:
+   0xFE, 0x03, 0x02,    // C0D6 INC $0203,x
+   0x8A,                // C0D9 TXA
+   0x18,                // C0DA CLC
+   0x69, 0x04,          // C0DB ADC #$04
+   0xAA,                // C0DD TAX
+   0xD0, 0xF6,          // C0DE BNE mv
+   0x20, 0x40, 0xFF,    // C0E0 JSR $FF40
+   0xAD, 0x02, 0x20,    // C0E3 LDA $2002
+   0x68,                // C0E6 PLA
+   0xA8,                // C0E7 TAY
+   0x68,                // C0E8 PLA
+   0xAA,                // C0E9 TAX
+   0x68,                // C0EA PLA
+   0x40,                // C0EB RTI
+   // irq:
+   0x48,                // C0EC PHA
+   0x20, 0x80, 0xFF,    // C0ED JSR $FF80
+   0x68,                // C0F0 PLA
+   0x40,                // C0F1 RTI
+};
+
+// Bank switching code for each cartridge, called from the test program.
+static const uint8_t uxromInit [] =
+{
+   0xA9, 0x03,          // LDA #$03
+   0x8D, 0x00, 0x80,    // STA $8000
+   0x60,                // RTS
+};
+
+static const uint8_t uxromNMI [] =
+{
+   0xA5, 0x30,          // LDA $30
+   0x29, 0x07,          // AND #$07
+   0x8D, 0x00, 0x80,    // STA $8000
+   0x60,                // RTS
+};
+
+static const uint8_t mmc3Init [] =
+{
+   0xA9, 0x40,          // LDA #$40
+   0x8D, 0x00, 0xC0,    // STA $C000
+   0x8D, 0x01, 0xC0,    // STA $C001
+   0x8D, 0x01, 0xE0,    // STA $E001
+   0xA9, 0x06,          // LDA #$06
+   0x8D, 0x00, 0x80,    // STA $8000
+   0xA9, 0x02,          // LDA #$02
+   0x8D, 0x01, 0x80,    // STA $8001
+   0xA9, 0x02,          // LDA #$02
+   0x8D, 0x00, 0x80,    // STA $8000
+   0xA9, 0x05,          // LDA #$05
+   0x8D, 0x01, 0x80,    // STA $8001
+   0x60,                // RTS
+};
+
+static const uint8_t mmc3NMI [] =
+{
+   0xA9, 0x00,          // LDA #$00
+   0x8D, 0x00, 0xA0,    // STA $A000
+   0xA9, 0x20,          // LDA #$20
+   0x8D, 0x00, 0xC0,    // STA $C000
+   0x8D, 0x01, 0xC0,    // STA $C001
+   0x8D, 0x01, 0xE0,    // STA $E001
+   0x60,                // RTS
+};
+
+static const uint8_t mmc3IRQ [] =
+{
+   0x8D, 0x00, 0xE0,    // STA $E000
+   0xA5, 0x30,          // LDA $30
+   0x29, 0x07,          // AND #$07
+   0x09, 0x04,          // ORA #$04
+   0x8D, 0x01, 0x80,    // STA $8001
+   0xA9, 0x30,          // LDA #$30
+   0x8D, 0x00, 0xC0,    // STA $C000
+   0x8D, 0x01, 0xE0,    // STA $E001
+   0xA5, 0x31,          // LDA $31
+   0x18,                // CLC
+   0x69, 0x01,          // ADC #$01
+   0x85, 0x31,          // STA $31
+   0x8D, 0x05, 0x20,    // STA $2005
+   0x8D, 0x05, 0x20,    // STA $2005
+   0x60,                // RTS
+};
+
+static uint64_t testHash ( const void* data, uint32_t size, uint64_t hash )
+{
+   const uint8_t* bytes = (const uint8_t*)data;
+   uint32_t idx;
+
+   // FNV-1a.
+   for ( idx = 0; idx < size; idx++ )
+   {
+      hash ^= bytes[idx];
+      hash *= 1099511628211ULL;
+   }
+   return hash;
+}
+
+#define TEST_HASH_START 14695981039346656037ULL
+
+// Audio of the context being run on each thread.
+static thread_local uint64_t testAudioHash;
+
+static void testAudioHook ( void )
+{
+   while ( nesGetAudioSamplesAvailable() >= 512 )
+   {
+      testAudioHash = testHash(nesGetAudioSamples(512),512*sizeof(uint16_t),testAudioHash);
+   }
+}
+
+const char* testROMName ( int32_t rom )
+{
+   static const char* names [] =
+   {
+      "NROM",
+      "UxROM",
+      "MMC3"
+   };
+
+   return names[rom];
+}
+
+void testBuildROM ( int32_t rom, TestROMImage& image )
+{
+   const uint8_t* init = NULL;
+   const uint8_t* nmi = NULL;
+   const uint8_t* irq = NULL;
+   uint32_t initSize = 0;
+   uint32_t nmiSize = 0;
+   uint32_t irqSize = 0;
+   uint32_t numPrgBanks;
+   uint32_t numChrBanks;
+   uint32_t mapper;
+   uint32_t bank;
+   uint32_t idx;
+   uint8_t* pBank;
+
+   switch ( rom )
+   {
+   case eTestROM_NROM:
+      mapper = 0;
+      numPrgBanks = 1;
+      numChrBanks = 1;
+      break;
+   case eTestROM_UxROM:
+      mapper = 2;
+      numPrgBanks = 8;
+      numChrBanks = 0;
+      init = uxromInit;
+      initSize = sizeof(uxromInit);
+      nmi = uxromNMI;
+      nmiSize = sizeof(uxromNMI);
+      break;
+   default:
+      mapper = 4;
+      numPrgBanks = 8;
+      numChrBanks = 4;
+      init = mmc3Init;
+      initSize = sizeof(mmc3Init);
+      nmi = mmc3NMI;
+      nmiSize = sizeof(mmc3NMI);
+      irq = mmc3IRQ;
+      irqSize = sizeof(mmc3IRQ);
+      break;
+   }
+
+   image.assign(16+(numPrgBanks*MEM_16KB)+(numChrBanks*MEM_8KB),0xFF);
+
+   memcpy(image.data(),"NES\x1a",4);
+   image[4] = numPrgBanks;
+   image[5] = numChrBanks;
+   image[6] = ((mapper&0x0F)<<4)|FLAG_MIRROR_VERT;
+   image[7] = mapper&0xF0;
+   memset(image.data()+8,0,8);
+
+   // Fill the banks the program doesn't run from with something to switch
+   // in and look at.
+   for ( bank = 0; bank < numPrgBanks-1; bank++ )
+   {
+      pBank = image.data()+16+(bank*MEM_16KB);
+      for ( idx = 0; idx < MEM_16KB; idx++ )
+      {
+         pBank[idx] = (idx*7)+(bank*13);
+      }
+   }
+   for ( bank = 0; bank < numChrBanks; bank++ )
+   {
+      pBank = image.data()+16+(numPrgBanks*MEM_16KB)+(bank*MEM_8KB);
+      for ( idx = 0; idx < MEM_8KB; idx++ )
+      {
+         pBank[idx] = (idx*31)^(idx>>3)^(bank*77);
+      }
+   }
+
+   // The program and its bank switching code go in the last bank, which
+   // every one of the cartridges leaves at $C000-$FFFF.
+   pBank = image.data()+16+((numPrgBanks-1)*MEM_16KB);
+   memcpy(pBank,testProgram,sizeof(testProgram));
+   pBank[TEST_MAPPER_INIT-0xC000] = 0x60; // RTS
+   pBank[TEST_MAPPER_NMI-0xC000] = 0x60;
+   pBank[TEST_MAPPER_IRQ-0xC000] = 0x60;
+   if ( init )
+   {
+      memcpy(pBank+TEST_MAPPER_INIT-0xC000,init,initSize);
+   }
+   if ( nmi )
+   {
+      memcpy(pBank+TEST_MAPPER_NMI-0xC000,nmi,nmiSize);
+   }
+   if ( irq )
+   {
+      memcpy(pBank+TEST_MAPPER_IRQ-0xC000,irq,irqSize);
+   }
+
+   // Vectors, copied into every bank so whichever is switched in has them.
+   for ( bank = 0; bank < numPrgBanks; bank++ )
+   {
+      pBank = image.data()+16+(bank*MEM_16KB)+MEM_16KB-6;
+      pBank[0] = TEST_NMI&0xFF;
+      pBank[1] = TEST_NMI>>8;
+      pBank[2] = TEST_RESET&0xFF;
+      pBank[3] = TEST_RESET>>8;
+      pBank[4] = TEST_IRQ&0xFF;
+      pBank[5] = TEST_IRQ>>8;
+   }
+}
+
+bool testReadROM ( const char* fileName, TestROMImage& image )
+{
+   FILE* file = fopen(fileName,"rb");
+   long  size;
+
+   if ( !file )
+   {
+      return false;
+   }
+
+   fseek(file,0,SEEK_END);
+   size = ftell(file);
+   fseek(file,0,SEEK_SET);
+
+   image.resize(size);
+   size = fread(image.data(),1,size,file);
+   image.resize(size);
+
+   fclose(file);
+
+   return true;
+}
+
+bool testLoadROM ( const TestROMImage& image )
+{
+   uint32_t numPrgRomBanks;
+   uint32_t numChrRomBanks;
+   uint8_t  romCB1;
+   uint8_t  romCB2;
+   uint32_t offset;
+   uint32_t bank;
+
+   if ( (image.size() < 16) || memcmp(image.data(),"NES\x1a",4) )
+   {
+      return false;
+   }
+
+   // Same header handling as the test runner's.
+   numPrgRomBanks = image[4]<<1;
+   numChrRomBanks = image[5];
+   romCB1 = image[6];
+   romCB2 = image[7];
+   if ( romCB2&0x0F )
+   {
+      romCB2 = 0x00;
+   }
+
+   offset = 16;
+   if ( romCB1&FLAG_TRAINER )
+   {
+      offset += 512;
+   }
+
+   if ( image.size() < offset+((numPrgRomBanks+numChrRomBanks)*MEM_8KB) )
+   {
+      return false;
+   }
+
+   nesUnloadROM();
+
+   for ( bank = 0; bank < numPrgRomBanks; bank++ )
+   {
+      nesLoadPRGROMBank(bank,(uint8_t*)image.data()+offset);
+      offset += MEM_8KB;
+   }
+   for ( bank = 0; bank < numChrRomBanks; bank++ )
+   {
+      nesLoadCHRROMBank(bank,(uint8_t*)image.data()+offset);
+      offset += MEM_8KB;
+   }
+
+   nesLoadROM();
+
+   if ( romCB1&FLAG_MIRROR_VERT )
+   {
+      nesSetVerticalMirroring();
+   }
+   else
+   {
+      nesSetHorizontalMirroring();
+   }
+   if ( romCB1&FLAG_FOURSCREEN_VRAM )
+   {
+      nesSetFourScreen();
+   }
+
+   nesSetSystemMode(MODE_NTSC);
+   nesResetInitial(((romCB1>>4)&0x0F)|(romCB2&0xF0));
+
+   return true;
+}
+
+uint64_t testRunFrames ( int32_t frames )
+{
+   std::vector<int8_t> tv ( 256*256*4, 0 );
+   NESCpuStateSnapshot cpu;
+   uint32_t joy [ 2 ];
+   uint64_t hash = TEST_HASH_START;
+   int32_t  frame;
+
+   testAudioHash = TEST_HASH_START;
+
+   nesSetTVOut(tv.data());
+   nesSetAudioHook(testAudioHook);
+
+   for ( frame = 0; frame < frames; frame++ )
+   {
+      joy[0] = (frame*37)&0xFF;
+      joy[1] = 0;
+      nesRun(joy);
+      hash = testHash(tv.data(),tv.size(),hash);
+   }
+
+   nesGetCpuSnapshot(&cpu);
+   hash = testHash(cpu.memory,sizeof(cpu.memory),hash);
+
+   nesSetAudioHook(NULL);
+   nesSetTVOut(NULL);
+
+   return hash^(testAudioHash*3);
+}
+
+double testSeconds ( void )
+{
+   return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
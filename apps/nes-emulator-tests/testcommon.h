@@ -0,0 +1,50 @@
+#ifndef TESTCOMMON_H
+#define TESTCOMMON_H
+
+#include <stdint.h>
+#include <vector>
+
+// Cartridges the built-in test program is built for.  The program turns on
+// rendering with sprites, scrolls, plays the APU channels and switches banks
+// from its NMI and, on MMC3, scanline IRQ handlers, so every part of the NES
+// has some work to do each frame.
+enum
+{
+   eTestROM_NROM = 0,
+   eTestROM_UxROM,
+   eTestROM_MMC3,
+   eTestROM_MAX
+};
+
+typedef std::vector<uint8_t> TestROMImage;
+
+const char* testROMName ( int32_t rom );
+
+// Builds an iNES image of the built-in test program for the given cartridge.
+void testBuildROM ( int32_t rom, TestROMImage& image );
+
+// Reads an iNES image from a file.
+bool testReadROM ( const char* fileName, TestROMImage& image );
+
+// Loads an iNES image into the context bound to the calling thread and
+// resets it, as the IDE does when a cartridge is loaded.
+bool testLoadROM ( const TestROMImage& image );
+
+// Runs frames of the ROM loaded into the context bound to the calling thread
+// with a fixed pattern of joypad input, and returns a hash of every frame's
+// picture, the audio and the CPU RAM at the end.
+uint64_t testRunFrames ( int32_t frames );
+
+// Seconds on a monotonic clock.
+double testSeconds ( void );
+
+// The tests and benchmarks, by the name given on the command line.  Each
+// returns the program's exit code.
+int testContexts ( int argc, char* argv[] );
+int testBreakpoints ( int argc, char* argv[] );
+int testStartup ( int argc, char* argv[] );
+int testBus ( int argc, char* argv[] );
+int testRender ( int argc, char* argv[] );
+int testTracer ( int argc, char* argv[] );
+
+#endif // TESTCOMMON_H
@@ -0,0 +1,143 @@
+#include "testcommon.h"
+
+#include "nes_emulator_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+
+// Runs every ROM in its own context, first one after another on this thread
+// and then all at once, each on its own thread, and checks the runs come out
+// the same.  Any state still shared between contexts shows up as a
+// difference.
+//
+// contexts [-f frames] [-c copies] [-d] [rom.nes ...]
+//
+// With no ROMs given the built-in test program is run on each cartridge.
+// -c runs that many copies of each ROM at once, -d turns on the debugger
+// support (tracer, code/data logger, breakpoints).
+int testContexts ( int argc, char* argv[] )
+{
+   std::vector<TestROMImage> images;
+   std::vector<std::string> names;
+   std::vector<uint64_t> serial;
+   std::vector<uint64_t> parallel;
+   std::vector<std::thread> threads;
+   int32_t frames = 300;
+   int32_t copies = 2;
+   bool debug = false;
+   bool failed = false;
+   uint32_t rom;
+   uint32_t run;
+   double start;
+   double serialTime;
+   double parallelTime;
+   int arg;
+
+   for ( arg = 0; arg < argc; arg++ )
+   {
+      if ( !strcmp(argv[arg],"-f") && (arg+1 < argc) )
+      {
+         frames = atoi(argv[++arg]);
+      }
+      else if ( !strcmp(argv[arg],"-c") && (arg+1 < argc) )
+      {
+         copies = atoi(argv[++arg]);
+      }
+      else if ( !strcmp(argv[arg],"-d") )
+      {
+         debug = true;
+      }
+      else
+      {
+         images.push_back(TestROMImage());
+         if ( !testReadROM(argv[arg],images.back()) )
+         {
+            printf("cannot read %s\n",argv[arg]);
+            return 1;
+         }
+         names.push_back(argv[arg]);
+      }
+   }
+   if ( images.empty() )
+   {
+      for ( rom = 0; rom < eTestROM_MAX; rom++ )
+      {
+         images.push_back(TestROMImage());
+         testBuildROM(rom,images.back());
+         names.push_back(testROMName(rom));
+      }
+   }
+
+   // Each run makes a context, binds it, and leaves this thread bound to
+   // the default one again when it's done with it.
+   auto runContext = [&]( uint32_t image, uint64_t* pHash )
+   {
+      NESContext* pContext = nesCreateContext();
+
+      nesSetContext(pContext);
+      if ( debug )
+      {
+         nesEnableDebug();
+      }
+      if ( testLoadROM(images[image]) )
+      {
+         *pHash = testRunFrames(frames);
+      }
+      else
+      {
+         *pHash = 0;
+      }
+      nesSetContext(NULL);
+      nesDestroyContext(pContext);
+   };
+
+   serial.resize(images.size());
+   start = testSeconds();
+   for ( rom = 0; rom < images.size(); rom++ )
+   {
+      runContext(rom,&serial[rom]);
+   }
+   serialTime = testSeconds()-start;
+
+   parallel.resize(images.size()*copies);
+   start = testSeconds();
+   for ( run = 0; run < parallel.size(); run++ )
+   {
+      threads.push_back(std::thread(runContext,run%images.size(),&parallel[run]));
+   }
+   for ( run = 0; run < threads.size(); run++ )
+   {
+      threads[run].join();
+   }
+   parallelTime = testSeconds()-start;
+
+   for ( run = 0; run < parallel.size(); run++ )
+   {
+      rom = run%images.size();
+      if ( !serial[rom] )
+      {
+         printf("%-20s cannot load\n",names[rom].c_str());
+         failed = true;
+      }
+      else if ( parallel[run] != serial[rom] )
+      {
+         printf("%-20s copy %u: %016llx, serial %016llx  MISMATCH\n",
+                names[rom].c_str(),run/(uint32_t)images.size(),
+                (unsigned long long)parallel[run],(unsigned long long)serial[rom]);
+         failed = true;
+      }
+      else
+      {
+         printf("%-20s copy %u: %016llx  ok\n",
+                names[rom].c_str(),run/(uint32_t)images.size(),(unsigned long long)parallel[run]);
+      }
+   }
+
+   printf("%u ROMs x %d frames: serial %.2fs, %u at once %.2fs\n",
+          (uint32_t)images.size(),frames,serialTime,(uint32_t)parallel.size(),parallelTime);
+
+   return failed ? 1 : 0;
+}
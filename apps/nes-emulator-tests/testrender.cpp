@@ -0,0 +1,136 @@
+#include "testcommon.h"
+
+#include "nes_emulator_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+// Runs frames as fast as possible and returns the best frames/s of three
+// passes, leaving the last frame drawn in tv.
+static double renderFrames ( int32_t frames, std::vector<int8_t>& tv )
+{
+   uint32_t joy [ 2 ] = { 0, 0 };
+   int32_t pass;
+   int32_t frame;
+   double start;
+   double seconds;
+   double best = 0.0;
+
+   nesSetTVOut(tv.data());
+   for ( pass = 0; pass < 3; pass++ )
+   {
+      start = testSeconds();
+      for ( frame = 0; frame < frames; frame++ )
+      {
+         nesRun(joy);
+      }
+      seconds = testSeconds()-start;
+      if ( (pass == 0) || (seconds < best) )
+      {
+         best = seconds;
+      }
+   }
+   nesSetTVOut(NULL);
+
+   return frames/best;
+}
+
+// Measures frames/s with the screen being drawn, without the debugger,
+// where each scanline's pixels are drawn in runs, and with it, where a
+// pixel is drawn per PPU cycle along with the rest of the debugger's
+// bookkeeping.  The two runs must leave the same picture on the screen.
+// Audio isn't collected; the APU drops the samples nobody reads.
+//
+// render [-f frames] [rom.nes ...]
+//
+// With no ROMs given the built-in test program is run on each cartridge.
+int testRender ( int argc, char* argv[] )
+{
+   std::vector<TestROMImage> images;
+   std::vector<std::string> names;
+   std::vector<int8_t> tv ( 256*256*4, 0 );
+   std::vector<int8_t> debugTV ( 256*256*4, 0 );
+   int32_t frames = 600;
+   uint32_t rom;
+   int32_t debug;
+   double fps [ 2 ];
+   bool loaded;
+   bool failed = false;
+   int arg;
+
+   for ( arg = 0; arg < argc; arg++ )
+   {
+      if ( !strcmp(argv[arg],"-f") && (arg+1 < argc) )
+      {
+         frames = atoi(argv[++arg]);
+      }
+      else
+      {
+         images.push_back(TestROMImage());
+         if ( !testReadROM(argv[arg],images.back()) )
+         {
+            printf("cannot read %s\n",argv[arg]);
+            return 1;
+         }
+         names.push_back(argv[arg]);
+      }
+   }
+   if ( images.empty() )
+   {
+      for ( rom = 0; rom < eTestROM_MAX; rom++ )
+      {
+         images.push_back(TestROMImage());
+         testBuildROM(rom,images.back());
+         names.push_back(testROMName(rom));
+      }
+   }
+   if ( frames < 1 )
+   {
+      frames = 1;
+   }
+
+   printf("%d frames, best of 3\n",frames);
+   printf("%-20s %10s %10s\n","","no debug","debug");
+
+   for ( rom = 0; rom < images.size(); rom++ )
+   {
+      loaded = true;
+      for ( debug = 0; debug < 2; debug++ )
+      {
+         NESContext* pContext = nesCreateContext();
+
+         nesSetContext(pContext);
+         if ( debug )
+         {
+            nesEnableDebug();
+         }
+         loaded &= testLoadROM(images[rom]);
+         if ( loaded )
+         {
+            fps[debug] = renderFrames(frames,debug?debugTV:tv);
+         }
+         nesSetContext(NULL);
+         nesDestroyContext(pContext);
+      }
+
+      if ( !loaded )
+      {
+         printf("%-20s cannot load\n",names[rom].c_str());
+         failed = true;
+      }
+      else if ( tv != debugTV )
+      {
+         printf("%-20s pictures differ\n",names[rom].c_str());
+         failed = true;
+      }
+      else
+      {
+         printf("%-20s %6.0f f/s %6.0f f/s %7.2fx\n",
+                names[rom].c_str(),fps[0],fps[1],fps[0]/fps[1]);
+      }
+   }
+
+   return failed ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+#include "testcommon.h"
+
+#include "nes_emulator_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#if defined ( __linux__ )
+#include <unistd.h>
+#endif
+
+// Resident memory of this process in bytes, or 0 where it can't be read.
+static uint64_t residentBytes ( void )
+{
+   uint64_t bytes = 0;
+#if defined ( __linux__ )
+   unsigned long long size;
+   unsigned long long resident;
+   FILE* statm = fopen("/proc/self/statm","r");
+
+   if ( statm )
+   {
+      if ( fscanf(statm,"%llu %llu",&size,&resident) == 2 )
+      {
+         bytes = resident*sysconf(_SC_PAGESIZE);
+      }
+      fclose(statm);
+   }
+#endif
+   return bytes;
+}
+
+// Measures what it costs to bring up an emulator: the time and resident
+// memory taken to create contexts, and to load a ROM into one with the
+// debugger on and reset it, which is when the PRG-ROM debug tables (code/data
+// logger, opcode masks, source line tables) are made for the banks the ROM
+// uses.
+//
+// startup [-c contexts] [rom.nes]
+//
+// With no ROM given the built-in test program is loaded on NROM.
+int testStartup ( int argc, char* argv[] )
+{
+   std::vector<NESContext*> contexts;
+   TestROMImage image;
+   const char* name = testROMName(eTestROM_NROM);
+   int32_t count = 4;
+   int32_t context;
+   uint64_t resident;
+   double start;
+   double seconds;
+   bool loaded;
+   int arg;
+
+   for ( arg = 0; arg < argc; arg++ )
+   {
+      if ( !strcmp(argv[arg],"-c") && (arg+1 < argc) )
+      {
+         count = atoi(argv[++arg]);
+      }
+      else
+      {
+         if ( !testReadROM(argv[arg],image) )
+         {
+            printf("cannot read %s\n",argv[arg]);
+            return 1;
+         }
+         name = argv[arg];
+      }
+   }
+   if ( image.empty() )
+   {
+      testBuildROM(eTestROM_NROM,image);
+   }
+   if ( count < 1 )
+   {
+      count = 1;
+   }
+
+   resident = residentBytes();
+   start = testSeconds();
+   for ( context = 0; context < count; context++ )
+   {
+      contexts.push_back(nesCreateContext());
+   }
+   seconds = testSeconds()-start;
+   printf("create %d contexts      %7.2f ms, %7.2f MB resident each\n",
+          count,1000.0*seconds/count,(residentBytes()-resident)/(1048576.0*count));
+
+   nesSetContext(contexts[0]);
+   nesEnableDebug();
+   resident = residentBytes();
+   start = testSeconds();
+   loaded = testLoadROM(image);
+   seconds = testSeconds()-start;
+   printf("load+reset ROM         %7.2f ms, %7.2f MB resident  (%s)\n",
+          1000.0*seconds,(residentBytes()-resident)/1048576.0,name);
+   nesSetContext(NULL);
+
+   for ( context = 0; context < count; context++ )
+   {
+      nesDestroyContext(contexts[context]);
+   }
+
+   if ( !loaded )
+   {
+      printf("cannot load %s\n",name);
+      return 1;
+   }
+
+   return 0;
+}
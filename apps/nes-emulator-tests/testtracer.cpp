@@ -0,0 +1,268 @@
+#include "testcommon.h"
+
+#include "nes_emulator_core.h"
+#include "ctracer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+// The sample the tracer is given as sample i of a capture.  Sources and
+// types alternate so both the CPU and PPU rings are used.
+static void makeSample ( uint32_t i, TracerInfo* pInfo )
+{
+   pInfo->frame = i/100;
+   pInfo->cycle = i*3;
+   pInfo->source = (i&1) ? eNESSource_PPU : eNESSource_CPU;
+   pInfo->type = (i&2) ? eTracer_DataWrite : eTracer_DataRead;
+   pInfo->target = eTarget_RAM;
+   pInfo->addr = (i*7)&0xFFFF;
+   pInfo->data = i&0xFF;
+}
+
+static uint32_t addSample ( CTracer& tracer, uint32_t i )
+{
+   TracerInfo info;
+
+   makeSample(i,&info);
+   tracer.SetFrame(info.frame);
+   return tracer.AddSample(info.cycle,info.type,info.source,info.target,info.addr,info.data);
+}
+
+// Checks that sample number sample reads back through GetRecord as sample i
+// of the capture.
+static bool checkRecord ( const CTracer& tracer, uint32_t sample, uint32_t i )
+{
+   TracerInfo expected;
+   TracerInfo info;
+
+   makeSample(i,&expected);
+   if ( !tracer.GetRecord(sample,&info) )
+   {
+      printf("   sample %u: not readable\n",sample);
+      return false;
+   }
+   if ( (info.frame != expected.frame) ||
+        (info.cycle != expected.cycle) ||
+        (info.source != expected.source) ||
+        (info.type != expected.type) ||
+        (info.target != expected.target) ||
+        (info.addr != expected.addr) ||
+        (info.data != expected.data) )
+   {
+      printf("   sample %u: read back cycle %u addr $%04X data $%02X, expected cycle %u addr $%04X data $%02X\n",
+             sample,info.cycle,info.addr,info.data,expected.cycle,expected.addr,expected.data);
+      return false;
+   }
+   return true;
+}
+
+// Checks the capture file was written with its header.
+static bool checkFile ( const char* fileName )
+{
+   char magic [ 8 ];
+   bool ok = false;
+   FILE* file = fopen(fileName,"rb");
+
+   if ( file )
+   {
+      ok = (fread(magic,1,8,file) == 8) && (!memcmp(magic,"NESTRACE",8));
+      fclose(file);
+   }
+   if ( !ok )
+   {
+      printf("   %s: no capture file header\n",fileName);
+   }
+   return ok;
+}
+
+// Captures into a file that stops when it's full.  The ring keeps one slot
+// free so a full capture holds depth-1 samples.
+static bool testFill ( CTracer& tracer, const char* fileName, uint32_t depth )
+{
+   uint32_t i;
+   uint32_t sample;
+   bool ok = true;
+
+   if ( !tracer.MapTracerFile(fileName,depth,false) )
+   {
+      printf("   cannot map %s\n",fileName);
+      return false;
+   }
+   depth = tracer.GetDepth();
+
+   for ( i = 0; i < 2*depth; i++ )
+   {
+      sample = addSample(tracer,i);
+      if ( (i < depth-1) ? (sample != i) : (sample != TRACER_NO_SAMPLE) )
+      {
+         printf("   sample %u: added as %u\n",i,sample);
+         ok = false;
+         break;
+      }
+   }
+   if ( !tracer.IsFull() || (tracer.GetNumSamples() != depth-1) )
+   {
+      printf("   %u samples, %s, expected %u samples, full\n",
+             tracer.GetNumSamples(),tracer.IsFull()?"full":"not full",depth-1);
+      ok = false;
+   }
+   for ( i = 0; ok && (i < depth-1); i++ )
+   {
+      ok = checkRecord(tracer,i,i);
+   }
+
+   tracer.UnmapTracerFile();
+
+   return ok && checkFile(fileName);
+}
+
+// Captures into a file that wraps, overwriting the oldest samples.  Only
+// the newest depth-1 samples can be read back.
+static bool testWrap ( CTracer& tracer, const char* fileName, uint32_t depth )
+{
+   TracerInfo info;
+   uint32_t count;
+   uint32_t row;
+   uint32_t i;
+   bool ok = true;
+
+   if ( !tracer.MapTracerFile(fileName,depth,true) )
+   {
+      printf("   cannot map %s\n",fileName);
+      return false;
+   }
+   depth = tracer.GetDepth();
+   count = 3*depth+5;
+
+   for ( i = 0; i < count; i++ )
+   {
+      addSample(tracer,i);
+   }
+   if ( tracer.IsFull() || (tracer.GetNumSamples() != depth-1) )
+   {
+      printf("   %u samples, %s, expected %u samples, not full\n",
+             tracer.GetNumSamples(),tracer.IsFull()?"full":"not full",depth-1);
+      ok = false;
+   }
+   for ( row = 0; ok && (row < depth-1); row++ )
+   {
+      ok = checkRecord(tracer,tracer.GetSample(row),count-1-row);
+   }
+   if ( ok && tracer.GetRecord(count-depth,&info) )
+   {
+      printf("   sample %u: readable after it was overwritten\n",count-depth);
+      ok = false;
+   }
+
+   tracer.UnmapTracerFile();
+
+   return ok && checkFile(fileName);
+}
+
+// Captures with a filter set and with the tracer disabled.
+static bool testFilter ( CTracer& tracer, const char* fileName, uint32_t depth )
+{
+   TracerInfo info;
+   uint32_t i;
+   uint32_t row;
+   uint32_t expected = 0;
+   bool ok = true;
+
+   if ( !tracer.MapTracerFile(fileName,depth,true) )
+   {
+      printf("   cannot map %s\n",fileName);
+      return false;
+   }
+
+   // CPU writes to $0000-$03FF only.
+   tracer.SetFilter(1<<eNESSource_CPU,TRACER_TYPE_BIT(eTracer_DataWrite),0x0000,0x03FF);
+   for ( i = 0; i < 1024; i++ )
+   {
+      makeSample(i,&info);
+      if ( (info.source == eNESSource_CPU) && (info.type == eTracer_DataWrite) && (info.addr <= 0x03FF) )
+      {
+         expected++;
+      }
+      addSample(tracer,i);
+   }
+   if ( tracer.GetNumSamples() != expected )
+   {
+      printf("   filtered: %u samples, expected %u\n",tracer.GetNumSamples(),expected);
+      ok = false;
+   }
+   for ( row = 0; ok && (row < tracer.GetNumSamples()); row++ )
+   {
+      if ( !tracer.GetRecord(tracer.GetSample(row),&info) ||
+           (info.source != eNESSource_CPU) ||
+           (info.type != eTracer_DataWrite) ||
+           (info.addr > 0x03FF) )
+      {
+         printf("   filtered: row %u is not a CPU write to $0000-$03FF\n",row);
+         ok = false;
+      }
+   }
+
+   tracer.SetFilter(TRACER_SOURCE_ALL,TRACER_TYPE_ALL,0x0000,0xFFFF);
+   tracer.Enable(false);
+   expected = tracer.GetNumSamples();
+   for ( i = 0; i < 1024; i++ )
+   {
+      addSample(tracer,i);
+   }
+   if ( tracer.GetNumSamples() != expected )
+   {
+      printf("   disabled: %u samples, expected %u\n",tracer.GetNumSamples(),expected);
+      ok = false;
+   }
+   tracer.Enable(true);
+
+   tracer.UnmapTracerFile();
+
+   return ok && checkFile(fileName);
+}
+
+// Checks the execution tracer's capture file: fills a capture that stops
+// when it's full, runs one that wraps several times round, and filters one,
+// reading the samples back through GetRecord.
+//
+// tracer [-d depth] [file]
+//
+// The capture file defaults to nes-emulator-tests.trace in the current
+// directory and is removed afterwards.
+int testTracer ( int argc, char* argv[] )
+{
+   CTracer tracer;
+   std::string fileName = "nes-emulator-tests.trace";
+   uint32_t depth = 65536;
+   bool failed = false;
+   bool ok;
+   int arg;
+
+   for ( arg = 0; arg < argc; arg++ )
+   {
+      if ( !strcmp(argv[arg],"-d") && (arg+1 < argc) )
+      {
+         depth = atoi(argv[++arg]);
+      }
+      else
+      {
+         fileName = argv[arg];
+      }
+   }
+
+   ok = testFill(tracer,fileName.c_str(),depth);
+   printf("fill   %s\n",ok?"ok":"FAILED");
+   failed |= !ok;
+   ok = testWrap(tracer,fileName.c_str(),depth);
+   printf("wrap   %s\n",ok?"ok":"FAILED");
+   failed |= !ok;
+   ok = testFilter(tracer,fileName.c_str(),depth);
+   printf("filter %s\n",ok?"ok":"FAILED");
+   failed |= !ok;
+
+   remove(fileName.c_str());
+
+   return failed ? 1 : 0;
+}
@@ -28,6 +28,7 @@ EmulatorControl::EmulatorControl(QWidget *parent) :
    QObject::connect(this,SIGNAL(pauseEmulation(bool)),emulator,SLOT(pauseEmulation(bool)));
    QObject::connect(this,SIGNAL(resetEmulator()),emulator,SLOT(resetEmulator()));
    QObject::connect(this,SIGNAL(softResetEmulator()),emulator,SLOT(softResetEmulator()));
+   QObject::connect(this,SIGNAL(stepBackFrame()),emulator,SLOT(stepBackFrame()));
 }
 
 EmulatorControl::~EmulatorControl()
@@ -42,6 +43,7 @@ QList<QAction*> EmulatorControl::menu()
    items.append(ui->actionPause);
    items.append(ui->actionSoft_Reset);
    items.append(ui->actionReset);
+   items.append(ui->actionFrame_Back);
    return items;
 }
 
@@ -82,3 +84,8 @@ void EmulatorControl::on_softButton_clicked()
    emit softResetEmulator();
    emit startEmulation();
 }
+
+void EmulatorControl::on_actionFrame_Back_triggered()
+{
+   emit stepBackFrame();
+}
@@ -24,12 +24,14 @@ signals:
    void pauseEmulation(bool show);
    void softResetEmulator();
    void resetEmulator();
+   void stepBackFrame();
 
 private slots:
    void on_softButton_clicked();
    void on_resetButton_clicked();
    void on_pauseButton_clicked();
    void on_playButton_clicked();
+   void on_actionFrame_Back_triggered();
    void internalPause();
    void internalPlay();
 };
@@ -12,7 +12,9 @@ NESEmulatorDockWidget::NESEmulatorDockWidget(QWidget *parent) :
 {
    int32_t i;
 
-   imgData = new char[256*256*4];
+   // The PPU and the renderer share three frames so neither waits on,
+   // or draws over, the other.
+   imgData = new char[3*256*256*4];
 
    ui->setupUi(this);
 
@@ -36,14 +38,14 @@ NESEmulatorDockWidget::NESEmulatorDockWidget(QWidget *parent) :
    m_joy [ CONTROLLER2 ] = 0;
 
    // Clear image to set alpha channel...
-   for ( i = 0; i < 256*256*4; i+=4 )
+   for ( i = 0; i < 3*256*256*4; i+=4 )
    {
       imgData[i] = 0;
       imgData[i+1] = 0;
       imgData[i+2] = 0;
       imgData[i+3] = 0xFF;
    }
-   nesSetTVOut((int8_t*)imgData);
+   nesSetTVOutQueue((int8_t*)imgData,(int8_t*)imgData+256*256*4,(int8_t*)imgData+2*256*256*4);
 }
 
 NESEmulatorDockWidget::~NESEmulatorDockWidget()
@@ -406,5 +408,6 @@ void NESEmulatorDockWidget::keyReleaseEvent(QKeyEvent* event)
 
 void NESEmulatorDockWidget::renderData()
 {
+   renderer->reloadData((char*)nesAcquireTVOut());
    renderer->updateGL();
 }
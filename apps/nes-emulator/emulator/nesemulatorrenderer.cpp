@@ -6,6 +6,7 @@ CNESEmulatorRenderer::CNESEmulatorRenderer(QWidget* parent, char* imgData)
    : QGLWidget(parent)
 {
    imageData = imgData;
+   imageChanged = true;
    scrollX = 0;
    scrollY = 0;
    zoom = 100;
@@ -75,6 +76,15 @@ void CNESEmulatorRenderer::initializeGL()
 
    // Load the actual texture
    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 256, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+   imageChanged = false;
+}
+
+void CNESEmulatorRenderer::reloadData(char* imgData)
+{
+   // The frame is uploaded on the next repaint.  Repaints for any other
+   // reason reuse the texture.
+   imageData = imgData;
+   imageChanged = true;
 }
 
 void CNESEmulatorRenderer::setBGColor(QColor clr)
@@ -164,7 +174,12 @@ void CNESEmulatorRenderer::paintGL()
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
    }
-   glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 256, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+   if ( imageChanged )
+   {
+      // Only the visible scanlines are ever drawn.
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 240, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+      imageChanged = false;
+   }
    glBegin(GL_QUADS);
    glTexCoord2f (0.0, 240.f/256.0);
    glVertex3f(0.0, 0.0, 0.0f);
@@ -45,17 +45,14 @@ extern "C" void SDL_GetMoreData(void* userdata, uint8_t* stream, int32_t len)
    to = t;
    qDebug(str.toLatin1().constData());
 #endif
-   if ( nesGetAudioSamplesAvailable() >= (len>>1) )
-   {
-      memcpy(stream,nesGetAudioSamples(len>>1),len);
-   }
-#if 0
-   else
+   nesReadAudioSamples((int16_t*)stream,len>>1);
+
+   // Let the emulator go on if it's waiting for room.  Don't bank wakeups
+   // while it isn't, or it would later run ahead of the audio.
+   if ( !nesAudioSemaphore.available() )
    {
-//      qDebug("UNDERRUN");
+      nesAudioSemaphore.release();
    }
-#endif
-   nesAudioSemaphore.release();
 }
 
 NESEmulatorThread::NESEmulatorThread(QObject*)
@@ -68,11 +65,15 @@ NESEmulatorThread::NESEmulatorThread(QObject*)
    m_isStarting = false;
    m_isTerminating = false;
    m_isResetting = false;
+   m_isSteppingBack = false;
    m_pCartridge = NULL;
 
    // Enable callbacks from the external emulator library.
    nesSetAudioHook(audioHook);
 
+   // Keep a history of the emulation to step back through.
+   nesRewindEnable(REWIND_ARENA_SIZE,REWIND_INTERVAL);
+
    SDL_Init ( SDL_INIT_AUDIO );
 
    sdlAudioSpec.callback = SDL_GetMoreData;
@@ -88,6 +89,8 @@ NESEmulatorThread::NESEmulatorThread(QObject*)
 
    SDL_PauseAudio ( 0 );
 
+   // Keep a couple of SDL buffers' worth of audio queued.
+   nesSetAudioLatency(APU_BUFFER_PRERENDER);
    nesClearAudioSamplesAvailable();
 }
 
@@ -225,6 +228,16 @@ void NESEmulatorThread::pauseEmulation (bool show)
    start();
 }
 
+void NESEmulatorThread::stepBackFrame ()
+{
+   m_isSteppingBack = true;
+   m_isStarting = false;
+   m_isRunning = false;
+   m_isPaused = true;
+   m_showOnPause = false;
+   start();
+}
+
 void NESEmulatorThread::run ()
 {
    QWidget* emulatorWidget = MainWindow::me(); // Hacky, but works for now.
@@ -279,6 +292,16 @@ void NESEmulatorThread::run ()
          m_isResetting = false;
       }
 
+      // Step back a frame...
+      if ( m_isSteppingBack )
+      {
+         m_isSteppingBack = false;
+
+         nesRewindStepBack(1);
+
+         emit emulatedFrame();
+      }
+
       // Run the NES...
       if ( m_isRunning )
       {
@@ -9,6 +9,10 @@
 #include "nes_emulator_core.h"
 
 #include "ccartridge.h"
+
+// Rewind history kept so the emulation can be stepped back.
+#define REWIND_ARENA_SIZE ( 32*1024*1024 )
+#define REWIND_INTERVAL   4
 // EMU
 class NESEmulatorThread : public QThread, public IXMLSerializable
 {
@@ -30,6 +34,7 @@ public slots:
    void softResetEmulator ();
    void startEmulation ();
    void pauseEmulation (bool show);
+   void stepBackFrame ();
    void controllerInput ( uint32_t* joy )
    {
       m_joy[CONTROLLER1] = joy[CONTROLLER1];
@@ -57,6 +62,7 @@ protected:
    bool          m_isResetting;
    bool          m_isSoftReset;
    bool          m_isStarting;
+   bool          m_isSteppingBack;
    uint32_t      m_joy [ NUM_CONTROLLERS ];
 };
 
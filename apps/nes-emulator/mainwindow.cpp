@@ -1,6 +1,7 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QSettings>
+#include <QTimerEvent>
 #include <QUrl>
 
 #include "main.h"
@@ -33,6 +34,9 @@ MainWindow::MainWindow(QWidget* parent) :
 
    ui->setupUi(this);
 
+   m_windowTitle = windowTitle();
+   m_frameStatisticsTimer = 0;
+
    m_pNESEmulatorThread = new NESEmulatorThread();
    CObjectRegistry::addObject("Emulator",m_pNESEmulatorThread);
 
@@ -896,6 +900,40 @@ void MainWindow::on_actionLinear_Interpolation_toggled(bool )
    m_pEmulator->setLinearInterpolation(ui->actionLinear_Interpolation->isChecked());
 }
 
+void MainWindow::on_actionFrame_Statistics_toggled(bool value)
+{
+   if ( value )
+   {
+      m_frameStatisticsTimer = startTimer(1000);
+   }
+   else
+   {
+      killTimer(m_frameStatisticsTimer);
+      m_frameStatisticsTimer = 0;
+      setWindowTitle(m_windowTitle);
+   }
+}
+
+void MainWindow::timerEvent(QTimerEvent* event)
+{
+   nesVideoInfo videoInfo;
+
+   if ( event->timerId() == m_frameStatisticsTimer )
+   {
+      nesGetVideoInformation(&videoInfo);
+
+      setWindowTitle(QString("%1 - %2 frames, %3 dropped, %4 duplicated")
+                     .arg(m_windowTitle)
+                     .arg(videoInfo.frames)
+                     .arg(videoInfo.dropped)
+                     .arg(videoInfo.duplicated));
+   }
+   else
+   {
+      QMainWindow::timerEvent(event);
+   }
+}
+
 void MainWindow::on_action4_3_Aspect_toggled(bool )
 {
    EmulatorPrefsDialog::set43Aspect(ui->action4_3_Aspect->isChecked());
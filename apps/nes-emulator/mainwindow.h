@@ -33,6 +33,7 @@ protected:
 
 protected:
    virtual void closeEvent ( QCloseEvent* event );
+   virtual void timerEvent ( QTimerEvent* event );
 
 private:
    static QWidget* _me;
@@ -44,6 +45,8 @@ private:
    QRect ncRect;
    QStringList m_recentFiles;
    QList<QAction*> m_recentFileActions;
+   QString m_windowTitle;
+   int m_frameStatisticsTimer;
 
 private:
    void updateFromEmulatorPrefs(bool initial);
@@ -59,6 +62,7 @@ private slots:
    void saveRecentFiles(QString fileName);
    void updateRecentFiles();
    void on_action4_3_Aspect_toggled(bool );
+   void on_actionFrame_Statistics_toggled(bool value);
    void on_actionLinear_Interpolation_toggled(bool );
    void on_action3x_triggered();
    void on_action2_5x_triggered();
@@ -0,0 +1,78 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QThread>
+
+#include "testsuiterunner.h"
+
+#include <stdio.h>
+
+int main(int argc, char* argv[])
+{
+   QCoreApplication testRunnerApplication(argc, argv);
+   QCommandLineParser parser;
+   TestSuiteRunner testSuite;
+   QString errors;
+   int jobs;
+
+   QCoreApplication::setOrganizationName("CSPSoftware");
+   QCoreApplication::setOrganizationDomain("nesicide.com");
+   QCoreApplication::setApplicationName("nes-testrunner");
+
+   parser.setApplicationDescription("Runs a NESICIDE test suite without the IDE and reports the results.");
+   parser.addHelpOption();
+   parser.addPositionalArgument("suite","Test suite XML file saved by the IDE's Test Suite Executive.");
+   QCommandLineOption jobsOption(QStringList() << "j" << "jobs","Number of tests to run at once (default: one per CPU).","count");
+   parser.addOption(jobsOption);
+   QCommandLineOption junitOption("junit","Write a JUnit XML report to <file> (- for standard output).","file");
+   parser.addOption(junitOption);
+   QCommandLineOption jsonOption("json","Write a JSON report to <file> (- for standard output).","file");
+   parser.addOption(jsonOption);
+   QCommandLineOption debugOption("debug","Run with the debugger support (tracer, code/data logger, breakpoints) enabled, for comparing frame rates.");
+   parser.addOption(debugOption);
+   parser.process(testRunnerApplication);
+
+   if ( parser.positionalArguments().count() != 1 )
+   {
+      parser.showHelp(2);
+   }
+
+   jobs = QThread::idealThreadCount();
+   if ( parser.isSet(jobsOption) )
+   {
+      jobs = parser.value(jobsOption).toInt();
+   }
+
+   if ( !testSuite.loadTestSuite(parser.positionalArguments().at(0),errors) )
+   {
+      fprintf(stderr,"%s\n",errors.toLocal8Bit().constData());
+      return 2;
+   }
+
+   testSuite.executeTests(jobs,parser.isSet(debugOption));
+
+   if ( parser.isSet(junitOption) && !testSuite.writeJUnitReport(parser.value(junitOption)) )
+   {
+      fprintf(stderr,"Cannot write %s\n",parser.value(junitOption).toLocal8Bit().constData());
+      return 2;
+   }
+   // JSON to standard output unless told otherwise.
+   if ( parser.isSet(jsonOption) || !parser.isSet(junitOption) )
+   {
+      QString reportFileName = parser.isSet(jsonOption)?parser.value(jsonOption):"-";
+
+      if ( !testSuite.writeJsonReport(reportFileName) )
+      {
+         fprintf(stderr,"Cannot write %s\n",reportFileName.toLocal8Bit().constData());
+         return 2;
+      }
+   }
+
+   fprintf(stderr,"%d tests: %d passed, %d failed, %d errors, %d skipped\n",
+           testSuite.numTests(),
+           testSuite.numWithResult("pass"),
+           testSuite.numWithResult("fail"),
+           testSuite.numWithResult("error"),
+           testSuite.numWithResult("skipped"));
+
+   return (testSuite.numWithResult("fail")||testSuite.numWithResult("error"))?1:0;
+}
@@ -0,0 +1,72 @@
+#-------------------------------------------------
+#
+# Headless test suite runner for the NES emulator.
+#
+#-------------------------------------------------
+
+QT = core \
+   xml
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TOP = ../..
+
+macx {
+    QMAKE_MAC_SDK = macosx10.14
+}
+
+CONFIG(release, debug|release) {
+   DESTDIR = release
+} else {
+   DESTDIR = debug
+}
+
+# Remove crap we do not need!
+CONFIG -= rtti exceptions
+
+OBJECTS_DIR = $$DESTDIR
+MOC_DIR = $$DESTDIR
+RCC_DIR = $$DESTDIR
+UI_DIR = $$DESTDIR
+
+DEFINES -= UNICODE
+
+TARGET = "nes-testrunner"
+
+TEMPLATE = app
+
+NESICIDE_CXXFLAGS = -I$$TOP/libs/nes -I$$TOP/libs/nes/emulator
+NESICIDE_LIBS = -L$$TOP/libs/nes/$$DESTDIR -lnes-emulator
+
+win32 {
+   QMAKE_LFLAGS += -static-libgcc
+}
+
+unix:!mac {
+   PREFIX = $$(PREFIX)
+   isEmpty (PREFIX) {
+      PREFIX = /usr/local
+   }
+
+   BINDIR = $$(BINDIR)
+   isEmpty (BINDIR) {
+      BINDIR=$$PREFIX/bin
+   }
+
+   target.path = $$BINDIR
+   INSTALLS += target
+}
+
+QMAKE_CXXFLAGS += $$NESICIDE_CXXFLAGS
+LIBS += $$NESICIDE_LIBS
+
+INCLUDEPATH += \
+   $$TOP/common
+
+SOURCES += \
+   main.cpp \
+   testsuiterunner.cpp
+
+HEADERS += \
+   testsuiterunner.h
@@ -0,0 +1,515 @@
+//    NESICIDE - an IDE for the 8-bit NES.
+//    Copyright (C) 2009  Christopher S. Pow
+
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "testsuiterunner.h"
+
+#include "nes_emulator_core.h"
+#include "cjoypadlogger.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDomDocument>
+#include <QDomElement>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+// Hook function endpoints.
+static void audioHook ( void )
+{
+   // Nobody is listening; just keep the APU's sample count from growing.
+   nesClearAudioSamplesAvailable();
+}
+
+TestCaseRunner::TestCaseRunner(TestCase* pTest,QString romPath,bool debug)
+{
+   m_pTest = pTest;
+   m_romPath = romPath;
+   m_debug = debug;
+
+   setAutoDelete(true);
+}
+
+bool TestCaseRunner::loadROM(QString& errors)
+{
+   QFile      romFile(m_romPath);
+   QByteArray rom;
+   const char nesHeader[4] = {'N', 'E', 'S', 0x1A};
+   int32_t    numPrgRomBanks;
+   int32_t    numChrRomBanks;
+   uint8_t    romCB1;
+   uint8_t    romCB2;
+   int32_t    offset;
+   int32_t    bank;
+
+   if ( !romFile.open(QIODevice::ReadOnly) )
+   {
+      errors = "Cannot open ROM file "+m_romPath;
+      return false;
+   }
+   rom = romFile.readAll();
+   romFile.close();
+
+   if ( (rom.length() < 16) || memcmp(rom.constData(),nesHeader,4) )
+   {
+      errors = "Invalid ROM format";
+      return false;
+   }
+
+   // Header layout as in the emulator's iNES loader: 16KB PRG-ROM bank
+   // count, 8KB CHR-ROM bank count, then the two control bytes.
+   numPrgRomBanks = ((uint8_t)rom.at(4))<<1;
+   numChrRomBanks = (uint8_t)rom.at(5);
+   romCB1 = rom.at(6);
+   romCB2 = rom.at(7);
+   if ( romCB2&0x0F )
+   {
+      // Garbage in the reserved bits; ignore the upper mapper nibble.
+      romCB2 = 0x00;
+   }
+
+   offset = 16;
+   if ( romCB1&FLAG_TRAINER )
+   {
+      offset += 512;
+   }
+
+   if ( rom.length() < offset+((numPrgRomBanks+numChrRomBanks)*MEM_8KB) )
+   {
+      errors = "ROM file is truncated";
+      return false;
+   }
+
+   // Clear emulator's cartridge ROMs...
+   nesUnloadROM();
+
+   // Load cartridge PRG-ROM banks into emulator...
+   for ( bank = 0; bank < numPrgRomBanks; bank++ )
+   {
+      nesLoadPRGROMBank(bank,(uint8_t*)rom.data()+offset);
+      offset += MEM_8KB;
+   }
+
+   // Load cartridge CHR-ROM banks into emulator...
+   for ( bank = 0; bank < numChrRomBanks; bank++ )
+   {
+      nesLoadCHRROMBank(bank,(uint8_t*)rom.data()+offset);
+      offset += MEM_8KB;
+   }
+
+   // Perform any necessary fixup on from the ROM loading...
+   nesLoadROM();
+
+   // Set up PPU with iNES header information...
+   if ( (romCB1&FLAG_MIRROR) == FLAG_MIRROR_VERT )
+   {
+      nesSetVerticalMirroring();
+   }
+   else
+   {
+      nesSetHorizontalMirroring();
+   }
+   if ( romCB1&FLAG_FOURSCREEN_VRAM )
+   {
+      nesSetFourScreen();
+   }
+
+   // Initialize NES...
+   nesResetInitial(((romCB1>>4)&0x0F)|(romCB2&0xF0));
+
+   return true;
+}
+
+void TestCaseRunner::run()
+{
+   NESContext*       pContext;
+   int8_t*           tv;
+   JoypadLoggerInfo* inputSample;
+   int32_t           numInputSamples;
+   int32_t           sample;
+   uint32_t          joy [ NUM_CONTROLLERS ] = { 0, 0 };
+   int32_t           frame;
+   int32_t           i;
+   QString           errors;
+   QElapsedTimer     timer;
+
+   timer.start();
+
+   // Each test gets a whole NES to itself.
+   pContext = nesCreateContext();
+   nesSetContext(pContext);
+
+   // Without the debugger support the core runs its hook-free
+   // instantiation, which is what the frame rates normally measure.
+   if ( m_debug )
+   {
+      nesEnableDebug();
+   }
+
+   // Clear image to set alpha channel, same as the emulator window does,
+   // so the TV SHA1s match the ones the IDE recorded.
+   tv = new int8_t [ 256*256*4 ];
+   for ( i = 0; i < 256*256*4; i+=4 )
+   {
+      tv[i] = 0;
+      tv[i+1] = 0;
+      tv[i+2] = 0;
+      tv[i+3] = 0xFF;
+   }
+   nesSetTVOut(tv);
+   nesSetAudioHook(audioHook);
+
+   if ( m_pTest->system == "ntsc" )
+   {
+      nesSetSystemMode(MODE_NTSC);
+   }
+   else
+   {
+      nesSetSystemMode(MODE_PAL);
+   }
+
+   if ( loadROM(errors) )
+   {
+      nesResetInputRecording();
+
+      inputSample = (JoypadLoggerInfo*)m_pTest->recordedInput.constData();
+      numInputSamples = m_pTest->recordedInput.length()/sizeof(JoypadLoggerInfo);
+
+      for ( sample = 0; sample < numInputSamples; sample++ )
+      {
+         nesSetInputSample(0,inputSample);
+         inputSample++;
+      }
+
+      nesSetInputRecording(false);
+      nesSetInputPlayback(true);
+
+      for ( frame = 0; frame < m_pTest->frames; frame++ )
+      {
+         nesRun(joy);
+      }
+
+      QCryptographicHash crypto(QCryptographicHash::Sha1);
+
+      crypto.addData((char*)nesGetTVOut(),256*240*4);
+
+      m_pTest->actualSha1 = crypto.result().toBase64();
+
+      if ( m_pTest->tvSha1.isEmpty() )
+      {
+         m_pTest->result = "skipped";
+         m_pTest->message = "No TV SHA1 recorded for this test";
+      }
+      else if ( m_pTest->actualSha1 == m_pTest->tvSha1 )
+      {
+         m_pTest->result = "pass";
+      }
+      else
+      {
+         m_pTest->result = "fail";
+         m_pTest->message = "TV SHA1 mismatch";
+      }
+   }
+   else
+   {
+      m_pTest->result = "error";
+      m_pTest->message = errors;
+   }
+
+   nesSetContext(NULL);
+   nesDestroyContext(pContext);
+   delete [] tv;
+
+   m_pTest->wallTime = timer.elapsed();
+   if ( (m_pTest->result != "error") && m_pTest->wallTime )
+   {
+      m_pTest->framesPerSecond = (m_pTest->frames*1000.0)/m_pTest->wallTime;
+   }
+}
+
+TestSuiteRunner::TestSuiteRunner()
+{
+   m_wallTime = 0;
+   m_debug = false;
+}
+
+bool TestSuiteRunner::loadTestSuite(QString testSuiteFileName,QString& errors)
+{
+   QFile        testSuiteFile(testSuiteFileName);
+   QDomDocument testSuiteDoc;
+   QDomElement  testSuiteElement;
+   QDomNode     testNode;
+   QDomElement  testElement;
+   TestCase     test;
+
+   if ( !testSuiteFile.open(QIODevice::ReadOnly|QIODevice::Text) )
+   {
+      errors = "Cannot open test suite file "+testSuiteFileName;
+      return false;
+   }
+   if ( !testSuiteDoc.setContent(&testSuiteFile,&errors) )
+   {
+      testSuiteFile.close();
+      return false;
+   }
+   testSuiteFile.close();
+
+   m_testSuiteFileName = testSuiteFileName;
+
+   // ROM file names are relative to the folder the suite lives in.
+   m_testSuiteFolder = QFileInfo(testSuiteFileName).absolutePath();
+
+   m_tests.clear();
+
+   testSuiteElement = testSuiteDoc.documentElement();
+   testNode = testSuiteElement.firstChild();
+   while ( !testNode.isNull() )
+   {
+      testElement = testNode.toElement();
+
+      test.fileName = testElement.attribute("filename");
+      test.frames = testElement.attribute("runframes").toInt();
+      test.system = testElement.attribute("system");
+      test.tvSha1.clear();
+      test.recordedInput.clear();
+
+      QDomNode    childNode = testElement.firstChild();
+      while ( !childNode.isNull() )
+      {
+         QDomElement childElement = childNode.toElement();
+         if ( childElement.nodeName() == "tvsha1" )
+         {
+            test.tvSha1 = childElement.firstChild().toCDATASection().data();
+         }
+         else if ( childElement.nodeName() == "recordedinput" )
+         {
+            test.recordedInput = QByteArray::fromBase64(childElement.firstChild().toCDATASection().data().toLocal8Bit());
+         }
+         childNode = childNode.nextSibling();
+      }
+
+      test.result = "none";
+      test.message.clear();
+      test.actualSha1.clear();
+      test.wallTime = 0;
+      test.framesPerSecond = 0.0;
+
+      m_tests.append(test);
+
+      testNode = testNode.nextSibling();
+   }
+
+   return true;
+}
+
+void TestSuiteRunner::executeTests(int jobs,bool debug)
+{
+   QThreadPool   pool;
+   QDir          testSuiteFolder(m_testSuiteFolder);
+   QElapsedTimer timer;
+   int           test;
+
+   if ( jobs > 0 )
+   {
+      pool.setMaxThreadCount(jobs);
+   }
+
+   m_debug = debug;
+
+   timer.start();
+
+   // m_tests is not touched again until every runner is done, so the
+   // runners can safely fill in their own entries.
+   for ( test = 0; test < m_tests.count(); test++ )
+   {
+      pool.start(new TestCaseRunner(&m_tests[test],testSuiteFolder.absoluteFilePath(m_tests[test].fileName),debug));
+   }
+   pool.waitForDone();
+
+   m_wallTime = timer.elapsed();
+}
+
+int TestSuiteRunner::numWithResult(QString result) const
+{
+   int count = 0;
+   int test;
+
+   for ( test = 0; test < m_tests.count(); test++ )
+   {
+      if ( m_tests[test].result == result )
+      {
+         count++;
+      }
+   }
+   return count;
+}
+
+// A report file name of "-" means standard output.
+static bool openReport(QFile& reportFile,QString reportFileName)
+{
+   if ( reportFileName == "-" )
+   {
+      return reportFile.open(stdout,QIODevice::WriteOnly|QIODevice::Text);
+   }
+
+   reportFile.setFileName(reportFileName);
+   return reportFile.open(QIODevice::WriteOnly|QIODevice::Text|QIODevice::Truncate);
+}
+
+bool TestSuiteRunner::writeJUnitReport(QString reportFileName)
+{
+   QFile        reportFile;
+   QDomDocument reportDoc;
+   QDomElement  suitesElement;
+   QDomElement  suiteElement;
+   QDomElement  testElement;
+   QDomElement  childElement;
+   QDomElement  propertiesElement;
+   QDomElement  propertyElement;
+   int          test;
+
+   reportDoc.appendChild(reportDoc.createProcessingInstruction("xml", "version='1.0' encoding='UTF-8'"));
+
+   suitesElement = reportDoc.createElement("testsuites");
+   reportDoc.appendChild(suitesElement);
+
+   suiteElement = reportDoc.createElement("testsuite");
+   suiteElement.setAttribute("name",QFileInfo(m_testSuiteFileName).completeBaseName());
+   suiteElement.setAttribute("tests",m_tests.count());
+   suiteElement.setAttribute("failures",numWithResult("fail"));
+   suiteElement.setAttribute("errors",numWithResult("error"));
+   suiteElement.setAttribute("skipped",numWithResult("skipped"));
+   suiteElement.setAttribute("time",QString::number(m_wallTime/1000.0,'f',3));
+   suitesElement.appendChild(suiteElement);
+
+   propertiesElement = reportDoc.createElement("properties");
+   suiteElement.appendChild(propertiesElement);
+
+   propertyElement = reportDoc.createElement("property");
+   propertyElement.setAttribute("name","debug");
+   propertyElement.setAttribute("value",m_debug?"true":"false");
+   propertiesElement.appendChild(propertyElement);
+
+   for ( test = 0; test < m_tests.count(); test++ )
+   {
+      const TestCase& testCase = m_tests[test];
+
+      testElement = reportDoc.createElement("testcase");
+      testElement.setAttribute("classname",QFileInfo(m_testSuiteFileName).completeBaseName());
+      testElement.setAttribute("name",testCase.fileName);
+      testElement.setAttribute("time",QString::number(testCase.wallTime/1000.0,'f',3));
+      suiteElement.appendChild(testElement);
+
+      propertiesElement = reportDoc.createElement("properties");
+      testElement.appendChild(propertiesElement);
+
+      propertyElement = reportDoc.createElement("property");
+      propertyElement.setAttribute("name","frames");
+      propertyElement.setAttribute("value",testCase.frames);
+      propertiesElement.appendChild(propertyElement);
+
+      propertyElement = reportDoc.createElement("property");
+      propertyElement.setAttribute("name","fps");
+      propertyElement.setAttribute("value",QString::number(testCase.framesPerSecond,'f',1));
+      propertiesElement.appendChild(propertyElement);
+
+      propertyElement = reportDoc.createElement("property");
+      propertyElement.setAttribute("name","tvsha1");
+      propertyElement.setAttribute("value",testCase.actualSha1);
+      propertiesElement.appendChild(propertyElement);
+
+      if ( testCase.result == "fail" )
+      {
+         childElement = reportDoc.createElement("failure");
+         childElement.setAttribute("message",testCase.message);
+         childElement.appendChild(reportDoc.createTextNode("expected "+testCase.tvSha1+", got "+testCase.actualSha1));
+         testElement.appendChild(childElement);
+      }
+      else if ( testCase.result == "error" )
+      {
+         childElement = reportDoc.createElement("error");
+         childElement.setAttribute("message",testCase.message);
+         testElement.appendChild(childElement);
+      }
+      else if ( testCase.result == "skipped" )
+      {
+         childElement = reportDoc.createElement("skipped");
+         childElement.setAttribute("message",testCase.message);
+         testElement.appendChild(childElement);
+      }
+   }
+
+   if ( !openReport(reportFile,reportFileName) )
+   {
+      return false;
+   }
+   reportFile.write(reportDoc.toByteArray());
+   reportFile.close();
+
+   return true;
+}
+
+bool TestSuiteRunner::writeJsonReport(QString reportFileName)
+{
+   QFile       reportFile;
+   QJsonObject reportObject;
+   QJsonArray  testsArray;
+   int         test;
+
+   for ( test = 0; test < m_tests.count(); test++ )
+   {
+      const TestCase& testCase = m_tests[test];
+      QJsonObject     testObject;
+
+      testObject["filename"] = testCase.fileName;
+      testObject["system"] = testCase.system;
+      testObject["result"] = testCase.result;
+      if ( !testCase.message.isEmpty() )
+      {
+         testObject["message"] = testCase.message;
+      }
+      testObject["frames"] = testCase.frames;
+      testObject["time"] = testCase.wallTime/1000.0;
+      testObject["fps"] = testCase.framesPerSecond;
+      testObject["expectedtvsha1"] = testCase.tvSha1;
+      testObject["tvsha1"] = testCase.actualSha1;
+
+      testsArray.append(testObject);
+   }
+
+   reportObject["testsuite"] = QFileInfo(m_testSuiteFileName).absoluteFilePath();
+   reportObject["tests"] = m_tests.count();
+   reportObject["passed"] = numWithResult("pass");
+   reportObject["failures"] = numWithResult("fail");
+   reportObject["errors"] = numWithResult("error");
+   reportObject["skipped"] = numWithResult("skipped");
+   reportObject["time"] = m_wallTime/1000.0;
+   reportObject["debug"] = m_debug;
+   reportObject["results"] = testsArray;
+
+   if ( !openReport(reportFile,reportFileName) )
+   {
+      return false;
+   }
+   reportFile.write(QJsonDocument(reportObject).toJson());
+   reportFile.close();
+
+   return true;
+}
@@ -0,0 +1,69 @@
+#ifndef TESTSUITERUNNER_H
+#define TESTSUITERUNNER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QRunnable>
+
+#include "stdint.h"
+
+// One <test> entry of a TestSuiteExecutiveDialog suite file, plus the
+// outcome of running it.
+typedef struct
+{
+   // From the suite file.
+   QString    fileName;
+   int32_t    frames;
+   QString    system;
+   QString    tvSha1;
+   QByteArray recordedInput;
+
+   // Filled in by the run.
+   QString    result;       // "pass", "fail", "skipped" or "error"
+   QString    message;
+   QString    actualSha1;
+   qint64     wallTime;     // msec
+   double     framesPerSecond;
+} TestCase;
+
+// Runs one test in its own emulator context.  Instances are handed to a
+// QThreadPool so any number of tests run at once.
+class TestCaseRunner : public QRunnable
+{
+public:
+   TestCaseRunner(TestCase* pTest,QString romPath,bool debug);
+
+   void run();
+
+private:
+   bool loadROM(QString& errors);
+
+   TestCase* m_pTest;
+   QString   m_romPath;
+   bool      m_debug;
+};
+
+class TestSuiteRunner
+{
+public:
+   TestSuiteRunner();
+
+   bool loadTestSuite(QString testSuiteFileName,QString& errors);
+   void executeTests(int jobs,bool debug);
+
+   bool writeJUnitReport(QString reportFileName);
+   bool writeJsonReport(QString reportFileName);
+
+   int numTests() const { return m_tests.count(); }
+   int numWithResult(QString result) const;
+
+private:
+   QString         m_testSuiteFileName;
+   QString         m_testSuiteFolder;
+   QList<TestCase> m_tests;
+   qint64          m_wallTime;
+   bool            m_debug;
+};
+
+#endif // TESTSUITERUNNER_H
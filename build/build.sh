@@ -20,4 +20,10 @@ echo Building FamiPlayer...
 ( cd famiplayer; qmake; make )
 echo Building NES Emulator...
 ( cd nes-emulator; qmake; make )
+echo Building NES Test Runner...
+( cd nes-testrunner; qmake; make )
+echo Building NES Emulator Tests...
+( cd nes-emulator-tests; qmake; make )
+echo Building CC65 Debug Info Tests...
+( cd cc65-debuginfo-tests; qmake; make )
 
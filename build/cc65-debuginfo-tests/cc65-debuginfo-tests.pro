@@ -0,0 +1,5 @@
+TEMPLATE = subdirs
+
+SUBDIRS = cc65-debuginfo-tests-app
+
+cc65-debuginfo-tests-app.file = ../../apps/cc65-debuginfo-tests/cc65-debuginfo-tests.pro
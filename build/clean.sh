@@ -8,6 +8,12 @@ echo Cleaning FamiPlayer...
 ( cd famiplayer; make distclean )
 echo Cleaning NES Emulator...
 ( cd nes-emulator; make distclean )
+echo Cleaning NES Test Runner...
+( cd nes-testrunner; make distclean )
+echo Cleaning NES Emulator Tests...
+( cd nes-emulator-tests; make distclean )
+echo Cleaning CC65 Debug Info Tests...
+( cd cc65-debuginfo-tests; make distclean )
 echo Removing deps...
 if [ "$1" == "deps" ]; then
   ( cd ..; rm -rf deps )
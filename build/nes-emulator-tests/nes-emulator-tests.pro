@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+
+SUBDIRS = nes-emulator-lib nes-emulator-tests-app
+
+nes-emulator-lib.file = ../../libs/nes/nes-emulator-lib.pro
+nes-emulator-tests-app.file = ../../apps/nes-emulator-tests/nes-emulator-tests.pro
+
+nes-emulator-tests-app.depends = nes-emulator-lib
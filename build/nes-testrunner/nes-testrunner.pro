@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+
+SUBDIRS = nes-emulator-lib nes-testrunner-app
+
+nes-emulator-lib.file = ../../libs/nes/nes-emulator-lib.pro
+nes-testrunner-app.file = ../../apps/nes-testrunner/nes-testrunner.pro
+
+nes-testrunner-app.depends = nes-emulator-lib
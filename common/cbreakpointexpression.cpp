@@ -0,0 +1,493 @@
+#include "cbreakpointexpression.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+// Binding strength of the binary operators, loosest first.  Operators not
+// in the table are not binary operators.
+static const int BINARY_LEVELS = 10;
+
+static int BinaryLevel ( int op )
+{
+   switch ( op )
+   {
+      case eBreakpointOpLogicalOr:
+         return 0;
+      case eBreakpointOpLogicalAnd:
+         return 1;
+      case eBreakpointOpBitwiseOr:
+         return 2;
+      case eBreakpointOpBitwiseXor:
+         return 3;
+      case eBreakpointOpBitwiseAnd:
+         return 4;
+      case eBreakpointOpEqual:
+      case eBreakpointOpNotEqual:
+         return 5;
+      case eBreakpointOpLess:
+      case eBreakpointOpLessEqual:
+      case eBreakpointOpGreater:
+      case eBreakpointOpGreaterEqual:
+         return 6;
+      case eBreakpointOpShiftLeft:
+      case eBreakpointOpShiftRight:
+         return 7;
+      case eBreakpointOpAdd:
+      case eBreakpointOpSubtract:
+         return 8;
+      case eBreakpointOpMultiply:
+      case eBreakpointOpDivide:
+      case eBreakpointOpModulo:
+         return 9;
+   }
+   return -1;
+}
+
+static bool NameMatches ( const char* text, int length, const char* name )
+{
+   int idx;
+
+   for ( idx = 0; idx < length; idx++ )
+   {
+      if ( (!name[idx]) || (tolower((unsigned char)text[idx]) != tolower((unsigned char)name[idx])) )
+      {
+         return false;
+      }
+   }
+   return name[length] == 0;
+}
+
+typedef struct _ExpressionParser
+{
+   const char*                       text;
+   const char*                       p;
+   const BreakpointExpressionSymbol* pSymbols;
+   BreakpointProgram*                pProgram;
+   char*                             error;
+   int                               depth;
+   bool                              failed;
+} ExpressionParser;
+
+static void Fail ( ExpressionParser* pParser, const char* what )
+{
+   if ( !pParser->failed )
+   {
+      snprintf(pParser->error,BREAKPOINT_ERROR_LENGTH,"%s at column %d",what,(int)(pParser->p-pParser->text)+1);
+      pParser->failed = true;
+   }
+}
+
+static void SkipSpace ( ExpressionParser* pParser )
+{
+   while ( isspace((unsigned char)(*pParser->p)) )
+   {
+      pParser->p++;
+   }
+}
+
+// Appends an operation.  push is the change in the depth of the value
+// stack the operation makes when evaluated.
+static void Emit ( ExpressionParser* pParser, int op, int32_t operand, int push )
+{
+   if ( pParser->failed )
+   {
+      return;
+   }
+   if ( pParser->pProgram->length >= BREAKPOINT_PROGRAM_LENGTH )
+   {
+      Fail(pParser,"Expression too long");
+      return;
+   }
+   pParser->depth += push;
+   if ( pParser->depth > BREAKPOINT_STACK_DEPTH )
+   {
+      Fail(pParser,"Expression nested too deeply");
+      return;
+   }
+   pParser->pProgram->ops[pParser->pProgram->length].op = op;
+   pParser->pProgram->ops[pParser->pProgram->length].operand = operand;
+   pParser->pProgram->length++;
+}
+
+// Looks for a binary operator at the parse position.  Returns the operation
+// and its length in characters, or -1 if there isn't one.
+static int ScanBinaryOperator ( const char* p, int* pLength )
+{
+   static const struct
+   {
+      const char* text;
+      int         op;
+   } operators [] =
+   {
+      { "||", eBreakpointOpLogicalOr },
+      { "&&", eBreakpointOpLogicalAnd },
+      { "==", eBreakpointOpEqual },
+      { "!=", eBreakpointOpNotEqual },
+      { "<=", eBreakpointOpLessEqual },
+      { ">=", eBreakpointOpGreaterEqual },
+      { "<<", eBreakpointOpShiftLeft },
+      { ">>", eBreakpointOpShiftRight },
+      { "|", eBreakpointOpBitwiseOr },
+      { "^", eBreakpointOpBitwiseXor },
+      { "&", eBreakpointOpBitwiseAnd },
+      { "<", eBreakpointOpLess },
+      { ">", eBreakpointOpGreater },
+      { "+", eBreakpointOpAdd },
+      { "-", eBreakpointOpSubtract },
+      { "*", eBreakpointOpMultiply },
+      { "/", eBreakpointOpDivide },
+      { "%", eBreakpointOpModulo },
+      { NULL, -1 }
+   };
+   int idx;
+
+   for ( idx = 0; operators[idx].text; idx++ )
+   {
+      int length = strlen(operators[idx].text);
+      if ( strncmp(p,operators[idx].text,length) == 0 )
+      {
+         (*pLength) = length;
+         return operators[idx].op;
+      }
+   }
+   return -1;
+}
+
+static void ParseBinary ( ExpressionParser* pParser, int level );
+
+static bool ParseNumber ( ExpressionParser* pParser )
+{
+   const char* p = pParser->p;
+   int         radix = 10;
+   uint32_t    value = 0;
+   int         digits = 0;
+
+   if ( (*p) == '$' )
+   {
+      radix = 16;
+      p++;
+   }
+   else if ( (*p) == '%' )
+   {
+      radix = 2;
+      p++;
+   }
+   else if ( ((*p) == '0') && (((*(p+1)) == 'x') || ((*(p+1)) == 'X')) )
+   {
+      radix = 16;
+      p += 2;
+   }
+   else if ( !isdigit((unsigned char)(*p)) )
+   {
+      return false;
+   }
+
+   for ( ; ; p++ )
+   {
+      int digit;
+
+      if ( isdigit((unsigned char)(*p)) )
+      {
+         digit = (*p)-'0';
+      }
+      else if ( isxdigit((unsigned char)(*p)) )
+      {
+         digit = tolower((unsigned char)(*p))-'a'+10;
+      }
+      else
+      {
+         break;
+      }
+      if ( digit >= radix )
+      {
+         break;
+      }
+      value = (value*radix)+digit;
+      digits++;
+   }
+
+   if ( (!digits) || isalnum((unsigned char)(*p)) || ((*p) == '_') )
+   {
+      pParser->p = p;
+      Fail(pParser,"Bad number");
+      return true;
+   }
+
+   pParser->p = p;
+   Emit(pParser,eBreakpointOpConstant,(int32_t)value,1);
+   return true;
+}
+
+static bool ParseName ( ExpressionParser* pParser )
+{
+   const char* start = pParser->p;
+   const char* p = start;
+   int         length;
+   int         idx;
+
+   if ( !(isalpha((unsigned char)(*p)) || ((*p) == '_')) )
+   {
+      return false;
+   }
+   while ( isalnum((unsigned char)(*p)) || ((*p) == '_') )
+   {
+      p++;
+   }
+   length = p-start;
+
+   if ( NameMatches(start,length,"data") )
+   {
+      pParser->p = p;
+      Emit(pParser,eBreakpointOpData,0,1);
+      return true;
+   }
+
+   for ( idx = 0; pParser->pSymbols && pParser->pSymbols[idx].name; idx++ )
+   {
+      if ( NameMatches(start,length,pParser->pSymbols[idx].name) )
+      {
+         pParser->p = p;
+         Emit(pParser,eBreakpointOpSymbol,pParser->pSymbols[idx].id,1);
+         return true;
+      }
+   }
+
+   Fail(pParser,"Unknown name");
+   return true;
+}
+
+static void ParseUnary ( ExpressionParser* pParser )
+{
+   int op = -1;
+
+   SkipSpace(pParser);
+   switch ( *pParser->p )
+   {
+      case '-':
+         op = eBreakpointOpNegate;
+         break;
+      case '!':
+         op = eBreakpointOpLogicalNot;
+         break;
+      case '~':
+         op = eBreakpointOpBitwiseNot;
+         break;
+      case '+':
+         pParser->p++;
+         ParseUnary(pParser);
+         return;
+   }
+   if ( op >= 0 )
+   {
+      pParser->p++;
+      ParseUnary(pParser);
+      Emit(pParser,op,0,0);
+      return;
+   }
+
+   if ( ((*pParser->p) == '(') || ((*pParser->p) == '[') )
+   {
+      char close = ((*pParser->p) == '(') ? ')' : ']';
+
+      pParser->p++;
+      ParseBinary(pParser,0);
+      SkipSpace(pParser);
+      if ( (*pParser->p) != close )
+      {
+         Fail(pParser,(close == ')') ? "Expected )" : "Expected ]");
+         return;
+      }
+      pParser->p++;
+      if ( close == ']' )
+      {
+         Emit(pParser,eBreakpointOpMemory,0,0);
+      }
+      return;
+   }
+
+   if ( ParseNumber(pParser) || ParseName(pParser) )
+   {
+      return;
+   }
+
+   Fail(pParser,(*pParser->p) ? "Expected a value" : "Unexpected end of expression");
+}
+
+static void ParseBinary ( ExpressionParser* pParser, int level )
+{
+   if ( level >= BINARY_LEVELS )
+   {
+      ParseUnary(pParser);
+      return;
+   }
+
+   ParseBinary(pParser,level+1);
+   while ( !pParser->failed )
+   {
+      int length;
+      int op;
+
+      SkipSpace(pParser);
+      op = ScanBinaryOperator(pParser->p,&length);
+      if ( (op < 0) || (BinaryLevel(op) != level) )
+      {
+         break;
+      }
+      pParser->p += length;
+      ParseBinary(pParser,level+1);
+      Emit(pParser,op,0,-1);
+   }
+}
+
+bool CBreakpointExpression::Compile ( const char* text, const BreakpointExpressionSymbol* pSymbols, BreakpointProgram* pProgram, char* error )
+{
+   ExpressionParser parser;
+
+   parser.text = text;
+   parser.p = text;
+   parser.pSymbols = pSymbols;
+   parser.pProgram = pProgram;
+   parser.error = error;
+   parser.depth = 0;
+   parser.failed = false;
+
+   pProgram->length = 0;
+   error[0] = 0;
+
+   SkipSpace(&parser);
+   if ( !(*parser.p) )
+   {
+      return true;
+   }
+
+   ParseBinary(&parser,0);
+   SkipSpace(&parser);
+   if ( (!parser.failed) && (*parser.p) )
+   {
+      Fail(&parser,"Unexpected text");
+   }
+
+   if ( parser.failed )
+   {
+      pProgram->length = 1;
+      pProgram->ops[0].op = eBreakpointOpConstant;
+      pProgram->ops[0].operand = 0;
+      return false;
+   }
+   return true;
+}
+
+int32_t CBreakpointExpression::Evaluate ( const BreakpointProgram* pProgram, const BreakpointExpressionContext* pContext, int32_t data )
+{
+   int32_t                    stack [ BREAKPOINT_STACK_DEPTH ];
+   int32_t*                   sp = stack-1;
+   const BreakpointOperation* pOp = pProgram->ops;
+   const BreakpointOperation* pEnd = pProgram->ops+pProgram->length;
+   int32_t                    rhs;
+
+   if ( pOp == pEnd )
+   {
+      return 1;
+   }
+
+   // The compiler has checked the depth of the stack, so the pushes and
+   // pops here don't need to.  Arithmetic is done unsigned where signed
+   // overflow would be undefined.
+   for ( ; pOp < pEnd; pOp++ )
+   {
+      switch ( pOp->op )
+      {
+         case eBreakpointOpConstant:
+            *(++sp) = pOp->operand;
+            break;
+         case eBreakpointOpSymbol:
+            *(++sp) = pContext->symbol(pOp->operand);
+            break;
+         case eBreakpointOpData:
+            *(++sp) = data;
+            break;
+         case eBreakpointOpMemory:
+            (*sp) = pContext->memory((uint32_t)(*sp));
+            break;
+         case eBreakpointOpNegate:
+            (*sp) = (int32_t)(0-(uint32_t)(*sp));
+            break;
+         case eBreakpointOpLogicalNot:
+            (*sp) = !(*sp);
+            break;
+         case eBreakpointOpBitwiseNot:
+            (*sp) = ~(*sp);
+            break;
+         default:
+            rhs = *(sp--);
+            switch ( pOp->op )
+            {
+               case eBreakpointOpMultiply:
+                  (*sp) = (int32_t)((uint32_t)(*sp)*(uint32_t)rhs);
+                  break;
+               case eBreakpointOpDivide:
+                  if ( rhs == -1 )
+                  {
+                     (*sp) = (int32_t)(0-(uint32_t)(*sp));
+                  }
+                  else
+                  {
+                     (*sp) = rhs ? ((*sp)/rhs) : 0;
+                  }
+                  break;
+               case eBreakpointOpModulo:
+                  (*sp) = ((rhs == 0) || (rhs == -1)) ? 0 : ((*sp)%rhs);
+                  break;
+               case eBreakpointOpAdd:
+                  (*sp) = (int32_t)((uint32_t)(*sp)+(uint32_t)rhs);
+                  break;
+               case eBreakpointOpSubtract:
+                  (*sp) = (int32_t)((uint32_t)(*sp)-(uint32_t)rhs);
+                  break;
+               case eBreakpointOpShiftLeft:
+                  (*sp) = (int32_t)((uint32_t)(*sp)<<(rhs&31));
+                  break;
+               case eBreakpointOpShiftRight:
+                  (*sp) = (int32_t)((uint32_t)(*sp)>>(rhs&31));
+                  break;
+               case eBreakpointOpLess:
+                  (*sp) = (*sp) < rhs;
+                  break;
+               case eBreakpointOpLessEqual:
+                  (*sp) = (*sp) <= rhs;
+                  break;
+               case eBreakpointOpGreater:
+                  (*sp) = (*sp) > rhs;
+                  break;
+               case eBreakpointOpGreaterEqual:
+                  (*sp) = (*sp) >= rhs;
+                  break;
+               case eBreakpointOpEqual:
+                  (*sp) = (*sp) == rhs;
+                  break;
+               case eBreakpointOpNotEqual:
+                  (*sp) = (*sp) != rhs;
+                  break;
+               case eBreakpointOpBitwiseAnd:
+                  (*sp) &= rhs;
+                  break;
+               case eBreakpointOpBitwiseXor:
+                  (*sp) ^= rhs;
+                  break;
+               case eBreakpointOpBitwiseOr:
+                  (*sp) |= rhs;
+                  break;
+               case eBreakpointOpLogicalAnd:
+                  (*sp) = (*sp) && rhs;
+                  break;
+               case eBreakpointOpLogicalOr:
+                  (*sp) = (*sp) || rhs;
+                  break;
+            }
+            break;
+      }
+   }
+
+   return *sp;
+}
@@ -0,0 +1,94 @@
+#ifndef CBREAKPOINTEXPRESSION_H
+#define CBREAKPOINTEXPRESSION_H
+
+#include <stdint.h>
+
+#define BREAKPOINT_EXPRESSION_LENGTH 128
+#define BREAKPOINT_PROGRAM_LENGTH    48
+#define BREAKPOINT_STACK_DEPTH       16
+#define BREAKPOINT_ERROR_LENGTH      128
+
+// Breakpoint conditions are compiled once, when the breakpoint is set, into
+// a short postfix program.  Evaluating a condition in the emulation loop is
+// then a walk over a handful of operations with a small value stack, rather
+// than a parse of the expression text.
+typedef enum
+{
+   eBreakpointOpConstant = 0,
+   eBreakpointOpSymbol,
+   eBreakpointOpData,
+   eBreakpointOpMemory,
+   eBreakpointOpNegate,
+   eBreakpointOpLogicalNot,
+   eBreakpointOpBitwiseNot,
+   eBreakpointOpMultiply,
+   eBreakpointOpDivide,
+   eBreakpointOpModulo,
+   eBreakpointOpAdd,
+   eBreakpointOpSubtract,
+   eBreakpointOpShiftLeft,
+   eBreakpointOpShiftRight,
+   eBreakpointOpLess,
+   eBreakpointOpLessEqual,
+   eBreakpointOpGreater,
+   eBreakpointOpGreaterEqual,
+   eBreakpointOpEqual,
+   eBreakpointOpNotEqual,
+   eBreakpointOpBitwiseAnd,
+   eBreakpointOpBitwiseXor,
+   eBreakpointOpBitwiseOr,
+   eBreakpointOpLogicalAnd,
+   eBreakpointOpLogicalOr
+} eBreakpointOperation;
+
+typedef struct _BreakpointOperation
+{
+   int32_t op;
+   int32_t operand;
+} BreakpointOperation;
+
+// A compiled condition.  An empty program is always true.
+typedef struct _BreakpointProgram
+{
+   int32_t             length;
+   BreakpointOperation ops [ BREAKPOINT_PROGRAM_LENGTH ];
+} BreakpointProgram;
+
+// Emulators describe the names an expression may use with a table of
+// these, terminated by an entry with a NULL name.  The id is handed back
+// to the context's symbol function when the expression is evaluated.
+typedef struct _BreakpointExpressionSymbol
+{
+   const char* name;
+   int32_t     id;
+} BreakpointExpressionSymbol;
+
+typedef struct _BreakpointExpressionContext
+{
+   int32_t (*symbol)(int32_t id);
+   int32_t (*memory)(uint32_t addr);
+} BreakpointExpressionContext;
+
+// Expression syntax, loosest binding first:
+//    ||  &&  |  ^  &  == !=  < <= > >=  << >>  + -  * / %
+//    unary - ! ~
+//    ( expr )  [ addr ]  number  symbol  data
+// Numbers are decimal, $hex, 0xhex or %binary.  Symbol names are not case
+// sensitive.  "data" is the value the breakpoint matched on.
+class CBreakpointExpression
+{
+public:
+   // Compiles text into pProgram.  On failure returns false, leaves a
+   // message in error (BREAKPOINT_ERROR_LENGTH bytes) and a program that
+   // is always false.
+   static bool Compile ( const char* text, const BreakpointExpressionSymbol* pSymbols, BreakpointProgram* pProgram, char* error );
+
+   static int32_t Evaluate ( const BreakpointProgram* pProgram, const BreakpointExpressionContext* pContext, int32_t data );
+
+   static bool IsEmpty ( const BreakpointProgram* pProgram )
+   {
+      return pProgram->length == 0;
+   }
+};
+
+#endif // CBREAKPOINTEXPRESSION_H
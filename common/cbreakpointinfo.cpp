@@ -1,18 +1,130 @@
 #include "cbreakpointinfo.h"
 
+#include <string.h>
+
 CBreakpointInfo::CBreakpointInfo()
-   : m_numBreakpoints(0)
+   : m_numBreakpoints(0),
+     m_revision(0),
+     m_logCount(0)
+{
+}
+
+bool CBreakpointInfo::CompileExpression ( BreakpointInfo* pBreakpoint, char* error )
+{
+   return CBreakpointExpression::Compile(pBreakpoint->expression,NULL,&(pBreakpoint->program),error);
+}
+
+void CBreakpointInfo::ModifyCondition ( BreakpointInfo* pBreakpoint, const BreakpointInfo* pSource )
+{
+   char error [ BREAKPOINT_ERROR_LENGTH ];
+
+   if ( pSource )
+   {
+      if ( pSource != pBreakpoint )
+      {
+         strncpy(pBreakpoint->expression,pSource->expression,BREAKPOINT_EXPRESSION_LENGTH);
+         pBreakpoint->expression[BREAKPOINT_EXPRESSION_LENGTH-1] = 0;
+         pBreakpoint->hitCondition = pSource->hitCondition;
+         pBreakpoint->hitCountTarget = pSource->hitCountTarget;
+         pBreakpoint->action = pSource->action;
+      }
+   }
+   else
+   {
+      pBreakpoint->expression[0] = 0;
+      pBreakpoint->hitCondition = eBreakpointHitAlways;
+      pBreakpoint->hitCountTarget = 0;
+      pBreakpoint->action = eBreakpointActionBreak;
+   }
+   pBreakpoint->hitCount = 0;
+
+   // A condition that doesn't compile leaves a program that is never true,
+   // so a bad condition can't turn into an unconditional breakpoint.
+   CompileExpression(pBreakpoint,error);
+}
+
+bool CBreakpointInfo::QualifyHit ( int idx, const BreakpointExpressionContext* pContext, int data )
+{
+   BreakpointInfo* pBreakpoint = &(m_breakpoint[idx]);
+   char            msg [ BREAKPOINT_LOG_LENGTH ];
+
+   if ( !CBreakpointExpression::Evaluate(&(pBreakpoint->program),pContext,data) )
+   {
+      return false;
+   }
+
+   pBreakpoint->hitCount++;
+   switch ( pBreakpoint->hitCondition )
+   {
+      case eBreakpointHitCountEqual:
+         if ( pBreakpoint->hitCount != pBreakpoint->hitCountTarget )
+         {
+            return false;
+         }
+         break;
+      case eBreakpointHitCountMultiple:
+         if ( pBreakpoint->hitCountTarget &&
+              (pBreakpoint->hitCount%pBreakpoint->hitCountTarget) )
+         {
+            return false;
+         }
+         break;
+      case eBreakpointHitCountAtLeast:
+         if ( pBreakpoint->hitCount < pBreakpoint->hitCountTarget )
+         {
+            return false;
+         }
+         break;
+      default:
+         break;
+   }
+
+   if ( pBreakpoint->action == eBreakpointActionLog )
+   {
+      GetHitPrintable(idx,msg);
+      AddLogEntry(msg);
+      return false;
+   }
+
+   return true;
+}
+
+void CBreakpointInfo::AddLogEntry ( const char* msg )
 {
+   char* entry = m_log[m_logCount%BREAKPOINT_LOG_ENTRIES];
+
+   strncpy(entry,msg,BREAKPOINT_LOG_LENGTH);
+   entry[BREAKPOINT_LOG_LENGTH-1] = 0;
+   m_logCount++;
+}
+
+bool CBreakpointInfo::GetLogEntry ( uint32_t entry, char* msg )
+{
+   uint32_t count = m_logCount;
+
+   if ( (entry >= count) || ((count-entry) > BREAKPOINT_LOG_ENTRIES) )
+   {
+      return false;
+   }
+   strncpy(msg,m_log[entry%BREAKPOINT_LOG_ENTRIES],BREAKPOINT_LOG_LENGTH);
+   msg[BREAKPOINT_LOG_LENGTH-1] = 0;
+
+   // The emulator may have gone round the log and written over the entry
+   // while it was being copied.
+   count = m_logCount;
+   return (count-entry) <= BREAKPOINT_LOG_ENTRIES;
 }
 
 void CBreakpointInfo::ToggleEnabled ( int bp )
 {
    m_breakpoint [ bp ].enabled = !m_breakpoint [ bp ].enabled;
+   m_revision++;
 }
 
 void CBreakpointInfo::SetEnabled ( int bp, bool enabled )
 {
    m_breakpoint [ bp ].enabled = enabled;
+   m_revision++;
 }
 
 int CBreakpointInfo::FindExactMatch ( int type, eBreakpointItemType itemType, int event, int item1, int item1Absolute, int item2, int mask, bool maskExclusive, eBreakpointConditionType conditionType, int condition, eBreakpointDataType dataType, int data )
@@ -61,12 +173,15 @@ void CBreakpointInfo::ModifyBreakpoint ( int bp, BreakpointInfo* pBreakpoint )
                        pBreakpoint->dataType,
                        pBreakpoint->data,
                        pBreakpoint->enabled);
+      ModifyCondition(&(m_breakpoint[bp]),pBreakpoint);
+      m_revision++;
    }
 }
 
 void CBreakpointInfo::ConstructBreakpoint ( BreakpointInfo* pBreakpoint, int type, eBreakpointItemType itemType, int event, int item1, int item1Absolute, int item2, int mask, bool maskExclusive, eBreakpointConditionType conditionType, int condition, eBreakpointDataType dataType, int data, bool enabled )
 {
    ModifyBreakpoint(pBreakpoint,type,itemType,event,item1,item1Absolute,item2,mask,maskExclusive,conditionType,condition,dataType,data,enabled);
+   ModifyCondition(pBreakpoint,NULL);
 }
 
 int CBreakpointInfo::AddBreakpoint ( BreakpointInfo* pBreakpoint )
@@ -88,7 +203,9 @@ int CBreakpointInfo::AddBreakpoint ( BreakpointInfo* pBreakpoint )
                          pBreakpoint->dataType,
                          pBreakpoint->data,
                          pBreakpoint->enabled );
+      ModifyCondition(&(m_breakpoint[m_numBreakpoints]),pBreakpoint);
       m_numBreakpoints++;
+      m_revision++;
    }
    else
    {
@@ -117,7 +234,9 @@ int CBreakpointInfo::AddBreakpoint ( int type, eBreakpointItemType itemType, int
                          dataType,
                          data,
                          enabled );
+      ModifyCondition(&(m_breakpoint[m_numBreakpoints]),NULL);
       m_numBreakpoints++;
+      m_revision++;
    }
    else
    {
@@ -149,10 +268,17 @@ void CBreakpointInfo::RemoveBreakpoint ( int index )
       m_breakpoint [ idx ].condition = m_breakpoint [ idx+1 ].condition;
       m_breakpoint [ idx ].dataType = m_breakpoint [ idx+1 ].dataType;
       m_breakpoint [ idx ].data = m_breakpoint [ idx+1 ].data;
+      memcpy(m_breakpoint [ idx ].expression,m_breakpoint [ idx+1 ].expression,BREAKPOINT_EXPRESSION_LENGTH);
+      m_breakpoint [ idx ].program = m_breakpoint [ idx+1 ].program;
+      m_breakpoint [ idx ].hitCondition = m_breakpoint [ idx+1 ].hitCondition;
+      m_breakpoint [ idx ].hitCountTarget = m_breakpoint [ idx+1 ].hitCountTarget;
+      m_breakpoint [ idx ].hitCount = m_breakpoint [ idx+1 ].hitCount;
+      m_breakpoint [ idx ].action = m_breakpoint [ idx+1 ].action;
       m_breakpoint [ idx ].hit = m_breakpoint [ idx+1 ].hit;
    }
 
    m_numBreakpoints--;
+   m_revision++;
 }
 
 BreakpointStatus CBreakpointInfo::GetStatus ( int idx )
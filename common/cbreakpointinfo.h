@@ -1,10 +1,16 @@
 #ifndef CBREAKPOINTINFO_H
 #define CBREAKPOINTINFO_H
 
-#define NUM_BREAKPOINTS 10
+#define NUM_BREAKPOINTS 100
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <atomic>
+
+#include "cbreakpointexpression.h"
+
+#define BREAKPOINT_LOG_ENTRIES 128
+#define BREAKPOINT_LOG_LENGTH  512
 
 typedef enum
 {
@@ -71,6 +77,20 @@ typedef enum
    eBreakpointDataPick
 } eBreakpointDataType;
 
+typedef enum
+{
+   eBreakpointHitAlways = 0,
+   eBreakpointHitCountEqual,
+   eBreakpointHitCountMultiple,
+   eBreakpointHitCountAtLeast
+} eBreakpointHitCondition;
+
+typedef enum
+{
+   eBreakpointActionBreak = 0,
+   eBreakpointActionLog
+} eBreakpointAction;
+
 class CBreakpointEventInfo
 {
 public:
@@ -143,6 +163,16 @@ typedef struct _BreakpointInfo
    int condition;
    eBreakpointDataType dataType;
    int data; // depending on type this field will be real value or index of bitfield value...
+   // Once the breakpoint matches, the condition expression must be true
+   // and the hit count must satisfy the hit condition for it to be hit.
+   // Log-only breakpoints (tracepoints) then write their hit message to the
+   // log rather than stopping the emulator.
+   char expression [ BREAKPOINT_EXPRESSION_LENGTH ];
+   BreakpointProgram program;
+   eBreakpointHitCondition hitCondition;
+   uint32_t hitCountTarget;
+   uint32_t hitCount;
+   eBreakpointAction action;
    bool hit;
 } BreakpointInfo;
 
@@ -176,14 +206,44 @@ public:
    {
       return &(m_breakpoint[idx]);
    }
+   // Compiles pBreakpoint->expression into pBreakpoint->program.  Emulators
+   // override this to provide the names an expression may use; this one
+   // only accepts an empty expression.
+   virtual bool CompileExpression ( BreakpointInfo* pBreakpoint, char* error );
+   // Checks the condition and hit count of a breakpoint that has matched.
+   // Returns true if the breakpoint is hit.  Log-only breakpoints are
+   // never hit; their hit message is added to the log instead.
+   bool QualifyHit ( int idx, const BreakpointExpressionContext* pContext, int data );
+   // Messages logged by log-only breakpoints.  The log keeps the last
+   // BREAKPOINT_LOG_ENTRIES messages; entries are numbered from when the
+   // log was created, so a reader can ask for the ones it hasn't seen.
+   void AddLogEntry ( const char* msg );
+   uint32_t GetLogCount ( void ) const
+   {
+      return m_logCount;
+   }
+   bool GetLogEntry ( uint32_t entry, char* msg );
+   // The revision changes whenever a breakpoint is added, removed,
+   // modified, enabled or disabled.  Emulators that index the breakpoints
+   // compare it with the revision they last indexed, from their own thread
+   // and while they run, so it goes up only once the change is made.
+   uint32_t GetRevision ( void ) const
+   {
+      return m_revision;
+   }
 
 protected:
    // Must be provided by subclass.
    virtual void ModifyBreakpoint ( BreakpointInfo* pBreakpoint, int type, eBreakpointItemType itemType, int event, int item1, int item1Absolute, int item2, int mask, bool maskExclusive, eBreakpointConditionType conditionType, int condition, eBreakpointDataType dataType, int data, bool enabled ) = 0;
 
+   void ModifyCondition ( BreakpointInfo* pBreakpoint, const BreakpointInfo* pSource );
+
 protected:
    BreakpointInfo m_breakpoint [ NUM_BREAKPOINTS ];
    int            m_numBreakpoints;
+   std::atomic<uint32_t> m_revision;
+   char           m_log [ BREAKPOINT_LOG_ENTRIES ][ BREAKPOINT_LOG_LENGTH ];
+   volatile uint32_t m_logCount;
 };
 
 #endif // CBREAKPOINTINFO_H
@@ -2987,6 +2987,7 @@ BOOL CFont::CreateFont(
    _qfont.setUnderline(bUnderline);
    _qfont.setStrikeOut(cStrikeOut);
    _qfont.setBold(nWeight>=FW_BOLD);
+   _staticText.clear();
    return TRUE;
 }
 
@@ -3002,9 +3003,33 @@ BOOL CFont::CreateFontIndirect(
    _qfont.setPointSize(abs(lpLogFont->lfHeight)*.75);
    _qfont.setItalic(lpLogFont->lfItalic);
    _qfont.setBold(lpLogFont->lfWeight>=FW_BOLD);
+   _staticText.clear();
    return TRUE;
 }
 
+const QStaticText& CFont::staticText(const QString& text)
+{
+   QHash<QString,QStaticText>::iterator iter = _staticText.find(text);
+
+   if ( iter == _staticText.end() )
+   {
+      QStaticText staticText(text);
+
+      // Pattern editors and the like draw the same few strings over and
+      // over; anything drawing endless different strings just starts over.
+      if ( _staticText.count() >= 1024 )
+      {
+         _staticText.clear();
+      }
+
+      staticText.setTextFormat(Qt::PlainText);
+      staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+      staticText.prepare(QTransform(),_qfont);
+      iter = _staticText.insert(text,staticText);
+   }
+   return iter.value();
+}
+
 CBitmap::CBitmap()
 {
    _qpixmap = new QPixmap(1,1);
@@ -3139,6 +3164,7 @@ CDC::CDC()
    _bkColor = QColor(0,0,0);
    _bkMode = 0;
    _textColor = QColor(255,255,255);
+   _textPen = false;
    _windowOrg.x = 0;
    _windowOrg.y = 0;
    attached = false;
@@ -3172,6 +3198,7 @@ CDC::CDC(CWnd* parent)
    _bkColor = QColor(0,0,0);
    _bkMode = 0;
    _textColor = QColor(255,255,255);
+   _textPen = false;
    _windowOrg.x = 0;
    _windowOrg.y = 0;
    attached = false;
@@ -3196,6 +3223,9 @@ void CDC::attach()
 {
    _qpixmap = QPixmap(1,1);
    _qpainter.begin(&_qpixmap);
+   if ( _font )
+      _qpainter.setFont((QFont)*_font);
+   _textPen = false;
    m_hDC = (HDC)this;
    attached = true;
 }
@@ -3211,6 +3241,9 @@ void CDC::attach(QWidget* qtParent, CWnd* mfcParent, bool transparent)
    else
       _qpixmap.fill(_qwidget->palette().color(QPalette::Window)); // CP: paint over an existing widget
    _qpainter.begin(&_qpixmap);
+   if ( _font )
+      _qpainter.setFont((QFont)*_font);
+   _textPen = false;
    m_hDC = (HDC)this;
    m_pWnd = mfcParent;
    attached = true;
@@ -3290,6 +3323,7 @@ CPen* CDC::SelectObject(
 )
 {
    CPen* temp = _pen;
+   restorePen();
    _pen = pPen;
    if ( _pen )
       _qpainter.setPen((QPen)(*_pen));
@@ -3400,13 +3434,20 @@ BOOL CDC::BitBlt(
 )
 {
    QPixmap* pixmap = pSrcDC->pixmap();
-   QPixmap tempPixmap = pixmap->copy();
    QSize pixmapSize = pSrcDC->pixmapSize();
    pixmapSize = pixmapSize.boundedTo(QSize(nWidth,nHeight));
-   if ( pixmap && (pixmapSize.width() >= 0) )
-      _qpainter.drawPixmap(x,y,pixmapSize.width(),pixmapSize.height(),tempPixmap,xSrc,ySrc,pixmapSize.width(),pixmapSize.height());
+   if ( pixmapSize.width() < 0 )
+      pixmapSize = QSize(nWidth,nHeight);
+   if ( pSrcDC == this )
+   {
+      // A pixmap can't be drawn onto itself, so copy the part being moved.
+      QPixmap tempPixmap = pixmap->copy(xSrc,ySrc,pixmapSize.width(),pixmapSize.height());
+      _qpainter.drawPixmap(x,y,tempPixmap);
+   }
    else
-      _qpainter.drawPixmap(x,y,nWidth,nHeight,tempPixmap,xSrc,ySrc,nWidth,nHeight);
+   {
+      _qpainter.drawPixmap(x,y,pixmapSize.width(),pixmapSize.height(),*pixmap,xSrc,ySrc,pixmapSize.width(),pixmapSize.height());
+   }
    return TRUE;
 }
 
@@ -3504,6 +3545,7 @@ BOOL CDC::DrawEdge(
    QRect rect2(lpRect->left+1,lpRect->top+1,lpRect->right-lpRect->left,lpRect->bottom-lpRect->top);
    QPen pen1(::GetSysColor(COLOR_BTNSHADOW));
    QPen pen2(::GetSysColor(COLOR_3DFACE));
+   restorePen();
    QPen pen = _qpainter.pen();
    _qpainter.setPen(pen1);
    _qpainter.drawRect(rect1);
@@ -3521,6 +3563,18 @@ BOOL CDC::RectVisible(
    return TRUE;
 }
 
+int CDC::GetClipBox(
+   LPRECT lpRect
+) const
+{
+   // Nothing is clipped; the whole pixmap is drawn to.
+   lpRect->left = 0;
+   lpRect->top = 0;
+   lpRect->right = _qpixmap.width();
+   lpRect->bottom = _qpixmap.height();
+   return SIMPLEREGION;
+}
+
 BOOL CDC::Rectangle(
    int x1,
    int y1,
@@ -3529,6 +3583,7 @@ BOOL CDC::Rectangle(
 )
 {
    QRect rect(x1,y1,x2-x1,y2-y1);
+   restorePen();
    _qpainter.drawRect(rect);
    return TRUE;
 }
@@ -3544,6 +3599,7 @@ void CDC::Draw3dRect( int x, int y, int cx, int cy, COLORREF clrTopLeft, COLORRE
 {
    QPen tlc(QColor(GetRValue(clrTopLeft),GetGValue(clrTopLeft),GetBValue(clrTopLeft)));
    QPen brc(QColor(GetRValue(clrBottomRight),GetGValue(clrBottomRight),GetBValue(clrBottomRight)));
+   restorePen();
    QPen origPen = _qpainter.pen();
    x -= _windowOrg.x;
    y -= _windowOrg.y;
@@ -3569,15 +3625,12 @@ int CDC::DrawText(
    QString qstr = QString::fromLatin1((LPCTSTR)str);
 #endif
    QTextOption to;
-   QPen origPen = _qpainter.pen();
-   _qpainter.setPen(QPen(_textColor));
-//   _qpainter.setFont((QFont)*_font);
+   textPen();
    if ( nFormat&DT_CENTER )
    {
       to.setAlignment(Qt::AlignCenter);
    }
    _qpainter.drawText(rect,qstr.toLatin1().constData(),to);
-   _qpainter.setPen(origPen);
    return 0; // CP: should be text height
 }
 
@@ -3594,16 +3647,13 @@ int CDC::DrawText(
 #else
    QString qstr = QString::fromLatin1(lpszString);
 #endif
-   QPen origPen = _qpainter.pen();
    QTextOption to;
-   _qpainter.setPen(QPen(_textColor));
-//   _qpainter.setFont((QFont)*_font);
+   textPen();
    if ( nFormat&DT_CENTER )
    {
       to.setAlignment(Qt::AlignCenter);
    }
    _qpainter.drawText(rect,qstr.left(nCount).toLatin1().constData(),to);
-   _qpainter.setPen(origPen);
    return 0; // CP: should be text height
 }
 
@@ -3667,6 +3717,7 @@ BOOL CDC::LineTo(
    int y
 )
 {
+   restorePen();
    _qpainter.drawLine(_lineOrg.x,_lineOrg.y,x,y);
    _lineOrg.x = x;
    _lineOrg.y = y;
@@ -3687,6 +3738,7 @@ BOOL CDC::Polygon(
    }
    poly.append(QPoint(lpPoints[0].x,lpPoints[0].y));
    path.addPolygon(poly);
+   restorePen();
    _qpainter.fillPath(path,(QBrush)*_brush);
    _qpainter.drawPath(path);
    return TRUE;
@@ -3716,15 +3768,7 @@ BOOL CDC::TextOut(
 #else
    QString qstr = QString::fromLatin1(lpszString);
 #endif
-   QFontMetrics fontMetrics((QFont)*_font);
-   QPen origPen = _qpainter.pen();
-   _qpainter.setPen(QPen(_textColor));
-//   _qpainter.setFont((QFont)*_font);
-   x += -_windowOrg.x;
-   y += -_windowOrg.y;
-   y += fontMetrics.ascent();
-   _qpainter.drawText(x,y,qstr.left(nCount));
-   _qpainter.setPen(origPen);
+   textOut(x,y,qstr.left(nCount));
    return TRUE;
 }
 
@@ -3734,16 +3778,50 @@ BOOL CDC::TextOut(
       const CString& str
 )
 {
-   QFontMetrics fontMetrics((QFont)*_font);
-   QPen origPen = _qpainter.pen();
-   _qpainter.setPen(QPen(_textColor));
-//   _qpainter.setFont((QFont)*_font);
+   textOut(x,y,(const QString&)str);
+   return TRUE;
+}
+
+void CDC::textOut(
+   int x,
+   int y,
+   const QString& text
+)
+{
+   // The painter draws in the selected font, so the text is laid out in
+   // it once and positioned by its top left rather than its baseline.
+   // Consecutive calls aren't queued up and drawn together: QPainter has
+   // no call that draws several pieces of text at once, so each would
+   // still be a drawStaticText when flushed.  Only the pen is shared.
+   textPen();
    x += -_windowOrg.x;
    y += -_windowOrg.y;
-   y += fontMetrics.ascent();
-   _qpainter.drawText(x,y,(const QString&)str);
-   _qpainter.setPen(origPen);
-   return TRUE;
+   _qpainter.drawStaticText(x,y,_font->staticText(text));
+}
+
+void CDC::textPen()
+{
+   // Runs of text in the same colour set the pen once.  The selected pen
+   // is put back before anything else that draws with it.
+   if ( !_textPen )
+   {
+      _selectedPen = _qpainter.pen();
+      _textPen = true;
+      _qpainter.setPen(QPen(_textColor));
+   }
+   else if ( _qpainter.pen().color() != _textColor )
+   {
+      _qpainter.setPen(QPen(_textColor));
+   }
+}
+
+void CDC::restorePen()
+{
+   if ( _textPen )
+   {
+      _textPen = false;
+      _qpainter.setPen(_selectedPen);
+   }
 }
 
 IMPLEMENT_DYNAMIC(CComboBox,CWnd)
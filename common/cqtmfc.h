@@ -20,6 +20,7 @@
 #include <QToolBar>
 #include <QPixmap>
 #include <QFont>
+#include <QStaticText>
 #include <QRegion>
 #include <QFrame>
 #include <QAbstractButton>
@@ -3459,11 +3460,16 @@ public:
    CFont& operator=(const CFont& r)
    {
       this->_qfont = r._qfont;
+      _staticText.clear();
       return *this;
    }
 
+   // Text drawn in this font, laid out the first time it's drawn.
+   const QStaticText& staticText(const QString& text);
+
 private:
    QFont _qfont;
+   QHash<QString,QStaticText> _staticText;
 };
 
 class CRgn : public CGdiObject
@@ -3503,7 +3509,7 @@ public:
    void attach();
    void attach(QWidget* qtParent, CWnd* mfcParent, bool transparent = false);
    void detach(bool silent = false);
-   QPainter* painter() { return &_qpainter; }
+   QPainter* painter() { restorePen(); return &_qpainter; }
    QPixmap* pixmap() { return &_qpixmap; }
    QSize pixmapSize() { return _bitmapSize; }
    QWidget* widget() { return _qwidget; }
@@ -3551,6 +3557,9 @@ public:
    virtual BOOL RectVisible(
       LPCRECT lpRect
    ) const;
+   int GetClipBox(
+      LPRECT lpRect
+   ) const;
    BOOL Rectangle(
       LPCRECT lpRect
    );
@@ -3746,6 +3755,9 @@ public:
 
 private:
    CDC(CDC& orig);
+   void textPen();
+   void restorePen();
+   void textOut(int x,int y,const QString& text);
    bool attached;
    QWidget*    _qwidget;
    QPixmap    _qpixmap;
@@ -3763,6 +3775,8 @@ private:
    QColor      _bkColor;
    int         _bkMode;
    QColor      _textColor;
+   bool        _textPen;
+   QPen        _selectedPen;
    CPoint      _windowOrg;
    CPoint      _viewportOrg;
    CWnd* m_pWnd;
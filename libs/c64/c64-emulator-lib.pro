@@ -25,6 +25,7 @@ CONFIG(release, debug|release) {
 
 # Remove crap we don't need!
 CONFIG -= rtti exceptions
+CONFIG += c++11
 
 OBJECTS_DIR = $$DESTDIR
 MOC_DIR = $$DESTDIR
@@ -65,6 +66,7 @@ INCLUDEPATH += . \
                $$TOP/common
 
 SOURCES += \
+   $$TOP/common/cbreakpointexpression.cpp \
    $$TOP/common/cbreakpointinfo.cpp \
    c64_emulator_core.cpp \
    emulator/cc646502.cpp \
@@ -1,6 +1,8 @@
 #ifndef C64_EMULATOR_CORE_H
 #define C64_EMULATOR_CORE_H
 
+#include "cbreakpointinfo.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -11,7 +13,6 @@ extern "C" {
 
 #include "cmemorydata.h"
 #include "cregisterdata.h"
-#include "cbreakpointinfo.h"
 
 // Common enumerations for emulated items.
 typedef enum
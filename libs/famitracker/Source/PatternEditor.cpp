@@ -161,7 +161,8 @@ CPatternEditor::CPatternEditor() :
 	m_iPaints(0),
 	m_iErases(0),
 	m_iBuffers(0),
-	m_iCharsDrawn(0)
+	m_iCharsDrawn(0),
+	m_iFullRedrawTime(0)
 {
 	// Get drag info from OS
 	m_iDragThresholdX = ::GetSystemMetrics(SM_CXDRAG);
@@ -347,9 +348,8 @@ void CPatternEditor::DrawScreen(CDC *pDC, CFamiTrackerView *pView)
 
 	// Performance checking
 #ifdef BENCHMARK
-	LARGE_INTEGER StartTime, EndTime;
-	LARGE_INTEGER Freq;
-	QueryPerformanceCounter(&StartTime);
+	QElapsedTimer PaintTimer;
+	PaintTimer.start();
 #endif
 
 	//
@@ -422,7 +422,14 @@ void CPatternEditor::DrawScreen(CDC *pDC, CFamiTrackerView *pView)
 		}
 		else {
 			// Perform a full redraw
+#ifdef BENCHMARK
+			QElapsedTimer RedrawTimer;
+			RedrawTimer.start();
+#endif
 			PerformFullRedraw(m_pPatternDC);
+#ifdef BENCHMARK
+			m_iFullRedrawTime += RedrawTimer.nsecsElapsed() / 1000;
+#endif
 		}
 
 		++m_iRedraws;
@@ -493,8 +500,7 @@ void CPatternEditor::DrawScreen(CDC *pDC, CFamiTrackerView *pView)
 #endif
 #ifdef BENCHMARK
 
-	QueryPerformanceCounter(&EndTime);
-	QueryPerformanceFrequency(&Freq);
+	qint64 PaintTime = PaintTimer.nsecsElapsed() / 1000;
 
 	CRect clipBox;
 	pDC->GetClipBox(&clipBox);
@@ -513,7 +519,8 @@ void CPatternEditor::DrawScreen(CDC *pDC, CFamiTrackerView *pView)
 
 #define PUT_TEXT(x) pDC->TextOut(m_iWinWidth - x, PosY, Text); PosY += LINE_BREAK
 
-	Text.Format(_T("%i ms"), (__int64(EndTime.QuadPart) - __int64(StartTime.QuadPart)) / (__int64(Freq.QuadPart) / 1000)); PUT_TEXT(160);
+	Text.Format(_T("%i us"), int(PaintTime)); PUT_TEXT(160);
+	Text.Format(_T("%i us / full redraw"), m_iFullRedraws ? int(m_iFullRedrawTime / m_iFullRedraws) : 0); PUT_TEXT(160);
 	Text.Format(_T("%i redraws"), m_iRedraws); PUT_TEXT(160);
 	Text.Format(_T("%i paints"), m_iPaints); PUT_TEXT(160);
 	Text.Format(_T("%i quick redraws"), m_iQuickRedraws); PUT_TEXT(160);
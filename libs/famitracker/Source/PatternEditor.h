@@ -404,4 +404,5 @@ private:
 	mutable int m_iErases;
 	mutable int m_iBuffers;
 	mutable int m_iCharsDrawn;
+	mutable qint64 m_iFullRedrawTime;
 };
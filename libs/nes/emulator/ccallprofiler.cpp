@@ -0,0 +1,143 @@
+//    NESICIDE - an IDE for the 8-bit NES.
+//    Copyright (C) 2009  Christopher S. Pow
+
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "ccallprofiler.h"
+
+CCallProfiler::CCallProfiler()
+{
+   m_pNodes = new CallProfilerNode [ CALL_PROFILER_NODES ];
+   m_lastCycle = 0;
+   Clear ();
+}
+
+CCallProfiler::~CCallProfiler()
+{
+   delete [] m_pNodes;
+}
+
+void CCallProfiler::Clear ( void )
+{
+   m_pNodes [ CALL_PROFILER_ROOT ].addr = 0xFFFFFFFF;
+   m_pNodes [ CALL_PROFILER_ROOT ].absAddr = 0xFFFFFFFF;
+   m_pNodes [ CALL_PROFILER_ROOT ].parent = CALL_PROFILER_NONE;
+   m_pNodes [ CALL_PROFILER_ROOT ].child = CALL_PROFILER_NONE;
+   m_pNodes [ CALL_PROFILER_ROOT ].sibling = CALL_PROFILER_NONE;
+   m_pNodes [ CALL_PROFILER_ROOT ].calls = 0;
+   m_pNodes [ CALL_PROFILER_ROOT ].cycles = 0;
+   m_numNodes = 1;
+   m_droppedCalls = 0;
+   m_depth = 0;
+}
+
+void CCallProfiler::Sample ( uint32_t cycle )
+{
+   int32_t node = CALL_PROFILER_ROOT;
+
+   if ( m_depth )
+   {
+      node = m_frameNode [ m_depth-1 ];
+   }
+
+   if ( (cycle-m_lastCycle) <= CALL_PROFILER_MAX_CYCLES )
+   {
+      m_pNodes [ node ].cycles += (cycle-m_lastCycle);
+   }
+   m_lastCycle = cycle;
+}
+
+void CCallProfiler::Pop ( uint8_t sp )
+{
+   // The stack grows down, so any call whose return address sat at or
+   // below the stack pointer is over.
+   while ( m_depth && (m_frameSP[m_depth-1] <= sp) )
+   {
+      m_depth--;
+   }
+}
+
+void CCallProfiler::Call ( uint32_t addr, uint32_t absAddr, uint8_t sp, uint32_t cycle )
+{
+   int32_t parent;
+   int32_t node;
+
+   Sample ( cycle );
+   Pop ( sp );
+
+   if ( m_depth == CALL_PROFILER_DEPTH )
+   {
+      return;
+   }
+
+   parent = CALL_PROFILER_ROOT;
+   if ( m_depth )
+   {
+      parent = m_frameNode [ m_depth-1 ];
+   }
+
+   for ( node = m_pNodes[parent].child; node != CALL_PROFILER_NONE; node = m_pNodes[node].sibling )
+   {
+      if ( (m_pNodes[node].addr == addr) &&
+           (m_pNodes[node].absAddr == absAddr) )
+      {
+         break;
+      }
+   }
+
+   if ( node == CALL_PROFILER_NONE )
+   {
+      if ( m_numNodes < CALL_PROFILER_NODES )
+      {
+         node = m_numNodes;
+         m_numNodes++;
+
+         m_pNodes [ node ].addr = addr;
+         m_pNodes [ node ].absAddr = absAddr;
+         m_pNodes [ node ].parent = parent;
+         m_pNodes [ node ].child = CALL_PROFILER_NONE;
+         m_pNodes [ node ].sibling = m_pNodes [ parent ].child;
+         m_pNodes [ node ].calls = 0;
+         m_pNodes [ node ].cycles = 0;
+         m_pNodes [ parent ].child = node;
+      }
+      else
+      {
+         // Charge the routine to its caller, but still track the call
+         // so its return is matched.
+         m_droppedCalls++;
+         node = parent;
+      }
+   }
+
+   if ( node != parent )
+   {
+      m_pNodes [ node ].calls++;
+   }
+
+   m_frameNode [ m_depth ] = node;
+   m_frameSP [ m_depth ] = sp;
+   m_depth++;
+}
+
+void CCallProfiler::Return ( uint8_t sp, uint32_t cycle )
+{
+   Sample ( cycle );
+   Pop ( sp );
+}
+
+void CCallProfiler::Unwind ( void )
+{
+   m_depth = 0;
+}
@@ -0,0 +1,92 @@
+#ifndef CCALLPROFILER_H
+#define CCALLPROFILER_H
+
+#include <stdint.h>
+
+#define CALL_PROFILER_NODES 8192
+#define CALL_PROFILER_DEPTH 64
+
+// Gaps between samples longer than any instruction are the CPU being
+// reset, a state being loaded or profiling having been off, and aren't
+// charged to anything.
+#define CALL_PROFILER_MAX_CYCLES 1024
+
+// Node 0 is the code that runs outside of any subroutine or interrupt
+// handler the profiler has seen called.
+#define CALL_PROFILER_ROOT  0
+#define CALL_PROFILER_NONE  -1
+
+// One routine reached by one particular chain of calls.  The nodes form
+// a call tree; the cycles of a node are the cycles spent in the routine
+// itself, so the cycles of a whole call chain are the sum over the subtree.
+typedef struct _CallProfilerNode
+{
+   // Entry point of the routine: the CPU address, and the absolute address
+   // in the banked memory it is in, to tell apart routines in different
+   // banks.
+   uint32_t addr;
+   uint32_t absAddr;
+   int32_t  parent;
+   int32_t  child;
+   int32_t  sibling;
+   uint32_t calls;
+   uint32_t cycles;
+} CallProfilerNode;
+
+// The call profiler keeps a shadow of the call stack as the CPU executes
+// JSR/RTS and enters/leaves interrupts, charging the CPU cycles between
+// the changes to whichever routine is running.  The program's stack pointer
+// decides which calls a return leaves, so code that plays with its return
+// addresses (RTS jump tables, discarding a return address, resetting the
+// stack in an NMI handler) doesn't leave the shadow stack out of step.
+class CCallProfiler
+{
+public:
+   CCallProfiler();
+   ~CCallProfiler();
+
+   void Clear ( void );
+
+   // Charges the cycles since the last change to the running routine.
+   void Sample ( uint32_t cycle );
+
+   // sp is the stack pointer before the return address was pushed, which
+   // is what it will be again once the routine returns.
+   void Call ( uint32_t addr, uint32_t absAddr, uint8_t sp, uint32_t cycle );
+   void Return ( uint8_t sp, uint32_t cycle );
+
+   // Forgets the calls in progress, as on a CPU reset.
+   void Unwind ( void );
+
+   int32_t GetNumNodes ( void ) const
+   {
+      return m_numNodes;
+   }
+   const CallProfilerNode* GetNode ( int32_t node ) const
+   {
+      return m_pNodes+node;
+   }
+   // The calls whose routines were charged to the caller because the tree
+   // was full.
+   uint32_t GetNumDroppedCalls ( void ) const
+   {
+      return m_droppedCalls;
+   }
+
+protected:
+   void Pop ( uint8_t sp );
+
+   CallProfilerNode* m_pNodes;
+   int32_t           m_numNodes;
+   uint32_t          m_droppedCalls;
+
+   // The shadow call stack.  Calls nested deeper than it are charged
+   // to the deepest call it holds.
+   int32_t           m_frameNode [ CALL_PROFILER_DEPTH ];
+   uint8_t           m_frameSP [ CALL_PROFILER_DEPTH ];
+   int32_t           m_depth;
+
+   uint32_t          m_lastCycle;
+};
+
+#endif // CCALLPROFILER_H
@@ -17,14 +17,12 @@
 #include "ccodedatalogger.h"
 
 #include "nes_emulator_core.h"
+#include "cnescontext.h"
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
-uint32_t CCodeDataLogger::m_curCycle = 0;
-LoggerInfo* CCodeDataLogger::m_pLastLoad = NULL;
-
 CCodeDataLogger::CCodeDataLogger(uint32_t size, uint32_t mask)
 {
    m_pLogger = new LoggerInfo [ size ];
@@ -45,6 +43,7 @@ void CCodeDataLogger::ClearData ( void )
    for ( idx = 0; idx < m_size; idx++ )
    {
       m_pLogger [ idx ].count = 0;
+      m_pLogger [ idx ].cycles = 0;
    }
 
    m_maxCount = 1;
@@ -83,20 +82,36 @@ void CCodeDataLogger::LogAccess ( uint32_t cycle, uint32_t addr, uint8_t data, i
       m_maxCount = pLogger->count;
    }
 
+   if ( type == eLogger_InstructionFetch )
+   {
+      if ( (STATE()->m_pLastFetch) &&
+           ((cycle-STATE()->m_lastFetchCycle) <= LOGGER_MAX_INSTRUCTION_CYCLES) )
+      {
+         STATE()->m_pLastFetch->cycles += (cycle-STATE()->m_lastFetchCycle);
+      }
+      STATE()->m_pLastFetch = pLogger;
+      STATE()->m_lastFetchCycle = cycle;
+   }
+
    pLogger->pLastLoad = NULL;
 
-   if ( (m_pLastLoad) &&
+   if ( (STATE()->m_pLastLoad) &&
          (type == eLogger_DataWrite) )
    {
-      pLogger->pLastLoad = m_pLastLoad;
+      pLogger->pLastLoad = STATE()->m_pLastLoad;
    }
 
    if ( type == eLogger_DataRead )
    {
-      m_pLastLoad = pLogger;
+      STATE()->m_pLastLoad = pLogger;
    }
 
-   m_curCycle = cycle;
+   STATE()->m_curCycle = cycle;
+}
+
+uint32_t CCodeDataLogger::GetCurCycle ( void )
+{
+   return STATE()->m_curCycle;
 }
 
 void CCodeDataLogger::GetPrintable ( uint32_t addr, int32_t subItem, char* str )
@@ -5,6 +5,12 @@
 
 #define LAST_VALUE_LIST_LEN 10
 
+// Longest an instruction can take, counting a sprite DMA and DMC fetches
+// that stall it.  Longer gaps between instruction fetches are the CPU
+// being reset, a state being loaded or logging having been off, and
+// aren't charged to anything.
+#define LOGGER_MAX_INSTRUCTION_CYCLES 1024
+
 enum
 {
    eLogger_InstructionFetch,
@@ -30,6 +36,9 @@ typedef struct _LoggerInfo
    uint32_t cycle;
    uint16_t cpuAddr;
    uint32_t count;
+   // CPU cycles spent in the instructions fetched from here, counted
+   // from each instruction fetch to the next.
+   uint32_t cycles;
    int8_t type;
    int8_t source;
    struct _LoggerInfo* pLastLoad;
@@ -53,6 +62,10 @@ public:
    {
       return (*(m_pLogger+addr)).cycle;
    }
+   uint32_t GetCycles ( uint32_t addr )
+   {
+      return (*(m_pLogger+addr)).cycles;
+   }
    uint32_t GetCPUAddr ( uint32_t addr )
    {
       return (*(m_pLogger+addr)).cpuAddr;
@@ -76,10 +89,7 @@ public:
       return (m_pLogger+addr);
    }
 
-   static inline uint32_t GetCurCycle ( void )
-   {
-      return m_curCycle;
-   }
+   static uint32_t GetCurCycle ( void );
    inline uint32_t GetMaxCount ( void )
    {
       return m_maxCount;
@@ -88,10 +98,21 @@ public:
 protected:
    uint32_t        m_size;
    uint32_t        m_mask;
-   static uint32_t m_curCycle;
    uint32_t m_maxCount;
-   static LoggerInfo* m_pLastLoad;
    LoggerInfo* m_pLogger;
+
+   // Shared by all of the loggers of one emulated NES.
+   friend struct NESContext;
+   struct State
+   {
+      uint32_t m_curCycle = 0;
+      LoggerInfo* m_pLastLoad = NULL;
+
+      // The last instruction fetch, to be charged the cycles up to the next.
+      LoggerInfo* m_pLastFetch = NULL;
+      uint32_t m_lastFetchCycle = 0;
+   };
+   static inline State* STATE ();
 };
 
 void nesClearCodeDataLoggerDatabases ();
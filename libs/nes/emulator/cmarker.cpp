@@ -15,6 +15,7 @@
 //    along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "cmarker.h"
+#include "cnescontext.h"
 
 static uint8_t markerColors [][3] =
 {
@@ -47,6 +48,9 @@ CMarker::CMarker()
 void CMarker::RemoveMarker(int32_t marker)
 {
    m_marker [ marker ].state = eMarkerSet_Invalid;
+
+   // Bring the debuggers' snapshots up to date.
+   __nescontext->edits++;
 }
 
 void CMarker::RemoveAllMarkers(void)
@@ -70,6 +74,8 @@ void CMarker::ZeroMarker(int32_t marker)
    m_marker [ marker ].minCpuCycles = 0xFFFFFFFF;
    m_marker [ marker ].maxCpuCycles = 0;
    m_marker [ marker ].curCpuCycles = 0;
+
+   __nescontext->edits++;
 }
 
 void CMarker::ZeroAllMarkers(void)
@@ -99,6 +105,8 @@ int CMarker::AddSpecificMarker(int32_t marker,uint32_t addr,uint32_t absAddr)
    m_marker [ marker ].maxCpuCycles = 0;
    m_marker [ marker ].curCpuCycles = 0;
 
+   __nescontext->edits++;
+
    return marker;
 }
 
@@ -129,6 +137,8 @@ void CMarker::CompleteMarker(int32_t marker,uint32_t addr,uint32_t absAddr)
    m_marker [ marker ].minCpuCycles = 0xFFFFFFFF;
    m_marker [ marker ].maxCpuCycles = 0;
    m_marker [ marker ].curCpuCycles = 0;
+
+   __nescontext->edits++;
 }
 
 int CMarker::FindInProgressMarker(void)
@@ -21,40 +21,17 @@
 #include "cnesios.h"
 #include "cnesio.h"
 #include "cnesapu.h"
+#include "cnesrewind.h"
+#include "cnescontext.h"
 
-int32_t  CNES::m_videoMode = MODE_NTSC;
-int32_t  CNES::m_controllerType [] = { IO_StandardJoypad, IO_Zapper };
-int32_t  CNES::m_controllerPositionX [] = { 0, };
-int32_t  CNES::m_controllerPositionY [] = { 0, };
-int32_t  CNES::m_windowX1 = 0;
-int32_t  CNES::m_windowY1 = 0;
-int32_t  CNES::m_windowX2 = 0;
-int32_t  CNES::m_windowY2 = 0;
-
-bool     CNES::m_bReplay = false;
-bool     CNES::m_bRecord = true;
-uint32_t CNES::m_frame = 0;
-
-CTracer*         CNES::m_tracer = NULL;
-
-CBreakpointInfo* CNES::m_breakpoints;
-bool            CNES::m_bBreakpointsEnabled = true;
-bool            CNES::m_bAtBreakpoint = false;
-bool            CNES::m_bStepCPUBreakpoint = false;
-bool            CNES::m_bStepPPUBreakpoint = false;
-int32_t         CNES::m_ppuCycleToStepTo = -1;
-uint32_t        CNES::m_ppuFrameToStepTo = -1;
-
-static CNES __init __attribute__((unused));
-
-CNES::CNES()
+CNES::State::State ()
 {
    m_breakpoints = new CNESBreakpointInfo();
 
    m_tracer = new CTracer();
 }
 
-CNES::~CNES()
+CNES::State::~State ()
 {
    delete m_breakpoints;
 
@@ -270,7 +247,7 @@ void CNES::RESET ( uint32_t mapper, bool soft )
    if ( nesIsDebuggable() )
    {
       // Clear execution tracer sample buffer...
-      m_tracer->ClearSampleBuffer ();
+      STATE()->m_tracer->ClearSampleBuffer ();
 
       // Zero visualizer markers...
       C6502::MARKERS()->ZeroAllMarkers();
@@ -288,30 +265,83 @@ void CNES::RESET ( uint32_t mapper, bool soft )
    // The SDL callback triggers emulation...
    C6502::RESET ( soft );
 
-   m_frame = 0;
+   STATE()->m_frame = 0;
+
+   // The rewind history can't go back past a reset.
+   CNESRewind::CLEAR ();
+}
+
+void CNES::SAVESTATE ( CNESStateWriter& writer )
+{
+   // The NES chunk holds what isn't part of any one chip: the video mode,
+   // frame count and the state of the devices on the controller ports.
+   writer.BEGIN ( "NES ", 1 );
+   writer.VALUE ( STATE()->m_videoMode );
+   writer.VALUE ( STATE()->m_frame );
+   CIO::STATEDATA ( writer );
+   CIOStandardJoypad::STATEDATA ( writer );
+   CIOTurboJoypad::STATEDATA ( writer );
+   CIOVaus::STATEDATA ( writer );
+   writer.END ();
+
+   C6502::SAVESTATE ( writer );
+   CPPU::SAVESTATE ( writer );
+   CAPU::SAVESTATE ( writer );
+   CROM::SAVESTATE ( writer );
+}
+
+bool CNES::LOADSTATE ( CNESStateReader& reader )
+{
+   uint16_t version;
+
+   // The cartridge goes first so a state from another game is turned
+   // away before anything has been changed.
+   if ( !CROM::LOADSTATE(reader) )
+   {
+      return false;
+   }
+
+   if ( (!reader.FIND("NES ",&version)) || (version != 1) )
+   {
+      return false;
+   }
+   reader.VALUE ( STATE()->m_videoMode );
+   reader.VALUE ( STATE()->m_frame );
+   CIO::STATEDATA ( reader );
+   CIOStandardJoypad::STATEDATA ( reader );
+   CIOTurboJoypad::STATEDATA ( reader );
+   CIOVaus::STATEDATA ( reader );
+   if ( !reader.GOOD() )
+   {
+      return false;
+   }
+
+   return C6502::LOADSTATE(reader) &&
+          CPPU::LOADSTATE(reader) &&
+          CAPU::LOADSTATE(reader);
 }
 
 void CNES::STEPCPUBREAKPOINT ( void )
 {
-   m_bStepCPUBreakpoint = true;
+   STATE()->m_bStepCPUBreakpoint = true;
 }
 
 void CNES::STEPPPUBREAKPOINT ( bool goFrame )
 {
-   m_bStepPPUBreakpoint = true;
+   STATE()->m_bStepPPUBreakpoint = true;
    if ( goFrame )
    {
-      m_ppuFrameToStepTo = CPPU::_FRAME()+1;
-      m_ppuCycleToStepTo = CPPU::_CYCLES();
+      STATE()->m_ppuFrameToStepTo = CPPU::_FRAME()+1;
+      STATE()->m_ppuCycleToStepTo = CPPU::_CYCLES();
    }
    else
    {
-      m_ppuFrameToStepTo = -1;
-      m_ppuCycleToStepTo = -1;
+      STATE()->m_ppuFrameToStepTo = -1;
+      STATE()->m_ppuCycleToStepTo = -1;
    }
 }
 
-void CNES::CHECKBREAKPOINT ( eBreakpointTarget target, eBreakpointType type, int32_t data, int32_t event )
+void CNES::EVALUATEBREAKPOINTS ( eBreakpointTarget target, eBreakpointType type, int32_t data, int32_t event )
 {
    int32_t idx;
    BreakpointInfo* pBreakpoint;
@@ -323,30 +353,30 @@ void CNES::CHECKBREAKPOINT ( eBreakpointTarget target, eBreakpointType type, int
    bool force = false;
 
    // If stepping, break...
-   if ( (m_bStepCPUBreakpoint) &&
+   if ( (STATE()->m_bStepCPUBreakpoint) &&
         (target == eBreakInCPU) &&
         (type == eBreakOnCPUExecution) )
    {
-      m_bStepCPUBreakpoint = false;
+      STATE()->m_bStepCPUBreakpoint = false;
       force = true;
    }
-   else if ( (m_bStepPPUBreakpoint) &&
+   else if ( (STATE()->m_bStepPPUBreakpoint) &&
              (target == eBreakInPPU) &&
              (type == eBreakOnPPUCycle) &&
-             ((m_ppuCycleToStepTo == -1) ||
-             ((m_ppuCycleToStepTo == CPPU::_CYCLES()) &&
-             (m_ppuFrameToStepTo == CPPU::_FRAME()))) )
+             ((STATE()->m_ppuCycleToStepTo == -1) ||
+             ((STATE()->m_ppuCycleToStepTo == CPPU::_CYCLES()) &&
+             (STATE()->m_ppuFrameToStepTo == CPPU::_FRAME()))) )
    {
-      m_bStepPPUBreakpoint = false;
+      STATE()->m_bStepPPUBreakpoint = false;
       force = true;
    }
    // For all breakpoints...if we're not stepping...
    else
    {
-      for ( idx = 0; idx < m_breakpoints->GetNumBreakpoints(); idx++ )
+      for ( idx = 0; idx < STATE()->m_breakpoints->GetNumBreakpoints(); idx++ )
       {
          // Get breakpoint data...
-         pBreakpoint = m_breakpoints->GetBreakpoint(idx);
+         pBreakpoint = STATE()->m_breakpoints->GetBreakpoint(idx);
 
          // Not hit yet...
          pBreakpoint->hit = false;
@@ -854,10 +884,31 @@ void CNES::CHECKBREAKPOINT ( eBreakpointTarget target, eBreakpointType type, int
 
                         break;
                   }
+
+                  // A match only counts if the breakpoint's condition and
+                  // hit count agree.  Log-only breakpoints never stop the
+                  // emulator.
+                  if ( pBreakpoint->hit )
+                  {
+                     pBreakpoint->hit = STATE()->m_breakpoints->QualifyHit(idx,CNESBreakpointInfo::GetExpressionContext(),data);
+                  }
                }
             }
          }
       }
+
+      // Remember whether any breakpoint is marked as hit so the marks
+      // are cleared at the next check.  Only those that are still hit
+      // once their conditions have been checked break.
+      STATE()->m_bBreakpointHits = false;
+      for ( idx = 0; idx < STATE()->m_breakpoints->GetNumBreakpoints(); idx++ )
+      {
+         if ( STATE()->m_breakpoints->GetBreakpoint(idx)->hit )
+         {
+            STATE()->m_bBreakpointHits = true;
+         }
+      }
+      force = STATE()->m_bBreakpointHits;
    }
 
    if ( force )
@@ -866,14 +917,167 @@ void CNES::CHECKBREAKPOINT ( eBreakpointTarget target, eBreakpointType type, int
    }
 }
 
+// Marks the addresses from item1 to item2 that pass the breakpoint's
+// address mask the same way EVALUATEBREAKPOINTS does.
+static void INDEXBREAKPOINTADDRESSES ( uint8_t* map, BreakpointInfo* pBreakpoint )
+{
+   uint32_t addr;
+
+   for ( addr = pBreakpoint->item1; (addr <= pBreakpoint->item2) && (addr < MEM_64KB); addr++ )
+   {
+      if ( ((!pBreakpoint->itemMaskExclusive) && (addr&pBreakpoint->itemMask)) ||
+           ((pBreakpoint->itemMaskExclusive) && (addr&pBreakpoint->itemMask) && ((addr&(~pBreakpoint->itemMask)) == 0)) )
+      {
+         map[addr>>3] |= (1<<(addr&7));
+      }
+   }
+}
+
+static void INDEXBREAKPOINTITEM ( uint8_t* map, uint32_t item )
+{
+   map[item>>3] |= (1<<(item&7));
+}
+
+void CNES::INDEXBREAKPOINTS ( void )
+{
+   State*          pState = STATE();
+   BreakpointInfo* pBreakpoint;
+   uint32_t        types = 0;
+   uint32_t        unindexed = 0;
+   uint32_t        index;
+   int32_t         idx;
+
+   if ( pState->m_breakpointRevision == pState->m_breakpoints->GetRevision() )
+   {
+      return;
+   }
+   pState->m_breakpointRevision = pState->m_breakpoints->GetRevision();
+
+   memset ( pState->m_breakpointAddresses, 0, sizeof(pState->m_breakpointAddresses) );
+   memset ( pState->m_breakpointItems, 0, sizeof(pState->m_breakpointItems) );
+   memset ( pState->m_breakpointEvents, 0, sizeof(pState->m_breakpointEvents) );
+
+   for ( idx = 0; idx < pState->m_breakpoints->GetNumBreakpoints(); idx++ )
+   {
+      pBreakpoint = pState->m_breakpoints->GetBreakpoint(idx);
+
+      if ( !pBreakpoint->enabled )
+      {
+         continue;
+      }
+
+      // Addresses past 64KB aren't indexed.
+      if ( (pBreakpoint->itemType == eBreakpointItemAddress) &&
+           (pBreakpoint->item2 >= MEM_64KB) )
+      {
+         unindexed |= (1<<pBreakpoint->type);
+      }
+
+      // "Access" breakpoints are checked as reads and writes.
+      switch ( pBreakpoint->type )
+      {
+         case eBreakOnCPUExecution:
+            types |= (1<<eBreakOnCPUExecution);
+            INDEXBREAKPOINTADDRESSES ( pState->m_breakpointAddresses[eBreakpointMap_CPUExecution], pBreakpoint );
+            break;
+         case eBreakOnCPUMemoryAccess:
+         case eBreakOnCPUMemoryRead:
+         case eBreakOnCPUMemoryWrite:
+            if ( pBreakpoint->type != eBreakOnCPUMemoryWrite )
+            {
+               types |= (1<<eBreakOnCPUMemoryRead);
+               INDEXBREAKPOINTADDRESSES ( pState->m_breakpointAddresses[eBreakpointMap_CPURead], pBreakpoint );
+            }
+            if ( pBreakpoint->type != eBreakOnCPUMemoryRead )
+            {
+               types |= (1<<eBreakOnCPUMemoryWrite);
+               INDEXBREAKPOINTADDRESSES ( pState->m_breakpointAddresses[eBreakpointMap_CPUWrite], pBreakpoint );
+            }
+            break;
+         case eBreakOnOAMPortalAccess:
+         case eBreakOnOAMPortalRead:
+         case eBreakOnOAMPortalWrite:
+            if ( pBreakpoint->type != eBreakOnOAMPortalWrite )
+            {
+               types |= (1<<eBreakOnOAMPortalRead);
+               INDEXBREAKPOINTADDRESSES ( pState->m_breakpointAddresses[eBreakpointMap_OAMRead], pBreakpoint );
+            }
+            if ( pBreakpoint->type != eBreakOnOAMPortalRead )
+            {
+               types |= (1<<eBreakOnOAMPortalWrite);
+               INDEXBREAKPOINTADDRESSES ( pState->m_breakpointAddresses[eBreakpointMap_OAMWrite], pBreakpoint );
+            }
+            break;
+         case eBreakOnPPUFetch:
+            types |= (1<<eBreakOnPPUFetch);
+            INDEXBREAKPOINTADDRESSES ( pState->m_breakpointAddresses[eBreakpointMap_PPUFetch], pBreakpoint );
+            break;
+         case eBreakOnPPUPortalAccess:
+         case eBreakOnPPUPortalRead:
+         case eBreakOnPPUPortalWrite:
+            if ( pBreakpoint->type != eBreakOnPPUPortalWrite )
+            {
+               types |= (1<<eBreakOnPPUPortalRead);
+               INDEXBREAKPOINTADDRESSES ( pState->m_breakpointAddresses[eBreakpointMap_PPURead], pBreakpoint );
+            }
+            if ( pBreakpoint->type != eBreakOnPPUPortalRead )
+            {
+               types |= (1<<eBreakOnPPUPortalWrite);
+               INDEXBREAKPOINTADDRESSES ( pState->m_breakpointAddresses[eBreakpointMap_PPUWrite], pBreakpoint );
+            }
+            break;
+         case eBreakOnCPUState:
+         case eBreakOnPPUState:
+         case eBreakOnAPUState:
+         case eBreakOnMapperState:
+            types |= (1<<pBreakpoint->type);
+            index = pBreakpoint->item1;
+            if ( index < BREAKPOINT_INDEX_SIZE )
+            {
+               INDEXBREAKPOINTITEM ( pState->m_breakpointItems[pBreakpoint->target], index );
+            }
+            else
+            {
+               unindexed |= (1<<pBreakpoint->type);
+            }
+            break;
+         case eBreakOnCPUEvent:
+         case eBreakOnPPUEvent:
+         case eBreakOnAPUEvent:
+         case eBreakOnMapperEvent:
+            types |= (1<<pBreakpoint->type);
+            index = pBreakpoint->event;
+            if ( index < BREAKPOINT_INDEX_SIZE )
+            {
+               INDEXBREAKPOINTITEM ( pState->m_breakpointEvents[pBreakpoint->target], index );
+            }
+            else
+            {
+               unindexed |= (1<<pBreakpoint->type);
+            }
+            break;
+         default:
+            types |= (1<<pBreakpoint->type);
+            unindexed |= (1<<pBreakpoint->type);
+            break;
+      }
+   }
+
+   pState->m_breakpointTypes = types;
+   pState->m_breakpointTypesUnindexed = unindexed;
+}
+
 void CNES::FORCEBREAKPOINT ( void )
 {
-   if ( m_bBreakpointsEnabled )
+   if ( STATE()->m_bBreakpointsEnabled )
    {
-      m_bAtBreakpoint = true;
+      STATE()->m_bAtBreakpoint = true;
 
       // Hook back to IDE to force it to update...
       nesBreak();
+
+      // Breakpoints may have been changed while we were stopped...
+      INDEXBREAKPOINTS();
    }
 }
 
@@ -882,11 +1086,17 @@ void CNES::RUN ( uint32_t* joy )
    uint32_t  ljoy [ NUM_CONTROLLERS ];
    JoypadLoggerInfo* pSample;
 
-   if ( m_bReplay )
+   // Take a rewind snapshot if one is due.
+   CNESRewind::FRAME ( joy );
+
+   // Pick up any changes to the breakpoints.
+   INDEXBREAKPOINTS ();
+
+   if ( STATE()->m_bReplay )
    {
-      if ( m_frame >= CIOStandardJoypad::LOGGER(0)->GetNumSamples() )
+      if ( STATE()->m_frame >= CIOStandardJoypad::LOGGER(0)->GetNumSamples() )
       {
-         m_bReplay = false;
+         STATE()->m_bReplay = false;
       }
    }
 
@@ -894,30 +1104,30 @@ void CNES::RUN ( uint32_t* joy )
    *(ljoy+CONTROLLER1) = *(joy+CONTROLLER1);
    *(ljoy+CONTROLLER2) = *(joy+CONTROLLER2);
 
-   if ( m_bRecord )
+   if ( STATE()->m_bRecord )
    {
       CIOStandardJoypad::LOGGER(0)->AddSample ( C6502::_CYCLES(), *(ljoy+CONTROLLER1) );
    }
 
-   if ( m_bRecord )
+   if ( STATE()->m_bRecord )
    {
       CIOStandardJoypad::LOGGER(1)->AddSample ( C6502::_CYCLES(), *(ljoy+CONTROLLER2) );
    }
 
    if ( CONTROLLER(0) == IO_StandardJoypad )
    {
-      if ( m_bReplay )
+      if ( STATE()->m_bReplay )
       {
-         pSample = CIOStandardJoypad::LOGGER(0)->GetSample ( m_frame );
+         pSample = CIOStandardJoypad::LOGGER(0)->GetSample ( STATE()->m_frame );
          *(ljoy+CONTROLLER1) |= (pSample->data);
       }
       CIOStandardJoypad::JOY ( CONTROLLER1, *(ljoy+CONTROLLER1) );
    }
    else if ( CONTROLLER(0) == IO_TurboJoypad )
    {
-      if ( m_bReplay )
+      if ( STATE()->m_bReplay )
       {
-         pSample = CIOTurboJoypad::LOGGER(0)->GetSample ( m_frame );
+         pSample = CIOTurboJoypad::LOGGER(0)->GetSample ( STATE()->m_frame );
          *(ljoy+CONTROLLER1) |= (pSample->data);
       }
       CIOTurboJoypad::JOY ( CONTROLLER1, *(ljoy+CONTROLLER1) );
@@ -937,18 +1147,18 @@ void CNES::RUN ( uint32_t* joy )
 
    if ( CONTROLLER(1) == IO_StandardJoypad )
    {
-      if ( m_bReplay )
+      if ( STATE()->m_bReplay )
       {
-         pSample = CIOStandardJoypad::LOGGER(1)->GetSample ( m_frame );
+         pSample = CIOStandardJoypad::LOGGER(1)->GetSample ( STATE()->m_frame );
          *(ljoy+CONTROLLER2) |= (pSample->data);
       }
       CIOStandardJoypad::JOY ( CONTROLLER2, *(ljoy+CONTROLLER2) );
    }
    else if ( CONTROLLER(1) == IO_TurboJoypad )
    {
-      if ( m_bReplay )
+      if ( STATE()->m_bReplay )
       {
-         pSample = CIOTurboJoypad::LOGGER(1)->GetSample ( m_frame );
+         pSample = CIOTurboJoypad::LOGGER(1)->GetSample ( STATE()->m_frame );
          *(ljoy+CONTROLLER2) |= (pSample->data);
       }
       CIOTurboJoypad::JOY ( CONTROLLER2, *(ljoy+CONTROLLER2) );
@@ -966,21 +1176,39 @@ void CNES::RUN ( uint32_t* joy )
       CIOStandardJoypad::JOY ( CONTROLLER2, 0x00 );
    }
 
+   // Run the frame with the debugger hooks compiled in only if they
+   // are needed.  Debug mode can't change in the middle of a frame.
+   if ( nesIsDebuggable() )
+   {
+      EMULATEFRAME<NESDebugHooks> ();
+   }
+   else
+   {
+      EMULATEFRAME<NESNoDebugHooks> ();
+   }
+}
+
+template <class HOOKS>
+void CNES::EMULATEFRAME ( void )
+{
    // PPU cycles repeat...
    CPPU::RESETCYCLECOUNTER ();
 
-   m_frame = CPPU::_FRAME();
+   STATE()->m_frame = CPPU::_FRAME();
 
-   if ( nesIsDebuggable() )
+   // Draw into the surface the frame queue gave back for the last frame.
+   CPPU::STARTTV ();
+
+   if ( HOOKS::ENABLED() )
    {
-      m_tracer->SetFrame ( m_frame );
+      STATE()->m_tracer->SetFrame ( STATE()->m_frame );
 
       // Emit start-of-frame indication to Tracer...
-      m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_StartPPUFrame, eNESSource_PPU, 0, 0, 0 );
+      STATE()->m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_StartPPUFrame, eNESSource_PPU, 0, 0, 0 );
    }
 
    // Do scanline processing for scanlines 0 - 239 (the screen!)...
-   CPPU::RENDERSCANLINE ( SCANLINES_VISIBLE );
+   CPPU::RENDERSCANLINE<HOOKS> ( SCANLINES_VISIBLE );
 
 #if 0
 
@@ -999,46 +1227,49 @@ void CNES::RUN ( uint32_t* joy )
 
 #endif
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Emit start-of-quiet scanline indication to Tracer...
-      m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_QuietStart, eNESSource_PPU, 0, 0, 0 );
+      STATE()->m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_QuietStart, eNESSource_PPU, 0, 0, 0 );
    }
 
    // Emulate PPU resting scanlines...
-   CPPU::QUIETSCANLINES ();
+   CPPU::QUIETSCANLINES<HOOKS> ();
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Emit end-of-quiet scanline indication to Tracer...
-      m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_QuietEnd, eNESSource_PPU, 0, 0, 0 );
+      STATE()->m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_QuietEnd, eNESSource_PPU, 0, 0, 0 );
 
       // Do VBLANK processing (scanlines 0-19 NTSC or 0-69 PAL)...
       // Emit start-VBLANK indication to Tracer...
-      m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_VBLANKStart, eNESSource_PPU, 0, 0, 0 );
+      STATE()->m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_VBLANKStart, eNESSource_PPU, 0, 0, 0 );
    }
 
    // Emulate VBLANK non-render scanlines...
-   CPPU::VBLANKSCANLINES ();
+   CPPU::VBLANKSCANLINES<HOOKS> ();
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Emit end-VBLANK indication to Tracer...
-      m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_VBLANKEnd, eNESSource_PPU, 0, 0, 0 );
+      STATE()->m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_VBLANKEnd, eNESSource_PPU, 0, 0, 0 );
 
       // Emit start-of-prerender scanline indication to Tracer...
-      m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_PreRenderStart, eNESSource_PPU, 0, 0, 0 );
+      STATE()->m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_PreRenderStart, eNESSource_PPU, 0, 0, 0 );
    }
 
    // Pre-render scanline...
-   CPPU::RENDERSCANLINE ( -1 );
+   CPPU::RENDERSCANLINE<HOOKS> ( -1 );
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Emit end-of-prerender scanline indication to Tracer...
-      m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_PreRenderEnd, eNESSource_PPU, 0, 0, 0 );
+      STATE()->m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_PreRenderEnd, eNESSource_PPU, 0, 0, 0 );
 
       // Emit end-of-frame indication to Tracer...
-      m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_EndPPUFrame, eNESSource_PPU, 0, 0, 0 );
+      STATE()->m_tracer->AddSample ( CPPU::_CYCLES(), eTracer_EndPPUFrame, eNESSource_PPU, 0, 0, 0 );
    }
+
+   // The frame is done; hand it to the UI.
+   CPPU::PUBLISHTV ();
 }
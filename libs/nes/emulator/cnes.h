@@ -4,9 +4,30 @@
 #include "ctracer.h"
 #include "cjoypadlogger.h"
 #include "cnesbreakpointinfo.h"
+#include "cnesstate.h"
 
 #include "nes_emulator_core.h"
 
+// Address maps in the breakpoint index.
+enum
+{
+   eBreakpointMap_CPUExecution = 0,
+   eBreakpointMap_CPURead,
+   eBreakpointMap_CPUWrite,
+   eBreakpointMap_OAMRead,
+   eBreakpointMap_OAMWrite,
+   eBreakpointMap_PPUFetch,
+   eBreakpointMap_PPURead,
+   eBreakpointMap_PPUWrite,
+   NUM_BREAKPOINT_MAPS
+};
+
+#define NUM_BREAKPOINT_TARGETS 4
+
+// Registers and events with indices past this are not indexed; their
+// breakpoint types are always evaluated.
+#define BREAKPOINT_INDEX_SIZE 256
+
 // The CNES class is the implementation of the NES as a complete
 // emulatable machine.  It contains a RUN method which is used
 // to drive the other objects (CPPU, C6502, CAPU, CROM) through
@@ -38,48 +59,45 @@
 class CNES
 {
 public:
-   CNES();
-   ~CNES();
-
    // Accessor methods to get/set the current video mode.
    static inline void VIDEOMODE ( int32_t mode )
    {
-      m_videoMode = mode;
+      STATE()->m_videoMode = mode;
    }
    static inline int32_t VIDEOMODE ( void )
    {
-      return m_videoMode;
+      return STATE()->m_videoMode;
    }
 
    // Accessor methods to get/set the controller type.
    static inline void CONTROLLER ( int32_t port, int32_t type )
    {
-      m_controllerType[port] = type;
+      STATE()->m_controllerType[port] = type;
    }
    static inline int32_t CONTROLLER ( int32_t port )
    {
-      return m_controllerType[port];
+      return STATE()->m_controllerType[port];
    }
 
    // Accessor method to set the controller's screen coordinates
    // for controllers that are screen-relative such as Zapper.
    static inline void CONTROLLERPOSITION ( int32_t port, int32_t px, int32_t py, int32_t wx1, int32_t wy1, int32_t wx2, int32_t wy2 )
    {
-      m_controllerPositionX[port] = px;
-      m_controllerPositionY[port] = py;
-      m_windowX1 = wx1;
-      m_windowY1 = wy1;
-      m_windowX2 = wx2;
-      m_windowY2 = wy2;
+      STATE()->m_controllerPositionX[port] = px;
+      STATE()->m_controllerPositionY[port] = py;
+      STATE()->m_windowX1 = wx1;
+      STATE()->m_windowY1 = wy1;
+      STATE()->m_windowX2 = wx2;
+      STATE()->m_windowY2 = wy2;
    }
    static inline void CONTROLLERPOSITION ( int32_t port, int32_t* px, int32_t* py, int32_t* wx1, int32_t* wy1, int32_t* wx2, int32_t* wy2 )
    {
-      (*px) = m_controllerPositionX[port];
-      (*py) = m_controllerPositionY[port];
-      (*wx1) = m_windowX1;
-      (*wy1) = m_windowY1;
-      (*wx2) = m_windowX2;
-      (*wy2) = m_windowY2;
+      (*px) = STATE()->m_controllerPositionX[port];
+      (*py) = STATE()->m_controllerPositionY[port];
+      (*wx1) = STATE()->m_windowX1;
+      (*wy1) = STATE()->m_windowY1;
+      (*wx2) = STATE()->m_windowX2;
+      (*wy2) = STATE()->m_windowY2;
    }
 
    // This method performs a full NES reset and initializes
@@ -92,6 +110,19 @@ public:
    // intercepted keypress/keyrelease events in the UI.
    static void RUN ( uint32_t* joy );
 
+   // This method emulates the PPU frame (and the CPU and APU along
+   // with it) once RUN has fed in the joypad state.  The HOOKS policy
+   // (see cnescontext.h) decides whether the debugger support is
+   // compiled into this instantiation.
+   template <class HOOKS> static void EMULATEFRAME ( void );
+
+   // Save state support.  SAVESTATE writes a complete save state, one chunk
+   // per emulator object; LOADSTATE restores one, returning false if it is
+   // incomplete or was saved from a different cartridge.  A failed LOADSTATE
+   // may have restored some objects and not others.
+   static void SAVESTATE ( CNESStateWriter& writer );
+   static bool LOADSTATE ( CNESStateReader& reader );
+
    // Accessor methods to get/set whether or not the emulation
    // engine is in replay mode.  In replay mode the emulation runs
    // as normal but the joypad inputs are fed in from previously
@@ -99,11 +130,11 @@ public:
    // for emulation runs that start from NES reset.
    static void REPLAY ( bool enable )
    {
-      m_bReplay = enable;
+      STATE()->m_bReplay = enable;
    }
    static bool REPLAY ()
    {
-      return m_bReplay;
+      return STATE()->m_bReplay;
    }
 
    // Accessor methods to get/set whether or not the emulation
@@ -112,18 +143,18 @@ public:
    // the REPLAY API.
    static void RECORD ( bool enable )
    {
-      m_bRecord = enable;
+      STATE()->m_bRecord = enable;
    }
    static bool RECORD ()
    {
-      return m_bRecord;
+      return STATE()->m_bRecord;
    }
 
    // Accessor method to retrieve the NES object's frame counter.
    // This is used by some debugger inspectors.
    static uint32_t FRAME ()
    {
-      return m_frame;
+      return STATE()->m_frame;
    }
 
    // Accessor method to retrieve the execution tracer database.  Other
@@ -131,14 +162,15 @@ public:
    // during emulation.
    static inline CTracer* TRACER ( void )
    {
-      return m_tracer;
+      return STATE()->m_tracer;
    }
 
    // This method globally enables or disables breakpoints.  It is used
    // during an emulation hard-reset (which is caused whenever a new
    // ROM image is loaded) to prevent the emulation engine from getting
    // hung up on a set breakpoint during the ROM image switchover.
-   static void BREAKPOINTS ( bool enable ) { m_bBreakpointsEnabled = enable; }
+   static void BREAKPOINTS ( bool enable ) { STATE()->m_bBreakpointsEnabled = enable; }
+   static bool BREAKPOINTSENABLED ( void ) { return STATE()->m_bBreakpointsEnabled; }
 
    // This method retrieves the database of currently active breakpoints.
    // It is used by the debugger inspectors to determine whether or not
@@ -146,13 +178,25 @@ public:
    // It is also used by the NES object in evaluating breakpoints for hits.
    static CBreakpointInfo* BREAKPOINTS ( void )
    {
-      return m_breakpoints;
+      return STATE()->m_breakpoints;
    }
 
    // This method is invoked by objects within the emulation engine (CNES,
    // C6502, CPPU, CAPU, CROM) to allow the emulation engine to halt itself
-   // if a breakpoint is encountered.
-   static void CHECKBREAKPOINT ( eBreakpointTarget target, eBreakpointType type = (eBreakpointType)-1, int32_t data = 0, int32_t event = 0 );
+   // if a breakpoint is encountered.  It is called for nearly every cycle
+   // so it only looks the address, register or event up in the breakpoint
+   // index built by INDEXBREAKPOINTS.  Only if a breakpoint could be hit
+   // does EVALUATEBREAKPOINTS go through the breakpoints one by one.  It
+   // is defined in cnescontext.h because it needs the CPU and PPU.
+   static inline void CHECKBREAKPOINT ( eBreakpointTarget target, eBreakpointType type = (eBreakpointType)-1, int32_t data = 0, int32_t event = 0 );
+   static void EVALUATEBREAKPOINTS ( eBreakpointTarget target, eBreakpointType type, int32_t data, int32_t event );
+
+   // Rebuilds the breakpoint index if the breakpoint database has changed
+   // since it was last built.  This is done at the start of each frame, on
+   // the way out of a breakpoint and, with the debugger hooks in, at the
+   // start of every rendered scanline, so breakpoints changed while the
+   // emulator runs take effect part way through the frame.
+   static void INDEXBREAKPOINTS ( void );
 
    // This method forces the emulation engine into breakpoint territory;
    // the emulation is halted, a breakpoint-watching thread is released,
@@ -163,11 +207,11 @@ public:
    // whether or not the machine is currently at a breakpoint.
    static bool ATBREAKPOINT ( void )
    {
-      return m_bAtBreakpoint;
+      return STATE()->m_bAtBreakpoint;
    }
    static void CLEARBREAKPOINT ( void )
    {
-      m_bAtBreakpoint = false;
+      STATE()->m_bAtBreakpoint = false;
    }
 
    // These methods set a flag within the NES object indicating that a
@@ -194,44 +238,68 @@ public:
    static void PRINTABLEADDR ( char* buffer, uint32_t addr, uint32_t absAddr );
 
 protected:
-   // Whether or not joypad input is being fed from the user or from
-   // previously recorded emulation runs.
-   static bool         m_bReplay;
-
-   // Whether or not joypad input is being recorded during this emulation run.
-   static bool         m_bRecord;
-
-   // NTSC, or PAL?
-   static int32_t             m_videoMode;
-
-   // Controller type information
-   static int32_t  m_controllerType [ NUM_CONTROLLERS ];
-
-   // Controller screen position information (for things like zapper)
-   static int32_t  m_controllerPositionX [ NUM_CONTROLLERS ];
-   static int32_t  m_controllerPositionY [ NUM_CONTROLLERS ];
-   static int32_t  m_windowX1;
-   static int32_t  m_windowY1;
-   static int32_t  m_windowX2;
-   static int32_t  m_windowY2;
-
-   // The execution tracer database.
-   static CTracer*         m_tracer;
-
-   // This is the database of active breakpoints.
-   static CBreakpointInfo* m_breakpoints;
-   static bool m_bBreakpointsEnabled;
-
-   // These flags determine the breakpoint state and behavior
-   // of the emulation engine.
-   static bool            m_bAtBreakpoint;
-   static bool            m_bStepCPUBreakpoint;
-   static bool            m_bStepPPUBreakpoint;
-   static int32_t         m_ppuCycleToStepTo;
-   static uint32_t        m_ppuFrameToStepTo;
-
-   // Emulation frame counter...a copy of CPPU::m_frame;
-   static uint32_t m_frame;
+   friend struct NESContext;
+   struct State
+   {
+      State ();
+      ~State ();
+
+      // Whether or not joypad input is being fed from the user or from
+      // previously recorded emulation runs.
+      bool         m_bReplay = false;
+
+      // Whether or not joypad input is being recorded during this emulation run.
+      bool         m_bRecord = true;
+
+      // NTSC, or PAL?
+      int32_t             m_videoMode = MODE_NTSC;
+
+      // Controller type information
+      int32_t  m_controllerType [ NUM_CONTROLLERS ] = { IO_StandardJoypad, IO_Zapper };
+
+      // Controller screen position information (for things like zapper)
+      int32_t  m_controllerPositionX [ NUM_CONTROLLERS ] = { 0, };
+      int32_t  m_controllerPositionY [ NUM_CONTROLLERS ] = { 0, };
+      int32_t  m_windowX1 = 0;
+      int32_t  m_windowY1 = 0;
+      int32_t  m_windowX2 = 0;
+      int32_t  m_windowY2 = 0;
+
+      // The execution tracer database.
+      CTracer*         m_tracer = NULL;
+
+      // This is the database of active breakpoints.
+      CBreakpointInfo* m_breakpoints = NULL;
+      bool m_bBreakpointsEnabled = true;
+
+      // These flags determine the breakpoint state and behavior
+      // of the emulation engine.
+      bool            m_bAtBreakpoint = false;
+      bool            m_bStepCPUBreakpoint = false;
+      bool            m_bStepPPUBreakpoint = false;
+      int32_t         m_ppuCycleToStepTo = -1;
+      uint32_t        m_ppuFrameToStepTo = -1;
+
+      // The breakpoint index.  m_breakpointTypes has a bit for each
+      // breakpoint type with an enabled breakpoint.  The address maps
+      // have a bit for each address an address breakpoint could hit at;
+      // the item and event maps a bit for each register and event index
+      // with a breakpoint on it, per target.  Types in
+      // m_breakpointTypesUnindexed are always evaluated.  m_bBreakpointHits
+      // is set while any breakpoint is marked as hit; the next check
+      // evaluates the breakpoints to clear the marks.
+      uint32_t        m_breakpointRevision = 0;
+      uint32_t        m_breakpointTypes = 0;
+      uint32_t        m_breakpointTypesUnindexed = 0;
+      bool            m_bBreakpointHits = false;
+      uint8_t         m_breakpointAddresses [ NUM_BREAKPOINT_MAPS ][ MEM_64KB>>3 ] = { { 0, }, };
+      uint8_t         m_breakpointItems [ NUM_BREAKPOINT_TARGETS ][ BREAKPOINT_INDEX_SIZE>>3 ] = { { 0, }, };
+      uint8_t         m_breakpointEvents [ NUM_BREAKPOINT_TARGETS ][ BREAKPOINT_INDEX_SIZE>>3 ] = { { 0, }, };
+
+      // Emulation frame counter...a copy of CPPU::m_frame;
+      uint32_t m_frame = 0;
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -23,6 +23,7 @@
 #include "cnesmappers.h"
 
 #include "nes_emulator_core.h"
+#include "cnescontext.h"
 
 // CPU Registers
 static CBitfieldData* tblCPUPCBitfields [] =
@@ -161,55 +162,6 @@ static CBreakpointEventInfo* tblCPUEvents [] =
 CBreakpointEventInfo** C6502::m_tblBreakpointEvents = tblCPUEvents;
 int32_t                C6502::m_numBreakpointEvents = NUM_CPU_EVENTS;
 
-bool            C6502::m_killed = false;              // KIL opcode not executed.
-bool            C6502::m_breakOnKIL = false;          // IDE sets this for us.
-bool            C6502::m_irqAsserted = false;
-int32_t         C6502::m_instrCycle = 0;
-bool            C6502::m_irqPending = false;
-bool            C6502::m_nmiAsserted = false;
-bool            C6502::m_nmiPending = false;
-uint8_t         C6502::m_openBusData = 0x00;
-uint8_t*  C6502::m_6502memory = NULL;
-uint8_t   C6502::m_a = 0x00;
-uint8_t   C6502::m_x = 0x00;
-uint8_t   C6502::m_y = 0x00;
-uint8_t   C6502::m_f = FLAG_MISC;
-uint16_t  C6502::m_pc = VECTOR_RESET;
-uint16_t  C6502::m_pcSync = VECTOR_RESET;
-bool      C6502::m_pcSyncSet = false;
-uint32_t    C6502::m_ea = 0;
-uint32_t            C6502::m_pcGoto = 0xFFFFFFFF;
-uint8_t   C6502::m_sp = 0x00;
-
-uint32_t    C6502::m_cycles = 0;
-int32_t         C6502::m_curCycles = 0;
-
-uint16_t C6502::m_writeDmaAddr = 0x0000;
-int32_t  C6502::m_writeDmaCounter = 0;
-uint16_t C6502::m_readDmaAddr = 0x0000;
-int32_t     C6502::m_dmaRequest = -1;
-int32_t  C6502::m_readDmaCounter = 0;
-
-int32_t         C6502::amode;
-uint8_t*  C6502::data = NULL;
-uint8_t   C6502::opcodeData [ 4 ]; // 3 opcode bytes and 1 byte for operand return data [extra cycle]
-struct _CNES6502_opcode* C6502::pOpcodeStruct = NULL;
-int32_t         C6502::opcodeSize;
-bool            C6502::m_write = false;
-int8_t            C6502::m_phase = 0;
-
-TracerInfo*      C6502::pDisassemblySample = NULL;
-
-CMarker*         C6502::m_marker = NULL;
-
-CCodeDataLogger* C6502::m_logger = NULL;
-
-uint8_t*   C6502::m_RAMopcodeMask = NULL;
-char**     C6502::m_RAMdisassembly = NULL;
-uint16_t*  C6502::m_RAMsloc2addr = NULL;
-uint16_t*  C6502::m_RAMaddr2sloc = NULL;
-uint32_t   C6502::m_RAMsloc = 0;
-
 static int32_t opcode_size [ NUM_ADDRESSING_MODES ] =
 {
    1, // AM_IMPLIED
@@ -244,297 +196,339 @@ static const char* operandFmt [ NUM_ADDRESSING_MODES ] =
    " $%02X"  // AM_RELATIVE
 };
 
-static CNES6502_opcode m_6502opcode [ 256 ] =
+// The text around the operand of each addressing mode, for the runtime
+// disassembler to build instructions with without going through sprintf.
+static const char* operandPrefix [ NUM_ADDRESSING_MODES ] =
+{
+   "", // AM_IMPLIED
+   " #$", // AM_IMMEDIATE
+   " $", // AM_ABSOLUTE
+   " $", // AM_ZEROPAGE
+   "", // AM_ACCUMULATOR
+   " $", // AM_ABSOLUTE_INDEXED_X
+   " $", // AM_ABSOLUTE_INDEXED_Y
+   " $", // AM_ZEROPAGE_INDEXED_X
+   " $", // AM_ZEROPAGE_INDEXED_Y
+   " ($", // AM_INDIRECT
+   " ($", // AM_PREINDEXED_INDIRECT
+   " ($", // AM_POSTINDEXED_INDIRECT
+   " $"  // AM_RELATIVE
+};
+
+static const char* operandSuffix [ NUM_ADDRESSING_MODES ] =
 {
-   { 0x00, "BRK", C6502::BRK, AM_IMPLIED, 7, true, false, 0x0 }, // BRK
-   { 0x01, "ORA", C6502::ORA, AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // ORA - (Indirect,X)
-   { 0x02, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0x03, "ASO", C6502::ASO, AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // ASO - (Indirect,X) (undocumented)
-   { 0x04, "DOP", C6502::DOP, AM_ZEROPAGE, 3, false, false, 0x4 }, // DOP (undocumented)
-   { 0x05, "ORA", C6502::ORA, AM_ZEROPAGE, 3, true, false, 0x4 }, // ORA - Zero Page
-   { 0x06, "ASL", C6502::ASL, AM_ZEROPAGE, 5, true, false, 0x10 }, // ASL - Zero Page
-   { 0x07, "ASO", C6502::ASO, AM_ZEROPAGE, 5, false, false, 0x10 }, // ASO - Zero Page (undocumented)
-   { 0x08, "PHP", C6502::PHP, AM_IMPLIED, 3, true, false, 0x4 }, // PHP
-   { 0x09, "ORA", C6502::ORA, AM_IMMEDIATE, 2, true, false, 0x2 }, // ORA - Immediate
-   { 0x0A, "ASL", C6502::ASL, AM_ACCUMULATOR, 2, true, false, 0x2 }, // ASL - Accumulator
-   { 0x0B, "ANC", C6502::ANC, AM_IMMEDIATE, 2, false, false, 0x2 }, // ANC - Immediate (undocumented)
-   { 0x0C, "TOP", C6502::TOP, AM_ABSOLUTE, 4, false, false, 0x8 }, // TOP (undocumented)
-   { 0x0D, "ORA", C6502::ORA, AM_ABSOLUTE, 4, true, false, 0x8 }, // ORA - Absolute
-   { 0x0E, "ASL", C6502::ASL, AM_ABSOLUTE, 6, true, false, 0x20 }, // ASL - Absolute
-   { 0x0F, "ASO", C6502::ASO, AM_ABSOLUTE, 6, false, false, 0x20 }, // ASO - Absolute (undocumented)
-   { 0x10, "BPL", C6502::BPL, AM_RELATIVE, 2, true, false, 0xA }, // BPL
-   { 0x11, "ORA", C6502::ORA, AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // ORA - (Indirect),Y
-   { 0x12, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0x13, "ASO", C6502::ASO, AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // ASO - (Indirect),Y (undocumented)
-   { 0x14, "DOP", C6502::DOP, AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
-   { 0x15, "ORA", C6502::ORA, AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // ORA - Zero Page,X
-   { 0x16, "ASL", C6502::ASL, AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // ASL - Zero Page,X
-   { 0x17, "ASO", C6502::ASO, AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // ASO - Zero Page,X (undocumented)
-   { 0x18, "CLC", C6502::CLC, AM_IMPLIED, 2, true, false, 0x2 }, // CLC
-   { 0x19, "ORA", C6502::ORA, AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // ORA - Absolute,Y
-   { 0x1A, "NOP", C6502::NOP, AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
-   { 0x1B, "ASO", C6502::ASO, AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // ASO - Absolute,Y (undocumented)
-   { 0x1C, "TOP", C6502::TOP, AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
-   { 0x1D, "ORA", C6502::ORA, AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // ORA - Absolute,X
-   { 0x1E, "ASL", C6502::ASL, AM_ABSOLUTE_INDEXED_X, 7, true, true, 0x40 }, // ASL - Absolute,X
-   { 0x1F, "ASO", C6502::ASO, AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }, // ASO - Absolute,X (undocumented)
-   { 0x20, "JSR", C6502::JSR, AM_ABSOLUTE, 6, true, false, 0x20 }, // JSR
-   { 0x21, "AND", C6502::AND, AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // AND - (Indirect,X)
-   { 0x22, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0x23, "RLA", C6502::RLA, AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // RLA - (Indirect,X) (undocumented)
-   { 0x24, "BIT", C6502::BIT, AM_ZEROPAGE, 3, true, false, 0x4 }, // BIT - Zero Page
-   { 0x25, "AND", C6502::AND, AM_ZEROPAGE, 3, true, false, 0x4 }, // AND - Zero Page
-   { 0x26, "ROL", C6502::ROL, AM_ZEROPAGE, 5, true, false, 0x10 }, // ROL - Zero Page
-   { 0x27, "RLA", C6502::RLA, AM_ZEROPAGE, 5, false, false, 0x10 }, // RLA - Zero Page (undocumented)
-   { 0x28, "PLP", C6502::PLP, AM_IMPLIED, 4, true, false, 0x8 }, // PLP
-   { 0x29, "AND", C6502::AND, AM_IMMEDIATE, 2, true, false, 0x2 }, // AND - Immediate
-   { 0x2A, "ROL", C6502::ROL, AM_ACCUMULATOR, 2, true, false, 0x2 }, // ROL - Accumulator
-   { 0x2B, "ANC", C6502::ANC, AM_IMMEDIATE, 2, false, false, 0x2 }, // ANC - Immediate (undocumented)
-   { 0x2C, "BIT", C6502::BIT, AM_ABSOLUTE, 4, true, false, 0x8 }, // BIT - Absolute
-   { 0x2D, "AND", C6502::AND, AM_ABSOLUTE, 4, true, false, 0x8 }, // AND - Absolute
-   { 0x2E, "ROL", C6502::ROL, AM_ABSOLUTE, 6, true, false, 0x20 }, // ROL - Absolute
-   { 0x2F, "RLA", C6502::RLA, AM_ABSOLUTE, 6, false, false, 0x20 }, // RLA - Absolute (undocumented)
-   { 0x30, "BMI", C6502::BMI, AM_RELATIVE, 2, true, false, 0x2 }, // BMI
-   { 0x31, "AND", C6502::AND, AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // AND - (Indirect),Y
-   { 0x32, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0x33, "RLA", C6502::RLA, AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // RLA - (Indirect),Y (undocumented)
-   { 0x34, "DOP", C6502::DOP, AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
-   { 0x35, "AND", C6502::AND, AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // AND - Zero Page,X
-   { 0x36, "ROL", C6502::ROL, AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // ROL - Zero Page,X
-   { 0x37, "RLA", C6502::RLA, AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // RLA - Zero Page,X (undocumented)
-   { 0x38, "SEC", C6502::SEC, AM_IMPLIED, 2, true, false, 0x2 }, // SEC
-   { 0x39, "AND", C6502::AND, AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // AND - Absolute,Y
-   { 0x3A, "NOP", C6502::NOP, AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
-   { 0x3B, "RLA", C6502::RLA, AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // RLA - Absolute,Y (undocumented)
-   { 0x3C, "TOP", C6502::TOP, AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
-   { 0x3D, "AND", C6502::AND, AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // AND - Absolute,X
-   { 0x3E, "ROL", C6502::ROL, AM_ABSOLUTE_INDEXED_X, 7, true, false, 0x40 }, // ROL - Absolute,X
-   { 0x3F, "RLA", C6502::RLA, AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }, // RLA - Absolute,X (undocumented)
-   { 0x40, "RTI", C6502::RTI, AM_IMPLIED, 6, true, false, 0x20 }, // RTI
-   { 0x41, "EOR", C6502::EOR, AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // EOR - (Indirect,X)
-   { 0x42, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0x43, "LSE", C6502::LSE, AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // LSE - (Indirect,X) (undocumented)
-   { 0x44, "DOP", C6502::DOP, AM_ZEROPAGE, 3, false, false, 0x4 }, // DOP (undocumented)
-   { 0x45, "EOR", C6502::EOR, AM_ZEROPAGE, 3, true, false, 0x4 }, // EOR - Zero Page
-   { 0x46, "LSR", C6502::LSR, AM_ZEROPAGE, 5, true, false, 0x10 }, // LSR - Zero Page
-   { 0x47, "LSE", C6502::LSE, AM_ZEROPAGE, 5, false, false, 0x10 }, // LSE - Zero Page (undocumented)
-   { 0x48, "PHA", C6502::PHA, AM_IMPLIED, 3, true, false, 0x4 }, // PHA
-   { 0x49, "EOR", C6502::EOR, AM_IMMEDIATE, 2, true, false, 0x2 }, // EOR - Immediate
-   { 0x4A, "LSR", C6502::LSR, AM_ACCUMULATOR, 2, true, false, 0x2 }, // LSR - Accumulator
-   { 0x4B, "ALR", C6502::ALR, AM_IMMEDIATE, 2, false, false, 0x2 }, // ALR - Immediate (undocumented)
-   { 0x4C, "JMP", C6502::JMP, AM_ABSOLUTE, 3, true, false, 0x4 }, // JMP - Absolute
-   { 0x4D, "EOR", C6502::EOR, AM_ABSOLUTE, 4, true, false, 0x8 }, // EOR - Absolute
-   { 0x4E, "LSR", C6502::LSR, AM_ABSOLUTE, 6, true, false, 0x20 }, // LSR - Absolute
-   { 0x4F, "LSE", C6502::LSE, AM_ABSOLUTE, 6, false, false, 0x20 }, // LSE - Absolute (undocumented)
-   { 0x50, "BVC", C6502::BVC, AM_RELATIVE, 2, true, false, 0xA }, // BVC
-   { 0x51, "EOR", C6502::EOR, AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // EOR - (Indirect),Y
-   { 0x52, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0x53, "LSE", C6502::LSE, AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // LSE - (Indirect),Y
-   { 0x54, "DOP", C6502::DOP, AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
-   { 0x55, "EOR", C6502::EOR, AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // EOR - Zero Page,X
-   { 0x56, "LSR", C6502::LSR, AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // LSR - Zero Page,X
-   { 0x57, "LSE", C6502::LSE, AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // LSE - Zero Page,X (undocumented)
-   { 0x58, "CLI", C6502::CLI, AM_IMPLIED, 2, true, false, 0x2 }, // CLI
-   { 0x59, "EOR", C6502::EOR, AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // EOR - Absolute,Y
-   { 0x5A, "NOP", C6502::NOP, AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
-   { 0x5B, "LSE", C6502::LSE, AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // LSE - Absolute,Y (undocumented)
-   { 0x5C, "TOP", C6502::TOP, AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
-   { 0x5D, "EOR", C6502::EOR, AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // EOR - Absolute,X
-   { 0x5E, "LSR", C6502::LSR, AM_ABSOLUTE_INDEXED_X, 7, true, true, 0x40 }, // LSR - Absolute,X
-   { 0x5F, "LSE", C6502::LSE, AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }, // LSE - Absolute,X (undocumented)
-   { 0x60, "RTS", C6502::RTS, AM_IMPLIED, 6, true, false, 0x20 }, // RTS
-   { 0x61, "ADC", C6502::ADC, AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // ADC - (Indirect,X)
-   { 0x62, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0x63, "RRA", C6502::RRA, AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // RRA - (Indirect,X) (undocumented)
-   { 0x64, "DOP", C6502::DOP, AM_ZEROPAGE, 3, false, false, 0x4 }, // DOP (undocumented)
-   { 0x65, "ADC", C6502::ADC, AM_ZEROPAGE, 3, true, false, 0x4 }, // ADC - Zero Page
-   { 0x66, "ROR", C6502::ROR, AM_ZEROPAGE, 5, true, false, 0x10 }, // ROR - Zero Page
-   { 0x67, "RRA", C6502::RRA, AM_ZEROPAGE, 5, false, false, 0x10 }, // RRA - Zero Page (undocumented)
-   { 0x68, "PLA", C6502::PLA, AM_IMPLIED, 4, true, false, 0x8 }, // PLA
-   { 0x69, "ADC", C6502::ADC, AM_IMMEDIATE, 2, true, false, 0x2 }, // ADC - Immediate
-   { 0x6A, "ROR", C6502::ROR, AM_ACCUMULATOR, 2, true, false, 0x2 }, // ROR - Accumulator
-   { 0x6B, "ARR", C6502::ARR, AM_IMMEDIATE, 2, false, false, 0x2 }, // ARR - Immediate (undocumented)
-   { 0x6C, "JMP", C6502::JMP, AM_INDIRECT, 5, true, false, 0x10 }, // JMP - Indirect
-   { 0x6D, "ADC", C6502::ADC, AM_ABSOLUTE, 4, true, false, 0x8 }, // ADC - Absolute
-   { 0x6E, "ROR", C6502::ROR, AM_ABSOLUTE, 6, true, false, 0x20 }, // ROR - Absolute
-   { 0x6F, "RRA", C6502::RRA, AM_ABSOLUTE, 6, false, false, 0x20 }, // RRA - Absolute (undocumented)
-   { 0x70, "BVS", C6502::BVS, AM_RELATIVE, 2, true, false, 0xA }, // BVS
-   { 0x71, "ADC", C6502::ADC, AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // ADC - (Indirect),Y
-   { 0x72, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0x73, "RRA", C6502::RRA, AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // RRA - (Indirect),Y (undocumented)
-   { 0x74, "DOP", C6502::DOP, AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
-   { 0x75, "ADC", C6502::ADC, AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // ADC - Zero Page,X
-   { 0x76, "ROR", C6502::ROR, AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // ROR - Zero Page,X
-   { 0x77, "RRA", C6502::RRA, AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // RRA - Zero Page,X (undocumented)
-   { 0x78, "SEI", C6502::SEI, AM_IMPLIED, 2, true, false, 0x2 }, // SEI
-   { 0x79, "ADC", C6502::ADC, AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // ADC - Absolute,Y
-   { 0x7A, "NOP", C6502::NOP, AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
-   { 0x7B, "RRA", C6502::RRA, AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // RRA - Absolute,Y (undocumented)
-   { 0x7C, "TOP", C6502::TOP, AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
-   { 0x7D, "ADC", C6502::ADC, AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // ADC - Absolute,X
-   { 0x7E, "ROR", C6502::ROR, AM_ABSOLUTE_INDEXED_X, 7, true, true, 0x40 }, // ROR - Absolute,X
-   { 0x7F, "RRA", C6502::RRA, AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }, // RRA - Absolute,X (undocumented)
-   { 0x80, "DOP", C6502::DOP, AM_IMMEDIATE, 2, false, false, 0x2 }, // DOP (undocumented)
-   { 0x81, "STA", C6502::STA, AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // STA - (Indirect,X)
-   { 0x82, "DOP", C6502::DOP, AM_IMMEDIATE, 2, false, false, 0x2 }, // DOP (undocumented)
-   { 0x83, "AXS", C6502::AXS, AM_PREINDEXED_INDIRECT, 6, false, false, 0x20 }, // AXS - (Indirect,X) (undocumented)
-   { 0x84, "STY", C6502::STY, AM_ZEROPAGE, 3, true, false, 0x4 }, // STY - Zero Page
-   { 0x85, "STA", C6502::STA, AM_ZEROPAGE, 3, true, false, 0x4 }, // STA - Zero Page
-   { 0x86, "STX", C6502::STX, AM_ZEROPAGE, 3, true, false, 0x4 }, // STX - Zero Page
-   { 0x87, "AXS", C6502::AXS, AM_ZEROPAGE, 3, false, false, 0x4 }, // AXS - Zero Page (undocumented)
-   { 0x88, "DEY", C6502::DEY, AM_IMPLIED, 2, true, false, 0x2 }, // DEY
-   { 0x89, "DOP", C6502::DOP, AM_IMMEDIATE, 2, false, false, 0x2 }, // DOP (undocumented)
-   { 0x8A, "TXA", C6502::TXA, AM_IMPLIED, 2, true, false, 0x2 }, // TXA
-   { 0x8B, "XAA", C6502::XAA, AM_IMMEDIATE, 2, false, false, 0x2 }, // XAA - Immediate (undocumented)
-   { 0x8C, "STY", C6502::STY, AM_ABSOLUTE, 4, true, false, 0x8 }, // STY - Absolute
-   { 0x8D, "STA", C6502::STA, AM_ABSOLUTE, 4, true, false, 0x8 }, // STA - Absolute
-   { 0x8E, "STX", C6502::STX, AM_ABSOLUTE, 4, true, false, 0x8 }, // STX - Absolute
-   { 0x8F, "AXS", C6502::AXS, AM_ABSOLUTE, 4, false, false, 0x8 }, // AXS - Absolulte (undocumented)
-   { 0x90, "BCC", C6502::BCC, AM_RELATIVE, 2, true, false, 0xA }, // BCC
-   { 0x91, "STA", C6502::STA, AM_POSTINDEXED_INDIRECT, 6, true, true, 0x20 }, // STA - (Indirect),Y
-   { 0x92, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0x93, "AXA", C6502::AXA, AM_POSTINDEXED_INDIRECT, 6, false, true, 0x20 }, // AXA - (Indirect),Y
-   { 0x94, "STY", C6502::STY, AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // STY - Zero Page,X
-   { 0x95, "STA", C6502::STA, AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // STA - Zero Page,X
-   { 0x96, "STX", C6502::STX, AM_ZEROPAGE_INDEXED_Y, 4, true, false, 0x8 }, // STX - Zero Page,Y
-   { 0x97, "AXS", C6502::AXS, AM_ZEROPAGE_INDEXED_Y, 4, false, false, 0x8 }, // AXS - Zero Page,Y
-   { 0x98, "TYA", C6502::TYA, AM_IMPLIED, 2, true, false, 0x2 }, // TYA
-   { 0x99, "STA", C6502::STA, AM_ABSOLUTE_INDEXED_Y, 5, true, true, 0x10 }, // STA - Absolute,Y
-   { 0x9A, "TXS", C6502::TXS, AM_IMPLIED, 2, true, false, 0x2 }, // TXS
-   { 0x9B, "TAS", C6502::TAS, AM_ABSOLUTE_INDEXED_Y, 5, false, true, 0x10 }, // TAS - Absolute,Y (undocumented)
-   { 0x9C, "SAY", C6502::SAY, AM_ABSOLUTE_INDEXED_X, 5, false, true, 0x10 }, // SAY - Absolute,X (undocumented)
-   { 0x9D, "STA", C6502::STA, AM_ABSOLUTE_INDEXED_X, 5, true, true, 0x10 }, // STA - Absolute,X
-   { 0x9E, "XAS", C6502::XAS, AM_ABSOLUTE_INDEXED_Y, 5, false, true, 0x10 }, // XAS - Absolute,Y (undocumented)
-   { 0x9F, "AXA", C6502::AXA, AM_ABSOLUTE_INDEXED_Y, 5, false, true, 0x10 }, // AXA - Absolute,Y (undocumented)
-   { 0xA0, "LDY", C6502::LDY, AM_IMMEDIATE, 2, true, false, 0x2 }, // LDY - Immediate
-   { 0xA1, "LDA", C6502::LDA, AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // LDA - (Indirect,X)
-   { 0xA2, "LDX", C6502::LDX, AM_IMMEDIATE, 2, true, false, 0x2 }, // LDX - Immediate
-   { 0xA3, "LAX", C6502::LAX, AM_PREINDEXED_INDIRECT, 6, false, false, 0x20 }, // LAX - (Indirect,X) (undocumented)
-   { 0xA4, "LDY", C6502::LDY, AM_ZEROPAGE, 3, true, false, 0x4 }, // LDY - Zero Page
-   { 0xA5, "LDA", C6502::LDA, AM_ZEROPAGE, 3, true, false, 0x4 }, // LDA - Zero Page
-   { 0xA6, "LDX", C6502::LDX, AM_ZEROPAGE, 3, true, false, 0x4 }, // LDX - Zero Page
-   { 0xA7, "LAX", C6502::LAX, AM_ZEROPAGE, 3, false, false, 0x4 }, // LAX - Zero Page (undocumented)
-   { 0xA8, "TAY", C6502::TAY, AM_IMPLIED, 2, true, false, 0x2 }, // TAY
-   { 0xA9, "LDA", C6502::LDA, AM_IMMEDIATE, 2, true, false, 0x2 }, // LDA - Immediate
-   { 0xAA, "TAX", C6502::TAX, AM_IMPLIED, 2, true, false, 0x2 }, // TAX
-   { 0xAB, "OAL", C6502::OAL, AM_IMMEDIATE, 2, false, false, 0x2 }, // OAL - Immediate
-   { 0xAC, "LDY", C6502::LDY, AM_ABSOLUTE, 4, true, false, 0x8 }, // LDY - Absolute
-   { 0xAD, "LDA", C6502::LDA, AM_ABSOLUTE, 4, true, false, 0x8 }, // LDA - Absolute
-   { 0xAE, "LDX", C6502::LDX, AM_ABSOLUTE, 4, true, false, 0x8 }, // LDX - Absolute
-   { 0xAF, "LAX", C6502::LAX, AM_ABSOLUTE, 4, false, false, 0x8 }, // LAX - Absolute (undocumented)
-   { 0xB0, "BCS", C6502::BCS, AM_RELATIVE, 2, true, false, 0xA }, // BCS
-   { 0xB1, "LDA", C6502::LDA, AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // LDA - (Indirect),Y
-   { 0xB2, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0xB3, "LAX", C6502::LAX, AM_POSTINDEXED_INDIRECT, 5, false, false, 0x10 }, // LAX - (Indirect),Y (undocumented)
-   { 0xB4, "LDY", C6502::LDY, AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // LDY - Zero Page,X
-   { 0xB5, "LDA", C6502::LDA, AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // LDA - Zero Page,X
-   { 0xB6, "LDX", C6502::LDX, AM_ZEROPAGE_INDEXED_Y, 4, true, false, 0x8 }, // LDX - Zero Page,Y
-   { 0xB7, "LAX", C6502::LAX, AM_ZEROPAGE_INDEXED_Y, 4, false, false, 0x8 }, // LAX - Zero Page,X (undocumented)
-   { 0xB8, "CLV", C6502::CLV, AM_IMPLIED, 2, true, false, 0x2 }, // CLV
-   { 0xB9, "LDA", C6502::LDA, AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // LDA - Absolute,Y
-   { 0xBA, "TSX", C6502::TSX, AM_IMPLIED, 2, true, false, 0x2 }, // TSX
-   { 0xBB, "LAS", C6502::LAS, AM_ABSOLUTE_INDEXED_Y, 4, false, false, 0x8 }, // LAS - Absolute,Y (undocumented)
-   { 0xBC, "LDY", C6502::LDY, AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // LDY - Absolute,X
-   { 0xBD, "LDA", C6502::LDA, AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // LDA - Absolute,X
-   { 0xBE, "LDX", C6502::LDX, AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // LDX - Absolute,Y
-   { 0xBF, "LAX", C6502::LAX, AM_ABSOLUTE_INDEXED_Y, 4, false, false, 0x8 }, // LAX - Absolute,Y (undocumented)
-   { 0xC0, "CPY", C6502::CPY, AM_IMMEDIATE, 2, true, false, 0x2 }, // CPY - Immediate
-   { 0xC1, "CMP", C6502::CMP, AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // CMP - (Indirect,X)
-   { 0xC2, "DOP", C6502::DOP, AM_IMMEDIATE, 2, false, false, 0x2 }, // DOP (undocumented)
-   { 0xC3, "DCM", C6502::DCM, AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // DCM - (Indirect,X) (undocumented)
-   { 0xC4, "CPY", C6502::CPY, AM_ZEROPAGE, 3, true, false, 0x4 }, // CPY - Zero Page
-   { 0xC5, "CMP", C6502::CMP, AM_ZEROPAGE, 3, true, false, 0x4 }, // CMP - Zero Page
-   { 0xC6, "DEC", C6502::DEC, AM_ZEROPAGE, 5, true, false, 0x10 }, // DEC - Zero Page
-   { 0xC7, "DCM", C6502::DCM, AM_ZEROPAGE, 5, true, false, 0x10 }, // DCM - Zero Page (undocumented)
-   { 0xC8, "INY", C6502::INY, AM_IMPLIED, 2, true, false, 0x2 }, // INY
-   { 0xC9, "CMP", C6502::CMP, AM_IMMEDIATE, 2, true, false, 0x2 }, // CMP - Immediate
-   { 0xCA, "DEX", C6502::DEX, AM_IMPLIED, 2, true, false, 0x2 }, // DEX
-   { 0xCB, "SAX", C6502::SAX, AM_IMMEDIATE, 2, false, false, 0x2 }, // SAX - Immediate (undocumented)
-   { 0xCC, "CPY", C6502::CPY, AM_ABSOLUTE, 4, true, false, 0x8 }, // CPY - Absolute
-   { 0xCD, "CMP", C6502::CMP, AM_ABSOLUTE, 4, true, false, 0x8 }, // CMP - Absolute
-   { 0xCE, "DEC", C6502::DEC, AM_ABSOLUTE, 6, true, false, 0x20 }, // DEC - Absolute
-   { 0xCF, "DCM", C6502::DCM, AM_ABSOLUTE, 6, false, false, 0x20 }, // DCM - Absolute (undocumented)
-   { 0xD0, "BNE", C6502::BNE, AM_RELATIVE, 2, true, false, 0xA }, // BNE
-   { 0xD1, "CMP", C6502::CMP, AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // CMP   (Indirect),Y
-   { 0xD2, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0xD3, "DCM", C6502::DCM, AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // DCM - (Indirect),Y (undocumented)
-   { 0xD4, "DOP", C6502::DOP, AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
-   { 0xD5, "CMP", C6502::CMP, AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // CMP - Zero Page,X
-   { 0xD6, "DEC", C6502::DEC, AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // DEC - Zero Page,X
-   { 0xD7, "DCM", C6502::DCM, AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // DCM - Zero Page,X (undocumented)
-   { 0xD8, "CLD", C6502::CLD, AM_IMPLIED, 2, true, false, 0x2 }, // CLD
-   { 0xD9, "CMP", C6502::CMP, AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // CMP - Absolute,Y
-   { 0xDA, "NOP", C6502::NOP, AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
-   { 0xDB, "DCM", C6502::DCM, AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // DCM - Absolute,Y (undocumented)
-   { 0xDC, "TOP", C6502::TOP, AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
-   { 0xDD, "CMP", C6502::CMP, AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // CMP - Absolute,X
-   { 0xDE, "DEC", C6502::DEC, AM_ABSOLUTE_INDEXED_X, 7, true, true, 0x40 }, // DEC - Absolute,X
-   { 0xDF, "DCM", C6502::DCM, AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }, // DCM - Absolute,X (undocumented)
-   { 0xE0, "CPX", C6502::CPX, AM_IMMEDIATE, 2, true, false, 0x2 }, // CPX - Immediate
-   { 0xE1, "SBC", C6502::SBC, AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // SBC - (Indirect,X)
-   { 0xE2, "DOP", C6502::DOP, AM_IMMEDIATE, 2, false, false, 0x2 }, // DOP (undocumented)
-   { 0xE3, "INS", C6502::INS, AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // INS - (Indirect,X) (undocumented)
-   { 0xE4, "CPX", C6502::CPX, AM_ZEROPAGE, 3, true, false, 0x4 }, // CPX - Zero Page
-   { 0xE5, "SBC", C6502::SBC, AM_ZEROPAGE, 3, true, false, 0x4 }, // SBC - Zero Page
-   { 0xE6, "INC", C6502::INC, AM_ZEROPAGE, 5, true, false, 0x10 }, // INC - Zero Page
-   { 0xE7, "INS", C6502::INS, AM_ZEROPAGE, 5, false, false, 0x10 }, // INS - Zero Page (undocumented)
-   { 0xE8, "INX", C6502::INX, AM_IMPLIED, 2, true, false, 0x2 }, // INX
-   { 0xE9, "SBC", C6502::SBC, AM_IMMEDIATE, 2, true, false, 0x2 }, // SBC - Immediate
-   { 0xEA, "NOP", C6502::NOP, AM_IMPLIED, 2, true, false, 0x2 }, // NOP
-   { 0xEB, "SBC", C6502::SBC, AM_IMMEDIATE, 2, false, false, 0x2 }, // SBC - Immediate (undocumented)
-   { 0xEC, "CPX", C6502::CPX, AM_ABSOLUTE, 4, true, false, 0x8 }, // CPX - Absolute
-   { 0xED, "SBC", C6502::SBC, AM_ABSOLUTE, 4, true, false, 0x8 }, // SBC - Absolute
-   { 0xEE, "INC", C6502::INC, AM_ABSOLUTE, 6, true, false, 0x20 }, // INC - Absolute
-   { 0xEF, "INS", C6502::INS, AM_ABSOLUTE, 6, false, false, 0x20 }, // INS - Absolute (undocumented)
-   { 0xF0, "BEQ", C6502::BEQ, AM_RELATIVE, 2, true, false, 0xA }, // BEQ
-   { 0xF1, "SBC", C6502::SBC, AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // SBC - (Indirect),Y
-   { 0xF2, "KIL", C6502::KIL, AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
-   { 0xF3, "INS", C6502::INS, AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // INS - (Indirect),Y (undocumented)
-   { 0xF4, "DOP", C6502::DOP, AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
-   { 0xF5, "SBC", C6502::SBC, AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // SBC - Zero Page,X
-   { 0xF6, "INC", C6502::INC, AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // INC - Zero Page,X
-   { 0xF7, "INS", C6502::INS, AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // INS - Zero Page,X (undocumented)
-   { 0xF8, "SED", C6502::SED, AM_IMPLIED, 2, true, false, 0x2 }, // SED
-   { 0xF9, "SBC", C6502::SBC, AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // SBC - Absolute,Y
-   { 0xFA, "NOP", C6502::NOP, AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
-   { 0xFB, "INS", C6502::INS, AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // INS - Absolute,Y (undocumented)
-   { 0xFC, "TOP", C6502::TOP, AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
-   { 0xFD, "SBC", C6502::SBC, AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // SBC - Absolute,X
-   { 0xFE, "INC", C6502::INC, AM_ABSOLUTE_INDEXED_X, 7, true, true, 0x40 }, // INC - Absolute,X
-   { 0xFF, "INS", C6502::INS, AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }  // INS - Absolute,X (undocumented)
+   "", // AM_IMPLIED
+   "", // AM_IMMEDIATE
+   "", // AM_ABSOLUTE
+   "", // AM_ZEROPAGE
+   "", // AM_ACCUMULATOR
+   ", X", // AM_ABSOLUTE_INDEXED_X
+   ", Y", // AM_ABSOLUTE_INDEXED_Y
+   ", X", // AM_ZEROPAGE_INDEXED_X
+   ", Y", // AM_ZEROPAGE_INDEXED_Y
+   ")", // AM_INDIRECT
+   ", X)", // AM_PREINDEXED_INDIRECT
+   "), Y", // AM_POSTINDEXED_INDIRECT
+   ""  // AM_RELATIVE
 };
 
-static C6502 __init __attribute__((unused));
+// Both instantiations of an instruction execution routine, for the
+// pFn member of the opcode table below.
+#define OPCODE(fn) { C6502::fn<NESNoDebugHooks>, C6502::fn<NESDebugHooks> }
 
-C6502::C6502()
+static CNES6502_opcode m_6502opcode [ 256 ] =
+{
+   { 0x00, "BRK", OPCODE(BRK), AM_IMPLIED, 7, true, false, 0x0 }, // BRK
+   { 0x01, "ORA", OPCODE(ORA), AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // ORA - (Indirect,X)
+   { 0x02, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0x03, "ASO", OPCODE(ASO), AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // ASO - (Indirect,X) (undocumented)
+   { 0x04, "DOP", OPCODE(DOP), AM_ZEROPAGE, 3, false, false, 0x4 }, // DOP (undocumented)
+   { 0x05, "ORA", OPCODE(ORA), AM_ZEROPAGE, 3, true, false, 0x4 }, // ORA - Zero Page
+   { 0x06, "ASL", OPCODE(ASL), AM_ZEROPAGE, 5, true, false, 0x10 }, // ASL - Zero Page
+   { 0x07, "ASO", OPCODE(ASO), AM_ZEROPAGE, 5, false, false, 0x10 }, // ASO - Zero Page (undocumented)
+   { 0x08, "PHP", OPCODE(PHP), AM_IMPLIED, 3, true, false, 0x4 }, // PHP
+   { 0x09, "ORA", OPCODE(ORA), AM_IMMEDIATE, 2, true, false, 0x2 }, // ORA - Immediate
+   { 0x0A, "ASL", OPCODE(ASL), AM_ACCUMULATOR, 2, true, false, 0x2 }, // ASL - Accumulator
+   { 0x0B, "ANC", OPCODE(ANC), AM_IMMEDIATE, 2, false, false, 0x2 }, // ANC - Immediate (undocumented)
+   { 0x0C, "TOP", OPCODE(TOP), AM_ABSOLUTE, 4, false, false, 0x8 }, // TOP (undocumented)
+   { 0x0D, "ORA", OPCODE(ORA), AM_ABSOLUTE, 4, true, false, 0x8 }, // ORA - Absolute
+   { 0x0E, "ASL", OPCODE(ASL), AM_ABSOLUTE, 6, true, false, 0x20 }, // ASL - Absolute
+   { 0x0F, "ASO", OPCODE(ASO), AM_ABSOLUTE, 6, false, false, 0x20 }, // ASO - Absolute (undocumented)
+   { 0x10, "BPL", OPCODE(BPL), AM_RELATIVE, 2, true, false, 0xA }, // BPL
+   { 0x11, "ORA", OPCODE(ORA), AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // ORA - (Indirect),Y
+   { 0x12, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0x13, "ASO", OPCODE(ASO), AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // ASO - (Indirect),Y (undocumented)
+   { 0x14, "DOP", OPCODE(DOP), AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
+   { 0x15, "ORA", OPCODE(ORA), AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // ORA - Zero Page,X
+   { 0x16, "ASL", OPCODE(ASL), AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // ASL - Zero Page,X
+   { 0x17, "ASO", OPCODE(ASO), AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // ASO - Zero Page,X (undocumented)
+   { 0x18, "CLC", OPCODE(CLC), AM_IMPLIED, 2, true, false, 0x2 }, // CLC
+   { 0x19, "ORA", OPCODE(ORA), AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // ORA - Absolute,Y
+   { 0x1A, "NOP", OPCODE(NOP), AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
+   { 0x1B, "ASO", OPCODE(ASO), AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // ASO - Absolute,Y (undocumented)
+   { 0x1C, "TOP", OPCODE(TOP), AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
+   { 0x1D, "ORA", OPCODE(ORA), AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // ORA - Absolute,X
+   { 0x1E, "ASL", OPCODE(ASL), AM_ABSOLUTE_INDEXED_X, 7, true, true, 0x40 }, // ASL - Absolute,X
+   { 0x1F, "ASO", OPCODE(ASO), AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }, // ASO - Absolute,X (undocumented)
+   { 0x20, "JSR", OPCODE(JSR), AM_ABSOLUTE, 6, true, false, 0x20 }, // JSR
+   { 0x21, "AND", OPCODE(AND), AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // AND - (Indirect,X)
+   { 0x22, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0x23, "RLA", OPCODE(RLA), AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // RLA - (Indirect,X) (undocumented)
+   { 0x24, "BIT", OPCODE(BIT), AM_ZEROPAGE, 3, true, false, 0x4 }, // BIT - Zero Page
+   { 0x25, "AND", OPCODE(AND), AM_ZEROPAGE, 3, true, false, 0x4 }, // AND - Zero Page
+   { 0x26, "ROL", OPCODE(ROL), AM_ZEROPAGE, 5, true, false, 0x10 }, // ROL - Zero Page
+   { 0x27, "RLA", OPCODE(RLA), AM_ZEROPAGE, 5, false, false, 0x10 }, // RLA - Zero Page (undocumented)
+   { 0x28, "PLP", OPCODE(PLP), AM_IMPLIED, 4, true, false, 0x8 }, // PLP
+   { 0x29, "AND", OPCODE(AND), AM_IMMEDIATE, 2, true, false, 0x2 }, // AND - Immediate
+   { 0x2A, "ROL", OPCODE(ROL), AM_ACCUMULATOR, 2, true, false, 0x2 }, // ROL - Accumulator
+   { 0x2B, "ANC", OPCODE(ANC), AM_IMMEDIATE, 2, false, false, 0x2 }, // ANC - Immediate (undocumented)
+   { 0x2C, "BIT", OPCODE(BIT), AM_ABSOLUTE, 4, true, false, 0x8 }, // BIT - Absolute
+   { 0x2D, "AND", OPCODE(AND), AM_ABSOLUTE, 4, true, false, 0x8 }, // AND - Absolute
+   { 0x2E, "ROL", OPCODE(ROL), AM_ABSOLUTE, 6, true, false, 0x20 }, // ROL - Absolute
+   { 0x2F, "RLA", OPCODE(RLA), AM_ABSOLUTE, 6, false, false, 0x20 }, // RLA - Absolute (undocumented)
+   { 0x30, "BMI", OPCODE(BMI), AM_RELATIVE, 2, true, false, 0x2 }, // BMI
+   { 0x31, "AND", OPCODE(AND), AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // AND - (Indirect),Y
+   { 0x32, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0x33, "RLA", OPCODE(RLA), AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // RLA - (Indirect),Y (undocumented)
+   { 0x34, "DOP", OPCODE(DOP), AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
+   { 0x35, "AND", OPCODE(AND), AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // AND - Zero Page,X
+   { 0x36, "ROL", OPCODE(ROL), AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // ROL - Zero Page,X
+   { 0x37, "RLA", OPCODE(RLA), AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // RLA - Zero Page,X (undocumented)
+   { 0x38, "SEC", OPCODE(SEC), AM_IMPLIED, 2, true, false, 0x2 }, // SEC
+   { 0x39, "AND", OPCODE(AND), AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // AND - Absolute,Y
+   { 0x3A, "NOP", OPCODE(NOP), AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
+   { 0x3B, "RLA", OPCODE(RLA), AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // RLA - Absolute,Y (undocumented)
+   { 0x3C, "TOP", OPCODE(TOP), AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
+   { 0x3D, "AND", OPCODE(AND), AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // AND - Absolute,X
+   { 0x3E, "ROL", OPCODE(ROL), AM_ABSOLUTE_INDEXED_X, 7, true, false, 0x40 }, // ROL - Absolute,X
+   { 0x3F, "RLA", OPCODE(RLA), AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }, // RLA - Absolute,X (undocumented)
+   { 0x40, "RTI", OPCODE(RTI), AM_IMPLIED, 6, true, false, 0x20 }, // RTI
+   { 0x41, "EOR", OPCODE(EOR), AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // EOR - (Indirect,X)
+   { 0x42, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0x43, "LSE", OPCODE(LSE), AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // LSE - (Indirect,X) (undocumented)
+   { 0x44, "DOP", OPCODE(DOP), AM_ZEROPAGE, 3, false, false, 0x4 }, // DOP (undocumented)
+   { 0x45, "EOR", OPCODE(EOR), AM_ZEROPAGE, 3, true, false, 0x4 }, // EOR - Zero Page
+   { 0x46, "LSR", OPCODE(LSR), AM_ZEROPAGE, 5, true, false, 0x10 }, // LSR - Zero Page
+   { 0x47, "LSE", OPCODE(LSE), AM_ZEROPAGE, 5, false, false, 0x10 }, // LSE - Zero Page (undocumented)
+   { 0x48, "PHA", OPCODE(PHA), AM_IMPLIED, 3, true, false, 0x4 }, // PHA
+   { 0x49, "EOR", OPCODE(EOR), AM_IMMEDIATE, 2, true, false, 0x2 }, // EOR - Immediate
+   { 0x4A, "LSR", OPCODE(LSR), AM_ACCUMULATOR, 2, true, false, 0x2 }, // LSR - Accumulator
+   { 0x4B, "ALR", OPCODE(ALR), AM_IMMEDIATE, 2, false, false, 0x2 }, // ALR - Immediate (undocumented)
+   { 0x4C, "JMP", OPCODE(JMP), AM_ABSOLUTE, 3, true, false, 0x4 }, // JMP - Absolute
+   { 0x4D, "EOR", OPCODE(EOR), AM_ABSOLUTE, 4, true, false, 0x8 }, // EOR - Absolute
+   { 0x4E, "LSR", OPCODE(LSR), AM_ABSOLUTE, 6, true, false, 0x20 }, // LSR - Absolute
+   { 0x4F, "LSE", OPCODE(LSE), AM_ABSOLUTE, 6, false, false, 0x20 }, // LSE - Absolute (undocumented)
+   { 0x50, "BVC", OPCODE(BVC), AM_RELATIVE, 2, true, false, 0xA }, // BVC
+   { 0x51, "EOR", OPCODE(EOR), AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // EOR - (Indirect),Y
+   { 0x52, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0x53, "LSE", OPCODE(LSE), AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // LSE - (Indirect),Y
+   { 0x54, "DOP", OPCODE(DOP), AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
+   { 0x55, "EOR", OPCODE(EOR), AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // EOR - Zero Page,X
+   { 0x56, "LSR", OPCODE(LSR), AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // LSR - Zero Page,X
+   { 0x57, "LSE", OPCODE(LSE), AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // LSE - Zero Page,X (undocumented)
+   { 0x58, "CLI", OPCODE(CLI), AM_IMPLIED, 2, true, false, 0x2 }, // CLI
+   { 0x59, "EOR", OPCODE(EOR), AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // EOR - Absolute,Y
+   { 0x5A, "NOP", OPCODE(NOP), AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
+   { 0x5B, "LSE", OPCODE(LSE), AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // LSE - Absolute,Y (undocumented)
+   { 0x5C, "TOP", OPCODE(TOP), AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
+   { 0x5D, "EOR", OPCODE(EOR), AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // EOR - Absolute,X
+   { 0x5E, "LSR", OPCODE(LSR), AM_ABSOLUTE_INDEXED_X, 7, true, true, 0x40 }, // LSR - Absolute,X
+   { 0x5F, "LSE", OPCODE(LSE), AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }, // LSE - Absolute,X (undocumented)
+   { 0x60, "RTS", OPCODE(RTS), AM_IMPLIED, 6, true, false, 0x20 }, // RTS
+   { 0x61, "ADC", OPCODE(ADC), AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // ADC - (Indirect,X)
+   { 0x62, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0x63, "RRA", OPCODE(RRA), AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // RRA - (Indirect,X) (undocumented)
+   { 0x64, "DOP", OPCODE(DOP), AM_ZEROPAGE, 3, false, false, 0x4 }, // DOP (undocumented)
+   { 0x65, "ADC", OPCODE(ADC), AM_ZEROPAGE, 3, true, false, 0x4 }, // ADC - Zero Page
+   { 0x66, "ROR", OPCODE(ROR), AM_ZEROPAGE, 5, true, false, 0x10 }, // ROR - Zero Page
+   { 0x67, "RRA", OPCODE(RRA), AM_ZEROPAGE, 5, false, false, 0x10 }, // RRA - Zero Page (undocumented)
+   { 0x68, "PLA", OPCODE(PLA), AM_IMPLIED, 4, true, false, 0x8 }, // PLA
+   { 0x69, "ADC", OPCODE(ADC), AM_IMMEDIATE, 2, true, false, 0x2 }, // ADC - Immediate
+   { 0x6A, "ROR", OPCODE(ROR), AM_ACCUMULATOR, 2, true, false, 0x2 }, // ROR - Accumulator
+   { 0x6B, "ARR", OPCODE(ARR), AM_IMMEDIATE, 2, false, false, 0x2 }, // ARR - Immediate (undocumented)
+   { 0x6C, "JMP", OPCODE(JMP), AM_INDIRECT, 5, true, false, 0x10 }, // JMP - Indirect
+   { 0x6D, "ADC", OPCODE(ADC), AM_ABSOLUTE, 4, true, false, 0x8 }, // ADC - Absolute
+   { 0x6E, "ROR", OPCODE(ROR), AM_ABSOLUTE, 6, true, false, 0x20 }, // ROR - Absolute
+   { 0x6F, "RRA", OPCODE(RRA), AM_ABSOLUTE, 6, false, false, 0x20 }, // RRA - Absolute (undocumented)
+   { 0x70, "BVS", OPCODE(BVS), AM_RELATIVE, 2, true, false, 0xA }, // BVS
+   { 0x71, "ADC", OPCODE(ADC), AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // ADC - (Indirect),Y
+   { 0x72, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0x73, "RRA", OPCODE(RRA), AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // RRA - (Indirect),Y (undocumented)
+   { 0x74, "DOP", OPCODE(DOP), AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
+   { 0x75, "ADC", OPCODE(ADC), AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // ADC - Zero Page,X
+   { 0x76, "ROR", OPCODE(ROR), AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // ROR - Zero Page,X
+   { 0x77, "RRA", OPCODE(RRA), AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // RRA - Zero Page,X (undocumented)
+   { 0x78, "SEI", OPCODE(SEI), AM_IMPLIED, 2, true, false, 0x2 }, // SEI
+   { 0x79, "ADC", OPCODE(ADC), AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // ADC - Absolute,Y
+   { 0x7A, "NOP", OPCODE(NOP), AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
+   { 0x7B, "RRA", OPCODE(RRA), AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // RRA - Absolute,Y (undocumented)
+   { 0x7C, "TOP", OPCODE(TOP), AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
+   { 0x7D, "ADC", OPCODE(ADC), AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // ADC - Absolute,X
+   { 0x7E, "ROR", OPCODE(ROR), AM_ABSOLUTE_INDEXED_X, 7, true, true, 0x40 }, // ROR - Absolute,X
+   { 0x7F, "RRA", OPCODE(RRA), AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }, // RRA - Absolute,X (undocumented)
+   { 0x80, "DOP", OPCODE(DOP), AM_IMMEDIATE, 2, false, false, 0x2 }, // DOP (undocumented)
+   { 0x81, "STA", OPCODE(STA), AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // STA - (Indirect,X)
+   { 0x82, "DOP", OPCODE(DOP), AM_IMMEDIATE, 2, false, false, 0x2 }, // DOP (undocumented)
+   { 0x83, "AXS", OPCODE(AXS), AM_PREINDEXED_INDIRECT, 6, false, false, 0x20 }, // AXS - (Indirect,X) (undocumented)
+   { 0x84, "STY", OPCODE(STY), AM_ZEROPAGE, 3, true, false, 0x4 }, // STY - Zero Page
+   { 0x85, "STA", OPCODE(STA), AM_ZEROPAGE, 3, true, false, 0x4 }, // STA - Zero Page
+   { 0x86, "STX", OPCODE(STX), AM_ZEROPAGE, 3, true, false, 0x4 }, // STX - Zero Page
+   { 0x87, "AXS", OPCODE(AXS), AM_ZEROPAGE, 3, false, false, 0x4 }, // AXS - Zero Page (undocumented)
+   { 0x88, "DEY", OPCODE(DEY), AM_IMPLIED, 2, true, false, 0x2 }, // DEY
+   { 0x89, "DOP", OPCODE(DOP), AM_IMMEDIATE, 2, false, false, 0x2 }, // DOP (undocumented)
+   { 0x8A, "TXA", OPCODE(TXA), AM_IMPLIED, 2, true, false, 0x2 }, // TXA
+   { 0x8B, "XAA", OPCODE(XAA), AM_IMMEDIATE, 2, false, false, 0x2 }, // XAA - Immediate (undocumented)
+   { 0x8C, "STY", OPCODE(STY), AM_ABSOLUTE, 4, true, false, 0x8 }, // STY - Absolute
+   { 0x8D, "STA", OPCODE(STA), AM_ABSOLUTE, 4, true, false, 0x8 }, // STA - Absolute
+   { 0x8E, "STX", OPCODE(STX), AM_ABSOLUTE, 4, true, false, 0x8 }, // STX - Absolute
+   { 0x8F, "AXS", OPCODE(AXS), AM_ABSOLUTE, 4, false, false, 0x8 }, // AXS - Absolulte (undocumented)
+   { 0x90, "BCC", OPCODE(BCC), AM_RELATIVE, 2, true, false, 0xA }, // BCC
+   { 0x91, "STA", OPCODE(STA), AM_POSTINDEXED_INDIRECT, 6, true, true, 0x20 }, // STA - (Indirect),Y
+   { 0x92, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0x93, "AXA", OPCODE(AXA), AM_POSTINDEXED_INDIRECT, 6, false, true, 0x20 }, // AXA - (Indirect),Y
+   { 0x94, "STY", OPCODE(STY), AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // STY - Zero Page,X
+   { 0x95, "STA", OPCODE(STA), AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // STA - Zero Page,X
+   { 0x96, "STX", OPCODE(STX), AM_ZEROPAGE_INDEXED_Y, 4, true, false, 0x8 }, // STX - Zero Page,Y
+   { 0x97, "AXS", OPCODE(AXS), AM_ZEROPAGE_INDEXED_Y, 4, false, false, 0x8 }, // AXS - Zero Page,Y
+   { 0x98, "TYA", OPCODE(TYA), AM_IMPLIED, 2, true, false, 0x2 }, // TYA
+   { 0x99, "STA", OPCODE(STA), AM_ABSOLUTE_INDEXED_Y, 5, true, true, 0x10 }, // STA - Absolute,Y
+   { 0x9A, "TXS", OPCODE(TXS), AM_IMPLIED, 2, true, false, 0x2 }, // TXS
+   { 0x9B, "TAS", OPCODE(TAS), AM_ABSOLUTE_INDEXED_Y, 5, false, true, 0x10 }, // TAS - Absolute,Y (undocumented)
+   { 0x9C, "SAY", OPCODE(SAY), AM_ABSOLUTE_INDEXED_X, 5, false, true, 0x10 }, // SAY - Absolute,X (undocumented)
+   { 0x9D, "STA", OPCODE(STA), AM_ABSOLUTE_INDEXED_X, 5, true, true, 0x10 }, // STA - Absolute,X
+   { 0x9E, "XAS", OPCODE(XAS), AM_ABSOLUTE_INDEXED_Y, 5, false, true, 0x10 }, // XAS - Absolute,Y (undocumented)
+   { 0x9F, "AXA", OPCODE(AXA), AM_ABSOLUTE_INDEXED_Y, 5, false, true, 0x10 }, // AXA - Absolute,Y (undocumented)
+   { 0xA0, "LDY", OPCODE(LDY), AM_IMMEDIATE, 2, true, false, 0x2 }, // LDY - Immediate
+   { 0xA1, "LDA", OPCODE(LDA), AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // LDA - (Indirect,X)
+   { 0xA2, "LDX", OPCODE(LDX), AM_IMMEDIATE, 2, true, false, 0x2 }, // LDX - Immediate
+   { 0xA3, "LAX", OPCODE(LAX), AM_PREINDEXED_INDIRECT, 6, false, false, 0x20 }, // LAX - (Indirect,X) (undocumented)
+   { 0xA4, "LDY", OPCODE(LDY), AM_ZEROPAGE, 3, true, false, 0x4 }, // LDY - Zero Page
+   { 0xA5, "LDA", OPCODE(LDA), AM_ZEROPAGE, 3, true, false, 0x4 }, // LDA - Zero Page
+   { 0xA6, "LDX", OPCODE(LDX), AM_ZEROPAGE, 3, true, false, 0x4 }, // LDX - Zero Page
+   { 0xA7, "LAX", OPCODE(LAX), AM_ZEROPAGE, 3, false, false, 0x4 }, // LAX - Zero Page (undocumented)
+   { 0xA8, "TAY", OPCODE(TAY), AM_IMPLIED, 2, true, false, 0x2 }, // TAY
+   { 0xA9, "LDA", OPCODE(LDA), AM_IMMEDIATE, 2, true, false, 0x2 }, // LDA - Immediate
+   { 0xAA, "TAX", OPCODE(TAX), AM_IMPLIED, 2, true, false, 0x2 }, // TAX
+   { 0xAB, "OAL", OPCODE(OAL), AM_IMMEDIATE, 2, false, false, 0x2 }, // OAL - Immediate
+   { 0xAC, "LDY", OPCODE(LDY), AM_ABSOLUTE, 4, true, false, 0x8 }, // LDY - Absolute
+   { 0xAD, "LDA", OPCODE(LDA), AM_ABSOLUTE, 4, true, false, 0x8 }, // LDA - Absolute
+   { 0xAE, "LDX", OPCODE(LDX), AM_ABSOLUTE, 4, true, false, 0x8 }, // LDX - Absolute
+   { 0xAF, "LAX", OPCODE(LAX), AM_ABSOLUTE, 4, false, false, 0x8 }, // LAX - Absolute (undocumented)
+   { 0xB0, "BCS", OPCODE(BCS), AM_RELATIVE, 2, true, false, 0xA }, // BCS
+   { 0xB1, "LDA", OPCODE(LDA), AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // LDA - (Indirect),Y
+   { 0xB2, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0xB3, "LAX", OPCODE(LAX), AM_POSTINDEXED_INDIRECT, 5, false, false, 0x10 }, // LAX - (Indirect),Y (undocumented)
+   { 0xB4, "LDY", OPCODE(LDY), AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // LDY - Zero Page,X
+   { 0xB5, "LDA", OPCODE(LDA), AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // LDA - Zero Page,X
+   { 0xB6, "LDX", OPCODE(LDX), AM_ZEROPAGE_INDEXED_Y, 4, true, false, 0x8 }, // LDX - Zero Page,Y
+   { 0xB7, "LAX", OPCODE(LAX), AM_ZEROPAGE_INDEXED_Y, 4, false, false, 0x8 }, // LAX - Zero Page,X (undocumented)
+   { 0xB8, "CLV", OPCODE(CLV), AM_IMPLIED, 2, true, false, 0x2 }, // CLV
+   { 0xB9, "LDA", OPCODE(LDA), AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // LDA - Absolute,Y
+   { 0xBA, "TSX", OPCODE(TSX), AM_IMPLIED, 2, true, false, 0x2 }, // TSX
+   { 0xBB, "LAS", OPCODE(LAS), AM_ABSOLUTE_INDEXED_Y, 4, false, false, 0x8 }, // LAS - Absolute,Y (undocumented)
+   { 0xBC, "LDY", OPCODE(LDY), AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // LDY - Absolute,X
+   { 0xBD, "LDA", OPCODE(LDA), AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // LDA - Absolute,X
+   { 0xBE, "LDX", OPCODE(LDX), AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // LDX - Absolute,Y
+   { 0xBF, "LAX", OPCODE(LAX), AM_ABSOLUTE_INDEXED_Y, 4, false, false, 0x8 }, // LAX - Absolute,Y (undocumented)
+   { 0xC0, "CPY", OPCODE(CPY), AM_IMMEDIATE, 2, true, false, 0x2 }, // CPY - Immediate
+   { 0xC1, "CMP", OPCODE(CMP), AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // CMP - (Indirect,X)
+   { 0xC2, "DOP", OPCODE(DOP), AM_IMMEDIATE, 2, false, false, 0x2 }, // DOP (undocumented)
+   { 0xC3, "DCM", OPCODE(DCM), AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // DCM - (Indirect,X) (undocumented)
+   { 0xC4, "CPY", OPCODE(CPY), AM_ZEROPAGE, 3, true, false, 0x4 }, // CPY - Zero Page
+   { 0xC5, "CMP", OPCODE(CMP), AM_ZEROPAGE, 3, true, false, 0x4 }, // CMP - Zero Page
+   { 0xC6, "DEC", OPCODE(DEC), AM_ZEROPAGE, 5, true, false, 0x10 }, // DEC - Zero Page
+   { 0xC7, "DCM", OPCODE(DCM), AM_ZEROPAGE, 5, true, false, 0x10 }, // DCM - Zero Page (undocumented)
+   { 0xC8, "INY", OPCODE(INY), AM_IMPLIED, 2, true, false, 0x2 }, // INY
+   { 0xC9, "CMP", OPCODE(CMP), AM_IMMEDIATE, 2, true, false, 0x2 }, // CMP - Immediate
+   { 0xCA, "DEX", OPCODE(DEX), AM_IMPLIED, 2, true, false, 0x2 }, // DEX
+   { 0xCB, "SAX", OPCODE(SAX), AM_IMMEDIATE, 2, false, false, 0x2 }, // SAX - Immediate (undocumented)
+   { 0xCC, "CPY", OPCODE(CPY), AM_ABSOLUTE, 4, true, false, 0x8 }, // CPY - Absolute
+   { 0xCD, "CMP", OPCODE(CMP), AM_ABSOLUTE, 4, true, false, 0x8 }, // CMP - Absolute
+   { 0xCE, "DEC", OPCODE(DEC), AM_ABSOLUTE, 6, true, false, 0x20 }, // DEC - Absolute
+   { 0xCF, "DCM", OPCODE(DCM), AM_ABSOLUTE, 6, false, false, 0x20 }, // DCM - Absolute (undocumented)
+   { 0xD0, "BNE", OPCODE(BNE), AM_RELATIVE, 2, true, false, 0xA }, // BNE
+   { 0xD1, "CMP", OPCODE(CMP), AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // CMP   (Indirect),Y
+   { 0xD2, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0xD3, "DCM", OPCODE(DCM), AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // DCM - (Indirect),Y (undocumented)
+   { 0xD4, "DOP", OPCODE(DOP), AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
+   { 0xD5, "CMP", OPCODE(CMP), AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // CMP - Zero Page,X
+   { 0xD6, "DEC", OPCODE(DEC), AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // DEC - Zero Page,X
+   { 0xD7, "DCM", OPCODE(DCM), AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // DCM - Zero Page,X (undocumented)
+   { 0xD8, "CLD", OPCODE(CLD), AM_IMPLIED, 2, true, false, 0x2 }, // CLD
+   { 0xD9, "CMP", OPCODE(CMP), AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // CMP - Absolute,Y
+   { 0xDA, "NOP", OPCODE(NOP), AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
+   { 0xDB, "DCM", OPCODE(DCM), AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // DCM - Absolute,Y (undocumented)
+   { 0xDC, "TOP", OPCODE(TOP), AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
+   { 0xDD, "CMP", OPCODE(CMP), AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // CMP - Absolute,X
+   { 0xDE, "DEC", OPCODE(DEC), AM_ABSOLUTE_INDEXED_X, 7, true, true, 0x40 }, // DEC - Absolute,X
+   { 0xDF, "DCM", OPCODE(DCM), AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }, // DCM - Absolute,X (undocumented)
+   { 0xE0, "CPX", OPCODE(CPX), AM_IMMEDIATE, 2, true, false, 0x2 }, // CPX - Immediate
+   { 0xE1, "SBC", OPCODE(SBC), AM_PREINDEXED_INDIRECT, 6, true, false, 0x20 }, // SBC - (Indirect,X)
+   { 0xE2, "DOP", OPCODE(DOP), AM_IMMEDIATE, 2, false, false, 0x2 }, // DOP (undocumented)
+   { 0xE3, "INS", OPCODE(INS), AM_PREINDEXED_INDIRECT, 8, false, false, 0x80 }, // INS - (Indirect,X) (undocumented)
+   { 0xE4, "CPX", OPCODE(CPX), AM_ZEROPAGE, 3, true, false, 0x4 }, // CPX - Zero Page
+   { 0xE5, "SBC", OPCODE(SBC), AM_ZEROPAGE, 3, true, false, 0x4 }, // SBC - Zero Page
+   { 0xE6, "INC", OPCODE(INC), AM_ZEROPAGE, 5, true, false, 0x10 }, // INC - Zero Page
+   { 0xE7, "INS", OPCODE(INS), AM_ZEROPAGE, 5, false, false, 0x10 }, // INS - Zero Page (undocumented)
+   { 0xE8, "INX", OPCODE(INX), AM_IMPLIED, 2, true, false, 0x2 }, // INX
+   { 0xE9, "SBC", OPCODE(SBC), AM_IMMEDIATE, 2, true, false, 0x2 }, // SBC - Immediate
+   { 0xEA, "NOP", OPCODE(NOP), AM_IMPLIED, 2, true, false, 0x2 }, // NOP
+   { 0xEB, "SBC", OPCODE(SBC), AM_IMMEDIATE, 2, false, false, 0x2 }, // SBC - Immediate (undocumented)
+   { 0xEC, "CPX", OPCODE(CPX), AM_ABSOLUTE, 4, true, false, 0x8 }, // CPX - Absolute
+   { 0xED, "SBC", OPCODE(SBC), AM_ABSOLUTE, 4, true, false, 0x8 }, // SBC - Absolute
+   { 0xEE, "INC", OPCODE(INC), AM_ABSOLUTE, 6, true, false, 0x20 }, // INC - Absolute
+   { 0xEF, "INS", OPCODE(INS), AM_ABSOLUTE, 6, false, false, 0x20 }, // INS - Absolute (undocumented)
+   { 0xF0, "BEQ", OPCODE(BEQ), AM_RELATIVE, 2, true, false, 0xA }, // BEQ
+   { 0xF1, "SBC", OPCODE(SBC), AM_POSTINDEXED_INDIRECT, 5, true, false, 0x10 }, // SBC - (Indirect),Y
+   { 0xF2, "KIL", OPCODE(KIL), AM_IMPLIED, 0, false, false, 0x0 }, // KIL - Implied (processor lock up!)
+   { 0xF3, "INS", OPCODE(INS), AM_POSTINDEXED_INDIRECT, 8, false, true, 0x80 }, // INS - (Indirect),Y (undocumented)
+   { 0xF4, "DOP", OPCODE(DOP), AM_ZEROPAGE_INDEXED_X, 4, false, false, 0x8 }, // DOP (undocumented)
+   { 0xF5, "SBC", OPCODE(SBC), AM_ZEROPAGE_INDEXED_X, 4, true, false, 0x8 }, // SBC - Zero Page,X
+   { 0xF6, "INC", OPCODE(INC), AM_ZEROPAGE_INDEXED_X, 6, true, false, 0x20 }, // INC - Zero Page,X
+   { 0xF7, "INS", OPCODE(INS), AM_ZEROPAGE_INDEXED_X, 6, false, false, 0x20 }, // INS - Zero Page,X (undocumented)
+   { 0xF8, "SED", OPCODE(SED), AM_IMPLIED, 2, true, false, 0x2 }, // SED
+   { 0xF9, "SBC", OPCODE(SBC), AM_ABSOLUTE_INDEXED_Y, 4, true, false, 0x8 }, // SBC - Absolute,Y
+   { 0xFA, "NOP", OPCODE(NOP), AM_IMPLIED, 2, false, false, 0x2 }, // NOP (undocumented)
+   { 0xFB, "INS", OPCODE(INS), AM_ABSOLUTE_INDEXED_Y, 7, false, true, 0x40 }, // INS - Absolute,Y (undocumented)
+   { 0xFC, "TOP", OPCODE(TOP), AM_ABSOLUTE_INDEXED_X, 4, false, false, 0x8 }, // TOP (undocumented)
+   { 0xFD, "SBC", OPCODE(SBC), AM_ABSOLUTE_INDEXED_X, 4, true, false, 0x8 }, // SBC - Absolute,X
+   { 0xFE, "INC", OPCODE(INC), AM_ABSOLUTE_INDEXED_X, 7, true, true, 0x40 }, // INC - Absolute,X
+   { 0xFF, "INS", OPCODE(INS), AM_ABSOLUTE_INDEXED_X, 7, false, true, 0x40 }  // INS - Absolute,X (undocumented)
+};
+
+C6502::State::State ()
 {
    int32_t addr;
 
-   m_RAMdisassembly = new char*[MEM_2KB];
-   for ( addr = 0; addr < MEM_2KB; addr++ )
-   {
-      m_RAMdisassembly[addr] = new char [ 16 ];
-   }
    m_RAMopcodeMask = new uint8_t[MEM_2KB];
    m_RAMsloc2addr = new uint16_t[MEM_2KB];
    m_RAMaddr2sloc = new uint16_t[MEM_2KB];
+   for ( addr = 0; addr < MEM_2KB; addr++ )
+   {
+      m_RAMopcodeMask[addr] = 0;
+      m_RAMsloc2addr[addr] = 0;
+      m_RAMaddr2sloc[addr] = 0;
+   }
 
-   m_6502memory = new uint8_t[MEM_2KB];
+   m_6502memory = new uint8_t[MEM_2KB]();
+
+   // Everything goes through the handlers until the first reset maps
+   // the pages.
+   for ( addr = 0; addr < NUM_CPU_PAGES; addr++ )
+   {
+      m_readPage[addr].pBank = NULL;
+      m_writePage[addr].pBank = NULL;
+   }
 
    m_logger = new CCodeDataLogger ( MEM_32KB, MASK_32KB );
 
    m_marker = new CMarker;
+
+   m_profiler = new CCallProfiler;
 }
 
-C6502::~C6502()
+C6502::State::~State ()
 {
-   int32_t addr;
-
-   for ( addr = 0; addr < MEM_2KB; addr++ )
-   {
-      delete m_RAMdisassembly[addr];
-   }
-   delete [] m_RAMdisassembly;
    delete [] m_RAMopcodeMask;
    delete [] m_RAMsloc2addr;
    delete [] m_RAMaddr2sloc;
@@ -544,119 +538,128 @@ C6502::~C6502()
    delete m_logger;
 
    delete m_marker;
+
+   delete m_profiler;
 }
 
+template <class HOOKS>
 void C6502::EMULATE ( int32_t cycles )
 {
    bool doCycle;
    bool nmiPending = false;
 
-   m_curCycles += cycles;
+   STATE()->m_curCycles += cycles;
 
-   if ( !m_killed )
+   if ( !STATE()->m_killed )
    {
       do
       {
-         if ( m_curCycles > 0 )
+         if ( STATE()->m_curCycles > 0 )
          {
-            doCycle = DMA();
+            doCycle = DMA<HOOKS>();
             if ( doCycle )
             {
-               if ( m_phase == 0 )
+               if ( STATE()->m_phase == 0 )
                {
                   // Indicate opcode fetch...
-                  m_instrCycle = 0;
+                  STATE()->m_instrCycle = 0;
 
                   // Keep track of synchronization points so IDE can display properly.
-                  m_pcSyncSet = true;
-                  m_pcSync = m_pc;
+                  STATE()->m_pcSyncSet = true;
+                  STATE()->m_pcSync = STATE()->m_pc;
 
                   // Break 'flag' is cleared after BRK finishes.
                   cB();
 
                   // Fetch
-                  nmiPending = m_nmiPending;
-                  (*opcodeData) = FETCH ();
+                  nmiPending = STATE()->m_nmiPending;
+                  (*STATE()->opcodeData) = FETCH<HOOKS> ();
 
-                  CNES::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUExecution, (*opcodeData) );
+                  HOOKS::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUExecution, (*STATE()->opcodeData) );
 
                   // Save the pointer to where to put the disassembly of
                   // the current opcode now.  This might be the last fetch
                   // for an instruction and the disassembly should be placed there.
-                  pDisassemblySample = CNES::TRACER()->GetLastCPUSample ();
+                  if ( HOOKS::ENABLED() )
+                  {
+                     STATE()->disassemblySample = CNES::TRACER()->GetLastCPUSample ();
+
+                     // Charge the last instruction to the routine it ran in.
+                     STATE()->m_profiler->Sample ( STATE()->m_cycles );
+                  }
 
                   // Check flags breakpoint.  Do it here instead of everywhere flags are
                   // changed so as to limit the number of calls to check the breakpoint.
-                  CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_F);
+                  HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_F);
 
                   // Check for KIL opcodes...
-                  if ( (((*opcodeData) == 0x02) ||
-                        ((*opcodeData) == 0x12) ||
-                        ((*opcodeData) == 0x22) ||
-                        ((*opcodeData) == 0x32) ||
-                        ((*opcodeData) == 0x42) ||
-                        ((*opcodeData) == 0x52) ||
-                        ((*opcodeData) == 0x62) ||
-                        ((*opcodeData) == 0x72) ||
-                        ((*opcodeData) == 0x92) ||
-                        ((*opcodeData) == 0xB2) ||
-                        ((*opcodeData) == 0xD2) ||
-                        ((*opcodeData) == 0xF2)) )
+                  if ( (((*STATE()->opcodeData) == 0x02) ||
+                        ((*STATE()->opcodeData) == 0x12) ||
+                        ((*STATE()->opcodeData) == 0x22) ||
+                        ((*STATE()->opcodeData) == 0x32) ||
+                        ((*STATE()->opcodeData) == 0x42) ||
+                        ((*STATE()->opcodeData) == 0x52) ||
+                        ((*STATE()->opcodeData) == 0x62) ||
+                        ((*STATE()->opcodeData) == 0x72) ||
+                        ((*STATE()->opcodeData) == 0x92) ||
+                        ((*STATE()->opcodeData) == 0xB2) ||
+                        ((*STATE()->opcodeData) == 0xD2) ||
+                        ((*STATE()->opcodeData) == 0xF2)) )
                   {
                      // KIL opcodes halt PC dead!  Force break if desired...
-                     if ( m_breakOnKIL )
+                     if ( STATE()->m_breakOnKIL )
                      {
                         CNES::FORCEBREAKPOINT ();
                      }
                   }
 
-                  if ( rPC() == m_pcGoto )
+                  if ( rPC() == STATE()->m_pcGoto )
                   {
                      CNES::STEPCPUBREAKPOINT();
-                     m_pcGoto = 0xFFFFFFFF;
+                     STATE()->m_pcGoto = 0xFFFFFFFF;
                   }
 
                   // If we fetched a BRK we might need to do some special stuff...
-                  if ( (!(nmiPending || m_irqPending)) && (*opcodeData) == BRK_IMPLIED )
+                  if ( (!(nmiPending || STATE()->m_irqPending)) && (*STATE()->opcodeData) == BRK_IMPLIED )
                   {
                      INCPC ();
                      sB ();
                   }
 
                   // Inject BRK if IRQ or NMI are pending...
-                  if ( (m_irqPending && (!rI())) || nmiPending )
+                  if ( (STATE()->m_irqPending && (!rI())) || nmiPending )
                   {
-                     (*opcodeData) = BRK_IMPLIED;
+                     (*STATE()->opcodeData) = BRK_IMPLIED;
                   }
 
-                  if ( (*opcodeData) != BRK_IMPLIED )
+                  if ( (*STATE()->opcodeData) != BRK_IMPLIED )
                   {
                      INCPC ();
                   }
 
                   // Get information about current opcode...
-                  pOpcodeStruct = m_6502opcode+(*opcodeData);
-                  opcodeSize = (*(opcode_size+(pOpcodeStruct->amode)));
+                  STATE()->pOpcodeStruct = m_6502opcode+(*STATE()->opcodeData);
+                  STATE()->opcodeSize = (*(opcode_size+(STATE()->pOpcodeStruct->amode)));
 
                   // Set up class data so we don't need to pass it down to each func...
-                  amode = pOpcodeStruct->amode;
-                  data = opcodeData+1;
+                  STATE()->amode = STATE()->pOpcodeStruct->amode;
+                  STATE()->data = STATE()->opcodeData+1;
 
                   // Go to next phase...
-                  m_phase++;
+                  STATE()->m_phase++;
                }
-               else if ( m_phase == 1 )
+               else if ( STATE()->m_phase == 1 )
                {
                   // Check for dummy-read needed for single-byte instructions...
-                  if ( opcodeSize == 1 )
+                  if ( STATE()->opcodeSize == 1 )
                   {
                      // Perform additional fetch...
-                     (*(opcodeData+1)) = EXTRAFETCH ();
+                     (*(STATE()->opcodeData+1)) = EXTRAFETCH<HOOKS> ();
 
-                     if ( rPC() == m_pcGoto )
+                     if ( rPC() == STATE()->m_pcGoto )
                      {
                         CNES::STEPCPUBREAKPOINT();
-                        m_pcGoto = 0xFFFFFFFF;
+                        STATE()->m_pcGoto = 0xFFFFFFFF;
                      }
 
                      if ( rB() )
@@ -665,151 +668,157 @@ void C6502::EMULATE ( int32_t cycles )
                      }
 
                      // Cause instruction execution...
-                     m_phase = -1;
+                     STATE()->m_phase = -1;
                   }
                   else
                   {
-                     (*(opcodeData+1)) = FETCH ();
+                     (*(STATE()->opcodeData+1)) = FETCH<HOOKS> ();
 
-                     if ( rPC() == m_pcGoto )
+                     if ( rPC() == STATE()->m_pcGoto )
                      {
                         CNES::STEPCPUBREAKPOINT();
-                        m_pcGoto = 0xFFFFFFFF;
+                        STATE()->m_pcGoto = 0xFFFFFFFF;
                      }
 
                      INCPC ();
 
-                     if ( opcodeSize == 2 )
+                     if ( STATE()->opcodeSize == 2 )
                      {
                         // Cause instruction execution...
-                        m_phase = -1;
+                        STATE()->m_phase = -1;
                      }
                      else
                      {
                         // JSR doesn't do the third byte fetch yet.
-                        if ( (*opcodeData) == JSR_ABSOLUTE )
+                        if ( (*STATE()->opcodeData) == JSR_ABSOLUTE )
                         {
                            // Cause instruction execution...
-                           m_phase = -1;
+                           STATE()->m_phase = -1;
                         }
                         else
                         {
                            // Go to next phase...
-                           m_phase++;
+                           STATE()->m_phase++;
                         }
                      }
                   }
                }
-               else if ( m_phase == 2 )
+               else if ( STATE()->m_phase == 2 )
                {
-                  (*(opcodeData+2)) = FETCH ();
+                  (*(STATE()->opcodeData+2)) = FETCH<HOOKS> ();
 
-                  if ( rPC() == m_pcGoto )
+                  if ( rPC() == STATE()->m_pcGoto )
                   {
                      CNES::STEPCPUBREAKPOINT();
-                     m_pcGoto = 0xFFFFFFFF;
+                     STATE()->m_pcGoto = 0xFFFFFFFF;
                   }
 
                   INCPC ();
 
                   // Cause instruction execution...
-                  m_phase = -1;
+                  STATE()->m_phase = -1;
                }
-               else if (  m_phase == -1 )
+               else if (  STATE()->m_phase == -1 )
                {
-                  if ( nesIsDebuggable() )
+                  if ( HOOKS::ENABLED() )
                   {
                      // Update Tracer
-                     CNES::TRACER()->SetRegisters ( pDisassemblySample, rA(), rX(), rY(), rSP(), rF() );
+                     CNES::TRACER()->SetRegisters ( STATE()->disassemblySample, rA(), rX(), rY(), rSP(), rF() );
                   }
 
-                  if ( rPC() == m_pcGoto )
+                  if ( rPC() == STATE()->m_pcGoto )
                   {
                      CNES::STEPCPUBREAKPOINT();
-                     m_pcGoto = 0xFFFFFFFF;
+                     STATE()->m_pcGoto = 0xFFFFFFFF;
                   }
 
                   // Execute
-                  pOpcodeStruct->pFn();
+                  STATE()->pOpcodeStruct->pFn[HOOKS::HOOKED]();
 
-                  if ( nesIsDebuggable() )
+                  if ( HOOKS::ENABLED() )
                   {
                      // Update Tracer
-                     CNES::TRACER()->SetDisassembly ( pDisassemblySample, opcodeData );
+                     CNES::TRACER()->SetDisassembly ( STATE()->disassemblySample, STATE()->opcodeData );
 
                      // Check for undocumented breakpoint...
-                     if ( !pOpcodeStruct->documented )
+                     if ( !STATE()->pOpcodeStruct->documented )
                      {
-                        CNES::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUEvent, 0, CPU_EVENT_UNDOCUMENTED );
-                        CNES::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUEvent, (*opcodeData), CPU_EVENT_UNDOCUMENTED_EXACT );
+                        HOOKS::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUEvent, 0, CPU_EVENT_UNDOCUMENTED );
+                        HOOKS::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUEvent, (*STATE()->opcodeData), CPU_EVENT_UNDOCUMENTED_EXACT );
                      }
                      else
                      {
-                        CNES::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUEvent, (*opcodeData), CPU_EVENT_EXECUTE_EXACT );
+                        HOOKS::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUEvent, (*STATE()->opcodeData), CPU_EVENT_EXECUTE_EXACT );
                      }
                   }
 
                   // Go back to fetch phases...
-                  if ( ((*opcodeData) != BRK_IMPLIED) ||
-                       (((*opcodeData) == BRK_IMPLIED) && (m_instrCycle == 7)) )
+                  if ( ((*STATE()->opcodeData) != BRK_IMPLIED) ||
+                       (((*STATE()->opcodeData) == BRK_IMPLIED) && (STATE()->m_instrCycle == 7)) )
                   {
-                     m_phase = 0;
+                     STATE()->m_phase = 0;
                   }
                }
             }
          }
       }
-      while ( (!m_killed) && (m_curCycles > 0) );
+      while ( (!STATE()->m_killed) && (STATE()->m_curCycles > 0) );
    }
    else
    {
       // Run APU for cycles...
       while ( cycles )
       {
-         CAPU::EMULATE ();
+         CAPU::EMULATE<HOOKS> ();
          cycles--;
       }
    }
 }
 
+void C6502::PROFILECALL ( uint8_t sp )
+{
+   STATE()->m_profiler->Call ( rPC(), CNES::ABSADDR(rPC()), sp, STATE()->m_cycles );
+}
+
 void C6502::APUDMAREQ ( uint16_t addr )
 {
-   m_dmaRequest = 3;
-   m_readDmaAddr = addr;
+   STATE()->m_dmaRequest = 3;
+   STATE()->m_readDmaAddr = addr;
 }
 
+template <class HOOKS>
 void C6502::ADVANCE ( bool stealing )
 {
    // If this cycle is being stolen, don't check whether IRQ/NMI needs to happen.
    if ( !stealing )
    {
       // NMI is ignored if it is asserted in the 6th or 7th cycles of a BRK.
-      if ( ((*opcodeData) != BRK_IMPLIED) ||
-           (((*opcodeData) == BRK_IMPLIED) &&
-           (m_instrCycle >= 0) &&
-           (m_instrCycle < 5)) )
+      if ( ((*STATE()->opcodeData) != BRK_IMPLIED) ||
+           (((*STATE()->opcodeData) == BRK_IMPLIED) &&
+           (STATE()->m_instrCycle >= 0) &&
+           (STATE()->m_instrCycle < 5)) )
       {
          // NMI is edge-sensitive thus it will only be marked as pending
          // if an assertion occurred recently.  Once marked as pending it
          // is cleared as not asserted to prevent multiple NMIs on a single
          // edge.
-         if ( m_nmiAsserted )
+         if ( STATE()->m_nmiAsserted )
          {
             // NMI is now pending to the CPU.
-            m_nmiPending = true;
-            m_nmiAsserted = false;
+            STATE()->m_nmiPending = true;
+            STATE()->m_nmiAsserted = false;
          }
       }
 
-      if ( pOpcodeStruct && (pOpcodeStruct->checkInterruptCycleMap&(1<<m_instrCycle)) )
+      if ( STATE()->pOpcodeStruct && (STATE()->pOpcodeStruct->checkInterruptCycleMap&(1<<STATE()->m_instrCycle)) )
       {
          // IRQ is level-sensitive thus it will always be marked as
          // "pending" if it has been asserted and not negated by the peripheral (and the
          // special cases described below are considered).
-         if ( m_irqAsserted && !rI() )
+         if ( STATE()->m_irqAsserted && !rI() )
          {
             // IRQ is now pending to the CPU.
-            m_irqPending = true;
+            STATE()->m_irqPending = true;
          }
       }
    }
@@ -818,51 +827,52 @@ void C6502::ADVANCE ( bool stealing )
    MAPPERFUNC->sync_cpu();
 
    // Run APU for one cycle...
-   CAPU::EMULATE ();
+   CAPU::EMULATE<HOOKS> ();
 
    // Increment running cycle counters...
-   m_cycles++;
+   STATE()->m_cycles++;
 
    // If stealing, don't move instruction cycle forward.
    if ( !stealing )
    {
-      m_instrCycle++;
+      STATE()->m_instrCycle++;
    }
 
    // Decrement cycles available counter...
-   m_curCycles--;
+   STATE()->m_curCycles--;
 }
 
+template <class HOOKS>
 bool C6502::DMA( void )
 {
    bool doCycle = true;
-   static uint8_t databuf;
+   uint8_t& databuf = STATE()->m_dmaData;
 
    // If the DMC DMA request is active it means the CPU was writing when
    // the DMC DMA controller went active.  We need to assert RDY on the next
    // CPU read cycle.  Check if that is now.
-   if ( !m_dmaRequest )
+   if ( !STATE()->m_dmaRequest )
    {
-      if ( !m_write )
+      if ( !STATE()->m_write )
       {
-         if ( m_writeDmaCounter )
+         if ( STATE()->m_writeDmaCounter )
          {
-            m_readDmaCounter = 2;
+            STATE()->m_readDmaCounter = 2;
          }
          else
          {
-            m_readDmaCounter = 4;
+            STATE()->m_readDmaCounter = 4;
          }
          if ( !(_CYCLES()&1) )
          {
-            m_readDmaCounter++;
+            STATE()->m_readDmaCounter++;
          }
-         m_dmaRequest--;
+         STATE()->m_dmaRequest--;
       }
    }
-   if ( m_dmaRequest > 0 )
+   if ( STATE()->m_dmaRequest > 0 )
    {
-      m_dmaRequest--;
+      STATE()->m_dmaRequest--;
    }
 
    // Run the DMA controller cycles if necessary.
@@ -871,19 +881,19 @@ bool C6502::DMA( void )
    {
       // APU DMC DMA happens even if sprite DMA is occurring.
       // If we're in the waiting period before DMA, wait.
-      if ( m_readDmaCounter > 4 )
+      if ( STATE()->m_readDmaCounter > 4 )
       {
-         m_readDmaCounter--;
+         STATE()->m_readDmaCounter--;
          goto done;
       }
       // If we're in the DMC DMA RDY-phase, just steal a cycle if there's
       // no sprite DMA already stealing them.
-      if ( m_readDmaCounter > 2 )
+      if ( STATE()->m_readDmaCounter > 2 )
       {
-         m_readDmaCounter--;
-         if ( !m_writeDmaCounter )
+         STATE()->m_readDmaCounter--;
+         if ( !STATE()->m_writeDmaCounter )
          {
-            STEAL ( 1, eNESSource_APU );
+            STEAL<HOOKS> ( 1, eNESSource_APU );
             doCycle = false;
             goto done;
          }
@@ -894,40 +904,40 @@ bool C6502::DMA( void )
          }
       }
       // If we're ready to do the DMC DMA read, do it.
-      if ( m_readDmaCounter == 2 )
+      if ( STATE()->m_readDmaCounter == 2 )
       {
-         CAPU::DMASAMPLE ( DMA(m_readDmaAddr) );
-         m_readDmaCounter--;
+         CAPU::DMASAMPLE ( DMA<HOOKS>(STATE()->m_readDmaAddr) );
+         STATE()->m_readDmaCounter--;
          doCycle = false;
 
-         if ( nesIsDebuggable() )
+         if ( HOOKS::ENABLED() )
          {
             // Check for APU DMC channel DMA breakpoint event...
-            CNES::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,0,APU_EVENT_DMC_DMA);
+            HOOKS::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,0,APU_EVENT_DMC_DMA);
          }
 
          goto done;
       }
       // If we're in the sprite DMA RDY-phase, just steal a cycle.
-      if ( m_writeDmaCounter > 512 )
+      if ( STATE()->m_writeDmaCounter > 512 )
       {
-         STEAL ( 1, eNESSource_PPU );
-         m_writeDmaCounter--;
+         STEAL<HOOKS> ( 1, eNESSource_PPU );
+         STATE()->m_writeDmaCounter--;
          doCycle = false;
          goto done;
       }
       // If we're ready to do the sprite DMA read, do it.
-      if ( m_writeDmaCounter )
+      if ( STATE()->m_writeDmaCounter )
       {
-         databuf = DMA(m_writeDmaAddr|(((512-m_writeDmaCounter)>>1)&0xFF));
+         databuf = DMA<HOOKS>(STATE()->m_writeDmaAddr|(((512-STATE()->m_writeDmaCounter)>>1)&0xFF));
 
-         if ( nesIsDebuggable() )
+         if ( HOOKS::ENABLED() )
          {
             // Check for PPU cycle breakpoint...
-            CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, (512-m_writeDmaCounter)>>1, PPU_EVENT_SPRITE_DMA );
+            HOOKS::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, (512-STATE()->m_writeDmaCounter)>>1, PPU_EVENT_SPRITE_DMA );
          }
 
-         m_writeDmaCounter--;
+         STATE()->m_writeDmaCounter--;
          doCycle = false;
          goto done;
       }
@@ -935,19 +945,19 @@ bool C6502::DMA( void )
    else
    {
       // If we're in the waiting period before DMA, wait.
-      if ( m_readDmaCounter > 4 )
+      if ( STATE()->m_readDmaCounter > 4 )
       {
-         m_readDmaCounter--;
+         STATE()->m_readDmaCounter--;
          goto done;
       }
       // If we're in the DMC DMA RDY-phase, just steal a cycle if there's
       // no sprite DMA already stealing them.
-      if ( m_readDmaCounter > 2 )
+      if ( STATE()->m_readDmaCounter > 2 )
       {
-         m_readDmaCounter--;
-         if ( !m_writeDmaCounter )
+         STATE()->m_readDmaCounter--;
+         if ( !STATE()->m_writeDmaCounter )
          {
-            STEAL ( 1, eNESSource_APU );
+            STEAL<HOOKS> ( 1, eNESSource_APU );
             doCycle = false;
             goto done;
          }
@@ -959,36 +969,36 @@ bool C6502::DMA( void )
       }
       // If APU DMC DMA occurred on the read-beat, skip this
       // write-beat if sprite DMA is in progress.
-      if ( m_readDmaCounter == 1 )
+      if ( STATE()->m_readDmaCounter == 1 )
       {
-         if ( m_writeDmaCounter )
+         if ( STATE()->m_writeDmaCounter )
          {
-            m_readDmaCounter--;
-            STEAL(rPC(),eNESSource_APU); // Put CPU on bus.
+            STATE()->m_readDmaCounter--;
+            STEAL<HOOKS>(rPC(),eNESSource_APU); // Put CPU on bus.
             doCycle = false;
             goto done;
          }
          else
          {
-            m_readDmaCounter--;
+            STATE()->m_readDmaCounter--;
             goto done;
          }
       }
       // If we're in the sprite DMA RDY-phase, just steal a cycle.
-      if ( m_writeDmaCounter > 512 )
+      if ( STATE()->m_writeDmaCounter > 512 )
       {
-         STEAL ( 1, eNESSource_PPU );
-         m_writeDmaCounter--;
+         STEAL<HOOKS> ( 1, eNESSource_PPU );
+         STATE()->m_writeDmaCounter--;
          doCycle = false;
          goto done;
       }
       // If we're ready to do the sprite DMA write, do it.
-      if ( m_writeDmaCounter )
+      if ( STATE()->m_writeDmaCounter )
       {
-         DMA ( (m_writeDmaAddr)|(((512-m_writeDmaCounter)>>1)&0xFF),
+         DMA<HOOKS> ( (STATE()->m_writeDmaAddr)|(((512-STATE()->m_writeDmaCounter)>>1)&0xFF),
                OAMDATA,
                databuf );
-         m_writeDmaCounter--;
+         STATE()->m_writeDmaCounter--;
          doCycle = false;
          goto done;
       }
@@ -996,60 +1006,60 @@ bool C6502::DMA( void )
    done:
 #if 0
 
-   if ( (m_readDmaCounter > 1) && (!m_writeDmaCounter) )
+   if ( (STATE()->m_readDmaCounter > 1) && (!STATE()->m_writeDmaCounter) )
    {
-      STEAL ( 1, eNESSource_APU );
-      m_readDmaCounter--;
+      STEAL<HOOKS> ( 1, eNESSource_APU );
+      STATE()->m_readDmaCounter--;
       doCycle = false;
    }
-   else if ( m_readDmaCounter > 1 )
+   else if ( STATE()->m_readDmaCounter > 1 )
    {
-      m_readDmaCounter--;
+      STATE()->m_readDmaCounter--;
       doCycle = false;
    }
-   else if ( m_writeDmaCounter > 512 )
+   else if ( STATE()->m_writeDmaCounter > 512 )
    {
-      STEAL ( 1, eNESSource_PPU );
-      m_writeDmaCounter--;
+      STEAL<HOOKS> ( 1, eNESSource_PPU );
+      STATE()->m_writeDmaCounter--;
       doCycle = false;
    }
-   else if ( m_readDmaCounter == 1 && (!m_writeDmaCounter) )
+   else if ( STATE()->m_readDmaCounter == 1 && (!STATE()->m_writeDmaCounter) )
    {
-      CAPU::DMASAMPLE ( DMA(m_readDmaAddr) );
-      m_readDmaCounter--;
+      CAPU::DMASAMPLE ( DMA<HOOKS>(STATE()->m_readDmaAddr) );
+      STATE()->m_readDmaCounter--;
       doCycle = false;
    }
-   else if ( m_readDmaCounter == 1 )
+   else if ( STATE()->m_readDmaCounter == 1 )
    {
       if ( _CYCLES()&1 )
       {
-         CAPU::DMASAMPLE ( DMA(m_readDmaAddr) );
+         CAPU::DMASAMPLE ( DMA<HOOKS>(STATE()->m_readDmaAddr) );
          doCycle = false;
       }
       else
       {
-         STEAL ( 1, eNESSource_APU );
-         m_readDmaCounter--;
+         STEAL<HOOKS> ( 1, eNESSource_APU );
+         STATE()->m_readDmaCounter--;
          doCycle = false;
       }
    }
-   else if ( m_writeDmaCounter && (m_readDmaCounter != 1) )
+   else if ( STATE()->m_writeDmaCounter && (STATE()->m_readDmaCounter != 1) )
    {
       // If this is a read-beat, do the read.
-      if ( !(m_writeDmaCounter&0x01) )
+      if ( !(STATE()->m_writeDmaCounter&0x01) )
       {
-         databuf = DMA(m_writeDmaAddr|(((512-m_writeDmaCounter)>>1)&0xFF));
+         databuf = DMA<HOOKS>(STATE()->m_writeDmaAddr|(((512-STATE()->m_writeDmaCounter)>>1)&0xFF));
          doCycle = false;
       }
       // If this is a write-beat, do the write.
       else
       {
-         DMA ( (m_writeDmaAddr)|(((512-m_writeDmaCounter)>>1)&0xFF),
+         DMA<HOOKS> ( (STATE()->m_writeDmaAddr)|(((512-STATE()->m_writeDmaCounter)>>1)&0xFF),
                OAMDATA,
                databuf );
          doCycle = false;
       }
-      m_writeDmaCounter--;
+      STATE()->m_writeDmaCounter--;
    }
 #endif
 
@@ -1057,51 +1067,51 @@ bool C6502::DMA( void )
    // Steal a CPU cycle if it is the appropriate time to do so...
    // If the CPU is currently writing, we don't bother it unless we're
    // already bothering it.
-   if ( (m_readDmaCounter > 1) && ((m_writeDmaCounter == 0) || (!(m_writeDmaCounter&1))) )
+   if ( (STATE()->m_readDmaCounter > 1) && ((STATE()->m_writeDmaCounter == 0) || (!(STATE()->m_writeDmaCounter&1))) )
    {
-      if ( m_write )
+      if ( STATE()->m_write )
       {
-         m_readDmaCounter--;
+         STATE()->m_readDmaCounter--;
          return true;
       }
       else
       {
-         STEAL ( 1, eNESSource_APU );
-         m_readDmaCounter--;
+         STEAL<HOOKS> ( 1, eNESSource_APU );
+         STATE()->m_readDmaCounter--;
          doCycle = false;
       }
    }
-   if ( m_writeDmaCounter > 512 )
+   if ( STATE()->m_writeDmaCounter > 512 )
    {
-      STEAL ( 1, eNESSource_PPU );
-      m_writeDmaCounter--;
+      STEAL<HOOKS> ( 1, eNESSource_PPU );
+      STATE()->m_writeDmaCounter--;
       doCycle = false;
    }
 
    // Perform DMA if necessary.
    if ( doCycle )
    {
-      if ( (m_readDmaCounter == 1) && ((m_writeDmaCounter == 0) || (!(m_writeDmaCounter&1))) )
+      if ( (STATE()->m_readDmaCounter == 1) && ((STATE()->m_writeDmaCounter == 0) || (!(STATE()->m_writeDmaCounter&1))) )
       {
-         CAPU::DMASAMPLE ( DMA(m_readDmaAddr) );
-         m_readDmaCounter = 0;
+         CAPU::DMASAMPLE ( DMA<HOOKS>(STATE()->m_readDmaAddr) );
+         STATE()->m_readDmaCounter = 0;
          doCycle = false;
       }
-      if ( m_writeDmaCounter && doCycle )
+      if ( STATE()->m_writeDmaCounter && doCycle )
       {
-         if ( !(m_writeDmaCounter&1) )
+         if ( !(STATE()->m_writeDmaCounter&1) )
          {
-            databuf = DMA(m_writeDmaAddr|(((512-m_writeDmaCounter)>>1)&0xFF));
-            m_writeDmaCounter--;
+            databuf = DMA<HOOKS>(STATE()->m_writeDmaAddr|(((512-STATE()->m_writeDmaCounter)>>1)&0xFF));
+            STATE()->m_writeDmaCounter--;
             doCycle = false;
          }
          // If we are on a DMA cycle, do the DMA...
          else
          {
-            DMA ( (m_writeDmaAddr)|(((512-m_writeDmaCounter)>>1)&0xFF),
+            DMA<HOOKS> ( (STATE()->m_writeDmaAddr)|(((512-STATE()->m_writeDmaCounter)>>1)&0xFF),
                   OAMDATA,
                   databuf );
-            m_writeDmaCounter--;
+            STATE()->m_writeDmaCounter--;
             doCycle = false;
          }
       }
@@ -1114,9 +1124,10 @@ bool C6502::DMA( void )
 
 // ILLEGAL/UNDOCUMENTED OPCODES
 
+template <class HOOKS>
 void C6502::KIL ( void )
 {
-   m_killed = true;
+   STATE()->m_killed = true;
    return;
 }
 
@@ -1129,9 +1140,10 @@ void C6502::KIL ( void )
 // ------------|-----------|---|---|---
 // Immediate   |AAC #arg   |$0B| 2 | 2
 // Immediate   |AAC #arg   |$2B| 2 | 2
+template <class HOOKS>
 void C6502::ANC ( void )
 {
-   wA ( rA()&(*data) );
+   wA ( rA()&(*STATE()->data) );
    wN ( rA()&0x80 );
    wC ( rA()&0x80 );
    wZ ( !rA() );
@@ -1147,9 +1159,10 @@ void C6502::ANC ( void )
 // Addressing  |Mnemonics  |Opc|Sz | n
 // ------------|-----------|---|---|---
 // Immediate   |ASR #arg   |$4B| 2 | 2
+template <class HOOKS>
 void C6502::ALR ( void )
 {
-   wA ( (rA()&(*data)) );
+   wA ( (rA()&(*STATE()->data)) );
    wC ( rA()&0x01 );
    wA ( rA()>>1 );
    wN ( rA()&0x80 );
@@ -1171,9 +1184,10 @@ void C6502::ALR ( void )
 // Addressing  |Mnemonics  |Opc|Sz | n
 // ------------|-----------|---|---|---
 // Immediate   |ARR #arg   |$6B| 2 | 2
+template <class HOOKS>
 void C6502::ARR ( void )
 {
-   wA ( (rC()<<7)|((rA()>>1)&((*data)>>1)) );
+   wA ( (rC()<<7)|((rA()>>1)&((*STATE()->data)>>1)) );
    wN ( rA()&0x80 );
    wZ ( !rA() );
 
@@ -1209,6 +1223,7 @@ void C6502::ARR ( void )
 // Addressing  |Mnemonics  |Opc|Sz | n
 // ------------|-----------|---|---|---
 // Immediate   |XAA #arg   |$8B| 2 | 2
+template <class HOOKS>
 void C6502::XAA ( void )
 {
    // From kevtris on #nesdev:
@@ -1226,14 +1241,15 @@ void C6502::XAA ( void )
 // ------------|-----------|---|---|---
 // Absolute,Y  |AXA arg,Y  |$9F| 3 | 5
 // (Indirect),Y|AXA arg    |$93| 2 | 6
+template <class HOOKS>
 void C6502::AXA ( void )
 {
    uint16_t addr;
    uint8_t  val;
 
-   addr = MAKEADDR ( amode, data );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
    val = (rX()&rA())&7;
-   MEM ( addr, val );
+   MEM<HOOKS> ( addr, val );
 
    return;
 }
@@ -1251,15 +1267,16 @@ void C6502::AXA ( void )
 // Addressing  |Mnemonics  |Opc|Sz | n
 // ------------|-----------|---|---|---
 // Absolute,Y  |XAS arg,Y  |$9B| 3 | 5
+template <class HOOKS>
 void C6502::TAS ( void )
 {
    uint16_t addr;
    uint8_t  val;
 
    wSP ( rX()&rA() );
-   addr = MAKEADDR ( amode, data );
-   val = (rSP()&((*(data+1))+1));
-   MEM ( addr, val );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   val = (rSP()&((*(STATE()->data+1))+1));
+   MEM<HOOKS> ( addr, val );
 
    return;
 }
@@ -1276,16 +1293,17 @@ void C6502::TAS ( void )
 // Addressing  |Mnemonics  |Opc|Sz | n
 // ------------|-----------|---|---|---
 // Absolute,X  |SYA arg,X  |$9C| 3 | 5
+template <class HOOKS>
 void C6502::SAY ( void )
 {
    uint16_t addr;
    uint8_t  val;
 
-   addr = MAKEADDR ( amode, data );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
    val = (rY()&((addr>>8)+1));
    addr &= 0x00FF;
    addr |= (val<<8);
-   MEM ( addr, val );
+   MEM<HOOKS> ( addr, val );
 
    return;
 }
@@ -1302,16 +1320,17 @@ void C6502::SAY ( void )
 // Addressing  |Mnemonics  |Opc|Sz | n
 // ------------|-----------|---|---|---
 // Absolute,Y  |SXA arg,Y  |$9E| 3 | 5
+template <class HOOKS>
 void C6502::XAS ( void )
 {
    uint16_t addr;
    uint8_t  val;
 
-   addr = MAKEADDR ( amode, data );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
    val = (rX()&((addr>>8)+1));
    addr &= 0x00FF;
    addr |= (val<<8);
-   MEM ( addr, val );
+   MEM<HOOKS> ( addr, val );
 
    return;
 }
@@ -1324,9 +1343,10 @@ void C6502::XAS ( void )
 // Addressing  |Mnemonics  |Opc|Sz | n
 // ------------|-----------|---|---|---
 // Immediate   |ATX #arg   |$AB| 2 | 2
+template <class HOOKS>
 void C6502::OAL ( void )
 {
-   wA ( (*data) );
+   wA ( (*STATE()->data) );
    wX ( rA() );
    wN ( rX()&0x80 );
    wZ ( !rX() );
@@ -1343,12 +1363,13 @@ void C6502::OAL ( void )
 // Addressing  |Mnemonics  |Opc|Sz | n
 // ------------|-----------|---|---|---
 // Absolute,Y  |LAR arg,Y  |$BB| 3 | 4 *
+template <class HOOKS>
 void C6502::LAS ( void )
 {
    uint16_t addr;
 
-   addr = MAKEADDR ( amode, data );
-   wA ( rSP()&MEM(addr) );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   wA ( rSP()&MEM<HOOKS>(addr) );
    wX ( rA() );
    wSP ( rA() );
    wN ( rA()&0x80 );
@@ -1366,12 +1387,13 @@ void C6502::LAS ( void )
 // Addressing  |Mnemonics  |Opc|Sz | n
 // ------------|-----------|---|---|---
 // Immediate   |AXS #arg   |$CB| 2 | 2
+template <class HOOKS>
 void C6502::SAX ( void )
 {
    int16_t val;
 
    wX ( rA()&rX() );
-   val = rX()-(*data);
+   val = rX()-(*STATE()->data);
    wX ( val&0xFF );
    wN ( rX()&0x80 );
    wZ ( !rX() );
@@ -1395,16 +1417,17 @@ void C6502::SAX ( void )
 // Absolute,Y  |SLO arg,Y  |$1B| 3 | 7
 // (Indirect,X)|SLO (arg,X)|$03| 2 | 8
 // (Indirect),Y|SLO (arg),Y|$13| 2 | 8
+template <class HOOKS>
 void C6502::ASO ( void )
 {
    uint16_t addr;
    uint16_t val;
 
-   addr = MAKEADDR ( amode, data );
-   val = MEM ( addr );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   val = MEM<HOOKS> ( addr );
 
    val <<= 1;
-   MEM ( addr, (uint8_t)val );
+   MEM<HOOKS> ( addr, (uint8_t)val );
    wC ( val&0x100 );
    val &= 0xFF;
    wA ( rA()|val );
@@ -1413,7 +1436,7 @@ void C6502::ASO ( void )
 
    // A missing memory cycle here?
    // Synchronize CPU and APU...
-   ADVANCE();
+   ADVANCE<HOOKS>();
 
    return;
 }
@@ -1429,13 +1452,14 @@ void C6502::ASO ( void )
 // Zero Page,Y |AAX arg,Y  |$97| 2 | 4
 // (Indirect,X)|AAX (arg,X)|$83| 2 | 6
 // Absolute    |AAX arg    |$8F| 3 | 4
+template <class HOOKS>
 void C6502::AXS ( void )
 {
    uint16_t addr;
 
-   addr = MAKEADDR ( amode, data );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
 
-   MEM ( addr, rA()&rX() );
+   MEM<HOOKS> ( addr, rA()&rX() );
 
    return;
 }
@@ -1460,18 +1484,19 @@ void C6502::AXS ( void )
 //  |  (Indirect),Y  |   ORA (Oper),Y        |    11   |    2    |    5*    |
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 on page crossing
+template <class HOOKS>
 void C6502::ORA ( void )
 {
    uint16_t addr;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      wA ( rA()|(*data) );
+      wA ( rA()|(*STATE()->data) );
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      wA ( rA()|MEM(addr) );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      wA ( rA()|MEM<HOOKS>(addr) );
    }
 
    wN ( rA()&0x80 );
@@ -1495,33 +1520,34 @@ void C6502::ORA ( void )
 //  |  Absolute      |   ASL Oper            |    0E   |    3    |    6     |
 //  |  Absolute, X   |   ASL Oper,X          |    1E   |    3    |    7     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::ASL ( void )
 {
    uint16_t addr = 0x0000;
    uint16_t val;
 
-   if ( amode == AM_ACCUMULATOR )
+   if ( STATE()->amode == AM_ACCUMULATOR )
    {
       val = rA ();
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      val = MEM ( addr );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      val = MEM<HOOKS> ( addr );
 
       // dummy write
-      MEM ( addr, val );
+      MEM<HOOKS> ( addr, val );
    }
 
    val <<= 1;
 
-   if ( amode == AM_ACCUMULATOR )
+   if ( STATE()->amode == AM_ACCUMULATOR )
    {
       wA ( (uint8_t)val );
    }
    else
    {
-      MEM ( addr, (uint8_t)val );
+      MEM<HOOKS> ( addr, (uint8_t)val );
    }
 
    wC ( val&0x100 );
@@ -1541,6 +1567,7 @@ void C6502::ASL ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   PHP                 |    08   |    1    |    3     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::PHP ( void )
 {
    sB();
@@ -1561,30 +1588,31 @@ void C6502::PHP ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if branch occurs to same page.
 //  * Add 2 if branch occurs to different page.
+template <class HOOKS>
 void C6502::BPL ( void )
 {
    uint32_t target;
 
-   target = rPC()+GETSIGNED8(data,0);
+   target = rPC()+GETSIGNED8(STATE()->data,0);
 
    if ( !rN() )
    {
       // Synchronize CPU and APU...
-      MEM ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(data,0))&0xFF) );
+      MEM<HOOKS> ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(STATE()->data,0))&0xFF) );
 
       // Extra cycle.
       if ( (rPC()&0xFF00) != (target&0xFF00) )
       {
          // Synchronize CPU and APU...
-         MEM ( target );
+         MEM<HOOKS> ( target );
       }
 
       wPC ( target );
 
-      if ( rPC() == m_pcGoto )
+      if ( rPC() == STATE()->m_pcGoto )
       {
          CNES::STEPCPUBREAKPOINT();
-         m_pcGoto = 0xFFFFFFFF;
+         STATE()->m_pcGoto = 0xFFFFFFFF;
       }
    }
 
@@ -1601,6 +1629,7 @@ void C6502::BPL ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   CLC                 |    18   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::CLC ( void )
 {
    cC ();
@@ -1618,22 +1647,28 @@ void C6502::CLC ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Absolute      |   JSR Oper            |    20   |    3    |    6     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::JSR ( void )
 {
    // Synchronize CPU and APU.
-   MEM ( GETSTACKADDR() );
+   MEM<HOOKS> ( GETSTACKADDR() );
 
    PUSH ( GETHI8(rPC()) );
    PUSH ( GETLO8(rPC()) );
 
-   *(data+1) = FETCH ();
+   *(STATE()->data+1) = FETCH<HOOKS> ();
+
+   wPC ( MAKE16(GETUNSIGNED8(STATE()->data,0),GETUNSIGNED8(STATE()->data,1)) );
 
-   wPC ( MAKE16(GETUNSIGNED8(data,0),GETUNSIGNED8(data,1)) );
+   if ( HOOKS::ENABLED() )
+   {
+      PROFILECALL ( rSP()+2 );
+   }
 
-   if ( rPC() == m_pcGoto )
+   if ( rPC() == STATE()->m_pcGoto )
    {
       CNES::STEPCPUBREAKPOINT();
-      m_pcGoto = 0xFFFFFFFF;
+      STATE()->m_pcGoto = 0xFFFFFFFF;
    }
 
    return;
@@ -1657,18 +1692,19 @@ void C6502::JSR ( void )
 //  |  (Indirect,Y)  |   AND (Oper),Y        |    31   |    2    |    5*    |
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if page boundary is crossed.
+template <class HOOKS>
 void C6502::AND ( void )
 {
    uint16_t addr;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      wA ( rA()&(*data) );
+      wA ( rA()&(*STATE()->data) );
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      wA ( rA()&MEM(addr) );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      wA ( rA()&MEM<HOOKS>(addr) );
    }
 
    wN ( rA()&0x80 );
@@ -1691,14 +1727,15 @@ void C6502::AND ( void )
 //  |  Zero Page     |   BIT Oper            |    24   |    2    |    3     |
 //  |  Absolute      |   BIT Oper            |    2C   |    3    |    4     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::BIT ( void )
 {
    uint16_t addr;
    uint8_t  val;
 
-   addr = MAKEADDR ( amode, data );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
 
-   val = MEM ( addr );
+   val = MEM<HOOKS> ( addr );
 
    wN ( val&0x80 );
    wV ( val&0x40 );
@@ -1725,22 +1762,23 @@ void C6502::BIT ( void )
 //  |  Absolute      |   ROL Oper            |    2E   |    3    |    6     |
 //  |  Absolute,X    |   ROL Oper,X          |    3E   |    3    |    7     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::ROL ( void )
 {
    uint16_t addr = 0x0000;
    uint16_t val;
 
-   if ( amode == AM_ACCUMULATOR )
+   if ( STATE()->amode == AM_ACCUMULATOR )
    {
       val = rA ();
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      val = MEM ( addr );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      val = MEM<HOOKS> ( addr );
 
       // dummy write
-      MEM ( addr, val );
+      MEM<HOOKS> ( addr, val );
    }
 
    val <<= 1;
@@ -1750,13 +1788,13 @@ void C6502::ROL ( void )
    wN ( val&0x80 );
    wZ ( !val );
 
-   if ( amode == AM_ACCUMULATOR )
+   if ( STATE()->amode == AM_ACCUMULATOR )
    {
       wA ( (uint8_t)val );
    }
    else
    {
-      MEM ( addr, (uint8_t)val );
+      MEM<HOOKS> ( addr, (uint8_t)val );
    }
 
    return;
@@ -1772,12 +1810,13 @@ void C6502::ROL ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   PLP                 |    28   |    1    |    4     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::PLP ( void )
 {
    // Synchronize CPU and APU...
-   MEM ( GETSTACKADDR() );
+   MEM<HOOKS> ( GETSTACKADDR() );
 
-   wF ( POP() );
+   wF ( POP<HOOKS>() );
 
    return;
 }
@@ -1794,30 +1833,31 @@ void C6502::PLP ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if branch occurs to same page.
 //  * Add 1 if branch occurs to different page.
+template <class HOOKS>
 void C6502::BMI ( void )
 {
    uint32_t target;
 
-   target = rPC()+GETSIGNED8(data,0);
+   target = rPC()+GETSIGNED8(STATE()->data,0);
 
    if ( rN() )
    {
       // Synchronize CPU and APU...
-      MEM ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(data,0))&0xFF) );
+      MEM<HOOKS> ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(STATE()->data,0))&0xFF) );
 
       // Extra cycle.
       if ( (rPC()&0xFF00) != (target&0xFF00) )
       {
          // Synchronize CPU and APU...
-         MEM ( target );
+         MEM<HOOKS> ( target );
       }
 
       wPC ( target );
 
-      if ( rPC() == m_pcGoto )
+      if ( rPC() == STATE()->m_pcGoto )
       {
          CNES::STEPCPUBREAKPOINT();
-         m_pcGoto = 0xFFFFFFFF;
+         STATE()->m_pcGoto = 0xFFFFFFFF;
       }
    }
 
@@ -1834,6 +1874,7 @@ void C6502::BMI ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   SEC                 |    38   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::SEC ( void )
 {
    sC ();
@@ -1850,6 +1891,7 @@ void C6502::SEC ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   RTI                 |    4D   |    1    |    6     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::RTI ( void )
 {
    uint8_t pclo;
@@ -1857,21 +1899,26 @@ void C6502::RTI ( void )
    uint8_t f;
 
    // Synchronize CPU and APU...
-   MEM ( GETSTACKADDR() );
+   MEM<HOOKS> ( GETSTACKADDR() );
 
-   f = POP();
-   pclo = POP ();
-   pchi = POP ();
+   f = POP<HOOKS>();
+   pclo = POP<HOOKS> ();
+   pchi = POP<HOOKS> ();
    wPC ( MAKE16(pclo,pchi) );
 
    wF ( f );
 
-   m_irqPending = false;
+   STATE()->m_irqPending = false;
 
-   if ( rPC() == m_pcGoto )
+   if ( HOOKS::ENABLED() )
+   {
+      STATE()->m_profiler->Return ( rSP(), STATE()->m_cycles );
+   }
+
+   if ( rPC() == STATE()->m_pcGoto )
    {
       CNES::STEPCPUBREAKPOINT();
-      m_pcGoto = 0xFFFFFFFF;
+      STATE()->m_pcGoto = 0xFFFFFFFF;
    }
 
    return;
@@ -1895,18 +1942,19 @@ void C6502::RTI ( void )
 //  |  (Indirect),Y  |   EOR (Oper),Y        |    51   |    2    |    5*    |
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if page boundary is crossed.
+template <class HOOKS>
 void C6502::EOR ( void )
 {
    uint16_t addr;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      wA ( rA()^(*data) );
+      wA ( rA()^(*STATE()->data) );
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      wA ( rA()^MEM(addr) );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      wA ( rA()^MEM<HOOKS>(addr) );
    }
 
    wN ( rA()&0x80 );
@@ -1929,25 +1977,26 @@ void C6502::EOR ( void )
 // Absolute,Y  |SRE arg,Y  |$5B| 3 | 7
 // (Indirect,X)|SRE (arg,X)|$43| 2 | 8
 // (Indirect),Y|SRE (arg),Y|$53| 2 | 8
+template <class HOOKS>
 void C6502::LSE ( void )
 {
    uint16_t addr;
    uint16_t val;
 
-   addr = MAKEADDR ( amode, data );
-   val = MEM ( addr );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   val = MEM<HOOKS> ( addr );
 
    wC ( val&0x01 );
    val >>= 1;
    val &= 0xFF;
-   MEM ( addr, (uint8_t)val );
+   MEM<HOOKS> ( addr, (uint8_t)val );
    wA ( rA()^val );
    wN ( rA()&0x80 );
    wZ ( !rA() );
 
    // A missing memory cycle here?
    // Synchronize CPU and APU...
-   ADVANCE ();
+   ADVANCE<HOOKS> ();
 
    return;
 }
@@ -1967,22 +2016,23 @@ void C6502::LSE ( void )
 //  |  Absolute      |   LSR Oper            |    4E   |    3    |    6     |
 //  |  Absolute,X    |   LSR Oper,X          |    5E   |    3    |    7     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::LSR ( void )
 {
    uint16_t addr = 0x0000;
    uint16_t val;
 
-   if ( amode == AM_ACCUMULATOR )
+   if ( STATE()->amode == AM_ACCUMULATOR )
    {
       val = rA ();
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      val = MEM ( addr );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      val = MEM<HOOKS> ( addr );
 
       // dummy write
-      MEM ( addr, val );
+      MEM<HOOKS> ( addr, val );
    }
 
    wC ( val&0x01 );
@@ -1991,13 +2041,13 @@ void C6502::LSR ( void )
    cN ();
    wZ ( !val );
 
-   if ( amode == AM_ACCUMULATOR )
+   if ( STATE()->amode == AM_ACCUMULATOR )
    {
       wA ( (uint8_t)val );
    }
    else
    {
-      MEM ( addr, (uint8_t)val );
+      MEM<HOOKS> ( addr, (uint8_t)val );
    }
 
    return;
@@ -2013,6 +2063,7 @@ void C6502::LSR ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   PHA                 |    48   |    1    |    3     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::PHA ( void )
 {
    PUSH ( rA() );
@@ -2031,11 +2082,12 @@ void C6502::PHA ( void )
 //  |  Absolute      |   JMP Oper            |    4C   |    3    |    3     |
 //  |  Indirect      |   JMP (Oper)          |    6C   |    3    |    5     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::JMP ( void )
 {
-   uint32_t addr = MAKE16(GETUNSIGNED8(data,0),GETUNSIGNED8(data,1));
+   uint32_t addr = MAKE16(GETUNSIGNED8(STATE()->data,0),GETUNSIGNED8(STATE()->data,1));
 
-   if ( amode == AM_ABSOLUTE )
+   if ( STATE()->amode == AM_ABSOLUTE )
    {
       wPC ( addr );
    }
@@ -2043,18 +2095,18 @@ void C6502::JMP ( void )
    {
       if ( (addr&0xFF) == 0xFF )
       {
-         wPC ( MAKE16(MEM(addr),MEM(addr&0xFF00)) );
+         wPC ( MAKE16(MEM<HOOKS>(addr),MEM<HOOKS>(addr&0xFF00)) );
       }
       else
       {
-         wPC ( MAKE16(MEM(addr),MEM(addr+1)) );
+         wPC ( MAKE16(MEM<HOOKS>(addr),MEM<HOOKS>(addr+1)) );
       }
    }
 
-   if ( rPC() == m_pcGoto )
+   if ( rPC() == STATE()->m_pcGoto )
    {
       CNES::STEPCPUBREAKPOINT();
-      m_pcGoto = 0xFFFFFFFF;
+      STATE()->m_pcGoto = 0xFFFFFFFF;
    }
 
    return;
@@ -2072,30 +2124,31 @@ void C6502::JMP ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if branch occurs to same page.
 //  * Add 2 if branch occurs to different page.
+template <class HOOKS>
 void C6502::BVC ( void )
 {
    uint32_t target;
 
-   target = rPC()+GETSIGNED8(data,0);
+   target = rPC()+GETSIGNED8(STATE()->data,0);
 
    if ( !rV() )
    {
       // Synchronize CPU and APU...
-      MEM ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(data,0))&0xFF) );
+      MEM<HOOKS> ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(STATE()->data,0))&0xFF) );
 
       // Extra cycle.
       if ( (rPC()&0xFF00) != (target&0xFF00) )
       {
          // Synchronize CPU and APU...
-         MEM ( target );
+         MEM<HOOKS> ( target );
       }
 
       wPC ( target );
 
-      if ( rPC() == m_pcGoto )
+      if ( rPC() == STATE()->m_pcGoto )
       {
          CNES::STEPCPUBREAKPOINT();
-         m_pcGoto = 0xFFFFFFFF;
+         STATE()->m_pcGoto = 0xFFFFFFFF;
       }
    }
 
@@ -2112,6 +2165,7 @@ void C6502::BVC ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   CLI                 |    58   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::CLI ( void )
 {
    cI ();
@@ -2128,26 +2182,32 @@ void C6502::CLI ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   RTS                 |    60   |    1    |    6     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::RTS ( void )
 {
    uint8_t pclo;
    uint8_t pchi;
 
    // Synchronize CPU and APU...
-   MEM ( GETSTACKADDR() );
+   MEM<HOOKS> ( GETSTACKADDR() );
 
-   pclo = POP ();
-   pchi = POP ();
+   pclo = POP<HOOKS> ();
+   pchi = POP<HOOKS> ();
 
    // Synchronize CPU and APU...
    wPC ( (MAKE16(pclo,pchi)) );
-   FETCH ();
+   FETCH<HOOKS> ();
    wPC ( (MAKE16(pclo,pchi))+1 );
 
-   if ( rPC() == m_pcGoto )
+   if ( HOOKS::ENABLED() )
+   {
+      STATE()->m_profiler->Return ( rSP(), STATE()->m_cycles );
+   }
+
+   if ( rPC() == STATE()->m_pcGoto )
    {
       CNES::STEPCPUBREAKPOINT();
-      m_pcGoto = 0xFFFFFFFF;
+      STATE()->m_pcGoto = 0xFFFFFFFF;
    }
 
    return;
@@ -2171,20 +2231,21 @@ void C6502::RTS ( void )
 //  |  (Indirect),Y  |   ADC (Oper),Y        |    71   |    2    |    5*    |
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if page boundary is crossed.
+template <class HOOKS>
 void C6502::ADC ( void )
 {
    uint32_t addr;
    int16_t result;
    uint8_t val;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      val = (*data);
+      val = (*STATE()->data);
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      val = MEM ( addr );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      val = MEM<HOOKS> ( addr );
    }
 
    result = rA () + val + rC ();
@@ -2218,22 +2279,23 @@ void C6502::ADC ( void )
 //
 //    Note: ROR instruction is available on MCS650X microprocessors after
 //          June, 1976.
+template <class HOOKS>
 void C6502::ROR ( void )
 {
    uint32_t addr = 0x0000;
    uint16_t val;
 
-   if ( amode == AM_ACCUMULATOR )
+   if ( STATE()->amode == AM_ACCUMULATOR )
    {
       val = rA ();
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      val = MEM ( addr );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      val = MEM<HOOKS> ( addr );
 
       // dummy write
-      MEM ( addr, val );
+      MEM<HOOKS> ( addr, val );
    }
 
    val |= ( rC()*0x100 );
@@ -2243,13 +2305,13 @@ void C6502::ROR ( void )
    wN ( val&0x80 );
    wZ ( !val );
 
-   if ( amode == AM_ACCUMULATOR )
+   if ( STATE()->amode == AM_ACCUMULATOR )
    {
       wA ( (uint8_t)val );
    }
    else
    {
-      MEM ( addr, (uint8_t)val );
+      MEM<HOOKS> ( addr, (uint8_t)val );
    }
 
    return;
@@ -2269,26 +2331,27 @@ void C6502::ROR ( void )
 // Absolute,Y  |RLA arg,Y  |$3B| 3 | 7
 // (Indirect,X)|RLA (arg,X)|$23| 2 | 8
 // (Indirect),Y|RLA (arg),Y|$33| 2 | 8
+template <class HOOKS>
 void C6502::RLA ( void )
 {
    uint32_t addr;
    uint16_t val;
 
-   addr = MAKEADDR ( amode, data );
-   val = MEM ( addr );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   val = MEM<HOOKS> ( addr );
 
    val <<= 1;
    val |= rC();
    wC ( val&0x100 );
    val &= 0xFF;
    wA ( rA()&val );
-   MEM ( addr, (uint8_t)val );
+   MEM<HOOKS> ( addr, (uint8_t)val );
    wN ( rA()&0x80 );
    wZ ( !rA() );
 
    // A missing memory cycle here?
    // Synchronize CPU and APU...
-   ADVANCE ();
+   ADVANCE<HOOKS> ();
 
    return;
 }
@@ -2309,20 +2372,21 @@ void C6502::RLA ( void )
 // Absolute,Y  |RRA arg,Y  |$7B| 3 | 7
 // (Indirect,X)|RRA (arg,X)|$63| 2 | 8
 // (Indirect),Y|RRA (arg),Y|$73| 2 | 8
+template <class HOOKS>
 void C6502::RRA ( void )
 {
    uint32_t addr;
    uint16_t val;
    int16_t result;
 
-   addr = MAKEADDR ( amode, data );
-   val = MEM ( addr );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   val = MEM<HOOKS> ( addr );
 
    val |= ( rC()*0x100 );
    wC ( val&0x01 );
    val >>= 1;
    val &= 0xFF;
-   MEM ( addr, (uint8_t)val );
+   MEM<HOOKS> ( addr, (uint8_t)val );
 
    result = rA () + val + rC ();
 
@@ -2334,7 +2398,7 @@ void C6502::RRA ( void )
 
    // A missing memory cycle here?
    // Synchronize CPU and APU...
-   ADVANCE ();
+   ADVANCE<HOOKS> ();
 
    return;
 }
@@ -2349,12 +2413,13 @@ void C6502::RRA ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   PLA                 |    68   |    1    |    4     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::PLA ( void )
 {
    // Synchronize CPU and APU...
-   MEM ( GETSTACKADDR() );
+   MEM<HOOKS> ( GETSTACKADDR() );
 
-   wA ( POP() );
+   wA ( POP<HOOKS>() );
    wN ( rA()&0x80 );
    wZ ( !rA() );
 
@@ -2373,30 +2438,31 @@ void C6502::PLA ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if branch occurs to same page.
 //  * Add 2 if branch occurs to different page.
+template <class HOOKS>
 void C6502::BVS ( void )
 {
    uint32_t target;
 
-   target = rPC()+GETSIGNED8(data,0);
+   target = rPC()+GETSIGNED8(STATE()->data,0);
 
    if ( rV() )
    {
       // Synchronize CPU and APU...
-      MEM ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(data,0))&0xFF) );
+      MEM<HOOKS> ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(STATE()->data,0))&0xFF) );
 
       // Extra cycle.
       if ( (rPC()&0xFF00) != (target&0xFF00) )
       {
          // Synchronize CPU and APU...
-         MEM ( target );
+         MEM<HOOKS> ( target );
       }
 
       wPC ( target );
 
-      if ( rPC() == m_pcGoto )
+      if ( rPC() == STATE()->m_pcGoto )
       {
          CNES::STEPCPUBREAKPOINT();
-         m_pcGoto = 0xFFFFFFFF;
+         STATE()->m_pcGoto = 0xFFFFFFFF;
       }
    }
 
@@ -2412,6 +2478,7 @@ void C6502::BVS ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   SEI                 |    78   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::SEI ( void )
 {
    sI ();
@@ -2435,12 +2502,13 @@ void C6502::SEI ( void )
 //  |  (Indirect,X)  |   STA (Oper,X)        |    81   |    2    |    6     |
 //  |  (Indirect),Y  |   STA (Oper),Y        |    91   |    2    |    6     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::STA ( void )
 {
    uint16_t addr;
 
-   addr = MAKEADDR ( amode, data );
-   MEM ( addr, rA() );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   MEM<HOOKS> ( addr, rA() );
 
    return;
 }
@@ -2457,12 +2525,13 @@ void C6502::STA ( void )
 //  |  Zero Page,X   |   STY Oper,X          |    94   |    2    |    4     |
 //  |  Absolute      |   STY Oper            |    8C   |    3    |    4     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::STY ( void )
 {
    uint16_t addr;
 
-   addr = MAKEADDR ( amode, data );
-   MEM ( addr, rY() );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   MEM<HOOKS> ( addr, rY() );
 
    return;
 }
@@ -2479,12 +2548,13 @@ void C6502::STY ( void )
 //  |  Zero Page,Y   |   STX Oper,Y          |    96   |    2    |    4     |
 //  |  Absolute      |   STX Oper            |    8E   |    3    |    4     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::STX ( void )
 {
    uint16_t addr;
 
-   addr = MAKEADDR ( amode, data );
-   MEM ( addr, rX() );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   MEM<HOOKS> ( addr, rX() );
 
    return;
 }
@@ -2499,6 +2569,7 @@ void C6502::STX ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   DEY                 |    88   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::DEY ( void )
 {
    wY ( rY()-1 );
@@ -2517,6 +2588,7 @@ void C6502::DEY ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   TXA                 |    8A   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::TXA ( void )
 {
    wA ( rX() );
@@ -2537,30 +2609,31 @@ void C6502::TXA ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if branch occurs to same page.
 //  * Add 2 if branch occurs to different page.
+template <class HOOKS>
 void C6502::BCC ( void )
 {
    uint32_t target;
 
-   target = rPC()+GETSIGNED8(data,0);
+   target = rPC()+GETSIGNED8(STATE()->data,0);
 
    if ( !rC() )
    {
       // Synchronize CPU and APU...
-      MEM ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(data,0))&0xFF) );
+      MEM<HOOKS> ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(STATE()->data,0))&0xFF) );
 
       // Extra cycle.
       if ( (rPC()&0xFF00) != (target&0xFF00) )
       {
          // Synchronize CPU and APU...
-         MEM ( target );
+         MEM<HOOKS> ( target );
       }
 
       wPC ( target );
 
-      if ( rPC() == m_pcGoto )
+      if ( rPC() == STATE()->m_pcGoto )
       {
          CNES::STEPCPUBREAKPOINT();
-         m_pcGoto = 0xFFFFFFFF;
+         STATE()->m_pcGoto = 0xFFFFFFFF;
       }
    }
 
@@ -2577,6 +2650,7 @@ void C6502::BCC ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   TYA                 |    98   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::TYA ( void )
 {
    wA ( rY() );
@@ -2595,6 +2669,7 @@ void C6502::TYA ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   TXS                 |    9A   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::TXS ( void )
 {
    wSP ( rX() );
@@ -2616,18 +2691,19 @@ void C6502::TXS ( void )
 //  |  Absolute,X    |   LDY Oper,X          |    BC   |    3    |    4*    |
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 when page boundary is crossed.
+template <class HOOKS>
 void C6502::LDY ( void )
 {
    uint32_t addr;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      wY ( (*data) );
+      wY ( (*STATE()->data) );
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      wY ( MEM(addr) );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      wY ( MEM<HOOKS>(addr) );
    }
 
    wN ( rY()&0x80 );
@@ -2650,21 +2726,22 @@ void C6502::LDY ( void )
 // (Indirect,X)|LAX (arg,X)|$A3| 2 | 6
 // (Indirect),Y|LAX (arg),Y|$B3| 2 | 5 *
 //  * Add 1 if page boundary is crossed.
+template <class HOOKS>
 void C6502::LAX ( void )
 {
    uint8_t val;
 
    uint32_t addr;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      wA ( (*data) );
-      wX ( (*data) );
+      wA ( (*STATE()->data) );
+      wX ( (*STATE()->data) );
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      val = MEM ( addr ); // Single memory access cycle...
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      val = MEM<HOOKS> ( addr ); // Single memory access cycle...
       wA ( val );
       wX ( val );
    }
@@ -2693,18 +2770,19 @@ void C6502::LAX ( void )
 //  |  (Indirect),Y  |   LDA (Oper),Y        |    B1   |    2    |    5*    |
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if page boundary is crossed.
+template <class HOOKS>
 void C6502::LDA ( void )
 {
    uint32_t addr;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      wA ( (*data) );
+      wA ( (*STATE()->data) );
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      wA ( MEM(addr) );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      wA ( MEM<HOOKS>(addr) );
    }
 
    wN ( rA()&0x80 );
@@ -2728,18 +2806,19 @@ void C6502::LDA ( void )
 //  |  Absolute,Y    |   LDX Oper,Y          |    BE   |    3    |    4*    |
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 when page boundary is crossed.
+template <class HOOKS>
 void C6502::LDX ( void )
 {
    uint32_t addr;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      wX ( (*data) );
+      wX ( (*STATE()->data) );
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      wX ( MEM(addr) );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      wX ( MEM<HOOKS>(addr) );
    }
 
    wN ( rX()&0x80 );
@@ -2758,6 +2837,7 @@ void C6502::LDX ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   TAY                 |    A8   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::TAY ( void )
 {
    wY ( rA() );
@@ -2777,6 +2857,7 @@ void C6502::TAY ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   TAX                 |    AA   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::TAX ( void )
 {
    wX ( rA() );
@@ -2798,30 +2879,31 @@ void C6502::TAX ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if branch occurs to same  page.
 //  * Add 2 if branch occurs to next  page.
+template <class HOOKS>
 void C6502::BCS ( void )
 {
    uint32_t target;
 
-   target = rPC()+GETSIGNED8(data,0);
+   target = rPC()+GETSIGNED8(STATE()->data,0);
 
    if ( rC() )
    {
       // Synchronize CPU and APU...
-      MEM ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(data,0))&0xFF) );
+      MEM<HOOKS> ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(STATE()->data,0))&0xFF) );
 
       // Extra cycle.
       if ( (rPC()&0xFF00) != (target&0xFF00) )
       {
          // Synchronize CPU and APU...
-         MEM ( target );
+         MEM<HOOKS> ( target );
       }
 
       wPC ( target );
 
-      if ( rPC() == m_pcGoto )
+      if ( rPC() == STATE()->m_pcGoto )
       {
          CNES::STEPCPUBREAKPOINT();
-         m_pcGoto = 0xFFFFFFFF;
+         STATE()->m_pcGoto = 0xFFFFFFFF;
       }
    }
 
@@ -2838,6 +2920,7 @@ void C6502::BCS ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   CLV                 |    B8   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::CLV ( void )
 {
    cV ();
@@ -2855,6 +2938,7 @@ void C6502::CLV ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   TSX                 |    BA   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::TSX ( void )
 {
    wX ( rSP() );
@@ -2875,19 +2959,20 @@ void C6502::TSX ( void )
 //  |  Zero Page     |   CPY Oper            |    C4   |    2    |    3     |
 //  |  Absolute      |   CPY Oper            |    CC   |    3    |    4     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::CPY ( void )
 {
    uint16_t addr;
    uint8_t  val;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      val = (*data)&0xFF;
+      val = (*STATE()->data)&0xFF;
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      val = MEM ( addr );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      val = MEM<HOOKS> ( addr );
    }
 
    wC ( rY()>=val );
@@ -2917,19 +3002,20 @@ void C6502::CPY ( void )
 //  |  (Indirect),Y  |   CMP (Oper),Y        |    D1   |    2    |    5*    |
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if page boundary is crossed.
+template <class HOOKS>
 void C6502::CMP ( void )
 {
    uint32_t addr;
    uint8_t val;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      val = (*data)&0xFF;
+      val = (*STATE()->data)&0xFF;
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      val = MEM ( addr );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      val = MEM<HOOKS> ( addr );
    }
 
    wC ( rA()>=val );
@@ -2955,15 +3041,16 @@ void C6502::CMP ( void )
 // Absolute,Y  |DCP arg,Y  |$DB| 3 | 7
 // (Indirect,X)|DCP (arg,X)|$C3| 2 | 8
 // (Indirect),Y|DCP (arg),Y|$D3| 2 | 8
+template <class HOOKS>
 void C6502::DCM ( void )
 {
    uint16_t addr;
    uint8_t  val;
 
-   addr = MAKEADDR ( amode, data );
-   val = MEM ( addr );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   val = MEM<HOOKS> ( addr );
    val -= 1;
-   MEM ( addr, val );
+   MEM<HOOKS> ( addr, val );
    wC ( rA()>=val );
    val = rA() - val;
    val &= 0xFF;
@@ -2972,7 +3059,7 @@ void C6502::DCM ( void )
 
    // A missing memory cycle here?
    // Synchronize CPU and APU...
-   ADVANCE ();
+   ADVANCE<HOOKS> ();
 
    return;
 }
@@ -2990,19 +3077,20 @@ void C6502::DCM ( void )
 //  |  Absolute      |   DEC Oper            |    CE   |    3    |    6     |
 //  |  Absolute,X    |   DEC Oper,X          |    DE   |    3    |    7     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::DEC ( void )
 {
    uint16_t addr;
    uint8_t  val;
 
-   addr = MAKEADDR ( amode, data );
-   val = MEM ( addr );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   val = MEM<HOOKS> ( addr );
 
    // dummy write
-   MEM ( addr, val );
+   MEM<HOOKS> ( addr, val );
 
    val -= 1;
-   MEM ( addr, val );
+   MEM<HOOKS> ( addr, val );
    wN ( val&0x80 );
    wZ ( !val );
 
@@ -3019,6 +3107,7 @@ void C6502::DEC ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   INY                 |    C8   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::INY ( void )
 {
    wY ( rY()+1 );
@@ -3038,6 +3127,7 @@ void C6502::INY ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   DEX                 |    CA   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::DEX ( void )
 {
    wX ( rX()-1 );
@@ -3059,30 +3149,31 @@ void C6502::DEX ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if branch occurs to same page.
 //  * Add 2 if branch occurs to different page.
+template <class HOOKS>
 void C6502::BNE ( void )
 {
    uint32_t target;
 
-   target = rPC()+GETSIGNED8(data,0);
+   target = rPC()+GETSIGNED8(STATE()->data,0);
 
    if ( !rZ() )
    {
       // Synchronize CPU and APU...
-      MEM ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(data,0))&0xFF) );
+      MEM<HOOKS> ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(STATE()->data,0))&0xFF) );
 
       // Extra cycle.
       if ( (rPC()&0xFF00) != (target&0xFF00) )
       {
          // Synchronize CPU and APU...
-         MEM ( target );
+         MEM<HOOKS> ( target );
       }
 
       wPC ( target );
 
-      if ( rPC() == m_pcGoto )
+      if ( rPC() == STATE()->m_pcGoto )
       {
          CNES::STEPCPUBREAKPOINT();
-         m_pcGoto = 0xFFFFFFFF;
+         STATE()->m_pcGoto = 0xFFFFFFFF;
       }
    }
 
@@ -3099,6 +3190,7 @@ void C6502::BNE ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   CLD                 |    D8   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::CLD ( void )
 {
    cD ();
@@ -3117,19 +3209,20 @@ void C6502::CLD ( void )
 //  |  Zero Page     |   CPX Oper            |    E4   |    2    |    3     |
 //  |  Absolute      |   CPX Oper            |    EC   |    3    |    4     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::CPX ( void )
 {
    uint16_t addr;
    uint8_t  val;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      val = (*data)&0xFF;
+      val = (*STATE()->data)&0xFF;
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      val = MEM ( addr );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      val = MEM<HOOKS> ( addr );
    }
 
    wC ( rX()>=val );
@@ -3159,20 +3252,21 @@ void C6502::CPX ( void )
 //  |  (Indirect),Y  |   SBC (Oper),Y        |    F1   |    2    |    5*    |
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 when page boundary is crossed.
+template <class HOOKS>
 void C6502::SBC ( void )
 {
    uint32_t addr;
    int16_t result;
    uint8_t val;
 
-   if ( amode == AM_IMMEDIATE )
+   if ( STATE()->amode == AM_IMMEDIATE )
    {
-      val = (*data);
+      val = (*STATE()->data);
    }
    else
    {
-      addr = MAKEADDR ( amode, data );
-      val = MEM ( addr );
+      addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+      val = MEM<HOOKS> ( addr );
    }
 
    result = (rA() - val - (1-rC()));
@@ -3198,19 +3292,20 @@ void C6502::SBC ( void )
 //  |  Absolute      |   INC Oper            |    EE   |    3    |    6     |
 //  |  Absolute,X    |   INC Oper,X          |    FE   |    3    |    7     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::INC ( void )
 {
    uint16_t addr;
    uint8_t  val;
 
-   addr = MAKEADDR ( amode, data );
-   val = MEM ( addr );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   val = MEM<HOOKS> ( addr );
 
    // dummy write
-   MEM ( addr, val );
+   MEM<HOOKS> ( addr, val );
 
    val++;
-   MEM ( addr, val );
+   MEM<HOOKS> ( addr, val );
    wN ( val&0x80 );
    wZ ( !val );
 
@@ -3231,16 +3326,17 @@ void C6502::INC ( void )
 // Absolute,Y  |ISC arg,Y  |$FB| 3 | 7
 // (Indirect,X)|ISC (arg,X)|$E3| 2 | 8
 // (Indirect),Y|ISC (arg),Y|$F3| 2 | 8
+template <class HOOKS>
 void C6502::INS ( void )
 {
    uint16_t addr;
    uint8_t  val;
    int16_t result;
 
-   addr = MAKEADDR ( amode, data );
-   val = MEM ( addr );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
+   val = MEM<HOOKS> ( addr );
    val++;
-   MEM ( addr, val );
+   MEM<HOOKS> ( addr, val );
 
    result = (rA() - val - (1-rC()));
 
@@ -3252,7 +3348,7 @@ void C6502::INS ( void )
 
    // A missing memory cycle here?
    // Synchronize CPU and APU...
-   ADVANCE ();
+   ADVANCE<HOOKS> ();
 
    return;
 }
@@ -3266,6 +3362,7 @@ void C6502::INS ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   INX                 |    E8   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::INX ( void )
 {
    wX ( rX()+1 );
@@ -3284,36 +3381,39 @@ void C6502::INX ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   NOP                 |    EA   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::NOP ( void )
 {
    return;
 }
 
+template <class HOOKS>
 void C6502::DOP ( void )
 {
    uint16_t addr;
 
-   addr = MAKEADDR ( amode, data );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
 
-   if ( amode != AM_IMMEDIATE )
+   if ( STATE()->amode != AM_IMMEDIATE )
    {
       // A missing memory cycle here?
       // Synchronize CPU and APU...
-      ADVANCE ();
+      ADVANCE<HOOKS> ();
    }
 
    return;
 }
 
+template <class HOOKS>
 void C6502::TOP ( void )
 {
    uint16_t addr;
 
-   addr = MAKEADDR ( amode, data );
+   addr = MAKEADDR<HOOKS> ( STATE()->amode, STATE()->data );
 
    // A missing memory cycle here?
    // Synchronize CPU and APU...
-   ADVANCE ();
+   ADVANCE<HOOKS> ();
 
    return;
 }
@@ -3329,30 +3429,31 @@ void C6502::TOP ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  * Add 1 if branch occurs to same  page.
 //  * Add 2 if branch occurs to next  page.
+template <class HOOKS>
 void C6502::BEQ ( void )
 {
    uint32_t target;
 
-   target = rPC()+GETSIGNED8(data,0);
+   target = rPC()+GETSIGNED8(STATE()->data,0);
 
    if ( rZ() )
    {
       // Synchronize CPU and APU...
-      MEM ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(data,0))&0xFF) );
+      MEM<HOOKS> ( (rPC()&0xFF00)|(((rPC()&0x00FF)+GETUNSIGNED8(STATE()->data,0))&0xFF) );
 
       // Extra cycle.
       if ( (rPC()&0xFF00) != (target&0xFF00) )
       {
          // Synchronize CPU and APU...
-         MEM ( target );
+         MEM<HOOKS> ( target );
       }
 
       wPC ( target );
 
-      if ( rPC() == m_pcGoto )
+      if ( rPC() == STATE()->m_pcGoto )
       {
          CNES::STEPCPUBREAKPOINT();
-         m_pcGoto = 0xFFFFFFFF;
+         STATE()->m_pcGoto = 0xFFFFFFFF;
       }
    }
 
@@ -3368,6 +3469,7 @@ void C6502::BEQ ( void )
 //  +----------------+-----------------------+---------+---------+----------+
 //  |  Implied       |   SED                 |    F8   |    1    |    2     |
 //  +----------------+-----------------------+---------+---------+----------+
+template <class HOOKS>
 void C6502::SED ( void )
 {
    sD ();
@@ -3386,26 +3488,27 @@ void C6502::SED ( void )
 //  |  Implied       |   BRK                 |    00   |    1    |    7     |
 //  +----------------+-----------------------+---------+---------+----------+
 //  1. A BRK command cannot be masked by setting I.
+template <class HOOKS>
 void C6502::BRK ( void )
 {
    uint8_t         pchi;
-   static uint8_t  pclo = 0x00;
-   static bool     doingIrq = false;
+   uint8_t&        pclo = STATE()->m_brkPclo;
+   bool&           doingIrq = STATE()->m_brkDoingIrq;
 
-   if ( !m_killed )
+   if ( !STATE()->m_killed )
    {
-      if ( m_instrCycle == 2 )
+      if ( STATE()->m_instrCycle == 2 )
       {
          PUSH ( GETHI8(rPC()) );
       }
-      else if ( m_instrCycle == 3 )
+      else if ( STATE()->m_instrCycle == 3 )
       {
          PUSH ( GETLO8((rPC())) );
       }
-      else if ( m_instrCycle == 4 )
+      else if ( STATE()->m_instrCycle == 4 )
       {
          PUSH ( rF() );
-         if ( m_nmiPending )
+         if ( STATE()->m_nmiPending )
          {
             doingIrq = false;
          }
@@ -3416,61 +3519,65 @@ void C6502::BRK ( void )
       }
       else
       {
-         if ( m_nmiPending && !doingIrq )
+         if ( STATE()->m_nmiPending && !doingIrq )
          {
-            if ( m_instrCycle == 5 )
+            if ( STATE()->m_instrCycle == 5 )
             {
-               pclo = MEM(VECTOR_NMI);
+               pclo = MEM<HOOKS>(VECTOR_NMI);
             }
-            else if ( m_instrCycle == 6 )
+            else if ( STATE()->m_instrCycle == 6 )
             {
-               pchi = MEM(VECTOR_NMI+1);
+               pchi = MEM<HOOKS>(VECTOR_NMI+1);
 
                wPC ( MAKE16(pclo,pchi) );
 
-               if ( rPC() == m_pcGoto )
+               if ( rPC() == STATE()->m_pcGoto )
                {
                   CNES::STEPCPUBREAKPOINT();
-                  m_pcGoto = 0xFFFFFFFF;
+                  STATE()->m_pcGoto = 0xFFFFFFFF;
                }
 
-               if ( nesIsDebuggable() )
+               if ( HOOKS::ENABLED() )
                {
                   // Check for NMI breakpoint...
-                  CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUEvent,0,CPU_EVENT_NMI_ENTERED);
+                  HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUEvent,0,CPU_EVENT_NMI_ENTERED);
+
+                  PROFILECALL ( rSP()+3 );
                }
 
                sI();
-               m_nmiPending = false;
+               STATE()->m_nmiPending = false;
                doingIrq = false;
             }
          }
          else
          {
-            if ( m_instrCycle == 5 )
+            if ( STATE()->m_instrCycle == 5 )
             {
-               pclo = MEM(VECTOR_IRQ);
+               pclo = MEM<HOOKS>(VECTOR_IRQ);
             }
-            else if ( m_instrCycle == 6 )
+            else if ( STATE()->m_instrCycle == 6 )
             {
-               pchi = MEM(VECTOR_IRQ+1);
+               pchi = MEM<HOOKS>(VECTOR_IRQ+1);
 
                wPC ( MAKE16(pclo,pchi) );
 
-               if ( rPC() == m_pcGoto )
+               if ( rPC() == STATE()->m_pcGoto )
                {
                   CNES::STEPCPUBREAKPOINT();
-                  m_pcGoto = 0xFFFFFFFF;
+                  STATE()->m_pcGoto = 0xFFFFFFFF;
                }
 
-               if ( nesIsDebuggable() )
+               if ( HOOKS::ENABLED() )
                {
                   // Check for IRQ breakpoint...
-                  CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUEvent,0,CPU_EVENT_IRQ_ENTERED);
+                  HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUEvent,0,CPU_EVENT_IRQ_ENTERED);
+
+                  PROFILECALL ( rSP()+3 );
                }
 
                sI();
-               m_irqPending = false;
+               STATE()->m_irqPending = false;
                doingIrq = false;
             }
          }
@@ -3482,13 +3589,13 @@ void C6502::BRK ( void )
 
 void C6502::ASSERTIRQ ( int8_t source )
 {
-   m_irqAsserted = true;
+   STATE()->m_irqAsserted = true;
 
    if ( nesIsDebuggable() )
    {
       if ( source == eNESSource_Mapper )
       {
-         CNES::TRACER()->AddIRQ ( m_cycles, source );
+         CNES::TRACER()->AddIRQ ( STATE()->m_cycles, source );
       }
       else
       {
@@ -3506,19 +3613,19 @@ void C6502::RELEASEIRQ ( int8_t source )
    {
       if ( source == eNESSource_Mapper )
       {
-         CNES::TRACER()->AddIRQRelease ( m_cycles, source );
+         CNES::TRACER()->AddIRQRelease ( STATE()->m_cycles, source );
       }
       else
       {
          CNES::TRACER()->AddIRQRelease ( CAPU::CYCLES(), source );
       }
    }
-   m_irqAsserted = false;
+   STATE()->m_irqAsserted = false;
 }
 
 void C6502::ASSERTNMI ()
 {
-   m_nmiAsserted = true;
+   STATE()->m_nmiAsserted = true;
 
    if ( nesIsDebuggable() )
    {
@@ -3531,7 +3638,10 @@ void C6502::ASSERTNMI ()
 
 void C6502::RESET ( bool soft )
 {
-   m_killed = false;
+   STATE()->m_killed = false;
+
+   // The mapper has been chosen and reset by now.
+   MAPPAGES ();
 
    CAPU::RESET ();
 
@@ -3540,35 +3650,38 @@ void C6502::RESET ( bool soft )
       CNES::TRACER()->AddRESET ();
    }
 
-   m_cycles = 0;
-   m_curCycles = 0;
-   m_phase = 0;
+   STATE()->m_cycles = 0;
+   STATE()->m_curCycles = 0;
+   STATE()->m_phase = 0;
 
-   m_dmaRequest = -1;
-   m_writeDmaCounter = 0;
-   m_readDmaCounter = 0;
+   STATE()->m_dmaRequest = -1;
+   STATE()->m_writeDmaCounter = 0;
+   STATE()->m_readDmaCounter = 0;
 
-   m_write = false;
+   STATE()->m_write = false;
 
    // Clear the disassembly sample...
-   pDisassemblySample = NULL;
+   STATE()->disassemblySample = TRACER_NO_SAMPLE;
+
+   // Nothing called before the reset will return.
+   STATE()->m_profiler->Unwind ();
 
-   m_irqAsserted = false;
-   m_irqPending = false;
-   m_instrCycle = 0;
-   m_nmiAsserted = false;
-   m_nmiPending = false;
+   STATE()->m_irqAsserted = false;
+   STATE()->m_irqPending = false;
+   STATE()->m_instrCycle = 0;
+   STATE()->m_nmiAsserted = false;
+   STATE()->m_nmiPending = false;
 
    wEA ( 0 );
 
-   m_pcGoto = 0xFFFFFFFF;
+   STATE()->m_pcGoto = 0xFFFFFFFF;
 
    // Fake cycle -- stuff is being cleared
-   MEM(0xFF);
+   MEM<HOOKS>(0xFF);
 
    // Fake opcode reads
-   MEM(0xFF);
-   MEM(0xFF);
+   MEM<HOOKS>(0xFF);
+   MEM<HOOKS>(0xFF);
 
    wF ( 0 );
    sI ();
@@ -3578,16 +3691,16 @@ void C6502::RESET ( bool soft )
    wX ( 0 );
    wY ( 0 );
    wSP ( 0 );
-   MEM ( 0x00 ); // These emulate the three "fake stack pushes" that occur
+   MEM<HOOKS> ( 0x00 ); // These emulate the three "fake stack pushes" that occur
    wSP ( 0xFF );
-   MEM ( 0x00 ); // during the 6502 RESET sequence.  The stack pushes are fake
+   MEM<HOOKS> ( 0x00 ); // during the 6502 RESET sequence.  The stack pushes are fake
    wSP ( 0xFE );
-   MEM ( 0x00 ); // in that they occur but are READs instead of WRITEs.
+   MEM<HOOKS> ( 0x00 ); // in that they occur but are READs instead of WRITEs.
    wSP ( 0xFD );
-   wPC ( MAKE16(MEM(VECTOR_RESET),MEM(VECTOR_RESET+1)) );
+   wPC ( MAKE16(MEM<HOOKS>(VECTOR_RESET),MEM<HOOKS>(VECTOR_RESET+1)) );
 
-   m_pcSync = rPC();
-   m_pcSyncSet = true;
+   STATE()->m_pcSync = rPC();
+   STATE()->m_pcSyncSet = true;
 
    // Clear memory...
    if ( !soft )
@@ -3602,10 +3715,144 @@ void C6502::RESET ( bool soft )
    }
 }
 
+template <class STREAM>
+void C6502::STATEDATA ( STREAM& stream )
+{
+   stream.VALUE ( STATE()->m_killed );
+   stream.VALUE ( STATE()->m_irqAsserted );
+   stream.VALUE ( STATE()->m_irqPending );
+   stream.VALUE ( STATE()->m_nmiAsserted );
+   stream.VALUE ( STATE()->m_nmiPending );
+   stream.VALUE ( STATE()->m_a );
+   stream.VALUE ( STATE()->m_x );
+   stream.VALUE ( STATE()->m_y );
+   stream.VALUE ( STATE()->m_f );
+   stream.VALUE ( STATE()->m_pc );
+   stream.VALUE ( STATE()->m_pcSync );
+   stream.VALUE ( STATE()->m_pcSyncSet );
+   stream.VALUE ( STATE()->m_sp );
+   stream.VALUE ( STATE()->m_ea );
+   stream.VALUE ( STATE()->m_cycles );
+   stream.VALUE ( STATE()->m_instrCycle );
+   stream.VALUE ( STATE()->m_curCycles );
+   stream.VALUE ( STATE()->amode );
+   stream.VALUE ( STATE()->m_dmaRequest );
+   stream.VALUE ( STATE()->m_writeDmaAddr );
+   stream.VALUE ( STATE()->m_writeDmaCounter );
+   stream.VALUE ( STATE()->m_readDmaAddr );
+   stream.VALUE ( STATE()->m_readDmaCounter );
+   stream.VALUE ( STATE()->m_dmaData );
+   stream.BYTES ( STATE()->opcodeData, sizeof(STATE()->opcodeData) );
+   stream.VALUE ( STATE()->opcodeSize );
+   stream.VALUE ( STATE()->m_write );
+   stream.VALUE ( STATE()->m_openBusData );
+   stream.VALUE ( STATE()->m_phase );
+   stream.VALUE ( STATE()->m_brkPclo );
+   stream.VALUE ( STATE()->m_brkDoingIrq );
+   stream.MEMORY ( STATE()->m_6502memory, MEM_2KB );
+}
+
+void C6502::SAVESTATE ( CNESStateWriter& writer )
+{
+   writer.BEGIN ( "CPU ", 1 );
+   STATEDATA ( writer );
+
+   // The instruction in flight is saved as its opcode table index.
+   writer.VALUE<int32_t> ( STATE()->pOpcodeStruct?(STATE()->pOpcodeStruct-m_6502opcode):-1 );
+   writer.VALUE<bool> ( STATE()->data != NULL );
+   writer.END ();
+}
+
+bool C6502::LOADSTATE ( CNESStateReader& reader )
+{
+   uint16_t version;
+   int32_t  opcode = -1;
+   bool     data = false;
+
+   if ( (!reader.FIND("CPU ",&version)) || (version != 1) )
+   {
+      return false;
+   }
+   STATEDATA ( reader );
+   reader.VALUE ( opcode );
+   reader.VALUE ( data );
+   if ( (opcode < -1) || (opcode > 255) )
+   {
+      return false;
+   }
+   STATE()->pOpcodeStruct = (opcode >= 0)?m_6502opcode+opcode:NULL;
+   STATE()->data = data?STATE()->opcodeData+1:NULL;
+   STATE()->disassemblySample = TRACER_NO_SAMPLE;
+
+   // The calls in progress are the ones of the state left behind.
+   STATE()->m_profiler->Unwind ();
+
+   return reader.GOOD();
+}
+
+void C6502::MAPPAGES ( void )
+{
+   CNES6502_page* pReadPage = STATE()->m_readPage;
+   CNES6502_page* pWritePage = STATE()->m_writePage;
+   bool           directPRGROM;
+   bool           directSRAM;
+   int32_t        page;
+
+   // Mappers that decode PRG-ROM or SRAM reads themselves keep their
+   // handlers.  Mapper 0 boards with more than 32KB of PRG-ROM show
+   // it at $6000 instead of SRAM.
+   directPRGROM = (MAPPERFUNC->highread == static_cast<MAPPERRFUNC>(CROM::HMAPPER));
+   directSRAM = (MAPPERFUNC->lowread == static_cast<MAPPERRFUNC>(CROM::LMAPPER)) &&
+                !((CROM::MAPPER() == 0) && (CROM::NUMPRGROMBANKS() > 4));
+
+   for ( page = 0; page < NUM_CPU_PAGES; page++ )
+   {
+      pReadPage[page].pBank = NULL;
+      pReadPage[page].offset = 0;
+      pReadPage[page].target = eTarget_Unknown;
+      pWritePage[page] = pReadPage[page];
+
+      if ( page < (0x2000>>UPSHIFT_2KB) )
+      {
+         // RAM mirrored...
+         pReadPage[page].pBank = &(STATE()->m_6502memory);
+         pReadPage[page].target = eTarget_RAM;
+         pWritePage[page] = pReadPage[page];
+      }
+      else if ( (page >= (SRAM_START>>UPSHIFT_2KB)) && (page < (0x8000>>UPSHIFT_2KB)) )
+      {
+         // SRAM writes go through the mapper so SRAM is marked dirty.
+         if ( directSRAM )
+         {
+            pReadPage[page].pBank = CROM::SRAMBANKSLOT(page<<UPSHIFT_2KB);
+            pReadPage[page].offset = ((page<<UPSHIFT_2KB)&MASK_8KB);
+            pReadPage[page].target = eTarget_SRAM;
+         }
+      }
+      else if ( page >= (0x8000>>UPSHIFT_2KB) )
+      {
+         if ( directPRGROM )
+         {
+            pReadPage[page].pBank = CROM::PRGROMBANKSLOT(page<<UPSHIFT_2KB);
+            pReadPage[page].offset = ((page<<UPSHIFT_2KB)&MASK_8KB);
+            pReadPage[page].target = eTarget_Mapper;
+         }
+      }
+   }
+}
+
 uint8_t C6502::LOAD ( uint32_t addr, int8_t* pTarget )
 {
+   CNES6502_page* pPage = STATE()->m_readPage+((addr&MASK_64KB)>>UPSHIFT_2KB);
    uint8_t data = C6502::OPENBUS();
 
+   // RAM, PRG-ROM and SRAM are read directly...
+   if ( pPage->pBank )
+   {
+      (*pTarget) = pPage->target;
+      return *((*(pPage->pBank))+pPage->offset+(addr&MASK_2KB));
+   }
+
    if ( addr >= 0x8000 )
    {
       (*pTarget) = eTarget_Mapper;
@@ -3615,7 +3862,7 @@ uint8_t C6502::LOAD ( uint32_t addr, int8_t* pTarget )
    {
       (*pTarget) = eTarget_RAM;
       addr &= 0x7FF; // RAM mirrored...
-      data = m_6502memory[addr];
+      data = STATE()->m_6502memory[addr];
    }
    else if ( addr < 0x4000 )
    {
@@ -3669,11 +3916,21 @@ uint8_t C6502::LOAD ( uint32_t addr, int8_t* pTarget )
 
 void C6502::STORE ( uint32_t addr, uint8_t data, int8_t* pTarget )
 {
+   CNES6502_page* pPage = STATE()->m_writePage+((addr&MASK_64KB)>>UPSHIFT_2KB);
+
+   // RAM is written directly...
+   if ( pPage->pBank )
+   {
+      (*pTarget) = pPage->target;
+      *((*(pPage->pBank))+pPage->offset+(addr&MASK_2KB)) = data;
+      return;
+   }
+
    if ( addr < 0x2000 )
    {
       (*pTarget) = eTarget_RAM;
       addr &= 0x7FF; // RAM mirrored...
-      m_6502memory[addr] = data&0xFF;
+      STATE()->m_6502memory[addr] = data&0xFF;
    }
    else if ( addr < 0x4000 )
    {
@@ -3697,11 +3954,11 @@ void C6502::STORE ( uint32_t addr, uint8_t data, int8_t* pTarget )
 
          // DMA
          // Note: DMA is done in C6502::EMULATE, it is only set-up here.
-         m_writeDmaAddr = data<<8;
-         m_writeDmaCounter = 513;
+         STATE()->m_writeDmaAddr = data<<8;
+         STATE()->m_writeDmaCounter = 513;
          if ( _CYCLES()&1 )
          {
-            m_writeDmaCounter++;
+            STATE()->m_writeDmaCounter++;
          }
       }
       // Otherwise if not accessing a controller port, use default...
@@ -3733,40 +3990,41 @@ void C6502::STORE ( uint32_t addr, uint8_t data, int8_t* pTarget )
    }
 }
 
+template <class HOOKS>
 uint8_t C6502::FETCH ()
 {
    int8_t target;
    uint8_t data;
-   uint8_t instrCycle = m_instrCycle;
+   uint8_t instrCycle = STATE()->m_instrCycle;
 
    // Not writing...
-   m_write = false;
+   STATE()->m_write = false;
 
    // Set effective address.
    wEA ( rPC() );
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       CNES::TRACER()->SetEffectiveAddress ( CNES::TRACER()->GetLastCPUSample(), rEA() );
    }
 
    // Synchronize CPU and APU...
-   ADVANCE ();
+   ADVANCE<HOOKS> ();
 
    data = LOAD ( rPC(), &target );
 
    // Store data to return as open-bus.
-   m_openBusData = data;
+   STATE()->m_openBusData = data;
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Add Tracer sample...
       if ( instrCycle == 0 )
       {
-         CNES::TRACER()->AddSample ( m_cycles, eTracer_InstructionFetch, eNESSource_CPU, target, rPC(), data );
+         CNES::TRACER()->AddSample ( STATE()->m_cycles, eTracer_InstructionFetch, eNESSource_CPU, target, rPC(), data );
       }
       else
       {
-         CNES::TRACER()->AddSample ( m_cycles, eTracer_OperandFetch, eNESSource_CPU, target, rPC(), data );
+         CNES::TRACER()->AddSample ( STATE()->m_cycles, eTracer_OperandFetch, eNESSource_CPU, target, rPC(), data );
       }
 
       // If ROM is being accessed, log code/data logger...
@@ -3777,15 +4035,15 @@ uint8_t C6502::FETCH ()
          CCodeDataLogger* pLogger = CROM::LOGGERVIRT ( rPC() );
          if ( instrCycle == 0 )
          {
-            pLogger->LogAccess ( m_cycles, rPC(), data, eLogger_InstructionFetch, eNESSource_CPU );
+            pLogger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_InstructionFetch, eNESSource_CPU );
          }
          else
          {
-            pLogger->LogAccess ( m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
+            pLogger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
          }
 
          // Update Markers...
-         m_marker->UpdateMarkers ( CROM::PRGROMABSADDR(rPC()), C6502::_CYCLES(), CPPU::_FRAME(), CPPU::_CYCLES() );
+         STATE()->m_marker->UpdateMarkers ( CROM::PRGROMABSADDR(rPC()), C6502::_CYCLES(), CPPU::_FRAME(), CPPU::_CYCLES() );
 
          // ... and update opcode masking for disassembler...
          CROM::PRGROMOPCODEMASK ( rPC(), (uint8_t)(instrCycle==0) );
@@ -3796,11 +4054,11 @@ uint8_t C6502::FETCH ()
          CCodeDataLogger* pLogger = CROM::SRAMLOGGERVIRT ( rPC() );
          if ( instrCycle == 0 )
          {
-            pLogger->LogAccess ( m_cycles, rPC(), data, eLogger_InstructionFetch, eNESSource_CPU );
+            pLogger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_InstructionFetch, eNESSource_CPU );
          }
          else
          {
-            pLogger->LogAccess ( m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
+            pLogger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
          }
 
          // Update opcode masking for disassembler...
@@ -3812,11 +4070,11 @@ uint8_t C6502::FETCH ()
          CCodeDataLogger* pLogger = CROM::EXRAMLOGGER ();
          if ( instrCycle == 0 )
          {
-            pLogger->LogAccess ( m_cycles, rPC(), data, eLogger_InstructionFetch, eNESSource_CPU );
+            pLogger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_InstructionFetch, eNESSource_CPU );
          }
          else
          {
-            pLogger->LogAccess ( m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
+            pLogger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
          }
 
          // Update opcode masking for disassembler...
@@ -3826,11 +4084,11 @@ uint8_t C6502::FETCH ()
       {
          if ( instrCycle == 0 )
          {
-            m_logger->LogAccess ( m_cycles, rPC(), data, eLogger_InstructionFetch, eNESSource_CPU );
+            STATE()->m_logger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_InstructionFetch, eNESSource_CPU );
          }
          else
          {
-            m_logger->LogAccess ( m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
+            STATE()->m_logger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
          }
 
          // ... and update opcode masking for disassembler...
@@ -3841,53 +4099,54 @@ uint8_t C6502::FETCH ()
    return data;
 }
 
+template <class HOOKS>
 uint8_t C6502::EXTRAFETCH ()
 {
    int8_t target;
    uint8_t data;
 
    // Not writing...
-   m_write = false;
+   STATE()->m_write = false;
 
    // Set effective address.
    wEA ( rPC() );
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       CNES::TRACER()->SetEffectiveAddress ( CNES::TRACER()->GetLastCPUSample(), rEA() );
    }
 
    // Synchronize CPU and APU...
-   ADVANCE ();
+   ADVANCE<HOOKS> ();
 
    data = LOAD ( rPC(), &target );
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Add Tracer sample...
-      CNES::TRACER()->AddSample ( m_cycles, eTracer_OperandFetch, eNESSource_CPU, target, rPC(), data );
+      CNES::TRACER()->AddSample ( STATE()->m_cycles, eTracer_OperandFetch, eNESSource_CPU, target, rPC(), data );
 
 #if 0
       // If ROM is being accessed, log code/data logger...
       if ( target == eTarget_Mapper )
       {
          CCodeDataLogger* pLogger = CROM::LOGGERVIRT ( rPC() );
-         pLogger->LogAccess ( m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
       }
       else if ( target == eTarget_SRAM )
       {
          // Log to Code/Data Logger...
          CCodeDataLogger* pLogger = CROM::SRAMLOGGERVIRT ( rPC() );
-         pLogger->LogAccess ( m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
       }
       else if ( target == eTarget_EXRAM )
       {
          // Log to Code/Data Logger...
          CCodeDataLogger* pLogger = CROM::EXRAMLOGGER ();
-         pLogger->LogAccess ( m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
       }
       else if ( target == eTarget_RAM )
       {
-         m_logger->LogAccess ( m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
+         STATE()->m_logger->LogAccess ( STATE()->m_cycles, rPC(), data, eLogger_OperandFetch, eNESSource_CPU );
       }
 #endif
    }
@@ -3895,285 +4154,290 @@ uint8_t C6502::EXTRAFETCH ()
    return data;
 }
 
+template <class HOOKS>
 uint8_t C6502::DMA ( uint32_t addr )
 {
    int8_t target;
    uint8_t data;
 
    // Not writing...
-   m_write = false;
+   STATE()->m_write = false;
 
    // Synchronize CPU and APU...
-   ADVANCE ( true );
+   ADVANCE<HOOKS> ( true );
 
    data = LOAD ( addr, &target );
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Add Tracer sample...
-      CNES::TRACER()->AddSample ( m_cycles, eTracer_DMA, eNESSource_CPU, target, addr, data );
+      CNES::TRACER()->AddSample ( STATE()->m_cycles, eTracer_DMA, eNESSource_CPU, target, addr, data );
 
       // If ROM or RAM is being accessed, log code/data logger...
       if ( (target == eTarget_Mapper) &&
            (addr >= MEM_32KB) )
       {
          CCodeDataLogger* pLogger = CROM::LOGGERVIRT ( addr );
-         pLogger->LogAccess ( m_cycles, addr, data, eLogger_DMA, eNESSource_APU );
+         pLogger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DMA, eNESSource_APU );
       }
       else if ( target == eTarget_RAM )
       {
-         m_logger->LogAccess ( m_cycles, addr, data, eLogger_DMA, eNESSource_APU );
+         STATE()->m_logger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DMA, eNESSource_APU );
       }
 
       // Check for breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUMemoryRead, data );
+      HOOKS::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUMemoryRead, data );
    }
 
    return data;
 }
 
+template <class HOOKS>
 void C6502::DMA ( uint32_t srcAddr, uint32_t dstAddr, uint8_t data )
 {
-   TracerInfo* pSample = NULL;
+   uint32_t sample = TRACER_NO_SAMPLE;
    int8_t target;
 
    // Writing...
-   m_write = true;
+   STATE()->m_write = true;
 
    // Synchronize CPU and APU...
-   ADVANCE ( true );
+   ADVANCE<HOOKS> ( true );
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Store unknown target because otherwise the trace will be out of order...
-      pSample = CNES::TRACER()->AddSample ( m_cycles, eTracer_DMA, eNESSource_CPU, target, dstAddr, data );
+      sample = CNES::TRACER()->AddSample ( STATE()->m_cycles, eTracer_DMA, eNESSource_CPU, target, dstAddr, data );
    }
 
    STORE ( dstAddr, data, &target );
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // If ROM or RAM is being accessed, log code/data logger...
       if ( srcAddr >= MEM_32KB )
       {
          CCodeDataLogger* pLogger = CROM::LOGGERVIRT ( srcAddr );
-         pLogger->LogAccess ( m_cycles, srcAddr, data, eLogger_DMA, eNESSource_PPU );
+         pLogger->LogAccess ( STATE()->m_cycles, srcAddr, data, eLogger_DMA, eNESSource_PPU );
       }
       else if ( srcAddr < MEM_8KB )
       {
-         m_logger->LogAccess ( m_cycles, srcAddr, data, eLogger_DMA, eNESSource_PPU );
+         STATE()->m_logger->LogAccess ( STATE()->m_cycles, srcAddr, data, eLogger_DMA, eNESSource_PPU );
       }
    }
 
    // Store real target...
-   if ( pSample )
+   if ( HOOKS::ENABLED() )
    {
-      pSample->target = target;
+      CNES::TRACER()->SetTarget ( sample, target );
    }
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Check for breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUMemoryWrite, data );
+      HOOKS::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUMemoryWrite, data );
    }
 }
 
+template <class HOOKS>
 uint8_t C6502::MEM ( uint32_t addr )
 {
    int8_t target;
    uint8_t data;
 
    // Not writing...
-   m_write = false;
+   STATE()->m_write = false;
 
    // Set effective address.
    wEA ( addr );
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       CNES::TRACER()->SetEffectiveAddress ( CNES::TRACER()->GetLastCPUSample(), rEA() );
    }
 
    // Synchronize CPU and APU...
-   ADVANCE ();
+   ADVANCE<HOOKS> ();
 
    data = LOAD ( addr, &target );
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Add Tracer sample...
-      CNES::TRACER()->AddSample ( m_cycles, eTracer_DataRead, eNESSource_CPU, target, addr, data );
+      CNES::TRACER()->AddSample ( STATE()->m_cycles, eTracer_DataRead, eNESSource_CPU, target, addr, data );
 
       // If ROM or RAM is being accessed, log code/data logger...
       if ( (target == eTarget_Mapper) &&
            (addr >= MEM_32KB) )
       {
          CCodeDataLogger* pLogger = CROM::LOGGERVIRT ( addr );
-         pLogger->LogAccess ( m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
       }
       else if ( target == eTarget_SRAM )
       {
          // Log to Code/Data Logger...
          CCodeDataLogger* pLogger = CROM::SRAMLOGGERVIRT ( addr );
-         pLogger->LogAccess ( m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
       }
       else if ( target == eTarget_EXRAM )
       {
          // Log to Code/Data Logger...
          CCodeDataLogger* pLogger = CROM::EXRAMLOGGER ();
-         pLogger->LogAccess ( m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
       }
       else if ( target == eTarget_RAM )
       {
          // Log to Code/Data Logger...
-         m_logger->LogAccess ( m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
+         STATE()->m_logger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
       }
       else
       {
          // Registers...
          // Log to Code/Data Logger...
-         m_logger->LogAccess ( m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
+         STATE()->m_logger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
       }
 
       // Check for breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUMemoryRead, data );
+      HOOKS::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUMemoryRead, data );
    }
 
    return data;
 }
 
+template <class HOOKS>
 void C6502::MEM ( uint32_t addr, uint8_t data )
 {
-   TracerInfo* pSample = NULL;
+   uint32_t sample = TRACER_NO_SAMPLE;
    int8_t target;
 
    // Writing...
-   m_write = true;
+   STATE()->m_write = true;
 
    // Set effective address.
    wEA ( addr );
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       CNES::TRACER()->SetEffectiveAddress ( CNES::TRACER()->GetLastCPUSample(), rEA() );
    }
 
    // Synchronize CPU and APU...
-   ADVANCE ();
+   ADVANCE<HOOKS> ();
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Store unknown target because otherwise the trace will be out of order...
-      pSample = CNES::TRACER()->AddSample ( m_cycles, eTracer_DataWrite, eNESSource_CPU, 0, addr, data );
+      sample = CNES::TRACER()->AddSample ( STATE()->m_cycles, eTracer_DataWrite, eNESSource_CPU, 0, addr, data );
    }
 
    STORE ( addr, data, &target );
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // If ROM or RAM is being accessed, log code/data logger...
       if ( (target == eTarget_Mapper) &&
            (addr >= MEM_32KB) )
       {
          CCodeDataLogger* pLogger = CROM::LOGGERVIRT ( addr );
-         pLogger->LogAccess ( m_cycles, addr, data, eLogger_DataWrite, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataWrite, eNESSource_CPU );
       }
       else if ( target == eTarget_SRAM )
       {
          // Log to Code/Data Logger...
          CCodeDataLogger* pLogger = CROM::SRAMLOGGERVIRT ( addr );
-         pLogger->LogAccess ( m_cycles, addr, data, eLogger_DataWrite, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataWrite, eNESSource_CPU );
       }
       else if ( target == eTarget_EXRAM )
       {
          // Log to Code/Data Logger...
          CCodeDataLogger* pLogger = CROM::EXRAMLOGGER ();
-         pLogger->LogAccess ( m_cycles, addr, data, eLogger_DataWrite, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataWrite, eNESSource_CPU );
       }
       else if ( target == eTarget_RAM )
       {
-         m_logger->LogAccess ( m_cycles, addr, data, eLogger_DataWrite, eNESSource_CPU );
+         STATE()->m_logger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataWrite, eNESSource_CPU );
       }
       else
       {
          // Registers...
          // Log to Code/Data Logger...
-         m_logger->LogAccess ( m_cycles, addr, data, eLogger_DataWrite, eNESSource_CPU );
+         STATE()->m_logger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataWrite, eNESSource_CPU );
       }
    }
 
    // Store real target...
-   if ( pSample )
+   if ( HOOKS::ENABLED() )
    {
-      pSample->target = target;
+      CNES::TRACER()->SetTarget ( sample, target );
    }
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Check for breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUMemoryWrite, data );
+      HOOKS::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUMemoryWrite, data );
    }
 }
 
+template <class HOOKS>
 uint8_t C6502::STEAL ( uint32_t addr, uint8_t source )
 {
    int8_t target;
    uint8_t data;
 
    // Not writing...
-   m_write = false;
+   STATE()->m_write = false;
 
    // Set effective address.
    wEA ( addr );
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       CNES::TRACER()->SetEffectiveAddress ( CNES::TRACER()->GetLastCPUSample(), rEA() );
    }
 
    // Synchronize CPU and APU...
-   ADVANCE ( true );
+   ADVANCE<HOOKS> ( true );
 
    data = LOAD ( addr, &target );
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Add Tracer sample...
-      CNES::TRACER()->AddStolenCycle ( m_cycles, source );
+      CNES::TRACER()->AddStolenCycle ( STATE()->m_cycles, source );
 
       // If ROM or RAM is being accessed, log code/data logger...
       if ( (target == eTarget_Mapper) &&
            (addr >= MEM_32KB) )
       {
          CCodeDataLogger* pLogger = CROM::LOGGERVIRT ( addr );
-         pLogger->LogAccess ( m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
       }
       else if ( target == eTarget_SRAM )
       {
          // Log to Code/Data Logger...
          CCodeDataLogger* pLogger = CROM::SRAMLOGGERVIRT ( addr );
-         pLogger->LogAccess ( m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
       }
       else if ( target == eTarget_EXRAM )
       {
          // Log to Code/Data Logger...
          CCodeDataLogger* pLogger = CROM::EXRAMLOGGER ();
-         pLogger->LogAccess ( m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
+         pLogger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
       }
       else if ( target == eTarget_RAM )
       {
          // Log to Code/Data Logger...
-         m_logger->LogAccess ( m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
+         STATE()->m_logger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
       }
       else
       {
          // Registers...
          // Log to Code/Data Logger...
-         m_logger->LogAccess ( m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
+         STATE()->m_logger->LogAccess ( STATE()->m_cycles, addr, data, eLogger_DataRead, eNESSource_CPU );
       }
 
       // Check stolen cycles breakpoint.
-      CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUEvent,0,CPU_EVENT_STOLEN_CYCLE);
+      HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUEvent,0,CPU_EVENT_STOLEN_CYCLE);
 
       // Check for breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUMemoryRead, data );
+      HOOKS::CHECKBREAKPOINT ( eBreakInCPU, eBreakOnCPUMemoryRead, data );
    }
 
    return data;
@@ -4193,6 +4457,7 @@ void C6502::_MEM ( uint32_t addr, uint8_t data )
    STORE ( addr, data, &target );
 }
 
+template <class HOOKS>
 uint32_t C6502::MAKEADDR ( int32_t amode, uint8_t* data )
 {
    uint16_t addr = 0x00, addrpre;
@@ -4204,13 +4469,13 @@ uint32_t C6502::MAKEADDR ( int32_t amode, uint8_t* data )
    else if ( amode == AM_ZEROPAGE_INDEXED_X )
    {
       // dummy read
-      MEM(*data);
+      MEM<HOOKS>(*data);
       addr = ((*data)+rX())&0xFF;
    }
    else if ( amode == AM_ZEROPAGE_INDEXED_Y )
    {
       // dummy read
-      MEM(*data);
+      MEM<HOOKS>(*data);
       addr = ((*data)+rY())&0xFF;
    }
    else if ( amode == AM_ABSOLUTE )
@@ -4223,10 +4488,10 @@ uint32_t C6502::MAKEADDR ( int32_t amode, uint8_t* data )
       addr = addrpre+rX();
 
       // Check for ROL special case...
-      if ( ((*opcodeData) == ROL_ABS_X) || ((addrpre>>8) != (addr>>8)) || (pOpcodeStruct->forceExtraCycle) )
+      if ( ((*STATE()->opcodeData) == ROL_ABS_X) || ((addrpre>>8) != (addr>>8)) || (STATE()->pOpcodeStruct->forceExtraCycle) )
       {
          // dummy read
-         MEM((addrpre&0xFF00)+((addrpre+rX())&0xFF));
+         MEM<HOOKS>((addrpre&0xFF00)+((addrpre+rX())&0xFF));
       }
    }
    else if ( amode == AM_ABSOLUTE_INDEXED_Y )
@@ -4234,27 +4499,27 @@ uint32_t C6502::MAKEADDR ( int32_t amode, uint8_t* data )
       addrpre = MAKE16((*data),(*(data+1)));
       addr = addrpre+rY();
 
-      if ( ((addrpre>>8) != (addr>>8)) || (pOpcodeStruct->forceExtraCycle) )
+      if ( ((addrpre>>8) != (addr>>8)) || (STATE()->pOpcodeStruct->forceExtraCycle) )
       {
          // dummy read
-         MEM((addrpre&0xFF00)+((addrpre+rY())&0xFF));
+         MEM<HOOKS>((addrpre&0xFF00)+((addrpre+rY())&0xFF));
       }
    }
    else if ( amode == AM_PREINDEXED_INDIRECT )
    {
       // dummy read
-      MEM(*data);
-      addr = MAKE16(MEM(((*data)+rX())&0xFF),MEM(((*data)+rX()+1)&0xFF));
+      MEM<HOOKS>(*data);
+      addr = MAKE16(MEM<HOOKS>(((*data)+rX())&0xFF),MEM<HOOKS>(((*data)+rX()+1)&0xFF));
    }
    else if ( amode == AM_POSTINDEXED_INDIRECT )
    {
-      addrpre = MAKE16(MEM((*data)),MEM(((*data)+1)&0xFF));
+      addrpre = MAKE16(MEM<HOOKS>((*data)),MEM<HOOKS>(((*data)+1)&0xFF));
       addr = addrpre+rY();
 
-      if ( ((addrpre>>8) != (addr>>8)) || (pOpcodeStruct->forceExtraCycle) )
+      if ( ((addrpre>>8) != (addr>>8)) || (STATE()->pOpcodeStruct->forceExtraCycle) )
       {
          // dummy read
-         MEM((addrpre&0xFF00)+((addrpre+rY())&0xFF));
+         MEM<HOOKS>((addrpre&0xFF00)+((addrpre+rY())&0xFF));
       }
    }
 
@@ -4268,100 +4533,137 @@ void C6502::DISASSEMBLE ()
 {
    if ( __PCSYNC() < 0x800 )
    {
-      DISASSEMBLE ( m_RAMdisassembly,
-                    m_6502memory,
+      DISASSEMBLE ( STATE()->m_6502memory,
                     MEM_2KB,
-                    m_RAMopcodeMask,
-                    m_RAMsloc2addr,
-                    m_RAMaddr2sloc,
-                    &(m_RAMsloc) );
+                    STATE()->m_RAMopcodeMask,
+                    STATE()->m_RAMsloc2addr,
+                    STATE()->m_RAMaddr2sloc,
+                    &(STATE()->m_RAMsloc),
+                    0,
+                    MEM_2KB-1 );
    }
 }
 
-void C6502::DISASSEMBLE ( char** disassembly, uint8_t* binary, int32_t binaryLength, uint8_t* opcodeMask, uint16_t* sloc2addr, uint16_t* addr2sloc, uint32_t* sourceLength )
+void C6502::DISASSEMBLE ( uint8_t* binary, int32_t binaryLength, uint8_t* opcodeMask, uint16_t* sloc2addr, uint16_t* addr2sloc, uint32_t* sourceLength, int32_t dirtyStart, int32_t dirtyEnd )
 {
-   CNES6502_opcode* pOp;
+   uint16_t lines [ MEM_8KB ];
+   uint32_t numLines = 0;
+   uint32_t startSloc;
+   uint32_t endSloc;
+   uint32_t sloc;
+   int32_t delta;
    int32_t opSize;
-   uint8_t op;
-   char* ptr;
-   uint8_t mask;
-
-   (*sourceLength) = 0;
+   int32_t i;
+   int32_t addr;
 
-   for ( int32_t i = 0; i < binaryLength; )
+   // The layout of a source line depends only on the opcode mask where it
+   // starts, so the lines before the one the first changed byte is in
+   // stay as they are...
+   startSloc = *(addr2sloc+dirtyStart);
+   if ( startSloc >= (*sourceLength) )
    {
-      op = *(binary+i);
-      pOp = m_6502opcode+op;
-      opSize = *(opcode_size+pOp->amode);
-
-      mask = *(opcodeMask+i);
-
-      ptr = (*disassembly);
-
-      // save sloc
-      (*sloc2addr) = i;
-      sloc2addr++;
-      (*addr2sloc) = (*sourceLength);
-      addr2sloc++;
+      startSloc = 0;
+   }
+   i = ((*sourceLength) > 0) ? (*(sloc2addr+startSloc)) : 0;
+   endSloc = (*sourceLength);
 
-      // If we've discovered this address has been executed by the 6502 we'll
-      // attempt to provide disassembly for it...
-      if ( (mask) && ((i+opSize) < binaryLength) )
+   // ...and once past the last changed byte, the lines from the first
+   // one the old layout also starts on are unchanged too.
+   while ( i < binaryLength )
+   {
+      if ( i > dirtyEnd )
       {
-         sprintf_opcode ( ptr, pOp->name );
-
-         switch ( pOp->amode )
-         {
-               // Single byte operands
-            case AM_IMMEDIATE:
-            case AM_ZEROPAGE_INDEXED_X:
-            case AM_ZEROPAGE_INDEXED_Y:
-            case AM_ZEROPAGE:
-            case AM_PREINDEXED_INDIRECT:
-            case AM_POSTINDEXED_INDIRECT:
-            case AM_RELATIVE:
-               ptr += sprintf ( ptr, operandFmt[pOp->amode], binary[i+1] );
-               break;
-
-               // Two byte operands
-            case AM_ABSOLUTE:
-            case AM_ABSOLUTE_INDEXED_X:
-            case AM_ABSOLUTE_INDEXED_Y:
-            case AM_INDIRECT:
-               ptr += sprintf ( ptr, operandFmt[pOp->amode], binary[i+2], binary[i+1] );
-               break;
-         }
-
-         if ( opSize > 2 )
+         sloc = *(addr2sloc+i);
+         if ( (sloc < (*sourceLength)) && ((*(sloc2addr+sloc)) == i) )
          {
-            strcpy((*(disassembly+2)), (*disassembly));
-            (*addr2sloc) = (*sourceLength);
-            addr2sloc++;
+            endSloc = sloc;
+            break;
          }
+      }
 
-         if ( opSize > 1 )
-         {
-            strcpy((*(disassembly+1)), (*disassembly));
-            (*addr2sloc) = (*sourceLength);
-            addr2sloc++;
-         }
+      lines [ numLines++ ] = i;
 
+      // If we've discovered this address has been executed by the 6502 the
+      // instruction makes up one source line, otherwise each byte does.
+      opSize = *(opcode_size+m_6502opcode[*(binary+i)].amode);
+      if ( (*(opcodeMask+i)) && ((i+opSize) < binaryLength) )
+      {
          i += opSize;
-         disassembly += opSize;
       }
       else
       {
-         sprintf_db(ptr);
-         sprintf_02x(ptr,binary[i]);
-
          i++;
-         disassembly++;
       }
+   }
 
-      (*sourceLength)++;
+   // Shift the unchanged lines after the region to their new source lines.
+   delta = numLines-(endSloc-startSloc);
+   if ( delta )
+   {
+      memmove ( sloc2addr+startSloc+numLines, sloc2addr+endSloc, ((*sourceLength)-endSloc)*sizeof(uint16_t) );
+      for ( addr = i; addr < binaryLength; addr++ )
+      {
+         (*(addr2sloc+addr)) += delta;
+      }
+      (*sourceLength) += delta;
+   }
+
+   // Lay out the region again.
+   for ( sloc = 0; sloc < numLines; sloc++ )
+   {
+      (*(sloc2addr+startSloc+sloc)) = lines[sloc];
+      for ( addr = lines[sloc]; addr < ((sloc+1 < numLines) ? lines[sloc+1] : i); addr++ )
+      {
+         (*(addr2sloc+addr)) = startSloc+sloc;
+      }
    }
 }
 
+char* C6502::DISASSEMBLY ( uint8_t* binary, int32_t binaryLength, uint8_t* opcodeMask, uint16_t* sloc2addr, uint16_t* addr2sloc, uint32_t offset )
+{
+   CNES6502_opcode* pOp;
+   int32_t opSize;
+   char* ptr = STATE()->m_disassembly;
+   const char* text;
+   int32_t i;
+
+   // Render the source line the byte belongs to as the last DISASSEMBLE
+   // laid it out...
+   i = *(sloc2addr+(*(addr2sloc+offset)));
+   pOp = m_6502opcode+(*(binary+i));
+   opSize = *(opcode_size+pOp->amode);
+
+   if ( (*(opcodeMask+i)) && ((i+opSize) < binaryLength) )
+   {
+      sprintf_opcode ( ptr, pOp->name );
+
+      for ( text = operandPrefix[pOp->amode]; (*text); text++ )
+      {
+         (*(ptr++)) = (*text);
+      }
+      if ( opSize > 2 )
+      {
+         sprintf_02x ( ptr, binary[i+2] );
+      }
+      if ( opSize > 1 )
+      {
+         sprintf_02x ( ptr, binary[i+1] );
+      }
+      for ( text = operandSuffix[pOp->amode]; (*text); text++ )
+      {
+         (*(ptr++)) = (*text);
+      }
+      (*ptr) = 0;
+   }
+   else
+   {
+      sprintf_db(ptr);
+      sprintf_02x(ptr,binary[offset]);
+   }
+
+   return STATE()->m_disassembly;
+}
+
 char* C6502::Disassemble ( uint8_t* pOpcode, char* buffer )
 {
    char* lbuffer = buffer;
@@ -4405,3 +4707,7 @@ char* C6502::Disassemble ( uint8_t* pOpcode, char* buffer )
 
    return lbuffer;
 }
+
+// CPU emulation is driven from the PPU in both debug hook flavors.
+template void C6502::EMULATE<NESNoDebugHooks> ( int32_t cycles );
+template void C6502::EMULATE<NESDebugHooks> ( int32_t cycles );
@@ -6,11 +6,13 @@
 #include "cnes.h"
 
 #include "cmarker.h"
+#include "ccallprofiler.h"
 #include "ctracer.h"
 #include "ccodedatalogger.h"
 #include "cregisterdata.h"
 #include "cmemorydata.h"
 #include "cbreakpointinfo.h"
+#include "cnesstate.h"
 
 // CPU flags register bit definitions.
 #define FLAG_C    0x01
@@ -39,19 +41,19 @@
 
 // CPU stack manipuation macros.
 #define GETSTACKADDR() (MAKE16(rSP(),0x01))
-#define GETSTACKDATA() (MEM(GETSTACKADDR()))
+#define GETSTACKDATA() (MEM<HOOKS>(GETSTACKADDR()))
 
 // CPU program counter manipulation macros.
-#define rPC() (uint32_t)(m_pc)
-#define wPC(pc) { m_pc = (pc); CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_PC); }
-#define INCPC() { m_pc++; CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_PC); }
+#define rPC() (uint32_t)(STATE()->m_pc)
+#define wPC(pc) { STATE()->m_pc = (pc); HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_PC); }
+#define INCPC() { STATE()->m_pc++; HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_PC); }
 
 // CPU stack pointer manipulation macros.
-#define rSP() (m_sp)
-#define wSP(sp) { m_sp = (sp); }
-#define DECSP() { m_sp--;  CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_SP); }
-#define INCSP() { m_sp++;  CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_SP); }
-#define PUSH(data) { MEM(GETSTACKADDR(),(data)); DECSP(); }
+#define rSP() (STATE()->m_sp)
+#define wSP(sp) { STATE()->m_sp = (sp); }
+#define DECSP() { STATE()->m_sp--;  HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_SP); }
+#define INCSP() { STATE()->m_sp++;  HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_SP); }
+#define PUSH(data) { MEM<HOOKS>(GETSTACKADDR(),(data)); DECSP(); }
 
 // The effective address is the calculated address for a
 // memory-affecting CPU operation based on the addressing
@@ -60,56 +62,56 @@
 // absolute physical address being manipulated by the CPU
 // for any given instruction executed.
 // NOTE: INTERNAL MACROS
-#define rEA() (m_ea)
-#define wEA(ea) { m_ea = (ea); }
+#define rEA() (STATE()->m_ea)
+#define wEA(ea) { STATE()->m_ea = (ea); }
 
 // CPU accumulator, X, and Y register manipulation macros.
 // NOTE: INTERNAL MACROS
-#define rA() (m_a)
-#define rX() (m_x)
-#define rY() (m_y)
-#define wA(a) { m_a = (a); CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_A); }
-#define wX(x) { m_x = (x); CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_X); }
-#define wY(y) { m_y = (y); CNES::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_Y); }
+#define rA() (STATE()->m_a)
+#define rX() (STATE()->m_x)
+#define rY() (STATE()->m_y)
+#define wA(a) { STATE()->m_a = (a); HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_A); }
+#define wX(x) { STATE()->m_x = (x); HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_X); }
+#define wY(y) { STATE()->m_y = (y); HOOKS::CHECKBREAKPOINT(eBreakInCPU,eBreakOnCPUState,CPU_Y); }
 
 // CPU flags register manipulation macros.  Used by instructions
 // that manipulate the flags register as a complete set rather than
 // as individual flag bits.
 // NOTE: INTERNAL MACROS
-#define rF() (m_f|FLAG_MISC)
-#define wF(f) { m_f = ((f)|FLAG_MISC); }
+#define rF() (STATE()->m_f|FLAG_MISC)
+#define wF(f) { STATE()->m_f = ((f)|FLAG_MISC); }
 
 // CPU flag bit manipulation macros.  Used by instructions that
 // manipulate individual flag bits within the CPU flags register.
 // NOTE: INTERNAL MACROS
-#define rN() (!!(m_f&FLAG_N))
-#define rV() (!!(m_f&FLAG_V))
-#define rB() (!!(m_f&FLAG_B))
-#define rD() (!!(m_f&FLAG_D))
-#define rI() (!!(m_f&FLAG_I))
-#define rZ() (!!(m_f&FLAG_Z))
-#define rC() (!!(m_f&FLAG_C))
-#define sN() { m_f|=FLAG_N; }
-#define cN() { m_f&=~(FLAG_N); }
-#define sV() { m_f|=FLAG_V; }
-#define cV() { m_f&=~(FLAG_V); }
-#define sB() { m_f|=FLAG_B; }
-#define cB() { m_f&=~(FLAG_B); }
-#define sD() { m_f|=FLAG_D; }
-#define cD() { m_f&=~(FLAG_D); }
-#define sI() { m_f|=FLAG_I; }
-#define cI() { m_f&=~(FLAG_I); }
-#define sZ() { m_f|=FLAG_Z; }
-#define cZ() { m_f&=~(FLAG_Z); }
-#define sC() { m_f|=FLAG_C; }
-#define cC() { m_f&=~(FLAG_C); }
-#define wN(set) { m_f&=(~(FLAG_N)); m_f|=((!!(set))<<FLAG_N_SHIFT); }
-#define wV(set) { m_f&=(~(FLAG_V)); m_f|=((!!(set))<<FLAG_V_SHIFT); }
-#define wB(set) { m_f&=(~(FLAG_B)); m_f|=((!!(set))<<FLAG_B_SHIFT); }
-#define wD(set) { m_f&=(~(FLAG_D)); m_f|=((!!(set))<<FLAG_D_SHIFT); }
-#define wI(set) { m_f&=(~(FLAG_I)); m_f|=((!!(set))<<FLAG_I_SHIFT); }
-#define wZ(set) { m_f&=(~(FLAG_Z)); m_f|=((!!(set))<<FLAG_Z_SHIFT); }
-#define wC(set) { m_f&=(~(FLAG_C)); m_f|=((!!(set))<<FLAG_C_SHIFT); }
+#define rN() (!!(STATE()->m_f&FLAG_N))
+#define rV() (!!(STATE()->m_f&FLAG_V))
+#define rB() (!!(STATE()->m_f&FLAG_B))
+#define rD() (!!(STATE()->m_f&FLAG_D))
+#define rI() (!!(STATE()->m_f&FLAG_I))
+#define rZ() (!!(STATE()->m_f&FLAG_Z))
+#define rC() (!!(STATE()->m_f&FLAG_C))
+#define sN() { STATE()->m_f|=FLAG_N; }
+#define cN() { STATE()->m_f&=~(FLAG_N); }
+#define sV() { STATE()->m_f|=FLAG_V; }
+#define cV() { STATE()->m_f&=~(FLAG_V); }
+#define sB() { STATE()->m_f|=FLAG_B; }
+#define cB() { STATE()->m_f&=~(FLAG_B); }
+#define sD() { STATE()->m_f|=FLAG_D; }
+#define cD() { STATE()->m_f&=~(FLAG_D); }
+#define sI() { STATE()->m_f|=FLAG_I; }
+#define cI() { STATE()->m_f&=~(FLAG_I); }
+#define sZ() { STATE()->m_f|=FLAG_Z; }
+#define cZ() { STATE()->m_f&=~(FLAG_Z); }
+#define sC() { STATE()->m_f|=FLAG_C; }
+#define cC() { STATE()->m_f&=~(FLAG_C); }
+#define wN(set) { STATE()->m_f&=(~(FLAG_N)); STATE()->m_f|=((!!(set))<<FLAG_N_SHIFT); }
+#define wV(set) { STATE()->m_f&=(~(FLAG_V)); STATE()->m_f|=((!!(set))<<FLAG_V_SHIFT); }
+#define wB(set) { STATE()->m_f&=(~(FLAG_B)); STATE()->m_f|=((!!(set))<<FLAG_B_SHIFT); }
+#define wD(set) { STATE()->m_f&=(~(FLAG_D)); STATE()->m_f|=((!!(set))<<FLAG_D_SHIFT); }
+#define wI(set) { STATE()->m_f&=(~(FLAG_I)); STATE()->m_f|=((!!(set))<<FLAG_I_SHIFT); }
+#define wZ(set) { STATE()->m_f&=(~(FLAG_Z)); STATE()->m_f|=((!!(set))<<FLAG_Z_SHIFT); }
+#define wC(set) { STATE()->m_f&=(~(FLAG_C)); STATE()->m_f|=((!!(set))<<FLAG_C_SHIFT); }
 
 // The C6502 class is the implementation of the core CPU of the NES.
 // It provides CPU-fetch-cycle granular emulation of the CPU core, including
@@ -142,26 +144,48 @@
 // one actual CPU cycle.  This is a limitation that could be removed in
 // future updates to the CPU core, but currently adequate accuracy is obtained
 // with this method.
+// One 2KB page of the CPU address space in the CPU bus page tables.
+// Pages backed by plain memory are reached through a pointer to the
+// bank pointer the memory is mapped by, so bank switches done by the
+// mappers take effect without the tables being touched.
+typedef struct _CNES6502_page
+{
+   // Bank pointer slot, or NULL if the page is I/O-mapped.
+   uint8_t** pBank;
+
+   // Offset of this page within the bank.
+   uint32_t offset;
+
+   // Tracer target of accesses to this page.
+   int8_t target;
+} CNES6502_page;
+
+// Number of entries in the CPU bus page tables.
+#define NUM_CPU_PAGES (MEM_64KB>>UPSHIFT_2KB)
+
 class C6502
 {
 public:
-   C6502();
-   ~C6502();
-
    // Emulation routines.
-   static void EMULATE ( int32_t cycles );
+   template <class HOOKS> static void EMULATE ( int32_t cycles );
    static void GOTO ( uint32_t pcGoto )
    {
-      m_pcGoto = pcGoto;
+      STATE()->m_pcGoto = pcGoto;
    }
    static void GOTO ()
    {
-      m_pcGoto = 0xFFFFFFFF;
+      STATE()->m_pcGoto = 0xFFFFFFFF;
    }
 
    // CPU reset vector routine.
    static void RESET ( bool soft );
 
+   // Save state support.  SAVESTATE writes this object's chunk of a save
+   // state; LOADSTATE restores it, returning false if the chunk is missing
+   // or does not match.
+   static void SAVESTATE ( CNESStateWriter& writer );
+   static bool LOADSTATE ( CNESStateReader& reader );
+
    // Routines to manipulate the IRQ/NMI inputs to the CPU core.
    static void ASSERTIRQ ( int8_t source );
    static void RELEASEIRQ ( int8_t source );
@@ -172,100 +196,100 @@ public:
    // assertion of NMI to the CPU.
    static void CHOKENMI ()
    {
-      m_nmiAsserted = false;
+      STATE()->m_nmiAsserted = false;
    }
 
    // The CPU BRK instruction and also the handler routines for
    // NMI and IRQ interrupts, since the behavior of BRK, IRQ, and NMI
    // is very similar.  (A NMI or IRQ is actually treated like an
    // instruction [BRK] in the instruction stream.)
-   static void BRK ( void );
+   template <class HOOKS> static void BRK ( void );
 
    // CPU instruction execution routines.  Each routine
    // contains the logic to execute all addressing mode
    // variants of the particular instruction.
    // The documented opcodes:
-   static void ADC ( void );
-   static void AND ( void );
-   static void ASL ( void );
-   static void BCC ( void );
-   static void BCS ( void );
-   static void BEQ ( void );
-   static void BIT ( void );
-   static void BMI ( void );
-   static void BNE ( void );
-   static void BPL ( void );
-   static void BVC ( void );
-   static void BVS ( void );
-   static void CLC ( void );
-   static void CLD ( void );
-   static void CLI ( void );
-   static void CLV ( void );
-   static void CMP ( void );
-   static void CPX ( void );
-   static void CPY ( void );
-   static void DEC ( void );
-   static void DEX ( void );
-   static void DEY ( void );
-   static void EOR ( void );
-   static void INC ( void );
-   static void INX ( void );
-   static void INY ( void );
-   static void JMP ( void );
-   static void JSR ( void );
-   static void LDA ( void );
-   static void LDY ( void );
-   static void LDX ( void );
-   static void LSR ( void );
-   static void NOP ( void );
-   static void ORA ( void );
-   static void PHA ( void );
-   static void PHP ( void );
-   static void PLA ( void );
-   static void PLP ( void );
-   static void ROL ( void );
-   static void ROR ( void );
-   static void RTI ( void );
-   static void RTS ( void );
-   static void SBC ( void );
-   static void SEC ( void );
-   static void SED ( void );
-   static void SEI ( void );
-   static void STA ( void );
-   static void STX ( void );
-   static void STY ( void );
-   static void TAX ( void );
-   static void TAY ( void );
-   static void TSX ( void );
-   static void TXA ( void );
-   static void TXS ( void );
-   static void TYA ( void );
+   template <class HOOKS> static void ADC ( void );
+   template <class HOOKS> static void AND ( void );
+   template <class HOOKS> static void ASL ( void );
+   template <class HOOKS> static void BCC ( void );
+   template <class HOOKS> static void BCS ( void );
+   template <class HOOKS> static void BEQ ( void );
+   template <class HOOKS> static void BIT ( void );
+   template <class HOOKS> static void BMI ( void );
+   template <class HOOKS> static void BNE ( void );
+   template <class HOOKS> static void BPL ( void );
+   template <class HOOKS> static void BVC ( void );
+   template <class HOOKS> static void BVS ( void );
+   template <class HOOKS> static void CLC ( void );
+   template <class HOOKS> static void CLD ( void );
+   template <class HOOKS> static void CLI ( void );
+   template <class HOOKS> static void CLV ( void );
+   template <class HOOKS> static void CMP ( void );
+   template <class HOOKS> static void CPX ( void );
+   template <class HOOKS> static void CPY ( void );
+   template <class HOOKS> static void DEC ( void );
+   template <class HOOKS> static void DEX ( void );
+   template <class HOOKS> static void DEY ( void );
+   template <class HOOKS> static void EOR ( void );
+   template <class HOOKS> static void INC ( void );
+   template <class HOOKS> static void INX ( void );
+   template <class HOOKS> static void INY ( void );
+   template <class HOOKS> static void JMP ( void );
+   template <class HOOKS> static void JSR ( void );
+   template <class HOOKS> static void LDA ( void );
+   template <class HOOKS> static void LDY ( void );
+   template <class HOOKS> static void LDX ( void );
+   template <class HOOKS> static void LSR ( void );
+   template <class HOOKS> static void NOP ( void );
+   template <class HOOKS> static void ORA ( void );
+   template <class HOOKS> static void PHA ( void );
+   template <class HOOKS> static void PHP ( void );
+   template <class HOOKS> static void PLA ( void );
+   template <class HOOKS> static void PLP ( void );
+   template <class HOOKS> static void ROL ( void );
+   template <class HOOKS> static void ROR ( void );
+   template <class HOOKS> static void RTI ( void );
+   template <class HOOKS> static void RTS ( void );
+   template <class HOOKS> static void SBC ( void );
+   template <class HOOKS> static void SEC ( void );
+   template <class HOOKS> static void SED ( void );
+   template <class HOOKS> static void SEI ( void );
+   template <class HOOKS> static void STA ( void );
+   template <class HOOKS> static void STX ( void );
+   template <class HOOKS> static void STY ( void );
+   template <class HOOKS> static void TAX ( void );
+   template <class HOOKS> static void TAY ( void );
+   template <class HOOKS> static void TSX ( void );
+   template <class HOOKS> static void TXA ( void );
+   template <class HOOKS> static void TXS ( void );
+   template <class HOOKS> static void TYA ( void );
 
    // The undocumented opcodes:
-   static void ASO ( void );
-   static void AXS ( void );
-   static void ANC ( void );
-   static void ALR ( void );
-   static void ARR ( void );
-   static void DCM ( void );
-   static void INS ( void );
-   static void LAX ( void );
-   static void LSE ( void );
-   static void DOP ( void );
-   static void TOP ( void );
-   static void RLA ( void );
-   static void RRA ( void );
-   static void XAA ( void );
-   static void AXA ( void );
-   static void TAS ( void );
-   static void SAY ( void );
-   static void XAS ( void );
-   static void OAL ( void );
-   static void LAS ( void );
-   static void SAX ( void );
+   template <class HOOKS> static void ASO ( void );
+   template <class HOOKS> static void AXS ( void );
+   template <class HOOKS> static void ANC ( void );
+   template <class HOOKS> static void ALR ( void );
+   template <class HOOKS> static void ARR ( void );
+   template <class HOOKS> static void DCM ( void );
+   template <class HOOKS> static void INS ( void );
+   template <class HOOKS> static void LAX ( void );
+   template <class HOOKS> static void LSE ( void );
+   template <class HOOKS> static void DOP ( void );
+   template <class HOOKS> static void TOP ( void );
+   template <class HOOKS> static void RLA ( void );
+   template <class HOOKS> static void RRA ( void );
+   template <class HOOKS> static void XAA ( void );
+   template <class HOOKS> static void AXA ( void );
+   template <class HOOKS> static void TAS ( void );
+   template <class HOOKS> static void SAY ( void );
+   template <class HOOKS> static void XAS ( void );
+   template <class HOOKS> static void OAL ( void );
+   template <class HOOKS> static void LAS ( void );
+   template <class HOOKS> static void SAX ( void );
 
    // The illegal opcodes:
-   static void KIL ( void );
+   template <class HOOKS> static void KIL ( void );
 
    // Accessor methods for retrieving information from or about
    // the managed entities within the CPU core object.
@@ -273,7 +297,7 @@ public:
    // Return the currently calculated effective address.
    static uint32_t _EA ( void )
    {
-      return m_ea;
+      return STATE()->m_ea;
    }
 
    // Return the contents of a memory location visible to the CPU.
@@ -285,21 +309,21 @@ public:
    // Retrieve a pointer to the whole memory.
    static uint8_t* _MEMPTR ( void )
    {
-      return m_6502memory;
+      return STATE()->m_6502memory;
    }
 
    // Return whether or not the CPU is currently in the middle of
    // the first cycle of an instruction fetch (the opcode fetch).
    static bool _SYNC ( void )
    {
-      return (m_instrCycle==0);
+      return (STATE()->m_instrCycle==0);
    }
 
    // Return whether or not the CPU is currently in the middle of
    // a write memory cycle.
    static bool _WRITING ( void )
    {
-      return m_write;
+      return STATE()->m_write;
    }
 
    // Return the current cycle index of the CPU core.
@@ -308,35 +332,35 @@ public:
    // But, roll-over of this counter is not a significant event.
    static inline uint32_t _CYCLES ( void )
    {
-      return m_cycles;
+      return STATE()->m_cycles;
    }
 
    // Accessor methods to set up or clear the state of the RAM
    // maintained internally by the CPU core object.
    static void MEMSET ( uint32_t addr, uint8_t* data, uint32_t length )
    {
-      memcpy(m_6502memory+addr,data,length);
+      memcpy(STATE()->m_6502memory+addr,data,length);
    };
    static void MEMCLR ( void )
    {
-      memset(m_6502memory,0,MEM_2KB);
+      memset(STATE()->m_6502memory,0,MEM_2KB);
    }
 
    // Method to return the current open bus data.
-   static uint8_t OPENBUS () { return m_openBusData; }
+   static uint8_t OPENBUS () { return STATE()->m_openBusData; }
 
    // DMA driver method.
-   static bool DMA ( void );
+   template <class HOOKS> static bool DMA ( void );
 
    // Accessor methods for supporting DMA between the CPU and APU/PPU.
-   static uint8_t DMA ( uint32_t addr );
-   static void DMA ( uint32_t srcAddr, uint32_t dstAddr, uint8_t data );
+   template <class HOOKS> static uint8_t DMA ( uint32_t addr );
+   template <class HOOKS> static void DMA ( uint32_t srcAddr, uint32_t dstAddr, uint8_t data );
 
    // The APU can request a DMA.
    static void APUDMAREQ ( uint16_t addr );
 
    // Accessor method for stack popping.
-   static inline uint32_t POP ( void )
+   template <class HOOKS> static inline uint32_t POP ( void )
    {
       INCSP();
       return GETSTACKDATA();
@@ -347,125 +371,125 @@ public:
    // emulator core.
    static uint32_t __PC ( void )
    {
-      return m_pc;
+      return STATE()->m_pc;
    }
    static uint32_t __PCSYNC ( void )
    {
-      if ( m_pcSyncSet )
+      if ( STATE()->m_pcSyncSet )
       {
-         return m_pcSync;
+         return STATE()->m_pcSync;
       }
       else
       {
-         return m_pc;
+         return STATE()->m_pc;
       }
    }
    static void __PC ( uint16_t pc )
    {
-      m_pc = pc;
+      STATE()->m_pc = pc;
    }
    static uint32_t _SP ( void )
    {
-      return m_sp;
+      return STATE()->m_sp;
    }
    static void _SP ( uint8_t sp )
    {
-      m_sp = sp;
+      STATE()->m_sp = sp;
    }
    static uint32_t _A ( void )
    {
-      return m_a;
+      return STATE()->m_a;
    }
    static void _A ( uint8_t a )
    {
-      m_a = a;
+      STATE()->m_a = a;
    }
    static uint32_t _X ( void )
    {
-      return m_x;
+      return STATE()->m_x;
    }
    static void _X ( uint8_t x )
    {
-      m_x = x;
+      STATE()->m_x = x;
    }
    static uint32_t _Y ( void )
    {
-      return m_y;
+      return STATE()->m_y;
    }
    static void _Y ( uint8_t y )
    {
-      m_y = y;
+      STATE()->m_y = y;
    }
    static uint32_t _F ( void )
    {
-      return m_f;
+      return STATE()->m_f;
    }
    static void _F ( uint8_t f )
    {
-      m_f = f;
+      STATE()->m_f = f;
    }
    static uint32_t _N ( void )
    {
-      return (!!(m_f&FLAG_N));   // Negative
+      return (!!(STATE()->m_f&FLAG_N));   // Negative
    }
    static uint32_t _V ( void )
    {
-      return (!!(m_f&FLAG_V));   // Overflow
+      return (!!(STATE()->m_f&FLAG_V));   // Overflow
    }
    static uint32_t _B ( void )
    {
-      return (!!(m_f&FLAG_B));   // Break command
+      return (!!(STATE()->m_f&FLAG_B));   // Break command
    }
    static uint32_t _D ( void )
    {
-      return (!!(m_f&FLAG_D));   // Decimal mode
+      return (!!(STATE()->m_f&FLAG_D));   // Decimal mode
    }
    static uint32_t _I ( void )
    {
-      return (!!(m_f&FLAG_I));   // Interrupt disable
+      return (!!(STATE()->m_f&FLAG_I));   // Interrupt disable
    }
    static uint32_t _Z ( void )
    {
-      return (!!(m_f&FLAG_Z));   // Zero
+      return (!!(STATE()->m_f&FLAG_Z));   // Zero
    }
    static uint32_t _C ( void )
    {
-      return (!!(m_f&FLAG_C));   // Carry
+      return (!!(STATE()->m_f&FLAG_C));   // Carry
    }
    static void _N ( uint32_t set )
    {
-      m_f&=~(FLAG_N);
-      m_f|=((!!set)<<FLAG_N_SHIFT);
+      STATE()->m_f&=~(FLAG_N);
+      STATE()->m_f|=((!!set)<<FLAG_N_SHIFT);
    }
    static void _V ( uint32_t set )
    {
-      m_f&=~(FLAG_V);
-      m_f|=((!!set)<<FLAG_V_SHIFT);
+      STATE()->m_f&=~(FLAG_V);
+      STATE()->m_f|=((!!set)<<FLAG_V_SHIFT);
    }
    static void _B ( uint32_t set )
    {
-      m_f&=~(FLAG_B);
-      m_f|=((!!set)<<FLAG_B_SHIFT);
+      STATE()->m_f&=~(FLAG_B);
+      STATE()->m_f|=((!!set)<<FLAG_B_SHIFT);
    }
    static void _D ( uint32_t set )
    {
-      m_f&=~(FLAG_D);
-      m_f|=((!!set)<<FLAG_D_SHIFT);
+      STATE()->m_f&=~(FLAG_D);
+      STATE()->m_f|=((!!set)<<FLAG_D_SHIFT);
    }
    static void _I ( uint32_t set )
    {
-      m_f&=~(FLAG_I);
-      m_f|=((!!set)<<FLAG_I_SHIFT);
+      STATE()->m_f&=~(FLAG_I);
+      STATE()->m_f|=((!!set)<<FLAG_I_SHIFT);
    }
    static void _Z ( uint32_t set )
    {
-      m_f&=~(FLAG_Z);
-      m_f|=((!!set)<<FLAG_Z_SHIFT);
+      STATE()->m_f&=~(FLAG_Z);
+      STATE()->m_f|=((!!set)<<FLAG_Z_SHIFT);
    }
    static void _C ( uint32_t set )
    {
-      m_f&=~(FLAG_C);
-      m_f|=((!!set)<<FLAG_C_SHIFT);
+      STATE()->m_f&=~(FLAG_C);
+      STATE()->m_f|=((!!set)<<FLAG_C_SHIFT);
    }
 
    // Interface to retrieve the database of execution markers.
@@ -477,17 +501,27 @@ public:
    // database visually.
    static CMarker* MARKERS()
    {
-      return m_marker;
+      return STATE()->m_marker;
+   }
+
+   // Interface to retrieve the call profiler.  The CPU core tells it
+   // about subroutine calls and returns and interrupts so it can charge
+   // the cycles executed to call chains.  The Code Profiler debugger
+   // inspector reads it to export call stacks for flame graphs.
+   static CCallProfiler* PROFILER()
+   {
+      return STATE()->m_profiler;
    }
 
    // Disassembly routines for display.
    static void DISASSEMBLE ();
-   static void DISASSEMBLE ( char** disassembly, uint8_t* binary, int32_t binaryLength, uint8_t* opcodeMask, uint16_t* sloc2addr, uint16_t* addr2sloc, uint32_t* sourceLength );
+   static void DISASSEMBLE ( uint8_t* binary, int32_t binaryLength, uint8_t* opcodeMask, uint16_t* sloc2addr, uint16_t* addr2sloc, uint32_t* sourceLength, int32_t dirtyStart, int32_t dirtyEnd );
+   static char* DISASSEMBLY ( uint8_t* binary, int32_t binaryLength, uint8_t* opcodeMask, uint16_t* sloc2addr, uint16_t* addr2sloc, uint32_t offset );
    static char* Disassemble ( uint8_t* pOpcode, char* buffer );
 
    static inline CCodeDataLogger* LOGGER ( void )
    {
-      return m_logger;
+      return STATE()->m_logger;
    }
 
    // Interface to retrieve the database defining the registers
@@ -513,7 +547,7 @@ public:
    // breakpoint if a KIL opcode is executed.
    static void BREAKONKIL(bool breakOnKIL)
    {
-      m_breakOnKIL = breakOnKIL;
+      STATE()->m_breakOnKIL = breakOnKIL;
    }
 
    // Interface to retrieve the database of CPU core-specific
@@ -536,191 +570,233 @@ public:
    // An "opcode mask" is tracked for each byte of accessible
    // RAM.  If a memory location is fetched by the CPU as an
    // opcode (see _SYNC), the memory location is marked
-   // as having been executed.  Disassembly of the executed
-   // instruction is generated real-time.  If the debuggers
-   // need to display disassembly of a memory location they
-   // retrieve it from the database generated by the runtime
-   // disassembler.
+   // as having been executed.  The runtime disassembler lays
+   // out the source lines of the executed instructions.  If
+   // the debuggers need to display disassembly of a memory
+   // location it is rendered from that layout on request.
    static inline void OPCODEMASK ( uint32_t addr, uint8_t mask )
    {
-      *(m_RAMopcodeMask+(addr&MEM_2KB)) = mask;
+      *(STATE()->m_RAMopcodeMask+(addr&MEM_2KB)) = mask;
    }
    static inline void OPCODEMASKCLR ( void )
    {
       int32_t idx;
       for ( idx = 0; idx < MEM_2KB; idx++ )
       {
-         m_RAMopcodeMask[idx] = 0;
+         STATE()->m_RAMopcodeMask[idx] = 0;
       }
    }
    static inline char* DISASSEMBLY ( uint32_t addr )
    {
-      return *(m_RAMdisassembly+addr);
+      return DISASSEMBLY ( STATE()->m_6502memory,
+                           MEM_2KB,
+                           STATE()->m_RAMopcodeMask,
+                           STATE()->m_RAMsloc2addr,
+                           STATE()->m_RAMaddr2sloc,
+                           addr );
    }
    static uint32_t SLOC2ADDR ( uint16_t sloc )
    {
-      return *(m_RAMsloc2addr+sloc);
+      return *(STATE()->m_RAMsloc2addr+sloc);
    }
    static uint16_t ADDR2SLOC ( uint32_t addr )
    {
-      return *(m_RAMaddr2sloc+addr);
+      return *(STATE()->m_RAMaddr2sloc+addr);
    }
    static inline uint16_t SLOC ()
    {
-      return m_RAMsloc;
+      return STATE()->m_RAMsloc;
    }
 
    static inline uint32_t WRITEDMAADDR()
    {
-      return (512-m_writeDmaCounter)>>1;
+      return (512-STATE()->m_writeDmaCounter)>>1;
    }
 
 protected:
    // Routine to calculate the effective address of a particular
    // instruction addressing mode based on the internal state of the CPU.
-   static inline uint32_t MAKEADDR ( int32_t amode, uint8_t* data );
+   template <class HOOKS> static inline uint32_t MAKEADDR ( int32_t amode, uint8_t* data );
 
    // Routine to drive APU and CPU synchronization by cycles.
-   static void ADVANCE ( bool stealing = false );
+   template <class HOOKS> static void ADVANCE ( bool stealing = false );
+
+   // Routine to tell the call profiler a subroutine or interrupt handler
+   // has been entered at the current PC.  sp is the stack pointer before
+   // the return address was pushed.
+   static void PROFILECALL ( uint8_t sp );
 
    // Routines to access the RAM maintained by the CPU core object.
    // These are used internally by the CPU core during emulation.
-   static uint8_t MEM ( uint32_t addr );
-   static void MEM ( uint32_t addr, uint8_t data );
-   static uint8_t FETCH ();
-   static uint8_t EXTRAFETCH ();
-   static uint8_t STEAL ( uint32_t addr, uint8_t source );
+   template <class HOOKS> static uint8_t MEM ( uint32_t addr );
+   template <class HOOKS> static void MEM ( uint32_t addr, uint8_t data );
+   template <class HOOKS> static uint8_t FETCH ();
+   template <class HOOKS> static uint8_t EXTRAFETCH ();
+   template <class HOOKS> static uint8_t STEAL ( uint32_t addr, uint8_t source );
    static uint8_t LOAD ( uint32_t addr, int8_t* pTarget );
    static void STORE ( uint32_t addr, uint8_t data, int8_t* pTarget );
 
-   // Is the CPU currently locked due to execution of an
-   // illegal instruction?  Illegal instructions are all KIL opcodes.
-   static bool            m_killed;
-
-   // Has an IRQ been asserted to the CPU core?
-   static bool            m_irqAsserted;
-
-   // Was IRQ asserted when checked?
-   static bool            m_irqPending;
-
-   // Has NMI been asserted to the CPU core?
-   static bool            m_nmiAsserted;
-
-   // Was NMI asserted when checked?
-   static bool            m_nmiPending;
-
-   // The CPU core maintains the 2KB of RAM visible to the CPU.
-   static uint8_t*  m_6502memory;
-
-   // The CPU core registers.
-   static uint8_t   m_a;
-   static uint8_t   m_x;
-   static uint8_t   m_y;
-   static uint8_t   m_f;
-   static uint16_t  m_pc;
-   static uint16_t  m_pcSync;
-   static bool      m_pcSyncSet;
-   static uint8_t   m_sp;
-
-   // The effective address calculated by the CPU core.
-   static uint32_t    m_ea;
-
-   // The address to break at on a "run to here" go.
-   static uint32_t            m_pcGoto;
-
-   // Running counter of CPU cycles executed.  Will roll over in
-   // approximately 40 minutes of emulation.
-   static uint32_t    m_cycles;
-   static int32_t     m_instrCycle;
-
-   // The current number of CPU cycles ready to be executed by
-   // the CPU core.
-   static int32_t             m_curCycles; // must be allowed to go negative!
-
-   // The following data is used internally by the CPU core
-   // during instruction execution.  As opcodes are fetched and
-   // decoded, relevant information about the opcode is stored
-   // in these variables to avoid passing all of this information
-   // on the stack frame during instruction execution via
-   // function-pointer invocation.
-   // The current opcode's addressing mode.
-   static int32_t             amode;
-
-   // DMC DMA request active flag.
-   static int32_t m_dmaRequest;
-
-   // DMA address for DMA write transfers.  The CPU sets this on a DMA
-   // request from a write to $4014, then begins its DMA transfer at the
-   // appropriate time.  When not DMAing the counter will be 0.
-   static uint16_t m_writeDmaAddr;
-   static int32_t m_writeDmaCounter;
-
-   // DMA address for DMA read transfers.  The APU sets this on a DMA
-   // request for a DMC channel sample, then begins its DMA transfer at the
-   // appropriate time.  When not DMAing the counter will be 0.
-   static uint16_t m_readDmaAddr;
-   static int32_t m_readDmaCounter;
-
-   // The current opcode's full 1-, 2-, or 3-byte instruction data.
-   static uint8_t*  data;
-   static uint8_t   opcodeData [ 4 ]; // 3 opcode bytes and 1 byte for operand return data [extra cycle]
-
-   // The current opcode's table entry (see struct _CNES6502_opcode below).
-   static struct _CNES6502_opcode* pOpcodeStruct;
-
-   // The size of the current opcode in bytes (1, 2, or 3).
-   static int32_t             opcodeSize;
-
-   // Whether or not the CPU is in a write memory cycle.
-   static bool            m_write;
-
-   // Open bus data to be returned if reading an unconnected memory region.
-   static uint8_t m_openBusData;
-
-   // Which phase of instruction fetching is the CPU core in?
-   // m_phase will be 0 during the opcode fetch.  m_phase will go
-   // up to 1 if the fetched opcode is 1-byte (extra fetch cycle) or 2-bytes.
-   // m_phase will go up to 3 if the fetched opcode is 3-byte.
-   // Then m_phase goes to -1 for the instruction execution.
-   static int8_t            m_phase;
-
-   // This points to the last execution tracer tag that
-   // is where the disassembly of the instruction should
-   // be placed.
-   static TracerInfo* pDisassemblySample;
-
-   // Database used by the Execution Visualizer debugger inspector.
-   // The data structure is maintained by the CPU core as it executes
-   // instructions that are marked.
-   static CMarker*         m_marker;
-
-   // Database used by the Code/Data Logger debugger inspector.  The data structure
-   // is maintained by the CPU core as it performs fetches, reads,
-   // writes, and DMA transfers to/from its managed RAM.  The
-   // Code/Data Logger displays the collected information graphically.
-   static CCodeDataLogger* m_logger;
+   // Routine to set up the CPU bus page tables for the mapper.
+   static void MAPPAGES ( void );
+
+   // The data saved and restored as-is by SAVESTATE and LOADSTATE.
+   template <class STREAM> static void STATEDATA ( STREAM& stream );
+
+   friend struct NESContext;
+   struct State
+   {
+      State ();
+      ~State ();
+
+      // Is the CPU currently locked due to execution of an
+      // illegal instruction?  Illegal instructions are all KIL opcodes.
+      bool            m_killed = false;
+
+      // Has an IRQ been asserted to the CPU core?
+      bool            m_irqAsserted = false;
+
+      // Was IRQ asserted when checked?
+      bool            m_irqPending = false;
+
+      // Has NMI been asserted to the CPU core?
+      bool            m_nmiAsserted = false;
+
+      // Was NMI asserted when checked?
+      bool            m_nmiPending = false;
+
+      // The CPU core maintains the 2KB of RAM visible to the CPU.
+      uint8_t*  m_6502memory = NULL;
+
+      // CPU bus page tables.  LOAD and STORE access memory-backed
+      // pages directly; the rest go to the register and mapper handlers.
+      CNES6502_page m_readPage [ NUM_CPU_PAGES ];
+      CNES6502_page m_writePage [ NUM_CPU_PAGES ];
+
+      // The CPU core registers.
+      uint8_t   m_a = 0x00;
+      uint8_t   m_x = 0x00;
+      uint8_t   m_y = 0x00;
+      uint8_t   m_f = FLAG_MISC;
+      uint16_t  m_pc = VECTOR_RESET;
+      uint16_t  m_pcSync = VECTOR_RESET;
+      bool      m_pcSyncSet = false;
+      uint8_t   m_sp = 0x00;
+
+      // The effective address calculated by the CPU core.
+      uint32_t    m_ea = 0;
+
+      // The address to break at on a "run to here" go.
+      uint32_t            m_pcGoto = 0xFFFFFFFF;
+
+      // Running counter of CPU cycles executed.  Will roll over in
+      // approximately 40 minutes of emulation.
+      uint32_t    m_cycles = 0;
+      int32_t     m_instrCycle = 0;
+
+      // The current number of CPU cycles ready to be executed by
+      // the CPU core.
+      int32_t             m_curCycles = 0; // must be allowed to go negative!
+
+      // The following data is used internally by the CPU core
+      // during instruction execution.  As opcodes are fetched and
+      // decoded, relevant information about the opcode is stored
+      // in these variables to avoid passing all of this information
+      // on the stack frame during instruction execution via
+      // function-pointer invocation.
+      // The current opcode's addressing mode.
+      int32_t             amode = 0;
+
+      // DMC DMA request active flag.
+      int32_t m_dmaRequest = -1;
+
+      // DMA address for DMA write transfers.  The CPU sets this on a DMA
+      // request from a write to $4014, then begins its DMA transfer at the
+      // appropriate time.  When not DMAing the counter will be 0.
+      uint16_t m_writeDmaAddr = 0x0000;
+      int32_t m_writeDmaCounter = 0;
+
+      // DMA address for DMA read transfers.  The APU sets this on a DMA
+      // request for a DMC channel sample, then begins its DMA transfer at the
+      // appropriate time.  When not DMAing the counter will be 0.
+      uint16_t m_readDmaAddr = 0x0000;
+      int32_t m_readDmaCounter = 0;
+
+      // The current opcode's full 1-, 2-, or 3-byte instruction data.
+      uint8_t*  data = NULL;
+      uint8_t   opcodeData [ 4 ] = { 0, }; // 3 opcode bytes and 1 byte for operand return data [extra cycle]
+
+      // The current opcode's table entry (see struct _CNES6502_opcode below).
+      struct _CNES6502_opcode* pOpcodeStruct = NULL;
+
+      // The size of the current opcode in bytes (1, 2, or 3).
+      int32_t             opcodeSize = 0;
+
+      // Whether or not the CPU is in a write memory cycle.
+      bool            m_write = false;
+
+      // Open bus data to be returned if reading an unconnected memory region.
+      uint8_t m_openBusData = 0x00;
+
+      // Which phase of instruction fetching is the CPU core in?
+      // m_phase will be 0 during the opcode fetch.  m_phase will go
+      // up to 1 if the fetched opcode is 1-byte (extra fetch cycle) or 2-bytes.
+      // m_phase will go up to 3 if the fetched opcode is 3-byte.
+      // Then m_phase goes to -1 for the instruction execution.
+      int8_t            m_phase = 0;
+
+      // This is the execution tracer sample that the
+      // disassembly of the instruction should be placed in.
+      uint32_t disassemblySample = TRACER_NO_SAMPLE;
+
+      // Database used by the Execution Visualizer debugger inspector.
+      // The data structure is maintained by the CPU core as it executes
+      // instructions that are marked.
+      CMarker*         m_marker = NULL;
+
+      // Shadow call stack and call tree used by the Code Profiler debugger
+      // inspector.  It is maintained by the CPU core as it executes
+      // subroutine calls and returns and takes interrupts.
+      CCallProfiler*   m_profiler = NULL;
+
+      // Database used by the Code/Data Logger debugger inspector.  The data structure
+      // is maintained by the CPU core as it performs fetches, reads,
+      // writes, and DMA transfers to/from its managed RAM.  The
+      // Code/Data Logger displays the collected information graphically.
+      CCodeDataLogger* m_logger = NULL;
+
+
+
+      // Configuration from EmulatorPrefs.
+      bool m_breakOnKIL = false;
+
+
+      // The data structures that support runtime disassembly of executed code.
+      uint8_t*   m_RAMopcodeMask = NULL;
+      uint16_t*  m_RAMsloc2addr = NULL;
+      uint16_t*  m_RAMaddr2sloc = NULL;
+      uint32_t    m_RAMsloc = 0;
+
+      // The text DISASSEMBLY renders a source line into.
+      char m_disassembly [ 16 ];
+
+      // Sprite DMA transfer byte held between the read and write cycles.
+      uint8_t m_dmaData = 0x00;
+
+      // Interrupt vector fetch state carried across the cycles of BRK.
+      uint8_t m_brkPclo = 0x00;
+      bool    m_brkDoingIrq = false;
+   };
+   static inline State* STATE ();
 
    // The database for CPU core registers.  Declaration
    // is in source file.
    static CRegisterDatabase* m_dbRegisters;
-
    // The database for CPU RAM.  Declaration is in source file.
    static CMemoryDatabase* m_dbMemory;
-
-   // Configuration from EmulatorPrefs.
-   static bool m_breakOnKIL;
-
    // The database for CPU core breakpoint events.  Declaration
    // is in source file.
    static CBreakpointEventInfo** m_tblBreakpointEvents;
    static int32_t                    m_numBreakpointEvents;
-
-   // The data structures that support runtime disassembly of executed code.
-   static uint8_t*   m_RAMopcodeMask;
-   static char**           m_RAMdisassembly;
-   static uint16_t*  m_RAMsloc2addr;
-   static uint16_t*  m_RAMaddr2sloc;
-   static uint32_t    m_RAMsloc;
 };
 
 // Structure representing each instruction and
@@ -733,8 +809,9 @@ typedef struct _CNES6502_opcode
    // Instruction printable name.
    const char* name;
 
-   // Instruction execution function.
-   void (*pFn)(void);
+   // Instruction execution function; one instantiation per debug hook
+   // policy, indexed by the policy's HOOKED value.
+   void (*pFn[2])(void);
 
    // Addressing mode of this particular entry.
    int32_t amode;
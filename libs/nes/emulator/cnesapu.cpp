@@ -14,9 +14,13 @@
 //    You should have received a copy of the GNU General Public License
 //    along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <math.h>
+#include <mutex>
+
 #include "cnesapu.h"
 #include "cnes6502.h"
 #include "cnesppu.h"
+#include "cnescontext.h"
 
 //#define OUTPUT_WAV
 
@@ -233,32 +237,6 @@ CRegisterDatabase* CAPU::m_dbRegisters = dbRegisters;
 CBreakpointEventInfo** CAPU::m_tblBreakpointEvents = tblAPUEvents;
 int32_t                CAPU::m_numBreakpointEvents = NUM_APU_EVENTS;
 
-uint8_t CAPU::m_APUreg [] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-uint8_t CAPU::m_APUregDirty [] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
-bool          CAPU::m_irqEnabled = false;
-bool          CAPU::m_irqAsserted = false;
-CAPUSquare    CAPU::m_square[2];
-CAPUTriangle  CAPU::m_triangle;
-CAPUNoise     CAPU::m_noise;
-CAPUDMC       CAPU::m_dmc;
-
-uint16_t*      CAPU::m_waveBuf = NULL;
-int32_t        CAPU::m_waveBufProduce = 0;
-int32_t        CAPU::m_waveBufConsume = 0;
-
-uint32_t CAPU::m_cycles = 0;
-
-float        CAPU::m_sampleSpacer = 0.0;
-
-int32_t CAPU::m_sampleBufferSize = APU_BUFFER_SIZE;
-
-int32_t CAPU::m_sequencerMode = 0;
-int32_t CAPU::m_newSequencerMode = 0;
-// Cycles to wait before changing sequencer modes...0 or 1 are valid values
-// on a mode-change.
-int32_t CAPU::m_changeModes = -1;
-int32_t CAPU::m_sequenceStep = 0;
-
 // Events that can occur during the APU sequence stepping
 enum
 {
@@ -320,12 +298,103 @@ static uint8_t m_lengthLUT [ 32 ] =
    0x1E
 };
 
-int32_t apuDataAvailable = 0;
+// Mixer lookup tables.  The APU's output is the sum of two non-linear
+// DACs, one shared by the squares and one by the triangle, noise and DMC
+// channels:
+//
+//                            95.88
+//      square_out = -----------------------
+//                          8128
+//                   ----------------- + 100
+//                   square1 + square2
+//
+//                            159.79
+//      tnd_out = ------------------------------
+//                            1
+//                ------------------------ + 100
+//                triangle   noise    dmc
+//                -------- + ----- + -----
+//                  8227     12241   22638
+//
+// The square DAC is indexed by square1+square2.  The other is indexed by
+// 3*triangle+2*noise+dmc, which is within a percent or so of the real
+// thing.  Both are scaled so full output is 32767.
+static int32_t m_squareTable [ 31 ];
+static int32_t m_tndTable [ 203 ];
+
+// Band-limited step kernel.  m_synthKernel[phase] is the share of a step
+// that happens phase/APU_SYNTH_PHASES of the way between two output samples
+// given to each of the APU_SYNTH_WIDTH output samples it is spread over.
+// Each phase sums to exactly 1<<APU_SYNTH_SHIFT so steps never leave the
+// output level off.
+static int32_t m_synthKernel [ APU_SYNTH_PHASES ][ APU_SYNTH_WIDTH ];
+
+void CAPU::BUILDSYNTHTABLES ( void )
+{
+   int32_t idx;
+   int32_t phase;
+   int32_t tap;
+   int32_t sum;
+   int32_t peak;
+   double  kernel [ APU_SYNTH_WIDTH ];
+   double  total;
+   double  t;
+   double  w;
+
+   m_squareTable[0] = 0;
+   for ( idx = 1; idx < 31; idx++ )
+   {
+      m_squareTable[idx] = (int32_t)(32767.0*95.52/((8128.0/idx)+100.0));
+   }
+   m_tndTable[0] = 0;
+   for ( idx = 1; idx < 203; idx++ )
+   {
+      m_tndTable[idx] = (int32_t)(32767.0*163.67/((24329.0/idx)+100.0));
+   }
 
-static CAPU __init __attribute__((unused));
+   // Blackman-windowed sinc low-pass with its cutoff a little below the
+   // output Nyquist frequency, centred APU_SYNTH_WIDTH/2 samples late.
+   for ( phase = 0; phase < APU_SYNTH_PHASES; phase++ )
+   {
+      total = 0.0;
+      for ( tap = 0; tap < APU_SYNTH_WIDTH; tap++ )
+      {
+         t = tap-(APU_SYNTH_WIDTH/2)+1-((double)phase/APU_SYNTH_PHASES);
+         w = 0.42+(0.5*cos((2.0*M_PI*t)/APU_SYNTH_WIDTH))+(0.08*cos((4.0*M_PI*t)/APU_SYNTH_WIDTH));
+         if ( t == 0.0 )
+         {
+            kernel[tap] = w;
+         }
+         else
+         {
+            kernel[tap] = w*sin(M_PI*0.9*t)/(M_PI*0.9*t);
+         }
+         total += kernel[tap];
+      }
 
-CAPU::CAPU()
+      sum = 0;
+      peak = 0;
+      for ( tap = 0; tap < APU_SYNTH_WIDTH; tap++ )
+      {
+         m_synthKernel[phase][tap] = (int32_t)floor(((kernel[tap]/total)*(1<<APU_SYNTH_SHIFT))+0.5);
+         sum += m_synthKernel[phase][tap];
+         if ( kernel[tap] > kernel[peak] )
+         {
+            peak = tap;
+         }
+      }
+      m_synthKernel[phase][peak] += (1<<APU_SYNTH_SHIFT)-sum;
+   }
+}
+
+CAPU::State::State ()
 {
+   // The tables are shared by every context and built by whichever
+   // context comes first, on whatever thread that is.
+   static std::once_flag synthTablesBuilt;
+
+   std::call_once ( synthTablesBuilt, BUILDSYNTHTABLES );
+
    m_square[0].SetChannel ( 0 );
    m_square[1].SetChannel ( 1 );
    m_triangle.SetChannel ( 2 );
@@ -338,163 +407,256 @@ CAPU::CAPU()
    m_noise.MUTE(false);
    m_dmc.MUTE(false);
 
+   m_square[0].DACAVERAGING(false);
+   m_square[1].DACAVERAGING(false);
+   m_triangle.DACAVERAGING(false);
+   m_noise.DACAVERAGING(false);
+   m_dmc.DACAVERAGING(false);
+
    m_waveBuf = new uint16_t [ APU_BUFFER_SIZE ];
    memset( m_waveBuf, 0, APU_BUFFER_SIZE * sizeof m_waveBuf[ 0 ] );
+   m_playBuf = new uint16_t [ APU_BUFFER_SIZE ];
+   memset( m_playBuf, 0, APU_BUFFER_SIZE * sizeof m_playBuf[ 0 ] );
 }
 
-uint8_t* CAPU::PLAY ( uint16_t samples )
+CAPU::State::~State ()
 {
-   uint16_t* waveBuf;
-   
-   m_sampleBufferSize = samples*NUM_APU_BUFS;
+   delete [] m_waveBuf;
+   delete [] m_playBuf;
+}
 
-   waveBuf = m_waveBuf + m_waveBufConsume;
+int32_t CAPU::READ ( int16_t* buffer, int32_t samples )
+{
+   uint32_t produce = STATE()->m_waveBufProduce.load(std::memory_order_acquire);
+   uint32_t consume = CONSUMEINDEX();
+   int32_t  available = produce-consume;
+   int32_t  latency = STATE()->m_latency.load(std::memory_order_relaxed);
+   int32_t  fillAverage;
+   int32_t  count;
+   int32_t  first;
+   int32_t  pad;
+   int32_t  rateAdjust;
+   int16_t  last;
 
-   m_waveBufConsume += samples;
-   m_waveBufConsume %= m_sampleBufferSize;
+   if ( samples <= 0 )
+   {
+      return 0;
+   }
 
-   apuDataAvailable -= samples;
+   count = available;
+   if ( count > samples )
+   {
+      count = samples;
+   }
 
-   return (uint8_t*)waveBuf;
-}
+   // Copy out in at most two pieces, either side of the end of the ring.
+   first = APU_BUFFER_SIZE-(consume&APU_BUFFER_MASK);
+   if ( first > count )
+   {
+      first = count;
+   }
+   memcpy(buffer,STATE()->m_waveBuf+(consume&APU_BUFFER_MASK),first*sizeof(int16_t));
+   memcpy(buffer+first,STATE()->m_waveBuf,(count-first)*sizeof(int16_t));
 
-uint16_t CAPU::AMPLITUDE ( void )
-{
-   float famp;
-   int16_t amp;
-   int16_t delta;
-   int16_t out[100] = { 0, };
-   static int16_t outLast = 0;
-   uint8_t sample;
-   uint8_t* sq1dacSamples = m_square[0].GETDACSAMPLES();
-   uint8_t* sq2dacSamples = m_square[1].GETDACSAMPLES();
-   uint8_t* triangleDacSamples = m_triangle.GETDACSAMPLES();
-   uint8_t* noiseDacSamples = m_noise.GETDACSAMPLES();
-   uint8_t* dmcDacSamples = m_dmc.GETDACSAMPLES();
-   static int32_t outDownsampled = 0;
-
-   for ( sample = 0; sample < m_square[0].GETDACSAMPLECOUNT(); sample++ )
-   {
-//      output = square_out + tnd_out
-//
-//
-//                            95.88
-//      square_out = -----------------------
-//                          8128
-//                   ----------------- + 100
-//                   square1 + square2
-//
-//
-//                            159.79
-//      tnd_out = ------------------------------
-//                            1
-//                ------------------------ + 100
-//                triangle   noise    dmc
-//                -------- + ----- + -----
-//                  8227     12241   22638
-      famp = 0.0;
-      if ( (*(sq1dacSamples+sample))+(*(sq2dacSamples+sample)) )
+   // A flush while we were copying is picked up by the next READ.
+   STATE()->m_waveBufConsume.store(consume+count,std::memory_order_release);
+
+   if ( count )
+   {
+      STATE()->m_lastSample = buffer[count-1];
+   }
+   if ( count < samples )
+   {
+      // Only count it as an underrun if the emulator is producing samples.
+      // When it is paused the ring is expected to be empty.
+      if ( produce != STATE()->m_lastProduce )
       {
-         famp = (95.88/((8128.0/((*(sq1dacSamples+sample))+(*(sq2dacSamples+sample))))+100.0));
+         STATE()->m_underruns.fetch_add(1,std::memory_order_relaxed);
       }
-      if ( (*(triangleDacSamples+sample))+(*(noiseDacSamples+sample))+(*(dmcDacSamples+sample)) )
+
+      // Fade the last sample out instead of dropping straight to silence,
+      // which would click.
+      for ( pad = count; pad < samples; pad++ )
       {
-         famp += (159.79/((1.0/((((*(triangleDacSamples+sample))/8227.0)+((*(noiseDacSamples+sample))/12241.0)+((*(dmcDacSamples+sample))/22638.0))))+100.0));
+         last = STATE()->m_lastSample;
+         last -= (last/256)+(last>0)-(last<0);
+         STATE()->m_lastSample = last;
+         buffer[pad] = last;
       }
-      amp = (int16_t)(float)(65535.0*famp*0.50);
+   }
+   STATE()->m_lastProduce = produce;
 
-      (*(out+sample)) = amp;
+   // Track the fill level seen at each read and, if there is a target,
+   // adjust the output sample rate in proportion to how far from it the
+   // average is.
+   fillAverage = STATE()->m_fillAverage.load(std::memory_order_relaxed);
+   fillAverage += ((available<<4)-fillAverage)>>3;
+   STATE()->m_fillAverage.store(fillAverage,std::memory_order_relaxed);
+   if ( latency )
+   {
+      rateAdjust = (int32_t)(((int64_t)((latency<<4)-fillAverage)*APU_RATE_ADJUST_MAX)/(latency<<4));
+      if ( rateAdjust > APU_RATE_ADJUST_MAX )
+      {
+         rateAdjust = APU_RATE_ADJUST_MAX;
+      }
+      else if ( rateAdjust < -APU_RATE_ADJUST_MAX )
+      {
+         rateAdjust = -APU_RATE_ADJUST_MAX;
+      }
+      STATE()->m_rateAdjust.store(rateAdjust,std::memory_order_relaxed);
+   }
+
+   return count;
+}
+
+uint8_t* CAPU::PLAY ( uint16_t samples )
+{
+   READ ( (int16_t*)STATE()->m_playBuf, samples );
+
+   return (uint8_t*)STATE()->m_playBuf;
+}
+
+void CAPU::LATENCY ( int32_t samples )
+{
+   if ( samples < 0 )
+   {
+      samples = 0;
+   }
+   else if ( samples > APU_BUFFER_SIZE/2 )
+   {
+      samples = APU_BUFFER_SIZE/2;
+   }
+   STATE()->m_latency.store(samples,std::memory_order_relaxed);
+   STATE()->m_rateAdjust.store(0,std::memory_order_relaxed);
+   STATE()->m_fillAverage.store(samples<<4,std::memory_order_relaxed);
+}
 
-      outDownsampled += (*(out+sample));
+void CAPU::INFORMATION ( nesAudioInfo* pInfo )
+{
+   pInfo->bufferSize = APU_BUFFER_SIZE;
+   pInfo->fill = SAMPLESAVAILABLE();
+   pInfo->fillAverage = STATE()->m_fillAverage.load(std::memory_order_relaxed)>>4;
+   pInfo->latency = STATE()->m_latency.load(std::memory_order_relaxed);
+   pInfo->rateAdjust = STATE()->m_rateAdjust.load(std::memory_order_relaxed);
+   pInfo->underruns = STATE()->m_underruns.load(std::memory_order_relaxed);
+   pInfo->overruns = STATE()->m_overruns.load(std::memory_order_relaxed);
+}
+
+void CAPU::SYNTHESIZE ( int32_t delta, int32_t phase )
+{
+   int64_t* synthBuf = STATE()->m_synthBuf;
+   int32_t* kernel = m_synthKernel[phase];
+   int32_t  pos = STATE()->m_synthPos;
+   int32_t  tap;
+
+   for ( tap = 0; tap < APU_SYNTH_WIDTH; tap++ )
+   {
+      synthBuf[(pos+tap)&(APU_SYNTH_WIDTH-1)] += (int64_t)delta*kernel[tap];
    }
+}
 
-   outDownsampled = (int32_t)((float)outDownsampled/((float)m_square[0].GETDACSAMPLECOUNT()));
+uint16_t CAPU::AMPLITUDE ( void )
+{
+   int32_t pos = STATE()->m_synthPos;
+   int32_t in;
+   int32_t out;
 
-   // Add mapper audio if any.
-   outDownsampled += MAPPERFUNC->amplitude();
+   // Integrate the steps due at this sample back into an output level.
+   STATE()->m_synthSum += STATE()->m_synthBuf[pos];
+   STATE()->m_synthBuf[pos] = 0;
+   STATE()->m_synthPos = (pos+1)&(APU_SYNTH_WIDTH-1);
 
-   delta = outDownsampled - outLast;
-   outDownsampled = outLast+((delta*65371)/65536); // 65371/65536 is 0.9975 adjusted to 16-bit fixed point.
+   in = (int32_t)(STATE()->m_synthSum>>APU_SYNTH_SHIFT);
 
-   outLast = outDownsampled;
+   // Add mapper audio if any.
+   in += MAPPERFUNC->amplitude();
+
+   // Take out the DC level; the DACs only ever output positive levels.
+   // The pole is at 1-1/512, a corner of about 14Hz at 44.1kHz.
+   STATE()->m_highPassOut += ((in-STATE()->m_highPassIn)<<8)-(STATE()->m_highPassOut>>9);
+   STATE()->m_highPassIn = in;
 
-   // Reset DAC averaging...
-   m_square[0].CLEARDACAVG();
-   m_square[1].CLEARDACAVG();
-   m_triangle.CLEARDACAVG();
-   m_noise.CLEARDACAVG();
-   m_dmc.CLEARDACAVG();
+   out = STATE()->m_highPassOut>>8;
+   if ( out > 32767 )
+   {
+      out = 32767;
+   }
+   else if ( out < -32768 )
+   {
+      out = -32768;
+   }
 
-   return outDownsampled;
+   return (uint16_t)(int16_t)out;
 }
 
+template <class HOOKS>
 void CAPU::SEQTICK ( int32_t sequence )
 {
    bool clockedLengthCounter = false;
    bool clockedLinearCounter = false;
 
-   if ( m_sequencerMode )
+   if ( STATE()->m_sequencerMode )
    {
       if ( m_seq5[sequence]&APU_SEQ_CLK_ENVELOPE_CTR )
       {
-         m_square[0].CLKENVELOPE ();
-         m_square[1].CLKENVELOPE ();
-         clockedLinearCounter |= m_triangle.CLKLINEARCOUNTER ();
-         m_noise.CLKENVELOPE ();
+         STATE()->m_square[0].CLKENVELOPE ();
+         STATE()->m_square[1].CLKENVELOPE ();
+         clockedLinearCounter |= STATE()->m_triangle.CLKLINEARCOUNTER ();
+         STATE()->m_noise.CLKENVELOPE ();
       }
 
       if ( m_seq5[sequence]&APU_SEQ_CLK_LENGTH_CTR )
       {
-         m_square[0].CLKSWEEPUNIT ();
-         clockedLengthCounter |= m_square[0].CLKLENGTHCOUNTER ();
-         m_square[1].CLKSWEEPUNIT ();
-         clockedLengthCounter |= m_square[1].CLKLENGTHCOUNTER ();
-         clockedLengthCounter |= m_triangle.CLKLENGTHCOUNTER ();
-         clockedLengthCounter |= m_noise.CLKLENGTHCOUNTER ();
+         STATE()->m_square[0].CLKSWEEPUNIT ();
+         clockedLengthCounter |= STATE()->m_square[0].CLKLENGTHCOUNTER ();
+         STATE()->m_square[1].CLKSWEEPUNIT ();
+         clockedLengthCounter |= STATE()->m_square[1].CLKLENGTHCOUNTER ();
+         clockedLengthCounter |= STATE()->m_triangle.CLKLENGTHCOUNTER ();
+         clockedLengthCounter |= STATE()->m_noise.CLKLENGTHCOUNTER ();
       }
    }
    else
    {
       if ( m_seq4[sequence]&APU_SEQ_CLK_ENVELOPE_CTR )
       {
-         m_square[0].CLKENVELOPE ();
-         m_square[1].CLKENVELOPE ();
-         clockedLinearCounter |= m_triangle.CLKLINEARCOUNTER ();
-         m_noise.CLKENVELOPE ();
+         STATE()->m_square[0].CLKENVELOPE ();
+         STATE()->m_square[1].CLKENVELOPE ();
+         clockedLinearCounter |= STATE()->m_triangle.CLKLINEARCOUNTER ();
+         STATE()->m_noise.CLKENVELOPE ();
       }
 
       if ( m_seq4[sequence]&APU_SEQ_CLK_LENGTH_CTR )
       {
-         m_square[0].CLKSWEEPUNIT ();
-         clockedLengthCounter |= m_square[0].CLKLENGTHCOUNTER ();
-         m_square[1].CLKSWEEPUNIT ();
-         clockedLengthCounter |= m_square[1].CLKLENGTHCOUNTER ();
-         clockedLengthCounter |= m_triangle.CLKLENGTHCOUNTER ();
-         clockedLengthCounter |= m_noise.CLKLENGTHCOUNTER ();
+         STATE()->m_square[0].CLKSWEEPUNIT ();
+         clockedLengthCounter |= STATE()->m_square[0].CLKLENGTHCOUNTER ();
+         STATE()->m_square[1].CLKSWEEPUNIT ();
+         clockedLengthCounter |= STATE()->m_square[1].CLKLENGTHCOUNTER ();
+         clockedLengthCounter |= STATE()->m_triangle.CLKLENGTHCOUNTER ();
+         clockedLengthCounter |= STATE()->m_noise.CLKLENGTHCOUNTER ();
       }
 
       if ( m_seq4[sequence]&APU_SEQ_INT_FLAG )
       {
-         if ( m_irqEnabled )
+         if ( STATE()->m_irqEnabled )
          {
-            m_irqAsserted = true;
+            STATE()->m_irqAsserted = true;
             C6502::ASSERTIRQ ( eNESSource_APU );
 
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Check for IRQ breakpoint...
-               CNES::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,0,APU_EVENT_IRQ);
+               HOOKS::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,0,APU_EVENT_IRQ);
             }
          }
       }
    }
 
    // Check for Length Counter clocking breakpoint...
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       if ( clockedLengthCounter )
       {
-         CNES::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,0,APU_EVENT_LENGTH_COUNTER_CLOCKED);
+         HOOKS::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,0,APU_EVENT_LENGTH_COUNTER_CLOCKED);
       }
    }
 }
@@ -532,49 +694,127 @@ void CAPU::RESET ( void )
 
    for ( idx = 0; idx < 32; idx++ )
    {
-      m_APUreg [ idx ] = 0x00;
-      m_APUregDirty [ idx ] = 1;
+      STATE()->m_APUreg [ idx ] = 0x00;
+      STATE()->m_APUregDirty [ idx ] = 1;
    }
 
-   m_square[0].RESET ();
-   m_square[1].RESET ();
-   m_triangle.RESET ();
-   m_noise.RESET ();
-   m_dmc.RESET ();
-
-   // Reset DAC averaging...
-   m_square[0].CLEARDACAVG();
-   m_square[1].CLEARDACAVG();
-   m_triangle.CLEARDACAVG();
-   m_noise.CLEARDACAVG();
-   m_dmc.CLEARDACAVG();
+   STATE()->m_square[0].RESET ();
+   STATE()->m_square[1].RESET ();
+   STATE()->m_triangle.RESET ();
+   STATE()->m_noise.RESET ();
+   STATE()->m_dmc.RESET ();
 
-   m_irqEnabled = true;
-   m_irqAsserted = false;
+   STATE()->m_irqEnabled = true;
+   STATE()->m_irqAsserted = false;
    C6502::RELEASEIRQ ( eNESSource_APU );
-   m_sequencerMode = 0;
-   m_sequenceStep = 0;
+   STATE()->m_sequencerMode = 0;
+   STATE()->m_sequenceStep = 0;
 
-   m_waveBufProduce = 0;
-   m_waveBufConsume = 0;
+   // The audio thread may be reading the ring, so rather than rewinding
+   // it just drop whatever hasn't been played yet.
+   CLEARSAMPLESAVAILABLE();
 
-   memset( m_waveBuf, 0, APU_BUFFER_SIZE * sizeof m_waveBuf[ 0 ] );
+   SAMPLERATE ( STATE()->m_sampleRate );
+
+   STATE()->m_synthAmp = 0;
+   memset( STATE()->m_synthBuf, 0, sizeof(STATE()->m_synthBuf) );
+   STATE()->m_synthPos = 0;
+   STATE()->m_synthSum = 0;
+   STATE()->m_highPassIn = 0;
+   STATE()->m_highPassOut = 0;
+
+   STATE()->m_cycles = 0;
+}
+
+void CAPU::SAMPLERATE ( int32_t rate )
+{
+   if ( rate <= 0 )
+   {
+      rate = SDL_SAMPLE_RATE;
+   }
+   STATE()->m_sampleRate = rate;
 
    if ( CNES::VIDEOMODE() == MODE_NTSC )
    {
-      m_sampleSpacer = APU_SAMPLE_SPACE_NTSC;
+      STATE()->m_sampleSpacer = APU_SAMPLE_SPACE_NTSC;
    }
    else if ( CNES::VIDEOMODE() == MODE_DENDY )
    {
-      m_sampleSpacer = APU_SAMPLE_SPACE_DENDY;
+      STATE()->m_sampleSpacer = APU_SAMPLE_SPACE_DENDY;
    }
    else
    {
-      m_sampleSpacer = APU_SAMPLE_SPACE_PAL;
+      STATE()->m_sampleSpacer = APU_SAMPLE_SPACE_PAL;
+   }
+
+   // The sample spacings are in CPU cycles per SDL_SAMPLE_RATE sample.
+   if ( rate != SDL_SAMPLE_RATE )
+   {
+      STATE()->m_sampleSpacer = (STATE()->m_sampleSpacer*SDL_SAMPLE_RATE)/rate;
+   }
+}
+
+template <class STREAM>
+void CAPU::STATEDATA ( STREAM& stream )
+{
+   stream.BYTES ( STATE()->m_APUreg, sizeof(STATE()->m_APUreg) );
+   stream.BYTES ( STATE()->m_APUregDirty, sizeof(STATE()->m_APUregDirty) );
+   stream.VALUE ( STATE()->m_irqEnabled );
+   stream.VALUE ( STATE()->m_irqAsserted );
+   stream.VALUE ( STATE()->m_sequencerMode );
+   stream.VALUE ( STATE()->m_newSequencerMode );
+   stream.VALUE ( STATE()->m_changeModes );
+   stream.VALUE ( STATE()->m_sequenceStep );
+   stream.VALUE ( STATE()->m_cycles );
+   stream.VALUE ( STATE()->m_sampleSpacer );
+   stream.VALUE ( STATE()->m_takeSample );
+   stream.VALUE ( STATE()->m_synthAmp );
+   stream.BYTES ( STATE()->m_synthBuf, sizeof(STATE()->m_synthBuf) );
+   stream.VALUE ( STATE()->m_synthPos );
+   stream.VALUE ( STATE()->m_synthSum );
+   stream.VALUE ( STATE()->m_highPassIn );
+   stream.VALUE ( STATE()->m_highPassOut );
+
+   // The channels have no pointers the emulation uses so they are
+   // saved whole.
+   stream.BYTES ( &STATE()->m_square[0], sizeof(CAPUSquare) );
+   stream.BYTES ( &STATE()->m_square[1], sizeof(CAPUSquare) );
+   stream.BYTES ( &STATE()->m_triangle, sizeof(CAPUTriangle) );
+   stream.BYTES ( &STATE()->m_noise, sizeof(CAPUNoise) );
+   stream.BYTES ( &STATE()->m_dmc, sizeof(CAPUDMC) );
+}
+
+void CAPU::SAVESTATE ( CNESStateWriter& writer )
+{
+   // The wave buffer belongs to the audio output, not the NES, and is
+   // not saved.
+   writer.BEGIN ( "APU ", 2 );
+   STATEDATA ( writer );
+   writer.END ();
+}
+
+bool CAPU::LOADSTATE ( CNESStateReader& reader )
+{
+   uint16_t version;
+   uint8_t  muted = MUTED();
+
+   if ( (!reader.FIND("APU ",&version)) || (version != 2) )
+   {
+      return false;
    }
+   STATEDATA ( reader );
+
+   // The output sample rate is a UI setting too.
+   SAMPLERATE ( STATE()->m_sampleRate );
+
+   // Channel muting is a UI setting; keep what the user has now.
+   STATE()->m_square[0].MUTE(!(muted&0x01));
+   STATE()->m_square[1].MUTE(!(muted&0x02));
+   STATE()->m_triangle.MUTE(!(muted&0x04));
+   STATE()->m_noise.MUTE(!(muted&0x08));
+   STATE()->m_dmc.MUTE(!(muted&0x10));
 
-   m_cycles = 0;
-   apuDataAvailable = 0;
+   return reader.GOOD();
 }
 
 CAPUOscillator::CAPUOscillator (uint8_t periodAdjust) :
@@ -606,6 +846,8 @@ CAPUOscillator::CAPUOscillator (uint8_t periodAdjust) :
    m_sweepEnabled = false;
    m_linearCounterHalted = false;
    m_dac = 0x00;
+   m_dacSamples = 0;
+   m_dacAveraging = true;
    m_reg1Wrote = false;
    m_reg3Wrote = false;
 
@@ -911,7 +1153,6 @@ void CAPUSquare::APU ( uint32_t addr, uint8_t data )
 void CAPUSquare::TIMERTICK ( void )
 {
    uint32_t clockIt = CLKDIVIDER ();
-   uint32_t seqTicks;
 
    // divide timer by 2...
    m_seqTick -= clockIt;
@@ -1438,10 +1679,18 @@ void CAPUDMC::TIMERTICK ( void )
    }
 }
 
+template <class HOOKS>
 void CAPU::EMULATE ( void )
 {
-   static float takeSample = 0.0f;
-   uint16_t* pWaveBuf;
+   float& takeSample = STATE()->m_takeSample;
+   float sampleSpacer;
+   int32_t rateAdjust;
+   int32_t amp;
+   int32_t phase;
+   uint32_t produce;
+   uint32_t fill;
+   int32_t latency;
+   uint16_t sample;
 
    // Handle APU clock jitter.  Mode changes occur
    // only on even APU clocks.  On a mode change write
@@ -1449,24 +1698,24 @@ void CAPU::EMULATE ( void )
    // 1 indicating that the mode change should happen
    // in 0 or 1 clocks from now.  Do the mode change
    // when m_changeModes is 0; decrement it if it isn't 0.
-   if ( m_changeModes == 0 )
+   if ( STATE()->m_changeModes == 0 )
    {
       // Do mode-change now...
-      m_changeModes--;
-      m_sequencerMode = m_newSequencerMode;
-      m_sequenceStep = 0;
+      STATE()->m_changeModes--;
+      STATE()->m_sequencerMode = STATE()->m_newSequencerMode;
+      STATE()->m_sequenceStep = 0;
       RESETCYCLECOUNTER(0);
 
-      if ( nesIsDebuggable() )
+      if ( HOOKS::ENABLED() )
       {
          // Emit frame-start indication to Tracer...
          CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_StartAPUFrame, eNESSource_APU, 0, 0, 0 );
       }
    }
 
-   if ( m_changeModes > 0 )
+   if ( STATE()->m_changeModes > 0 )
    {
-      m_changeModes--;
+      STATE()->m_changeModes--;
    }
 
    // Clock the 240Hz sequencer.
@@ -1474,51 +1723,51 @@ void CAPU::EMULATE ( void )
    if ( (CNES::VIDEOMODE() == MODE_NTSC) || (CNES::VIDEOMODE() == MODE_DENDY) )
    {
       // APU sequencer mode 1
-      if ( m_sequencerMode )
+      if ( STATE()->m_sequencerMode )
       {
-         if ( m_cycles == 1 )
+         if ( STATE()->m_cycles == 1 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 0 );
+            SEQTICK<HOOKS> ( 0 );
          }
-         else if ( m_cycles == 7459 )
+         else if ( STATE()->m_cycles == 7459 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 1 );
+            SEQTICK<HOOKS> ( 1 );
          }
-         else if ( m_cycles == 14915 )
+         else if ( STATE()->m_cycles == 14915 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 2 );
+            SEQTICK<HOOKS> ( 2 );
          }
-         else if ( m_cycles == 22373 )
+         else if ( STATE()->m_cycles == 22373 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 3 );
+            SEQTICK<HOOKS> ( 3 );
          }
-         else if ( m_cycles == 29829 )
+         else if ( STATE()->m_cycles == 29829 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
@@ -1530,61 +1779,61 @@ void CAPU::EMULATE ( void )
       // APU sequencer mode 0
       else
       {
-         if ( m_cycles == 7459 )
+         if ( STATE()->m_cycles == 7459 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 0 );
+            SEQTICK<HOOKS> ( 0 );
          }
-         else if ( m_cycles == 14915 )
+         else if ( STATE()->m_cycles == 14915 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 1 );
+            SEQTICK<HOOKS> ( 1 );
          }
-         else if ( m_cycles == 22373 )
+         else if ( STATE()->m_cycles == 22373 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 2 );
+            SEQTICK<HOOKS> ( 2 );
          }
-         else if ( (m_cycles == 29830) ||
-                   (m_cycles == 29832) )
+         else if ( (STATE()->m_cycles == 29830) ||
+                   (STATE()->m_cycles == 29832) )
          {
-            if ( m_irqEnabled )
+            if ( STATE()->m_irqEnabled )
             {
-               m_irqAsserted = true;
+               STATE()->m_irqAsserted = true;
                C6502::ASSERTIRQ(eNESSource_APU);
 
-               if ( nesIsDebuggable() )
+               if ( HOOKS::ENABLED() )
                {
                   // Check for IRQ breakpoint...
-                  CNES::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,0,APU_EVENT_IRQ);
+                  HOOKS::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,0,APU_EVENT_IRQ);
                }
             }
          }
-         else if ( m_cycles == 29831 )
+         else if ( STATE()->m_cycles == 29831 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
             // IRQ asserted inside SEQTICK...
-            SEQTICK ( 3 );
+            SEQTICK<HOOKS> ( 3 );
          }
       }
    }
@@ -1592,51 +1841,51 @@ void CAPU::EMULATE ( void )
    else
    {
       // APU sequencer mode 1
-      if ( m_sequencerMode )
+      if ( STATE()->m_sequencerMode )
       {
-         if ( m_cycles == 1 )
+         if ( STATE()->m_cycles == 1 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 0 );
+            SEQTICK<HOOKS> ( 0 );
          }
-         else if ( m_cycles == 8315 )
+         else if ( STATE()->m_cycles == 8315 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 1 );
+            SEQTICK<HOOKS> ( 1 );
          }
-         else if ( m_cycles == 16629 )
+         else if ( STATE()->m_cycles == 16629 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 2 );
+            SEQTICK<HOOKS> ( 2 );
          }
-         else if ( m_cycles == 24941 )
+         else if ( STATE()->m_cycles == 24941 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 3 );
+            SEQTICK<HOOKS> ( 3 );
          }
-         else if ( m_cycles == 33255 )
+         else if ( STATE()->m_cycles == 33255 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
@@ -1648,81 +1897,103 @@ void CAPU::EMULATE ( void )
       // APU sequencer mode 0
       else
       {
-         if ( m_cycles == 8315 )
+         if ( STATE()->m_cycles == 8315 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 0 );
+            SEQTICK<HOOKS> ( 0 );
          }
-         else if ( m_cycles == 16629 )
+         else if ( STATE()->m_cycles == 16629 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 1 );
+            SEQTICK<HOOKS> ( 1 );
          }
-         else if ( m_cycles == 24941 )
+         else if ( STATE()->m_cycles == 24941 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
-            SEQTICK ( 2 );
+            SEQTICK<HOOKS> ( 2 );
          }
-         else if ( (m_cycles == 33254) ||
-                   (m_cycles == 33256) )
+         else if ( (STATE()->m_cycles == 33254) ||
+                   (STATE()->m_cycles == 33256) )
          {
-            if ( m_irqEnabled )
+            if ( STATE()->m_irqEnabled )
             {
-               m_irqAsserted = true;
+               STATE()->m_irqAsserted = true;
                C6502::ASSERTIRQ(eNESSource_APU);
 
-               if ( nesIsDebuggable() )
+               if ( HOOKS::ENABLED() )
                {
                   // Check for IRQ breakpoint...
-                  CNES::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,0,APU_EVENT_IRQ);
+                  HOOKS::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,0,APU_EVENT_IRQ);
                }
             }
          }
-         else if ( m_cycles == 33255 )
+         else if ( STATE()->m_cycles == 33255 )
          {
-            if ( nesIsDebuggable() )
+            if ( HOOKS::ENABLED() )
             {
                // Emit frame-end indication to Tracer...
                CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_SequencerStep, eNESSource_APU, 0, 0, 0 );
             }
 
             // IRQ asserted inside SEQTICK...
-            SEQTICK ( 3 );
+            SEQTICK<HOOKS> ( 3 );
          }
       }
    }
 
    // Clock the individual channels.
-   m_square[0].TIMERTICK ();
-   m_square[1].TIMERTICK ();
-   m_triangle.TIMERTICK ();
-   m_noise.TIMERTICK ();
-   m_dmc.TIMERTICK ();
+   STATE()->m_square[0].TIMERTICK ();
+   STATE()->m_square[1].TIMERTICK ();
+   STATE()->m_triangle.TIMERTICK ();
+   STATE()->m_noise.TIMERTICK ();
+   STATE()->m_dmc.TIMERTICK ();
+
+   sampleSpacer = STATE()->m_sampleSpacer;
+   rateAdjust = STATE()->m_rateAdjust.load(std::memory_order_relaxed);
+   if ( rateAdjust )
+   {
+      sampleSpacer -= (sampleSpacer*rateAdjust)/1000000.0f;
+   }
+
+   // Mix the channels.  Only a change in the mix costs anything more; it
+   // goes into the output as a band-limited step at this cycle's position
+   // between output samples.
+   amp = m_squareTable[STATE()->m_square[0].GETDAC()+STATE()->m_square[1].GETDAC()]+
+         m_tndTable[(3*STATE()->m_triangle.GETDAC())+(2*STATE()->m_noise.GETDAC())+STATE()->m_dmc.GETDAC()];
+   if ( amp != STATE()->m_synthAmp )
+   {
+      phase = (int32_t)((takeSample*APU_SYNTH_PHASES)/sampleSpacer);
+      if ( phase >= APU_SYNTH_PHASES )
+      {
+         phase = APU_SYNTH_PHASES-1;
+      }
+      SYNTHESIZE ( amp-STATE()->m_synthAmp, phase );
+      STATE()->m_synthAmp = amp;
+   }
 
    // Generate audio samples.
    takeSample += 1.0;
 
-   if ( takeSample >= m_sampleSpacer )
+   if ( takeSample >= sampleSpacer )
    {
-      takeSample -= m_sampleSpacer;
+      takeSample -= sampleSpacer;
 
-      pWaveBuf = m_waveBuf+m_waveBufProduce;
-      (*pWaveBuf) = AMPLITUDE ();
+      sample = AMPLITUDE ();
 
 #if defined ( OUTPUT_WAV )
 if ( wavOut )
@@ -1734,7 +2005,7 @@ if ( wavOut )
 //   fwrite(&t,1,1,wavOut);
 //   fwrite(&n,1,1,wavOut);
 //   fwrite(&d,1,1,wavOut);
-   fwrite(&(*pWaveBuf),1,2,wavOut);
+   fwrite(&sample,1,2,wavOut);
    wavFileSize += 2;
    if ( wavFileSize == 88200*200 )
    {
@@ -1744,24 +2015,35 @@ if ( wavOut )
 }
 #endif
 
-      m_waveBufProduce++;
-
-      m_waveBufProduce %= m_sampleBufferSize;
-
-      apuDataAvailable++;
+      // Measured from the consumer's own index, not the last flush: the
+      // consumer may still be copying flushed samples out.
+      produce = STATE()->m_waveBufProduce.load(std::memory_order_relaxed);
+      fill = produce-STATE()->m_waveBufConsume.load(std::memory_order_acquire);
+      if ( fill < APU_BUFFER_SIZE )
+      {
+         STATE()->m_waveBuf[produce&APU_BUFFER_MASK] = sample;
+         STATE()->m_waveBufProduce.store(produce+1,std::memory_order_release);
+         fill++;
+      }
+      else
+      {
+         // Nobody is playing the samples; drop this one.
+         STATE()->m_overruns.fetch_add(1,std::memory_order_relaxed);
+      }
 
-      if ( apuDataAvailable >= APU_BUFFER_PRERENDER )
+      latency = STATE()->m_latency.load(std::memory_order_relaxed);
+      if ( fill >= (uint32_t)(latency?latency:APU_BUFFER_PRERENDER) )
       {
          nesBreakAudio();
       }
    }
 
    // Go to next cycle and restart if necessary...
-   m_cycles++;
+   STATE()->m_cycles++;
 
    if ( (CNES::VIDEOMODE() == MODE_NTSC) || (CNES::VIDEOMODE() == MODE_DENDY) )
    {
-      if ( (m_sequencerMode) && (m_cycles >= 37283) )
+      if ( (STATE()->m_sequencerMode) && (STATE()->m_cycles >= 37283) )
       {
          if ( nesIsDebuggable() )
          {
@@ -1777,7 +2059,7 @@ if ( wavOut )
             CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_StartAPUFrame, eNESSource_APU, 0, 0, 0 );
          }
       }
-      else if ( (!m_sequencerMode) && (m_cycles >= 37289) )
+      else if ( (!STATE()->m_sequencerMode) && (STATE()->m_cycles >= 37289) )
       {
          if ( nesIsDebuggable() )
          {
@@ -1796,7 +2078,7 @@ if ( wavOut )
    }
    else // MODE_PAL
    {
-      if ( (m_sequencerMode) && (m_cycles >= 41567) )
+      if ( (STATE()->m_sequencerMode) && (STATE()->m_cycles >= 41567) )
       {
          if ( nesIsDebuggable() )
          {
@@ -1812,7 +2094,7 @@ if ( wavOut )
             CNES::TRACER()->AddSample ( CAPU::CYCLES(), eTracer_StartAPUFrame, eNESSource_APU, 0, 0, 0 );
          }
       }
-      else if ( (!m_sequencerMode) && (m_cycles >= 41569) )
+      else if ( (!STATE()->m_sequencerMode) && (STATE()->m_cycles >= 41569) )
       {
          if ( nesIsDebuggable() )
          {
@@ -1833,7 +2115,7 @@ if ( wavOut )
 
 void CAPU::RELEASEIRQ ( void )
 {
-   if ( (!m_irqAsserted) && (!m_dmc.IRQASSERTED()) )
+   if ( (!STATE()->m_irqAsserted) && (!STATE()->m_dmc.IRQASSERTED()) )
    {
       C6502::RELEASEIRQ ( eNESSource_APU );
    }
@@ -1845,15 +2127,15 @@ uint32_t CAPU::APU ( uint32_t addr )
 
    if ( addr == APUCTRL )
    {
-      data |= (m_square[0].LENGTH()?0x01:0x00);
-      data |= (m_square[1].LENGTH()?0x02:0x00);
-      data |= (m_triangle.LENGTH()?0x04:0x00);
-      data |= (m_noise.LENGTH()?0x08:0x00);
-      data |= (m_dmc.LENGTH()?0x10:0x00);
-      data |= (m_irqAsserted?0x40:0x00);
-      data |= (m_dmc.IRQASSERTED()?0x80:0x00);
+      data |= (STATE()->m_square[0].LENGTH()?0x01:0x00);
+      data |= (STATE()->m_square[1].LENGTH()?0x02:0x00);
+      data |= (STATE()->m_triangle.LENGTH()?0x04:0x00);
+      data |= (STATE()->m_noise.LENGTH()?0x08:0x00);
+      data |= (STATE()->m_dmc.LENGTH()?0x10:0x00);
+      data |= (STATE()->m_irqAsserted?0x40:0x00);
+      data |= (STATE()->m_dmc.IRQASSERTED()?0x80:0x00);
 
-      m_irqAsserted = false;
+      STATE()->m_irqAsserted = false;
       CAPU::RELEASEIRQ ();
 
       if ( nesIsDebuggable() )
@@ -1874,56 +2156,56 @@ uint32_t CAPU::APU ( uint32_t addr )
 void CAPU::APU ( uint32_t addr, uint8_t data )
 {
    // For APU recording...
-   m_APUreg [ addr&0x1F ] = data;
-   m_APUregDirty [ addr&0x1F ] = 1;
+   STATE()->m_APUreg [ addr&0x1F ] = data;
+   STATE()->m_APUregDirty [ addr&0x1F ] = 1;
 
    if ( addr < 0x4004 )
    {
       // Square 1
-      m_square[0].APU ( addr&0x3, data );
+      STATE()->m_square[0].APU ( addr&0x3, data );
    }
    else if ( addr < 0x4008 )
    {
       // Square 2
-      m_square[1].APU ( addr&0x3, data );
+      STATE()->m_square[1].APU ( addr&0x3, data );
    }
    else if ( addr < 0x400C )
    {
       // Triangle
-      m_triangle.APU ( addr&0x3, data );
+      STATE()->m_triangle.APU ( addr&0x3, data );
    }
    else if ( addr < 0x4010 )
    {
       // Noise
-      m_noise.APU ( addr&0x3, data );
+      STATE()->m_noise.APU ( addr&0x3, data );
    }
    else if ( addr < 0x4014 )
    {
       // DMC
-      m_dmc.APU ( addr&0x3, data );
+      STATE()->m_dmc.APU ( addr&0x3, data );
    }
    else if ( addr == APUCTRL )
    {
-      m_square[0].ENABLE ( !!(data&0x01) );
-      m_square[1].ENABLE ( !!(data&0x02) );
-      m_triangle.ENABLE ( !!(data&0x04) );
-      m_noise.ENABLE ( !!(data&0x08) );
-      m_dmc.ENABLE ( !!(data&0x10) );
+      STATE()->m_square[0].ENABLE ( !!(data&0x01) );
+      STATE()->m_square[1].ENABLE ( !!(data&0x02) );
+      STATE()->m_triangle.ENABLE ( !!(data&0x04) );
+      STATE()->m_noise.ENABLE ( !!(data&0x08) );
+      STATE()->m_dmc.ENABLE ( !!(data&0x10) );
    }
    else if ( addr == 0x4017 )
    {
-      m_newSequencerMode = data&0x80;
-      m_irqEnabled = !(data&0x40);
+      STATE()->m_newSequencerMode = data&0x80;
+      STATE()->m_irqEnabled = !(data&0x40);
 
-      if ( !m_irqEnabled )
+      if ( !STATE()->m_irqEnabled )
       {
-         m_irqAsserted = false;
-         m_dmc.IRQASSERTED(false);
+         STATE()->m_irqAsserted = false;
+         STATE()->m_dmc.IRQASSERTED(false);
          CAPU::RELEASEIRQ ();
       }
 
       // Change modes on even cycle...
-      m_changeModes = C6502::_CYCLES()&1;
+      STATE()->m_changeModes = C6502::_CYCLES()&1;
    }
 
    if ( nesIsDebuggable() )
@@ -1932,3 +2214,7 @@ void CAPU::APU ( uint32_t addr, uint8_t data )
    }
 }
 
+
+// APU emulation is driven from the CPU in both debug hook flavors.
+template void CAPU::EMULATE<NESNoDebugHooks> ( void );
+template void CAPU::EMULATE<NESDebugHooks> ( void );
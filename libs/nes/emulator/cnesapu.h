@@ -1,15 +1,31 @@
 #if !defined ( APU_H )
 #define APU_H
 
+#include <atomic>
+
 #include "nes_emulator_core.h"
 
 #include "cregisterdata.h"
 #include "cbreakpointinfo.h"
 
 #include "cnes.h"
+#include "cnesstate.h"
 
 #define NUM_APU_BUFS 16
 #define APU_BUFFER_SIZE (NUM_APU_BUFS*APU_SAMPLES)
+#define APU_BUFFER_MASK (APU_BUFFER_SIZE-1)
+
+// Band-limited synthesis.  Changes in the mixed output of the APU channels
+// are added to the output as band-limited steps placed to within
+// 1/APU_SYNTH_PHASES of an output sample.  Each step is spread over
+// APU_SYNTH_WIDTH output samples, which delays the output by half that.
+#define APU_SYNTH_PHASES 512
+#define APU_SYNTH_WIDTH  16
+#define APU_SYNTH_SHIFT  14
+
+// Largest adjustment, in parts per million, the rate control will make to
+// the output sample rate to keep the audio buffer near its target fill.
+#define APU_RATE_ADJUST_MAX 5000
 
 // APU mask register ($4017) bit definitions.
 #define APUSTATUS_FIVEFRAMES 0x80
@@ -110,9 +126,12 @@ public:
    inline void SETDAC ( uint8_t dac )
    {
       uint8_t oldDac = m_dac;
-      m_dacAverage[m_dacSamples] = dac;
+      if ( m_dacAveraging )
+      {
+         m_dacAverage[m_dacSamples] = dac;
+         m_dacSamples++;
+      }
       m_dac = dac;
-      m_dacSamples++;
       if ( dac != oldDac )
       {
          CNES::CHECKBREAKPOINT(eBreakInAPU,eBreakOnAPUEvent,dac,APU_EVENT_SQUARE1_DAC_VALUE+m_channel);
@@ -123,7 +142,14 @@ public:
       return m_dac;
    }
 
-   // These routines deal with averaging the DAC value over time.
+   // These routines deal with averaging the DAC value over time.  The
+   // APU's own channels don't need it; their output is synthesized from
+   // the DAC changes as they happen.
+   inline void DACAVERAGING ( bool enabled )
+   {
+      m_dacAveraging = enabled;
+      m_dacSamples = 0;
+   }
    inline void CLEARDACAVG ( void )
    {
       m_dacSamples = 0;
@@ -269,6 +295,7 @@ protected:
                               // cover both NTSC and PAL sample-spacing throughout
                               // the frame.
    uint8_t m_dacSamples;
+   bool    m_dacAveraging;
 
    // Flags indicating whether or not certain channel
    // registers were written since the last channel activity.
@@ -588,87 +615,127 @@ protected:
 class CAPU
 {
 public:
-   CAPU();
-
    static void RESET ( void );
+
+   // Save state support.  SAVESTATE writes this object's chunk of a save
+   // state; LOADSTATE restores it, returning false if the chunk is missing
+   // or does not match.
+   static void SAVESTATE ( CNESStateWriter& writer );
+   static bool LOADSTATE ( CNESStateReader& reader );
    static uint32_t APU ( uint32_t addr );
    static void APU ( uint32_t addr, uint8_t data );
-   static void EMULATE ( void );
+   template <class HOOKS> static void EMULATE ( void );
+
+   // Audio output.  Samples go from the emulator thread to the audio thread
+   // through a single-producer, single-consumer ring: EMULATE is the only
+   // writer of the produce index and READ (or PLAY) the only writer of the
+   // consume index, so neither side needs a lock.  READ always fills the
+   // whole buffer it is given; if the ring runs dry the last sample is faded
+   // out rather than leaving a gap.  It returns the number of samples that
+   // actually came from the ring.
+   //
+   // CLEARSAMPLESAVAILABLE is called on the emulator side.  It doesn't touch
+   // the consume index; it records the produce index as far as the ring is
+   // to be flushed and READ skips its consume index up to there.
+   static int32_t READ ( int16_t* buffer, int32_t samples );
    static uint8_t* PLAY ( uint16_t samples );
+   static int32_t SAMPLESAVAILABLE ( void )
+   {
+      uint32_t produce = STATE()->m_waveBufProduce.load(std::memory_order_acquire);
+
+      return produce-CONSUMEINDEX();
+   }
+   static void CLEARSAMPLESAVAILABLE ( void )
+   {
+      STATE()->m_waveBufFlush.store(STATE()->m_waveBufProduce.load(std::memory_order_relaxed),std::memory_order_release);
+   }
+
+   // Sets the fill level, in samples, the ring is kept at.  The audio hook
+   // is called once the ring holds this many samples, and the output sample
+   // rate is nudged up or down to hold the fill near it when the emulator
+   // can't keep pace.  Zero restores the default of APU_BUFFER_PRERENDER
+   // with no rate control.
+   static void LATENCY ( int32_t samples );
+   static void INFORMATION ( nesAudioInfo* pInfo );
+
+   // Sets the output sample rate.  Defaults to SDL_SAMPLE_RATE.
+   static void SAMPLERATE ( int32_t rate );
 
    static void DMASOURCE ( uint8_t* source )
    {
-      m_dmc.DMASOURCE ( source );
+      STATE()->m_dmc.DMASOURCE ( source );
    }
 
    static void DMASAMPLE ( uint8_t data )
    {
-      m_dmc.DMASAMPLE ( data );
+      STATE()->m_dmc.DMASAMPLE ( data );
    }
 
    static uint8_t MUTED ( void )
    {
-      return ( (!m_square[0].MUTED())|
-               ((!m_square[1].MUTED())<<1)|
-               ((!m_triangle.MUTED())<<2)|
-               ((!m_noise.MUTED())<<3)|
-               ((!m_dmc.MUTED())<<4) );
+      return ( (!STATE()->m_square[0].MUTED())|
+               ((!STATE()->m_square[1].MUTED())<<1)|
+               ((!STATE()->m_triangle.MUTED())<<2)|
+               ((!STATE()->m_noise.MUTED())<<3)|
+               ((!STATE()->m_dmc.MUTED())<<4) );
    }
    static void MUTE ( uint8_t mask )
    {
-      m_square[0].MUTE(!(mask&0x01));
-      m_square[1].MUTE(!(mask&0x02));
-      m_triangle.MUTE(!(mask&0x04));
-      m_noise.MUTE(!(mask&0x08));
-      m_dmc.MUTE(!(mask&0x10));
+      STATE()->m_square[0].MUTE(!(mask&0x01));
+      STATE()->m_square[1].MUTE(!(mask&0x02));
+      STATE()->m_triangle.MUTE(!(mask&0x04));
+      STATE()->m_noise.MUTE(!(mask&0x08));
+      STATE()->m_dmc.MUTE(!(mask&0x10));
    }
 
    static uint32_t _APU ( uint32_t addr )
    {
-      return *(m_APUreg+(addr&0x1F));
+      return *(STATE()->m_APUreg+(addr&0x1F));
    }
    static void _APU ( uint32_t addr, uint8_t data )
    {
-      *(m_APUreg+(addr&0x1F)) = data;
+      *(STATE()->m_APUreg+(addr&0x1F)) = data;
    }
    static inline uint8_t DIRTY ( uint32_t addr )
    {
-      uint8_t updated = *(m_APUregDirty+(addr&0x1F));
-      *(m_APUregDirty+(addr&0x1F))=0;
+      uint8_t updated = *(STATE()->m_APUregDirty+(addr&0x1F));
+      *(STATE()->m_APUregDirty+(addr&0x1F))=0;
       return updated;
    }
 
    static void RELEASEIRQ ( void );
-   static inline void SEQTICK ( int32_t sequence );
+   template <class HOOKS> static inline void SEQTICK ( int32_t sequence );
    static inline uint16_t AMPLITUDE ( void );
+   static inline void SYNTHESIZE ( int32_t delta, int32_t phase );
+   static void BUILDSYNTHTABLES ( void );
 
    static inline void RESETCYCLECOUNTER ( uint32_t cycle )
    {
-      m_cycles = cycle;
+      STATE()->m_cycles = cycle;
    }
    static inline uint32_t CYCLES ( void )
    {
-      return m_cycles;
+      return STATE()->m_cycles;
    }
 
    static int32_t SEQUENCERMODE ( void )
    {
-      return m_sequencerMode;
+      return STATE()->m_sequencerMode;
    }
 
    // INTERNAL ACCESSOR FUNCTIONS
    // These are called directly.
    static void LENGTHCOUNTERS ( uint16_t* sq1, uint16_t* sq2, uint16_t* triangle, uint16_t* noise, uint16_t* dmc )
    {
-      (*sq1) = m_square[0].LENGTHCOUNTER();
-      (*sq2) = m_square[1].LENGTHCOUNTER();
-      (*triangle) = m_triangle.LENGTHCOUNTER();
-      (*noise) = m_noise.LENGTHCOUNTER();
-      (*dmc) = m_dmc.LENGTHCOUNTER();
+      (*sq1) = STATE()->m_square[0].LENGTHCOUNTER();
+      (*sq2) = STATE()->m_square[1].LENGTHCOUNTER();
+      (*triangle) = STATE()->m_triangle.LENGTHCOUNTER();
+      (*noise) = STATE()->m_noise.LENGTHCOUNTER();
+      (*dmc) = STATE()->m_dmc.LENGTHCOUNTER();
    }
    static void LINEARCOUNTER ( uint8_t* triangle )
    {
-      (*triangle) = m_triangle.LINEARCOUNTER();
+      (*triangle) = STATE()->m_triangle.LINEARCOUNTER();
    }
    static void GETDACS ( uint8_t* square1,
                          uint8_t* square2,
@@ -676,27 +743,27 @@ public:
                          uint8_t* noise,
                          uint8_t* dmc )
    {
-      (*square1) = m_square[0].GETDAC();
-      (*square2) = m_square[1].GETDAC();
-      (*triangle) = m_triangle.GETDAC();
-      (*noise) = m_noise.GETDAC();
-      (*dmc) = m_dmc.GETDAC();
+      (*square1) = STATE()->m_square[0].GETDAC();
+      (*square2) = STATE()->m_square[1].GETDAC();
+      (*triangle) = STATE()->m_triangle.GETDAC();
+      (*noise) = STATE()->m_noise.GETDAC();
+      (*dmc) = STATE()->m_dmc.GETDAC();
    }
    static void DMCIRQ ( bool* enabled, bool* asserted )
    {
-      (*enabled) = m_dmc.IRQENABLED();
-      (*asserted) = m_dmc.IRQASSERTED();
+      (*enabled) = STATE()->m_dmc.IRQENABLED();
+      (*asserted) = STATE()->m_dmc.IRQASSERTED();
    }
    static void SAMPLEINFO ( uint16_t* addr, uint16_t* length, uint16_t* pos )
    {
-      (*addr) = m_dmc.SAMPLEADDR();
-      (*length) = m_dmc.SAMPLELENGTH();
-      (*pos) = m_dmc.SAMPLEPOS();
+      (*addr) = STATE()->m_dmc.SAMPLEADDR();
+      (*length) = STATE()->m_dmc.SAMPLELENGTH();
+      (*pos) = STATE()->m_dmc.SAMPLEPOS();
    }
    static void DMAINFO ( uint8_t* buffer, bool* full )
    {
-      (*buffer) = m_dmc.SAMPLEBUFFER();
-      (*full) = m_dmc.SAMPLEBUFFERFULL();
+      (*buffer) = STATE()->m_dmc.SAMPLEBUFFER();
+      (*full) = STATE()->m_dmc.SAMPLEBUFFERFULL();
    }
 
    static CRegisterDatabase* REGISTERS()
@@ -714,30 +781,91 @@ public:
    }
 
 protected:
-   static uint8_t m_APUreg [ 32 ];
-   static uint8_t m_APUregDirty [ 32 ];
-   static bool m_irqEnabled;
-   static bool m_irqAsserted;
-
-   static int32_t m_sequencerMode;
-   static int32_t m_newSequencerMode;
-   static int32_t m_changeModes;
-   static int32_t m_sequenceStep;
-
-   static CAPUSquare m_square[2];
-   static CAPUTriangle m_triangle;
-   static CAPUNoise m_noise;
-   static CAPUDMC m_dmc;
-
-   static uint16_t* m_waveBuf;
-   static int32_t m_waveBufProduce;
-   static int32_t m_waveBufConsume;
-
-   static uint32_t   m_cycles;
-
-   static float m_sampleSpacer;
-   
-   static int32_t m_sampleBufferSize;
+   // Where the consumer is to read from next: its own index, or the last
+   // flush if the emulator has flushed the ring past it.
+   static uint32_t CONSUMEINDEX ( void )
+   {
+      uint32_t consume = STATE()->m_waveBufConsume.load(std::memory_order_acquire);
+      uint32_t flush = STATE()->m_waveBufFlush.load(std::memory_order_acquire);
+
+      return ( (int32_t)(flush-consume) > 0 ) ? flush : consume;
+   }
+
+   friend struct NESContext;
+   struct State
+   {
+      State ();
+      ~State ();
+
+      uint8_t m_APUreg [ 32 ] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+      uint8_t m_APUregDirty [ 32 ] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+      bool m_irqEnabled = false;
+      bool m_irqAsserted = false;
+
+      int32_t m_sequencerMode = 0;
+      int32_t m_newSequencerMode = 0;
+      // Cycles to wait before changing sequencer modes...0 or 1 are valid values
+      // on a mode-change.
+      int32_t m_changeModes = -1;
+      int32_t m_sequenceStep = 0;
+
+      CAPUSquare m_square[2];
+      CAPUTriangle m_triangle;
+      CAPUNoise m_noise;
+      CAPUDMC m_dmc;
+
+      // The output ring.  The indices count samples forever and are masked
+      // into m_waveBuf, so produce-consume is the fill level.
+      // m_waveBufFlush is the produce index at the last flush.
+      uint16_t* m_waveBuf = NULL;
+      std::atomic<uint32_t> m_waveBufProduce { 0 };
+      std::atomic<uint32_t> m_waveBufConsume { 0 };
+      std::atomic<uint32_t> m_waveBufFlush { 0 };
+
+      // Linear copy of the ring handed out by PLAY.
+      uint16_t* m_playBuf = NULL;
+
+      uint32_t   m_cycles = 0;
+
+      float m_sampleSpacer = 0.0;
+      int32_t m_sampleRate = SDL_SAMPLE_RATE;
+
+      // Rate control.  m_latency is the target fill (0 for none) and
+      // m_rateAdjust the current change to the output sample rate in parts
+      // per million, positive for more samples.  Both are set by the audio
+      // thread and read by the emulator thread.
+      std::atomic<int32_t> m_latency { 0 };
+      std::atomic<int32_t> m_rateAdjust { 0 };
+
+      // Consumer-side telemetry.  m_fillAverage is the fill the audio thread
+      // sees when it reads, averaged over the last few reads, in 1/16ths of
+      // a sample.  m_lastProduce is the produce index at the last read, used
+      // to tell an underrun from the emulator being paused.
+      std::atomic<int32_t>  m_fillAverage { 0 };
+      std::atomic<uint32_t> m_underruns { 0 };
+      std::atomic<uint32_t> m_overruns { 0 };
+      uint32_t m_lastProduce = 0;
+      int16_t  m_lastSample = 0;
+
+      // Band-limited synthesis.  m_synthAmp is the mixed output of the
+      // channels.  m_synthBuf holds the steps not yet output, the next
+      // output sample's share at m_synthPos, and m_synthSum integrates them
+      // back into the output level.  m_highPassIn and m_highPassOut are the
+      // DC-blocking filter, the output kept to 8 fractional bits.
+      int32_t m_synthAmp = 0;
+      int64_t m_synthBuf [ APU_SYNTH_WIDTH ] = { 0 };
+      int32_t m_synthPos = 0;
+      int64_t m_synthSum = 0;
+      int32_t m_highPassIn = 0;
+      int32_t m_highPassOut = 0;
+
+      // Cycles since the last output sample.
+      float   m_takeSample = 0.0f;
+   };
+   static inline State* STATE ();
+
+   // The data saved and restored as-is by SAVESTATE and LOADSTATE.
+   template <class STREAM> static void STATEDATA ( STREAM& stream );
 
    static CRegisterDatabase* m_dbRegisters;
 
@@ -1,16 +1,144 @@
 #include "cbreakpointinfo.h"
 
+#include <string.h>
+
 #include "nes_emulator_core.h"
 
 #include "cnes6502.h"
 #include "cnesppu.h"
 #include "cnesapu.h"
 #include "cnesrom.h"
+#include "cnes.h"
+#include "cnescontext.h"
+
+typedef enum
+{
+   eNESSymbolA = 0,
+   eNESSymbolX,
+   eNESSymbolY,
+   eNESSymbolSP,
+   eNESSymbolF,
+   eNESSymbolPC,
+   eNESSymbolFlagN,
+   eNESSymbolFlagV,
+   eNESSymbolFlagD,
+   eNESSymbolFlagI,
+   eNESSymbolFlagZ,
+   eNESSymbolFlagC,
+   eNESSymbolEA,
+   eNESSymbolCPUCycle,
+   eNESSymbolFrame,
+   eNESSymbolPPUCycle,
+   eNESSymbolScanline,
+   eNESSymbolPixel,
+   eNESSymbolPPUAddr
+} eNESSymbol;
+
+static const BreakpointExpressionSymbol nesSymbols [] =
+{
+   { "a", eNESSymbolA },
+   { "x", eNESSymbolX },
+   { "y", eNESSymbolY },
+   { "sp", eNESSymbolSP },
+   { "f", eNESSymbolF },
+   { "pc", eNESSymbolPC },
+   { "n", eNESSymbolFlagN },
+   { "v", eNESSymbolFlagV },
+   { "d", eNESSymbolFlagD },
+   { "i", eNESSymbolFlagI },
+   { "z", eNESSymbolFlagZ },
+   { "c", eNESSymbolFlagC },
+   { "ea", eNESSymbolEA },
+   { "cycle", eNESSymbolCPUCycle },
+   { "frame", eNESSymbolFrame },
+   { "ppucycle", eNESSymbolPPUCycle },
+   { "scanline", eNESSymbolScanline },
+   { "pixel", eNESSymbolPixel },
+   { "ppuaddr", eNESSymbolPPUAddr },
+   { NULL, 0 }
+};
+
+static int32_t nesSymbolValue ( int32_t id )
+{
+   switch ( id )
+   {
+      case eNESSymbolA:
+         return C6502::_A();
+      case eNESSymbolX:
+         return C6502::_X();
+      case eNESSymbolY:
+         return C6502::_Y();
+      case eNESSymbolSP:
+         return C6502::_SP();
+      case eNESSymbolF:
+         return C6502::_F();
+      case eNESSymbolPC:
+         return C6502::__PC();
+      case eNESSymbolFlagN:
+         return C6502::_N();
+      case eNESSymbolFlagV:
+         return C6502::_V();
+      case eNESSymbolFlagD:
+         return C6502::_D();
+      case eNESSymbolFlagI:
+         return C6502::_I();
+      case eNESSymbolFlagZ:
+         return C6502::_Z();
+      case eNESSymbolFlagC:
+         return C6502::_C();
+      case eNESSymbolEA:
+         return C6502::_EA();
+      case eNESSymbolCPUCycle:
+         return C6502::_CYCLES();
+      case eNESSymbolFrame:
+         return CPPU::_FRAME();
+      case eNESSymbolPPUCycle:
+         return CPPU::_CYCLES();
+      case eNESSymbolScanline:
+         return CPPU::_Y();
+      case eNESSymbolPixel:
+         return CPPU::_X();
+      case eNESSymbolPPUAddr:
+         return CPPU::_PPUADDR();
+   }
+   return 0;
+}
+
+static int32_t nesMemoryValue ( uint32_t addr )
+{
+   addr &= 0xFFFF;
+   if ( addr < 0x2000 )
+   {
+      addr &= 0x7FF;
+   }
+   return CNES::_MEM(addr);
+}
+
+static const BreakpointExpressionContext nesExpressionContext =
+{
+   nesSymbolValue,
+   nesMemoryValue
+};
 
 CNESBreakpointInfo::CNESBreakpointInfo()
 {
 }
 
+const BreakpointExpressionSymbol* CNESBreakpointInfo::GetExpressionSymbols ( void )
+{
+   return nesSymbols;
+}
+
+const BreakpointExpressionContext* CNESBreakpointInfo::GetExpressionContext ( void )
+{
+   return &nesExpressionContext;
+}
+
+bool CNESBreakpointInfo::CompileExpression ( BreakpointInfo* pBreakpoint, char* error )
+{
+   return CBreakpointExpression::Compile(pBreakpoint->expression,nesSymbols,&(pBreakpoint->program),error);
+}
+
 void CNESBreakpointInfo::ModifyBreakpoint ( BreakpointInfo* pBreakpoint, int type, eBreakpointItemType itemType, int event, int item1, int item1Absolute, int item2, int mask, bool maskExclusive, eBreakpointConditionType conditionType, int condition, eBreakpointDataType dataType, int data, bool enabled )
 {
    pBreakpoint->hit = false;
@@ -89,6 +217,7 @@ void CNESBreakpointInfo::ModifyBreakpoint ( BreakpointInfo* pBreakpoint, int typ
 
 void CNESBreakpointInfo::GetPrintable ( int idx, char* msg )
 {
+   char*          start = msg;
    CRegisterData* pRegister;
    CBitfieldData* pBitfield;
    char printableAddress[32];
@@ -1836,12 +1965,36 @@ void CNESBreakpointInfo::GetPrintable ( int idx, char* msg )
                    m_breakpoint[idx].item2 );
          break;
    }
+
+   msg = start+strlen(start);
+   if ( m_breakpoint[idx].expression[0] )
+   {
+      msg += sprintf ( msg, " and %s", m_breakpoint[idx].expression );
+   }
+   switch ( m_breakpoint[idx].hitCondition )
+   {
+      case eBreakpointHitCountEqual:
+         msg += sprintf ( msg, ", on hit %d", m_breakpoint[idx].hitCountTarget );
+         break;
+      case eBreakpointHitCountMultiple:
+         msg += sprintf ( msg, ", every %d hits", m_breakpoint[idx].hitCountTarget );
+         break;
+      case eBreakpointHitCountAtLeast:
+         msg += sprintf ( msg, ", from hit %d on", m_breakpoint[idx].hitCountTarget );
+         break;
+      default:
+         break;
+   }
+   if ( m_breakpoint[idx].action == eBreakpointActionLog )
+   {
+      sprintf ( msg, " (log only)" );
+   }
 }
 
 void CNESBreakpointInfo::GetHitPrintable ( int idx, char* hmsg )
 {
    char*          msg = hmsg;
 
-   msg += sprintf ( msg, "[PPU(frame=%d,cycle=%d),CPU(cycle=%d),APU(cycle=%d)] BREAK: ", CPPU::_FRAME(), CPPU::_CYCLES(), C6502::_CYCLES(), CAPU::CYCLES() );
+   msg += sprintf ( msg, "[PPU(frame=%d,cycle=%d),CPU(cycle=%d),APU(cycle=%d)] %s: ", CPPU::_FRAME(), CPPU::_CYCLES(), C6502::_CYCLES(), CAPU::CYCLES(), (m_breakpoint[idx].action == eBreakpointActionLog) ? "LOG" : "BREAK" );
    GetPrintable(idx,msg);
 }
@@ -9,6 +9,11 @@ public:
    CNESBreakpointInfo();
    void GetPrintable ( int idx, char* msg );
    void GetHitPrintable ( int idx, char* hmsg );
+   bool CompileExpression ( BreakpointInfo* pBreakpoint, char* error );
+   // Names the NES allows in breakpoint conditions, and how the core
+   // looks them and CPU memory up when it evaluates one.
+   static const BreakpointExpressionSymbol* GetExpressionSymbols ( void );
+   static const BreakpointExpressionContext* GetExpressionContext ( void );
 
 protected:
    void ModifyBreakpoint ( BreakpointInfo* pBreakpoint, int type, eBreakpointItemType itemType, int event, int item1, int item1Absolute, int item2, int mask, bool maskExclusive, eBreakpointConditionType conditionType, int condition, eBreakpointDataType dataType, int data, bool enabled );
@@ -0,0 +1,172 @@
+//    NESICIDE - an IDE for the 8-bit NES.
+//    Copyright (C) 2009  Christopher S. Pow
+
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "cnescontext.h"
+
+// The context used by any thread that has not bound one of its own.
+static NESContext __nesdefaultcontext;
+
+#if defined ( _MSC_VER )
+__declspec(thread) NESContext* __nescontext = &__nesdefaultcontext;
+#else
+__thread NESContext* __nescontext __attribute__((tls_model("initial-exec"))) = &__nesdefaultcontext;
+#endif
+
+NESContext::NESContext ()
+   : mapperfunc(&(_mapperfunc[0])), // Assume NROM to start.
+     debug(false),
+     breakpointHook(NULL),
+     audioHook(NULL),
+     snapshots(NULL),
+     snapshotLatest(-1),
+     snapshotSequence(0),
+     edits(0)
+{
+   int32_t idx;
+
+   for ( idx = 0; idx < NUM_DEBUGGER_SNAPSHOTS; idx++ )
+   {
+      snapshotUsers[idx] = 0;
+      snapshotEdits[idx] = 0;
+   }
+}
+
+NESContext::~NESContext ()
+{
+   delete [] snapshots;
+}
+
+NESContext* nesDefaultContext ( void )
+{
+   return &__nesdefaultcontext;
+}
+
+void* nesMapperState ( int32_t idx, uint32_t* mapper, uint32_t* size )
+{
+   switch ( idx )
+   {
+      case 0:
+         (*mapper) = 1;
+         (*size) = sizeof(__nescontext->mapper001);
+         return &__nescontext->mapper001;
+      case 1:
+         (*mapper) = 2;
+         (*size) = sizeof(__nescontext->mapper002);
+         return &__nescontext->mapper002;
+      case 2:
+         (*mapper) = 3;
+         (*size) = sizeof(__nescontext->mapper003);
+         return &__nescontext->mapper003;
+      case 3:
+         (*mapper) = 4;
+         (*size) = sizeof(__nescontext->mapper004);
+         return &__nescontext->mapper004;
+      case 4:
+         (*mapper) = 5;
+         (*size) = sizeof(__nescontext->mapper005);
+         return &__nescontext->mapper005;
+      case 5:
+         (*mapper) = 7;
+         (*size) = sizeof(__nescontext->mapper007);
+         return &__nescontext->mapper007;
+      case 6:
+         (*mapper) = 9;
+         (*size) = sizeof(__nescontext->mapper009);
+         return &__nescontext->mapper009;
+      case 7:
+         (*mapper) = 10;
+         (*size) = sizeof(__nescontext->mapper010);
+         return &__nescontext->mapper010;
+      case 8:
+         (*mapper) = 11;
+         (*size) = sizeof(__nescontext->mapper011);
+         return &__nescontext->mapper011;
+      case 9:
+         (*mapper) = 13;
+         (*size) = sizeof(__nescontext->mapper013);
+         return &__nescontext->mapper013;
+      case 10:
+         (*mapper) = 16;
+         (*size) = sizeof(__nescontext->mapper016);
+         return &__nescontext->mapper016;
+      case 11:
+         (*mapper) = 18;
+         (*size) = sizeof(__nescontext->mapper018);
+         return &__nescontext->mapper018;
+      case 12:
+         (*mapper) = 19;
+         (*size) = sizeof(__nescontext->mapper019);
+         return &__nescontext->mapper019;
+      case 13:
+         (*mapper) = 21;
+         (*size) = sizeof(__nescontext->mapper021);
+         return &__nescontext->mapper021;
+      case 14:
+         (*mapper) = 22;
+         (*size) = sizeof(__nescontext->mapper022);
+         return &__nescontext->mapper022;
+      case 15:
+         (*mapper) = 23;
+         (*size) = sizeof(__nescontext->mapper023);
+         return &__nescontext->mapper023;
+      case 16:
+         (*mapper) = 24;
+         (*size) = sizeof(__nescontext->mapper024);
+         return &__nescontext->mapper024;
+      case 17:
+         (*mapper) = 25;
+         (*size) = sizeof(__nescontext->mapper025);
+         return &__nescontext->mapper025;
+      case 18:
+         (*mapper) = 26;
+         (*size) = sizeof(__nescontext->mapper026);
+         return &__nescontext->mapper026;
+      case 19:
+         (*mapper) = 28;
+         (*size) = sizeof(__nescontext->mapper028);
+         return &__nescontext->mapper028;
+      case 20:
+         (*mapper) = 33;
+         (*size) = sizeof(__nescontext->mapper033);
+         return &__nescontext->mapper033;
+      case 21:
+         (*mapper) = 34;
+         (*size) = sizeof(__nescontext->mapper034);
+         return &__nescontext->mapper034;
+      case 22:
+         (*mapper) = 65;
+         (*size) = sizeof(__nescontext->mapper065);
+         return &__nescontext->mapper065;
+      case 23:
+         (*mapper) = 68;
+         (*size) = sizeof(__nescontext->mapper068);
+         return &__nescontext->mapper068;
+      case 24:
+         (*mapper) = 69;
+         (*size) = sizeof(__nescontext->mapper069);
+         return &__nescontext->mapper069;
+      case 25:
+         (*mapper) = 73;
+         (*size) = sizeof(__nescontext->mapper073);
+         return &__nescontext->mapper073;
+      case 26:
+         (*mapper) = 75;
+         (*size) = sizeof(__nescontext->mapper075);
+         return &__nescontext->mapper075;
+      default:
+         return NULL;
+   }
+}
@@ -0,0 +1,317 @@
+#if !defined ( NESCONTEXT_H )
+#define NESCONTEXT_H
+
+#include <atomic>
+#include <mutex>
+#include <string.h>
+
+#include "cnes.h"
+#include "cnes6502.h"
+#include "cnesppu.h"
+#include "cnesapu.h"
+#include "cnesrom.h"
+#include "cnesio.h"
+#include "cnesrewind.h"
+#include "cnesmappers.h"
+#include "ccodedatalogger.h"
+#include "cnesrommapper001.h"
+#include "cnesrommapper002.h"
+#include "cnesrommapper003.h"
+#include "cnesrommapper004.h"
+#include "cnesrommapper005.h"
+#include "cnesrommapper007.h"
+#include "cnesrommapper009.h"
+#include "cnesrommapper010.h"
+#include "cnesrommapper011.h"
+#include "cnesrommapper013.h"
+#include "cnesrommapper016.h"
+#include "cnesrommapper018.h"
+#include "cnesrommapper019.h"
+#include "cnesrommapper021.h"
+#include "cnesrommapper022.h"
+#include "cnesrommapper023.h"
+#include "cnesrommapper024.h"
+#include "cnesrommapper025.h"
+#include "cnesrommapper026.h"
+#include "cnesrommapper028.h"
+#include "cnesrommapper033.h"
+#include "cnesrommapper034.h"
+#include "cnesrommapper065.h"
+#include "cnesrommapper068.h"
+#include "cnesrommapper069.h"
+#include "cnesrommapper073.h"
+#include "cnesrommapper075.h"
+
+// The NESContext structure is one complete emulated NES.  The emulator
+// core objects (CNES, C6502, CPPU, CAPU, CROM, the I/O devices and the
+// mappers) are still static classes; their mutable data lives in each
+// class's State structure and a NESContext holds one of each.  The
+// static methods reach their data through STATE(), which returns the
+// State inside the context bound to the calling thread.
+//
+// A process-wide default context is bound to every thread until the
+// thread binds another one with nesSetContext(), so single-instance
+// users of the nes* interfaces see no difference.  Any number of
+// contexts can be created and run concurrently as long as each is only
+// run by one thread at a time.
+//
+// Data that describes the emulated hardware rather than a particular
+// machine's state (register and memory databases, breakpoint event
+// tables, opcode tables) remains static and is shared by all contexts.
+struct NESContext
+{
+   NESContext ();
+   ~NESContext ();
+
+   // Contexts start out zeroed like the default one, which is static, so
+   // whatever the State constructors leave alone is the same in all of them.
+   static void* operator new ( size_t size )
+   {
+      void* pContext = ::operator new ( size );
+
+      memset ( pContext, 0, size );
+      return pContext;
+   }
+   static void operator delete ( void* pContext )
+   {
+      ::operator delete ( pContext );
+   }
+
+   CNES::State              nes;
+   C6502::State             cpu;
+   CPPU::State              ppu;
+   CAPU::State              apu;
+   CROM::State              rom;
+   CIO::State               io;
+   CIOStandardJoypad::State joypad;
+   CIOTurboJoypad::State    turboJoypad;
+   CIOVaus::State           vaus;
+   CCodeDataLogger::State   logger;
+   CNESRewind::State        rewind;
+
+   CROMMapper001::State     mapper001;
+   CROMMapper002::State     mapper002;
+   CROMMapper003::State     mapper003;
+   CROMMapper004::State     mapper004;
+   CROMMapper005::State     mapper005;
+   CROMMapper007::State     mapper007;
+   CROMMapper009::State     mapper009;
+   CROMMapper010::State     mapper010;
+   CROMMapper011::State     mapper011;
+   CROMMapper013::State     mapper013;
+   CROMMapper016::State     mapper016;
+   CROMMapper018::State     mapper018;
+   CROMMapper019::State     mapper019;
+   CROMMapper021::State     mapper021;
+   CROMMapper022::State     mapper022;
+   CROMMapper023::State     mapper023;
+   CROMMapper024::State     mapper024;
+   CROMMapper025::State     mapper025;
+   CROMMapper026::State     mapper026;
+   CROMMapper028::State     mapper028;
+   CROMMapper033::State     mapper033;
+   CROMMapper034::State     mapper034;
+   CROMMapper065::State     mapper065;
+   CROMMapper068::State     mapper068;
+   CROMMapper069::State     mapper069;
+   CROMMapper073::State     mapper073;
+   CROMMapper075::State     mapper075;
+
+   // Mapper function table entry selected at the last reset.
+   MapperFuncs* mapperfunc;
+
+   // Whether debugger support (tracer, loggers, breakpoints) is active.
+   bool debug;
+
+   // Callbacks into the UI.
+   void (*breakpointHook)(void);
+   void (*audioHook)(void);
+
+   // Held by the thread changing the NES other than through the debuggers,
+   // by running a frame, resetting, loading and the like.  nesBreak() lets
+   // go of it while the breakpoint hook runs.
+   std::mutex changing;
+
+   // Snapshots published for the debuggers, allocated when the first is
+   // published.  A snapshot's users are the threads that have acquired it,
+   // plus DEBUGGER_SNAPSHOT_WRITING while it is being written.  edits counts
+   // changes made outside of a frame and snapshotEdits records
+   // its value when each snapshot was taken.
+   nesDebuggerSnapshot*  snapshots;
+   std::atomic<uint32_t> snapshotUsers [ NUM_DEBUGGER_SNAPSHOTS ];
+   uint32_t              snapshotEdits [ NUM_DEBUGGER_SNAPSHOTS ];
+   std::atomic<int32_t>  snapshotLatest;
+   std::atomic<uint32_t> snapshotSequence;
+   std::atomic<uint32_t> edits;
+};
+
+#define DEBUGGER_SNAPSHOT_WRITING 0x80000000
+
+// The context bound to the calling thread.  Never NULL.
+#if defined ( _MSC_VER )
+extern __declspec(thread) NESContext* __nescontext;
+#else
+extern __thread NESContext* __nescontext __attribute__((tls_model("initial-exec")));
+#endif
+
+// The context threads are bound to until they call nesSetContext().
+NESContext* nesDefaultContext ( void );
+
+// Enumerates the mapper States of the bound context for saving and
+// restoring them whole.  Returns the idx'th State and its mapper number and
+// size, or NULL past the last one.  All of them are saved, rather than only
+// the current mapper's, because some mappers share another's State.
+void* nesMapperState ( int32_t idx, uint32_t* mapper, uint32_t* size );
+
+// Core-internal shortcuts for per-context data that used to be globals.
+#undef nesIsDebuggable
+#define nesIsDebuggable() ( __nescontext->debug )
+#define MAPPERFUNC ( __nescontext->mapperfunc )
+
+// Debugger hook policies.  The routines that run for every emulated
+// cycle (the CPU instructions and bus accesses, PPU scanline rendering
+// and the APU sequencer) are templates on one of these.  CNES::RUN picks
+// the instantiation once per frame: NESNoDebugHooks compiles the tracer,
+// code/data logger and breakpoint checks out entirely while
+// NESDebugHooks keeps them, still subject to nesIsDebuggable().
+struct NESNoDebugHooks
+{
+   enum { HOOKED = 0 };
+   static inline bool ENABLED ( void ) { return false; }
+   static inline void CHECKBREAKPOINT ( eBreakpointTarget, eBreakpointType = (eBreakpointType)-1, int32_t = 0, int32_t = 0 ) {}
+};
+
+struct NESDebugHooks
+{
+   enum { HOOKED = 1 };
+   static inline bool ENABLED ( void ) { return nesIsDebuggable(); }
+   static inline void CHECKBREAKPOINT ( eBreakpointTarget target, eBreakpointType type = (eBreakpointType)-1, int32_t data = 0, int32_t event = 0 )
+   {
+      CNES::CHECKBREAKPOINT ( target, type, data, event );
+   }
+};
+
+// Code outside the templated routines (register handlers, resets,
+// interrupts) always runs with the hooks in place.  This lets the
+// register macros in the class headers be used there unchanged.
+typedef NESDebugHooks HOOKS;
+
+inline CNES::State* CNES::STATE () { return &__nescontext->nes; }
+inline C6502::State* C6502::STATE () { return &__nescontext->cpu; }
+inline CPPU::State* CPPU::STATE () { return &__nescontext->ppu; }
+inline CAPU::State* CAPU::STATE () { return &__nescontext->apu; }
+inline CROM::State* CROM::STATE () { return &__nescontext->rom; }
+inline CIO::State* CIO::STATE () { return &__nescontext->io; }
+inline CIOStandardJoypad::State* CIOStandardJoypad::STATE () { return &__nescontext->joypad; }
+inline CIOTurboJoypad::State* CIOTurboJoypad::STATE () { return &__nescontext->turboJoypad; }
+inline CIOVaus::State* CIOVaus::STATE () { return &__nescontext->vaus; }
+inline CCodeDataLogger::State* CCodeDataLogger::STATE () { return &__nescontext->logger; }
+inline CNESRewind::State* CNESRewind::STATE () { return &__nescontext->rewind; }
+
+inline CROMMapper001::State* CROMMapper001::STATE () { return &__nescontext->mapper001; }
+inline CROMMapper002::State* CROMMapper002::STATE () { return &__nescontext->mapper002; }
+inline CROMMapper003::State* CROMMapper003::STATE () { return &__nescontext->mapper003; }
+inline CROMMapper004::State* CROMMapper004::STATE () { return &__nescontext->mapper004; }
+inline CROMMapper005::State* CROMMapper005::STATE () { return &__nescontext->mapper005; }
+inline CROMMapper007::State* CROMMapper007::STATE () { return &__nescontext->mapper007; }
+inline CROMMapper009::State* CROMMapper009::STATE () { return &__nescontext->mapper009; }
+inline CROMMapper010::State* CROMMapper010::STATE () { return &__nescontext->mapper010; }
+inline CROMMapper011::State* CROMMapper011::STATE () { return &__nescontext->mapper011; }
+inline CROMMapper013::State* CROMMapper013::STATE () { return &__nescontext->mapper013; }
+inline CROMMapper016::State* CROMMapper016::STATE () { return &__nescontext->mapper016; }
+inline CROMMapper018::State* CROMMapper018::STATE () { return &__nescontext->mapper018; }
+inline CROMMapper019::State* CROMMapper019::STATE () { return &__nescontext->mapper019; }
+inline CROMMapper021::State* CROMMapper021::STATE () { return &__nescontext->mapper021; }
+inline CROMMapper022::State* CROMMapper022::STATE () { return &__nescontext->mapper022; }
+inline CROMMapper023::State* CROMMapper023::STATE () { return &__nescontext->mapper023; }
+inline CROMMapper024::State* CROMMapper024::STATE () { return &__nescontext->mapper024; }
+inline CROMMapper025::State* CROMMapper025::STATE () { return &__nescontext->mapper025; }
+inline CROMMapper026::State* CROMMapper026::STATE () { return &__nescontext->mapper026; }
+inline CROMMapper028::State* CROMMapper028::STATE () { return &__nescontext->mapper028; }
+inline CROMMapper033::State* CROMMapper033::STATE () { return &__nescontext->mapper033; }
+inline CROMMapper034::State* CROMMapper034::STATE () { return &__nescontext->mapper034; }
+inline CROMMapper065::State* CROMMapper065::STATE () { return &__nescontext->mapper065; }
+inline CROMMapper068::State* CROMMapper068::STATE () { return &__nescontext->mapper068; }
+inline CROMMapper069::State* CROMMapper069::STATE () { return &__nescontext->mapper069; }
+inline CROMMapper073::State* CROMMapper073::STATE () { return &__nescontext->mapper073; }
+inline CROMMapper075::State* CROMMapper075::STATE () { return &__nescontext->mapper075; }
+
+// Look the check up in the breakpoint index.  The type is a constant at
+// nearly every call site so the switch folds away, leaving one bit test
+// for the common case of no breakpoint there.
+#define BREAKPOINTBIT(map,idx) ( ((map)[((idx)>>3)&((sizeof(map))-1)]>>((idx)&7))&1 )
+
+inline void CNES::CHECKBREAKPOINT ( eBreakpointTarget target, eBreakpointType type, int32_t data, int32_t event )
+{
+   State* pState = STATE();
+   bool   check;
+
+   // If stepping or clearing hits, go through everything...
+   if ( pState->m_bStepCPUBreakpoint ||
+        pState->m_bStepPPUBreakpoint ||
+        pState->m_bBreakpointHits )
+   {
+      EVALUATEBREAKPOINTS ( target, type, data, event );
+      return;
+   }
+
+   if ( !((pState->m_breakpointTypes>>type)&1) )
+   {
+      return;
+   }
+   if ( (pState->m_breakpointTypesUnindexed>>type)&1 )
+   {
+      EVALUATEBREAKPOINTS ( target, type, data, event );
+      return;
+   }
+
+   switch ( type )
+   {
+      case eBreakOnCPUExecution:
+         check = BREAKPOINTBIT(pState->m_breakpointAddresses[eBreakpointMap_CPUExecution],C6502::__PCSYNC());
+         break;
+      case eBreakOnCPUMemoryRead:
+         check = BREAKPOINTBIT(pState->m_breakpointAddresses[eBreakpointMap_CPURead],C6502::_EA());
+         break;
+      case eBreakOnCPUMemoryWrite:
+         check = BREAKPOINTBIT(pState->m_breakpointAddresses[eBreakpointMap_CPUWrite],C6502::_EA());
+         break;
+      case eBreakOnOAMPortalRead:
+         check = BREAKPOINTBIT(pState->m_breakpointAddresses[eBreakpointMap_OAMRead],CPPU::_OAMADDR());
+         break;
+      case eBreakOnOAMPortalWrite:
+         check = BREAKPOINTBIT(pState->m_breakpointAddresses[eBreakpointMap_OAMWrite],CPPU::_OAMADDR());
+         break;
+      case eBreakOnPPUFetch:
+         check = BREAKPOINTBIT(pState->m_breakpointAddresses[eBreakpointMap_PPUFetch],CPPU::_PPUADDR());
+         break;
+      case eBreakOnPPUPortalRead:
+         check = BREAKPOINTBIT(pState->m_breakpointAddresses[eBreakpointMap_PPURead],CPPU::_PPUADDR());
+         break;
+      case eBreakOnPPUPortalWrite:
+         check = BREAKPOINTBIT(pState->m_breakpointAddresses[eBreakpointMap_PPUWrite],CPPU::_PPUADDR());
+         break;
+      case eBreakOnCPUState:
+      case eBreakOnPPUState:
+      case eBreakOnAPUState:
+      case eBreakOnMapperState:
+         check = BREAKPOINTBIT(pState->m_breakpointItems[target],data);
+         break;
+      case eBreakOnCPUEvent:
+      case eBreakOnPPUEvent:
+      case eBreakOnAPUEvent:
+      case eBreakOnMapperEvent:
+         check = BREAKPOINTBIT(pState->m_breakpointEvents[target],event);
+         break;
+      default:
+         check = true;
+         break;
+   }
+
+   if ( check )
+   {
+      EVALUATEBREAKPOINTS ( target, type, data, event );
+   }
+}
+
+#endif
@@ -15,11 +15,22 @@ public:
    static uint32_t _IO ( uint32_t addr );
    static inline void JOY ( uint8_t joy, uint32_t data )
    {
-      *(m_ioJoy+joy) = data;
+      *(STATE()->m_ioJoy+joy) = data;
+   }
+
+   // Save state support.  The I/O devices are saved as part of CNES's chunk.
+   template <class STREAM> static void STATEDATA ( STREAM& stream )
+   {
+      stream.BYTES ( STATE()->m_ioJoy, sizeof(STATE()->m_ioJoy) );
    }
 
 protected:
-   static uint32_t  m_ioJoy [ NUM_CONTROLLERS ];
+   friend struct NESContext;
+   struct State
+   {
+      uint32_t  m_ioJoy [ NUM_CONTROLLERS ] = { 0x00, 0x00 };
+   };
+   static inline State* STATE ();
 };
 
 class CIOStandardJoypad : public CIO
@@ -31,12 +42,24 @@ public:
    static uint32_t IO ( uint32_t addr );
    static void _IO ( uint32_t addr, uint8_t data );
    static uint32_t _IO ( uint32_t addr );
-   static inline CJoypadLogger* LOGGER ( int idx ) { return m_logger+idx; }
+   static inline CJoypadLogger* LOGGER ( int idx ) { return STATE()->m_logger+idx; }
+
+   // Save state support.  The I/O devices are saved as part of CNES's chunk.
+   template <class STREAM> static void STATEDATA ( STREAM& stream )
+   {
+      stream.BYTES ( STATE()->m_ioJoyLatch, sizeof(STATE()->m_ioJoyLatch) );
+      stream.VALUE ( STATE()->m_last4016 );
+   }
 
 protected:
-   static uint8_t   m_ioJoyLatch [ NUM_CONTROLLERS ];
-   static uint8_t   m_last4016;
-   static CJoypadLogger  m_logger [ NUM_CONTROLLERS ];
+   friend struct NESContext;
+   struct State
+   {
+      uint8_t   m_ioJoyLatch [ NUM_CONTROLLERS ] = { 0x00, 0x00 };
+      uint8_t   m_last4016 = 0x00;
+      CJoypadLogger  m_logger [ NUM_CONTROLLERS ];
+   };
+   static inline State* STATE ();
 };
 
 class CIOTurboJoypad : public CIOStandardJoypad
@@ -48,9 +71,21 @@ public:
    static void _IO ( uint32_t addr, uint8_t data );
    static uint32_t _IO ( uint32_t addr );
 
+   // Save state support.  The I/O devices are saved as part of CNES's chunk.
+   template <class STREAM> static void STATEDATA ( STREAM& stream )
+   {
+      stream.VALUE ( STATE()->m_lastFrame );
+      stream.BYTES ( STATE()->m_alternator, sizeof(STATE()->m_alternator) );
+   }
+
 protected:
-   static uint32_t m_lastFrame;
-   static uint8_t m_alternator [ NUM_CONTROLLERS ][ 2 ];
+   friend struct NESContext;
+   struct State
+   {
+      uint32_t m_lastFrame = 0;
+      uint8_t m_alternator [ NUM_CONTROLLERS ][ 2 ] = { { 0, 0 }, { 0, 0 } };
+   };
+   static inline State* STATE ();
 };
 
 class CIOVaus : public CIO
@@ -64,10 +99,23 @@ public:
    static uint32_t _IO ( uint32_t addr );
    static void SPECIAL ( int32_t port, int32_t special );
 
+   // Save state support.  The I/O devices are saved as part of CNES's chunk.
+   template <class STREAM> static void STATEDATA ( STREAM& stream )
+   {
+      stream.BYTES ( STATE()->m_ioPotLatch, sizeof(STATE()->m_ioPotLatch) );
+      stream.VALUE ( STATE()->m_last4016 );
+      stream.BYTES ( STATE()->m_trimPot, sizeof(STATE()->m_trimPot) );
+   }
+
 protected:
-   static uint8_t   m_ioPotLatch [ NUM_CONTROLLERS ];
-   static uint8_t   m_last4016;
-   static uint8_t   m_trimPot [ NUM_CONTROLLERS ];
+   friend struct NESContext;
+   struct State
+   {
+      uint8_t   m_ioPotLatch [ NUM_CONTROLLERS ] = { 0x00, 0x00 };
+      uint8_t   m_last4016 = 0x00;
+      uint8_t   m_trimPot [ NUM_CONTROLLERS ] = { 0x54, 0x54 };
+   };
+   static inline State* STATE ();
 };
 
 class CIOZapper : public CIO
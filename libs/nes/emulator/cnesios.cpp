@@ -1,5 +1,6 @@
 #include "cnesios.h"
 #include "cnesio.h"
+#include "cnescontext.h"
 
 IOFuncs iofunc[] =
 {
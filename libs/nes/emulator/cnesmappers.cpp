@@ -43,8 +43,7 @@
 #include "cnesrommapper069.h"
 #include "cnesrommapper073.h"
 #include "cnesrommapper075.h"
-
-MapperFuncs* MAPPERFUNC = &(_mapperfunc[0]); // Assume NROM to start.
+#include "cnescontext.h"
 
 MapperFuncs _mapperfunc[] =
 {
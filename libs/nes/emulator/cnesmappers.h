@@ -29,6 +29,4 @@ typedef struct _MapperFuncs
 
 extern MapperFuncs _mapperfunc[];
 
-extern MapperFuncs* MAPPERFUNC;
-
 #endif
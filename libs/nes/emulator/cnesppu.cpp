@@ -22,6 +22,7 @@
 #include "cnesapu.h"
 
 #include "nes_emulator_core.h"
+#include "cnescontext.h"
 
 // The sprite pattern garbage fetch cycles use sprite tile index $FF.
 #define GARBAGE_SPRITE_FETCH 0xFF
@@ -666,78 +667,30 @@ static CBreakpointEventInfo* tblPPUEvents [] =
 CBreakpointEventInfo** CPPU::m_tblBreakpointEvents = tblPPUEvents;
 int32_t                CPPU::m_numBreakpointEvents = NUM_PPU_EVENTS;
 
-uint8_t* CPPU::m_PPUmemory = NULL;
-uint8_t  CPPU::m_PALETTEmemory [] = { 0, };
-uint8_t* CPPU::m_pPPUmemory [] = { NULL, };
-uint8_t  CPPU::m_oamAddr = 0x00;
-int32_t  CPPU::m_ppuRegByte = 0;
-uint16_t CPPU::m_ppuAddr = 0x0000;
-uint8_t  CPPU::m_ppuAddrIncrement = 1;
-uint16_t CPPU::m_ppuAddrLatch = 0x0000;
-uint8_t  CPPU::m_ppuReadLatch = 0x00;
-uint8_t  CPPU::m_ppuIOLatch = 0x00;
-uint8_t  CPPU::m_ppuIOLatchDecayFrames [] = { 0, };
-uint8_t  CPPU::m_PPUreg [] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
-uint8_t  CPPU::m_PPUoam [] = { 0x00, };
-uint8_t  CPPU::m_ppuScrollX = 0x00;
-int32_t        CPPU::m_oneScreen = -1;
-bool           CPPU::m_extraVRAM = false;
-
-uint32_t   CPPU::m_cycles = 0;
-
-uint32_t CPPU::startVblank;
-uint32_t CPPU::quietScanlines;
-uint32_t CPPU::vblankScanlines;
-uint32_t CPPU::vblankEndCycle;
-uint32_t CPPU::prerenderScanline;
-uint32_t CPPU::cycleRatio;
-uint32_t CPPU::memoryDecayFrames;
-
-bool           CPPU::m_vblankChoked = false;
-bool           CPPU::m_nmiChoked = false;
-bool           CPPU::m_nmiReenabled = false;
-
-int8_t*          CPPU::m_pTV = NULL;
-
-uint32_t       CPPU::m_frame = 0;
-int32_t         CPPU::m_curCycles = 0;
-
-SpriteTemporaryMemory CPPU::m_spriteTemporaryMemory;
-SpriteBuffer          CPPU::m_spriteBuffer;
-
-BackgroundBuffer CPPU::m_bkgndBuffer;
-
-CCodeDataLogger* CPPU::m_logger = NULL;
-
-uint8_t  CPPU::m_last2005x = 0;
-uint8_t  CPPU::m_last2005y = 0;
-uint16_t** CPPU::m_2005x = NULL;
-uint16_t** CPPU::m_2005y = NULL;
-uint8_t  CPPU::m_lastSprite0HitX = 0;
-uint8_t  CPPU::m_lastSprite0HitY = 0;
-uint8_t  CPPU::m_x = 0xFF;
-uint8_t  CPPU::m_y = 0xFF;
-
-static CPPU __init __attribute__((unused));
-
-CPPU::CPPU()
+CPPU::State::State ()
 {
    int idx;
 
+   memset ( &m_spriteTemporaryMemory, 0, sizeof(m_spriteTemporaryMemory) );
+   memset ( &m_spriteBuffer, 0, sizeof(m_spriteBuffer) );
+   memset ( &m_bkgndBuffer, 0, sizeof(m_bkgndBuffer) );
+   memset ( &m_bkgndTemp, 0, sizeof(m_bkgndTemp) );
+   memset ( &m_spriteDevNull, 0, sizeof(m_spriteDevNull) );
+
    m_logger = new CCodeDataLogger ( MEM_16KB, MASK_16KB );
 
    m_2005x = new uint16_t*[256];
    for ( idx = 0; idx < 256; idx++ )
    {
-      m_2005x[idx] = new uint16_t[240];
+      m_2005x[idx] = new uint16_t[240]();
    }
    m_2005y = new uint16_t*[256];
    for ( idx = 0; idx < 256; idx++ )
    {
-      m_2005y[idx] = new uint16_t[240];
+      m_2005y[idx] = new uint16_t[240]();
    }
 
-   m_PPUmemory = new uint8_t[MEM_4KB];
+   m_PPUmemory = new uint8_t[MEM_4KB]();
 
    // Set up default mapping.
    for ( idx = 0; idx < 8; idx++ )
@@ -746,7 +699,7 @@ CPPU::CPPU()
    }
 }
 
-CPPU::~CPPU()
+CPPU::State::~State ()
 {
    int idx;
 
@@ -765,118 +718,121 @@ CPPU::~CPPU()
    delete [] m_PPUmemory;
 }
 
+template <class HOOKS>
 void CPPU::EMULATE(uint32_t cycles)
 {
    uint32_t idxx = 0xffffffff;
    uint32_t idxy = 0xffffffff;
+   uint32_t dot = STATE()->m_cycles%PPU_CYCLES_PER_SCANLINE;
+   uint32_t line = STATE()->m_cycles/PPU_CYCLES_PER_SCANLINE;
 
    for ( ; cycles > 0; cycles-- )
    {
-      // Get VBLANK raster position.
-      if ( m_cycles >= startVblank )
+      // Get VBLANK raster position.  Once inside VBLANK it is stepped
+      // along with the frame raster position below.
+      if ( (idxy == 0xffffffff) && (STATE()->m_cycles >= STATE()->startVblank) )
       {
-         idxy = (m_cycles-startVblank)/PPU_CYCLES_PER_SCANLINE;
-         idxx = (m_cycles-startVblank)%PPU_CYCLES_PER_SCANLINE;
+         idxy = (STATE()->m_cycles-STATE()->startVblank)/PPU_CYCLES_PER_SCANLINE;
+         idxx = (STATE()->m_cycles-STATE()->startVblank)%PPU_CYCLES_PER_SCANLINE;
       }
 
       // We're emulating one PPU cycle...
-      m_curCycles += CPU_CYCLE_ADJUST;
+      STATE()->m_curCycles += CPU_CYCLE_ADJUST;
 
       // Update PPU address from latch at appropriate times...
       // Re-latch PPU address...
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         if ( ((m_cycles%PPU_CYCLES_PER_SCANLINE) == 257) &&
-               ((m_cycles/PPU_CYCLES_PER_SCANLINE) < SCANLINES_VISIBLE) )
+         if ( (dot == 257) && (line < SCANLINES_VISIBLE) )
          {
-            m_ppuAddr &= 0xFBE0;
-            m_ppuAddr |= m_ppuAddrLatch&0x41F;
+            STATE()->m_ppuAddr &= 0xFBE0;
+            STATE()->m_ppuAddr |= STATE()->m_ppuAddrLatch&0x41F;
          }
-         else if ( ((m_cycles%PPU_CYCLES_PER_SCANLINE) == 304) &&
-                   ((m_cycles/PPU_CYCLES_PER_SCANLINE) == prerenderScanline) )
+         else if ( (dot == 304) && (line == STATE()->prerenderScanline) )
          {
-            m_ppuAddr = m_ppuAddrLatch;
+            STATE()->m_ppuAddr = STATE()->m_ppuAddrLatch;
          }
-         else if ( (m_cycles/PPU_CYCLES_PER_SCANLINE) < SCANLINES_VISIBLE )
+         else if ( line < SCANLINES_VISIBLE )
          {
-            if ( (m_cycles%PPU_CYCLES_PER_SCANLINE) == 251 )
+            if ( dot == 251 )
             {
-               if ( (m_ppuAddr&0x7000) == 0x7000 )
+               if ( (STATE()->m_ppuAddr&0x7000) == 0x7000 )
                {
-                  m_ppuAddr &= 0x8FFF;
+                  STATE()->m_ppuAddr &= 0x8FFF;
 
-                  if ( (m_ppuAddr&0x03E0) == 0x03A0 )
+                  if ( (STATE()->m_ppuAddr&0x03E0) == 0x03A0 )
                   {
-                     m_ppuAddr ^= 0x0800;
-                     m_ppuAddr &= 0xFC1F;
+                     STATE()->m_ppuAddr ^= 0x0800;
+                     STATE()->m_ppuAddr &= 0xFC1F;
                   }
                   else
                   {
-                     if ( (m_ppuAddr&0x03E0) == 0x03E0 )
+                     if ( (STATE()->m_ppuAddr&0x03E0) == 0x03E0 )
                      {
-                        m_ppuAddr &= 0xFC1F;
+                        STATE()->m_ppuAddr &= 0xFC1F;
                      }
                      else
                      {
-                        m_ppuAddr += 0x0020;
+                        STATE()->m_ppuAddr += 0x0020;
                      }
                   }
                }
                else
                {
-                  m_ppuAddr += 0x1000;
+                  STATE()->m_ppuAddr += 0x1000;
                }
             }
 
-            if ( (((m_cycles%PPU_CYCLES_PER_SCANLINE)%8) == 3) &&
-                  (((m_cycles%PPU_CYCLES_PER_SCANLINE) < 256) ||
-                   ((m_cycles%PPU_CYCLES_PER_SCANLINE) == 323) ||
-                   ((m_cycles%PPU_CYCLES_PER_SCANLINE) == 331)) )
+            if ( ((dot&7) == 3) &&
+                  ((dot < 256) || (dot == 323) || (dot == 331)) )
             {
-               if ( (m_ppuAddr&0x001F) != 0x001F )
+               if ( (STATE()->m_ppuAddr&0x001F) != 0x001F )
                {
-                  m_ppuAddr++;
+                  STATE()->m_ppuAddr++;
                }
                else
                {
-                  m_ppuAddr ^= 0x041F;
+                  STATE()->m_ppuAddr ^= 0x041F;
                }
             }
          }
       }
 
       // Run 0 or 1 CPU cycles...
-      C6502::EMULATE ( m_curCycles/cycleRatio );
+      if ( STATE()->m_curCycles >= (int32_t)STATE()->cycleRatio )
+      {
+         C6502::EMULATE<HOOKS> ( 1 );
 
-      // Adjust current cycle count...
-      m_curCycles %= cycleRatio;
+         // Adjust current cycle count...
+         STATE()->m_curCycles -= STATE()->cycleRatio;
+      }
 
       // Turn off NMI choking if it shouldn't be...
-      if ( m_cycles > startVblank+1 )
+      if ( STATE()->m_cycles > STATE()->startVblank+1 )
       {
          NMICHOKED ( false );
       }
 
       // Turn off NMI re-enablement if it shouldn't be...
-      if ( m_cycles > vblankEndCycle )
+      if ( STATE()->m_cycles > STATE()->vblankEndCycle )
       {
          NMIREENABLED ( false );
       }
 
-      if ( nesIsDebuggable() )
+      if ( HOOKS::ENABLED() )
       {
          // Check for breakpoints...
-         CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUCycle );
+         HOOKS::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUCycle );
       }
 
       if ( (rPPU(PPUCTRL)&PPUCTRL_GENERATE_NMI) &&
             (((!NMICHOKED()) && (idxy == 0) && (idxx == 1)) ||
-             ((NMIREENABLED()) && (idxy <= vblankScanlines-1) && (idxx < PPU_CYCLES_PER_SCANLINE-1))) )
+             ((NMIREENABLED()) && (idxy <= STATE()->vblankScanlines-1) && (idxx < PPU_CYCLES_PER_SCANLINE-1))) )
       {
          C6502::ASSERTNMI ();
 
          // Check for PPU NMI breakpoint...
-         CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, 0, PPU_EVENT_NMI );
+         HOOKS::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, 0, PPU_EVENT_NMI );
       }
 
       // Clear OAM at appropriate point...
@@ -885,15 +841,39 @@ void CPPU::EMULATE(uint32_t cycles)
       if ( (rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) == (PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES)) &&
            (idxy == 19) && (idxx == 316) )
       {
-         m_oamAddr = 0x00;
+         STATE()->m_oamAddr = 0x00;
       }
 
       // Internal cycle counter keeps track of stuff needing to happen
       // at particular PPU frame cycles.  It is reset at the end of a frame.
-      m_cycles++;
+      STATE()->m_cycles++;
+
+      // Step the raster positions without dividing every cycle...
+      if ( (++dot) == PPU_CYCLES_PER_SCANLINE )
+      {
+         dot = 0;
+         line++;
+      }
+      if ( (idxy != 0xffffffff) && ((++idxx) == PPU_CYCLES_PER_SCANLINE) )
+      {
+         idxx = 0;
+         idxy++;
+      }
    }
 }
 
+// The debugger accesses are never traced so they need no hooks.
+uint32_t CPPU::_MEM ( uint32_t addr )
+{
+   return LOAD<NESNoDebugHooks>(addr,0,0,false);
+}
+
+void CPPU::_MEM ( uint32_t addr, uint8_t data )
+{
+   STORE<NESNoDebugHooks>(addr,data,0,0,false);
+}
+
+template <class HOOKS>
 uint32_t CPPU::LOAD ( uint32_t addr, int8_t source, int8_t type, bool trace )
 {
    uint8_t data = 0xFF;
@@ -905,9 +885,9 @@ uint32_t CPPU::LOAD ( uint32_t addr, int8_t source, int8_t type, bool trace )
       data = CROM::CHRMEM ( addr );
 
       // Add Tracer sample...
-      if ( nesIsDebuggable() && trace )
+      if ( HOOKS::ENABLED() && trace )
       {
-         CNES::TRACER()->AddSample ( m_cycles, type, source, eTarget_PatternMemory, addr, data );
+         CNES::TRACER()->AddSample ( STATE()->m_cycles, type, source, eTarget_PatternMemory, addr, data );
       }
 
       return data;
@@ -917,12 +897,12 @@ uint32_t CPPU::LOAD ( uint32_t addr, int8_t source, int8_t type, bool trace )
    {
       if ( addr >= 0x3F00 )
       {
-         data = *(m_PALETTEmemory+(addr&0x1F));
+         data = *(STATE()->m_PALETTEmemory+(addr&0x1F));
 
          // Add Tracer sample...
-         if ( nesIsDebuggable() && trace )
+         if ( HOOKS::ENABLED() && trace )
          {
-            CNES::TRACER()->AddSample ( m_cycles, type, source, eTarget_Palette, addr, data );
+            CNES::TRACER()->AddSample ( STATE()->m_cycles, type, source, eTarget_Palette, addr, data );
          }
 
          return data;
@@ -931,24 +911,25 @@ uint32_t CPPU::LOAD ( uint32_t addr, int8_t source, int8_t type, bool trace )
       addr &= 0xEFFF;
    }
 
-   data = *((*(m_pPPUmemory+((addr&0x1FFF)>>10)))+(addr&0x3FF));
+   data = *((*(STATE()->m_pPPUmemory+((addr&0x1FFF)>>10)))+(addr&0x3FF));
 
    // Add Tracer sample...
-   if ( nesIsDebuggable() && trace )
+   if ( HOOKS::ENABLED() && trace )
    {
       if ( (addr&0x3FF) < 0x3C0 )
       {
-         CNES::TRACER()->AddSample ( m_cycles, type, source, eTarget_NameTable, addr, data );
+         CNES::TRACER()->AddSample ( STATE()->m_cycles, type, source, eTarget_NameTable, addr, data );
       }
       else
       {
-         CNES::TRACER()->AddSample ( m_cycles, type, source, eTarget_AttributeTable, addr, data );
+         CNES::TRACER()->AddSample ( STATE()->m_cycles, type, source, eTarget_AttributeTable, addr, data );
       }
    }
 
    return data;
 }
 
+template <class HOOKS>
 void CPPU::STORE ( uint32_t addr, uint8_t data, int8_t source, int8_t type, bool trace )
 {
    addr &= 0x3FFF;
@@ -956,9 +937,9 @@ void CPPU::STORE ( uint32_t addr, uint8_t data, int8_t source, int8_t type, bool
    if ( addr < 0x2000 )
    {
       // Add Tracer sample...
-      if ( nesIsDebuggable() && trace )
+      if ( HOOKS::ENABLED() && trace )
       {
-         CNES::TRACER()->AddSample ( m_cycles, type, source, eTarget_PatternMemory, addr, data );
+         CNES::TRACER()->AddSample ( STATE()->m_cycles, type, source, eTarget_PatternMemory, addr, data );
       }
 
       if ( CROM::IsWriteProtected() == false )
@@ -974,19 +955,19 @@ void CPPU::STORE ( uint32_t addr, uint8_t data, int8_t source, int8_t type, bool
       if ( addr >= 0x3F00 )
       {
          // Add Tracer sample...
-         if ( nesIsDebuggable() && trace )
+         if ( HOOKS::ENABLED() && trace )
          {
-            CNES::TRACER()->AddSample ( m_cycles, type, source, eTarget_Palette, addr, data );
+            CNES::TRACER()->AddSample ( STATE()->m_cycles, type, source, eTarget_Palette, addr, data );
          }
 
          if ( !(addr&0xF) )
          {
-            *(m_PALETTEmemory+0x00) = data;
-            *(m_PALETTEmemory+0x10) = data;
+            *(STATE()->m_PALETTEmemory+0x00) = data;
+            *(STATE()->m_PALETTEmemory+0x10) = data;
          }
          else
          {
-            *(m_PALETTEmemory+(addr&0x1F)) = data;
+            *(STATE()->m_PALETTEmemory+(addr&0x1F)) = data;
          }
 
          return;
@@ -996,136 +977,139 @@ void CPPU::STORE ( uint32_t addr, uint8_t data, int8_t source, int8_t type, bool
    }
 
    // Add Tracer sample...
-   if ( nesIsDebuggable() && trace )
+   if ( HOOKS::ENABLED() && trace )
    {
       if ( (addr&0x3FF) < 0x3C0 )
       {
-         CNES::TRACER()->AddSample ( m_cycles, type, source, eTarget_NameTable, addr, data );
+         CNES::TRACER()->AddSample ( STATE()->m_cycles, type, source, eTarget_NameTable, addr, data );
       }
       else
       {
-         CNES::TRACER()->AddSample ( m_cycles, type, source, eTarget_AttributeTable, addr, data );
+         CNES::TRACER()->AddSample ( STATE()->m_cycles, type, source, eTarget_AttributeTable, addr, data );
       }
    }
 
-   *((*(m_pPPUmemory+((addr&0x1FFF)>>10)))+(addr&0x3FF)) = data;
+   *((*(STATE()->m_pPPUmemory+((addr&0x1FFF)>>10)))+(addr&0x3FF)) = data;
 }
 
+template <class HOOKS>
 uint32_t CPPU::RENDER ( uint32_t addr, int8_t target )
 {
    uint32_t data;
 
-   data = LOAD ( addr, eNESSource_PPU, target );
+   data = LOAD<HOOKS> ( addr, eNESSource_PPU, target );
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
-      m_logger->LogAccess ( C6502::_CYCLES()/*m_cycles*/, addr, data, eLogger_DataRead, eNESSource_PPU );
+      STATE()->m_logger->LogAccess ( C6502::_CYCLES()/*m_cycles*/, addr, data, eLogger_DataRead, eNESSource_PPU );
    }
 
    // Provide PPU cycle and address to mappers that watch such things!
-   MAPPERFUNC->sync_ppu(m_cycles,addr);
+   MAPPERFUNC->sync_ppu(STATE()->m_cycles,addr);
 
    // Address/Data bus multiplexed thus 2 cycles required per access...
-   EMULATE(1);
+   EMULATE<HOOKS>(1);
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Check for PPU address breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, rPPUADDR(), PPU_EVENT_ADDRESS_EQUALS );
+      HOOKS::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, rPPUADDR(), PPU_EVENT_ADDRESS_EQUALS );
 
       // Check for breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUFetch, data );
+      HOOKS::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUFetch, data );
    }
 
    return data;
 }
 
+template <class HOOKS>
 void CPPU::GARBAGE ( uint32_t addr, int8_t target )
 {
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
-      CNES::TRACER()->AddGarbageFetch ( m_cycles, target, addr );
+      CNES::TRACER()->AddGarbageFetch ( STATE()->m_cycles, target, addr );
    }
 
    // Provide PPU cycle and address to mappers that watch such things!
-   MAPPERFUNC->sync_ppu(m_cycles,addr);
+   MAPPERFUNC->sync_ppu(STATE()->m_cycles,addr);
 
    // Address/Data bus multiplexed thus 2 cycles required per access...
-   EMULATE(1);
+   EMULATE<HOOKS>(1);
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Check for PPU address breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, rPPUADDR(), PPU_EVENT_ADDRESS_EQUALS );
+      HOOKS::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, rPPUADDR(), PPU_EVENT_ADDRESS_EQUALS );
 
       // Check for breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUFetch );
+      HOOKS::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUFetch );
    }
 }
 
+template <class HOOKS>
 void CPPU::EXTRA ()
 {
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
-      CNES::TRACER()->AddGarbageFetch ( m_cycles, eTarget_ExtraCycle, 0 );
+      CNES::TRACER()->AddGarbageFetch ( STATE()->m_cycles, eTarget_ExtraCycle, 0 );
    }
 
    // Idle cycle...
-   EMULATE(1);
+   EMULATE<HOOKS>(1);
 
-   if ( nesIsDebuggable() )
+   if ( HOOKS::ENABLED() )
    {
       // Check for PPU address breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, rPPUADDR(), PPU_EVENT_ADDRESS_EQUALS );
+      HOOKS::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, rPPUADDR(), PPU_EVENT_ADDRESS_EQUALS );
 
       // Check for breakpoint...
-      CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUFetch );
+      HOOKS::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUFetch );
    }
 }
 
 void CPPU::RESET ( bool soft )
 {
-   startVblank = (CNES::VIDEOMODE()==MODE_NTSC)?PPU_CYCLE_START_VBLANK_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?PPU_CYCLE_START_VBLANK_PAL:PPU_CYCLE_START_VBLANK_DENDY;
-   quietScanlines = (CNES::VIDEOMODE()==MODE_NTSC)?SCANLINES_QUIET_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?SCANLINES_QUIET_PAL:SCANLINES_QUIET_DENDY;
-   vblankScanlines = (CNES::VIDEOMODE()==MODE_NTSC)?SCANLINES_VBLANK_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?SCANLINES_VBLANK_PAL:SCANLINES_VBLANK_DENDY;
-   vblankEndCycle = (CNES::VIDEOMODE()==MODE_NTSC)?PPU_CYCLE_END_VBLANK_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?PPU_CYCLE_END_VBLANK_PAL:PPU_CYCLE_END_VBLANK_DENDY;
-   prerenderScanline = (CNES::VIDEOMODE()==MODE_NTSC)?SCANLINE_PRERENDER_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?SCANLINE_PRERENDER_PAL:SCANLINE_PRERENDER_DENDY;
-   cycleRatio = (CNES::VIDEOMODE()==MODE_NTSC)?PPU_CPU_RATIO_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?PPU_CPU_RATIO_PAL:PPU_CPU_RATIO_DENDY;
-   memoryDecayFrames = (CNES::VIDEOMODE()==MODE_NTSC)?PPU_DECAY_FRAME_COUNT_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?PPU_DECAY_FRAME_COUNT_PAL:PPU_DECAY_FRAME_COUNT_DENDY;
-
-   m_PPUreg [ 0 ] = 0x00;
-   m_PPUreg [ 1 ] = 0x00;
-   m_PPUreg [ 2 ] = 0x00;
-
-   m_frame = 0;
-   m_cycles = 0;
-   m_curCycles = 0;
-
-   m_vblankChoked = false;
-   m_nmiChoked = false;
-   m_nmiReenabled = false;
-
-   m_ppuAddr = 0x0000;
-   m_ppuAddrLatch = 0x0000;
-   m_ppuAddrIncrement = 1;
-   m_ppuReadLatch = 0x00;
-   m_ppuRegByte = 0;
-   m_ppuIOLatch = 0x00;
-   m_ppuIOLatchDecayFrames [ 0 ] = 0;
-   m_ppuIOLatchDecayFrames [ 1 ] = 0;
-   m_ppuIOLatchDecayFrames [ 2 ] = 0;
-   m_ppuIOLatchDecayFrames [ 3 ] = 0;
-   m_ppuIOLatchDecayFrames [ 4 ] = 0;
-   m_ppuIOLatchDecayFrames [ 5 ] = 0;
-   m_ppuIOLatchDecayFrames [ 6 ] = 0;
-   m_ppuIOLatchDecayFrames [ 7 ] = 0;
-
-   m_spriteTemporaryMemory.count = 0;
-   m_spriteTemporaryMemory.yByte = SPRITEY;
-   m_spriteTemporaryMemory.rolling = 0;
-
-   m_lastSprite0HitX = 0;
-   m_lastSprite0HitY = 0;
+   STATE()->startVblank = (CNES::VIDEOMODE()==MODE_NTSC)?PPU_CYCLE_START_VBLANK_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?PPU_CYCLE_START_VBLANK_PAL:PPU_CYCLE_START_VBLANK_DENDY;
+   STATE()->quietScanlines = (CNES::VIDEOMODE()==MODE_NTSC)?SCANLINES_QUIET_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?SCANLINES_QUIET_PAL:SCANLINES_QUIET_DENDY;
+   STATE()->vblankScanlines = (CNES::VIDEOMODE()==MODE_NTSC)?SCANLINES_VBLANK_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?SCANLINES_VBLANK_PAL:SCANLINES_VBLANK_DENDY;
+   STATE()->vblankEndCycle = (CNES::VIDEOMODE()==MODE_NTSC)?PPU_CYCLE_END_VBLANK_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?PPU_CYCLE_END_VBLANK_PAL:PPU_CYCLE_END_VBLANK_DENDY;
+   STATE()->prerenderScanline = (CNES::VIDEOMODE()==MODE_NTSC)?SCANLINE_PRERENDER_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?SCANLINE_PRERENDER_PAL:SCANLINE_PRERENDER_DENDY;
+   STATE()->cycleRatio = (CNES::VIDEOMODE()==MODE_NTSC)?PPU_CPU_RATIO_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?PPU_CPU_RATIO_PAL:PPU_CPU_RATIO_DENDY;
+   STATE()->memoryDecayFrames = (CNES::VIDEOMODE()==MODE_NTSC)?PPU_DECAY_FRAME_COUNT_NTSC:(CNES::VIDEOMODE()==MODE_PAL)?PPU_DECAY_FRAME_COUNT_PAL:PPU_DECAY_FRAME_COUNT_DENDY;
+
+   STATE()->m_PPUreg [ 0 ] = 0x00;
+   STATE()->m_PPUreg [ 1 ] = 0x00;
+   STATE()->m_PPUreg [ 2 ] = 0x00;
+
+   STATE()->m_frame = 0;
+   STATE()->m_cycles = 0;
+   STATE()->m_curCycles = 0;
+
+   STATE()->m_vblankChoked = false;
+   STATE()->m_nmiChoked = false;
+   STATE()->m_nmiReenabled = false;
+
+   STATE()->m_ppuAddr = 0x0000;
+   STATE()->m_ppuAddrLatch = 0x0000;
+   STATE()->m_ppuAddrIncrement = 1;
+   STATE()->m_ppuReadLatch = 0x00;
+   STATE()->m_ppuRegByte = 0;
+   STATE()->m_ppuIOLatch = 0x00;
+   STATE()->m_ppuIOLatchDecayFrames [ 0 ] = 0;
+   STATE()->m_ppuIOLatchDecayFrames [ 1 ] = 0;
+   STATE()->m_ppuIOLatchDecayFrames [ 2 ] = 0;
+   STATE()->m_ppuIOLatchDecayFrames [ 3 ] = 0;
+   STATE()->m_ppuIOLatchDecayFrames [ 4 ] = 0;
+   STATE()->m_ppuIOLatchDecayFrames [ 5 ] = 0;
+   STATE()->m_ppuIOLatchDecayFrames [ 6 ] = 0;
+   STATE()->m_ppuIOLatchDecayFrames [ 7 ] = 0;
+
+   STATE()->m_spriteTemporaryMemory.count = 0;
+   STATE()->m_spriteTemporaryMemory.yByte = SPRITEY;
+   STATE()->m_spriteTemporaryMemory.rolling = 0;
+
+   STATE()->m_lastSprite0HitX = 0;
+   STATE()->m_lastSprite0HitY = 0;
 
    // Set up default palette in a way that passes the default palette test.
    PALETTESET ( tblDefaultPalette );
@@ -1138,34 +1122,178 @@ void CPPU::RESET ( bool soft )
    }
 }
 
+template <class STREAM>
+void CPPU::STATEDATA ( STREAM& stream )
+{
+   stream.BYTES ( STATE()->m_PALETTEmemory, sizeof(STATE()->m_PALETTEmemory) );
+   stream.VALUE ( STATE()->m_ppuRegByte );
+   stream.VALUE ( STATE()->startVblank );
+   stream.VALUE ( STATE()->quietScanlines );
+   stream.VALUE ( STATE()->vblankScanlines );
+   stream.VALUE ( STATE()->vblankEndCycle );
+   stream.VALUE ( STATE()->prerenderScanline );
+   stream.VALUE ( STATE()->cycleRatio );
+   stream.VALUE ( STATE()->memoryDecayFrames );
+   stream.VALUE ( STATE()->m_oamAddr );
+   stream.VALUE ( STATE()->m_ppuAddr );
+   stream.VALUE ( STATE()->m_ppuAddrLatch );
+   stream.VALUE ( STATE()->m_ppuAddrIncrement );
+   stream.VALUE ( STATE()->m_ppuReadLatch );
+   stream.VALUE ( STATE()->m_ppuIOLatch );
+   stream.BYTES ( STATE()->m_ppuIOLatchDecayFrames, sizeof(STATE()->m_ppuIOLatchDecayFrames) );
+   stream.BYTES ( STATE()->m_PPUreg, sizeof(STATE()->m_PPUreg) );
+   stream.BYTES ( STATE()->m_PPUoam, sizeof(STATE()->m_PPUoam) );
+   stream.VALUE ( STATE()->m_ppuScrollX );
+   stream.VALUE ( STATE()->m_oneScreen );
+   stream.VALUE ( STATE()->m_extraVRAM );
+   stream.VALUE ( STATE()->m_cycles );
+   stream.VALUE ( STATE()->m_frame );
+   stream.VALUE ( STATE()->m_curCycles );
+   stream.VALUE ( STATE()->m_vblankChoked );
+   stream.VALUE ( STATE()->m_nmiChoked );
+   stream.VALUE ( STATE()->m_nmiReenabled );
+   stream.VALUE ( STATE()->m_spriteTemporaryMemory );
+   stream.VALUE ( STATE()->m_spriteBuffer );
+   stream.VALUE ( STATE()->m_bkgndBuffer );
+   stream.VALUE ( STATE()->m_bkgndPatternIdx );
+   stream.VALUE ( STATE()->m_bkgndTemp );
+   stream.VALUE ( STATE()->m_spriteDevNull );
+   stream.VALUE ( STATE()->m_spritesFound );
+   stream.BYTES ( STATE()->m_spriteLine, sizeof(STATE()->m_spriteLine) );
+   stream.VALUE ( STATE()->m_pixelX );
+   stream.VALUE ( STATE()->m_pixelDue );
+   stream.VALUE ( STATE()->m_last2005x );
+   stream.VALUE ( STATE()->m_last2005y );
+   stream.VALUE ( STATE()->m_lastSprite0HitX );
+   stream.VALUE ( STATE()->m_lastSprite0HitY );
+   stream.VALUE ( STATE()->m_x );
+   stream.VALUE ( STATE()->m_y );
+   stream.MEMORY ( STATE()->m_PPUmemory, MEM_4KB );
+}
+
+void CPPU::SAVESTATE ( CNESStateWriter& writer )
+{
+   uint8_t* point;
+   int32_t  idx;
+
+   writer.BEGIN ( "PPU ", 1 );
+   STATEDATA ( writer );
+
+   // Nametables are saved as an offset into PPU memory or, for mappers
+   // that map CHR memory into the nametables, as 0x10000 plus the CHR bank.
+   for ( idx = 0; idx < 8; idx++ )
+   {
+      point = STATE()->m_pPPUmemory[idx];
+      if ( (point >= STATE()->m_PPUmemory) && (point < STATE()->m_PPUmemory+MEM_4KB) )
+      {
+         writer.VALUE<int32_t> ( point-STATE()->m_PPUmemory );
+      }
+      else
+      {
+         writer.VALUE<int32_t> ( 0x10000+CROM::CHRBANK(point) );
+      }
+   }
+
+   // Sprite evaluation is either into the temporary memory or off to nowhere.
+   if ( STATE()->m_pSpriteEval == &STATE()->m_spriteDevNull )
+   {
+      writer.VALUE<int32_t> ( -1 );
+   }
+   else
+   {
+      writer.VALUE<int32_t> ( STATE()->m_pSpriteEval-STATE()->m_spriteTemporaryMemory.data );
+   }
+
+   // The non-debug renderer's position on the TV.
+   if ( STATE()->m_pTV && STATE()->m_pPixelTV )
+   {
+      writer.VALUE<int32_t> ( STATE()->m_pPixelTV-STATE()->m_pTV );
+   }
+   else
+   {
+      writer.VALUE<int32_t> ( -1 );
+   }
+   writer.END ();
+}
+
+bool CPPU::LOADSTATE ( CNESStateReader& reader )
+{
+   uint8_t* pPPUmemory [ 8 ];
+   uint16_t version;
+   int32_t  value;
+   int32_t  idx;
+
+   if ( (!reader.FIND("PPU ",&version)) || (version != 1) )
+   {
+      return false;
+   }
+   STATEDATA ( reader );
+
+   for ( idx = 0; idx < 8; idx++ )
+   {
+      reader.VALUE ( value );
+      if ( (value >= 0) && (value < MEM_4KB) )
+      {
+         pPPUmemory[idx] = STATE()->m_PPUmemory+value;
+      }
+      else if ( !(pPPUmemory[idx] = CROM::CHRBANK(value-0x10000)) )
+      {
+         return false;
+      }
+   }
+   memcpy(STATE()->m_pPPUmemory,pPPUmemory,sizeof(pPPUmemory));
+
+   reader.VALUE ( value );
+   if ( (value < -1) || (value >= NUM_SPRITES_PER_SCANLINE) )
+   {
+      return false;
+   }
+   STATE()->m_pSpriteEval = (value >= 0)?STATE()->m_spriteTemporaryMemory.data+value:&STATE()->m_spriteDevNull;
+
+   reader.VALUE ( value );
+   if ( (value < -1) || (value >= (256*240)<<2) )
+   {
+      return false;
+   }
+   STATE()->m_pPixelTV = ((value >= 0) && STATE()->m_pTV)?STATE()->m_pTV+value:NULL;
+
+   return reader.GOOD();
+}
+
 uint32_t CPPU::PPU ( uint32_t addr )
 {
    uint8_t data = 0xFF;
    uint16_t fixAddr;
    uint16_t oldPpuAddr;
 
+   // Catch the screen up to the CPU before it looks at the PPU...
+   if ( STATE()->m_pixelX < STATE()->m_pixelDue )
+   {
+      RENDERPIXELS ();
+   }
+
    fixAddr = addr&0x0007;
 
    if ( fixAddr == PPUSTATUS_REG )
    {
-      data = *(m_PPUreg+fixAddr);
-      *(m_PPUreg+fixAddr) &= (~PPUSTATUS_VBLANK); // VBLANK clear-on-read
-      m_ppuRegByte = 0; // Clear PPUADDR address latch
-      data = (data&0xE0)|(m_ppuIOLatch&0x1F);
+      data = *(STATE()->m_PPUreg+fixAddr);
+      *(STATE()->m_PPUreg+fixAddr) &= (~PPUSTATUS_VBLANK); // VBLANK clear-on-read
+      STATE()->m_ppuRegByte = 0; // Clear PPUADDR address latch
+      data = (data&0xE0)|(STATE()->m_ppuIOLatch&0x1F);
 
       // Refresh I/O latch...
-      m_ppuIOLatch &= (0x1F);
-      m_ppuIOLatch |= (data&0xE0);
+      STATE()->m_ppuIOLatch &= (0x1F);
+      STATE()->m_ppuIOLatch |= (data&0xE0);
 
       // Kill VBLANK flag if register is read at 'wrong' time...
-      if ( m_cycles == startVblank-1 )
+      if ( STATE()->m_cycles == STATE()->startVblank-1 )
       {
          VBLANKCHOKED ( true );
       }
 
       // Kill NMI assertion if register is read at 'wrong' time...
-      if ( (m_cycles >= startVblank-1) &&
-            (m_cycles <= startVblank+1) )
+      if ( (STATE()->m_cycles >= STATE()->startVblank-1) &&
+            (STATE()->m_cycles <= STATE()->startVblank+1) )
       {
          NMICHOKED ( true );
       }
@@ -1175,10 +1303,10 @@ uint32_t CPPU::PPU ( uint32_t addr )
       uint8_t mask[4] = { 0xFF, 0xFF, 0xE3, 0xFF };
 
       // Third sprite byte should be masked with E3 on read.
-      data = (*(m_PPUoam+m_oamAddr))&mask[m_oamAddr&0x3];
+      data = (*(STATE()->m_PPUoam+STATE()->m_oamAddr))&mask[STATE()->m_oamAddr&0x3];
 
       // Refresh I/O latch...
-      m_ppuIOLatch = data;
+      STATE()->m_ppuIOLatch = data;
 
       if ( nesIsDebuggable() )
       {
@@ -1188,35 +1316,35 @@ uint32_t CPPU::PPU ( uint32_t addr )
    }
    else if ( fixAddr == PPUDATA_REG )
    {
-      oldPpuAddr = m_ppuAddr;
+      oldPpuAddr = STATE()->m_ppuAddr;
 
-      m_ppuAddr += m_ppuAddrIncrement;
+      STATE()->m_ppuAddr += STATE()->m_ppuAddrIncrement;
 
       if ( oldPpuAddr < 0x3F00 )
       {
-         data = m_ppuReadLatch;
+         data = STATE()->m_ppuReadLatch;
 
          // Refresh I/O latch...
-         m_ppuIOLatch = data;
+         STATE()->m_ppuIOLatch = data;
 
-         m_ppuReadLatch = LOAD ( oldPpuAddr, eNESSource_CPU, eTracer_DataRead );
+         STATE()->m_ppuReadLatch = LOAD<HOOKS> ( oldPpuAddr, eNESSource_CPU, eTracer_DataRead );
       }
       else
       {
-         data = LOAD ( oldPpuAddr, eNESSource_CPU, eTracer_DataRead );
+         data = LOAD<HOOKS> ( oldPpuAddr, eNESSource_CPU, eTracer_DataRead );
 
          // Mask off unused palette RAM bits.
          data &= 0x3F;
 
          // Fill in read-latch bits...
-         data |= (m_ppuIOLatch&0xC0);
+         data |= (STATE()->m_ppuIOLatch&0xC0);
 
          // Refresh I/O latch...
-         m_ppuIOLatch &= (0xC0);
-         m_ppuIOLatch |= (data&0x3F);
+         STATE()->m_ppuIOLatch &= (0xC0);
+         STATE()->m_ppuIOLatch |= (data&0x3F);
 
          // Shadow palette/VRAM read, don't use regular LOAD or it will be logged in Tracer...
-         m_ppuReadLatch = *((*(m_pPPUmemory+(((oldPpuAddr&(~0x1000))&0x1FFF)>>10)))+((oldPpuAddr&(~0x1000))&0x3FF));
+         STATE()->m_ppuReadLatch = *((*(STATE()->m_pPPUmemory+(((oldPpuAddr&(~0x1000))&0x1FFF)>>10)))+((oldPpuAddr&(~0x1000))&0x3FF));
       }
 
       if ( nesIsDebuggable() )
@@ -1225,15 +1353,15 @@ uint32_t CPPU::PPU ( uint32_t addr )
          CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUPortalRead, data );
 
          // Log Code/Data logger...
-         m_logger->LogAccess ( C6502::_CYCLES()/*m_cycles*/, oldPpuAddr, data, eLogger_DataRead, eNESSource_CPU );
+         STATE()->m_logger->LogAccess ( C6502::_CYCLES()/*m_cycles*/, oldPpuAddr, data, eLogger_DataRead, eNESSource_CPU );
       }
 
       // Toggling A12 causes IRQ count in some mappers...
-      MAPPERFUNC->sync_ppu(m_cycles,m_ppuAddr);
+      MAPPERFUNC->sync_ppu(STATE()->m_cycles,STATE()->m_ppuAddr);
    }
    else
    {
-      data = m_ppuIOLatch;
+      data = STATE()->m_ppuIOLatch;
    }
 
    if ( nesIsDebuggable() )
@@ -1252,21 +1380,27 @@ void CPPU::PPU ( uint32_t addr, uint8_t data )
    uint8_t  old2000;
    int32_t  bit;
 
+   // Catch the screen up to the CPU before it changes the PPU...
+   if ( STATE()->m_pixelX < STATE()->m_pixelDue )
+   {
+      RENDERPIXELS ();
+   }
+
    // Set I/O latch for bus hold-up emulation...
-   m_ppuIOLatch = data;
+   STATE()->m_ppuIOLatch = data;
 
    // Set crude 'frame counters' for each 1 bit to decay...
    for ( bit = 0; bit < 8; bit++ )
    {
-      if ( m_ppuIOLatch&(1<<bit) )
+      if ( STATE()->m_ppuIOLatch&(1<<bit) )
       {
          // ~600msec
-         m_ppuIOLatchDecayFrames [ bit ] = memoryDecayFrames;
+         STATE()->m_ppuIOLatchDecayFrames [ bit ] = STATE()->memoryDecayFrames;
       }
       else
       {
          // No decay necessary.
-         m_ppuIOLatchDecayFrames [ bit ] = 0;
+         STATE()->m_ppuIOLatchDecayFrames [ bit ] = 0;
       }
    }
 
@@ -1274,8 +1408,8 @@ void CPPU::PPU ( uint32_t addr, uint8_t data )
 
    if ( fixAddr != PPUSTATUS_REG )
    {
-      old2000 = *(m_PPUreg+PPUCTRL_REG);
-      *(m_PPUreg+fixAddr) = data;
+      old2000 = *(STATE()->m_PPUreg+PPUCTRL_REG);
+      *(STATE()->m_PPUreg+fixAddr) = data;
 
       // Check for need to re-assert NMI if NMI is enabled and we're in VBLANK...
       if ( (fixAddr == PPUCTRL_REG) &&
@@ -1289,17 +1423,17 @@ void CPPU::PPU ( uint32_t addr, uint8_t data )
 
    if ( fixAddr == PPUCTRL_REG )
    {
-      m_ppuAddrLatch &= 0x73FF;
-      m_ppuAddrLatch |= ((((uint16_t)data&PPUCTRL_BASE_NAM_TBL_ADDR_MSK))<<10);
-      m_ppuAddrIncrement = (((!!(data&PPUCTRL_VRAM_ADDR_INC))*31)+1);
+      STATE()->m_ppuAddrLatch &= 0x73FF;
+      STATE()->m_ppuAddrLatch |= ((((uint16_t)data&PPUCTRL_BASE_NAM_TBL_ADDR_MSK))<<10);
+      STATE()->m_ppuAddrIncrement = (((!!(data&PPUCTRL_VRAM_ADDR_INC))*31)+1);
    }
    else if ( fixAddr == OAMADDR_REG )
    {
-      m_oamAddr = data;
+      STATE()->m_oamAddr = data;
    }
    else if ( fixAddr == OAMDATA_REG )
    {
-      *(m_PPUoam+m_oamAddr) = data;
+      *(STATE()->m_PPUoam+STATE()->m_oamAddr) = data;
 
       if ( nesIsDebuggable() )
       {
@@ -1307,16 +1441,16 @@ void CPPU::PPU ( uint32_t addr, uint8_t data )
          CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnOAMPortalWrite, data );
       }
 
-      m_oamAddr++;
+      STATE()->m_oamAddr++;
    }
    else if ( fixAddr == PPUSCROLL_REG )
    {
-      if ( m_ppuRegByte )
+      if ( STATE()->m_ppuRegByte )
       {
-         m_last2005y = data;
-         m_ppuAddrLatch &= 0x8C1F;
-         m_ppuAddrLatch |= ((((uint16_t)data&0xF8))<<2);
-         m_ppuAddrLatch |= ((((uint16_t)data&0x07))<<12);
+         STATE()->m_last2005y = data;
+         STATE()->m_ppuAddrLatch &= 0x8C1F;
+         STATE()->m_ppuAddrLatch |= ((((uint16_t)data&0xF8))<<2);
+         STATE()->m_ppuAddrLatch |= ((((uint16_t)data&0x07))<<12);
 
          if ( nesIsDebuggable() )
          {
@@ -1326,10 +1460,10 @@ void CPPU::PPU ( uint32_t addr, uint8_t data )
       }
       else
       {
-         m_last2005x = data;
-         m_ppuScrollX = data&0x07;
-         m_ppuAddrLatch &= 0xFFE0;
-         m_ppuAddrLatch |= ((((uint16_t)data&0xF8))>>3);
+         STATE()->m_last2005x = data;
+         STATE()->m_ppuScrollX = data&0x07;
+         STATE()->m_ppuAddrLatch &= 0xFFE0;
+         STATE()->m_ppuAddrLatch |= ((((uint16_t)data&0xF8))>>3);
 
          if ( nesIsDebuggable() )
          {
@@ -1338,47 +1472,47 @@ void CPPU::PPU ( uint32_t addr, uint8_t data )
          }
       }
 
-      m_ppuRegByte = !m_ppuRegByte;
+      STATE()->m_ppuRegByte = !STATE()->m_ppuRegByte;
    }
    else if ( fixAddr == PPUADDR_REG )
    {
-      if ( m_ppuRegByte )
+      if ( STATE()->m_ppuRegByte )
       {
-         m_ppuAddrLatch &= 0x7F00;
-         m_ppuAddrLatch |= data;
+         STATE()->m_ppuAddrLatch &= 0x7F00;
+         STATE()->m_ppuAddrLatch |= data;
 
-         m_ppuAddr = m_ppuAddrLatch;
+         STATE()->m_ppuAddr = STATE()->m_ppuAddrLatch;
 
          // Toggling A12 causes IRQ count in some mappers...
-         MAPPERFUNC->sync_ppu(m_cycles,m_ppuAddr);
+         MAPPERFUNC->sync_ppu(STATE()->m_cycles,STATE()->m_ppuAddr);
       }
       else
       {
-         m_ppuAddrLatch &= 0x00FF;
-         m_ppuAddrLatch |= ((((uint16_t)data&0x3F))<<8);
+         STATE()->m_ppuAddrLatch &= 0x00FF;
+         STATE()->m_ppuAddrLatch |= ((((uint16_t)data&0x3F))<<8);
       }
 
-      m_ppuRegByte = !m_ppuRegByte;
+      STATE()->m_ppuRegByte = !STATE()->m_ppuRegByte;
    }
    else if ( fixAddr == PPUDATA_REG )
    {
-      STORE ( m_ppuAddr, data, eNESSource_CPU, eTracer_DataWrite );
+      STORE<HOOKS> ( STATE()->m_ppuAddr, data, eNESSource_CPU, eTracer_DataWrite );
 
-      oldPpuAddr = m_ppuAddr;
+      oldPpuAddr = STATE()->m_ppuAddr;
 
       if ( nesIsDebuggable() )
       {
-         m_logger->LogAccess ( C6502::_CYCLES()/*m_cycles*/, oldPpuAddr, data, eLogger_DataWrite, eNESSource_CPU );
+         STATE()->m_logger->LogAccess ( C6502::_CYCLES()/*m_cycles*/, oldPpuAddr, data, eLogger_DataWrite, eNESSource_CPU );
 
          // Check for breakpoint...
          CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUPortalWrite, data );
       }
 
       // Increment PPUADDR
-      m_ppuAddr += m_ppuAddrIncrement;
+      STATE()->m_ppuAddr += STATE()->m_ppuAddrIncrement;
 
       // Toggling A12 causes IRQ count in some mappers...
-      MAPPERFUNC->sync_ppu(m_cycles,m_ppuAddr);
+      MAPPERFUNC->sync_ppu(STATE()->m_cycles,STATE()->m_ppuAddr);
    }
 
    if ( nesIsDebuggable() )
@@ -1390,14 +1524,14 @@ void CPPU::PPU ( uint32_t addr, uint8_t data )
 
 void CPPU::MIRROR ( int32_t oneScreen, bool vert, bool extraVRAM )
 {
-   m_oneScreen = oneScreen;
-   m_extraVRAM = extraVRAM;
+   STATE()->m_oneScreen = oneScreen;
+   STATE()->m_extraVRAM = extraVRAM;
 
-   if ( m_oneScreen >= 0 )
+   if ( STATE()->m_oneScreen >= 0 )
    {
-      MIRROR ( m_oneScreen, m_oneScreen, m_oneScreen, m_oneScreen );
+      MIRROR ( STATE()->m_oneScreen, STATE()->m_oneScreen, STATE()->m_oneScreen, STATE()->m_oneScreen );
    }
-   else if ( m_extraVRAM )
+   else if ( STATE()->m_extraVRAM )
    {
       MIRROR ( 0, 1, 2, 3 );
    }
@@ -1426,51 +1560,53 @@ void CPPU::MIRROR ( int32_t nt1, int32_t nt2, int32_t nt3, int32_t nt4 )
    if ( nt1 >= 0 )
    {
       nt1 &= 0x3;
-      Move1KBank ( 0x8, &(m_PPUmemory[(nt1<<UPSHIFT_1KB)]) );
+      Move1KBank ( 0x8, &(STATE()->m_PPUmemory[(nt1<<UPSHIFT_1KB)]) );
    }
    if ( nt2 >= 0 )
    {
       nt2 &= 0x3;
-      Move1KBank ( 0x9, &(m_PPUmemory[(nt2<<UPSHIFT_1KB)]) );
+      Move1KBank ( 0x9, &(STATE()->m_PPUmemory[(nt2<<UPSHIFT_1KB)]) );
    }
    if ( nt3 >= 0 )
    {
       nt3 &= 0x3;
-      Move1KBank ( 0xA, &(m_PPUmemory[(nt3<<UPSHIFT_1KB)]) );
+      Move1KBank ( 0xA, &(STATE()->m_PPUmemory[(nt3<<UPSHIFT_1KB)]) );
    }
    if ( nt4 >= 0 )
    {
       nt4 &= 0x3;
-      Move1KBank ( 0xB, &(m_PPUmemory[(nt4<<UPSHIFT_1KB)]) );
+      Move1KBank ( 0xB, &(STATE()->m_PPUmemory[(nt4<<UPSHIFT_1KB)]) );
    }
 }
 
+template <class HOOKS>
 void CPPU::QUIETSCANLINES ( void )
 {
    int32_t bit;
 
-   EMULATE(PPU_CYCLES_PER_SCANLINE*quietScanlines);
+   EMULATE<HOOKS>(PPU_CYCLES_PER_SCANLINE*STATE()->quietScanlines);
 
    // Do I/O latch decay...this is just a convenient place to put
    // this decay because this function is called once per frame and
    // the current emulation of PPU register decay is a frame-count.
    for ( bit = 0; bit < 8; bit++ )
    {
-      if ( m_ppuIOLatch&(1<<bit) )
+      if ( STATE()->m_ppuIOLatch&(1<<bit) )
       {
-         if ( m_ppuIOLatchDecayFrames[bit] )
+         if ( STATE()->m_ppuIOLatchDecayFrames[bit] )
          {
-            m_ppuIOLatchDecayFrames[bit]--;
+            STATE()->m_ppuIOLatchDecayFrames[bit]--;
          }
 
-         if ( !(m_ppuIOLatchDecayFrames[bit]) )
+         if ( !(STATE()->m_ppuIOLatchDecayFrames[bit]) )
          {
-            m_ppuIOLatch &= (~(1<<bit));
+            STATE()->m_ppuIOLatch &= (~(1<<bit));
          }
       }
    }
 }
 
+template <class HOOKS>
 void CPPU::VBLANKSCANLINES ( void )
 {
    // Set VBLANK flag...
@@ -1479,7 +1615,7 @@ void CPPU::VBLANKSCANLINES ( void )
       wPPU ( PPUSTATUS, rPPU(PPUSTATUS)|PPUSTATUS_VBLANK );
    }
 
-   EMULATE(vblankScanlines*PPU_CYCLES_PER_SCANLINE);
+   EMULATE<HOOKS>(STATE()->vblankScanlines*PPU_CYCLES_PER_SCANLINE);
 
    // Clear VBLANK, Sprite 0 Hit flag and sprite overflow...
    wPPU ( PPUSTATUS, rPPU(PPUSTATUS)&(~(PPUSTATUS_VBLANK|PPUSTATUS_SPRITE_0_HIT|PPUSTATUS_SPRITE_OVFLO)) );
@@ -1487,8 +1623,8 @@ void CPPU::VBLANKSCANLINES ( void )
 
 void CPPU::PIXELPIPELINES ( int32_t pickoff, uint8_t* a, uint8_t* b1, uint8_t* b2 )
 {
-   BackgroundBufferData* pBkgnd1 = m_bkgndBuffer.data;
-   BackgroundBufferData* pBkgnd2 = m_bkgndBuffer.data+1;
+   BackgroundBufferData* pBkgnd1 = STATE()->m_bkgndBuffer.data;
+   BackgroundBufferData* pBkgnd2 = STATE()->m_bkgndBuffer.data+1;
 
    // Adjust pickoff point to place within stored data...
    pickoff = 7-pickoff;
@@ -1515,6 +1651,173 @@ void CPPU::PIXELPIPELINES ( int32_t pickoff, uint8_t* a, uint8_t* b1, uint8_t* b
    pBkgnd2->attribData2 <<= 1;
 }
 
+void CPPU::SPRITELINE ( void )
+{
+   uint16_t* pLine = STATE()->m_spriteLine;
+   SpriteBufferData* pSprite;
+   int32_t sprite;
+   int32_t idx2;
+   int32_t p;
+   uint16_t colorIdx;
+
+   memset ( pLine, 0, sizeof(STATE()->m_spriteLine) );
+
+   // Lay the sprites down back to front so that on each pixel the
+   // first sprite in the buffer with an opaque pixel there wins, as
+   // the sprite multiplexer would pick it.
+   for ( sprite = STATE()->m_spriteBuffer.count-1; sprite >= 0; sprite-- )
+   {
+      pSprite = STATE()->m_spriteBuffer.data + sprite;
+
+      for ( idx2 = 0; idx2 < PATTERN_SIZE; idx2++ )
+      {
+         p = pSprite->temp.spriteX + idx2;
+
+         if ( p > 255 )
+         {
+            break;
+         }
+
+         if ( pSprite->spriteFlipHoriz )
+         {
+            colorIdx = ((pSprite->patternData1>>idx2)&0x01)|((((pSprite->patternData2>>idx2)&0x01)<<1) );
+         }
+         else
+         {
+            colorIdx = ((pSprite->patternData1>>(7-idx2))&0x01)|((((pSprite->patternData2>>(7-idx2))&0x01)<<1) );
+         }
+
+         if ( colorIdx )
+         {
+            colorIdx |= (pSprite->temp.attribData<<2);
+
+            if ( pSprite->spriteBehind )
+            {
+               colorIdx |= SPRITELINE_BEHIND;
+            }
+            if ( pSprite->temp.spriteIdx == 0 )
+            {
+               colorIdx |= SPRITELINE_SPRITE0;
+            }
+
+            *(pLine+p) = colorIdx;
+         }
+      }
+   }
+}
+
+void CPPU::RENDERPIXELS ( void )
+{
+   BackgroundBufferData* pBkgnd1 = STATE()->m_bkgndBuffer.data;
+   BackgroundBufferData* pBkgnd2 = STATE()->m_bkgndBuffer.data+1;
+   uint8_t  mask = rPPU(PPUMASK);
+   int      grey = !!(mask&PPUMASK_GREYSCALE);
+   int      emR = !!(mask&PPUMASK_INTENSIFY_REDS);
+   int      emG = !!(mask&PPUMASK_INTENSIFY_GREENS);
+   int      emB = !!(mask&PPUMASK_INTENSIFY_BLUES);
+   int32_t  startBkgnd = (!(mask&PPUMASK_BKGND_CLIPPING))<<3;
+   int32_t  startSprite = (!(mask&PPUMASK_SPRITE_CLIPPING))<<3;
+   int32_t  p = STATE()->m_pixelX;
+   int32_t  pixels = STATE()->m_pixelDue-p;
+   int8_t*  pTV = STATE()->m_pPixelTV+(p<<2);
+   uint16_t spriteColorIdx;
+   int32_t  bkgndColorIdx;
+   int32_t  colorIdx;
+   int32_t  pickoff;
+
+   // The background barrel-shifters, each pair of tile slices as one
+   // 16-bit shifter.  The pixels drawn here are never more than the
+   // eight between tile fetches so the pickoff stays within them.
+   uint16_t patternData1 = (pBkgnd1->patternData1<<8)|pBkgnd2->patternData1;
+   uint16_t patternData2 = (pBkgnd1->patternData2<<8)|pBkgnd2->patternData2;
+   uint16_t attribData1 = (pBkgnd1->attribData1<<8)|pBkgnd2->attribData1;
+   uint16_t attribData2 = (pBkgnd1->attribData2<<8)|pBkgnd2->attribData2;
+
+   if ( startSprite < startBkgnd )
+   {
+      startSprite = startBkgnd;
+   }
+   if ( !(mask&PPUMASK_RENDER_SPRITES) )
+   {
+      startSprite = 256;
+   }
+
+   for ( pickoff = 15-rSCROLLX(); p < STATE()->m_pixelDue; p++, pickoff--, pTV += 4 )
+   {
+      if ( mask&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
+      {
+         // Background pixel determination...
+         bkgndColorIdx = ((patternData1>>pickoff)&0x1)|
+                         (((patternData2>>pickoff)&0x1)<<1)|
+                         (((attribData1>>pickoff)&0x1)<<2)|
+                         (((attribData2>>pickoff)&0x1)<<3);
+
+         // Render background color if necessary...
+         if ( (!(bkgndColorIdx&0x3)) || (!(mask&PPUMASK_RENDER_BKGND)) )
+         {
+            bkgndColorIdx = 0;
+         }
+
+         // Sprite pixel determination...
+         spriteColorIdx = (p >= startSprite) ? *(STATE()->m_spriteLine+p) : 0;
+
+         // Sprite/background pixel rendering determination...
+         if ( spriteColorIdx &&
+              ((!(spriteColorIdx&SPRITELINE_BEHIND)) || (bkgndColorIdx == 0)) )
+         {
+            colorIdx = rPALETTE(0x10+(spriteColorIdx&0x0F));
+         }
+         else if ( p>=startBkgnd )
+         {
+            colorIdx = rPALETTE(bkgndColorIdx);
+         }
+         else
+         {
+            colorIdx = rPALETTE(0);
+         }
+
+         // Sprite 0 hit checks...
+         if ( (spriteColorIdx&SPRITELINE_SPRITE0) &&
+              (!(rPPU(PPUSTATUS)&PPUSTATUS_SPRITE_0_HIT)) &&
+              (bkgndColorIdx != 0) &&
+              (p < 255) &&
+              ((mask&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES)) == (PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES)) )
+         {
+            rPPU(PPUSTATUS) |= PPUSTATUS_SPRITE_0_HIT;
+         }
+      }
+      else if ( (STATE()->m_ppuAddr&0x3F00) == 0x3F00 )
+      {
+         colorIdx = rPALETTE(STATE()->m_ppuAddr&0x1F);
+      }
+      else
+      {
+         colorIdx = rPALETTE(0);
+      }
+
+      *pTV = CBasePalette::GetPaletteR(colorIdx, grey, emR, emG, emB);
+      *(pTV+1) = CBasePalette::GetPaletteG(colorIdx, grey, emR, emG, emB);
+      *(pTV+2) = CBasePalette::GetPaletteB(colorIdx, grey, emR, emG, emB);
+   }
+
+   // Shift to the left to line up for next pickoff...
+   patternData1 <<= pixels;
+   patternData2 <<= pixels;
+   attribData1 <<= pixels;
+   attribData2 <<= pixels;
+   pBkgnd1->patternData1 = patternData1>>8;
+   pBkgnd1->patternData2 = patternData2>>8;
+   pBkgnd1->attribData1 = attribData1>>8;
+   pBkgnd1->attribData2 = attribData2>>8;
+   pBkgnd2->patternData1 = patternData1&0xFF;
+   pBkgnd2->patternData2 = patternData2&0xFF;
+   pBkgnd2->attribData1 = attribData1&0xFF;
+   pBkgnd2->attribData2 = attribData2&0xFF;
+
+   STATE()->m_pixelX = p;
+}
+
+template <class HOOKS>
 void CPPU::RENDERSCANLINE ( int32_t scanlines )
 {
    int32_t idxx;
@@ -1545,22 +1848,37 @@ void CPPU::RENDERSCANLINE ( int32_t scanlines )
    for ( scanline = start; scanline <= scanlines; scanline++ )
    {
       rasttv = ((scanline<<8)<<2);
-      pTV = (int8_t*)(m_pTV+rasttv);
+      pTV = (int8_t*)(STATE()->m_pTV+rasttv);
       p = 0;
 
-      m_x = 0;
-      m_y = scanline;
+      // Pick up breakpoints changed while the frame runs.
+      if ( HOOKS::HOOKED )
+      {
+         CNES::INDEXBREAKPOINTS ();
+      }
 
-      if ( nesIsDebuggable() )
+      STATE()->m_x = 0;
+      STATE()->m_y = scanline;
+
+      if ( (!HOOKS::HOOKED) && (scanline >= 0) )
+      {
+         // Get ready to draw this scanline in runs...
+         SPRITELINE ();
+         STATE()->m_pPixelTV = pTV;
+         STATE()->m_pixelX = 0;
+         STATE()->m_pixelDue = 0;
+      }
+
+      if ( HOOKS::ENABLED() )
       {
          // Check for start-of-scanline breakpoints...
          if ( scanline == -1 )
          {
-            CNES::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_PRE_RENDER_SCANLINE_START);
+            HOOKS::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_PRE_RENDER_SCANLINE_START);
          }
          else
          {
-            CNES::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_SCANLINE_START);
+            HOOKS::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_SCANLINE_START);
          }
       }
 
@@ -1568,24 +1886,40 @@ void CPPU::RENDERSCANLINE ( int32_t scanlines )
       {
          uint8_t a, b1, b2;
 
-         spriteColorIdx = 0;
-         bkgndColorIdx = 0;
-         startBkgnd = (!(rPPU(PPUMASK)&PPUMASK_BKGND_CLIPPING))<<3;
-         startSprite = (!(rPPU(PPUMASK)&PPUMASK_SPRITE_CLIPPING))<<3;
+         if ( !HOOKS::HOOKED )
+         {
+            // Without the debugger there is nothing to see of each pixel as it
+            // is drawn, so they are drawn a tile at a time before the next tile
+            // slice is loaded into the pipeline, or sooner if the CPU gets at
+            // the PPU registers in the meantime.
+            if ( scanline >= 0 )
+            {
+               STATE()->m_pixelDue = idxx+1;
 
+               if ( (idxx&7) == 7 )
+               {
+                  RENDERPIXELS ();
+               }
+            }
+         }
          // Only render to the screen on the visible scanlines...
-         if ( scanline >= 0 )
+         else if ( scanline >= 0 )
          {
-            if ( nesIsDebuggable() )
+            spriteColorIdx = 0;
+            bkgndColorIdx = 0;
+            startBkgnd = (!(rPPU(PPUMASK)&PPUMASK_BKGND_CLIPPING))<<3;
+            startSprite = (!(rPPU(PPUMASK)&PPUMASK_SPRITE_CLIPPING))<<3;
+
+            if ( HOOKS::ENABLED() )
             {
-               m_x = idxx;
+               STATE()->m_x = idxx;
 
                // Update variables for PPU viewer
-               *(*(m_2005x+m_x)+m_y) = m_last2005x+((rPPU(PPUCTRL)&0x1)<<8);
-               *(*(m_2005y+m_x)+m_y) = m_last2005y+(((rPPU(PPUCTRL)&0x2)>>1)*240);
+               *(*(STATE()->m_2005x+STATE()->m_x)+STATE()->m_y) = STATE()->m_last2005x+((rPPU(PPUCTRL)&0x1)<<8);
+               *(*(STATE()->m_2005y+STATE()->m_x)+STATE()->m_y) = STATE()->m_last2005y+(((rPPU(PPUCTRL)&0x2)>>1)*240);
 
                // Check for PPU pixel-at breakpoint...
-               CNES::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_PIXEL_XY);
+               HOOKS::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_PIXEL_XY);
             }
 
             // Run sprite multiplexer to figure out what, if any,
@@ -1593,9 +1927,9 @@ void CPPU::RENDERSCANLINE ( int32_t scanlines )
             pSelectedSprite = NULL;
             pSelectedSpriteTemp = NULL;
 
-            for ( sprite = 0; sprite < m_spriteBuffer.count; sprite++ )
+            for ( sprite = 0; sprite < STATE()->m_spriteBuffer.count; sprite++ )
             {
-               pSprite = m_spriteBuffer.data + sprite;
+               pSprite = STATE()->m_spriteBuffer.data + sprite;
                pSpriteTemp = &(pSprite->temp);
                idx2 = p - pSpriteTemp->spriteX;
 
@@ -1603,10 +1937,10 @@ void CPPU::RENDERSCANLINE ( int32_t scanlines )
                      (pSpriteTemp->spriteX+idx2 >= startSprite) &&
                      (pSpriteTemp->spriteX+idx2 >= startBkgnd) )
                {
-                  if ( nesIsDebuggable() )
+                  if ( HOOKS::ENABLED() )
                   {
                      // Check for sprite-in-multiplexer event breakpoint...
-                     CNES::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,pSpriteTemp->spriteIdx,PPU_EVENT_SPRITE_IN_MULTIPLEXER);
+                     HOOKS::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,pSpriteTemp->spriteIdx,PPU_EVENT_SPRITE_IN_MULTIPLEXER);
                   }
 
                   if ( pSprite->spriteFlipHoriz )
@@ -1633,10 +1967,10 @@ void CPPU::RENDERSCANLINE ( int32_t scanlines )
 
                   if ( spriteColorIdx&0x3 )
                   {
-                     if ( nesIsDebuggable() )
+                     if ( HOOKS::ENABLED() )
                      {
                         // Check for sprite selected event breakpoint...
-                        CNES::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,pSpriteTemp->spriteIdx,PPU_EVENT_SPRITE_SELECTED);
+                        HOOKS::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,pSpriteTemp->spriteIdx,PPU_EVENT_SPRITE_SELECTED);
                      }
 
                      // Save rendered sprite for multiplexing with background...
@@ -1670,10 +2004,10 @@ void CPPU::RENDERSCANLINE ( int32_t scanlines )
                       ((bkgndColorIdx == 0) &&
                        (spriteColorIdx != 0))) )
                {
-                  if ( nesIsDebuggable() )
+                  if ( HOOKS::ENABLED() )
                   {
                      // Check for sprite rendering event breakpoint...
-                     CNES::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,pSelectedSpriteTemp->spriteIdx,PPU_EVENT_SPRITE_RENDERING);
+                     HOOKS::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,pSelectedSpriteTemp->spriteIdx,PPU_EVENT_SPRITE_RENDERING);
                   }
 
                   // Draw sprite...
@@ -1707,28 +2041,28 @@ void CPPU::RENDERSCANLINE ( int32_t scanlines )
                   {
                      wPPU ( PPUSTATUS, rPPU(PPUSTATUS)|PPUSTATUS_SPRITE_0_HIT );
 
-                     if ( nesIsDebuggable() )
+                     if ( HOOKS::ENABLED() )
                      {
                         // Save last sprite 0 hit coords for OAM viewer...
-                        m_lastSprite0HitX = p;
-                        m_lastSprite0HitY = scanline;
+                        STATE()->m_lastSprite0HitX = p;
+                        STATE()->m_lastSprite0HitY = scanline;
 
                         // Add trace tag for Sprice 0 hit...
-                        CNES::TRACER()->AddSample ( m_cycles, eTracer_Sprite0Hit, eNESSource_PPU, 0, 0, 0 );
+                        CNES::TRACER()->AddSample ( STATE()->m_cycles, eTracer_Sprite0Hit, eNESSource_PPU, 0, 0, 0 );
 
                         // Check for Sprite 0 Hit breakpoint...
-                        CNES::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_SPRITE0_HIT);
+                        HOOKS::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_SPRITE0_HIT);
                      }
                   }
                }
             }
             else
             {
-               if ( (m_ppuAddr&0x3F00) == 0x3F00 )
+               if ( (STATE()->m_ppuAddr&0x3F00) == 0x3F00 )
                {
-                  *pTV = CBasePalette::GetPaletteR(rPALETTE(m_ppuAddr&0x1F), !!(rPPU(PPUMASK)&PPUMASK_GREYSCALE), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_REDS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_GREENS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_BLUES));
-                  *(pTV+1) = CBasePalette::GetPaletteG(rPALETTE(m_ppuAddr&0x1F), !!(rPPU(PPUMASK)&PPUMASK_GREYSCALE), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_REDS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_GREENS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_BLUES));
-                  *(pTV+2) = CBasePalette::GetPaletteB(rPALETTE(m_ppuAddr&0x1F), !!(rPPU(PPUMASK)&PPUMASK_GREYSCALE), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_REDS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_GREENS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_BLUES));
+                  *pTV = CBasePalette::GetPaletteR(rPALETTE(STATE()->m_ppuAddr&0x1F), !!(rPPU(PPUMASK)&PPUMASK_GREYSCALE), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_REDS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_GREENS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_BLUES));
+                  *(pTV+1) = CBasePalette::GetPaletteG(rPALETTE(STATE()->m_ppuAddr&0x1F), !!(rPPU(PPUMASK)&PPUMASK_GREYSCALE), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_REDS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_GREENS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_BLUES));
+                  *(pTV+2) = CBasePalette::GetPaletteB(rPALETTE(STATE()->m_ppuAddr&0x1F), !!(rPPU(PPUMASK)&PPUMASK_GREYSCALE), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_REDS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_GREENS), !!(rPPU(PPUMASK)&PPUMASK_INTENSIFY_BLUES));
                }
                else
                {
@@ -1746,97 +2080,167 @@ void CPPU::RENDERSCANLINE ( int32_t scanlines )
          // Secondary OAM reads occur on even PPU cycles...
          if ( !(idxx&1) )
          {
-            BUILDSPRITELIST ( scanline, idxx );
+            BUILDSPRITELIST<HOOKS> ( scanline, idxx );
          }
-         GATHERBKGND ( idxx%8 );
+         GATHERBKGND<HOOKS> ( idxx%8 );
       }
 
-      if ( nesIsDebuggable() )
+      if ( HOOKS::ENABLED() )
       {
          // Check for end-of-scanline breakpoints...
          if ( scanline == -1 )
          {
-            CNES::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_PRE_RENDER_SCANLINE_END);
+            HOOKS::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_PRE_RENDER_SCANLINE_END);
          }
          else
          {
-            CNES::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_SCANLINE_END);
+            HOOKS::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUEvent,0,PPU_EVENT_SCANLINE_END);
          }
       }
 
-      GATHERSPRITES ( scanline );
+      GATHERSPRITES<HOOKS> ( scanline );
 
       // Fill pipeline for next scanline...
-      m_bkgndBuffer.data[0].attribData1 = m_bkgndBuffer.data[1].attribData1;
-      m_bkgndBuffer.data[0].attribData2 = m_bkgndBuffer.data[1].attribData2;
-      m_bkgndBuffer.data[0].patternData1 = m_bkgndBuffer.data[1].patternData1;
-      m_bkgndBuffer.data[0].patternData2 = m_bkgndBuffer.data[1].patternData2;
+      STATE()->m_bkgndBuffer.data[0].attribData1 = STATE()->m_bkgndBuffer.data[1].attribData1;
+      STATE()->m_bkgndBuffer.data[0].attribData2 = STATE()->m_bkgndBuffer.data[1].attribData2;
+      STATE()->m_bkgndBuffer.data[0].patternData1 = STATE()->m_bkgndBuffer.data[1].patternData1;
+      STATE()->m_bkgndBuffer.data[0].patternData2 = STATE()->m_bkgndBuffer.data[1].patternData2;
 
       for ( p = 0; p < 8; p++ )
       {
-         GATHERBKGND ( p );
+         GATHERBKGND<HOOKS> ( p );
       }
 
       // Fill pipeline for next scanline...
-      m_bkgndBuffer.data[0].attribData1 = m_bkgndBuffer.data[1].attribData1;
-      m_bkgndBuffer.data[0].attribData2 = m_bkgndBuffer.data[1].attribData2;
-      m_bkgndBuffer.data[0].patternData1 = m_bkgndBuffer.data[1].patternData1;
-      m_bkgndBuffer.data[0].patternData2 = m_bkgndBuffer.data[1].patternData2;
+      STATE()->m_bkgndBuffer.data[0].attribData1 = STATE()->m_bkgndBuffer.data[1].attribData1;
+      STATE()->m_bkgndBuffer.data[0].attribData2 = STATE()->m_bkgndBuffer.data[1].attribData2;
+      STATE()->m_bkgndBuffer.data[0].patternData1 = STATE()->m_bkgndBuffer.data[1].patternData1;
+      STATE()->m_bkgndBuffer.data[0].patternData2 = STATE()->m_bkgndBuffer.data[1].patternData2;
 
       for ( p = 0; p < 8; p++ )
       {
-         GATHERBKGND ( p );
+         GATHERBKGND<HOOKS> ( p );
       }
 
       // Finish off scanline render clock cycles...
-      EMULATE(1);
+      EMULATE<HOOKS>(1);
 
       // If this is a visible scanline it is 341 clocks long both NTSC and PAL...
       // The exact skipped cycle appears to be cycle 337, which is right here.
       if ( scanline >= 0 )
       {
          // ...account for extra clock (341)
-         EXTRA ();
+         EXTRA<HOOKS> ();
       }
       // Otherwise, if this is the pre-render scanline it is:
       // 341 dots for PAL, always
       // 340 dots for NTSC odd frames and 341 dots for NTSC even frames if rendering is off, 341 dots for all frames otherwise
       else
       {
-         if ( (CNES::VIDEOMODE() == MODE_DENDY) || (CNES::VIDEOMODE() == MODE_PAL) || ((CNES::VIDEOMODE() == MODE_NTSC) && ((!(m_frame&1)) || (!(rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND))))) )
+         if ( (CNES::VIDEOMODE() == MODE_DENDY) || (CNES::VIDEOMODE() == MODE_PAL) || ((CNES::VIDEOMODE() == MODE_NTSC) && ((!(STATE()->m_frame&1)) || (!(rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND))))) )
          {
             // account for extra clock (341)
-            EXTRA ();
+            EXTRA<HOOKS> ();
          }
       }
 
       // Finish off scanline render clock cycles...
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         GARBAGE ( 0x2000, eTarget_NameTable );
+         GARBAGE<HOOKS> ( 0x2000, eTarget_NameTable );
       }
       else
       {
-         EMULATE(1);
+         EMULATE<HOOKS>(1);
       }
-      EMULATE(1);
+      EMULATE<HOOKS>(1);
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         GARBAGE ( 0x2000, eTarget_NameTable );
+         GARBAGE<HOOKS> ( 0x2000, eTarget_NameTable );
       }
       else
       {
-         EMULATE(1);
+         EMULATE<HOOKS>(1);
       }
    }
 }
 
+void CPPU::TVQUEUE ( int8_t* tv0, int8_t* tv1, int8_t* tv2 )
+{
+   STATE()->m_tvQueue[0] = tv0;
+   STATE()->m_tvQueue[1] = tv1;
+   STATE()->m_tvQueue[2] = tv2;
+
+   // The PPU starts on the first surface, the second waits to be published
+   // over and the UI has the third.
+   STATE()->m_tvBack = 0;
+   STATE()->m_tvFront = 2;
+   STATE()->m_tvReady.store(1,std::memory_order_release);
+   STATE()->m_tvFrames.store(0,std::memory_order_relaxed);
+   STATE()->m_tvDropped.store(0,std::memory_order_relaxed);
+   STATE()->m_tvDuplicated.store(0,std::memory_order_relaxed);
+
+   if ( tv0 )
+   {
+      TV ( tv0 );
+   }
+}
+
+void CPPU::PUBLISHTV ( void )
+{
+   int32_t ready;
+
+   if ( STATE()->m_tvQueue[0] )
+   {
+      // Swap the finished surface for the published one.  If the UI never
+      // acquired that one, it was drawn for nothing.
+      ready = STATE()->m_tvReady.exchange(STATE()->m_tvBack|TV_QUEUE_FRESH,std::memory_order_acq_rel);
+      if ( ready&TV_QUEUE_FRESH )
+      {
+         STATE()->m_tvDropped.fetch_add(1,std::memory_order_relaxed);
+      }
+      STATE()->m_tvBack = ready&TV_QUEUE_INDEX;
+      STATE()->m_tvFrames.fetch_add(1,std::memory_order_relaxed);
+   }
+}
+
+int8_t* CPPU::ACQUIRETV ( void )
+{
+   int32_t ready;
+
+   if ( !STATE()->m_tvQueue[0] )
+   {
+      return STATE()->m_pTV;
+   }
+
+   // Swap the surface the UI is done with for the published one if there
+   // is a new one; otherwise the UI shows the same frame again.
+   if ( STATE()->m_tvReady.load(std::memory_order_relaxed)&TV_QUEUE_FRESH )
+   {
+      ready = STATE()->m_tvReady.exchange(STATE()->m_tvFront,std::memory_order_acq_rel);
+      STATE()->m_tvFront = ready&TV_QUEUE_INDEX;
+   }
+   else
+   {
+      STATE()->m_tvDuplicated.fetch_add(1,std::memory_order_relaxed);
+   }
+
+   return STATE()->m_tvQueue[STATE()->m_tvFront];
+}
+
+void CPPU::VIDEOINFORMATION ( nesVideoInfo* pInfo )
+{
+   pInfo->frames = STATE()->m_tvFrames.load(std::memory_order_relaxed);
+   pInfo->dropped = STATE()->m_tvDropped.load(std::memory_order_relaxed);
+   pInfo->duplicated = STATE()->m_tvDuplicated.load(std::memory_order_relaxed);
+}
+
 void CPPU::PIXELRGB ( int32_t x, int32_t y, uint8_t* r, uint8_t* g, uint8_t* b )
 {
    if ( (x>=0) && (x<=255) && (y>=0) && (y<=239) )
    {
       int32_t rasttv = (y<<8)<<2;
-      int8_t* pTV = (int8_t*)(m_pTV+rasttv);
+      int8_t* pTV = (int8_t*)(STATE()->m_pTV+rasttv);
 
       pTV += (x<<2);
 
@@ -1846,10 +2250,11 @@ void CPPU::PIXELRGB ( int32_t x, int32_t y, uint8_t* r, uint8_t* g, uint8_t* b )
    }
 }
 
+template <class HOOKS>
 void CPPU::GATHERBKGND ( int8_t phase )
 {
-   static uint16_t patternIdx;
-   static BackgroundBufferData bkgndTemp;
+   uint16_t& patternIdx = STATE()->m_bkgndPatternIdx;
+   BackgroundBufferData& bkgndTemp = STATE()->m_bkgndTemp;
 
    uint32_t ppuAddr = rPPUADDR();
    int32_t tileX = ppuAddr&0x001F;
@@ -1858,11 +2263,11 @@ void CPPU::GATHERBKGND ( int8_t phase )
    int32_t attribAddr = 0x2000 + (ppuAddr&0x0C00) + 0x03C0 + ((tileY&0xFFFC)<<1) + (tileX>>2);
    uint8_t attribData = 0x00;
    int32_t bkgndPatBase = (!!(rPPU(PPUCTRL)&PPUCTRL_BKGND_PAT_TBL_ADDR))<<12;
-   BackgroundBufferData* pBkgnd = m_bkgndBuffer.data + 1;
+   BackgroundBufferData* pBkgnd = STATE()->m_bkgndBuffer.data + 1;
 
    if ( !(phase&1) )
    {
-      EMULATE(1);
+      EMULATE<HOOKS>(1);
       return;
    }
 
@@ -1870,22 +2275,22 @@ void CPPU::GATHERBKGND ( int8_t phase )
    {
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         patternIdx = bkgndPatBase+(RENDER(nameAddr,eTracer_RenderBkgnd)<<4)+((ppuAddr&0x7000)>>12);
+         patternIdx = bkgndPatBase+(RENDER<HOOKS>(nameAddr,eTracer_RenderBkgnd)<<4)+((ppuAddr&0x7000)>>12);
       }
       else
       {
-         EMULATE(1);
+         EMULATE<HOOKS>(1);
       }
    }
    else if ( phase == 3 )
    {
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         attribData = RENDER ( attribAddr,eTracer_RenderBkgnd );
+         attribData = RENDER<HOOKS> ( attribAddr,eTracer_RenderBkgnd );
       }
       else
       {
-         EMULATE(1);
+         EMULATE<HOOKS>(1);
       }
 
       if ( (tileY&0x0002) == 0 )
@@ -1979,22 +2384,22 @@ void CPPU::GATHERBKGND ( int8_t phase )
    {
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         bkgndTemp.patternData1 = RENDER ( patternIdx,eTracer_RenderBkgnd );
+         bkgndTemp.patternData1 = RENDER<HOOKS> ( patternIdx,eTracer_RenderBkgnd );
       }
       else
       {
-         EMULATE(1);
+         EMULATE<HOOKS>(1);
       }
    }
    else if ( phase == 7 )
    {
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         bkgndTemp.patternData2 = RENDER ( patternIdx+PATTERN_SIZE,eTracer_RenderBkgnd );
+         bkgndTemp.patternData2 = RENDER<HOOKS> ( patternIdx+PATTERN_SIZE,eTracer_RenderBkgnd );
       }
       else
       {
-         EMULATE(1);
+         EMULATE<HOOKS>(1);
       }
 
       pBkgnd->attribData1 = bkgndTemp.attribData1;
@@ -2005,11 +2410,12 @@ void CPPU::GATHERBKGND ( int8_t phase )
    }
 }
 
+template <class HOOKS>
 void CPPU::BUILDSPRITELIST ( int32_t scanline, int32_t cycle )
 {
-   static SpriteTemporaryMemoryData  devNull;
-   static SpriteTemporaryMemoryData* pSprite = &devNull;
-   static int32_t                    spritesFound = 0;
+   SpriteTemporaryMemoryData&  devNull = STATE()->m_spriteDevNull;
+   SpriteTemporaryMemoryData*& pSprite = STATE()->m_pSpriteEval;
+   int32_t&                    spritesFound = STATE()->m_spritesFound;
 
    int32_t          idx1;
    int32_t          spriteY;
@@ -2020,13 +2426,13 @@ void CPPU::BUILDSPRITELIST ( int32_t scanline, int32_t cycle )
    if ( cycle == 0 )
    {
       spritesFound = 0;
-      m_oamAddr = 0;
+      STATE()->m_oamAddr = 0;
       pSprite = &devNull;
-      m_spriteTemporaryMemory.count = 0;
-      m_spriteTemporaryMemory.sprite = (m_oamAddr>>2);
-      m_spriteTemporaryMemory.phase = 0;
-      m_spriteTemporaryMemory.yByte = (m_oamAddr&0x3);
-      m_spriteTemporaryMemory.rolling = 0;
+      STATE()->m_spriteTemporaryMemory.count = 0;
+      STATE()->m_spriteTemporaryMemory.sprite = (STATE()->m_oamAddr>>2);
+      STATE()->m_spriteTemporaryMemory.phase = 0;
+      STATE()->m_spriteTemporaryMemory.yByte = (STATE()->m_oamAddr&0x3);
+      STATE()->m_spriteTemporaryMemory.rolling = 0;
    }
 
    // Loop invariants...
@@ -2041,18 +2447,18 @@ void CPPU::BUILDSPRITELIST ( int32_t scanline, int32_t cycle )
    }
 
    // Secondary OAM reads stop after all sprites evaluated...
-   if ( m_spriteTemporaryMemory.sprite == NUM_SPRITES )
+   if ( STATE()->m_spriteTemporaryMemory.sprite == NUM_SPRITES )
    {
       return;
    }
 
-   if ( m_spriteTemporaryMemory.phase == 0 )
+   if ( STATE()->m_spriteTemporaryMemory.phase == 0 )
    {
       // Populate sprite buffer...
       // Retrieve OAM byte for scanline check...
       // Note: obscure PPU 'bug' in that 9th sprite on scanline
       // causes other sprite data to be used as the Y-coordinate.
-      spriteY = OAM ( m_spriteTemporaryMemory.yByte, m_spriteTemporaryMemory.sprite ) + 1;
+      spriteY = OAM ( STATE()->m_spriteTemporaryMemory.yByte, STATE()->m_spriteTemporaryMemory.sprite ) + 1;
 
       // idx1 is sprite slice (it will be in range 0-7 or 0-15 if the sprite
       // is on the next scanline.
@@ -2070,8 +2476,8 @@ void CPPU::BUILDSPRITELIST ( int32_t scanline, int32_t cycle )
             pSprite = &devNull;
 
             // Move to next sprite...
-            m_spriteTemporaryMemory.sprite++;
-            m_spriteTemporaryMemory.phase = 0;
+            STATE()->m_spriteTemporaryMemory.sprite++;
+            STATE()->m_spriteTemporaryMemory.phase = 0;
 
             // Should we assert sprite overflow?
             if ( spritesFound == 9 )
@@ -2082,10 +2488,10 @@ void CPPU::BUILDSPRITELIST ( int32_t scanline, int32_t cycle )
                   {
                      wPPU(PPUSTATUS,rPPU(PPUSTATUS)|PPUSTATUS_SPRITE_OVFLO );
 
-                     if ( nesIsDebuggable() )
+                     if ( HOOKS::ENABLED() )
                      {
                         // Check for breakpoint...
-                        CNES::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, 0, PPU_EVENT_SPRITE_OVERFLOW );
+                        HOOKS::CHECKBREAKPOINT ( eBreakInPPU, eBreakOnPPUEvent, 0, PPU_EVENT_SPRITE_OVERFLOW );
                      }
                   }
                }
@@ -2094,70 +2500,71 @@ void CPPU::BUILDSPRITELIST ( int32_t scanline, int32_t cycle )
          else
          {
             // Cause fetch phases to occur for this in-range sprite...
-            m_spriteTemporaryMemory.phase++;
+            STATE()->m_spriteTemporaryMemory.phase++;
 
             // Found a sprite...
-            pSprite = m_spriteTemporaryMemory.data+m_spriteTemporaryMemory.count;
-            pSprite->spriteIdx = m_spriteTemporaryMemory.sprite;
+            pSprite = STATE()->m_spriteTemporaryMemory.data+STATE()->m_spriteTemporaryMemory.count;
+            pSprite->spriteIdx = STATE()->m_spriteTemporaryMemory.sprite;
             pSprite->spriteSlice = idx1;
          }
       }
       else
       {
          // Sprite not on this scanline, move to next one...
-         m_spriteTemporaryMemory.sprite++;
+         STATE()->m_spriteTemporaryMemory.sprite++;
       }
 
       // If we've found 8 sprites on this scanline, enable the
       // obscure PPU 'bug'.
       if ( (spritesFound == 8) && (!(idx1 >= 0) && (idx1 < spriteSize)) )
       {
-         m_spriteTemporaryMemory.rolling = 1;
+         STATE()->m_spriteTemporaryMemory.rolling = 1;
       }
 
       // The obscure PPU 'bug' behavior rolls through different
       // sprite data bytes as the Y-coordinate...
-      if ( m_spriteTemporaryMemory.rolling )
+      if ( STATE()->m_spriteTemporaryMemory.rolling )
       {
-         m_spriteTemporaryMemory.yByte++;
-         m_spriteTemporaryMemory.yByte %= OAM_SIZE;
+         STATE()->m_spriteTemporaryMemory.yByte++;
+         STATE()->m_spriteTemporaryMemory.yByte %= OAM_SIZE;
       }
 
       if ( spritesFound < NUM_SPRITES_PER_SCANLINE )
       {
-         m_spriteTemporaryMemory.count = spritesFound;
+         STATE()->m_spriteTemporaryMemory.count = spritesFound;
       }
       else
       {
-         m_spriteTemporaryMemory.count = NUM_SPRITES_PER_SCANLINE;
+         STATE()->m_spriteTemporaryMemory.count = NUM_SPRITES_PER_SCANLINE;
       }
    }
-   else if ( (pSprite != &devNull) && (m_spriteTemporaryMemory.phase == 1) )
+   else if ( (pSprite != &devNull) && (STATE()->m_spriteTemporaryMemory.phase == 1) )
    {
       // Cause fetch phases to occur for this in-range sprite...
-      m_spriteTemporaryMemory.phase++;
+      STATE()->m_spriteTemporaryMemory.phase++;
 
       pSprite->patternIdx = OAM ( SPRITEPAT, pSprite->spriteIdx );
    }
-   else if ( (pSprite != &devNull) && (m_spriteTemporaryMemory.phase == 2) )
+   else if ( (pSprite != &devNull) && (STATE()->m_spriteTemporaryMemory.phase == 2) )
    {
       // Cause fetch phases to occur for this in-range sprite...
-      m_spriteTemporaryMemory.phase++;
+      STATE()->m_spriteTemporaryMemory.phase++;
 
       pSprite->attribData = OAM ( SPRITEATT, pSprite->spriteIdx );
    }
-   else if ( (pSprite != &devNull) && (m_spriteTemporaryMemory.phase == 3) )
+   else if ( (pSprite != &devNull) && (STATE()->m_spriteTemporaryMemory.phase == 3) )
    {
       // Move to next sprite...
-      m_spriteTemporaryMemory.sprite++;
-      m_spriteTemporaryMemory.phase = 0;
+      STATE()->m_spriteTemporaryMemory.sprite++;
+      STATE()->m_spriteTemporaryMemory.phase = 0;
 
       pSprite->spriteX = OAM ( SPRITEX, pSprite->spriteIdx );
    }
 
-   m_oamAddr = (m_spriteTemporaryMemory.sprite<<2)|(m_spriteTemporaryMemory.phase);
+   STATE()->m_oamAddr = (STATE()->m_spriteTemporaryMemory.sprite<<2)|(STATE()->m_spriteTemporaryMemory.phase);
 }
 
+template <class HOOKS>
 void CPPU::GATHERSPRITES ( int32_t scanline )
 {
    int32_t idx1;
@@ -2177,11 +2584,11 @@ void CPPU::GATHERSPRITES ( int32_t scanline )
    }
 
    // Populate sprite buffer...
-   for ( sprite = 0; sprite < m_spriteTemporaryMemory.count; sprite++ )
+   for ( sprite = 0; sprite < STATE()->m_spriteTemporaryMemory.count; sprite++ )
    {
       // Move sprite data...
-      pSpriteTemp = (m_spriteTemporaryMemory.data+sprite);
-      pSprite = m_spriteBuffer.data+sprite;
+      pSpriteTemp = (STATE()->m_spriteTemporaryMemory.data+sprite);
+      pSprite = STATE()->m_spriteBuffer.data+sprite;
 
       pSprite->temp.attribData = pSpriteTemp->attribData;
       pSprite->temp.patternIdx = pSpriteTemp->patternIdx;
@@ -2190,13 +2597,13 @@ void CPPU::GATHERSPRITES ( int32_t scanline )
       pSprite->temp.spriteX = pSpriteTemp->spriteX;
    }
 
-   m_spriteBuffer.count = m_spriteTemporaryMemory.count;
+   STATE()->m_spriteBuffer.count = STATE()->m_spriteTemporaryMemory.count;
 
    // Work with sprite buffer...
-   for ( sprite = 0; sprite < m_spriteBuffer.count; sprite++ )
+   for ( sprite = 0; sprite < STATE()->m_spriteBuffer.count; sprite++ )
    {
       // Get sprite data...
-      pSprite = m_spriteBuffer.data+sprite;
+      pSprite = STATE()->m_spriteBuffer.data+sprite;
       pSpriteTemp = &(pSprite->temp);
 
       // Get sprite 'slice'...
@@ -2233,55 +2640,55 @@ void CPPU::GATHERSPRITES ( int32_t scanline )
       // Garbage nametable fetches according to Samus Aran...
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         EMULATE(1);
-         GARBAGE ( 0x2000, eTarget_NameTable );
-         EMULATE(1);
-         GARBAGE ( 0x2000, eTarget_NameTable );
+         EMULATE<HOOKS>(1);
+         GARBAGE<HOOKS> ( 0x2000, eTarget_NameTable );
+         EMULATE<HOOKS>(1);
+         GARBAGE<HOOKS> ( 0x2000, eTarget_NameTable );
       }
       else
       {
-         EMULATE(4);
+         EMULATE<HOOKS>(4);
       }
 
       // Get sprite's pattern data...
-      EMULATE(1);
+      EMULATE<HOOKS>(1);
 
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         pSprite->patternData1 = RENDER ( spritePatBase+(patternIdx<<4)+(idx1&0x7), eTracer_RenderSprite );
+         pSprite->patternData1 = RENDER<HOOKS> ( spritePatBase+(patternIdx<<4)+(idx1&0x7), eTracer_RenderSprite );
       }
       else
       {
-         EMULATE(1);
+         EMULATE<HOOKS>(1);
       }
 
-      EMULATE(1);
+      EMULATE<HOOKS>(1);
 
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         pSprite->patternData2 = RENDER ( spritePatBase+(patternIdx<<4)+(idx1&0x7)+PATTERN_SIZE, eTracer_RenderSprite );
+         pSprite->patternData2 = RENDER<HOOKS> ( spritePatBase+(patternIdx<<4)+(idx1&0x7)+PATTERN_SIZE, eTracer_RenderSprite );
       }
       else
       {
-         EMULATE(1);
+         EMULATE<HOOKS>(1);
       }
    }
 
    // Perform remaining garbage fetches to finish out the scanline's
    // PPU cycles...
-   for ( sprite = m_spriteBuffer.count; sprite < NUM_SPRITES_PER_SCANLINE; sprite++ )
+   for ( sprite = STATE()->m_spriteBuffer.count; sprite < NUM_SPRITES_PER_SCANLINE; sprite++ )
    {
       // Garbage nametable fetches according to Samus Aran...
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         EMULATE(1);
-         GARBAGE ( 0x2000, eTarget_NameTable );
-         EMULATE(1);
-         GARBAGE ( 0x2000, eTarget_NameTable );
+         EMULATE<HOOKS>(1);
+         GARBAGE<HOOKS> ( 0x2000, eTarget_NameTable );
+         EMULATE<HOOKS>(1);
+         GARBAGE<HOOKS> ( 0x2000, eTarget_NameTable );
       }
       else
       {
-         EMULATE(4);
+         EMULATE<HOOKS>(4);
       }
 
       if ( spriteSize == 16 )
@@ -2291,14 +2698,23 @@ void CPPU::GATHERSPRITES ( int32_t scanline )
 
       if ( rPPU(PPUMASK)&(PPUMASK_RENDER_BKGND|PPUMASK_RENDER_SPRITES) )
       {
-         EMULATE(1);
-         GARBAGE ( spritePatBase+(GARBAGE_SPRITE_FETCH<<4), eTarget_PatternMemory );
-         EMULATE(1);
-         GARBAGE ( spritePatBase+(GARBAGE_SPRITE_FETCH<<4)+PATTERN_SIZE, eTarget_PatternMemory );
+         EMULATE<HOOKS>(1);
+         GARBAGE<HOOKS> ( spritePatBase+(GARBAGE_SPRITE_FETCH<<4), eTarget_PatternMemory );
+         EMULATE<HOOKS>(1);
+         GARBAGE<HOOKS> ( spritePatBase+(GARBAGE_SPRITE_FETCH<<4)+PATTERN_SIZE, eTarget_PatternMemory );
       }
       else
       {
-         EMULATE(4);
+         EMULATE<HOOKS>(4);
       }
    }
 }
+
+// Scanline emulation is driven from CNES::EMULATEFRAME in both debug
+// hook flavors.
+template void CPPU::RENDERSCANLINE<NESNoDebugHooks> ( int32_t scanline );
+template void CPPU::RENDERSCANLINE<NESDebugHooks> ( int32_t scanline );
+template void CPPU::QUIETSCANLINES<NESNoDebugHooks> ( void );
+template void CPPU::QUIETSCANLINES<NESDebugHooks> ( void );
+template void CPPU::VBLANKSCANLINES<NESNoDebugHooks> ( void );
+template void CPPU::VBLANKSCANLINES<NESDebugHooks> ( void );
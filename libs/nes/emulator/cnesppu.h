@@ -1,12 +1,15 @@
 #if !defined ( PPU_H )
 #define PPU_H
 
+#include <atomic>
+
 #include "nes_emulator_core.h"
 
 #include "ctracer.h"
 #include "ccodedatalogger.h"
 
 #include "cnesrom.h"
+#include "cnesstate.h"
 
 // Rudimentary PPU I/O bus decay algorithm simply counts PPU frames to get
 // "close" to 600 milliseconds of time elapsed for a single bit to decay.
@@ -14,6 +17,13 @@
 #define PPU_DECAY_FRAME_COUNT_PAL   30
 #define PPU_DECAY_FRAME_COUNT_DENDY 30
 
+// The frame queue's surfaces are handed between the PPU and the UI by index.
+// The published surface's index is kept with a flag saying whether the UI
+// has yet to acquire it.
+#define TV_QUEUE_SIZE  3
+#define TV_QUEUE_INDEX 0x3
+#define TV_QUEUE_FRESH 0x4
+
 // PPU cycles are used as the master cycle of the emulation system.
 // To achieve an integer ratio of PPU/CPU/APU cycles the PPU cycle
 // counter is incremented by 5 each time.  To arrive at the appropriate
@@ -142,11 +152,15 @@ typedef struct _BackgroundBuffer
 } BackgroundBuffer;
 
 // Macros for internal access to PPU data for use within the PPU object.
-#define rPALETTE(addr) ( (*(m_PALETTEmemory+(addr))&0x3F) )
-#define rPPU(addr) ( *(m_PPUreg+((addr)&0x0007)) )
-#define wPPU(addr,data) { *(m_PPUreg+((addr)&0x0007)) = (data); CNES::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUState,addr&0x0007); }
-#define rPPUADDR() ( m_ppuAddr )
-#define rSCROLLX() ( m_ppuScrollX )
+#define rPALETTE(addr) ( (*(STATE()->m_PALETTEmemory+(addr))&0x3F) )
+#define rPPU(addr) ( *(STATE()->m_PPUreg+((addr)&0x0007)) )
+#define wPPU(addr,data) { *(STATE()->m_PPUreg+((addr)&0x0007)) = (data); HOOKS::CHECKBREAKPOINT(eBreakInPPU,eBreakOnPPUState,addr&0x0007); }
+#define rPPUADDR() ( STATE()->m_ppuAddr )
+#define rSCROLLX() ( STATE()->m_ppuScrollX )
+
+// Flags kept alongside the palette index in each sprite line entry.
+#define SPRITELINE_BEHIND  0x100
+#define SPRITELINE_SPRITE0 0x200
 
 // The CPPU class is the implementation of the PPU of the NES.
 // It provides PPU-fetch-cycle granular emulation of the PPU core.
@@ -189,16 +203,19 @@ typedef struct _BackgroundBuffer
 class CPPU
 {
 public:
-   CPPU();
-   ~CPPU();
-
    // Emulation routine.  Emulates one PPU cycle.
-   static inline void EMULATE ( uint32_t cycles );
+   template <class HOOKS> static inline void EMULATE ( uint32_t cycles );
 
    // Routine invoked on reset of the emulation engine.
    // Cleans up the PPU state as if a NES reset had just occurred.
    static void RESET ( bool soft );
 
+   // Save state support.  SAVESTATE writes this object's chunk of a save
+   // state; LOADSTATE restores it, returning false if the chunk is missing
+   // or does not match.
+   static void SAVESTATE ( CNESStateWriter& writer );
+   static bool LOADSTATE ( CNESStateReader& reader );
+
    // State and internal data accessor interfaces.
    // Read a PPU register, affecting the PPU's internal state.
    // This function is used during emulation.
@@ -216,25 +233,25 @@ public:
    // Read a byte from the PPU's internal OAM memory.
    static inline uint32_t OAM ( uint32_t oam, uint32_t sprite )
    {
-      return *(m_PPUoam+(sprite*OAM_SIZE)+oam);
+      return *(STATE()->m_PPUoam+(sprite*OAM_SIZE)+oam);
    }
 
    // Write a byte to the PPU's internal OAM memory.
    static inline void OAM ( uint32_t oam, uint32_t sprite, uint8_t data )
    {
-      *(m_PPUoam+(sprite*OAM_SIZE)+oam) = data;
+      *(STATE()->m_PPUoam+(sprite*OAM_SIZE)+oam) = data;
    }
 
    // Read a byte from the PPU's internal OAM memory.
    static inline uint32_t _OAM ( uint32_t oam, uint32_t sprite )
    {
-      return *(m_PPUoam+(sprite*OAM_SIZE)+oam);
+      return *(STATE()->m_PPUoam+(sprite*OAM_SIZE)+oam);
    }
 
    // Write a byte to the PPU's internal OAM memory.
    static inline void _OAM ( uint32_t oam, uint32_t sprite, uint8_t data )
    {
-      *(m_PPUoam+(sprite*OAM_SIZE)+oam) = data;
+      *(STATE()->m_PPUoam+(sprite*OAM_SIZE)+oam) = data;
    }
 
    // Return the current cycle index of the PPU core.
@@ -256,36 +273,36 @@ public:
    // its presence or lack thereof.
    static inline uint32_t _CYCLES ( void )
    {
-      return m_cycles;
+      return STATE()->m_cycles;
    }
 
    // Every PPU frame starts at PPU cycle 0.
    static inline void RESETCYCLECOUNTER ( void )
    {
-      m_cycles = 0;
-      m_frame++;
+      STATE()->m_cycles = 0;
+      STATE()->m_frame++;
    }
 
    // Accessor methods to set up or clear the state of the nametable memory
    // maintained internally by the PPU object.
    static void MEMSET ( uint32_t addr, uint8_t* data, uint32_t length )
    {
-      memcpy(m_PPUmemory+addr,data,length);
+      memcpy(STATE()->m_PPUmemory+addr,data,length);
    }
    static void MEMCLR ( void )
    {
-      memset(m_PPUmemory,0,MEM_4KB);
+      memset(STATE()->m_PPUmemory,0,MEM_4KB);
    }
 
    // Accessor methods to set up or clear the state of the OAM memory
    // maintained internally by the PPU object.
    static void OAMSET ( uint32_t addr, uint8_t* data, uint32_t length )
    {
-      memcpy(m_PPUoam+addr,data,length);
+      memcpy(STATE()->m_PPUoam+addr,data,length);
    }
    static void OAMCLR ( void )
    {
-      memset(m_PPUoam,0,MEM_256B);
+      memset(STATE()->m_PPUoam,0,MEM_256B);
    }
 
    // Routines to configure or retrieve information about the current
@@ -296,16 +313,16 @@ public:
    static void MIRROR ( int32_t nt1, int32_t nt2, int32_t nt3, int32_t nt4 );
    static inline bool FOURSCREEN ( void )
    {
-      return m_extraVRAM;
+      return STATE()->m_extraVRAM;
    }
 
    // Rendering interfaces.  These are invoked by the NES object at
    // particular places within the PPU frame to run the PPU for a
    // specific number of PPU cycles, usually a multiple of the number
    // of PPU cycles per scanline.
-   static void RENDERSCANLINE ( int32_t scanline );
-   static void QUIETSCANLINES ( void );
-   static void VBLANKSCANLINES ( void );
+   template <class HOOKS> static void RENDERSCANLINE ( int32_t scanline );
+   template <class HOOKS> static void QUIETSCANLINES ( void );
+   template <class HOOKS> static void VBLANKSCANLINES ( void );
 
    // Interface to handle the special case where the setting of the
    // VBLANK flag in the PPU registers is choked by the reading of the
@@ -313,12 +330,12 @@ public:
    // the PPU frame.
    static inline void VBLANKCHOKED ( bool choked )
    {
-      m_vblankChoked = choked;
+      STATE()->m_vblankChoked = choked;
    }
    static inline bool VBLANKCHOKED ()
    {
-      bool choked = m_vblankChoked;
-      m_vblankChoked = false;
+      bool choked = STATE()->m_vblankChoked;
+      STATE()->m_vblankChoked = false;
       return choked;
    }
 
@@ -327,11 +344,11 @@ public:
    // PPU frame.
    static inline void NMICHOKED ( bool choked )
    {
-      m_nmiChoked = choked;
+      STATE()->m_nmiChoked = choked;
    }
    static inline bool NMICHOKED ()
    {
-      return m_nmiChoked;
+      return STATE()->m_nmiChoked;
    }
 
    // Interface to handle the special case where assertion of NMI can be
@@ -339,12 +356,12 @@ public:
    // bit is cleared and re-set during the VBLANK period.
    static inline void NMIREENABLED ( bool reenabled )
    {
-      m_nmiReenabled = reenabled;
+      STATE()->m_nmiReenabled = reenabled;
    }
    static inline bool NMIREENABLED ()
    {
-      bool reenabled = m_nmiReenabled;
-      m_nmiReenabled = false;
+      bool reenabled = STATE()->m_nmiReenabled;
+      STATE()->m_nmiReenabled = false;
       return reenabled;
    }
 
@@ -358,7 +375,7 @@ public:
    // part of the emulation process (ie. generate an NMI to the CPU core or not?)
    static inline uint32_t _PPU ( uint32_t addr )
    {
-      return *(m_PPUreg+(addr&0x0007));
+      return *(STATE()->m_PPUreg+(addr&0x0007));
    }
 
    // Write a PPU register.
@@ -368,35 +385,29 @@ public:
    // flag are not necessarily dependent on executed code.
    static inline void _PPU ( uint32_t addr, uint8_t data )
    {
-      *(m_PPUreg+(addr&0x0007)) = data;
+      *(STATE()->m_PPUreg+(addr&0x0007)) = data;
    }
 
    // Silently read from a memory location visible to the PPU.
    // This routine is used by the debuggers to gather PPU information without
    // impacting the state of the emulation or the visual aspect of any inspectors.
-   static inline uint32_t _MEM ( uint32_t addr )
-   {
-      return LOAD(addr,0,0,false);
-   }
+   static uint32_t _MEM ( uint32_t addr );
 
    // Silently write to a memory location visible to the PPU.
    // This routine is used by the debuggers to change PPU information without
    // impacting the state of the emulation or the visual aspect of any inspectors.
-   static inline void _MEM ( uint32_t addr, uint8_t data )
-   {
-      STORE(addr,data,0,0,false);
-   }
+   static void _MEM ( uint32_t addr, uint8_t data );
 
    // Silently read from memory locations visible to the PPU.
    // These routines are used by the debuggers to gather PPU information without
    // impacting the state of the emulation.
    static inline uint8_t _NAMETABLE ( uint16_t addr )
    {
-      return *((*(m_pPPUmemory+((addr&0x1FFF)>>10)))+(addr&0x3FF));
+      return *((*(STATE()->m_pPPUmemory+((addr&0x1FFF)>>10)))+(addr&0x3FF));
    }
    static inline uint8_t _ATTRTABLE ( uint16_t addr )
    {
-      return *((*(m_pPPUmemory+((addr&0x1FFF)>>10)))+(addr&0x3FF));
+      return *((*(STATE()->m_pPPUmemory+((addr&0x1FFF)>>10)))+(addr&0x3FF));
    }
    static inline uint8_t _PATTERNDATA ( uint16_t addr )
    {
@@ -409,37 +420,37 @@ public:
          addr = 0x00;
       }
 
-      return *(m_PALETTEmemory+addr);
+      return *(STATE()->m_PALETTEmemory+addr);
    }
 
    // Return the internal state of the PPU's hardware such as the OAM address latch, the PPU
    // address latch, and the read-buffer.
    static inline uint8_t _OAMADDR ( void )
    {
-      return m_oamAddr;
+      return STATE()->m_oamAddr;
    }
    static inline uint16_t _PPUADDR ( void )
    {
-      return m_ppuAddr;
+      return STATE()->m_ppuAddr;
    }
    static inline uint8_t _PPUREADLATCH ( void )
    {
-      return m_ppuReadLatch;
+      return STATE()->m_ppuReadLatch;
    }
    static inline uint16_t _PPUADDRLATCH ( void )
    {
-      return m_ppuAddrLatch;
+      return STATE()->m_ppuAddrLatch;
    }
    static inline int32_t _PPUFLIPFLOP ( void )
    {
-      return m_ppuRegByte;
+      return STATE()->m_ppuRegByte;
    }
    static inline void _MIRROR(uint16_t* sc1, uint16_t* sc2, uint16_t* sc3, uint16_t* sc4)
    {
-      (*sc1) = ((uint8_t*)m_pPPUmemory[0]-(uint8_t*)m_PPUmemory)+MEM_8KB;
-      (*sc2) = ((uint8_t*)m_pPPUmemory[1]-(uint8_t*)m_PPUmemory)+MEM_8KB;
-      (*sc3) = ((uint8_t*)m_pPPUmemory[2]-(uint8_t*)m_PPUmemory)+MEM_8KB;
-      (*sc4) = ((uint8_t*)m_pPPUmemory[3]-(uint8_t*)m_PPUmemory)+MEM_8KB;
+      (*sc1) = ((uint8_t*)STATE()->m_pPPUmemory[0]-(uint8_t*)STATE()->m_PPUmemory)+MEM_8KB;
+      (*sc2) = ((uint8_t*)STATE()->m_pPPUmemory[1]-(uint8_t*)STATE()->m_PPUmemory)+MEM_8KB;
+      (*sc3) = ((uint8_t*)STATE()->m_pPPUmemory[2]-(uint8_t*)STATE()->m_PPUmemory)+MEM_8KB;
+      (*sc4) = ((uint8_t*)STATE()->m_pPPUmemory[3]-(uint8_t*)STATE()->m_PPUmemory)+MEM_8KB;
    }
 
    // Accessor functions for the database of scroll values indexed by pixel
@@ -449,26 +460,34 @@ public:
    // inspector.
    static inline uint16_t _SCROLLX ( int32_t x, int32_t y )
    {
-      return *(*(m_2005x+x)+y);
+      return *(*(STATE()->m_2005x+x)+y);
    }
    static inline uint16_t _SCROLLY ( int32_t x, int32_t y )
    {
-      return *(*(m_2005y+x)+y);
+      return *(*(STATE()->m_2005y+x)+y);
+   }
+   static inline const uint16_t* _SCROLLXCOLUMN ( int32_t x )
+   {
+      return *(STATE()->m_2005x+x);
+   }
+   static inline const uint16_t* _SCROLLYCOLUMN ( int32_t x )
+   {
+      return *(STATE()->m_2005y+x);
    }
    static inline void _SCROLL ( uint8_t* x, uint8_t* y )
    {
-      (*x) = m_last2005x;
-      (*y) = m_last2005y;
+      (*x) = STATE()->m_last2005x;
+      (*y) = STATE()->m_last2005y;
    }
 
    // Accessor functions for the pixel coordinate of the last sprite-0 hit.
    static inline uint8_t _SPRITE0HITX ( void )
    {
-      return m_lastSprite0HitX;
+      return STATE()->m_lastSprite0HitX;
    }
    static inline uint8_t _SPRITE0HITY ( void )
    {
-      return m_lastSprite0HitY;
+      return STATE()->m_lastSprite0HitY;
    }
 
    // Returns a running counter of the number of frames that have elapsed
@@ -477,37 +496,60 @@ public:
    // even then, roll-over of this counter is not a significant event.
    static inline uint32_t _FRAME ( void )
    {
-      return m_frame;
+      return STATE()->m_frame;
    }
 
    // Accessor functions for the pixel coordinate of the PPU during rendering.
    static inline uint8_t _X ( void )
    {
-      return m_x;
+      return STATE()->m_x;
    }
    static inline uint8_t _Y ( void )
    {
-      return m_y;
+      return STATE()->m_y;
    }
 
    // Accessor routines to get or set the rendering surface memory to
    // be used by the PPU to render the emulated machine's image.
    static inline void TV ( int8_t* pTV )
    {
-      m_pTV = pTV;
+      // Keep the position the non-debug renderer is drawing at on the same
+      // pixel of the new surface.
+      if ( STATE()->m_pTV && STATE()->m_pPixelTV )
+      {
+         STATE()->m_pPixelTV = pTV?pTV+(STATE()->m_pPixelTV-STATE()->m_pTV):NULL;
+      }
+      STATE()->m_pTV = pTV;
    }
    static inline int8_t* TV ( void )
    {
-      return m_pTV;
+      return STATE()->m_pTV;
    }
 
+   // Frame queue.  The PPU publishes the surface it drew at the end of each
+   // frame and, at the start of the next, moves on to the one it got back for
+   // it.  The UI acquires the latest published surface.  Surfaces only change
+   // hands through the atomic index of the published one, so neither side
+   // ever waits on the other.
+   static void TVQUEUE ( int8_t* tv0, int8_t* tv1, int8_t* tv2 );
+   static inline void STARTTV ( void )
+   {
+      if ( STATE()->m_tvQueue[0] )
+      {
+         TV ( STATE()->m_tvQueue[STATE()->m_tvBack] );
+      }
+   }
+   static void PUBLISHTV ( void );
+   static int8_t* ACQUIRETV ( void );
+   static void VIDEOINFORMATION ( nesVideoInfo* pInfo );
+
    // Accessor method used by some ROM mappers that can remap the
    // nametable memory in a more complicated fashion than straight mirroring.
    static inline void Move1KBank ( int32_t bank, uint8_t* point )
    {
       if ( bank >= 8 )
       {
-         m_pPPUmemory[bank-8] = point;
+         STATE()->m_pPPUmemory[bank-8] = point;
       }
    }
 
@@ -516,7 +558,7 @@ public:
    // Logger debugger inspector.
    static inline CCodeDataLogger* LOGGER ( void )
    {
-      return m_logger;
+      return STATE()->m_logger;
    }
 
    // Interface to retrieve the database defining the registers
@@ -562,207 +604,258 @@ public:
 protected:
    // Routines to access the RAM maintained by the PPU core object.
    // These are used internally by the PPU core during emulation.
-   static void STORE ( uint32_t addr, uint8_t data, int8_t source = eNESSource_PPU, int8_t type = eTracer_Unknown, bool trace = true );
-   static uint32_t LOAD ( uint32_t addr, int8_t source = eNESSource_PPU, int8_t type = eTracer_Unknown, bool trace = true );
+   template <class HOOKS> static void STORE ( uint32_t addr, uint8_t data, int8_t source = eNESSource_PPU, int8_t type = eTracer_Unknown, bool trace = true );
+   template <class HOOKS> static uint32_t LOAD ( uint32_t addr, int8_t source = eNESSource_PPU, int8_t type = eTracer_Unknown, bool trace = true );
 
    // Routines to access the RAM maintained by the PPU core object for rendering.
    // These are used internally by the PPU core during emulation.
-   static inline uint32_t RENDER ( uint32_t addr, int8_t target );
-   static inline void GARBAGE ( uint32_t addr, int8_t target );
-   static inline void EXTRA ();
+   template <class HOOKS> static inline uint32_t RENDER ( uint32_t addr, int8_t target );
+   template <class HOOKS> static inline void GARBAGE ( uint32_t addr, int8_t target );
+   template <class HOOKS> static inline void EXTRA ();
 
    // Routines that mimic the PPU bus behavior down to the PPU cycle.
    // These are used internally by the PPU core during emulation.
-   static inline void GATHERBKGND ( int8_t phase );
-   static inline void GATHERSPRITES ( int32_t scanline );
+   template <class HOOKS> static inline void GATHERBKGND ( int8_t phase );
+   template <class HOOKS> static inline void GATHERSPRITES ( int32_t scanline );
 
    // Routines that mimic the PPU OAM behavior down to the PPU cycle.
    // This is used internally by the PPU core during emulation.
-   static inline void BUILDSPRITELIST ( int32_t scanline, int32_t cycle );
+   template <class HOOKS> static inline void BUILDSPRITELIST ( int32_t scanline, int32_t cycle );
 
    // Routine that mimics the PPU's background barrel-shifters and
    // X-scroll pickoff.
    static inline void PIXELPIPELINES ( int32_t pickoff, uint8_t* a, uint8_t* b1, uint8_t* b2 );
 
+   // Routines used by the non-debug renderer, which composites the pixels
+   // of a scanline in runs rather than one per PPU cycle.  SPRITELINE
+   // flattens the sprite buffer into one entry per pixel at the start of a
+   // scanline.  RENDERPIXELS draws the pixels that are due but not yet drawn;
+   // it is called at each tile fetch and before any CPU access to the PPU
+   // registers so that the CPU never sees a pixel that is out of date.
+   static void SPRITELINE ( void );
+   static void RENDERPIXELS ( void );
+
+   // The data saved and restored as-is by SAVESTATE and LOADSTATE.
+   template <class STREAM> static void STATEDATA ( STREAM& stream );
+
    // Routine that initializes the PPU's palette memory on reset.
    static void PALETTESET ( uint8_t* data )
    {
-      memcpy(m_PALETTEmemory,data,MEM_32B);
+      memcpy(STATE()->m_PALETTEmemory,data,MEM_32B);
    }
 
 protected:
-   // The PPU core maintains 32B of palette RAM.
-   static uint8_t  m_PALETTEmemory [ MEM_32B ];
-
-   // The PPU core maintains 2KB of video RAM.
-   // Some mappers extend this by providing more memory on
-   // the cartridge.
-   static uint8_t*  m_PPUmemory;
-
-   // The PPU's video memory can be rearranged by some mappers.
-   // These pointers support that rearrangement.
-   static uint8_t* m_pPPUmemory [ 8 ];
-
-   // The PPU has an internal flip-flop which delivers
-   // bytes written to $2005 or $2006 to different locations
-   // within the PPU.  The flip-flop flips on each write to
-   // PPU address $2005, or $2007.  It is reset on reads from
-   // PPU address $2002.
-   static int32_t            m_ppuRegByte;
-
-   // Pre-calculated values based on video mode.
-   static uint32_t startVblank;
-   static uint32_t quietScanlines;
-   static uint32_t vblankScanlines;
-   static uint32_t vblankEndCycle;
-   static uint32_t prerenderScanline;
-   static uint32_t cycleRatio;
-   static uint32_t memoryDecayFrames;
-
-   // The PPU has an internal OAM address register that is
-   // accessed via PPU address $2003.  It is incremented on
-   // writes to $2004.
-   static uint8_t  m_oamAddr;
-
-   // The PPU has an internal address register that is used to
-   // generate the bus addresses accessed by the PPU during rendering.
-   // It is incremented on read/write of PPU address $2007.  It
-   // is updated from the PPU address latch (see below) on every
-   // other write to PPU address $2006 (ie. when the flip-flop is flipped
-   // in the right direction).
-   static uint16_t m_ppuAddr;
-
-   // The PPU has an internal address latch that is programmed
-   // via writes to PPU address $2000, $2005, $2006, and $2007.
-   // The latch is copied to the address register (see above)
-   // on every other write to PPU address $2006.
-   static uint16_t m_ppuAddrLatch;
-
-   // The PPU keeps track internally of whether it should be
-   // auto-incrementing its internal address register by 1
-   // (for horizontal updating) or by 32 (for vertical updating).
-   // This is set on writes to PPU address $2000.
-   static uint8_t  m_ppuAddrIncrement;
-
-   // The PPU has an internal latch that keeps the last value
-   // read by the PPU on an external memory fetch.  This provides
-   // a one-read-cycle delay between the PPU and CPU when the
-   // CPU requests data (via a read of PPU address $2007) from
-   // the PPU's visible memory space.  This latch is necessary so
-   // the CPU does not have to be held up while the PPU does the
-   // external memory fetch.  The latch does not apply to CPU
-   // accesses to PPU addresses in the range $3F00-$3FFF (the PPU's
-   // internal palette memory).  That data is returned immediately
-   // to the CPU on a read access of PPU address $2007 in that range.
-   static uint8_t  m_ppuReadLatch;
-
-   // The PPU has an internal hold-up on the bus between it and
-   // the CPU that causes the last value written to be readable
-   // for about 600 milliseconds.
-   static uint8_t m_ppuIOLatch;
-
-   // Each bit of the IO latch decays at the same rate but some
-   // might have been set to 1 more recently than others.
-   static uint8_t m_ppuIOLatchDecayFrames [ 8 ];
-
-   // The PPU has eight registers visible to the CPU in the CPU's
-   // memory map at address $2000 through $2007.  These are further
-   // mirrored throughout the CPU's memory map up to address $3FFF.
-   // The PPU keeps track internally of values written to the register
-   // ports so that the debugger inspectors can return actual data
-   // written to the registers instead of "open bus".  If the debugger
-   // inspectors want to, they can implement a mode where the inspector
-   // does infact reflect the actual state of the PPU as seen by the CPU.
-   // Typically, however, a user likes to see what has been written.
-   // I'll keep the "open bus" in mind though to provide accurate feedback
-   // as if the user were staring at an actual PPU.
-   static uint8_t  m_PPUreg [ NUM_PPU_REGS ];
-
-   // The PPU has space for 64 objects (sprites) in its internal
-   // Object Attribute Map (OAM) memory.
-   static uint8_t  m_PPUoam [ NUM_OAM_REGS ];
-
-   // The PPU maintains fine-X (0..7) scroll value which is used as the
-   // pick-off location in the barrel-shifter that does the rendering.
-   static uint8_t  m_ppuScrollX;
-
-   // The PPU maintains the state of mirroring of its internal video RAM.
-   // Some mappers only use one video screen's worth of RAM, others provide
-   // extra RAM for up to four independent video screens.  Most mappers use
-   // the two video screen's worth of RAM dedicated to the PPU in some
-   // mirrored fashion across the memory region which supports up to four
-   // video screen's worth.
-   static int32_t            m_oneScreen;
-   static bool           m_extraVRAM;
-
-   // Bounded counter of PPU cycles executed.  It resets to zero at the
-   // start of each PPU frame.
-   static uint32_t   m_cycles;
-
-   // Running counter of PPU frames drawn.  It will roll over after
-   // approximately 40 minutes of emulation.  However, this roll-over
-   // is not a significant event.
-   static uint32_t   m_frame;
-
-   // The current number of PPU cycles ready to be executed by
-   // the PPU core.
-   static int32_t            m_curCycles;
-
-   // If the CPU reads PPU address $2002 at a precise point within the
-   // PPU frame it can choke the setting of the VBLANK flag in that register.
-   static bool           m_vblankChoked;
-
-   // If the CPU reads PPU address $2002 at precise points within the
-   // PPU frame it can choke the assertion of NMI by the PPU.
-   static bool           m_nmiChoked;
-
-   // Re-enabling NMI flag in the PPU control register allows for re-assertion
-   // of NMI during VBLANK period.
-   static bool           m_nmiReenabled;
-
-   // This is the temporary memory used by the PPU to store gathered
-   // OAM data during pixel rendering.
-   static SpriteTemporaryMemory m_spriteTemporaryMemory;
-
-   // This is the secondary OAM that is used to keep track of in-view
-   // sprites on each scanline.
-   static SpriteBuffer     m_spriteBuffer;
-
-   // This is the background buffer of fetched tile data to be
-   // rendered on the next scanline.
-   static BackgroundBuffer m_bkgndBuffer;
-
-   // This is the rendering surface on which the PPU draws the
-   // emulated frame representing the true visual state of the
-   // NES as would be seen by a player.  The memory is allocated
-   // by the dialog class and passed to the PPU.
-   static int8_t*          m_pTV;
-
-   // These items are the database that keeps track of the status of the
-   // x and y scroll values for each rendered pixel.  This information is
-   // used by the nametable visualizer to highlight areas of the nametable
-   // memory internal to the PPU that are being rendered to the screen.
-   static uint8_t  m_last2005x;
-   static uint8_t  m_last2005y;
-   static uint16_t** m_2005x;
-   static uint16_t** m_2005y;
-
-   // These items are the position of the last sprite-0 hit event on the
-   // last rendered PPU frame.  They are invalidated at the start of each
-   // new frame.
-   static uint8_t  m_lastSprite0HitX;
-   static uint8_t  m_lastSprite0HitY;
-
-   // These items are the position of the pixel being rendered by the
-   // PPU on any given PPU cycle.  This information is used by the debugger.
-   static uint8_t  m_x;
-   static uint8_t  m_y;
-
-   // Database used by the Code/Data Logger debugger inspector.  The data structure
-   // is maintained by the PPU core as it performs fetches, reads,
-   // and writes to/from its managed RAM.  The
-   // Code/Data Logger displays the collected information graphically.
-   static CCodeDataLogger* m_logger;
+   friend struct NESContext;
+   struct State
+   {
+      State ();
+      ~State ();
+
+      // The PPU core maintains 32B of palette RAM.
+      uint8_t  m_PALETTEmemory [ MEM_32B ] = { 0, };
+
+      // The PPU core maintains 2KB of video RAM.
+      // Some mappers extend this by providing more memory on
+      // the cartridge.
+      uint8_t*  m_PPUmemory = NULL;
+
+      // The PPU's video memory can be rearranged by some mappers.
+      // These pointers support that rearrangement.
+      uint8_t* m_pPPUmemory [ 8 ] = { NULL, };
+
+      // The PPU has an internal flip-flop which delivers
+      // bytes written to $2005 or $2006 to different locations
+      // within the PPU.  The flip-flop flips on each write to
+      // PPU address $2005, or $2007.  It is reset on reads from
+      // PPU address $2002.
+      int32_t            m_ppuRegByte = 0;
+
+      // Pre-calculated values based on video mode.
+      uint32_t startVblank = 0;
+      uint32_t quietScanlines = 0;
+      uint32_t vblankScanlines = 0;
+      uint32_t vblankEndCycle = 0;
+      uint32_t prerenderScanline = 0;
+      uint32_t cycleRatio = 0;
+      uint32_t memoryDecayFrames = 0;
+
+      // The PPU has an internal OAM address register that is
+      // accessed via PPU address $2003.  It is incremented on
+      // writes to $2004.
+      uint8_t  m_oamAddr = 0x00;
+
+      // The PPU has an internal address register that is used to
+      // generate the bus addresses accessed by the PPU during rendering.
+      // It is incremented on read/write of PPU address $2007.  It
+      // is updated from the PPU address latch (see below) on every
+      // other write to PPU address $2006 (ie. when the flip-flop is flipped
+      // in the right direction).
+      uint16_t m_ppuAddr = 0x0000;
+
+      // The PPU has an internal address latch that is programmed
+      // via writes to PPU address $2000, $2005, $2006, and $2007.
+      // The latch is copied to the address register (see above)
+      // on every other write to PPU address $2006.
+      uint16_t m_ppuAddrLatch = 0x0000;
+
+      // The PPU keeps track internally of whether it should be
+      // auto-incrementing its internal address register by 1
+      // (for horizontal updating) or by 32 (for vertical updating).
+      // This is set on writes to PPU address $2000.
+      uint8_t  m_ppuAddrIncrement = 1;
+
+      // The PPU has an internal latch that keeps the last value
+      // read by the PPU on an external memory fetch.  This provides
+      // a one-read-cycle delay between the PPU and CPU when the
+      // CPU requests data (via a read of PPU address $2007) from
+      // the PPU's visible memory space.  This latch is necessary so
+      // the CPU does not have to be held up while the PPU does the
+      // external memory fetch.  The latch does not apply to CPU
+      // accesses to PPU addresses in the range $3F00-$3FFF (the PPU's
+      // internal palette memory).  That data is returned immediately
+      // to the CPU on a read access of PPU address $2007 in that range.
+      uint8_t  m_ppuReadLatch = 0x00;
+
+      // The PPU has an internal hold-up on the bus between it and
+      // the CPU that causes the last value written to be readable
+      // for about 600 milliseconds.
+      uint8_t m_ppuIOLatch = 0x00;
+
+      // Each bit of the IO latch decays at the same rate but some
+      // might have been set to 1 more recently than others.
+      uint8_t m_ppuIOLatchDecayFrames [ 8 ] = { 0, };
+
+      // The PPU has eight registers visible to the CPU in the CPU's
+      // memory map at address $2000 through $2007.  These are further
+      // mirrored throughout the CPU's memory map up to address $3FFF.
+      // The PPU keeps track internally of values written to the register
+      // ports so that the debugger inspectors can return actual data
+      // written to the registers instead of "open bus".  If the debugger
+      // inspectors want to, they can implement a mode where the inspector
+      // does infact reflect the actual state of the PPU as seen by the CPU.
+      // Typically, however, a user likes to see what has been written.
+      // I'll keep the "open bus" in mind though to provide accurate feedback
+      // as if the user were staring at an actual PPU.
+      uint8_t  m_PPUreg [ NUM_PPU_REGS ] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+      // The PPU has space for 64 objects (sprites) in its internal
+      // Object Attribute Map (OAM) memory.
+      uint8_t  m_PPUoam [ NUM_OAM_REGS ] = { 0x00, };
+
+      // The PPU maintains fine-X (0..7) scroll value which is used as the
+      // pick-off location in the barrel-shifter that does the rendering.
+      uint8_t  m_ppuScrollX = 0x00;
+
+      // The PPU maintains the state of mirroring of its internal video RAM.
+      // Some mappers only use one video screen's worth of RAM, others provide
+      // extra RAM for up to four independent video screens.  Most mappers use
+      // the two video screen's worth of RAM dedicated to the PPU in some
+      // mirrored fashion across the memory region which supports up to four
+      // video screen's worth.
+      int32_t            m_oneScreen = -1;
+      bool           m_extraVRAM = false;
+
+      // Bounded counter of PPU cycles executed.  It resets to zero at the
+      // start of each PPU frame.
+      uint32_t   m_cycles = 0;
+
+      // Running counter of PPU frames drawn.  It will roll over after
+      // approximately 40 minutes of emulation.  However, this roll-over
+      // is not a significant event.
+      uint32_t   m_frame = 0;
+
+      // The current number of PPU cycles ready to be executed by
+      // the PPU core.
+      int32_t            m_curCycles = 0;
+
+      // If the CPU reads PPU address $2002 at a precise point within the
+      // PPU frame it can choke the setting of the VBLANK flag in that register.
+      bool           m_vblankChoked = false;
+
+      // If the CPU reads PPU address $2002 at precise points within the
+      // PPU frame it can choke the assertion of NMI by the PPU.
+      bool           m_nmiChoked = false;
+
+      // Re-enabling NMI flag in the PPU control register allows for re-assertion
+      // of NMI during VBLANK period.
+      bool           m_nmiReenabled = false;
+
+      // This is the temporary memory used by the PPU to store gathered
+      // OAM data during pixel rendering.
+      SpriteTemporaryMemory m_spriteTemporaryMemory;
+
+      // This is the secondary OAM that is used to keep track of in-view
+      // sprites on each scanline.
+      SpriteBuffer     m_spriteBuffer;
+
+      // This is the background buffer of fetched tile data to be
+      // rendered on the next scanline.
+      BackgroundBuffer m_bkgndBuffer;
+
+      // This is the rendering surface on which the PPU draws the
+      // emulated frame representing the true visual state of the
+      // NES as would be seen by a player.  The memory is allocated
+      // by the dialog class and passed to the PPU.
+      int8_t*          m_pTV = NULL;
+
+      // The frame queue, if the UI has given the PPU one.  The surface the
+      // PPU draws into next is only touched by the emulator thread and the
+      // one the UI has acquired only by the UI.
+      int8_t*          m_tvQueue [ TV_QUEUE_SIZE ] = { NULL, };
+      int32_t          m_tvBack = 0;
+      int32_t          m_tvFront = 2;
+      std::atomic<int32_t>  m_tvReady { 1 };
+      std::atomic<uint32_t> m_tvFrames { 0 };
+      std::atomic<uint32_t> m_tvDropped { 0 };
+      std::atomic<uint32_t> m_tvDuplicated { 0 };
+
+      // These items are used by the non-debug renderer.  The sprite line
+      // holds, for each pixel of the scanline, the palette index of the
+      // frontmost opaque sprite pixel (0 if none) with SPRITELINE_BEHIND
+      // and SPRITELINE_SPRITE0 flags.  The pixel counts are how far
+      // across the scanline pixels have been drawn and are due to be drawn.
+      uint16_t         m_spriteLine [ 256 ] = { 0, };
+      int32_t          m_pixelX = 0;
+      int32_t          m_pixelDue = 0;
+      int8_t*          m_pPixelTV = NULL;
+
+      // These items are the database that keeps track of the status of the
+      // x and y scroll values for each rendered pixel.  This information is
+      // used by the nametable visualizer to highlight areas of the nametable
+      // memory internal to the PPU that are being rendered to the screen.
+      uint8_t  m_last2005x = 0;
+      uint8_t  m_last2005y = 0;
+      uint16_t** m_2005x = NULL;
+      uint16_t** m_2005y = NULL;
+
+      // These items are the position of the last sprite-0 hit event on the
+      // last rendered PPU frame.  They are invalidated at the start of each
+      // new frame.
+      uint8_t  m_lastSprite0HitX = 0;
+      uint8_t  m_lastSprite0HitY = 0;
+
+      // These items are the position of the pixel being rendered by the
+      // PPU on any given PPU cycle.  This information is used by the debugger.
+      uint8_t  m_x = 0xFF;
+      uint8_t  m_y = 0xFF;
+
+      // Database used by the Code/Data Logger debugger inspector.  The data structure
+      // is maintained by the PPU core as it performs fetches, reads,
+      // and writes to/from its managed RAM.  The
+      // Code/Data Logger displays the collected information graphically.
+      CCodeDataLogger* m_logger = NULL;
+
+      // Background tile fetch state carried across the fetch cycles.
+      uint16_t             m_bkgndPatternIdx = 0;
+      BackgroundBufferData m_bkgndTemp;
+
+      // Sprite evaluation state carried across the evaluation cycles.
+      // Evaluation writes go to m_spriteDevNull once eight sprites are found.
+      SpriteTemporaryMemoryData  m_spriteDevNull;
+      SpriteTemporaryMemoryData* m_pSpriteEval = &m_spriteDevNull;
+      int32_t                    m_spritesFound = 0;
+   };
+   static inline State* STATE ();
 
    // The database for PPU core registers.  Declaration
    // is in source file.
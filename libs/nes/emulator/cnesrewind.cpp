@@ -0,0 +1,505 @@
+//    NESICIDE - an IDE for the 8-bit NES.
+//    Copyright (C) 2009  Christopher S. Pow
+
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "cnesrewind.h"
+#include "cnes.h"
+#include "cnesstate.h"
+
+#include <chrono>
+
+#include "cnescontext.h"
+
+// Record header is size, frame, frames and delta size; the trailer is size.
+#define REWIND_RECORD_HEADER_SIZE  16
+#define REWIND_RECORD_TRAILER_SIZE 4
+
+// A new span costs two bytes of counts, so differences with fewer than
+// this many unchanged bytes between them are cheaper kept in one span.
+#define REWIND_SPAN_MERGE 2
+
+static inline uint32_t GETU32 ( const uint8_t* p )
+{
+   uint32_t v;
+   memcpy(&v,p,sizeof(v));
+   return v;
+}
+
+static inline void PUTU32 ( uint8_t* p, uint32_t v )
+{
+   memcpy(p,&v,sizeof(v));
+}
+
+static inline uint32_t PUTVARINT ( uint8_t* p, uint32_t v )
+{
+   uint32_t n = 0;
+
+   while ( v >= 0x80 )
+   {
+      p[n++] = (v&0x7F)|0x80;
+      v >>= 7;
+   }
+   p[n++] = v;
+
+   return n;
+}
+
+static inline uint32_t GETVARINT ( const uint8_t* p, uint32_t* pos )
+{
+   uint32_t v = 0;
+   uint32_t shift = 0;
+   uint8_t  b;
+
+   do
+   {
+      b = p[(*pos)++];
+      v |= (b&0x7F)<<shift;
+      shift += 7;
+   } while ( b&0x80 );
+
+   return v;
+}
+
+CNESRewind::State::~State ()
+{
+   delete [] m_pArena;
+   delete [] m_pTop;
+   delete [] m_pScratch;
+   delete [] m_pDelta;
+   delete [] m_pInputs;
+}
+
+bool CNESRewind::ENABLE ( uint32_t arenaSize, uint32_t interval )
+{
+   DISABLE ();
+
+   if ( (arenaSize < MEM_1KB) || (interval == 0) )
+   {
+      return false;
+   }
+
+   STATE()->m_pArena = new uint8_t[arenaSize];
+   STATE()->m_arenaSize = arenaSize;
+   STATE()->m_interval = interval;
+   STATE()->m_pInputs = new uint32_t[interval*NUM_CONTROLLERS];
+
+   CLEAR ();
+
+   return true;
+}
+
+void CNESRewind::DISABLE ( void )
+{
+   delete [] STATE()->m_pArena;
+   STATE()->m_pArena = NULL;
+   STATE()->m_arenaSize = 0;
+   delete [] STATE()->m_pTop;
+   STATE()->m_pTop = NULL;
+   delete [] STATE()->m_pScratch;
+   STATE()->m_pScratch = NULL;
+   delete [] STATE()->m_pDelta;
+   STATE()->m_pDelta = NULL;
+   delete [] STATE()->m_pInputs;
+   STATE()->m_pInputs = NULL;
+   STATE()->m_stateSize = 0;
+
+   CLEAR ();
+}
+
+void CNESRewind::CLEAR ( void )
+{
+   STATE()->m_head = 0;
+   STATE()->m_tail = 0;
+   STATE()->m_wrap = 0;
+   STATE()->m_bWrapped = false;
+   STATE()->m_count = 0;
+   STATE()->m_bHaveTop = false;
+   STATE()->m_topFrame = 0;
+   STATE()->m_frame = 0;
+   STATE()->m_lastRecordSize = 0;
+   STATE()->m_captures = 0;
+   STATE()->m_captureTime = 0;
+}
+
+
+uint32_t CNESRewind::DELTA ( const uint8_t* a, const uint8_t* b, uint32_t size, uint8_t* out )
+{
+   uint32_t pos = 0;
+   uint32_t o = 0;
+   uint32_t start;
+   uint32_t first;
+   uint32_t last;
+   uint32_t idx;
+   uint64_t wa;
+   uint64_t wb;
+
+   while ( pos < size )
+   {
+      // Skip the unchanged bytes, a word at a time while we can.
+      start = pos;
+      while ( pos+sizeof(uint64_t) <= size )
+      {
+         memcpy(&wa,a+pos,sizeof(wa));
+         memcpy(&wb,b+pos,sizeof(wb));
+         if ( wa != wb )
+         {
+            break;
+         }
+         pos += sizeof(uint64_t);
+      }
+      while ( (pos < size) && (a[pos] == b[pos]) )
+      {
+         pos++;
+      }
+      if ( pos == size )
+      {
+         break;
+      }
+
+      // Take in changed bytes until there's a long enough unchanged stretch.
+      first = pos;
+      last = pos;
+      while ( (pos < size) && (pos-last <= REWIND_SPAN_MERGE) )
+      {
+         if ( a[pos] != b[pos] )
+         {
+            last = pos;
+         }
+         pos++;
+      }
+
+      o += PUTVARINT ( out+o, first-start );
+      o += PUTVARINT ( out+o, last+1-first );
+      for ( idx = first; idx <= last; idx++ )
+      {
+         out[o++] = a[idx]^b[idx];
+      }
+      pos = last+1;
+   }
+
+   return o;
+}
+
+void CNESRewind::APPLYDELTA ( uint8_t* state, uint32_t size, const uint8_t* delta, uint32_t deltaSize )
+{
+   uint32_t pos = 0;
+   uint32_t o = 0;
+   uint32_t count;
+
+   while ( o < deltaSize )
+   {
+      pos += GETVARINT ( delta, &o );
+      count = GETVARINT ( delta, &o );
+      if ( (pos+count > size) || (o+count > deltaSize) )
+      {
+         return;
+      }
+      while ( count-- )
+      {
+         state[pos++] ^= delta[o++];
+      }
+   }
+}
+
+uint8_t* CNESRewind::APPEND ( uint32_t size )
+{
+   uint8_t* pRecord;
+
+   // A record that can never fit ends the history here.
+   if ( size > STATE()->m_arenaSize )
+   {
+      STATE()->m_count = 0;
+      return NULL;
+   }
+
+   for ( ; ; )
+   {
+      if ( !STATE()->m_count )
+      {
+         STATE()->m_head = 0;
+         STATE()->m_tail = 0;
+         STATE()->m_bWrapped = false;
+      }
+      if ( !STATE()->m_bWrapped )
+      {
+         if ( STATE()->m_head+size <= STATE()->m_arenaSize )
+         {
+            break;
+         }
+
+         // Records aren't split, so go back to the start of the arena.
+         STATE()->m_wrap = STATE()->m_head;
+         STATE()->m_head = 0;
+         STATE()->m_bWrapped = true;
+      }
+      if ( STATE()->m_head+size <= STATE()->m_tail )
+      {
+         break;
+      }
+      REMOVEOLDEST ();
+   }
+
+   pRecord = STATE()->m_pArena+STATE()->m_head;
+   STATE()->m_head += size;
+   STATE()->m_count++;
+
+   return pRecord;
+}
+
+void CNESRewind::REMOVEOLDEST ( void )
+{
+   STATE()->m_tail += GETU32(STATE()->m_pArena+STATE()->m_tail);
+   STATE()->m_count--;
+
+   if ( STATE()->m_bWrapped && (STATE()->m_tail == STATE()->m_wrap) )
+   {
+      STATE()->m_tail = 0;
+      STATE()->m_bWrapped = false;
+   }
+}
+
+bool CNESRewind::REMOVENEWEST ( void )
+{
+   uint8_t* pRecord;
+   uint32_t frames;
+
+   if ( !STATE()->m_count )
+   {
+      return false;
+   }
+
+   if ( STATE()->m_bWrapped && (STATE()->m_head == 0) )
+   {
+      STATE()->m_head = STATE()->m_wrap;
+      STATE()->m_bWrapped = false;
+   }
+   STATE()->m_head -= GETU32(STATE()->m_pArena+STATE()->m_head-REWIND_RECORD_TRAILER_SIZE);
+   STATE()->m_count--;
+
+   pRecord = STATE()->m_pArena+STATE()->m_head;
+   frames = GETU32(pRecord+8);
+
+   // Turn the newest snapshot back into the one before it and pick up the
+   // inputs of the frames that followed that one.
+   APPLYDELTA ( STATE()->m_pTop,
+                STATE()->m_topSize,
+                pRecord+REWIND_RECORD_HEADER_SIZE+(frames*NUM_CONTROLLERS*sizeof(uint32_t)),
+                GETU32(pRecord+12) );
+   memcpy(STATE()->m_pInputs,pRecord+REWIND_RECORD_HEADER_SIZE,frames*NUM_CONTROLLERS*sizeof(uint32_t));
+   STATE()->m_topFrame = GETU32(pRecord+4);
+
+   return true;
+}
+
+uint32_t CNESRewind::OLDESTFRAME ( void )
+{
+   if ( STATE()->m_count )
+   {
+      return GETU32(STATE()->m_pArena+STATE()->m_tail+4);
+   }
+   return STATE()->m_topFrame;
+}
+
+void CNESRewind::CAPTURE ( void )
+{
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   uint32_t size;
+   uint32_t frames;
+   uint32_t deltaSize;
+   uint32_t recordSize;
+   uint8_t* pRecord;
+   uint8_t* pSwap;
+
+   // A new history is sized for the cartridge that is loaded now.
+   if ( !STATE()->m_bHaveTop )
+   {
+      CNESStateWriter counter ( NULL, 0, false );
+
+      CNES::SAVESTATE ( counter );
+      size = counter.FINISH();
+      if ( size > STATE()->m_stateSize )
+      {
+         delete [] STATE()->m_pTop;
+         delete [] STATE()->m_pScratch;
+         delete [] STATE()->m_pDelta;
+         STATE()->m_pTop = new uint8_t[size];
+         STATE()->m_pScratch = new uint8_t[size];
+         STATE()->m_pDelta = new uint8_t[DELTAMAXSIZE(size)];
+         STATE()->m_stateSize = size;
+      }
+   }
+
+   CNESStateWriter writer ( STATE()->m_pScratch, STATE()->m_stateSize, false );
+
+   CNES::SAVESTATE ( writer );
+   size = writer.FINISH();
+   if ( !size )
+   {
+      CLEAR ();
+      return;
+   }
+
+   if ( STATE()->m_bHaveTop && (size == STATE()->m_topSize) )
+   {
+      frames = STATE()->m_frame-STATE()->m_topFrame;
+      deltaSize = DELTA ( STATE()->m_pTop, STATE()->m_pScratch, size, STATE()->m_pDelta );
+      recordSize = REWIND_RECORD_HEADER_SIZE+
+                   (frames*NUM_CONTROLLERS*sizeof(uint32_t))+
+                   deltaSize+
+                   REWIND_RECORD_TRAILER_SIZE;
+      recordSize = (recordSize+3)&(~3);
+
+      pRecord = APPEND ( recordSize );
+      if ( pRecord )
+      {
+         PUTU32 ( pRecord, recordSize );
+         PUTU32 ( pRecord+4, STATE()->m_topFrame );
+         PUTU32 ( pRecord+8, frames );
+         PUTU32 ( pRecord+12, deltaSize );
+         memcpy(pRecord+REWIND_RECORD_HEADER_SIZE,STATE()->m_pInputs,frames*NUM_CONTROLLERS*sizeof(uint32_t));
+         memcpy(pRecord+REWIND_RECORD_HEADER_SIZE+(frames*NUM_CONTROLLERS*sizeof(uint32_t)),STATE()->m_pDelta,deltaSize);
+         PUTU32 ( pRecord+recordSize-REWIND_RECORD_TRAILER_SIZE, recordSize );
+      }
+      STATE()->m_lastRecordSize = recordSize;
+   }
+   else
+   {
+      // Can't get from this state back to the last one.
+      STATE()->m_count = 0;
+   }
+
+   // The new state becomes the newest snapshot.
+   pSwap = STATE()->m_pTop;
+   STATE()->m_pTop = STATE()->m_pScratch;
+   STATE()->m_pScratch = pSwap;
+   STATE()->m_topSize = size;
+   STATE()->m_topFrame = STATE()->m_frame;
+   STATE()->m_bHaveTop = true;
+
+   STATE()->m_captures++;
+   STATE()->m_captureTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-start).count();
+}
+
+uint32_t CNESRewind::FRAMESAVAILABLE ( void )
+{
+   uint32_t oldest;
+
+   if ( !STATE()->m_bHaveTop )
+   {
+      return 0;
+   }
+
+   // The frame before the target is re-run, so the oldest snapshot can
+   // only be gone back to if it's the first frame of the history.
+   oldest = OLDESTFRAME();
+   if ( oldest == 0 )
+   {
+      return STATE()->m_frame;
+   }
+   if ( STATE()->m_frame > oldest+1 )
+   {
+      return STATE()->m_frame-oldest-1;
+   }
+   return 0;
+}
+
+bool CNESRewind::STEPBACK ( uint32_t frames )
+{
+   uint32_t target;
+   uint32_t need;
+   uint32_t joy [ NUM_CONTROLLERS ];
+   uint32_t idx;
+   bool     breakpoints;
+   bool     record;
+   void (*breakpointHook)(void);
+   void (*audioHook)(void);
+
+   if ( (!STATE()->m_pArena) || (frames > FRAMESAVAILABLE()) )
+   {
+      return false;
+   }
+   if ( frames == 0 )
+   {
+      return true;
+   }
+
+   target = STATE()->m_frame-frames;
+   need = target?target-1:0;
+
+   while ( STATE()->m_topFrame > need )
+   {
+      REMOVENEWEST ();
+   }
+
+   CNESStateReader reader ( STATE()->m_pTop, STATE()->m_topSize );
+
+   if ( !CNES::LOADSTATE(reader) )
+   {
+      // Our own snapshot should always load; if it didn't the NES
+      // is in no state to follow on from the history.
+      CLEAR ();
+      return false;
+   }
+   STATE()->m_frame = STATE()->m_topFrame;
+
+   // Re-run up to the target frame without stopping at breakpoints,
+   // recording the inputs again or waiting on the audio.
+   breakpoints = CNES::BREAKPOINTSENABLED();
+   record = CNES::RECORD();
+   breakpointHook = __nescontext->breakpointHook;
+   audioHook = __nescontext->audioHook;
+   CNES::BREAKPOINTS ( false );
+   CNES::RECORD ( false );
+   __nescontext->breakpointHook = NULL;
+   __nescontext->audioHook = NULL;
+
+   while ( STATE()->m_frame < target )
+   {
+      idx = (STATE()->m_frame-STATE()->m_topFrame)*NUM_CONTROLLERS;
+      joy[CONTROLLER1] = STATE()->m_pInputs[idx+CONTROLLER1];
+      joy[CONTROLLER2] = STATE()->m_pInputs[idx+CONTROLLER2];
+      CNES::RUN ( joy );
+   }
+
+   CNES::BREAKPOINTS ( breakpoints );
+   CNES::RECORD ( record );
+   __nescontext->breakpointHook = breakpointHook;
+   __nescontext->audioHook = audioHook;
+
+   return true;
+}
+
+void CNESRewind::INFORMATION ( nesRewindInfo* pInfo )
+{
+   pInfo->arenaSize = STATE()->m_arenaSize;
+   if ( STATE()->m_bWrapped )
+   {
+      pInfo->arenaUsed = (STATE()->m_wrap-STATE()->m_tail)+STATE()->m_head;
+   }
+   else
+   {
+      pInfo->arenaUsed = STATE()->m_head-STATE()->m_tail;
+   }
+   if ( !STATE()->m_count )
+   {
+      pInfo->arenaUsed = 0;
+   }
+   pInfo->stateSize = STATE()->m_topSize;
+   pInfo->interval = STATE()->m_interval;
+   pInfo->snapshots = STATE()->m_count+(STATE()->m_bHaveTop?1:0);
+   pInfo->framesAvailable = FRAMESAVAILABLE();
+   pInfo->lastSnapshotSize = STATE()->m_lastRecordSize;
+   pInfo->captureTime = STATE()->m_captures?(uint32_t)(STATE()->m_captureTime/STATE()->m_captures):0;
+}
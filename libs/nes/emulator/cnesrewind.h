@@ -0,0 +1,135 @@
+#if !defined ( NESREWIND_H )
+#define NESREWIND_H
+
+#include "nes_emulator_core.h"
+
+// The CNESRewind class keeps a history of save states so the emulation can
+// be stepped backwards.  Every m_interval frames CNES::RUN has it take a
+// full, uncompressed save state.  Only the newest one is kept whole.  Older
+// ones are kept as the XOR of each state with the one taken after it, with
+// the runs of zero bytes squeezed out.  Frame to frame most of the NES does
+// not change, so the differences are small.  Because XOR is its own inverse,
+// applying the newest difference to the newest state gives back the one
+// before it, and so on down the history.
+//
+// The differences live in an arena that is allocated once, when rewind is
+// enabled, and is used as a ring: when it fills up the oldest differences
+// are dropped.  Each one carries the joypad inputs of the frames it covers,
+// so stepping back to a frame between two snapshots loads the snapshot
+// before it and re-runs the frames in between with the same inputs.
+//
+// Arena record layout (4-byte aligned):
+//    size              uint32_t (whole record)
+//    frame             uint32_t (frame the snapshot was taken at)
+//    frames            uint32_t (number of frames of inputs)
+//    delta size        uint32_t
+//    inputs            uint32_t [ frames ][ NUM_CONTROLLERS ]
+//    delta             delta size bytes
+//    size              uint32_t (repeated so the newest record can be found)
+class CNESRewind
+{
+public:
+   // Allocates the arena and starts a new history.  ENABLE can be
+   // called again to change the arena size or interval.
+   static bool ENABLE ( uint32_t arenaSize, uint32_t interval );
+   static void DISABLE ( void );
+   static bool ENABLED ( void )
+   {
+      return STATE()->m_pArena != NULL;
+   }
+
+   // Forgets the history.  Called whenever the NES is put into a state
+   // that doesn't follow on from the last frame (reset, state load).
+   static void CLEAR ( void );
+
+   // Called by CNES::RUN at the start of every frame with the joypad inputs
+   // for the frame.  Takes a snapshot if one is due.
+   static void FRAME ( uint32_t* joy )
+   {
+      if ( STATE()->m_pArena )
+      {
+         if ( (!STATE()->m_bHaveTop) ||
+              ((STATE()->m_frame-STATE()->m_topFrame) >= STATE()->m_interval) )
+         {
+            CAPTURE ();
+         }
+         STATE()->m_pInputs[((STATE()->m_frame-STATE()->m_topFrame)*NUM_CONTROLLERS)+CONTROLLER1] = joy[CONTROLLER1];
+         STATE()->m_pInputs[((STATE()->m_frame-STATE()->m_topFrame)*NUM_CONTROLLERS)+CONTROLLER2] = joy[CONTROLLER2];
+         STATE()->m_frame++;
+      }
+   }
+
+   // Puts the emulation back the given number of frames.  The frame before
+   // the target frame is re-run so the TV output is that of the target
+   // frame.  Must be called between frames.  Returns false, and changes
+   // nothing, if the history doesn't go back that far.
+   static bool STEPBACK ( uint32_t frames );
+
+   // How many frames STEPBACK can go back from here.
+   static uint32_t FRAMESAVAILABLE ( void );
+
+   static void INFORMATION ( nesRewindInfo* pInfo );
+
+protected:
+   static void CAPTURE ( void );
+   static uint8_t* APPEND ( uint32_t size );
+   static void REMOVEOLDEST ( void );
+   static bool REMOVENEWEST ( void );
+   static uint32_t OLDESTFRAME ( void );
+
+   // The XOR of two states of size bytes, encoded as a list of
+   // (zero run, literal count, literal bytes) spans with varint counts.
+   // Trailing zeros are not encoded.  DELTA returns the encoded size; the
+   // output buffer must be DELTAMAXSIZE(size) bytes.
+   static uint32_t DELTA ( const uint8_t* a, const uint8_t* b, uint32_t size, uint8_t* out );
+   static void APPLYDELTA ( uint8_t* state, uint32_t size, const uint8_t* delta, uint32_t deltaSize );
+   static inline uint32_t DELTAMAXSIZE ( uint32_t size )
+   {
+      return size+(size>>3)+16;
+   }
+
+   friend struct NESContext;
+   struct State
+   {
+      State () {}
+      ~State ();
+
+      // The arena holding the history.
+      uint8_t* m_pArena = NULL;
+      uint32_t m_arenaSize = 0;
+
+      // Frames between snapshots.
+      uint32_t m_interval = 1;
+
+      // Ring bookkeeping.  Records run from m_tail to m_head; once the
+      // ring has wrapped they run from m_tail to m_wrap and then from the
+      // start of the arena to m_head.
+      uint32_t m_head = 0;
+      uint32_t m_tail = 0;
+      uint32_t m_wrap = 0;
+      bool     m_bWrapped = false;
+      uint32_t m_count = 0;
+
+      // The newest snapshot, kept whole, and the frame it was taken at.
+      // The inputs of the frames since then are in m_pInputs.
+      uint8_t*  m_pTop = NULL;
+      uint8_t*  m_pScratch = NULL;
+      uint8_t*  m_pDelta = NULL;
+      uint32_t* m_pInputs = NULL;
+      uint32_t  m_stateSize = 0;
+      uint32_t  m_topSize = 0;
+      uint32_t  m_topFrame = 0;
+      bool      m_bHaveTop = false;
+
+      // Frames run since the history was started.
+      uint32_t m_frame = 0;
+
+      // Capture cost statistics.
+      uint32_t m_lastRecordSize = 0;
+      uint32_t m_captures = 0;
+      uint64_t m_captureTime = 0;
+   };
+   static inline State* STATE ();
+};
+
+#endif
@@ -17,6 +17,7 @@
 #include "cnesrom.h"
 #include "cnesppu.h"
 #include "cnes6502.h"
+#include "cnescontext.h"
 
 // Mapper Event breakpoints
 bool mapperIRQEvent(BreakpointInfo* pBreakpoint,int data)
@@ -31,8 +32,6 @@ static CBreakpointEventInfo* tblMapperEvents [] =
    new CBreakpointEventInfo("IRQ", mapperIRQEvent, 0, "Break if mapper asserts IRQ", 10),
 };
 
-CRegisterDatabase*  CROM::m_dbRegisters = NULL;
-
 static CMemoryDatabase* dbSRAMMemory = new CMemoryDatabase(eMemory_cartSRAM,
                                                            SRAM_START,
                                                            MEM_8KB,
@@ -94,74 +93,38 @@ CMemoryDatabase* CROM::m_dbCHRMemory = dbCHRMemory;
 CBreakpointEventInfo** CROM::m_tblBreakpointEvents = tblMapperEvents;
 int32_t                CROM::m_numBreakpointEvents = NUM_MAPPER_EVENTS;
 
-uint8_t** CROM::m_PRGROMmemory = NULL;
-uint8_t** CROM::m_CHRmemory = NULL;
-uint8_t*  CROM::m_pPRGROMmemory [] = { NULL, NULL, NULL, NULL };
-uint8_t*  CROM::m_pCHRmemory [] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
-uint8_t** CROM::m_SRAMmemory = NULL;
-uint8_t*  CROM::m_pSRAMmemory [] = { NULL, NULL, NULL, NULL, NULL };
-uint8_t*  CROM::m_EXRAMmemory = NULL;
-
-uint32_t           CROM::m_mapper = 0;
-uint32_t           CROM::m_numPrgBanks = 0;
-uint32_t           CROM::m_numChrBanks = 0;
-
-CCodeDataLogger* CROM::m_pLogger [] = { NULL, };
-CCodeDataLogger* CROM::m_pEXRAMLogger = NULL;
-CCodeDataLogger* CROM::m_pSRAMLogger [] = { NULL, };
-
-uint8_t**  CROM::m_PRGROMopcodeMask = NULL;
-bool*      CROM::m_PRGROMopcodeMaskDirty  = NULL;
-char***    CROM::m_PRGROMdisassembly = NULL;
-uint16_t** CROM::m_PRGROMsloc2addr = NULL;
-uint16_t** CROM::m_PRGROMaddr2sloc = NULL;
-uint32_t*  CROM::m_PRGROMsloc = NULL;
-uint8_t**  CROM::m_SRAMopcodeMask = NULL;
-bool*      CROM::m_SRAMopcodeMaskDirty = NULL;
-char***    CROM::m_SRAMdisassembly = NULL;
-uint16_t** CROM::m_SRAMsloc2addr = NULL;
-uint16_t** CROM::m_SRAMaddr2sloc = NULL;
-uint32_t*  CROM::m_SRAMsloc = NULL;
-bool       CROM::m_SRAMdirty = false;
-uint8_t*   CROM::m_EXRAMopcodeMask = NULL;
-bool       CROM::m_EXRAMopcodeMaskDirty = false;
-char**     CROM::m_EXRAMdisassembly = NULL;
-uint16_t*  CROM::m_EXRAMsloc2addr = NULL;
-uint16_t*  CROM::m_EXRAMaddr2sloc = NULL;
-uint32_t   CROM::m_EXRAMsloc = 0;
-
-static CROM __init __attribute__((unused));
-
-CROM::CROM()
+CROM::State::State ()
 {
    int32_t bank;
    int32_t addr;
 
+   m_unloadedOpcodeMask = new uint8_t[MEM_8KB];
+   m_unloadedSloc2addr = new uint16_t[MEM_8KB];
+   m_unloadedAddr2sloc = new uint16_t[MEM_8KB];
+   m_pUnloadedLogger = new CCodeDataLogger ( MEM_8KB, MASK_8KB );
+   for ( addr = 0; addr < MEM_8KB; addr++ )
+   {
+      m_unloadedOpcodeMask[addr] = 0;
+      m_unloadedSloc2addr[addr] = 0;
+      m_unloadedAddr2sloc[addr] = 0;
+   }
+
    m_PRGROMmemory = new uint8_t*[NUM_ROM_BANKS];
-   m_PRGROMdisassembly = new char**[NUM_ROM_BANKS];
-   m_PRGROMopcodeMaskDirty = new bool[NUM_ROM_BANKS];
+   m_PRGROMopcodeMaskDirty = new DirtyRange[NUM_ROM_BANKS];
    m_PRGROMopcodeMask = new uint8_t*[NUM_ROM_BANKS];
    m_PRGROMsloc2addr = new uint16_t*[NUM_ROM_BANKS];
    m_PRGROMaddr2sloc = new uint16_t*[NUM_ROM_BANKS];
    m_PRGROMsloc = new uint32_t[NUM_ROM_BANKS];
    for ( bank = 0; bank < NUM_ROM_BANKS; bank++ )
    {
-      m_PRGROMmemory[bank] = new uint8_t[MEM_8KB+1]; // Leave room for bank ID.
-      m_PRGROMdisassembly[bank] = new char*[MEM_8KB];
-      m_PRGROMopcodeMaskDirty[bank] = true;
-      m_PRGROMopcodeMask[bank] = new uint8_t[MEM_8KB];
-      m_PRGROMsloc2addr[bank] = new uint16_t[MEM_8KB];
-      m_PRGROMaddr2sloc[bank] = new uint16_t[MEM_8KB];
+      m_PRGROMmemory[bank] = new uint8_t[MEM_8KB+1](); // Leave room for bank ID.
+      m_PRGROMopcodeMaskDirty[bank].start = 0;
+      m_PRGROMopcodeMaskDirty[bank].end = MEM_8KB-1;
+      m_PRGROMopcodeMask[bank] = m_unloadedOpcodeMask;
+      m_PRGROMsloc2addr[bank] = m_unloadedSloc2addr;
+      m_PRGROMaddr2sloc[bank] = m_unloadedAddr2sloc;
       m_PRGROMsloc[bank] = 0;
-      m_pLogger [ bank ] = new CCodeDataLogger ( MEM_8KB, MASK_8KB );
-
-      for ( addr = 0; addr < MEM_8KB; addr++ )
-      {
-         m_PRGROMdisassembly[bank][addr] = new char [ 16 ];
-         m_PRGROMopcodeMask[bank][addr] = 0;
-         m_PRGROMsloc2addr[bank][addr] = 0;
-         m_PRGROMaddr2sloc[bank][addr] = 0;
-      }
+      m_pLogger [ bank ] = m_pUnloadedLogger;
 
       // Store bank ID in bank data at the end.  This is used only
       // by code that needs to calculate absolute address stuff.
@@ -171,17 +134,16 @@ CROM::CROM()
    }
 
    m_SRAMmemory = new uint8_t*[NUM_SRAM_BANKS];
-   m_SRAMdisassembly = new char**[NUM_SRAM_BANKS];
-   m_SRAMopcodeMaskDirty = new bool[NUM_SRAM_BANKS];
+   m_SRAMopcodeMaskDirty = new DirtyRange[NUM_SRAM_BANKS];
    m_SRAMopcodeMask = new uint8_t*[NUM_SRAM_BANKS];
    m_SRAMsloc2addr = new uint16_t*[NUM_SRAM_BANKS];
    m_SRAMaddr2sloc = new uint16_t*[NUM_SRAM_BANKS];
    m_SRAMsloc = new uint32_t[NUM_SRAM_BANKS];
    for ( bank = 0; bank < NUM_SRAM_BANKS; bank++ )
    {
-      m_SRAMmemory[bank] = new uint8_t[MEM_8KB+1]; // Leave room for bank ID.
-      m_SRAMdisassembly[bank] = new char*[MEM_8KB];
-      m_SRAMopcodeMaskDirty[bank] = true;
+      m_SRAMmemory[bank] = new uint8_t[MEM_8KB+1](); // Leave room for bank ID.
+      m_SRAMopcodeMaskDirty[bank].start = 0;
+      m_SRAMopcodeMaskDirty[bank].end = MEM_8KB-1;
       m_SRAMopcodeMask[bank] = new uint8_t[MEM_8KB];
       m_SRAMsloc2addr[bank] = new uint16_t[MEM_8KB];
       m_SRAMaddr2sloc[bank] = new uint16_t[MEM_8KB];
@@ -190,7 +152,6 @@ CROM::CROM()
 
       for ( addr = 0; addr < MEM_8KB; addr++ )
       {
-         m_SRAMdisassembly[bank][addr] = new char [ 16 ];
          m_SRAMopcodeMask[bank][addr] = 0;
          m_SRAMsloc2addr[bank][addr] = 0;
          m_SRAMaddr2sloc[bank][addr] = 0;
@@ -203,15 +164,13 @@ CROM::CROM()
       m_SRAMmemory[bank][MEM_8KB] = bank;
    }
 
-   m_EXRAMmemory = new uint8_t[MEM_1KB];
-   m_EXRAMdisassembly = new char*[MEM_1KB];
+   m_EXRAMmemory = new uint8_t[MEM_1KB]();
    m_EXRAMopcodeMask = new uint8_t[MEM_1KB];
    m_EXRAMsloc2addr = new uint16_t[MEM_1KB];
    m_EXRAMaddr2sloc = new uint16_t[MEM_1KB];
    m_pEXRAMLogger = new CCodeDataLogger ( MEM_1KB, MASK_1KB );
    for ( addr = 0; addr < MEM_1KB; addr++ )
    {
-      m_EXRAMdisassembly[addr] = new char [ 16 ];
       m_EXRAMopcodeMask[addr] = 0;
       m_EXRAMsloc2addr[addr] = 0;
       m_EXRAMaddr2sloc[addr] = 0;
@@ -220,7 +179,7 @@ CROM::CROM()
    m_CHRmemory = new uint8_t*[NUM_CHR_BANKS];
    for ( bank = 0; bank < NUM_CHR_BANKS; bank++ )
    {
-      m_CHRmemory[bank] = new uint8_t[MEM_1KB+1]; // Leave room for bank ID.
+      m_CHRmemory[bank] = new uint8_t[MEM_1KB+1](); // Leave room for bank ID.
 
       // Store bank ID in bank data at the end.  This is used only
       // by code that needs to calculate absolute address stuff.
@@ -229,6 +188,17 @@ CROM::CROM()
       m_CHRmemory[bank][MEM_1KB] = bank;
    }
 
+   // Map the banks as RESET would with no cartridge loaded, so the CPU
+   // and PPU have memory to look at before the first one.
+   for ( bank = 0; bank < 4; bank++ )
+   {
+      m_pPRGROMmemory [ bank ] = m_PRGROMmemory [ bank ];
+   }
+   for ( bank = 0; bank < 8; bank++ )
+   {
+      m_pCHRmemory [ bank ] = m_CHRmemory [ bank ];
+   }
+
    // Assume identity-mapped SRAM...
    // There are five possible concurrently-visible 8KB
    // SRAM banks in MMC5: (0x6000 - 0xFFFF).  Other
@@ -237,28 +207,27 @@ CROM::CROM()
    {
       m_pSRAMmemory [ bank ] = *(m_SRAMmemory+bank);
    }
-
-   CROM::RESET ( false );
 }
 
-CROM::~CROM()
+CROM::State::~State ()
 {
    int32_t bank;
-   int32_t addr;
 
    for ( bank = 0; bank < NUM_ROM_BANKS; bank++ )
    {
-      delete m_pLogger [ bank ];
-
-      for ( addr = 0; addr < MEM_8KB; addr++ )
+      if ( bank < m_numPrgBankTables )
       {
-         delete m_PRGROMdisassembly[bank][addr];
+         delete m_pLogger [ bank ];
+         delete [] m_PRGROMopcodeMask[bank];
+         delete [] m_PRGROMsloc2addr[bank];
+         delete [] m_PRGROMaddr2sloc[bank];
       }
       delete [] m_PRGROMmemory[bank];
-      delete [] m_PRGROMopcodeMask[bank];
-      delete [] m_PRGROMsloc2addr[bank];
-      delete [] m_PRGROMaddr2sloc[bank];
    }
+   delete m_pUnloadedLogger;
+   delete [] m_unloadedOpcodeMask;
+   delete [] m_unloadedSloc2addr;
+   delete [] m_unloadedAddr2sloc;
    delete [] m_PRGROMopcodeMaskDirty;
    delete [] m_PRGROMmemory;
    delete [] m_PRGROMopcodeMask;
@@ -274,10 +243,6 @@ CROM::~CROM()
 
    for ( bank = 0; bank < NUM_SRAM_BANKS; bank++ )
    {
-      for ( addr = 0; addr < MEM_8KB; addr++ )
-      {
-         delete m_SRAMdisassembly[bank][addr];
-      }
       delete [] m_SRAMmemory[bank];
       delete [] m_SRAMopcodeMask[bank];
       delete [] m_SRAMsloc2addr[bank];
@@ -290,10 +255,6 @@ CROM::~CROM()
    delete [] m_SRAMaddr2sloc;
    delete [] m_SRAMsloc;
 
-   for ( addr = 0; addr < MEM_1KB; addr++ )
-   {
-      delete m_EXRAMdisassembly[addr];
-   }
    delete [] m_EXRAMmemory;
    delete [] m_EXRAMopcodeMask;
    delete [] m_EXRAMsloc2addr;
@@ -302,8 +263,33 @@ CROM::~CROM()
 
 void CROM::SetPRGBank ( int32_t bank, uint8_t* data )
 {
-   memcpy ( m_PRGROMmemory[m_numPrgBanks], data, MEM_8KB );
-   m_numPrgBanks++;
+   int32_t addr;
+
+   bank = STATE()->m_numPrgBanks;
+
+   memcpy ( STATE()->m_PRGROMmemory[bank], data, MEM_8KB );
+   STATE()->m_numPrgBanks++;
+
+   // Give the bank its own logger and disassembly tables the first time
+   // a ROM uses it.  They're kept for later ROMs.
+   if ( bank == STATE()->m_numPrgBankTables )
+   {
+      STATE()->m_PRGROMopcodeMask[bank] = new uint8_t[MEM_8KB];
+      STATE()->m_PRGROMsloc2addr[bank] = new uint16_t[MEM_8KB];
+      STATE()->m_PRGROMaddr2sloc[bank] = new uint16_t[MEM_8KB];
+      STATE()->m_pLogger [ bank ] = new CCodeDataLogger ( MEM_8KB, MASK_8KB );
+      for ( addr = 0; addr < MEM_8KB; addr++ )
+      {
+         STATE()->m_PRGROMopcodeMask[bank][addr] = 0;
+         STATE()->m_PRGROMsloc2addr[bank][addr] = 0;
+         STATE()->m_PRGROMaddr2sloc[bank][addr] = 0;
+      }
+      STATE()->m_numPrgBankTables++;
+   }
+
+   // A different ROM is in the bank so it has to be laid out again.
+   STATE()->m_PRGROMopcodeMaskDirty[bank].start = 0;
+   STATE()->m_PRGROMopcodeMaskDirty[bank].end = MEM_8KB-1;
 }
 
 void CROM::SetCHRBank ( int32_t bank, uint8_t* data )
@@ -311,20 +297,20 @@ void CROM::SetCHRBank ( int32_t bank, uint8_t* data )
    uint8_t ibank;
    for ( ibank = 0; ibank < 8; ibank++ )
    {
-      memcpy ( m_CHRmemory[(bank<<3)+ibank], data+(ibank*MEM_1KB), MEM_1KB );
+      memcpy ( STATE()->m_CHRmemory[(bank<<3)+ibank], data+(ibank*MEM_1KB), MEM_1KB );
    }
-   m_numChrBanks = bank + 1;
+   STATE()->m_numChrBanks = bank + 1;
 }
 
 void CROM::DoneLoadingBanks ()
 {
    // This is called when the ROM loader is done so that fixup can be done...
-   if ( m_numPrgBanks == 2 )
+   if ( STATE()->m_numPrgBanks == 2 )
    {
       // If the ROM contains only one 16KB PRG-ROM bank then it needs to be replicated
       // to the second PRG-ROM bank slot...
-      m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ 0 ];
-      m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ 1 ];
+      STATE()->m_pPRGROMmemory [ 2 ] = STATE()->m_PRGROMmemory [ 0 ];
+      STATE()->m_pPRGROMmemory [ 3 ] = STATE()->m_PRGROMmemory [ 1 ];
    }
 
    if ( nesIsDebuggable() )
@@ -334,7 +320,7 @@ void CROM::DoneLoadingBanks ()
    }
 
    // We just put a cartridge in...the SRAM isn't dirty yet.
-   m_SRAMdirty = false;
+   STATE()->m_SRAMdirty = false;
 }
 
 void CROM::RESET ( bool soft )
@@ -346,24 +332,25 @@ void CROM::RESET ( uint32_t mapper, bool soft )
 {
    int32_t bank;
 
-   m_mapper = mapper;
+   STATE()->m_mapper = mapper;
 
    if ( mapper == 0 )
    {
-      m_dbRegisters = NULL;
+      STATE()->m_dbRegisters = NULL;
    }
 
    if ( nesIsDebuggable() )
    {
       // Clear Code/Data Logger info...
-      for ( bank = 0; bank < NUM_ROM_BANKS; bank++ )
+      for ( bank = 0; bank < STATE()->m_numPrgBankTables; bank++ )
       {
-         m_pLogger [ bank ]->ClearData ();
+         STATE()->m_pLogger [ bank ]->ClearData ();
       }
+      STATE()->m_pUnloadedLogger->ClearData ();
    }
 
    // Support for NROM-368 for Shiru and crew.
-   if ( (m_mapper == 0) && (m_numPrgBanks > 4) )
+   if ( (STATE()->m_mapper == 0) && (STATE()->m_numPrgBanks > 4) )
    {
       // A NROM-368 file is laid out linearly so the six 8KB PRG-ROM banks will be
       // loaded into the following memory addresses:
@@ -377,35 +364,35 @@ void CROM::RESET ( uint32_t mapper, bool soft )
       // so that the CPU sees the upper end of the linear memory there.  The lower end
       // from $4000-$7fff will be mapped in by the existing mapper "low read" APIs called
       // whenever the CPU reads from $4018-$7fff.
-      m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 2 ];
-      m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 3 ];
+      STATE()->m_pPRGROMmemory [ 0 ] = STATE()->m_PRGROMmemory [ 2 ];
+      STATE()->m_pPRGROMmemory [ 1 ] = STATE()->m_PRGROMmemory [ 3 ];
 
-      m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ 4 ];
-      m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ 5 ];
+      STATE()->m_pPRGROMmemory [ 2 ] = STATE()->m_PRGROMmemory [ 4 ];
+      STATE()->m_pPRGROMmemory [ 3 ] = STATE()->m_PRGROMmemory [ 5 ];
    }
    else
    {
-      m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-      m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
+      STATE()->m_pPRGROMmemory [ 0 ] = STATE()->m_PRGROMmemory [ 0 ];
+      STATE()->m_pPRGROMmemory [ 1 ] = STATE()->m_PRGROMmemory [ 1 ];
 
       // If the ROM contains only one 16KB PRG-ROM bank then it needs to be replicated
       // to the second PRG-ROM bank slot...
-      if ( m_numPrgBanks == 2 )
+      if ( STATE()->m_numPrgBanks == 2 )
       {
-         m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ 0 ];
-         m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ 1 ];
+         STATE()->m_pPRGROMmemory [ 2 ] = STATE()->m_PRGROMmemory [ 0 ];
+         STATE()->m_pPRGROMmemory [ 3 ] = STATE()->m_PRGROMmemory [ 1 ];
       }
       else
       {
-         m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ 2 ];
-         m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ 3 ];
+         STATE()->m_pPRGROMmemory [ 2 ] = STATE()->m_PRGROMmemory [ 2 ];
+         STATE()->m_pPRGROMmemory [ 3 ] = STATE()->m_PRGROMmemory [ 3 ];
       }
    }
 
    // Default CHR map...
    for ( bank = 0; bank < 8; bank++ )
    {
-      m_pCHRmemory [ bank ] = m_CHRmemory [ bank ];
+      STATE()->m_pCHRmemory [ bank ] = STATE()->m_CHRmemory [ bank ];
    }
 
    // Assume identity-mapped SRAM...
@@ -414,18 +401,173 @@ void CROM::RESET ( uint32_t mapper, bool soft )
    // cartridges with 8KB of SRAM will leave this mapping alone.
    for ( bank = 0; bank < 5; bank++ )
    {
-      m_pSRAMmemory [ bank ] = *(m_SRAMmemory+bank);
+      STATE()->m_pSRAMmemory [ bank ] = *(STATE()->m_SRAMmemory+bank);
+   }
+}
+
+template <class STREAM>
+void CROM::STATEDATA ( STREAM& stream )
+{
+   int32_t bank;
+
+   for ( bank = 0; bank < NUM_SRAM_BANKS; bank++ )
+   {
+      stream.MEMORY ( STATE()->m_SRAMmemory[bank], MEM_8KB );
+   }
+   stream.MEMORY ( STATE()->m_EXRAMmemory, MEM_1KB );
+
+   // CHR memory is only writeable when there is no CHR-ROM.
+   if ( !IsWriteProtected() )
+   {
+      for ( bank = 0; bank < NUM_CHRRAM_BANKS; bank++ )
+      {
+         stream.MEMORY ( STATE()->m_CHRmemory[bank], MEM_1KB );
+      }
+   }
+}
+
+void CROM::SAVESTATE ( CNESStateWriter& writer )
+{
+   void*    pState;
+   uint32_t mapper;
+   uint32_t size;
+   int32_t  idx;
+
+   // The cartridge itself isn't saved, only enough of it to know that the
+   // state is being loaded back onto the same one.
+   writer.BEGIN ( "CART", 1 );
+   writer.VALUE ( STATE()->m_mapper );
+   writer.VALUE ( STATE()->m_numPrgBanks );
+   writer.VALUE ( STATE()->m_numChrBanks );
+
+   // Bank slots are saved as bank numbers.
+   for ( idx = 0; idx < 4; idx++ )
+   {
+      writer.VALUE<uint8_t> ( STATE()->m_pPRGROMmemory[idx][MEM_8KB] );
+   }
+   for ( idx = 0; idx < 8; idx++ )
+   {
+      writer.VALUE<int32_t> ( CHRBANK(STATE()->m_pCHRmemory[idx]) );
+   }
+   for ( idx = 0; idx < 5; idx++ )
+   {
+      writer.VALUE<uint8_t> ( STATE()->m_pSRAMmemory[idx][MEM_8KB] );
+   }
+   STATEDATA ( writer );
+   writer.END ();
+
+   writer.BEGIN ( "MAPR", 1 );
+   for ( idx = 0; (pState = nesMapperState(idx,&mapper,&size)); idx++ )
+   {
+      writer.VALUE ( mapper );
+      writer.VALUE ( size );
+      writer.BYTES ( pState, size );
+   }
+   writer.END ();
+}
+
+bool CROM::LOADSTATE ( CNESStateReader& reader )
+{
+   uint8_t* pPRGROMmemory [ 4 ];
+   uint8_t* pCHRmemory [ 8 ];
+   uint8_t* pSRAMmemory [ 5 ];
+   void*    pState;
+   uint16_t version;
+   uint32_t mapper;
+   uint32_t size;
+   uint32_t value;
+   uint8_t  bank;
+   int32_t  chrBank;
+   int32_t  idx;
+
+   if ( (!reader.FIND("CART",&version)) || (version != 1) )
+   {
+      return false;
+   }
+   reader.VALUE ( value );
+   if ( value != STATE()->m_mapper )
+   {
+      return false;
+   }
+   reader.VALUE ( value );
+   if ( value != STATE()->m_numPrgBanks )
+   {
+      return false;
+   }
+   reader.VALUE ( value );
+   if ( value != STATE()->m_numChrBanks )
+   {
+      return false;
+   }
+
+   for ( idx = 0; idx < 4; idx++ )
+   {
+      reader.VALUE ( bank );
+      if ( bank >= NUM_ROM_BANKS )
+      {
+         return false;
+      }
+      pPRGROMmemory[idx] = STATE()->m_PRGROMmemory[bank];
+   }
+   for ( idx = 0; idx < 8; idx++ )
+   {
+      reader.VALUE ( chrBank );
+      if ( !(pCHRmemory[idx] = CHRBANK(chrBank)) )
+      {
+         return false;
+      }
+   }
+   for ( idx = 0; idx < 5; idx++ )
+   {
+      reader.VALUE ( bank );
+      if ( bank >= NUM_SRAM_BANKS )
+      {
+         return false;
+      }
+      pSRAMmemory[idx] = STATE()->m_SRAMmemory[bank];
+   }
+   STATEDATA ( reader );
+   if ( !reader.GOOD() )
+   {
+      return false;
    }
+   memcpy(STATE()->m_pPRGROMmemory,pPRGROMmemory,sizeof(pPRGROMmemory));
+   memcpy(STATE()->m_pCHRmemory,pCHRmemory,sizeof(pCHRmemory));
+   memcpy(STATE()->m_pSRAMmemory,pSRAMmemory,sizeof(pSRAMmemory));
+
+   // Whatever the battery-backed RAM had in it has been replaced.
+   STATE()->m_SRAMdirty = true;
+
+   if ( (!reader.FIND("MAPR",&version)) || (version != 1) )
+   {
+      return false;
+   }
+   for ( idx = 0; (pState = nesMapperState(idx,&mapper,&size)); idx++ )
+   {
+      reader.VALUE ( value );
+      if ( value != mapper )
+      {
+         return false;
+      }
+      reader.VALUE ( value );
+      if ( value != size )
+      {
+         return false;
+      }
+      reader.BYTES ( pState, size );
+   }
+
+   return reader.GOOD();
 }
 
 uint32_t CROM::LMAPPER ( uint32_t addr )
 {
    uint8_t data = C6502::OPENBUS();
 
-   if ( (m_mapper == 0) && (m_numPrgBanks > 4) )
+   if ( (STATE()->m_mapper == 0) && (STATE()->m_numPrgBanks > 4) )
    {
       addr -= MEM_16KB;
-      return *(*(m_PRGROMmemory+(PRGBANK_VIRT(addr)))+(PRGBANK_OFF(addr)));
+      return *(*(STATE()->m_PRGROMmemory+(PRGBANK_VIRT(addr)))+(PRGBANK_OFF(addr)));
    }
    else
    {
@@ -450,52 +592,58 @@ void CROM::DISASSEMBLE ()
 {
    uint32_t bank;
 
-   // Disassemble PRG-ROM banks...
-   for ( bank = 0; bank < m_numPrgBanks; bank++ )
+   // Disassemble what changed in the PRG-ROM banks...
+   for ( bank = 0; bank < STATE()->m_numPrgBanks; bank++ )
    {
-      if ( *(m_PRGROMopcodeMaskDirty+bank) )
+      if ( STATE()->m_PRGROMopcodeMaskDirty[bank].start <= STATE()->m_PRGROMopcodeMaskDirty[bank].end )
       {
-         C6502::DISASSEMBLE ( m_PRGROMdisassembly[bank],
-                              m_PRGROMmemory[bank],
+         C6502::DISASSEMBLE ( STATE()->m_PRGROMmemory[bank],
                               MEM_8KB,
-                              m_PRGROMopcodeMask[bank],
-                              m_PRGROMsloc2addr[bank],
-                              m_PRGROMaddr2sloc[bank],
-                              &(m_PRGROMsloc[bank]) );
-
-         *(m_PRGROMopcodeMaskDirty+bank) = false;
+                              STATE()->m_PRGROMopcodeMask[bank],
+                              STATE()->m_PRGROMsloc2addr[bank],
+                              STATE()->m_PRGROMaddr2sloc[bank],
+                              &(STATE()->m_PRGROMsloc[bank]),
+                              STATE()->m_PRGROMopcodeMaskDirty[bank].start,
+                              STATE()->m_PRGROMopcodeMaskDirty[bank].end );
+
+         STATE()->m_PRGROMopcodeMaskDirty[bank].start = MEM_8KB;
+         STATE()->m_PRGROMopcodeMaskDirty[bank].end = 0;
       }
    }
 
-   // Disassemble SRAM...
+   // Disassemble what changed in SRAM...
    for ( bank = 0; bank < NUM_SRAM_BANKS; bank++ )
    {
-      if ( *(m_SRAMopcodeMaskDirty+bank) )
+      if ( STATE()->m_SRAMopcodeMaskDirty[bank].start <= STATE()->m_SRAMopcodeMaskDirty[bank].end )
       {
-         C6502::DISASSEMBLE ( m_SRAMdisassembly[bank],
-                              m_SRAMmemory[bank],
+         C6502::DISASSEMBLE ( STATE()->m_SRAMmemory[bank],
                               MEM_8KB,
-                              m_SRAMopcodeMask[bank],
-                              m_SRAMsloc2addr[bank],
-                              m_SRAMaddr2sloc[bank],
-                              &(m_SRAMsloc[bank]) );
-
-         *(m_SRAMopcodeMaskDirty+bank) = false;
+                              STATE()->m_SRAMopcodeMask[bank],
+                              STATE()->m_SRAMsloc2addr[bank],
+                              STATE()->m_SRAMaddr2sloc[bank],
+                              &(STATE()->m_SRAMsloc[bank]),
+                              STATE()->m_SRAMopcodeMaskDirty[bank].start,
+                              STATE()->m_SRAMopcodeMaskDirty[bank].end );
+
+         STATE()->m_SRAMopcodeMaskDirty[bank].start = MEM_8KB;
+         STATE()->m_SRAMopcodeMaskDirty[bank].end = 0;
       }
    }
 
-   // Disassemble EXRAM...
-   if ( m_EXRAMopcodeMaskDirty )
+   // Disassemble what changed in EXRAM...
+   if ( STATE()->m_EXRAMopcodeMaskDirty.start <= STATE()->m_EXRAMopcodeMaskDirty.end )
    {
-      C6502::DISASSEMBLE ( m_EXRAMdisassembly,
-                           m_EXRAMmemory,
+      C6502::DISASSEMBLE ( STATE()->m_EXRAMmemory,
                            MEM_1KB,
-                           m_EXRAMopcodeMask,
-                           m_EXRAMsloc2addr,
-                           m_EXRAMaddr2sloc,
-                           &(m_EXRAMsloc) );
+                           STATE()->m_EXRAMopcodeMask,
+                           STATE()->m_EXRAMsloc2addr,
+                           STATE()->m_EXRAMaddr2sloc,
+                           &(STATE()->m_EXRAMsloc),
+                           STATE()->m_EXRAMopcodeMaskDirty.start,
+                           STATE()->m_EXRAMopcodeMaskDirty.end );
 
-      m_EXRAMopcodeMaskDirty = false;
+      STATE()->m_EXRAMopcodeMaskDirty.start = MEM_1KB;
+      STATE()->m_EXRAMopcodeMaskDirty.end = 0;
    }
 }
 
@@ -527,19 +675,19 @@ uint32_t CROM::PRGROMSLOC2ADDR ( uint16_t sloc )
       sloc -= slocC000;
    }
 
-   return addr+(*(*(m_PRGROMsloc2addr+PRGBANK_PHYS(addr))+sloc));
+   return addr+(*(*(STATE()->m_PRGROMsloc2addr+PRGBANK_PHYS(addr))+sloc));
 }
 
 uint32_t CROM::SRAMSLOC2ADDR ( uint16_t sloc )
 {
    int32_t addr = 0x6000;
 
-   return addr+(*(*(m_SRAMsloc2addr+SRAMBANK_PHYS(addr))+sloc));
+   return addr+(*(*(STATE()->m_SRAMsloc2addr+SRAMBANK_PHYS(addr))+sloc));
 }
 
 uint32_t CROM::EXRAMSLOC2ADDR ( uint16_t sloc )
 {
-   return 0x5C00+(*(m_EXRAMsloc2addr+sloc));
+   return 0x5C00+(*(STATE()->m_EXRAMsloc2addr+sloc));
 }
 
 uint16_t CROM::PRGROMADDR2SLOC ( uint32_t addr )
@@ -566,17 +714,17 @@ uint16_t CROM::PRGROMADDR2SLOC ( uint32_t addr )
       sloc = slocC000;
    }
 
-   return sloc+(*(*(m_PRGROMaddr2sloc+PRGBANK_PHYS(addr))+PRGBANK_OFF(addr)));
+   return sloc+(*(*(STATE()->m_PRGROMaddr2sloc+PRGBANK_PHYS(addr))+PRGBANK_OFF(addr)));
 }
 
 uint16_t CROM::SRAMADDR2SLOC ( uint32_t addr )
 {
    int32_t sloc = 0;
 
-   return sloc+(*(*(m_SRAMaddr2sloc+SRAMBANK_PHYS(addr))+SRAMBANK_OFF(addr)));
+   return sloc+(*(*(STATE()->m_SRAMaddr2sloc+SRAMBANK_PHYS(addr))+SRAMBANK_OFF(addr)));
 }
 
 uint16_t CROM::EXRAMADDR2SLOC ( uint32_t addr )
 {
-   return *(m_EXRAMaddr2sloc+(addr-0x5C00));
+   return *(STATE()->m_EXRAMaddr2sloc+(addr-0x5C00));
 }
@@ -10,13 +10,14 @@
 #include "ccodedatalogger.h"
 #include "cregisterdata.h"
 #include "cmemorydata.h"
+#include "cnesstate.h"
 
 // Resolve a 6502-address to one of 4 8KB PRG ROM banks [0:$8000-$9FFF, 1:$A000-$BFFF, 2:$C000-$DFFF, or 3:$E000-$FFFF]
 #define PRGBANK_VIRT(addr) ( (addr&MASK_32KB)>>SHIFT_32KB_8KB )
 // Retrieve the bank-offset address portion of a 6502-address for use within PRG ROM banks
 #define PRGBANK_OFF(addr) ( addr&MASK_8KB )
 // Resolve a 6502-address to one of the 8KB PRG ROM banks within a ROM file [the absolute physical address]
-#define PRGBANK_PHYS(addr) ( *((*(m_pPRGROMmemory+PRGBANK_VIRT(addr)))+MEM_8KB) )
+#define PRGBANK_PHYS(addr) ( *((*(CROM::STATE()->m_pPRGROMmemory+PRGBANK_VIRT(addr)))+MEM_8KB) )
 
 // Resolve an absolute address to a PRG-ROM bank
 #define PRGBANK_ABSBANK(absAddr) ( absAddr>>SHIFT_32KB_8KB )
@@ -26,7 +27,7 @@
 // Retrieve the bank-offset address portion of an address for use within CHR memory banks
 #define CHRBANK_OFF(addr) ( addr&MASK_1KB )
 // Resolve an address to one of the 8KB CHR memory banks [the absolute physical address]
-#define CHRBANK_PHYS(addr) ( *((*(m_pCHRmemory+CHRBANK_VIRT(addr)))+MEM_1KB) )
+#define CHRBANK_PHYS(addr) ( *((*(CROM::STATE()->m_pCHRmemory+CHRBANK_VIRT(addr)))+MEM_1KB) )
 
 #define SRAMBANK_VIRT(addr) ( ((addr-SRAM_START)&MASK_64KB)>>SHIFT_64KB_8KB )
 #define SRAMBANK_OFF(addr) ( addr&MASK_8KB )
@@ -34,41 +35,38 @@
 // NOTE: Mappers with SRAM typically have one 8KB bank at $6000-$7FFF but MMC5
 // allows mapping of up to 64KB of SRAM anywhere in the upper 32KB ROM space.
 //#define SRAMBANK_PHYS(addr) ( ((uint8_t*)(*(m_pSRAMmemory+SRAMBANK_VIRT(addr)))-(uint8_t*)m_SRAMmemory)>>SHIFT_64KB_8KB )
-#define SRAMBANK_PHYS(addr) ( *((*(m_pSRAMmemory+SRAMBANK_VIRT(addr)))+MEM_8KB) )
+#define SRAMBANK_PHYS(addr) ( *((*(CROM::STATE()->m_pSRAMmemory+SRAMBANK_VIRT(addr)))+MEM_8KB) )
 
 #define SRAMBANK_ABSBANK(absAddr) ( absAddr>>SHIFT_64KB_8KB )
 
 class CROM
 {
 public:
-   CROM();
-   ~CROM();
-
    // Priming interfaces (data setup/initialization)
    static void ClearPRGBanks ()
    {
-      m_numPrgBanks = 0;
+      STATE()->m_numPrgBanks = 0;
    }
    static void ClearCHRBanks ()
    {
-      m_numChrBanks = 0;
+      STATE()->m_numChrBanks = 0;
    }
    static void SetCHRBank ( int32_t bank, uint8_t* data );
    static void SetPRGBank ( int32_t bank, uint8_t* data );
    static void DoneLoadingBanks ( void );
    static uint32_t NUMPRGROMBANKS ( void )
    {
-      return m_numPrgBanks;
+      return STATE()->m_numPrgBanks;
    }
    static uint32_t NUMCHRROMBANKS ( void )
    {
-      return m_numChrBanks;
+      return STATE()->m_numChrBanks;
    }
 
    // Operations
    static bool IsWriteProtected ( void )
    {
-      return (m_numChrBanks>0);
+      return (STATE()->m_numChrBanks>0);
    }
    static uint32_t CHRMEMABSADDR ( uint32_t addr )
    {
@@ -80,20 +78,20 @@ public:
    }
    static inline uint32_t PRGROM ( uint32_t addr )
    {
-      return *(*(m_pPRGROMmemory+PRGBANK_VIRT(addr))+(PRGBANK_OFF(addr)));
+      return *(*(STATE()->m_pPRGROMmemory+PRGBANK_VIRT(addr))+(PRGBANK_OFF(addr)));
    }
    static inline void PRGROM ( uint32_t, uint8_t ) {}
    static inline uint32_t PRGROMPHYS ( uint32_t addr )
    {
-      return *(*(m_PRGROMmemory+PRGBANK_ABSBANK(addr))+PRGBANK_OFF(addr));
+      return *(*(STATE()->m_PRGROMmemory+PRGBANK_ABSBANK(addr))+PRGBANK_OFF(addr));
    }
    static inline void CHRMEM ( uint32_t addr, uint8_t data )
    {
-      *(*(m_pCHRmemory+CHRBANK_VIRT(addr))+CHRBANK_OFF(addr)) = data;
+      *(*(STATE()->m_pCHRmemory+CHRBANK_VIRT(addr))+CHRBANK_OFF(addr)) = data;
    }
    static inline uint32_t CHRMEM ( uint32_t addr )
    {
-      return *(*(m_pCHRmemory+CHRBANK_VIRT(addr))+CHRBANK_OFF(addr));
+      return *(*(STATE()->m_pCHRmemory+CHRBANK_VIRT(addr))+CHRBANK_OFF(addr));
    }
    static inline uint32_t SRAMABSADDR ( uint32_t addr )
    {
@@ -101,28 +99,39 @@ public:
    }
    static inline uint32_t SRAMVIRT ( uint32_t addr )
    {
-      return *(*(m_pSRAMmemory+SRAMBANK_VIRT(addr))+SRAMBANK_OFF(addr));
+      return *(*(STATE()->m_pSRAMmemory+SRAMBANK_VIRT(addr))+SRAMBANK_OFF(addr));
    }
    static inline void SRAMVIRT ( uint32_t addr, uint8_t data )
    {
-      *(*(m_pSRAMmemory+SRAMBANK_VIRT(addr))+SRAMBANK_OFF(addr)) = data;
-      m_SRAMdirty = true;
+      *(*(STATE()->m_pSRAMmemory+SRAMBANK_VIRT(addr))+SRAMBANK_OFF(addr)) = data;
+      STATE()->m_SRAMdirty = true;
    }
    static inline uint32_t SRAMPHYS ( uint32_t addr )
    {
-      return *(*(m_SRAMmemory+SRAMBANK_ABSBANK(addr))+SRAMBANK_OFF(addr));
+      return *(*(STATE()->m_SRAMmemory+SRAMBANK_ABSBANK(addr))+SRAMBANK_OFF(addr));
    }
    static inline void SRAMPHYS ( uint32_t addr, uint8_t data, bool setDirty = true )
    {
-      *(*(m_SRAMmemory+SRAMBANK_ABSBANK(addr))+SRAMBANK_OFF(addr)) = data;
+      *(*(STATE()->m_SRAMmemory+SRAMBANK_ABSBANK(addr))+SRAMBANK_OFF(addr)) = data;
       if ( setDirty )
       {
-         m_SRAMdirty = true;
+         STATE()->m_SRAMdirty = true;
       }
    }
    static inline void REMAPSRAM ( uint32_t addr, uint8_t bank )
    {
-      *(m_pSRAMmemory+SRAMBANK_VIRT(addr)) = *(m_SRAMmemory+bank);
+      *(STATE()->m_pSRAMmemory+SRAMBANK_VIRT(addr)) = *(STATE()->m_SRAMmemory+bank);
+   }
+   // The bank pointers the CPU bus page tables read through.  They
+   // stay valid for the life of the ROM; remapping changes what they
+   // point at.
+   static inline uint8_t** PRGROMBANKSLOT ( uint32_t addr )
+   {
+      return STATE()->m_pPRGROMmemory+PRGBANK_VIRT(addr);
+   }
+   static inline uint8_t** SRAMBANKSLOT ( uint32_t addr )
+   {
+      return STATE()->m_pSRAMmemory+SRAMBANK_VIRT(addr);
    }
    static inline uint32_t EXRAMABSADDR ( uint32_t addr )
    {
@@ -130,11 +139,11 @@ public:
    }
    static inline uint32_t EXRAM ( uint32_t addr )
    {
-      return *(m_EXRAMmemory+(addr-EXRAM_START));
+      return *(STATE()->m_EXRAMmemory+(addr-EXRAM_START));
    }
    static inline void EXRAM ( uint32_t addr, uint8_t data )
    {
-      *(m_EXRAMmemory+(addr-EXRAM_START)) = data;
+      *(STATE()->m_EXRAMmemory+(addr-EXRAM_START)) = data;
    }
 
    // Mapper interfaces [called by emulator through mapperfunc array]
@@ -142,7 +151,7 @@ public:
    static void RESET ( uint32_t mapper, bool soft );
    static uint32_t MAPPER ( void )
    {
-      return m_mapper;
+      return STATE()->m_mapper;
    }
    static uint32_t HMAPPER ( uint32_t addr )
    {
@@ -163,40 +172,72 @@ public:
    }
    static void SOUNDENABLE ( uint32_t mask ) {}
 
+   // Save state support.  SAVESTATE writes this object's chunk of a save
+   // state; LOADSTATE restores it, returning false if the chunk is missing
+   // or does not match.
+   static void SAVESTATE ( CNESStateWriter& writer );
+   static bool LOADSTATE ( CNESStateReader& reader );
+
+   // Converts between 1KB CHR memory bank pointers and bank numbers, for
+   // saving things that point into CHR memory.  The bank ID stored after
+   // each bank is only eight bits wide so both of its possible banks are
+   // checked.  CHRBANK returns -1 if the pointer isn't to a CHR memory bank.
+   static int32_t CHRBANK ( uint8_t* point )
+   {
+      int32_t bank = point[MEM_1KB];
+
+      for ( ; bank < NUM_CHR_BANKS; bank += 256 )
+      {
+         if ( STATE()->m_CHRmemory[bank] == point )
+         {
+            return bank;
+         }
+      }
+      return -1;
+   }
+   static uint8_t* CHRBANK ( int32_t bank )
+   {
+      return ((bank >= 0) && (bank < NUM_CHR_BANKS))?STATE()->m_CHRmemory[bank]:NULL;
+   }
+
    // Code/Data logger support functions
    static inline CCodeDataLogger* LOGGERVIRT ( uint32_t addr )
    {
-      return *(m_pLogger+PRGBANK_PHYS(addr));
+      return *(STATE()->m_pLogger+PRGBANK_PHYS(addr));
    }
    static inline CCodeDataLogger* SRAMLOGGERVIRT ( uint32_t addr )
    {
-      return *(m_pSRAMLogger+SRAMBANK_PHYS(addr));
+      return *(STATE()->m_pSRAMLogger+SRAMBANK_PHYS(addr));
    }
    static inline CCodeDataLogger* LOGGERPHYS ( uint32_t addr )
    {
-      return *(m_pLogger+PRGBANK_ABSBANK(addr));
+      return *(STATE()->m_pLogger+PRGBANK_ABSBANK(addr));
    }
    static inline CCodeDataLogger* SRAMLOGGERPHYS ( uint32_t addr )
    {
-      return *(m_pSRAMLogger+SRAMBANK_ABSBANK(addr));
+      return *(STATE()->m_pSRAMLogger+SRAMBANK_ABSBANK(addr));
    }
    static inline CCodeDataLogger* EXRAMLOGGER ()
    {
-      return m_pEXRAMLogger;
+      return STATE()->m_pEXRAMLogger;
    }
 
    // Support functions for inline disassembly in PRG-ROM, SRAM, and EXRAM
    static inline void PRGROMOPCODEMASK ( uint32_t addr, uint8_t mask )
    {
-      if ( (*(*(m_PRGROMopcodeMask+PRGBANK_PHYS(addr))+PRGBANK_OFF(addr))) != mask )
+      if ( (*(*(STATE()->m_PRGROMopcodeMask+PRGBANK_PHYS(addr))+PRGBANK_OFF(addr))) != mask )
       {
-         *(m_PRGROMopcodeMaskDirty+PRGBANK_PHYS(addr)) = true;
+         OPCODEMASKCHANGED ( STATE()->m_PRGROMopcodeMaskDirty+PRGBANK_PHYS(addr), PRGBANK_OFF(addr) );
       }
-      *(*(m_PRGROMopcodeMask+PRGBANK_PHYS(addr))+PRGBANK_OFF(addr)) = mask;
+      *(*(STATE()->m_PRGROMopcodeMask+PRGBANK_PHYS(addr))+PRGBANK_OFF(addr)) = mask;
    }
    static inline void PRGROMOPCODEMASKATABSADDR ( uint32_t absAddr, uint8_t mask )
    {
-      *(*(m_PRGROMopcodeMask+PRGBANK_ABSBANK(absAddr))+PRGBANK_OFF(absAddr)) = mask;
+      if ( (*(*(STATE()->m_PRGROMopcodeMask+PRGBANK_ABSBANK(absAddr))+PRGBANK_OFF(absAddr))) != mask )
+      {
+         OPCODEMASKCHANGED ( STATE()->m_PRGROMopcodeMaskDirty+PRGBANK_ABSBANK(absAddr), PRGBANK_OFF(absAddr) );
+      }
+      *(*(STATE()->m_PRGROMopcodeMask+PRGBANK_ABSBANK(absAddr))+PRGBANK_OFF(absAddr)) = mask;
    }
    static inline void PRGROMOPCODEMASKCLR ( void )
    {
@@ -204,34 +245,47 @@ public:
       int32_t idx2;
       for ( idx1 = 0; idx1 < NUM_ROM_BANKS; idx1++ )
       {
-         for ( idx2 = 0; idx2 < MEM_8KB; idx2++ )
+         if ( idx1 < STATE()->m_numPrgBankTables )
          {
-            m_PRGROMopcodeMask[idx1][idx2] = 0;
+            for ( idx2 = 0; idx2 < MEM_8KB; idx2++ )
+            {
+               STATE()->m_PRGROMopcodeMask[idx1][idx2] = 0;
+            }
          }
-         m_PRGROMopcodeMaskDirty[idx1] = true;
+         STATE()->m_PRGROMopcodeMaskDirty[idx1].start = 0;
+         STATE()->m_PRGROMopcodeMaskDirty[idx1].end = MEM_8KB-1;
+      }
+      for ( idx2 = 0; idx2 < MEM_8KB; idx2++ )
+      {
+         STATE()->m_unloadedOpcodeMask[idx2] = 0;
       }
    }
    static inline char* PRGROMDISASSEMBLY ( uint32_t addr )
    {
-      return *(*(m_PRGROMdisassembly+PRGBANK_PHYS(addr))+PRGBANK_OFF(addr));
+      return C6502::DISASSEMBLY ( *(STATE()->m_PRGROMmemory+PRGBANK_PHYS(addr)),
+                                  MEM_8KB,
+                                  *(STATE()->m_PRGROMopcodeMask+PRGBANK_PHYS(addr)),
+                                  *(STATE()->m_PRGROMsloc2addr+PRGBANK_PHYS(addr)),
+                                  *(STATE()->m_PRGROMaddr2sloc+PRGBANK_PHYS(addr)),
+                                  PRGBANK_OFF(addr) );
    }
    static inline char* PRGROMDISASSEMBLYATABSADDR ( uint32_t absAddr, char* buffer )
    {
-      return C6502::Disassemble((*(m_PRGROMmemory+PRGBANK_ABSBANK(absAddr))+PRGBANK_OFF(absAddr)),buffer);
+      return C6502::Disassemble((*(STATE()->m_PRGROMmemory+PRGBANK_ABSBANK(absAddr))+PRGBANK_OFF(absAddr)),buffer);
    }
    static uint32_t PRGROMSLOC2ADDR ( uint16_t sloc );
    static uint16_t PRGROMADDR2SLOC ( uint32_t addr );
    static inline uint32_t PRGROMSLOC ( uint32_t addr )
    {
-      return *(m_PRGROMsloc+PRGBANK_PHYS(addr));
+      return *(STATE()->m_PRGROMsloc+PRGBANK_PHYS(addr));
    }
    static inline void SRAMOPCODEMASK ( uint32_t addr, uint8_t mask )
    {
-      if ( (*(*(m_SRAMopcodeMask+SRAMBANK_PHYS(addr))+SRAMBANK_OFF(addr))) != mask )
+      if ( (*(*(STATE()->m_SRAMopcodeMask+SRAMBANK_PHYS(addr))+SRAMBANK_OFF(addr))) != mask )
       {
-         *(m_SRAMopcodeMaskDirty+SRAMBANK_PHYS(addr)) = true;
+         OPCODEMASKCHANGED ( STATE()->m_SRAMopcodeMaskDirty+SRAMBANK_PHYS(addr), SRAMBANK_OFF(addr) );
       }
-      *(*(m_SRAMopcodeMask+SRAMBANK_PHYS(addr))+SRAMBANK_OFF(addr)) = mask;
+      *(*(STATE()->m_SRAMopcodeMask+SRAMBANK_PHYS(addr))+SRAMBANK_OFF(addr)) = mask;
    }
    static inline void SRAMOPCODEMASKCLR ( void )
    {
@@ -241,48 +295,60 @@ public:
       {
          for ( idx2 = 0; idx2 < MEM_8KB; idx2++ )
          {
-            m_SRAMopcodeMask[idx1][idx2] = 0;
+            STATE()->m_SRAMopcodeMask[idx1][idx2] = 0;
          }
-         m_SRAMopcodeMaskDirty[idx1] = true;
+         STATE()->m_SRAMopcodeMaskDirty[idx1].start = 0;
+         STATE()->m_SRAMopcodeMaskDirty[idx1].end = MEM_8KB-1;
       }
    }
    static inline char* SRAMDISASSEMBLY ( uint32_t addr )
    {
-      return *(*(m_SRAMdisassembly+SRAMBANK_PHYS(addr))+SRAMBANK_OFF(addr));
+      return C6502::DISASSEMBLY ( *(STATE()->m_SRAMmemory+SRAMBANK_PHYS(addr)),
+                                  MEM_8KB,
+                                  *(STATE()->m_SRAMopcodeMask+SRAMBANK_PHYS(addr)),
+                                  *(STATE()->m_SRAMsloc2addr+SRAMBANK_PHYS(addr)),
+                                  *(STATE()->m_SRAMaddr2sloc+SRAMBANK_PHYS(addr)),
+                                  SRAMBANK_OFF(addr) );
    }
    static uint32_t SRAMSLOC2ADDR ( uint16_t sloc );
    static uint16_t SRAMADDR2SLOC ( uint32_t addr );
    static inline uint32_t SRAMSLOC ( uint32_t addr)
    {
-      return *(m_SRAMsloc+SRAMBANK_PHYS(addr));
+      return *(STATE()->m_SRAMsloc+SRAMBANK_PHYS(addr));
    }
-   static bool SRAMDIRTY() { return m_SRAMdirty; }
+   static bool SRAMDIRTY() { return STATE()->m_SRAMdirty; }
    static inline void EXRAMOPCODEMASK ( uint32_t addr, uint8_t mask )
    {
-      if ( (*(m_EXRAMopcodeMask+(addr-0x5C00))) != mask )
+      if ( (*(STATE()->m_EXRAMopcodeMask+(addr-0x5C00))) != mask )
       {
-         m_EXRAMopcodeMaskDirty = true;
+         OPCODEMASKCHANGED ( &(STATE()->m_EXRAMopcodeMaskDirty), addr-0x5C00 );
       }
-      *(m_EXRAMopcodeMask+(addr-0x5C00)) = mask;
+      *(STATE()->m_EXRAMopcodeMask+(addr-0x5C00)) = mask;
    }
    static inline void EXRAMOPCODEMASKCLR ( void )
    {
       int32_t idx2;
       for ( idx2 = 0; idx2 < MEM_1KB; idx2++ )
       {
-         m_EXRAMopcodeMask[idx2] = 0;
+         STATE()->m_EXRAMopcodeMask[idx2] = 0;
       }
-      m_EXRAMopcodeMaskDirty = true;
+      STATE()->m_EXRAMopcodeMaskDirty.start = 0;
+      STATE()->m_EXRAMopcodeMaskDirty.end = MEM_1KB-1;
    }
    static inline char* EXRAMDISASSEMBLY ( uint32_t addr )
    {
-      return *(m_EXRAMdisassembly+(addr-0x5C00));
+      return C6502::DISASSEMBLY ( STATE()->m_EXRAMmemory,
+                                  MEM_1KB,
+                                  STATE()->m_EXRAMopcodeMask,
+                                  STATE()->m_EXRAMsloc2addr,
+                                  STATE()->m_EXRAMaddr2sloc,
+                                  addr-0x5C00 );
    }
    static uint32_t EXRAMSLOC2ADDR ( uint16_t sloc );
    static uint16_t EXRAMADDR2SLOC ( uint32_t addr );
    static inline uint32_t EXRAMSLOC ()
    {
-      return m_EXRAMsloc;
+      return STATE()->m_EXRAMsloc;
    }
    static void DISASSEMBLE ();
 
@@ -299,7 +365,7 @@ public:
    // Debug register display interfaces
    static inline CRegisterDatabase* REGISTERS ( void )
    {
-      return m_dbRegisters;
+      return STATE()->m_dbRegisters;
    }
 
    static inline CMemoryDatabase* PRGROMMEMORY ( void )
@@ -323,54 +389,95 @@ public:
    }
 
 protected:
-   static uint8_t**  m_PRGROMmemory;
-   static uint8_t**  m_CHRmemory;
-   static uint8_t**  m_SRAMmemory;
-   static uint8_t*   m_EXRAMmemory;
+   // The range of a memory's opcode mask that has changed since it was
+   // last disassembled.  It is empty when start is past end.
+   struct DirtyRange
+   {
+      int32_t start;
+      int32_t end;
+   };
+   static inline void OPCODEMASKCHANGED ( DirtyRange* pDirty, int32_t offset )
+   {
+      if ( pDirty->start > pDirty->end )
+      {
+         pDirty->start = offset;
+         pDirty->end = offset;
+      }
+      else if ( offset < pDirty->start )
+      {
+         pDirty->start = offset;
+      }
+      else if ( offset > pDirty->end )
+      {
+         pDirty->end = offset;
+      }
+   }
+
+   friend struct NESContext;
+   struct State
+   {
+      State ();
+      ~State ();
 
-   // Mapper stuff...
-   static uint32_t           m_mapper;
-   static uint32_t           m_numPrgBanks;
-   static uint32_t           m_numChrBanks;
-   static uint8_t* m_pPRGROMmemory [ 4 ];
-   static uint8_t* m_pCHRmemory [ 8 ];
-   static uint8_t* m_pSRAMmemory [ 5 ];
+      uint8_t**  m_PRGROMmemory = NULL;
+      uint8_t**  m_CHRmemory = NULL;
+      uint8_t**  m_SRAMmemory = NULL;
+      uint8_t*   m_EXRAMmemory = NULL;
 
-   static CCodeDataLogger* m_pLogger [ NUM_ROM_BANKS ];
-   static CCodeDataLogger* m_pEXRAMLogger;
-   static CCodeDataLogger* m_pSRAMLogger [ NUM_SRAM_BANKS ];
+      // Mapper stuff...
+      uint32_t           m_mapper = 0;
+      uint32_t           m_numPrgBanks = 0;
+      uint32_t           m_numChrBanks = 0;
+      uint8_t* m_pPRGROMmemory [ 4 ] = { NULL, NULL, NULL, NULL };
+      uint8_t* m_pCHRmemory [ 8 ] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+      uint8_t* m_pSRAMmemory [ 5 ] = { NULL, NULL, NULL, NULL, NULL };
 
-   static CRegisterDatabase* m_dbRegisters;
+      CCodeDataLogger* m_pLogger [ NUM_ROM_BANKS ] = { NULL, };
+      CCodeDataLogger* m_pUnloadedLogger = NULL;
+      CCodeDataLogger* m_pEXRAMLogger = NULL;
+      CCodeDataLogger* m_pSRAMLogger [ NUM_SRAM_BANKS ] = { NULL, };
+
+      CRegisterDatabase* m_dbRegisters = NULL;
+
+
+
+      uint8_t**  m_PRGROMopcodeMask = NULL;
+      DirtyRange* m_PRGROMopcodeMaskDirty = NULL;
+      uint16_t** m_PRGROMsloc2addr = NULL;
+      uint16_t** m_PRGROMaddr2sloc = NULL;
+      uint32_t*  m_PRGROMsloc = NULL;
+
+      // PRG-ROM banks get their own logger and disassembly tables when
+      // a ROM is first loaded into them.  Until then they share these.
+      int32_t    m_numPrgBankTables = 0;
+      uint8_t*   m_unloadedOpcodeMask = NULL;
+      uint16_t*  m_unloadedSloc2addr = NULL;
+      uint16_t*  m_unloadedAddr2sloc = NULL;
+
+      uint8_t**  m_SRAMopcodeMask = NULL;
+      DirtyRange* m_SRAMopcodeMaskDirty = NULL;
+      uint16_t** m_SRAMsloc2addr = NULL;
+      uint16_t** m_SRAMaddr2sloc = NULL;
+      uint32_t*  m_SRAMsloc = NULL;
+      bool       m_SRAMdirty = false;
+
+      uint8_t*  m_EXRAMopcodeMask = NULL;
+      DirtyRange m_EXRAMopcodeMaskDirty = { 0, MEM_1KB-1 };
+      uint16_t* m_EXRAMsloc2addr = NULL;
+      uint16_t* m_EXRAMaddr2sloc = NULL;
+      uint32_t   m_EXRAMsloc = 0;
+   };
+   static inline State* STATE ();
+
+   // The data saved and restored as-is by SAVESTATE and LOADSTATE.
+   template <class STREAM> static void STATEDATA ( STREAM& stream );
 
    static CMemoryDatabase* m_dbPRGROMMemory;
    static CMemoryDatabase* m_dbSRAMMemory;
    static CMemoryDatabase* m_dbEXRAMMemory;
    static CMemoryDatabase* m_dbCHRMemory;
-
    static CBreakpointEventInfo** m_tblBreakpointEvents;
    static int32_t                    m_numBreakpointEvents;
-
-   static uint8_t**  m_PRGROMopcodeMask;
-   static bool*      m_PRGROMopcodeMaskDirty;
-   static char***    m_PRGROMdisassembly;
-   static uint16_t** m_PRGROMsloc2addr;
-   static uint16_t** m_PRGROMaddr2sloc;
-   static uint32_t*  m_PRGROMsloc;
-
-   static uint8_t**  m_SRAMopcodeMask;
-   static bool*      m_SRAMopcodeMaskDirty;
-   static char***    m_SRAMdisassembly;
-   static uint16_t** m_SRAMsloc2addr;
-   static uint16_t** m_SRAMaddr2sloc;
-   static uint32_t*  m_SRAMsloc;
-   static bool       m_SRAMdirty;
-
-   static uint8_t*  m_EXRAMopcodeMask;
-   static bool     m_EXRAMopcodeMaskDirty;
-   static char**          m_EXRAMdisassembly;
-   static uint16_t* m_EXRAMsloc2addr;
-   static uint16_t* m_EXRAMaddr2sloc;
-   static uint32_t   m_EXRAMsloc;
 };
 
 #endif
@@ -18,6 +18,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 001 Registers
 static CBitfieldData* tbl8000_9FFFBitfields [] =
@@ -64,14 +65,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,4,4,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper001::m_reg [] = { 0x0C, 0x00, 0x00, 0x00 };
-uint8_t  CROMMapper001::m_regdef [] = { 0x0C, 0x00, 0x00, 0x00 };
-uint8_t  CROMMapper001::m_sr = 0x00;
-uint8_t  CROMMapper001::m_sel = 0x00;
-uint8_t  CROMMapper001::m_srCount = 0;
-uint32_t CROMMapper001::m_cpuCycleOfLastWrite = 0xFFFFFFFF;
-uint32_t CROMMapper001::m_cpuCycle = 0xFFFFFFFF;
-
 CROMMapper001::CROMMapper001()
 {
 }
@@ -84,27 +77,27 @@ void CROMMapper001::RESET ( bool soft )
 {
    int32_t idx;
 
-   m_mapper = 1;
+   CROM::STATE()->m_mapper = 1;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_sr = 0;
-   m_srCount = 0;
+   STATE()->m_sr = 0;
+   STATE()->m_srCount = 0;
 
-   m_cpuCycleOfLastWrite = 0xFFFFFFFF;
-   m_cpuCycle = 0xFFFFFFFF;
+   STATE()->m_cpuCycleOfLastWrite = 0xFFFFFFFF;
+   STATE()->m_cpuCycle = 0xFFFFFFFF;
 
    for ( idx = 0; idx < 4; idx++ )
    {
-      m_reg [ idx ] = m_regdef [ idx ];
+      STATE()->m_reg [ idx ] = STATE()->m_regdef [ idx ];
    }
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
@@ -112,12 +105,12 @@ void CROMMapper001::RESET ( bool soft )
 void CROMMapper001::SYNCCPU()
 {
    // This may not be the actual CPU cycle but it doesn't matter.
-   m_cpuCycle++;
+   STATE()->m_cpuCycle++;
 }
 
 uint32_t CROMMapper001::DEBUGINFO ( uint32_t addr )
 {
-   return m_reg [ (addr-MEM_32KB)/MEM_8KB ];
+   return STATE()->m_reg [ (addr-MEM_32KB)/MEM_8KB ];
 }
 
 void CROMMapper001::HMAPPER ( uint32_t addr, uint8_t data )
@@ -125,43 +118,43 @@ void CROMMapper001::HMAPPER ( uint32_t addr, uint8_t data )
    uint8_t bank = 0;
 
    // Discard this write if it's immediately following another write.
-   if ( m_cpuCycle == m_cpuCycleOfLastWrite+1 )
+   if ( STATE()->m_cpuCycle == STATE()->m_cpuCycleOfLastWrite+1 )
    {
       return;
    }
 
    // Keep track of when we last wrote.
-   m_cpuCycleOfLastWrite = m_cpuCycle;
+   STATE()->m_cpuCycleOfLastWrite = STATE()->m_cpuCycle;
 
    // Shift bits into registers...
    if ( data&0x80 )
    {
-      m_sr = 0x00;
-      m_srCount = 0;
-      m_reg [ 0 ] |= m_regdef [ 0 ];
-      m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-      m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+      STATE()->m_sr = 0x00;
+      STATE()->m_srCount = 0;
+      STATE()->m_reg [ 0 ] |= STATE()->m_regdef [ 0 ];
+      CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+      CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
    }
    else
    {
-      m_sr>>=1;
-      m_sr|=((data&0x01)<<4);
-      m_srCount++;
+      STATE()->m_sr>>=1;
+      STATE()->m_sr|=((data&0x01)<<4);
+      STATE()->m_srCount++;
 
-      if ( m_srCount == 5 )
+      if ( STATE()->m_srCount == 5 )
       {
-         m_sel = (addr-0x8000)/0x2000;
-         m_reg [ m_sel ] = m_sr;
-         m_srCount = 0;
+         STATE()->m_sel = (addr-0x8000)/0x2000;
+         STATE()->m_reg [ STATE()->m_sel ] = STATE()->m_sr;
+         STATE()->m_srCount = 0;
 
          // Act on new register content...
-         switch ( m_sel )
+         switch ( STATE()->m_sel )
          {
             case 0:
 
-               if ( m_reg[0]&0x02 )
+               if ( STATE()->m_reg[0]&0x02 )
                {
-                  if ( m_reg[0]&0x01 )
+                  if ( STATE()->m_reg[0]&0x01 )
                   {
                      CPPU::MIRRORHORIZ ();
                   }
@@ -172,93 +165,93 @@ void CROMMapper001::HMAPPER ( uint32_t addr, uint8_t data )
                }
                else
                {
-                  CPPU::MIRROR ( m_reg[0]&0x01 );
+                  CPPU::MIRROR ( STATE()->m_reg[0]&0x01 );
                }
 
                break;
             case 1:
 
-               if ( m_numChrBanks > 0 )
+               if ( CROM::STATE()->m_numChrBanks > 0 )
                {
-                  if ( m_reg[0]&0x10 )
+                  if ( STATE()->m_reg[0]&0x10 )
                   {
-                     m_pCHRmemory [ 0 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+0 ];
-                     m_pCHRmemory [ 1 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+1 ];
-                     m_pCHRmemory [ 2 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+2 ];
-                     m_pCHRmemory [ 3 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+3 ];
+                     CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+0 ];
+                     CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+1 ];
+                     CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+2 ];
+                     CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+3 ];
                   }
                   else
                   {
-                     m_pCHRmemory [ 0 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+0 ];
-                     m_pCHRmemory [ 1 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+1 ];
-                     m_pCHRmemory [ 2 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+2 ];
-                     m_pCHRmemory [ 3 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+3 ];
-                     m_pCHRmemory [ 4 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+4 ];
-                     m_pCHRmemory [ 5 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+5 ];
-                     m_pCHRmemory [ 6 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+6 ];
-                     m_pCHRmemory [ 7 ] = m_CHRmemory [ ((m_reg[1]&0x1F)<<2)+7 ];
+                     CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+0 ];
+                     CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+1 ];
+                     CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+2 ];
+                     CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+3 ];
+                     CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+4 ];
+                     CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+5 ];
+                     CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+6 ];
+                     CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[1]&0x1F)<<2)+7 ];
                   }
                }
                else
                {
-                  if ( m_reg[0]&0x10 )
+                  if ( STATE()->m_reg[0]&0x10 )
                   {
-                     m_pCHRmemory [ 0 ] = m_CHRmemory [ 0 ];
-                     m_pCHRmemory [ 1 ] = m_CHRmemory [ 1 ];
-                     m_pCHRmemory [ 2 ] = m_CHRmemory [ 2 ];
-                     m_pCHRmemory [ 3 ] = m_CHRmemory [ 3 ];
+                     CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ 0 ];
+                     CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ 1 ];
+                     CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ 2 ];
+                     CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ 3 ];
                   }
                }
 
                break;
             case 2:
 
-               if ( m_numChrBanks > 0 )
+               if ( CROM::STATE()->m_numChrBanks > 0 )
                {
-                  if ( m_reg[0]&0x10 )
+                  if ( STATE()->m_reg[0]&0x10 )
                   {
-                     m_pCHRmemory [ 4 ] = m_CHRmemory [ ((m_reg[2]&0x1F)<<2)+0 ];
-                     m_pCHRmemory [ 5 ] = m_CHRmemory [ ((m_reg[2]&0x1F)<<2)+1 ];
-                     m_pCHRmemory [ 6 ] = m_CHRmemory [ ((m_reg[2]&0x1F)<<2)+2 ];
-                     m_pCHRmemory [ 7 ] = m_CHRmemory [ ((m_reg[2]&0x1F)<<2)+3 ];
+                     CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[2]&0x1F)<<2)+0 ];
+                     CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[2]&0x1F)<<2)+1 ];
+                     CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[2]&0x1F)<<2)+2 ];
+                     CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg[2]&0x1F)<<2)+3 ];
                   }
                }
                else
                {
-                  if ( m_reg[0]&0x10 )
+                  if ( STATE()->m_reg[0]&0x10 )
                   {
-                     m_pCHRmemory [ 4 ] = m_CHRmemory [ 4 ];
-                     m_pCHRmemory [ 5 ] = m_CHRmemory [ 5 ];
-                     m_pCHRmemory [ 6 ] = m_CHRmemory [ 6 ];
-                     m_pCHRmemory [ 7 ] = m_CHRmemory [ 7 ];
+                     CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ 4 ];
+                     CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ 5 ];
+                     CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ 6 ];
+                     CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ 7 ];
                   }
                }
 
                break;
             case 3:
 
-               if ( m_reg[0]&0x08 )
+               if ( STATE()->m_reg[0]&0x08 )
                {
-                  bank = (m_reg[3]&0x0F)<<1;
+                  bank = (STATE()->m_reg[3]&0x0F)<<1;
 
-                  if ( m_reg[0]&0x04 )
+                  if ( STATE()->m_reg[0]&0x04 )
                   {
-                     m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ bank ];
-                     m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ bank+1 ];
+                     CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ bank ];
+                     CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ bank+1 ];
                   }
                   else
                   {
-                     m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ bank ];
-                     m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ bank+1 ];
+                     CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ bank ];
+                     CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ bank+1 ];
                   }
                }
                else
                {
-                  bank = m_reg[3]&0x0F;
-                  m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ bank ];
-                  m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ bank+1 ];
-                  m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ bank+2 ];
-                  m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ bank+3 ];
+                  bank = STATE()->m_reg[3]&0x0F;
+                  CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ bank ];
+                  CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ bank+1 ];
+                  CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ bank+2 ];
+                  CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ bank+3 ];
                }
 
                break;
@@ -268,7 +261,7 @@ void CROMMapper001::HMAPPER ( uint32_t addr, uint8_t data )
          {
             // Check mapper state breakpoints...
             // m_sel is convenient register number...
-            CNES::CHECKBREAKPOINT(eBreakInMapper,eBreakOnMapperState,m_sel);
+            CNES::CHECKBREAKPOINT(eBreakInMapper,eBreakOnMapperState,STATE()->m_sel);
          }
       }
    }
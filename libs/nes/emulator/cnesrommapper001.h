@@ -18,22 +18,27 @@ public:
    // Note: called directly!
    static uint32_t SHIFTREGISTER ( void )
    {
-      return m_sr;
+      return STATE()->m_sr;
    }
    static uint32_t SHIFTREGISTERBIT ( void )
    {
-      return m_srCount;
+      return STATE()->m_srCount;
    }
 
 protected:
-   // MMC1
-   static uint8_t  m_reg [ 4 ];
-   static uint8_t  m_regdef [ 4 ];
-   static uint8_t  m_sr;
-   static uint8_t  m_sel;
-   static uint8_t  m_srCount;
-   static uint32_t m_cpuCycleOfLastWrite;
-   static uint32_t m_cpuCycle;
+   friend struct NESContext;
+   struct State
+   {
+      // MMC1
+      uint8_t  m_reg [ 4 ] = { 0x0C, 0x00, 0x00, 0x00 };
+      uint8_t  m_regdef [ 4 ] = { 0x0C, 0x00, 0x00, 0x00 };
+      uint8_t  m_sr = 0x00;
+      uint8_t  m_sel = 0x00;
+      uint8_t  m_srCount = 0;
+      uint32_t m_cpuCycleOfLastWrite = 0xFFFFFFFF;
+      uint32_t m_cpuCycle = 0xFFFFFFFF;
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -17,6 +17,7 @@
 #include "cnesrommapper002.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 002 Registers
 static CBitfieldData* tbl8000_FFFFBitfields [] =
@@ -41,8 +42,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,1,1,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper002::m_reg = 0x00;
-
 CROMMapper002::CROMMapper002()
 {
 }
@@ -53,35 +52,35 @@ CROMMapper002::~CROMMapper002()
 
 void CROMMapper002::RESET ( bool soft )
 {
-   m_mapper = 2;
+   CROM::STATE()->m_mapper = 2;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
 
 uint32_t CROMMapper002::DEBUGINFO ( uint32_t addr )
 {
-   return m_reg;
+   return STATE()->m_reg;
 }
 
 void CROMMapper002::HMAPPER ( uint32_t addr, uint8_t data )
 {
    uint8_t bank;
 
-   m_reg = data%m_numPrgBanks;
+   STATE()->m_reg = data%CROM::STATE()->m_numPrgBanks;
 
-   bank = m_reg<<1;
+   bank = STATE()->m_reg<<1;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ bank ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ bank+1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ bank ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ bank+1 ];
 
    if ( nesIsDebuggable() )
    {
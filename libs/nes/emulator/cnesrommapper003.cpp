@@ -18,6 +18,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 003 Registers
 static CBitfieldData* tbl8000_FFFFBitfields [] =
@@ -42,8 +43,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,1,1,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper003::m_reg = 0x00;
-
 CROMMapper003::CROMMapper003()
 {
 }
@@ -54,38 +53,38 @@ CROMMapper003::~CROMMapper003()
 
 void CROMMapper003::RESET ( bool soft )
 {
-   m_mapper = 3;
+   CROM::STATE()->m_mapper = 3;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
 
 uint32_t CROMMapper003::DEBUGINFO ( uint32_t addr )
 {
-   return m_reg;
+   return STATE()->m_reg;
 }
 
 void CROMMapper003::HMAPPER ( uint32_t addr, uint8_t data )
 {
-   m_reg = data&0x3; // avoid latch diode protection bits
+   STATE()->m_reg = data&0x3; // avoid latch diode protection bits
                      // https://wiki.nesdev.com/w/index.php/CNROM
 
-   m_pCHRmemory [ 0 ] = m_CHRmemory [ (m_reg<<3)+0 ];
-   m_pCHRmemory [ 1 ] = m_CHRmemory [ (m_reg<<3)+1 ];
-   m_pCHRmemory [ 2 ] = m_CHRmemory [ (m_reg<<3)+2 ];
-   m_pCHRmemory [ 3 ] = m_CHRmemory [ (m_reg<<3)+3 ];
-   m_pCHRmemory [ 4 ] = m_CHRmemory [ (m_reg<<3)+4 ];
-   m_pCHRmemory [ 5 ] = m_CHRmemory [ (m_reg<<3)+5 ];
-   m_pCHRmemory [ 6 ] = m_CHRmemory [ (m_reg<<3)+6 ];
-   m_pCHRmemory [ 7 ] = m_CHRmemory [ (m_reg<<3)+7 ];
+   CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg<<3)+0 ];
+   CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg<<3)+1 ];
+   CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg<<3)+2 ];
+   CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg<<3)+3 ];
+   CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg<<3)+4 ];
+   CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg<<3)+5 ];
+   CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg<<3)+6 ];
+   CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg<<3)+7 ];
 
    if ( nesIsDebuggable() )
    {
@@ -20,46 +20,51 @@ public:
    // Note: called directly!
    static uint32_t IRQENABLED ( void )
    {
-      return m_irqEnable;
+      return STATE()->m_irqEnable;
    }
    static uint32_t IRQASSERTED ( void )
    {
-      return m_irqAsserted;
+      return STATE()->m_irqAsserted;
    }
    static uint32_t IRQRELOAD ( void )
    {
-      return m_irqReload;
+      return STATE()->m_irqReload;
    }
    static uint32_t IRQCOUNTER ( void )
    {
-      return m_irqCounter;
+      return STATE()->m_irqCounter;
    }
    static uint32_t IRQLATCH ( void )
    {
-      return m_irqLatch;
+      return STATE()->m_irqLatch;
    }
    static uint32_t PPUADDRA12 ( void )
    {
-      return m_lastPPUAddrA12;
+      return STATE()->m_lastPPUAddrA12;
    }
    static uint32_t PPUCYCLE ( void )
    {
-      return m_lastPPUCycle;
+      return STATE()->m_lastPPUCycle;
    }
 
 protected:
-   // MMC3
-   static uint8_t  m_reg [ 8 ];
-   static bool           m_irqAsserted;
-   static uint8_t  m_irqCounter;
-   static uint8_t  m_irqLatch;
-   static bool           m_irqEnable;
-   static bool           m_irqReload;
-   static uint8_t  m_prg [ 2 ];
-   static uint8_t  m_chr [ 8 ];
+   friend struct NESContext;
+   struct State
+   {
+      // MMC3
+      uint8_t  m_reg [ 8 ] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+      bool           m_irqAsserted = false;
+      uint8_t  m_irqCounter = 0x00;
+      uint8_t  m_irqLatch = 0x00;
+      bool           m_irqEnable = false;
+      bool           m_irqReload = false;
+      uint8_t  m_prg [ 2 ] = { 0, 0 };
+      uint8_t  m_chr [ 8 ] = { 0, 0, 0, 0, 0, 0, 0, 0 };
 
-   static uint32_t   m_lastPPUAddrA12;
-   static uint32_t   m_lastPPUCycle;
+      uint32_t   m_lastPPUAddrA12 = 0;
+      uint32_t   m_lastPPUCycle = 0;
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -24,28 +24,37 @@ public:
    static void SOUNDENABLE ( uint32_t mask );
 
 protected:
-   // MMC5
-   static uint8_t m_prgMode;
-   static uint8_t m_chrMode;
-   static uint8_t m_chrHigh;
-   static uint8_t m_irqScanline;
-   static uint8_t m_irqEnabled;
-   static uint8_t m_irqStatus;
-   static bool          m_prgRAM [ 3 ];
-   static bool          m_wp;
-   static uint32_t m_ppuCycle;
-   static uint8_t m_chr[12];
-   static uint8_t m_wp1;
-   static uint8_t m_wp2;
-   static uint8_t  m_mult1;
-   static uint8_t  m_mult2;
-   static uint16_t m_prod;
-   static uint8_t  m_fillTile;
-   static uint8_t  m_fillAttr;
-   static uint8_t  m_reg[44];
+   friend struct NESContext;
+   struct State
+   {
+      // MMC5
+      uint8_t m_prgMode = 0;
+      uint8_t m_chrMode = 0;
+      uint8_t m_chrHigh = 0;
+      uint8_t m_irqScanline = 0;
+      uint8_t m_irqEnabled = 0;
+      uint8_t m_irqStatus = 0;
+      bool          m_prgRAM [ 3 ] = { false, false, false };
+      bool          m_wp = false;
+      uint32_t m_ppuCycle = 0;
+      uint8_t m_chr[12] = { 0, };
+      uint8_t m_wp1 = 0;
+      uint8_t m_wp2 = 0;
+      uint8_t  m_mult1 = 0;
+      uint8_t  m_mult2 = 0;
+      uint16_t m_prod = 0;
+      uint8_t  m_fillTile = 0;
+      uint8_t  m_fillAttr = 0;
+      uint8_t  m_reg[44] = { 0, };
 
-   static CAPUSquare m_square[2];
-   static CAPUDMC    m_dmc;
+      CAPUSquare m_square[2];
+      CAPUDMC    m_dmc;
+
+      // Output filter accumulators.
+      int16_t m_outLast = 0;
+      int32_t m_outDownsampled = 0;
+   };
+   static inline State* STATE ();
 };
 
 #endif
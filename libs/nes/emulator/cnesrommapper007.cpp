@@ -19,6 +19,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 007 Registers
 static CBitfieldData* tbl8000_FFFFBitfields [] =
@@ -44,8 +45,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,1,1,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper007::m_reg = 0x00;
-
 CROMMapper007::CROMMapper007()
 {
 }
@@ -56,16 +55,16 @@ CROMMapper007::~CROMMapper007()
 
 void CROMMapper007::RESET ( bool soft )
 {
-   m_mapper = 7;
+   CROM::STATE()->m_mapper = 7;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    CPPU::MIRROR ( 0 );
 
@@ -74,23 +73,23 @@ void CROMMapper007::RESET ( bool soft )
 
 uint32_t CROMMapper007::DEBUGINFO ( uint32_t addr )
 {
-   return m_reg;
+   return STATE()->m_reg;
 }
 
 void CROMMapper007::HMAPPER ( uint32_t addr, uint8_t data )
 {
    uint8_t bank;
 
-   m_reg = data;
+   STATE()->m_reg = data;
 
-   bank = (m_reg&0xF)<<2;
+   bank = (STATE()->m_reg&0xF)<<2;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ bank ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ bank+1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ bank+2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ bank+3 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ bank ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ bank+1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ bank+2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ bank+3 ];
 
-   CPPU::MIRROR ( (m_reg&0x10)>>4 );
+   CPPU::MIRROR ( (STATE()->m_reg&0x10)>>4 );
 
    if ( nesIsDebuggable() )
    {
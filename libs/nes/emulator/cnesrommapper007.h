@@ -14,7 +14,12 @@ public:
    static uint32_t DEBUGINFO ( uint32_t addr );
 
 protected:
-   static uint8_t  m_reg;
+   friend struct NESContext;
+   struct State
+   {
+      uint8_t  m_reg = 0x00;
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -16,6 +16,7 @@
 
 #include "cnesrommapper010.h"
 #include "cnesppu.h"
+#include "cnescontext.h"
 
 // Mapper 010 Registers
 static CBitfieldData* tblA000_AFFFBitfields [] =
@@ -70,15 +71,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,6,6,tblRegisters,rowHeadings,columnHeadings);
 
-// MMC2 stuff
-uint8_t  CROMMapper010::m_reg [] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
-uint8_t  CROMMapper010::m_latch0 = 0xFE;
-uint8_t  CROMMapper010::m_latch1 = 0xFE;
-uint8_t  CROMMapper010::m_latch0FD = 0;
-uint8_t  CROMMapper010::m_latch0FE = 1;
-uint8_t  CROMMapper010::m_latch1FD = 0;
-uint8_t  CROMMapper010::m_latch1FE = 0;
-
 CROMMapper010::CROMMapper010()
 {
 }
@@ -89,32 +81,32 @@ CROMMapper010::~CROMMapper010()
 
 void CROMMapper010::RESET ( bool soft )
 {
-   m_mapper = 10;
-
-   m_dbRegisters = dbRegisters;
-
-   CROM::RESET ( m_mapper, soft );
-
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
-
-   m_latch0 = 0xFE;
-   m_latch1 = 0xFE;
-   m_latch0FD = 0;
-   m_latch0FE = 1;
-   m_latch1FD = 0;
-   m_latch1FE = 0;
-
-   m_pCHRmemory [ 0 ] = m_CHRmemory [ (m_latch0FE<<2)+0 ];
-   m_pCHRmemory [ 1 ] = m_CHRmemory [ (m_latch0FE<<2)+1 ];
-   m_pCHRmemory [ 2 ] = m_CHRmemory [ (m_latch0FE<<2)+2 ];
-   m_pCHRmemory [ 3 ] = m_CHRmemory [ (m_latch0FE<<2)+3 ];
-   m_pCHRmemory [ 4 ] = m_CHRmemory [ (m_latch1FE<<2)+0 ];
-   m_pCHRmemory [ 5 ] = m_CHRmemory [ (m_latch1FE<<2)+1 ];
-   m_pCHRmemory [ 6 ] = m_CHRmemory [ (m_latch1FE<<2)+2 ];
-   m_pCHRmemory [ 7 ] = m_CHRmemory [ (m_latch1FE<<2)+3 ];
+   CROM::STATE()->m_mapper = 10;
+
+   CROM::STATE()->m_dbRegisters = dbRegisters;
+
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
+
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
+
+   STATE()->m_latch0 = 0xFE;
+   STATE()->m_latch1 = 0xFE;
+   STATE()->m_latch0FD = 0;
+   STATE()->m_latch0FE = 1;
+   STATE()->m_latch1FD = 0;
+   STATE()->m_latch1FE = 0;
+
+   CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+0 ];
+   CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+1 ];
+   CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+2 ];
+   CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+3 ];
+   CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+0 ];
+   CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+1 ];
+   CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+2 ];
+   CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+3 ];
 }
 
 uint32_t CROMMapper010::DEBUGINFO ( uint32_t addr )
@@ -122,22 +114,22 @@ uint32_t CROMMapper010::DEBUGINFO ( uint32_t addr )
    switch ( addr&0xF000 )
    {
       case 0xA000:
-         return m_reg [ 0 ];
+         return STATE()->m_reg [ 0 ];
          break;
       case 0xB000:
-         return m_reg [ 1 ];
+         return STATE()->m_reg [ 1 ];
          break;
       case 0xC000:
-         return m_reg [ 2 ];
+         return STATE()->m_reg [ 2 ];
          break;
       case 0xD000:
-         return m_reg [ 3 ];
+         return STATE()->m_reg [ 3 ];
          break;
       case 0xE000:
-         return m_reg [ 4 ];
+         return STATE()->m_reg [ 4 ];
          break;
       case 0xF000:
-         return m_reg [ 5 ];
+         return STATE()->m_reg [ 5 ];
          break;
    }
 
@@ -152,69 +144,69 @@ void CROMMapper010::HMAPPER ( uint32_t addr, uint8_t data )
    {
       case 0xA000:
          reg = 0;
-         m_reg [ 0 ] = data;
-         m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ (data<<1)+0 ];
-         m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ (data<<1)+1 ];
+         STATE()->m_reg [ 0 ] = data;
+         CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ (data<<1)+0 ];
+         CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ (data<<1)+1 ];
          break;
       case 0xB000:
          reg = 1;
-         m_reg [ 1 ] = data;
-         m_latch0FD = data;
+         STATE()->m_reg [ 1 ] = data;
+         STATE()->m_latch0FD = data;
 
-         if ( m_latch0 == 0xFD )
+         if ( STATE()->m_latch0 == 0xFD )
          {
-            m_pCHRmemory [ 0 ] = m_CHRmemory [ (m_latch0FD<<2)+0 ];
-            m_pCHRmemory [ 1 ] = m_CHRmemory [ (m_latch0FD<<2)+1 ];
-            m_pCHRmemory [ 2 ] = m_CHRmemory [ (m_latch0FD<<2)+2 ];
-            m_pCHRmemory [ 3 ] = m_CHRmemory [ (m_latch0FD<<2)+3 ];
+            CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FD<<2)+0 ];
+            CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FD<<2)+1 ];
+            CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FD<<2)+2 ];
+            CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FD<<2)+3 ];
          }
 
          break;
       case 0xC000:
          reg = 2;
-         m_reg [ 2 ] = data;
-         m_latch0FE = data;
+         STATE()->m_reg [ 2 ] = data;
+         STATE()->m_latch0FE = data;
 
-         if ( m_latch0 == 0xFE )
+         if ( STATE()->m_latch0 == 0xFE )
          {
-            m_pCHRmemory [ 0 ] = m_CHRmemory [ (m_latch0FE<<2)+0 ];
-            m_pCHRmemory [ 1 ] = m_CHRmemory [ (m_latch0FE<<2)+1 ];
-            m_pCHRmemory [ 2 ] = m_CHRmemory [ (m_latch0FE<<2)+2 ];
-            m_pCHRmemory [ 3 ] = m_CHRmemory [ (m_latch0FE<<2)+3 ];
+            CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+0 ];
+            CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+1 ];
+            CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+2 ];
+            CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+3 ];
          }
 
          break;
       case 0xD000:
          reg = 3;
-         m_reg [ 3 ] = data;
-         m_latch1FD = data;
+         STATE()->m_reg [ 3 ] = data;
+         STATE()->m_latch1FD = data;
 
-         if ( m_latch1 == 0xFD )
+         if ( STATE()->m_latch1 == 0xFD )
          {
-            m_pCHRmemory [ 4 ] = m_CHRmemory [ (m_latch1FD<<2)+0 ];
-            m_pCHRmemory [ 5 ] = m_CHRmemory [ (m_latch1FD<<2)+1 ];
-            m_pCHRmemory [ 6 ] = m_CHRmemory [ (m_latch1FD<<2)+2 ];
-            m_pCHRmemory [ 7 ] = m_CHRmemory [ (m_latch1FD<<2)+3 ];
+            CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FD<<2)+0 ];
+            CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FD<<2)+1 ];
+            CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FD<<2)+2 ];
+            CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FD<<2)+3 ];
          }
 
          break;
       case 0xE000:
          reg = 4;
-         m_reg [ 4 ] = data;
-         m_latch1FE = data;
+         STATE()->m_reg [ 4 ] = data;
+         STATE()->m_latch1FE = data;
 
-         if ( m_latch1 == 0xFE )
+         if ( STATE()->m_latch1 == 0xFE )
          {
-            m_pCHRmemory [ 4 ] = m_CHRmemory [ (m_latch1FE<<2)+0 ];
-            m_pCHRmemory [ 5 ] = m_CHRmemory [ (m_latch1FE<<2)+1 ];
-            m_pCHRmemory [ 6 ] = m_CHRmemory [ (m_latch1FE<<2)+2 ];
-            m_pCHRmemory [ 7 ] = m_CHRmemory [ (m_latch1FE<<2)+3 ];
+            CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+0 ];
+            CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+1 ];
+            CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+2 ];
+            CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+3 ];
          }
 
          break;
       case 0xF000:
          reg = 5;
-         m_reg [ 5 ] = data;
+         STATE()->m_reg [ 5 ] = data;
 
          if ( !(CPPU::FOURSCREEN()) )
          {
@@ -242,34 +234,34 @@ void CROMMapper010::SYNCPPU ( uint32_t ppuCycle, uint32_t ppuAddr )
 {
    if ( (ppuAddr&0x1FF0) == 0x0FD0 )
    {
-      m_latch0 = 0xFD;
-      m_pCHRmemory [ 0 ] = m_CHRmemory [ (m_latch0FD<<2)+0 ];
-      m_pCHRmemory [ 1 ] = m_CHRmemory [ (m_latch0FD<<2)+1 ];
-      m_pCHRmemory [ 2 ] = m_CHRmemory [ (m_latch0FD<<2)+2 ];
-      m_pCHRmemory [ 3 ] = m_CHRmemory [ (m_latch0FD<<2)+3 ];
+      STATE()->m_latch0 = 0xFD;
+      CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FD<<2)+0 ];
+      CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FD<<2)+1 ];
+      CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FD<<2)+2 ];
+      CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FD<<2)+3 ];
    }
    else if ( (ppuAddr&0x1FF0) == 0x0FE0 )
    {
-      m_latch0 = 0xFE;
-      m_pCHRmemory [ 0 ] = m_CHRmemory [ (m_latch0FE<<2)+0 ];
-      m_pCHRmemory [ 1 ] = m_CHRmemory [ (m_latch0FE<<2)+1 ];
-      m_pCHRmemory [ 2 ] = m_CHRmemory [ (m_latch0FE<<2)+2 ];
-      m_pCHRmemory [ 3 ] = m_CHRmemory [ (m_latch0FE<<2)+3 ];
+      STATE()->m_latch0 = 0xFE;
+      CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+0 ];
+      CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+1 ];
+      CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+2 ];
+      CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch0FE<<2)+3 ];
    }
    else if ( (ppuAddr&0x1FF0) == 0x1FD0 )
    {
-      m_latch1 = 0xFD;
-      m_pCHRmemory [ 4 ] = m_CHRmemory [ (m_latch1FD<<2)+0 ];
-      m_pCHRmemory [ 5 ] = m_CHRmemory [ (m_latch1FD<<2)+1 ];
-      m_pCHRmemory [ 6 ] = m_CHRmemory [ (m_latch1FD<<2)+2 ];
-      m_pCHRmemory [ 7 ] = m_CHRmemory [ (m_latch1FD<<2)+3 ];
+      STATE()->m_latch1 = 0xFD;
+      CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FD<<2)+0 ];
+      CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FD<<2)+1 ];
+      CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FD<<2)+2 ];
+      CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FD<<2)+3 ];
    }
    else if ( (ppuAddr&0x1FF0) == 0x1FE0 )
    {
-      m_latch1 = 0xFE;
-      m_pCHRmemory [ 4 ] = m_CHRmemory [ (m_latch1FE<<2)+0 ];
-      m_pCHRmemory [ 5 ] = m_CHRmemory [ (m_latch1FE<<2)+1 ];
-      m_pCHRmemory [ 6 ] = m_CHRmemory [ (m_latch1FE<<2)+2 ];
-      m_pCHRmemory [ 7 ] = m_CHRmemory [ (m_latch1FE<<2)+3 ];
+      STATE()->m_latch1 = 0xFE;
+      CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+0 ];
+      CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+1 ];
+      CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+2 ];
+      CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_latch1FE<<2)+3 ];
    }
 }
@@ -18,38 +18,43 @@ public:
    // Note: called directly!
    static uint32_t LATCH0FD ( void )
    {
-      return m_latch0FD;
+      return STATE()->m_latch0FD;
    }
    static uint32_t LATCH0FE ( void )
    {
-      return m_latch0FE;
+      return STATE()->m_latch0FE;
    }
    static uint32_t LATCH1FD ( void )
    {
-      return m_latch1FD;
+      return STATE()->m_latch1FD;
    }
    static uint32_t LATCH1FE ( void )
    {
-      return m_latch1FE;
+      return STATE()->m_latch1FE;
    }
    static uint32_t LATCH0 ( void )
    {
-      return m_latch0;
+      return STATE()->m_latch0;
    }
    static uint32_t LATCH1 ( void )
    {
-      return m_latch0;
+      return STATE()->m_latch0;
    }
 
 protected:
-   // MMC3
-   static uint8_t  m_reg [ 6 ];
-   static uint8_t  m_latch0;
-   static uint8_t  m_latch1;
-   static uint8_t  m_latch0FD;
-   static uint8_t  m_latch0FE;
-   static uint8_t  m_latch1FD;
-   static uint8_t  m_latch1FE;
+   friend struct NESContext;
+   struct State
+   {
+      // MMC3
+      uint8_t  m_reg [ 6 ] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+      uint8_t  m_latch0 = 0xFE;
+      uint8_t  m_latch1 = 0xFE;
+      uint8_t  m_latch0FD = 0;
+      uint8_t  m_latch0FE = 1;
+      uint8_t  m_latch1FD = 0;
+      uint8_t  m_latch1FE = 0;
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -16,6 +16,7 @@
 
 #include "cnesrommapper011.h"
 #include "cnesppu.h"
+#include "cnescontext.h"
 
 // Mapper 011 Registers
 static CBitfieldData* tbl8000_FFFFBitfields [] =
@@ -42,8 +43,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,1,1,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper011::m_reg = 0x00;
-
 CROMMapper011::CROMMapper011()
 {
 }
@@ -54,46 +53,46 @@ CROMMapper011::~CROMMapper011()
 
 void CROMMapper011::RESET ( bool soft )
 {
-   m_mapper = 11;
+   CROM::STATE()->m_mapper = 11;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
 
 uint32_t CROMMapper011::DEBUGINFO ( uint32_t addr )
 {
-   return m_reg;
+   return STATE()->m_reg;
 }
 
 void CROMMapper011::HMAPPER ( uint32_t addr, uint8_t data )
 {
    uint8_t bank;
 
-   m_reg = data;
+   STATE()->m_reg = data;
 
    bank = ((data&0x03)<<2);
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ bank ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ bank+1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ bank+2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ bank+3 ];
-
-   m_pCHRmemory [ 0 ] = m_CHRmemory [ ((data>>1)&0x78)+0 ];
-   m_pCHRmemory [ 1 ] = m_CHRmemory [ ((data>>1)&0x78)+1 ];
-   m_pCHRmemory [ 2 ] = m_CHRmemory [ ((data>>1)&0x78)+2 ];
-   m_pCHRmemory [ 3 ] = m_CHRmemory [ ((data>>1)&0x78)+3 ];
-   m_pCHRmemory [ 4 ] = m_CHRmemory [ ((data>>1)&0x78)+4 ];
-   m_pCHRmemory [ 5 ] = m_CHRmemory [ ((data>>1)&0x78)+5 ];
-   m_pCHRmemory [ 6 ] = m_CHRmemory [ ((data>>1)&0x78)+6 ];
-   m_pCHRmemory [ 7 ] = m_CHRmemory [ ((data>>1)&0x78)+7 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ bank ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ bank+1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ bank+2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ bank+3 ];
+
+   CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ ((data>>1)&0x78)+0 ];
+   CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ ((data>>1)&0x78)+1 ];
+   CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ ((data>>1)&0x78)+2 ];
+   CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ ((data>>1)&0x78)+3 ];
+   CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ ((data>>1)&0x78)+4 ];
+   CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ ((data>>1)&0x78)+5 ];
+   CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ ((data>>1)&0x78)+6 ];
+   CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ ((data>>1)&0x78)+7 ];
 
    if ( nesIsDebuggable() )
    {
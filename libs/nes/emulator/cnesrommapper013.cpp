@@ -17,6 +17,7 @@
 #include "cnesrommapper013.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 013 Registers
 static CBitfieldData* tbl8000_FFFFBitfields [] =
@@ -41,8 +42,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,1,1,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper013::m_reg = 0x00;
-
 CROMMapper013::CROMMapper013()
 {
 }
@@ -53,33 +52,33 @@ CROMMapper013::~CROMMapper013()
 
 void CROMMapper013::RESET ( bool soft )
 {
-   m_mapper = 13;
+   CROM::STATE()->m_mapper = 13;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
 
 uint32_t CROMMapper013::DEBUGINFO ( uint32_t addr )
 {
-   return m_reg;
+   return STATE()->m_reg;
 }
 
 void CROMMapper013::HMAPPER ( uint32_t addr, uint8_t data )
 {
-   m_reg = data;
+   STATE()->m_reg = data;
 
-   m_pCHRmemory [ 4 ] = m_CHRmemory [ ((m_reg&0x3)<<2)+0 ];
-   m_pCHRmemory [ 5 ] = m_CHRmemory [ ((m_reg&0x3)<<2)+1 ];
-   m_pCHRmemory [ 6 ] = m_CHRmemory [ ((m_reg&0x3)<<2)+2 ];
-   m_pCHRmemory [ 7 ] = m_CHRmemory [ ((m_reg&0x3)<<2)+3 ];
+   CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg&0x3)<<2)+0 ];
+   CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg&0x3)<<2)+1 ];
+   CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg&0x3)<<2)+2 ];
+   CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ ((STATE()->m_reg&0x3)<<2)+3 ];
 
    if ( nesIsDebuggable() )
    {
@@ -19,6 +19,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 016 Registers
 static CBitfieldData* tbl0000Bitfields [] =
@@ -86,17 +87,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,14,14,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper016::m_reg [] = { 0x00, };
-uint16_t CROMMapper016::m_irqCounter = 0;
-bool     CROMMapper016::m_irqEnabled = false;
-bool     CROMMapper016::m_irqAsserted = false;
-uint8_t  CROMMapper016::m_eepromBitCounter = 0;
-uint8_t  CROMMapper016::m_eepromState = 0;
-uint8_t  CROMMapper016::m_eepromCmd;
-uint8_t  CROMMapper016::m_eepromAddr;
-uint8_t  CROMMapper016::m_eepromDataBuf;
-uint8_t  CROMMapper016::m_eepromRWBit;
-
 CROMMapper016::CROMMapper016()
 {
 }
@@ -109,22 +99,22 @@ void CROMMapper016::RESET016 ( bool soft )
 {
    int32_t idx;
 
-   m_mapper = 16;
+   CROM::STATE()->m_mapper = 16;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_irqCounter = 0;
-   m_irqEnabled = false;
-   m_irqAsserted = false;
-   m_eepromState = 0;
-   m_eepromBitCounter = 0;
+   STATE()->m_irqCounter = 0;
+   STATE()->m_irqEnabled = false;
+   STATE()->m_irqAsserted = false;
+   STATE()->m_eepromState = 0;
+   STATE()->m_eepromBitCounter = 0;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
@@ -134,35 +124,35 @@ void CROMMapper016::RESET159 ( bool soft )
 {
    int32_t idx;
 
-   m_mapper = 159;
+   CROM::STATE()->m_mapper = 159;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_irqCounter = 0;
-   m_irqEnabled = false;
-   m_irqAsserted = false;
-   m_eepromState = 0;
-   m_eepromBitCounter = 0;
+   STATE()->m_irqCounter = 0;
+   STATE()->m_irqEnabled = false;
+   STATE()->m_irqAsserted = false;
+   STATE()->m_eepromState = 0;
+   STATE()->m_eepromBitCounter = 0;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
 
 void CROMMapper016::SYNCCPU ( void )
 {
-   if ( m_irqEnabled )
+   if ( STATE()->m_irqEnabled )
    {
-      m_irqCounter--;
+      STATE()->m_irqCounter--;
 
-      if ( !m_irqCounter )
+      if ( !STATE()->m_irqCounter )
       {
-         m_irqAsserted = true;
+         STATE()->m_irqAsserted = true;
          C6502::ASSERTIRQ(eNESSource_Mapper);
 
          if ( nesIsDebuggable() )
@@ -179,46 +169,46 @@ uint32_t CROMMapper016::DEBUGINFO ( uint32_t addr )
    switch ( addr&0x000F )
    {
    case 0x0000:
-      return m_reg[0];
+      return STATE()->m_reg[0];
       break;
    case 0x0001:
-      return m_reg[1];
+      return STATE()->m_reg[1];
       break;
    case 0x0002:
-      return m_reg[2];
+      return STATE()->m_reg[2];
       break;
    case 0x0003:
-      return m_reg[3];
+      return STATE()->m_reg[3];
       break;
    case 0x0004:
-      return m_reg[4];
+      return STATE()->m_reg[4];
       break;
    case 0x0005:
-      return m_reg[5];
+      return STATE()->m_reg[5];
       break;
    case 0x0006:
-      return m_reg[6];
+      return STATE()->m_reg[6];
       break;
    case 0x0007:
-      return m_reg[7];
+      return STATE()->m_reg[7];
       break;
    case 0x0008:
-      return m_reg[8];
+      return STATE()->m_reg[8];
       break;
    case 0x0009:
-      return m_reg[9];
+      return STATE()->m_reg[9];
       break;
    case 0x000A:
-      return m_reg[10];
+      return STATE()->m_reg[10];
       break;
    case 0x000B:
-      return m_reg[11];
+      return STATE()->m_reg[11];
       break;
    case 0x000C:
-      return m_reg[12];
+      return STATE()->m_reg[12];
       break;
    case 0x000D:
-      return m_reg[13];
+      return STATE()->m_reg[13];
       break;
    }
 }
@@ -227,54 +217,54 @@ uint32_t CROMMapper016::LMAPPER ( uint32_t addr )
 {
    uint8_t data = C6502::OPENBUS();
 
-   switch ( m_eepromState )
+   switch ( STATE()->m_eepromState )
    {
    case 1:
       // Need to ack and skip to state 3 on a read command.
-      if ( m_eepromBitCounter == 9 )
+      if ( STATE()->m_eepromBitCounter == 9 )
       {
-         m_eepromBitCounter = 0;
-         if ( m_eepromCmd&0x01 )
+         STATE()->m_eepromBitCounter = 0;
+         if ( STATE()->m_eepromCmd&0x01 )
          {
-            m_eepromState = 3;
+            STATE()->m_eepromState = 3;
          }
          else
          {
-            m_eepromState = 2;
+            STATE()->m_eepromState = 2;
          }
          data = 0x00;
       }
    case 2:
       // Only need to ack.
-      if ( m_eepromBitCounter == 9 )
+      if ( STATE()->m_eepromBitCounter == 9 )
       {
-         m_eepromBitCounter = 0;
-         m_eepromState++;
+         STATE()->m_eepromBitCounter = 0;
+         STATE()->m_eepromState++;
          data = 0x00;
       }
       break;
    case 3:
       // Command execution
-      if ( m_eepromBitCounter == 9 )
+      if ( STATE()->m_eepromBitCounter == 9 )
       {
-         m_eepromBitCounter = 0;
+         STATE()->m_eepromBitCounter = 0;
          data = 0x00;
       }
 
       // Read
-      if ( m_mapper == 16 )
+      if ( CROM::STATE()->m_mapper == 16 )
       {
-         data = CROM::SRAMVIRT(0x6000+m_eepromAddr);
+         data = CROM::SRAMVIRT(0x6000+STATE()->m_eepromAddr);
       }
       else
       {
-         data = CROM::SRAMVIRT(0x6000+(m_eepromAddr>>1));
+         data = CROM::SRAMVIRT(0x6000+(STATE()->m_eepromAddr>>1));
       }
-      data >>= m_eepromBitCounter;
+      data >>= STATE()->m_eepromBitCounter;
       data &= 0x01;
       data <<= 4;
 
-      m_eepromBitCounter++;
+      STATE()->m_eepromBitCounter++;
       break;
    }
 
@@ -289,53 +279,53 @@ void CROMMapper016::HMAPPER ( uint32_t addr, uint8_t data )
    {
    case 0x0000:
       reg = 0;
-      m_reg[0] = data;
-      m_pCHRmemory[0] = m_CHRmemory[data];
+      STATE()->m_reg[0] = data;
+      CROM::STATE()->m_pCHRmemory[0] = CROM::STATE()->m_CHRmemory[data];
       break;
    case 0x0001:
       reg = 1;
-      m_reg[1] = data;
-      m_pCHRmemory[1] = m_CHRmemory[data];
+      STATE()->m_reg[1] = data;
+      CROM::STATE()->m_pCHRmemory[1] = CROM::STATE()->m_CHRmemory[data];
       break;
    case 0x0002:
       reg = 2;
-      m_reg[2] = data;
-      m_pCHRmemory[2] = m_CHRmemory[data];
+      STATE()->m_reg[2] = data;
+      CROM::STATE()->m_pCHRmemory[2] = CROM::STATE()->m_CHRmemory[data];
       break;
    case 0x0003:
       reg = 3;
-      m_reg[3] = data;
-      m_pCHRmemory[3] = m_CHRmemory[data];
+      STATE()->m_reg[3] = data;
+      CROM::STATE()->m_pCHRmemory[3] = CROM::STATE()->m_CHRmemory[data];
       break;
    case 0x0004:
       reg = 4;
-      m_reg[4] = data;
-      m_pCHRmemory[4] = m_CHRmemory[data];
+      STATE()->m_reg[4] = data;
+      CROM::STATE()->m_pCHRmemory[4] = CROM::STATE()->m_CHRmemory[data];
       break;
    case 0x0005:
       reg = 5;
-      m_reg[5] = data;
-      m_pCHRmemory[5] = m_CHRmemory[data];
+      STATE()->m_reg[5] = data;
+      CROM::STATE()->m_pCHRmemory[5] = CROM::STATE()->m_CHRmemory[data];
       break;
    case 0x0006:
       reg = 6;
-      m_reg[6] = data;
-      m_pCHRmemory[6] = m_CHRmemory[data];
+      STATE()->m_reg[6] = data;
+      CROM::STATE()->m_pCHRmemory[6] = CROM::STATE()->m_CHRmemory[data];
       break;
    case 0x0007:
       reg = 7;
-      m_reg[7] = data;
-      m_pCHRmemory[7] = m_CHRmemory[data];
+      STATE()->m_reg[7] = data;
+      CROM::STATE()->m_pCHRmemory[7] = CROM::STATE()->m_CHRmemory[data];
       break;
    case 0x0008:
       reg = 8;
-      m_reg[8] = data;
-      m_pPRGROMmemory[0] = m_PRGROMmemory[((data<<1)%m_numPrgBanks)+0];
-      m_pPRGROMmemory[1] = m_PRGROMmemory[((data<<1)%m_numPrgBanks)+1];
+      STATE()->m_reg[8] = data;
+      CROM::STATE()->m_pPRGROMmemory[0] = CROM::STATE()->m_PRGROMmemory[((data<<1)%CROM::STATE()->m_numPrgBanks)+0];
+      CROM::STATE()->m_pPRGROMmemory[1] = CROM::STATE()->m_PRGROMmemory[((data<<1)%CROM::STATE()->m_numPrgBanks)+1];
       break;
    case 0x0009:
       reg = 9;
-      m_reg[9] = data;
+      STATE()->m_reg[9] = data;
       switch ( data&0x03 )
       {
       case 0:
@@ -354,129 +344,129 @@ void CROMMapper016::HMAPPER ( uint32_t addr, uint8_t data )
       break;
    case 0x000A:
       reg = 10;
-      m_reg[10] = data;
-      m_irqEnabled = data&0x01;
-      m_irqAsserted = false;
+      STATE()->m_reg[10] = data;
+      STATE()->m_irqEnabled = data&0x01;
+      STATE()->m_irqAsserted = false;
       C6502::RELEASEIRQ(eNESSource_Mapper);
       break;
    case 0x000B:
       reg = 11;
-      m_reg[11] = data;
-      m_irqCounter &= 0xFF00;
-      m_irqCounter |= data;
+      STATE()->m_reg[11] = data;
+      STATE()->m_irqCounter &= 0xFF00;
+      STATE()->m_irqCounter |= data;
       break;
    case 0x000C:
       reg = 12;
-      m_reg[12] = data;
-      m_irqCounter &= 0x00FF;
-      m_irqCounter |= (data<<8);
+      STATE()->m_reg[12] = data;
+      STATE()->m_irqCounter &= 0x00FF;
+      STATE()->m_irqCounter |= (data<<8);
       break;
    case 0x000D:
       reg = 13;
       // Check for START/STOP
-      if ( (m_reg[13]&0x20) && (data&0x20) )
+      if ( (STATE()->m_reg[13]&0x20) && (data&0x20) )
       {
          // Clock is high, did data go low?  If so, START
-         if ( (m_reg[13]&0x40) && (!(data&0x40)) )
+         if ( (STATE()->m_reg[13]&0x40) && (!(data&0x40)) )
          {
             // EEPROM in mapper 159 skips address phase
-            if ( m_mapper == 16 )
+            if ( CROM::STATE()->m_mapper == 16 )
             {
-               m_eepromState = 1;
+               STATE()->m_eepromState = 1;
             }
             else
             {
-               m_eepromState = 2;
+               STATE()->m_eepromState = 2;
             }
-            m_eepromBitCounter = 0;
+            STATE()->m_eepromBitCounter = 0;
          }
          // Clock is high, did data go high?  If so, STOP
-         if ( (!(m_reg[13]&0x40)) && (data&0x40) )
+         if ( (!(STATE()->m_reg[13]&0x40)) && (data&0x40) )
          {
-            m_eepromState = 0;
+            STATE()->m_eepromState = 0;
          }
       }
 
       // Did clock transition?
-      if ( (!(m_reg[13]&0x20)) && (data&0x20) )
+      if ( (!(STATE()->m_reg[13]&0x20)) && (data&0x20) )
       {
          // positive edge
-         switch ( m_eepromState )
+         switch ( STATE()->m_eepromState )
          {
          case 1:
             // Accepting command
-            if ( m_eepromBitCounter < 8 )
+            if ( STATE()->m_eepromBitCounter < 8 )
             {
-               m_eepromCmd <<= 1;
-               m_eepromCmd &= 0xFF;
-               m_eepromCmd |= ((data&0x40)>>6);
+               STATE()->m_eepromCmd <<= 1;
+               STATE()->m_eepromCmd &= 0xFF;
+               STATE()->m_eepromCmd |= ((data&0x40)>>6);
             }
-            m_eepromBitCounter++;
+            STATE()->m_eepromBitCounter++;
             break;
          case 2:
             // Accepting address
-            if ( m_eepromBitCounter < 8 )
+            if ( STATE()->m_eepromBitCounter < 8 )
             {
-               m_eepromAddr <<= 1;
-               m_eepromAddr &= 0xFF;
-               m_eepromAddr |= ((data&0x40)>>6);
+               STATE()->m_eepromAddr <<= 1;
+               STATE()->m_eepromAddr &= 0xFF;
+               STATE()->m_eepromAddr |= ((data&0x40)>>6);
             }
-            m_eepromBitCounter++;
+            STATE()->m_eepromBitCounter++;
             break;
          case 3:
             // Command execution
-            if ( m_mapper == 16 )
+            if ( CROM::STATE()->m_mapper == 16 )
             {
-               m_eepromRWBit = m_eepromCmd&0x01;
+               STATE()->m_eepromRWBit = STATE()->m_eepromCmd&0x01;
             }
             else
             {
-               m_eepromRWBit = m_eepromAddr&0x01;
+               STATE()->m_eepromRWBit = STATE()->m_eepromAddr&0x01;
             }
-            switch ( m_eepromRWBit )
+            switch ( STATE()->m_eepromRWBit )
             {
             case 0:
                // Write
-               m_eepromDataBuf <<= 1;
-               m_eepromDataBuf |= ((data&0x40)>>6);
+               STATE()->m_eepromDataBuf <<= 1;
+               STATE()->m_eepromDataBuf |= ((data&0x40)>>6);
 
-               m_eepromBitCounter++;
-               if ( m_eepromBitCounter == 8 )
+               STATE()->m_eepromBitCounter++;
+               if ( STATE()->m_eepromBitCounter == 8 )
                {
-                  if ( m_mapper == 16 )
+                  if ( CROM::STATE()->m_mapper == 16 )
                   {
-                     CROM::SRAMVIRT(0x6000+m_eepromAddr,m_eepromDataBuf);
+                     CROM::SRAMVIRT(0x6000+STATE()->m_eepromAddr,STATE()->m_eepromDataBuf);
                   }
                   else
                   {
-                     CROM::SRAMVIRT(0x6000+(m_eepromAddr>>1),m_eepromDataBuf);
+                     CROM::SRAMVIRT(0x6000+(STATE()->m_eepromAddr>>1),STATE()->m_eepromDataBuf);
                   }
                   CNES::FORCEBREAKPOINT();
-                  if ( m_mapper == 16 )
+                  if ( CROM::STATE()->m_mapper == 16 )
                   {
-                     m_eepromAddr++;
-                     m_eepromAddr %= 0x100;
+                     STATE()->m_eepromAddr++;
+                     STATE()->m_eepromAddr %= 0x100;
                   }
                   else
                   {
-                     m_eepromAddr += 2;
-                     m_eepromAddr %= 0x100;
+                     STATE()->m_eepromAddr += 2;
+                     STATE()->m_eepromAddr %= 0x100;
                   }
                }
                break;
             case 1:
-               if ( m_eepromBitCounter == 8 )
+               if ( STATE()->m_eepromBitCounter == 8 )
                {
-                  m_eepromBitCounter++;
-                  if ( m_mapper == 16 )
+                  STATE()->m_eepromBitCounter++;
+                  if ( CROM::STATE()->m_mapper == 16 )
                   {
-                     m_eepromAddr++;
-                     m_eepromAddr %= 0x100;
+                     STATE()->m_eepromAddr++;
+                     STATE()->m_eepromAddr %= 0x100;
                   }
                   else
                   {
-                     m_eepromAddr += 2;
-                     m_eepromAddr %= 0x100;
+                     STATE()->m_eepromAddr += 2;
+                     STATE()->m_eepromAddr %= 0x100;
                   }
                }
             }
@@ -485,7 +475,7 @@ void CROMMapper016::HMAPPER ( uint32_t addr, uint8_t data )
       }
 
       // NOTE: m_reg[13] is used to keep track of the previous pin states!
-      m_reg[13] = data;
+      STATE()->m_reg[13] = data;
       break;
    }
 
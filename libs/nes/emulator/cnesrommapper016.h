@@ -21,48 +21,53 @@ public:
    // Note: called directly!
    static uint32_t IRQENABLED ( void )
    {
-      return m_irqEnabled;
+      return STATE()->m_irqEnabled;
    }
    static uint32_t IRQCOUNTER ( void )
    {
-      return m_irqCounter;
+      return STATE()->m_irqCounter;
    }
    static uint32_t IRQASSERTED ( void )
    {
-      return m_irqAsserted;
+      return STATE()->m_irqAsserted;
    }
    static uint32_t EEPROMSTATE ( void )
    {
-      return m_eepromState;
+      return STATE()->m_eepromState;
    }
    static uint32_t EEPROMBITCOUNTER ( void )
    {
-      return m_eepromBitCounter;
+      return STATE()->m_eepromBitCounter;
    }
    static uint32_t EEPROMCMD ( void )
    {
-      return m_eepromCmd;
+      return STATE()->m_eepromCmd;
    }
    static uint32_t EEPROMADDR ( void )
    {
-      return m_eepromAddr;
+      return STATE()->m_eepromAddr;
    }
    static uint32_t EEPROMDATABUF ( void )
    {
-      return m_eepromDataBuf;
+      return STATE()->m_eepromDataBuf;
    }
 
 protected:
-   static uint8_t  m_reg [ 14 ];
-   static uint16_t m_irqCounter;
-   static bool     m_irqEnabled;
-   static bool     m_irqAsserted;
-   static uint8_t  m_eepromBitCounter;
-   static uint8_t  m_eepromState;
-   static uint8_t  m_eepromCmd;
-   static uint8_t  m_eepromAddr;
-   static uint8_t  m_eepromDataBuf;
-   static uint8_t  m_eepromRWBit;
+   friend struct NESContext;
+   struct State
+   {
+      uint8_t  m_reg [ 14 ] = { 0x00, };
+      uint16_t m_irqCounter = 0;
+      bool     m_irqEnabled = false;
+      bool     m_irqAsserted = false;
+      uint8_t  m_eepromBitCounter = 0;
+      uint8_t  m_eepromState = 0;
+      uint8_t  m_eepromCmd = 0;
+      uint8_t  m_eepromAddr = 0;
+      uint8_t  m_eepromDataBuf = 0;
+      uint8_t  m_eepromRWBit = 0;
+   };
+   static inline State* STATE ();
    // We'll use the SRAM interface in CROM object to store
    // the EEPROM data so that it gets saved using the regular
    // save-state mechanics.
@@ -19,6 +19,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 018 Registers
 static CBitfieldData* tbl8000Bitfields [] =
@@ -129,13 +130,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,29,29,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper018::m_reg [] = { 0x00, };
-uint8_t  CROMMapper018::m_prg [] = { 0x00, };
-uint8_t  CROMMapper018::m_chr [] = { 0x00, };
-uint16_t CROMMapper018::m_irqReload = 0;
-uint16_t CROMMapper018::m_irqCounter = 0;
-bool     CROMMapper018::m_irqEnabled = false;
-
 CROMMapper018::CROMMapper018()
 {
 }
@@ -148,20 +142,20 @@ void CROMMapper018::RESET ( bool soft )
 {
    int32_t idx;
 
-   m_mapper = 18;
+   CROM::STATE()->m_mapper = 18;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_irqReload = 0;
-   m_irqCounter = 0;
-   m_irqEnabled = false;
+   STATE()->m_irqReload = 0;
+   STATE()->m_irqCounter = 0;
+   STATE()->m_irqEnabled = false;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
@@ -172,9 +166,9 @@ void CROMMapper018::SYNCCPU ( void )
    uint16_t counter;
    uint8_t  size;
 
-   size = ((m_reg[27]&0x0E)>>1);
+   size = ((STATE()->m_reg[27]&0x0E)>>1);
 
-   if ( m_irqEnabled )
+   if ( STATE()->m_irqEnabled )
    {
       // Get relevant counter bits.
       if ( size == 0 )
@@ -198,12 +192,12 @@ void CROMMapper018::SYNCCPU ( void )
          counterMask = 0x000F;
       }
 
-      counter = m_irqCounter&counterMask;
+      counter = STATE()->m_irqCounter&counterMask;
       counter--;
-      m_irqCounter &= (~counterMask);
-      m_irqCounter |= (counter&counterMask);
+      STATE()->m_irqCounter &= (~counterMask);
+      STATE()->m_irqCounter |= (counter&counterMask);
 
-      if ( (m_irqCounter&counterMask) == counterMask )
+      if ( (STATE()->m_irqCounter&counterMask) == counterMask )
       {
          C6502::ASSERTIRQ(eNESSource_Mapper);
 
@@ -221,91 +215,91 @@ uint32_t CROMMapper018::DEBUGINFO ( uint32_t addr )
    switch ( addr )
    {
    case 0x8000:
-      return m_reg[0];
+      return STATE()->m_reg[0];
       break;
    case 0x8001:
-      return m_reg[1];
+      return STATE()->m_reg[1];
       break;
    case 0x8002:
-      return m_reg[2];
+      return STATE()->m_reg[2];
       break;
    case 0x8003:
-      return m_reg[3];
+      return STATE()->m_reg[3];
       break;
    case 0x9000:
-      return m_reg[4];
+      return STATE()->m_reg[4];
       break;
    case 0x9001:
-      return m_reg[5];
+      return STATE()->m_reg[5];
       break;
    case 0xA000:
-      return m_reg[6];
+      return STATE()->m_reg[6];
       break;
    case 0xA001:
-      return m_reg[7];
+      return STATE()->m_reg[7];
       break;
    case 0xA002:
-      return m_reg[8];
+      return STATE()->m_reg[8];
       break;
    case 0xA003:
-      return m_reg[9];
+      return STATE()->m_reg[9];
       break;
    case 0xB000:
-      return m_reg[10];
+      return STATE()->m_reg[10];
       break;
    case 0xB001:
-      return m_reg[11];
+      return STATE()->m_reg[11];
       break;
    case 0xB002:
-      return m_reg[12];
+      return STATE()->m_reg[12];
       break;
    case 0xB003:
-      return m_reg[13];
+      return STATE()->m_reg[13];
       break;
    case 0xC000:
-      return m_reg[14];
+      return STATE()->m_reg[14];
       break;
    case 0xC001:
-      return m_reg[15];
+      return STATE()->m_reg[15];
       break;
    case 0xC002:
-      return m_reg[16];
+      return STATE()->m_reg[16];
       break;
    case 0xC003:
-      return m_reg[17];
+      return STATE()->m_reg[17];
       break;
    case 0xD000:
-      return m_reg[18];
+      return STATE()->m_reg[18];
       break;
    case 0xD001:
-      return m_reg[19];
+      return STATE()->m_reg[19];
       break;
    case 0xD002:
-      return m_reg[20];
+      return STATE()->m_reg[20];
       break;
    case 0xD003:
-      return m_reg[21];
+      return STATE()->m_reg[21];
       break;
    case 0xE000:
-      return m_reg[22];
+      return STATE()->m_reg[22];
       break;
    case 0xE001:
-      return m_reg[23];
+      return STATE()->m_reg[23];
       break;
    case 0xE002:
-      return m_reg[24];
+      return STATE()->m_reg[24];
       break;
    case 0xE003:
-      return m_reg[25];
+      return STATE()->m_reg[25];
       break;
    case 0xF000:
-      return m_reg[26];
+      return STATE()->m_reg[26];
       break;
    case 0xF001:
-      return m_reg[27];
+      return STATE()->m_reg[27];
       break;
    case 0xF002:
-      return m_reg[28];
+      return STATE()->m_reg[28];
       break;
    }
 }
@@ -318,193 +312,193 @@ void CROMMapper018::HMAPPER ( uint32_t addr, uint8_t data )
    {
    case 0x8000:
       reg = 0;
-      m_reg[0] = data;
-      m_prg[0] &= 0xF0;
-      m_prg[0] |= (data&0x0F);
-      m_pPRGROMmemory[0] = m_PRGROMmemory[m_prg[0]%m_numPrgBanks];
+      STATE()->m_reg[0] = data;
+      STATE()->m_prg[0] &= 0xF0;
+      STATE()->m_prg[0] |= (data&0x0F);
+      CROM::STATE()->m_pPRGROMmemory[0] = CROM::STATE()->m_PRGROMmemory[STATE()->m_prg[0]%CROM::STATE()->m_numPrgBanks];
    case 0x8001:
       reg = 1;
-      m_reg[1] = data;
-      m_prg[0] &= 0x0F;
-      m_prg[0] |= (data<<4);
-      m_pPRGROMmemory[0] = m_PRGROMmemory[m_prg[0]%m_numPrgBanks];
+      STATE()->m_reg[1] = data;
+      STATE()->m_prg[0] &= 0x0F;
+      STATE()->m_prg[0] |= (data<<4);
+      CROM::STATE()->m_pPRGROMmemory[0] = CROM::STATE()->m_PRGROMmemory[STATE()->m_prg[0]%CROM::STATE()->m_numPrgBanks];
    case 0x8002:
       reg = 2;
-      m_reg[2] = data;
-      m_prg[1] &= 0xF0;
-      m_prg[1] |= (data&0x0F);
-      m_pPRGROMmemory[1] = m_PRGROMmemory[m_prg[1]%m_numPrgBanks];
+      STATE()->m_reg[2] = data;
+      STATE()->m_prg[1] &= 0xF0;
+      STATE()->m_prg[1] |= (data&0x0F);
+      CROM::STATE()->m_pPRGROMmemory[1] = CROM::STATE()->m_PRGROMmemory[STATE()->m_prg[1]%CROM::STATE()->m_numPrgBanks];
    case 0x8003:
       reg = 3;
-      m_reg[3] = data;
-      m_prg[1] &= 0x0F;
-      m_prg[1] |= (data<<4);
-      m_pPRGROMmemory[1] = m_PRGROMmemory[m_prg[1]%m_numPrgBanks];
+      STATE()->m_reg[3] = data;
+      STATE()->m_prg[1] &= 0x0F;
+      STATE()->m_prg[1] |= (data<<4);
+      CROM::STATE()->m_pPRGROMmemory[1] = CROM::STATE()->m_PRGROMmemory[STATE()->m_prg[1]%CROM::STATE()->m_numPrgBanks];
       break;
    case 0x9000:
       reg = 4;
-      m_reg[4] = data;
-      m_prg[2] &= 0xF0;
-      m_prg[2] |= (data&0x0F);
-      m_pPRGROMmemory[2] = m_PRGROMmemory[m_prg[2]%m_numPrgBanks];
+      STATE()->m_reg[4] = data;
+      STATE()->m_prg[2] &= 0xF0;
+      STATE()->m_prg[2] |= (data&0x0F);
+      CROM::STATE()->m_pPRGROMmemory[2] = CROM::STATE()->m_PRGROMmemory[STATE()->m_prg[2]%CROM::STATE()->m_numPrgBanks];
    case 0x9001:
       reg = 5;
-      m_reg[5] = data;
-      m_prg[2] &= 0x0F;
-      m_prg[2] |= (data<<4);
-      m_pPRGROMmemory[2] = m_PRGROMmemory[m_prg[2]%m_numPrgBanks];
+      STATE()->m_reg[5] = data;
+      STATE()->m_prg[2] &= 0x0F;
+      STATE()->m_prg[2] |= (data<<4);
+      CROM::STATE()->m_pPRGROMmemory[2] = CROM::STATE()->m_PRGROMmemory[STATE()->m_prg[2]%CROM::STATE()->m_numPrgBanks];
       break;
    case 0xA000:
       reg = 6;
-      m_reg[6] = data;
-      m_chr[0] &= 0xF0;
-      m_chr[0] |= (data&0x0F);
-      m_pCHRmemory[0] = m_CHRmemory[m_chr[0]];
+      STATE()->m_reg[6] = data;
+      STATE()->m_chr[0] &= 0xF0;
+      STATE()->m_chr[0] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[0] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[0]];
       break;
    case 0xA001:
       reg = 7;
-      m_reg[7] = data;
-      m_chr[0] &= 0x0F;
-      m_chr[0] |= (data<<4);
-      m_pCHRmemory[0] = m_CHRmemory[m_chr[0]];
+      STATE()->m_reg[7] = data;
+      STATE()->m_chr[0] &= 0x0F;
+      STATE()->m_chr[0] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[0] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[0]];
       break;
    case 0xA002:
       reg = 8;
-      m_reg[8] = data;
-      m_chr[1] &= 0xF0;
-      m_chr[1] |= (data&0x0F);
-      m_pCHRmemory[1] = m_CHRmemory[m_chr[1]];
+      STATE()->m_reg[8] = data;
+      STATE()->m_chr[1] &= 0xF0;
+      STATE()->m_chr[1] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[1] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[1]];
       break;
    case 0xA003:
       reg = 9;
-      m_reg[9] = data;
-      m_chr[1] &= 0x0F;
-      m_chr[1] |= (data<<4);
-      m_pCHRmemory[1] = m_CHRmemory[m_chr[1]];
+      STATE()->m_reg[9] = data;
+      STATE()->m_chr[1] &= 0x0F;
+      STATE()->m_chr[1] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[1] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[1]];
       break;
    case 0xB000:
       reg = 10;
-      m_reg[10] = data;
-      m_chr[2] &= 0xF0;
-      m_chr[2] |= (data&0x0F);
-      m_pCHRmemory[2] = m_CHRmemory[m_chr[2]];
+      STATE()->m_reg[10] = data;
+      STATE()->m_chr[2] &= 0xF0;
+      STATE()->m_chr[2] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[2] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[2]];
       break;
    case 0xB001:
       reg = 11;
-      m_reg[11] = data;
-      m_chr[2] &= 0x0F;
-      m_chr[2] |= (data<<4);
-      m_pCHRmemory[2] = m_CHRmemory[m_chr[2]];
+      STATE()->m_reg[11] = data;
+      STATE()->m_chr[2] &= 0x0F;
+      STATE()->m_chr[2] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[2] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[2]];
       break;
    case 0xB002:
       reg = 12;
-      m_reg[12] = data;
-      m_chr[3] &= 0xF0;
-      m_chr[3] |= (data&0x0F);
-      m_pCHRmemory[3] = m_CHRmemory[m_chr[3]];
+      STATE()->m_reg[12] = data;
+      STATE()->m_chr[3] &= 0xF0;
+      STATE()->m_chr[3] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[3] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[3]];
       break;
    case 0xB003:
       reg = 13;
-      m_reg[13] = data;
-      m_chr[3] &= 0x0F;
-      m_chr[3] |= (data<<4);
-      m_pCHRmemory[3] = m_CHRmemory[m_chr[3]];
+      STATE()->m_reg[13] = data;
+      STATE()->m_chr[3] &= 0x0F;
+      STATE()->m_chr[3] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[3] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[3]];
       break;
    case 0xC000:
       reg = 14;
-      m_reg[14] = data;
-      m_chr[4] &= 0xF0;
-      m_chr[4] |= (data&0x0F);
-      m_pCHRmemory[4] = m_CHRmemory[m_chr[4]];
+      STATE()->m_reg[14] = data;
+      STATE()->m_chr[4] &= 0xF0;
+      STATE()->m_chr[4] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[4] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[4]];
       break;
    case 0xC001:
       reg = 15;
-      m_reg[15] = data;
-      m_chr[4] &= 0x0F;
-      m_chr[4] |= (data<<4);
-      m_pCHRmemory[4] = m_CHRmemory[m_chr[4]];
+      STATE()->m_reg[15] = data;
+      STATE()->m_chr[4] &= 0x0F;
+      STATE()->m_chr[4] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[4] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[4]];
       break;
    case 0xC002:
       reg = 16;
-      m_reg[16] = data;
-      m_chr[5] &= 0xF0;
-      m_chr[5] |= (data&0x0F);
-      m_pCHRmemory[5] = m_CHRmemory[m_chr[5]];
+      STATE()->m_reg[16] = data;
+      STATE()->m_chr[5] &= 0xF0;
+      STATE()->m_chr[5] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[5] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[5]];
       break;
    case 0xC003:
       reg = 17;
-      m_reg[17] = data;
-      m_chr[5] &= 0x0F;
-      m_chr[5] |= (data<<4);
-      m_pCHRmemory[5] = m_CHRmemory[m_chr[5]];
+      STATE()->m_reg[17] = data;
+      STATE()->m_chr[5] &= 0x0F;
+      STATE()->m_chr[5] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[5] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[5]];
       break;
    case 0xD000:
       reg = 18;
-      m_reg[18] = data;
-      m_chr[6] &= 0xF0;
-      m_chr[6] |= (data&0x0F);
-      m_pCHRmemory[6] = m_CHRmemory[m_chr[6]];
+      STATE()->m_reg[18] = data;
+      STATE()->m_chr[6] &= 0xF0;
+      STATE()->m_chr[6] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[6] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[6]];
       break;
    case 0xD001:
       reg = 19;
-      m_reg[19] = data;
-      m_chr[6] &= 0x0F;
-      m_chr[6] |= (data<<4);
-      m_pCHRmemory[6] = m_CHRmemory[m_chr[6]];
+      STATE()->m_reg[19] = data;
+      STATE()->m_chr[6] &= 0x0F;
+      STATE()->m_chr[6] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[6] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[6]];
       break;
    case 0xD002:
       reg = 20;
-      m_reg[20] = data;
-      m_chr[7] &= 0xF0;
-      m_chr[7] |= (data&0x0F);
-      m_pCHRmemory[7] = m_CHRmemory[m_chr[7]];
+      STATE()->m_reg[20] = data;
+      STATE()->m_chr[7] &= 0xF0;
+      STATE()->m_chr[7] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[7] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[7]];
       break;
    case 0xD003:
       reg = 21;
-      m_reg[21] = data;
-      m_chr[7] &= 0x0F;
-      m_chr[7] |= (data<<4);
-      m_pCHRmemory[7] = m_CHRmemory[m_chr[7]];
+      STATE()->m_reg[21] = data;
+      STATE()->m_chr[7] &= 0x0F;
+      STATE()->m_chr[7] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[7] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[7]];
       break;
    case 0xE000:
       reg = 22;
-      m_reg[22] = data;
-      m_irqReload &= 0xFFF0;
-      m_irqReload |= (data&0x0F);
+      STATE()->m_reg[22] = data;
+      STATE()->m_irqReload &= 0xFFF0;
+      STATE()->m_irqReload |= (data&0x0F);
       break;
    case 0xE001:
       reg = 23;
-      m_reg[23] = data;
-      m_irqReload &= 0xFF0F;
-      m_irqReload |= ((data&0x0F)<<4);
+      STATE()->m_reg[23] = data;
+      STATE()->m_irqReload &= 0xFF0F;
+      STATE()->m_irqReload |= ((data&0x0F)<<4);
       break;
    case 0xE002:
       reg = 24;
-      m_reg[24] = data;
-      m_irqReload &= 0xF0FF;
-      m_irqReload |= ((data&0x0F)<<8);
+      STATE()->m_reg[24] = data;
+      STATE()->m_irqReload &= 0xF0FF;
+      STATE()->m_irqReload |= ((data&0x0F)<<8);
       break;
    case 0xE003:
       reg = 25;
-      m_reg[25] = data;
-      m_irqReload &= 0x0FFF;
-      m_irqReload |= ((data&0x0F)<<12);
+      STATE()->m_reg[25] = data;
+      STATE()->m_irqReload &= 0x0FFF;
+      STATE()->m_irqReload |= ((data&0x0F)<<12);
       break;
    case 0xF000:
       reg = 26;
-      m_reg[26] = data;
-      m_irqCounter = m_irqReload;
+      STATE()->m_reg[26] = data;
+      STATE()->m_irqCounter = STATE()->m_irqReload;
       C6502::RELEASEIRQ(eNESSource_Mapper);
       break;
    case 0xF001:
       reg = 27;
-      m_reg[27] = data;
-      m_irqEnabled = data&0x01;
+      STATE()->m_reg[27] = data;
+      STATE()->m_irqEnabled = data&0x01;
       C6502::RELEASEIRQ(eNESSource_Mapper);
       break;
    case 0xF002:
       reg = 28;
-      m_reg[28] = data;
+      STATE()->m_reg[28] = data;
       switch ( data&0x03 )
       {
       case 0:
@@ -15,12 +15,17 @@ public:
    static uint32_t DEBUGINFO ( uint32_t addr );
 
 protected:
-   static uint8_t  m_reg [ 29 ];
-   static uint8_t  m_prg [ 3 ];
-   static uint8_t  m_chr [ 8 ];
-   static uint16_t m_irqReload;
-   static uint16_t m_irqCounter;
-   static bool     m_irqEnabled;
+   friend struct NESContext;
+   struct State
+   {
+      uint8_t  m_reg [ 29 ] = { 0x00, };
+      uint8_t  m_prg [ 3 ] = { 0x00, };
+      uint8_t  m_chr [ 8 ] = { 0x00, };
+      uint16_t m_irqReload = 0;
+      uint16_t m_irqCounter = 0;
+      bool     m_irqEnabled = false;
+   };
+   static inline State* STATE ();
 };
 
 #endif
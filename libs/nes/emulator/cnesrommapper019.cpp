@@ -19,6 +19,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 019 Registers
 static CBitfieldData* tbl4800Bitfields [] =
@@ -104,15 +105,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,19,19,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper019::m_reg [] = { 0x00, };
-uint8_t  CROMMapper019::m_chr [];
-uint16_t CROMMapper019::m_irqCounter = 0;
-bool     CROMMapper019::m_irqEnabled = false;
-N106WaveChannel CROMMapper019::m_wave[8];
-uint8_t  CROMMapper019::m_soundRAM [];
-uint8_t  CROMMapper019::m_soundRAMAddr;
-uint8_t  CROMMapper019::m_soundChansEnabled = 0;
-
 CROMMapper019::CROMMapper019()
 {
 }
@@ -125,27 +117,27 @@ void CROMMapper019::RESET ( bool soft )
 {
    int32_t idx;
 
-   m_mapper = 19;
+   CROM::STATE()->m_mapper = 19;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
    for ( idx = 0; idx < 8; idx++ )
    {
-      m_wave[idx].SOUNDRAM(m_soundRAM);
-      m_wave[idx].RESET();
+      STATE()->m_wave[idx].SOUNDRAM(STATE()->m_soundRAM);
+      STATE()->m_wave[idx].RESET();
    }
-   m_soundRAMAddr = 0;
-   m_soundChansEnabled = 0;
+   STATE()->m_soundRAMAddr = 0;
+   STATE()->m_soundChansEnabled = 0;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_irqCounter = 0;
-   m_irqEnabled = false;
+   STATE()->m_irqCounter = 0;
+   STATE()->m_irqEnabled = false;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
@@ -156,12 +148,12 @@ void CROMMapper019::SYNCCPU ( void )
 
    for ( idx = 0; idx < 8; idx++ )
    {
-      m_wave[idx].TIMERTICK(m_soundChansEnabled);
+      STATE()->m_wave[idx].TIMERTICK(STATE()->m_soundChansEnabled);
    }
 
-   if ( m_irqEnabled )
+   if ( STATE()->m_irqEnabled )
    {
-      if ( m_irqCounter == 0x7FFF )
+      if ( STATE()->m_irqCounter == 0x7FFF )
       {
          C6502::ASSERTIRQ(eNESSource_Mapper);
 
@@ -173,7 +165,7 @@ void CROMMapper019::SYNCCPU ( void )
       }
       else
       {
-         m_irqCounter++;
+         STATE()->m_irqCounter++;
       }
    }
 }
@@ -183,61 +175,61 @@ uint32_t CROMMapper019::DEBUGINFO ( uint32_t addr )
    switch ( addr )
    {
    case 0x4800:
-      return m_reg[0];
+      return STATE()->m_reg[0];
       break;
    case 0x5000:
-      return m_reg[1];
+      return STATE()->m_reg[1];
       break;
    case 0x5800:
-      return m_reg[2];
+      return STATE()->m_reg[2];
       break;
    case 0x8000:
-      return m_reg[3];
+      return STATE()->m_reg[3];
       break;
    case 0x8800:
-      return m_reg[4];
+      return STATE()->m_reg[4];
       break;
    case 0x9000:
-      return m_reg[5];
+      return STATE()->m_reg[5];
       break;
    case 0x9800:
-      return m_reg[6];
+      return STATE()->m_reg[6];
       break;
    case 0xA000:
-      return m_reg[7];
+      return STATE()->m_reg[7];
       break;
    case 0xA800:
-      return m_reg[8];
+      return STATE()->m_reg[8];
       break;
    case 0xB000:
-      return m_reg[9];
+      return STATE()->m_reg[9];
       break;
    case 0xB800:
-      return m_reg[10];
+      return STATE()->m_reg[10];
       break;
    case 0xC000:
-      return m_reg[11];
+      return STATE()->m_reg[11];
       break;
    case 0xC800:
-      return m_reg[12];
+      return STATE()->m_reg[12];
       break;
    case 0xD000:
-      return m_reg[13];
+      return STATE()->m_reg[13];
       break;
    case 0xD800:
-      return m_reg[14];
+      return STATE()->m_reg[14];
       break;
    case 0xE000:
-      return m_reg[15];
+      return STATE()->m_reg[15];
       break;
    case 0xE800:
-      return m_reg[16];
+      return STATE()->m_reg[16];
       break;
    case 0xF000:
-      return m_reg[17];
+      return STATE()->m_reg[17];
       break;
    case 0xF800:
-      return m_reg[18];
+      return STATE()->m_reg[18];
       break;
    }
 }
@@ -251,21 +243,21 @@ uint32_t CROMMapper019::LMAPPER ( uint32_t addr )
    {
    case 0x4800:
       reg = 0;
-      data = m_soundRAM[m_soundRAMAddr];
-      if ( m_reg[18]&0x80 )
+      data = STATE()->m_soundRAM[STATE()->m_soundRAMAddr];
+      if ( STATE()->m_reg[18]&0x80 )
       {
-         m_soundRAMAddr++;
-         m_soundRAMAddr &= 0x7F;
+         STATE()->m_soundRAMAddr++;
+         STATE()->m_soundRAMAddr &= 0x7F;
       }
       break;
    case 0x5000:
       reg = 1;
-      data = m_reg[1];
+      data = STATE()->m_reg[1];
       C6502::RELEASEIRQ(eNESSource_Mapper);
       break;
    case 0x5800:
       reg = 2;
-      data = m_reg[2];
+      data = STATE()->m_reg[2];
       C6502::RELEASEIRQ(eNESSource_Mapper);
       break;
    }
@@ -287,39 +279,39 @@ void CROMMapper019::LMAPPER ( uint32_t addr, uint8_t data )
    {
    case 0x4800:
       reg = 0;
-      m_reg[0] = data;
-      m_soundRAM[m_soundRAMAddr] = data;
-      if ( m_soundRAMAddr >= 0x40 )
+      STATE()->m_reg[0] = data;
+      STATE()->m_soundRAM[STATE()->m_soundRAMAddr] = data;
+      if ( STATE()->m_soundRAMAddr >= 0x40 )
       {
-         m_wave[(m_soundRAMAddr-0x40)/0x8].REG(m_soundRAMAddr&0x7,data);
+         STATE()->m_wave[(STATE()->m_soundRAMAddr-0x40)/0x8].REG(STATE()->m_soundRAMAddr&0x7,data);
       }
 
       // Special case "register" 0x7F for channel enabled count.
-      if ( m_soundRAMAddr == 0x7F )
+      if ( STATE()->m_soundRAMAddr == 0x7F )
       {
-         m_soundChansEnabled = ((data>>4)&0x7);
+         STATE()->m_soundChansEnabled = ((data>>4)&0x7);
       }
 
-      if ( m_reg[18]&0x80 )
+      if ( STATE()->m_reg[18]&0x80 )
       {
-         m_soundRAMAddr++;
-         m_soundRAMAddr &= 0x7F;
+         STATE()->m_soundRAMAddr++;
+         STATE()->m_soundRAMAddr &= 0x7F;
       }
       break;
    case 0x5000:
       reg = 1;
-      m_reg[1] = data;
+      STATE()->m_reg[1] = data;
       C6502::RELEASEIRQ(eNESSource_Mapper);
-      m_irqCounter &= 0xFF00;
-      m_irqCounter |= data;
+      STATE()->m_irqCounter &= 0xFF00;
+      STATE()->m_irqCounter |= data;
       break;
    case 0x5800:
       reg = 2;
-      m_reg[2] = data;
+      STATE()->m_reg[2] = data;
       C6502::RELEASEIRQ(eNESSource_Mapper);
-      m_irqCounter &= 0x00FF;
-      m_irqCounter |= ((data&0x7F)<<8);
-      m_irqEnabled = (data&0x80);
+      STATE()->m_irqCounter &= 0x00FF;
+      STATE()->m_irqCounter |= ((data&0x7F)<<8);
+      STATE()->m_irqEnabled = (data&0x80);
       break;
    }
 
@@ -338,175 +330,175 @@ void CROMMapper019::HMAPPER ( uint32_t addr, uint8_t data )
    {
    case 0x8000:
       reg = 3;
-      m_reg[3] = data;
-      m_chr[0] = data;
-      m_pCHRmemory[0] = m_CHRmemory[m_chr[0]];
-      if ( (!(m_reg[16]&0x40)) &&
+      STATE()->m_reg[3] = data;
+      STATE()->m_chr[0] = data;
+      CROM::STATE()->m_pCHRmemory[0] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[0]];
+      if ( (!(STATE()->m_reg[16]&0x40)) &&
            (data >= 0xE0) )
       {
          data &= 0x1F;
          // Shove this into unused CHR memory, we'll call it CHR-RAM.
-         m_pCHRmemory[0] = m_CHRmemory[0x100+data];
+         CROM::STATE()->m_pCHRmemory[0] = CROM::STATE()->m_CHRmemory[0x100+data];
       }
       break;
    case 0x8800:
       reg = 4;
-      m_reg[4] = data;
-      m_chr[1] = data;
-      m_pCHRmemory[1] = m_CHRmemory[m_chr[1]];
-      if ( (!(m_reg[16]&0x40)) &&
+      STATE()->m_reg[4] = data;
+      STATE()->m_chr[1] = data;
+      CROM::STATE()->m_pCHRmemory[1] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[1]];
+      if ( (!(STATE()->m_reg[16]&0x40)) &&
            (data >= 0xE0) )
       {
          data &= 0x1F;
          // Shove this into unused CHR memory, we'll call it CHR-RAM.
-         m_pCHRmemory[1] = m_CHRmemory[0x100+data];
+         CROM::STATE()->m_pCHRmemory[1] = CROM::STATE()->m_CHRmemory[0x100+data];
       }
       break;
    case 0x9000:
       reg = 5;
-      m_reg[5] = data;
-      m_chr[2] = data;
-      m_pCHRmemory[2] = m_CHRmemory[m_chr[2]];
-      if ( (!(m_reg[16]&0x40)) &&
+      STATE()->m_reg[5] = data;
+      STATE()->m_chr[2] = data;
+      CROM::STATE()->m_pCHRmemory[2] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[2]];
+      if ( (!(STATE()->m_reg[16]&0x40)) &&
            (data >= 0xE0) )
       {
          data &= 0x1F;
          // Shove this into unused CHR memory, we'll call it CHR-RAM.
-         m_pCHRmemory[2] = m_CHRmemory[0x100+data];
+         CROM::STATE()->m_pCHRmemory[2] = CROM::STATE()->m_CHRmemory[0x100+data];
       }
       break;
    case 0x9800:
       reg = 6;
-      m_reg[6] = data;
-      m_chr[3] = data;
-      m_pCHRmemory[3] = m_CHRmemory[m_chr[3]];
-      if ( (!(m_reg[16]&0x40)) &&
+      STATE()->m_reg[6] = data;
+      STATE()->m_chr[3] = data;
+      CROM::STATE()->m_pCHRmemory[3] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[3]];
+      if ( (!(STATE()->m_reg[16]&0x40)) &&
            (data >= 0xE0) )
       {
          data &= 0x1F;
          // Shove this into unused CHR memory, we'll call it CHR-RAM.
-         m_pCHRmemory[3] = m_CHRmemory[0x100+data];
+         CROM::STATE()->m_pCHRmemory[3] = CROM::STATE()->m_CHRmemory[0x100+data];
       }
       break;
    case 0xA000:
       reg = 7;
-      m_reg[7] = data;
-      m_chr[4] = data;
-      m_pCHRmemory[4] = m_CHRmemory[m_chr[4]];
-      if ( (!(m_reg[16]&0x80)) &&
+      STATE()->m_reg[7] = data;
+      STATE()->m_chr[4] = data;
+      CROM::STATE()->m_pCHRmemory[4] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[4]];
+      if ( (!(STATE()->m_reg[16]&0x80)) &&
            (data >= 0xE0) )
       {
          data &= 0x1F;
          // Shove this into unused CHR memory, we'll call it CHR-RAM.
-         m_pCHRmemory[4] = m_CHRmemory[0x100+data];
+         CROM::STATE()->m_pCHRmemory[4] = CROM::STATE()->m_CHRmemory[0x100+data];
       }
       break;
    case 0xA800:
       reg = 8;
-      m_reg[8] = data;
-      m_chr[5] = data;
-      m_pCHRmemory[5] = m_CHRmemory[m_chr[5]];
-      if ( (!(m_reg[16]&0x80)) &&
+      STATE()->m_reg[8] = data;
+      STATE()->m_chr[5] = data;
+      CROM::STATE()->m_pCHRmemory[5] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[5]];
+      if ( (!(STATE()->m_reg[16]&0x80)) &&
            (data >= 0xE0) )
       {
          data &= 0x1F;
          // Shove this into unused CHR memory, we'll call it CHR-RAM.
-         m_pCHRmemory[5] = m_CHRmemory[0x100+data];
+         CROM::STATE()->m_pCHRmemory[5] = CROM::STATE()->m_CHRmemory[0x100+data];
       }
       break;
    case 0xB000:
       reg = 9;
-      m_reg[9] = data;
-      m_chr[6] = data;
-      m_pCHRmemory[6] = m_CHRmemory[m_chr[6]];
-      if ( (!(m_reg[16]&0x80)) &&
+      STATE()->m_reg[9] = data;
+      STATE()->m_chr[6] = data;
+      CROM::STATE()->m_pCHRmemory[6] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[6]];
+      if ( (!(STATE()->m_reg[16]&0x80)) &&
            (data >= 0xE0) )
       {
          data &= 0x1F;
          // Shove this into unused CHR memory, we'll call it CHR-RAM.
-         m_pCHRmemory[6] = m_CHRmemory[0x100+data];
+         CROM::STATE()->m_pCHRmemory[6] = CROM::STATE()->m_CHRmemory[0x100+data];
       }
       break;
    case 0xB800:
       reg = 10;
-      m_reg[10] = data;
-      m_chr[7] = data;
-      m_pCHRmemory[7] = m_CHRmemory[m_chr[7]];
-      if ( (!(m_reg[16]&0x80)) &&
+      STATE()->m_reg[10] = data;
+      STATE()->m_chr[7] = data;
+      CROM::STATE()->m_pCHRmemory[7] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[7]];
+      if ( (!(STATE()->m_reg[16]&0x80)) &&
            (data >= 0xE0) )
       {
          data &= 0x1F;
          // Shove this into unused CHR memory, we'll call it CHR-RAM.
-         m_pCHRmemory[7] = m_CHRmemory[0x100+data];
+         CROM::STATE()->m_pCHRmemory[7] = CROM::STATE()->m_CHRmemory[0x100+data];
       }
       break;
    case 0xC000:
       reg = 11;
-      m_reg[11] = data;
+      STATE()->m_reg[11] = data;
       if ( data < 0xE0 )
       {
-         CPPU::Move1KBank(0x8,m_CHRmemory[m_reg[11]]);
+         CPPU::Move1KBank(0x8,CROM::STATE()->m_CHRmemory[STATE()->m_reg[11]]);
       }
       else
       {
-         CPPU::MIRROR(m_reg[11]&0x01,-1,-1,-1);
+         CPPU::MIRROR(STATE()->m_reg[11]&0x01,-1,-1,-1);
       }
       break;
    case 0xC800:
       reg = 12;
-      m_reg[12] = data;
+      STATE()->m_reg[12] = data;
       if ( data < 0xE0 )
       {
-         CPPU::Move1KBank(0x9,m_CHRmemory[m_reg[12]]);
+         CPPU::Move1KBank(0x9,CROM::STATE()->m_CHRmemory[STATE()->m_reg[12]]);
       }
       else
       {
-         CPPU::MIRROR(-1,m_reg[12]&0x01,-1,-1);
+         CPPU::MIRROR(-1,STATE()->m_reg[12]&0x01,-1,-1);
       }
       break;
    case 0xD000:
       reg = 13;
-      m_reg[13] = data;
+      STATE()->m_reg[13] = data;
       if ( data < 0xE0 )
       {
-         CPPU::Move1KBank(0xA,m_CHRmemory[m_reg[13]]);
+         CPPU::Move1KBank(0xA,CROM::STATE()->m_CHRmemory[STATE()->m_reg[13]]);
       }
       else
       {
-         CPPU::MIRROR(-1,-1,m_reg[13]&0x01,-1);
+         CPPU::MIRROR(-1,-1,STATE()->m_reg[13]&0x01,-1);
       }
       break;
    case 0xD800:
       reg = 14;
-      m_reg[14] = data;
+      STATE()->m_reg[14] = data;
       if ( data < 0xE0 )
       {
-         CPPU::Move1KBank(0xB,m_CHRmemory[m_reg[14]]);
+         CPPU::Move1KBank(0xB,CROM::STATE()->m_CHRmemory[STATE()->m_reg[14]]);
       }
       else
       {
-         CPPU::MIRROR(-1,-1,-1,m_reg[14]&0x01);
+         CPPU::MIRROR(-1,-1,-1,STATE()->m_reg[14]&0x01);
       }
       break;
    case 0xE000:
       reg = 15;
-      m_reg[15] = data;
-      m_pPRGROMmemory[0] = m_PRGROMmemory[data%m_numPrgBanks];
+      STATE()->m_reg[15] = data;
+      CROM::STATE()->m_pPRGROMmemory[0] = CROM::STATE()->m_PRGROMmemory[data%CROM::STATE()->m_numPrgBanks];
       break;
    case 0xE800:
       reg = 16;
-      m_reg[16] = data;
-      m_pPRGROMmemory[1] = m_PRGROMmemory[data%m_numPrgBanks];
+      STATE()->m_reg[16] = data;
+      CROM::STATE()->m_pPRGROMmemory[1] = CROM::STATE()->m_PRGROMmemory[data%CROM::STATE()->m_numPrgBanks];
       break;
    case 0xF000:
       reg = 17;
-      m_reg[17] = data;
-      m_pPRGROMmemory[2] = m_PRGROMmemory[data%m_numPrgBanks];
+      STATE()->m_reg[17] = data;
+      CROM::STATE()->m_pPRGROMmemory[2] = CROM::STATE()->m_PRGROMmemory[data%CROM::STATE()->m_numPrgBanks];
       break;
    case 0xF800:
       reg = 18;
-      m_reg[18] = data;
-      m_soundRAMAddr = data&0x7F;
+      STATE()->m_reg[18] = data;
+      STATE()->m_soundRAMAddr = data&0x7F;
       break;
    }
 
@@ -563,25 +555,25 @@ uint16_t CROMMapper019::AMPLITUDE()
    int16_t amp;
    int16_t delta;
    int16_t out[100] = { 0, };
-   static int16_t outLast = 0;
+   int16_t& outLast = STATE()->m_outLast;
    uint8_t sample;
    uint8_t* wdacSamples[8];
-   static int32_t outDownsampled = 0;
+   int32_t& outDownsampled = STATE()->m_outDownsampled;
    int32_t idx;
 
-   wdacSamples[0] = m_wave[0].GETDACSAMPLES();
-   wdacSamples[1] = m_wave[1].GETDACSAMPLES();
-   wdacSamples[2] = m_wave[2].GETDACSAMPLES();
-   wdacSamples[3] = m_wave[3].GETDACSAMPLES();
-   wdacSamples[4] = m_wave[4].GETDACSAMPLES();
-   wdacSamples[5] = m_wave[5].GETDACSAMPLES();
-   wdacSamples[6] = m_wave[6].GETDACSAMPLES();
-   wdacSamples[7] = m_wave[7].GETDACSAMPLES();
+   wdacSamples[0] = STATE()->m_wave[0].GETDACSAMPLES();
+   wdacSamples[1] = STATE()->m_wave[1].GETDACSAMPLES();
+   wdacSamples[2] = STATE()->m_wave[2].GETDACSAMPLES();
+   wdacSamples[3] = STATE()->m_wave[3].GETDACSAMPLES();
+   wdacSamples[4] = STATE()->m_wave[4].GETDACSAMPLES();
+   wdacSamples[5] = STATE()->m_wave[5].GETDACSAMPLES();
+   wdacSamples[6] = STATE()->m_wave[6].GETDACSAMPLES();
+   wdacSamples[7] = STATE()->m_wave[7].GETDACSAMPLES();
 
-   for ( sample = 0; sample < m_wave[0].GETDACSAMPLECOUNT(); sample++ )
+   for ( sample = 0; sample < STATE()->m_wave[0].GETDACSAMPLECOUNT(); sample++ )
    {
       amp = 0;
-      for ( idx = 7-m_soundChansEnabled; idx < 8; idx++ )
+      for ( idx = 7-STATE()->m_soundChansEnabled; idx < 8; idx++ )
       {
          amp += (*(*(wdacSamples+idx)+sample));
       }
@@ -600,7 +592,7 @@ uint16_t CROMMapper019::AMPLITUDE()
       outDownsampled += (*(out+sample));
    }
 
-   outDownsampled = (int32_t)((float)outDownsampled/((float)m_wave[0].GETDACSAMPLECOUNT()));
+   outDownsampled = (int32_t)((float)outDownsampled/((float)STATE()->m_wave[0].GETDACSAMPLECOUNT()));
 
    delta = outDownsampled - outLast;
    outDownsampled = outLast+((delta*65371)/65536); // 65371/65536 is 0.9975 adjusted to 16-bit fixed point.
@@ -608,14 +600,14 @@ uint16_t CROMMapper019::AMPLITUDE()
    outLast = outDownsampled;
 
    // Reset DAC averaging...
-   m_wave[0].CLEARDACAVG();
-   m_wave[1].CLEARDACAVG();
-   m_wave[2].CLEARDACAVG();
-   m_wave[3].CLEARDACAVG();
-   m_wave[4].CLEARDACAVG();
-   m_wave[5].CLEARDACAVG();
-   m_wave[6].CLEARDACAVG();
-   m_wave[7].CLEARDACAVG();
+   STATE()->m_wave[0].CLEARDACAVG();
+   STATE()->m_wave[1].CLEARDACAVG();
+   STATE()->m_wave[2].CLEARDACAVG();
+   STATE()->m_wave[3].CLEARDACAVG();
+   STATE()->m_wave[4].CLEARDACAVG();
+   STATE()->m_wave[5].CLEARDACAVG();
+   STATE()->m_wave[6].CLEARDACAVG();
+   STATE()->m_wave[7].CLEARDACAVG();
 
    return outDownsampled;
 }
@@ -101,23 +101,32 @@ public:
       uint8_t bit;
       for ( bit = 0; bit < 8; bit++ )
       {
-         m_wave[bit].muted = !(mask&(0x01<<bit));
+         STATE()->m_wave[bit].muted = !(mask&(0x01<<bit));
       }
    }
 
 protected:
-   // N106
-   static uint8_t  m_reg [ 19 ];
-   static uint8_t  m_chr [ 8 ];
-   static uint16_t m_irqCounter;
-   static bool     m_irqEnabled;
+   friend struct NESContext;
+   struct State
+   {
+      // N106
+      uint8_t  m_reg [ 19 ] = { 0x00, };
+      uint8_t  m_chr [ 8 ] = { 0, };
+      uint16_t m_irqCounter = 0;
+      bool     m_irqEnabled = false;
+
+      // N106 sound
+      N106WaveChannel m_wave[8];
 
-   // N106 sound
-   static N106WaveChannel m_wave[8];
+      uint8_t m_soundRAM[128] = { 0, };
+      uint8_t m_soundRAMAddr = 0;
+      uint8_t m_soundChansEnabled = 0;
 
-   static uint8_t m_soundRAM[128];
-   static uint8_t m_soundRAMAddr;
-   static uint8_t m_soundChansEnabled;
+      // Output filter accumulators.
+      int16_t m_outLast = 0;
+      int32_t m_outDownsampled = 0;
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -19,6 +19,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 021 Registers
 static CBitfieldData* tbl8000Bitfields [] =
@@ -135,14 +136,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,2,24,48,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper021::m_reg [] = { 0x00, };
-uint8_t  CROMMapper021::m_chr [] = { 0, };
-uint8_t  CROMMapper021::m_irqReload = 0;
-uint8_t  CROMMapper021::m_irqCounter = 0;
-uint8_t  CROMMapper021::m_irqPrescaler = 0;
-uint8_t  CROMMapper021::m_irqPrescalerPhase = 0;
-bool     CROMMapper021::m_irqEnabled = false;
-
 CROMMapper021::CROMMapper021()
 {
 }
@@ -155,22 +148,22 @@ void CROMMapper021::RESET ( bool soft )
 {
    int32_t idx;
 
-   m_mapper = 21;
+   CROM::STATE()->m_mapper = 21;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_irqReload = 0;
-   m_irqCounter = 0;
-   m_irqPrescaler = 0;
-   m_irqPrescalerPhase = 0;
-   m_irqEnabled = false;
+   STATE()->m_irqReload = 0;
+   STATE()->m_irqCounter = 0;
+   STATE()->m_irqPrescaler = 0;
+   STATE()->m_irqPrescalerPhase = 0;
+   STATE()->m_irqEnabled = false;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
@@ -179,14 +172,14 @@ void CROMMapper021::SYNCCPU ( void )
 {
    uint8_t phases[3] = { 114, 114, 113 };
 
-   if ( m_reg[22]&0x02 )
+   if ( STATE()->m_reg[22]&0x02 )
    {
-      if ( m_reg[22]&0x04 )
+      if ( STATE()->m_reg[22]&0x04 )
       {
          // Cycle mode counter
-         if ( m_irqCounter == 0xFF )
+         if ( STATE()->m_irqCounter == 0xFF )
          {
-            m_irqCounter = m_irqReload;
+            STATE()->m_irqCounter = STATE()->m_irqReload;
             C6502::ASSERTIRQ(eNESSource_Mapper);
 
             if ( nesIsDebuggable() )
@@ -197,22 +190,22 @@ void CROMMapper021::SYNCCPU ( void )
          }
          else
          {
-            m_irqCounter++;
+            STATE()->m_irqCounter++;
          }
       }
       else
       {
          // Scanline mode counter
-         m_irqPrescaler++;
-         if ( m_irqPrescaler >= phases[m_irqPrescalerPhase] )
+         STATE()->m_irqPrescaler++;
+         if ( STATE()->m_irqPrescaler >= phases[STATE()->m_irqPrescalerPhase] )
          {
-            m_irqPrescaler = 0;
-            m_irqPrescalerPhase++;
-            m_irqPrescalerPhase %= 3;
+            STATE()->m_irqPrescaler = 0;
+            STATE()->m_irqPrescalerPhase++;
+            STATE()->m_irqPrescalerPhase %= 3;
 
-            if ( m_irqCounter == 0xFF )
+            if ( STATE()->m_irqCounter == 0xFF )
             {
-               m_irqCounter = m_irqReload;
+               STATE()->m_irqCounter = STATE()->m_irqReload;
                C6502::ASSERTIRQ(eNESSource_Mapper);
 
                if ( nesIsDebuggable() )
@@ -223,7 +216,7 @@ void CROMMapper021::SYNCCPU ( void )
             }
             else
             {
-               m_irqCounter++;
+               STATE()->m_irqCounter++;
             }
          }
       }
@@ -241,18 +234,18 @@ uint32_t CROMMapper021::DEBUGINFO ( uint32_t addr )
    case 0x8080:
    case 0x8006:
    case 0x80C0:
-      return m_reg[0];
+      return STATE()->m_reg[0];
       break;
    case 0x9000:
    case 0x9002:
    case 0x9040:
-      return m_reg[1];
+      return STATE()->m_reg[1];
       break;
    case 0x9004:
    case 0x9080:
    case 0x9006:
    case 0x90C0:
-      return m_reg[2];
+      return STATE()->m_reg[2];
       break;
    case 0xA000:
    case 0xA002:
@@ -261,82 +254,82 @@ uint32_t CROMMapper021::DEBUGINFO ( uint32_t addr )
    case 0xA080:
    case 0xA006:
    case 0xA0C0:
-      return m_reg[3];
+      return STATE()->m_reg[3];
       break;
    case 0xB000:
-      return m_reg[4];
+      return STATE()->m_reg[4];
       break;
    case 0xB002:
    case 0xB040:
-      return m_reg[5];
+      return STATE()->m_reg[5];
       break;
    case 0xB004:
    case 0xB080:
-      return m_reg[6];
+      return STATE()->m_reg[6];
       break;
    case 0xB006:
    case 0xB0C0:
-      return m_reg[7];
+      return STATE()->m_reg[7];
       break;
    case 0xC000:
-      return m_reg[8];
+      return STATE()->m_reg[8];
       break;
    case 0xC002:
    case 0xC040:
-      return m_reg[9];
+      return STATE()->m_reg[9];
       break;
    case 0xC004:
    case 0xC080:
-      return m_reg[10];
+      return STATE()->m_reg[10];
       break;
    case 0xC006:
    case 0xC0C0:
-      return m_reg[11];
+      return STATE()->m_reg[11];
       break;
    case 0xD000:
-      return m_reg[12];
+      return STATE()->m_reg[12];
       break;
    case 0xD002:
    case 0xD040:
-      return m_reg[13];
+      return STATE()->m_reg[13];
       break;
    case 0xD004:
    case 0xD080:
-      return m_reg[14];
+      return STATE()->m_reg[14];
       break;
    case 0xD006:
    case 0xD0C0:
-      return m_reg[15];
+      return STATE()->m_reg[15];
       break;
    case 0xE000:
-      return m_reg[16];
+      return STATE()->m_reg[16];
       break;
    case 0xE002:
    case 0xE040:
-      return m_reg[17];
+      return STATE()->m_reg[17];
       break;
    case 0xE004:
    case 0xE080:
-      return m_reg[18];
+      return STATE()->m_reg[18];
       break;
    case 0xE006:
    case 0xE0C0:
-      return m_reg[19];
+      return STATE()->m_reg[19];
       break;
    case 0xF000:
-      return m_reg[20];
+      return STATE()->m_reg[20];
       break;
    case 0xF002:
    case 0xF040:
-      return m_reg[21];
+      return STATE()->m_reg[21];
       break;
    case 0xF004:
    case 0xF080:
-      return m_reg[22];
+      return STATE()->m_reg[22];
       break;
    case 0xF006:
    case 0xF0C0:
-      return m_reg[23];
+      return STATE()->m_reg[23];
       break;
    }
 }
@@ -355,23 +348,23 @@ void CROMMapper021::HMAPPER ( uint32_t addr, uint8_t data )
    case 0x8006:
    case 0x80C0:
       reg = 0;
-      m_reg[0] = data;
-      if ( m_reg[2]&0x02 )
+      STATE()->m_reg[0] = data;
+      if ( STATE()->m_reg[2]&0x02 )
       {
-         m_pPRGROMmemory[0] = m_PRGROMmemory[m_numPrgBanks-2];
-         m_pPRGROMmemory[2] = m_PRGROMmemory[data&0x1F];
+         CROM::STATE()->m_pPRGROMmemory[0] = CROM::STATE()->m_PRGROMmemory[CROM::STATE()->m_numPrgBanks-2];
+         CROM::STATE()->m_pPRGROMmemory[2] = CROM::STATE()->m_PRGROMmemory[data&0x1F];
       }
       else
       {
-         m_pPRGROMmemory[0] = m_PRGROMmemory[data&0x1F];
-         m_pPRGROMmemory[2] = m_PRGROMmemory[m_numPrgBanks-2];
+         CROM::STATE()->m_pPRGROMmemory[0] = CROM::STATE()->m_PRGROMmemory[data&0x1F];
+         CROM::STATE()->m_pPRGROMmemory[2] = CROM::STATE()->m_PRGROMmemory[CROM::STATE()->m_numPrgBanks-2];
       }
       break;
    case 0x9000:
    case 0x9002:
    case 0x9040:
       reg = 1;
-      m_reg[1] = data;
+      STATE()->m_reg[1] = data;
       switch ( data&0x03 )
       {
       case 0:
@@ -393,14 +386,14 @@ void CROMMapper021::HMAPPER ( uint32_t addr, uint8_t data )
    case 0x9006:
    case 0x90C0:
       reg = 2;
-      m_reg[2] = data;
-      if ( m_reg[2]&0x02 )
+      STATE()->m_reg[2] = data;
+      if ( STATE()->m_reg[2]&0x02 )
       {
-         m_pPRGROMmemory[0] = m_PRGROMmemory[m_numPrgBanks-2];
+         CROM::STATE()->m_pPRGROMmemory[0] = CROM::STATE()->m_PRGROMmemory[CROM::STATE()->m_numPrgBanks-2];
       }
       else
       {
-         m_pPRGROMmemory[2] = m_PRGROMmemory[m_numPrgBanks-2];
+         CROM::STATE()->m_pPRGROMmemory[2] = CROM::STATE()->m_PRGROMmemory[CROM::STATE()->m_numPrgBanks-2];
       }
       break;
    case 0xA000:
@@ -411,177 +404,177 @@ void CROMMapper021::HMAPPER ( uint32_t addr, uint8_t data )
    case 0xA006:
    case 0xA0C0:
       reg = 3;
-      m_reg[3] = data;
-      m_pPRGROMmemory[1] = m_PRGROMmemory[data&0x1F];
+      STATE()->m_reg[3] = data;
+      CROM::STATE()->m_pPRGROMmemory[1] = CROM::STATE()->m_PRGROMmemory[data&0x1F];
       break;
    case 0xB000:
       reg = 4;
-      m_reg[4] = data;
-      m_chr[0] &= 0xF0;
-      m_chr[0] |= (data&0x0F);
-      m_pCHRmemory[0] = m_CHRmemory[m_chr[0]];
+      STATE()->m_reg[4] = data;
+      STATE()->m_chr[0] &= 0xF0;
+      STATE()->m_chr[0] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[0] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[0]];
       break;
    case 0xB002:
    case 0xB040:
       reg = 5;
-      m_reg[5] = data;
-      m_chr[0] &= 0x0F;
-      m_chr[0] |= (data<<4);
-      m_pCHRmemory[0] = m_CHRmemory[m_chr[0]];
+      STATE()->m_reg[5] = data;
+      STATE()->m_chr[0] &= 0x0F;
+      STATE()->m_chr[0] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[0] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[0]];
       break;
    case 0xB004:
    case 0xB080:
       reg = 6;
-      m_reg[6] = data;
-      m_chr[1] &= 0xF0;
-      m_chr[1] |= (data&0x0F);
-      m_pCHRmemory[1] = m_CHRmemory[m_chr[1]];
+      STATE()->m_reg[6] = data;
+      STATE()->m_chr[1] &= 0xF0;
+      STATE()->m_chr[1] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[1] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[1]];
       break;
    case 0xB006:
    case 0xB0C0:
       reg = 7;
-      m_reg[7] = data;
-      m_chr[1] &= 0x0F;
-      m_chr[1] |= (data<<4);
-      m_pCHRmemory[1] = m_CHRmemory[m_chr[1]];
+      STATE()->m_reg[7] = data;
+      STATE()->m_chr[1] &= 0x0F;
+      STATE()->m_chr[1] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[1] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[1]];
       break;
    case 0xC000:
       reg = 8;
-      m_reg[8] = data;
-      m_chr[2] &= 0xF0;
-      m_chr[2] |= (data&0x0F);
-      m_pCHRmemory[2] = m_CHRmemory[m_chr[2]];
+      STATE()->m_reg[8] = data;
+      STATE()->m_chr[2] &= 0xF0;
+      STATE()->m_chr[2] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[2] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[2]];
       break;
    case 0xC002:
    case 0xC040:
       reg = 9;
-      m_reg[9] = data;
-      m_chr[2] &= 0x0F;
-      m_chr[2] |= (data<<4);
-      m_pCHRmemory[2] = m_CHRmemory[m_chr[2]];
+      STATE()->m_reg[9] = data;
+      STATE()->m_chr[2] &= 0x0F;
+      STATE()->m_chr[2] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[2] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[2]];
       break;
    case 0xC004:
    case 0xC080:
       reg = 10;
-      m_reg[10] = data;
-      m_chr[3] &= 0xF0;
-      m_chr[3] |= (data&0x0F);
-      m_pCHRmemory[3] = m_CHRmemory[m_chr[3]];
+      STATE()->m_reg[10] = data;
+      STATE()->m_chr[3] &= 0xF0;
+      STATE()->m_chr[3] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[3] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[3]];
       break;
    case 0xC006:
    case 0xC0C0:
       reg = 11;
-      m_reg[11] = data;
-      m_chr[3] &= 0x0F;
-      m_chr[3] |= (data<<4);
-      m_pCHRmemory[3] = m_CHRmemory[m_chr[3]];
+      STATE()->m_reg[11] = data;
+      STATE()->m_chr[3] &= 0x0F;
+      STATE()->m_chr[3] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[3] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[3]];
       break;
    case 0xD000:
       reg = 12;
-      m_reg[12] = data;
-      m_chr[4] &= 0xF0;
-      m_chr[4] |= (data&0x0F);
-      m_pCHRmemory[4] = m_CHRmemory[m_chr[4]];
+      STATE()->m_reg[12] = data;
+      STATE()->m_chr[4] &= 0xF0;
+      STATE()->m_chr[4] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[4] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[4]];
       break;
    case 0xD002:
    case 0xD040:
       reg = 13;
-      m_reg[13] = data;
-      m_chr[4] &= 0x0F;
-      m_chr[4] |= (data<<4);
-      m_pCHRmemory[4] = m_CHRmemory[m_chr[4]];
+      STATE()->m_reg[13] = data;
+      STATE()->m_chr[4] &= 0x0F;
+      STATE()->m_chr[4] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[4] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[4]];
       break;
    case 0xD004:
    case 0xD080:
       reg = 14;
-      m_reg[14] = data;
-      m_chr[5] &= 0xF0;
-      m_chr[5] |= (data&0x0F);
-      m_pCHRmemory[5] = m_CHRmemory[m_chr[5]];
+      STATE()->m_reg[14] = data;
+      STATE()->m_chr[5] &= 0xF0;
+      STATE()->m_chr[5] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[5] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[5]];
       break;
    case 0xD006:
    case 0xD0C0:
       reg = 15;
-      m_reg[15] = data;
-      m_chr[5] &= 0x0F;
-      m_chr[5] |= (data<<4);
-      m_pCHRmemory[5] = m_CHRmemory[m_chr[5]];
+      STATE()->m_reg[15] = data;
+      STATE()->m_chr[5] &= 0x0F;
+      STATE()->m_chr[5] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[5] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[5]];
       break;
    case 0xE000:
       reg = 16;
-      m_reg[16] = data;
-      m_chr[6] &= 0xF0;
-      m_chr[6] |= (data&0x0F);
-      m_pCHRmemory[6] = m_CHRmemory[m_chr[6]];
+      STATE()->m_reg[16] = data;
+      STATE()->m_chr[6] &= 0xF0;
+      STATE()->m_chr[6] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[6] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[6]];
       break;
    case 0xE002:
    case 0xE040:
       reg = 17;
-      m_reg[17] = data;
-      m_chr[6] &= 0x0F;
-      m_chr[6] |= (data<<4);
-      m_pCHRmemory[6] = m_CHRmemory[m_chr[6]];
+      STATE()->m_reg[17] = data;
+      STATE()->m_chr[6] &= 0x0F;
+      STATE()->m_chr[6] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[6] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[6]];
       break;
    case 0xE004:
    case 0xE080:
       reg = 18;
-      m_reg[18] = data;
-      m_chr[7] &= 0xF0;
-      m_chr[7] |= (data&0x0F);
-      m_pCHRmemory[7] = m_CHRmemory[m_chr[7]];
+      STATE()->m_reg[18] = data;
+      STATE()->m_chr[7] &= 0xF0;
+      STATE()->m_chr[7] |= (data&0x0F);
+      CROM::STATE()->m_pCHRmemory[7] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[7]];
       break;
    case 0xE006:
    case 0xE0C0:
       reg = 19;
-      m_reg[19] = data;
-      m_chr[7] &= 0x0F;
-      m_chr[7] |= (data<<4);
-      m_pCHRmemory[7] = m_CHRmemory[m_chr[7]];
+      STATE()->m_reg[19] = data;
+      STATE()->m_chr[7] &= 0x0F;
+      STATE()->m_chr[7] |= (data<<4);
+      CROM::STATE()->m_pCHRmemory[7] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[7]];
       break;
    case 0xF000:
       reg = 20;
-      m_reg[20] = data;
-      m_irqReload &= 0xF0;
-      m_irqReload |= (data&0x0F);
+      STATE()->m_reg[20] = data;
+      STATE()->m_irqReload &= 0xF0;
+      STATE()->m_irqReload |= (data&0x0F);
       break;
    case 0xF002:
    case 0xF040:
       reg = 21;
-      m_reg[21] = data;
-      m_irqReload &= 0x0F;
-      m_irqReload |= (data<<4);
+      STATE()->m_reg[21] = data;
+      STATE()->m_irqReload &= 0x0F;
+      STATE()->m_irqReload |= (data<<4);
       break;
    case 0xF004:
    case 0xF080:
       reg = 22;
-      m_reg[22] = data;
+      STATE()->m_reg[22] = data;
       C6502::RELEASEIRQ(eNESSource_Mapper);
-      if ( m_reg[22]&0x02 )
+      if ( STATE()->m_reg[22]&0x02 )
       {
-         m_irqCounter = m_irqReload;
-         m_irqPrescaler = 0;
-         m_irqPrescalerPhase = 0;
-         m_irqEnabled = true;
+         STATE()->m_irqCounter = STATE()->m_irqReload;
+         STATE()->m_irqPrescaler = 0;
+         STATE()->m_irqPrescalerPhase = 0;
+         STATE()->m_irqEnabled = true;
       }
       else
       {
-         m_irqEnabled = false;
+         STATE()->m_irqEnabled = false;
       }
       break;
    case 0xF006:
    case 0xF0C0:
       reg = 23;
-      m_reg[23] = data;
+      STATE()->m_reg[23] = data;
       C6502::RELEASEIRQ(eNESSource_Mapper);
-      m_reg[22] &= 0xFD;
-      m_reg[22] |= ((m_reg[22]&0x01)<<1);
-      if ( m_reg[22]&0x02 )
+      STATE()->m_reg[22] &= 0xFD;
+      STATE()->m_reg[22] |= ((STATE()->m_reg[22]&0x01)<<1);
+      if ( STATE()->m_reg[22]&0x02 )
       {
-         m_irqEnabled = true;
+         STATE()->m_irqEnabled = true;
       }
       else
       {
-         m_irqEnabled = false;
+         STATE()->m_irqEnabled = false;
       }
       break;
    }
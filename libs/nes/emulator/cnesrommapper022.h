@@ -14,9 +14,14 @@ public:
    static uint32_t DEBUGINFO ( uint32_t addr );
 
 protected:
-   // VRC2
-   static uint8_t  m_reg [ 19 ];
-   static uint8_t  m_chr [ 8 ];
+   friend struct NESContext;
+   struct State
+   {
+      // VRC2
+      uint8_t  m_reg [ 19 ] = { 0x00, };
+      uint8_t  m_chr [ 8 ] = { 0, };
+   };
+   static inline State* STATE ();
 };
 
 #endif
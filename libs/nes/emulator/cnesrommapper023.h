@@ -15,14 +15,19 @@ public:
    static uint32_t DEBUGINFO ( uint32_t addr );
 
 protected:
-   // VRC2+VRC4
-   static uint8_t  m_reg [ 23 ];
-   static uint8_t  m_chr [ 8 ];
-   static uint8_t  m_irqReload;
-   static uint8_t  m_irqCounter;
-   static uint8_t  m_irqPrescaler;
-   static uint8_t  m_irqPrescalerPhase;
-   static bool     m_irqEnabled;
+   friend struct NESContext;
+   struct State
+   {
+      // VRC2+VRC4
+      uint8_t  m_reg [ 23 ] = { 0x00, };
+      uint8_t  m_chr [ 8 ] = { 0, };
+      uint8_t  m_irqReload = 0;
+      uint8_t  m_irqCounter = 0;
+      uint8_t  m_irqPrescaler = 0;
+      uint8_t  m_irqPrescalerPhase = 0;
+      bool     m_irqEnabled = false;
+   };
+   static inline State* STATE ();
 };
 
 #endif
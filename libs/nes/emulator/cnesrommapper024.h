@@ -156,24 +156,33 @@ public:
    static uint16_t AMPLITUDE ( void );
    static void SOUNDENABLE ( uint32_t mask )
    {
-      m_pulse[0].muted = !(mask&0x01);
-      m_pulse[1].muted = !(mask&0x02);
-      m_sawtooth.muted = !(mask&0x04);
+      STATE()->m_pulse[0].muted = !(mask&0x01);
+      STATE()->m_pulse[1].muted = !(mask&0x02);
+      STATE()->m_sawtooth.muted = !(mask&0x04);
    }
 
 protected:
-   // VRC6
-   static uint8_t  m_reg [ 23 ];
-   static uint8_t  m_chr [ 8 ];
-   static uint8_t  m_irqReload;
-   static uint8_t  m_irqCounter;
-   static uint8_t  m_irqPrescaler;
-   static uint8_t  m_irqPrescalerPhase;
-   static bool     m_irqEnabled;
+   friend struct NESContext;
+   struct State
+   {
+      // VRC6
+      uint8_t  m_reg [ 23 ] = { 0x00, };
+      uint8_t  m_chr [ 8 ] = { 0, };
+      uint8_t  m_irqReload = 0;
+      uint8_t  m_irqCounter = 0;
+      uint8_t  m_irqPrescaler = 0;
+      uint8_t  m_irqPrescalerPhase = 0;
+      bool     m_irqEnabled = false;
+
+      // VRC6 sound
+      VRC6PulseChannel m_pulse[2];
+      VRC6SawtoothChannel m_sawtooth;
 
-   // VRC6 sound
-   static VRC6PulseChannel m_pulse[2];
-   static VRC6SawtoothChannel m_sawtooth;
+      // Output filter accumulators.
+      int16_t m_outLast = 0;
+      int32_t m_outDownsampled = 0;
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -19,6 +19,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 026 Registers
 static CBitfieldData* tbl8000Bitfields [] =
@@ -127,14 +128,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,23,23,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper026::m_reg [] = { 0x00, };
-uint8_t  CROMMapper026::m_chr [];
-uint8_t  CROMMapper026::m_irqReload = 0;
-uint8_t  CROMMapper026::m_irqCounter = 0;
-uint8_t  CROMMapper026::m_irqPrescaler = 0;
-uint8_t  CROMMapper026::m_irqPrescalerPhase = 0;
-bool     CROMMapper026::m_irqEnabled = false;
-
 CROMMapper026::CROMMapper026()
 {
 }
@@ -147,26 +140,26 @@ void CROMMapper026::RESET ( bool soft )
 {
    int32_t idx;
 
-   m_mapper = 26;
+   CROM::STATE()->m_mapper = 26;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   m_pulse[0].RESET();
-   m_pulse[1].RESET();
-   m_sawtooth.RESET();
+   CROMMapper024::STATE()->m_pulse[0].RESET();
+   CROMMapper024::STATE()->m_pulse[1].RESET();
+   CROMMapper024::STATE()->m_sawtooth.RESET();
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_irqReload = 0;
-   m_irqCounter = 0;
-   m_irqPrescaler = 0;
-   m_irqPrescalerPhase = 0;
-   m_irqEnabled = false;
+   STATE()->m_irqReload = 0;
+   STATE()->m_irqCounter = 0;
+   STATE()->m_irqPrescaler = 0;
+   STATE()->m_irqPrescalerPhase = 0;
+   STATE()->m_irqEnabled = false;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
@@ -175,18 +168,18 @@ void CROMMapper026::SYNCCPU ( void )
 {
    uint8_t phases[3] = { 114, 114, 113 };
 
-   m_pulse[0].TIMERTICK();
-   m_pulse[1].TIMERTICK();
-   m_sawtooth.TIMERTICK();
+   CROMMapper024::STATE()->m_pulse[0].TIMERTICK();
+   CROMMapper024::STATE()->m_pulse[1].TIMERTICK();
+   CROMMapper024::STATE()->m_sawtooth.TIMERTICK();
 
-   if ( m_reg[21]&0x02 )
+   if ( STATE()->m_reg[21]&0x02 )
    {
-      if ( m_reg[21]&0x04 )
+      if ( STATE()->m_reg[21]&0x04 )
       {
          // Cycle mode counter
-         if ( m_irqCounter == 0xFF )
+         if ( STATE()->m_irqCounter == 0xFF )
          {
-            m_irqCounter = m_irqReload;
+            STATE()->m_irqCounter = STATE()->m_irqReload;
             C6502::ASSERTIRQ(eNESSource_Mapper);
 
             if ( nesIsDebuggable() )
@@ -197,22 +190,22 @@ void CROMMapper026::SYNCCPU ( void )
          }
          else
          {
-            m_irqCounter++;
+            STATE()->m_irqCounter++;
          }
       }
       else
       {
          // Scanline mode counter
-         m_irqPrescaler++;
-         if ( m_irqPrescaler >= phases[m_irqPrescalerPhase] )
+         STATE()->m_irqPrescaler++;
+         if ( STATE()->m_irqPrescaler >= phases[STATE()->m_irqPrescalerPhase] )
          {
-            m_irqPrescaler = 0;
-            m_irqPrescalerPhase++;
-            m_irqPrescalerPhase %= 3;
+            STATE()->m_irqPrescaler = 0;
+            STATE()->m_irqPrescalerPhase++;
+            STATE()->m_irqPrescalerPhase %= 3;
 
-            if ( m_irqCounter == 0xFF )
+            if ( STATE()->m_irqCounter == 0xFF )
             {
-               m_irqCounter = m_irqReload;
+               STATE()->m_irqCounter = STATE()->m_irqReload;
                C6502::ASSERTIRQ(eNESSource_Mapper);
 
                if ( nesIsDebuggable() )
@@ -223,7 +216,7 @@ void CROMMapper026::SYNCCPU ( void )
             }
             else
             {
-               m_irqCounter++;
+               STATE()->m_irqCounter++;
             }
          }
       }
@@ -238,76 +231,76 @@ uint32_t CROMMapper026::DEBUGINFO ( uint32_t addr )
    case 0x8001:
    case 0x8002:
    case 0x8003:
-      return m_reg[0];
+      return STATE()->m_reg[0];
       break;
    case 0x9000:
-      return m_reg[1];
+      return STATE()->m_reg[1];
       break;
    case 0x9001:
-      return m_reg[2];
+      return STATE()->m_reg[2];
       break;
    case 0x9002:
-      return m_reg[3];
+      return STATE()->m_reg[3];
       break;
    case 0xA000:
-      return m_reg[4];
+      return STATE()->m_reg[4];
       break;
    case 0xA001:
-      return m_reg[5];
+      return STATE()->m_reg[5];
       break;
    case 0xA002:
-      return m_reg[6];
+      return STATE()->m_reg[6];
       break;
    case 0xB000:
-      return m_reg[7];
+      return STATE()->m_reg[7];
       break;
    case 0xB001:
-      return m_reg[8];
+      return STATE()->m_reg[8];
       break;
    case 0xB002:
-      return m_reg[9];
+      return STATE()->m_reg[9];
       break;
    case 0xB003:
-      return m_reg[10];
+      return STATE()->m_reg[10];
       break;
    case 0xC000:
    case 0xC001:
    case 0xC002:
    case 0xC003:
-      return m_reg[11];
+      return STATE()->m_reg[11];
       break;
    case 0xD000:
-      return m_reg[12];
+      return STATE()->m_reg[12];
       break;
    case 0xD001:
-      return m_reg[13];
+      return STATE()->m_reg[13];
       break;
    case 0xD002:
-      return m_reg[14];
+      return STATE()->m_reg[14];
       break;
    case 0xD003:
-      return m_reg[15];
+      return STATE()->m_reg[15];
       break;
    case 0xE000:
-      return m_reg[16];
+      return STATE()->m_reg[16];
       break;
    case 0xE001:
-      return m_reg[17];
+      return STATE()->m_reg[17];
       break;
    case 0xE002:
-      return m_reg[18];
+      return STATE()->m_reg[18];
       break;
    case 0xE003:
-      return m_reg[19];
+      return STATE()->m_reg[19];
       break;
    case 0xF000:
-      return m_reg[20];
+      return STATE()->m_reg[20];
       break;
    case 0xF001:
-      return m_reg[21];
+      return STATE()->m_reg[21];
       break;
    case 0xF002:
-      return m_reg[22];
+      return STATE()->m_reg[22];
       break;
    }
 }
@@ -323,58 +316,58 @@ void CROMMapper026::HMAPPER ( uint32_t addr, uint8_t data )
    case 0x8002:
    case 0x8003:
       reg = 0;
-      m_reg[0] = data;
-      m_pPRGROMmemory[0] = m_PRGROMmemory[(data<<1)+0];
-      m_pPRGROMmemory[1] = m_PRGROMmemory[(data<<1)+1];
+      STATE()->m_reg[0] = data;
+      CROM::STATE()->m_pPRGROMmemory[0] = CROM::STATE()->m_PRGROMmemory[(data<<1)+0];
+      CROM::STATE()->m_pPRGROMmemory[1] = CROM::STATE()->m_PRGROMmemory[(data<<1)+1];
       break;
    case 0x9000:
       reg = 1;
-      m_reg[1] = data;
-      m_pulse[0].REG(0x9000,data);
+      STATE()->m_reg[1] = data;
+      CROMMapper024::STATE()->m_pulse[0].REG(0x9000,data);
       break;
    case 0x9001:
       reg = 2;
-      m_reg[2] = data;
-      m_pulse[0].REG(0x9002,data);
+      STATE()->m_reg[2] = data;
+      CROMMapper024::STATE()->m_pulse[0].REG(0x9002,data);
       break;
    case 0x9002:
       reg = 3;
-      m_reg[3] = data;
-      m_pulse[0].REG(0x9001,data);
+      STATE()->m_reg[3] = data;
+      CROMMapper024::STATE()->m_pulse[0].REG(0x9001,data);
       break;
    case 0xA000:
       reg = 4;
-      m_reg[4] = data;
-      m_pulse[1].REG(0xA000,data);
+      STATE()->m_reg[4] = data;
+      CROMMapper024::STATE()->m_pulse[1].REG(0xA000,data);
       break;
    case 0xA001:
       reg = 5;
-      m_reg[5] = data;
-      m_pulse[1].REG(0xA002,data);
+      STATE()->m_reg[5] = data;
+      CROMMapper024::STATE()->m_pulse[1].REG(0xA002,data);
       break;
    case 0xA002:
       reg = 6;
-      m_reg[6] = data;
-      m_pulse[1].REG(0xA001,data);
+      STATE()->m_reg[6] = data;
+      CROMMapper024::STATE()->m_pulse[1].REG(0xA001,data);
       break;
    case 0xB000:
       reg = 7;
-      m_reg[7] = data;
-      m_sawtooth.REG(0xB000,data);
+      STATE()->m_reg[7] = data;
+      CROMMapper024::STATE()->m_sawtooth.REG(0xB000,data);
       break;
    case 0xB001:
       reg = 8;
-      m_reg[8] = data;
-      m_sawtooth.REG(0xB002,data);
+      STATE()->m_reg[8] = data;
+      CROMMapper024::STATE()->m_sawtooth.REG(0xB002,data);
       break;
    case 0xB002:
       reg = 9;
-      m_reg[9] = data;
-      m_sawtooth.REG(0xB001,data);
+      STATE()->m_reg[9] = data;
+      CROMMapper024::STATE()->m_sawtooth.REG(0xB001,data);
       break;
    case 0xB003:
       reg = 10;
-      m_reg[10] = data;
+      STATE()->m_reg[10] = data;
       switch ( (data&0x0C)>>2 )
       {
       case 0:
@@ -396,91 +389,91 @@ void CROMMapper026::HMAPPER ( uint32_t addr, uint8_t data )
    case 0xC002:
    case 0xC003:
       reg = 11;
-      m_reg[11] = data;
-      m_pPRGROMmemory[2] = m_PRGROMmemory[data];
+      STATE()->m_reg[11] = data;
+      CROM::STATE()->m_pPRGROMmemory[2] = CROM::STATE()->m_PRGROMmemory[data];
       break;
    case 0xD000:
       reg = 12;
-      m_reg[12] = data;
-      m_chr[0] = data;
-      m_pCHRmemory[0] = m_CHRmemory[m_chr[0]];
+      STATE()->m_reg[12] = data;
+      STATE()->m_chr[0] = data;
+      CROM::STATE()->m_pCHRmemory[0] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[0]];
       break;
    case 0xD001:
       reg = 13;
-      m_reg[13] = data;
-      m_chr[2] = data;
-      m_pCHRmemory[2] = m_CHRmemory[m_chr[2]];
+      STATE()->m_reg[13] = data;
+      STATE()->m_chr[2] = data;
+      CROM::STATE()->m_pCHRmemory[2] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[2]];
       break;
    case 0xD002:
       reg = 14;
-      m_reg[14] = data;
-      m_chr[1] = data;
-      m_pCHRmemory[1] = m_CHRmemory[m_chr[1]];
+      STATE()->m_reg[14] = data;
+      STATE()->m_chr[1] = data;
+      CROM::STATE()->m_pCHRmemory[1] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[1]];
       break;
    case 0xD003:
       reg = 15;
-      m_reg[15] = data;
-      m_chr[3] = data;
-      m_pCHRmemory[3] = m_CHRmemory[m_chr[3]];
+      STATE()->m_reg[15] = data;
+      STATE()->m_chr[3] = data;
+      CROM::STATE()->m_pCHRmemory[3] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[3]];
       break;
    case 0xE000:
       reg = 16;
-      m_reg[16] = data;
-      m_chr[4] = data;
-      m_pCHRmemory[4] = m_CHRmemory[m_chr[4]];
+      STATE()->m_reg[16] = data;
+      STATE()->m_chr[4] = data;
+      CROM::STATE()->m_pCHRmemory[4] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[4]];
       break;
    case 0xE001:
       reg = 17;
-      m_reg[17] = data;
-      m_chr[6] = data;
-      m_pCHRmemory[6] = m_CHRmemory[m_chr[6]];
+      STATE()->m_reg[17] = data;
+      STATE()->m_chr[6] = data;
+      CROM::STATE()->m_pCHRmemory[6] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[6]];
       break;
    case 0xE002:
       reg = 18;
-      m_reg[18] = data;
-      m_chr[5] = data;
-      m_pCHRmemory[5] = m_CHRmemory[m_chr[5]];
+      STATE()->m_reg[18] = data;
+      STATE()->m_chr[5] = data;
+      CROM::STATE()->m_pCHRmemory[5] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[5]];
       break;
    case 0xE003:
       reg = 19;
-      m_reg[19] = data;
-      m_chr[7] = data;
-      m_pCHRmemory[7] = m_CHRmemory[m_chr[7]];
+      STATE()->m_reg[19] = data;
+      STATE()->m_chr[7] = data;
+      CROM::STATE()->m_pCHRmemory[7] = CROM::STATE()->m_CHRmemory[STATE()->m_chr[7]];
       break;
    case 0xF000:
       reg = 20;
-      m_reg[20] = data;
-      m_irqReload = data;
+      STATE()->m_reg[20] = data;
+      STATE()->m_irqReload = data;
       break;
    case 0xF001:
       reg = 21;
-      m_reg[21] = data;
+      STATE()->m_reg[21] = data;
       C6502::RELEASEIRQ(eNESSource_Mapper);
-      m_reg[22] &= 0xFD;
-      m_reg[22] |= ((m_reg[21]&0x01)<<1);
-      if ( m_reg[22]&0x02 )
+      STATE()->m_reg[22] &= 0xFD;
+      STATE()->m_reg[22] |= ((STATE()->m_reg[21]&0x01)<<1);
+      if ( STATE()->m_reg[22]&0x02 )
       {
-         m_irqEnabled = true;
+         STATE()->m_irqEnabled = true;
       }
       else
       {
-         m_irqEnabled = false;
+         STATE()->m_irqEnabled = false;
       }
       break;
    case 0xF002:
       reg = 22;
-      m_reg[22] = data;
+      STATE()->m_reg[22] = data;
       C6502::RELEASEIRQ(eNESSource_Mapper);
-      if ( m_reg[21]&0x02 )
+      if ( STATE()->m_reg[21]&0x02 )
       {
-         m_irqCounter = m_irqReload;
-         m_irqPrescaler = 0;
-         m_irqPrescalerPhase = 0;
-         m_irqEnabled = true;
+         STATE()->m_irqCounter = STATE()->m_irqReload;
+         STATE()->m_irqPrescaler = 0;
+         STATE()->m_irqPrescalerPhase = 0;
+         STATE()->m_irqEnabled = true;
       }
       else
       {
-         m_irqEnabled = false;
+         STATE()->m_irqEnabled = false;
       }
       break;
    }
@@ -21,50 +21,55 @@ public:
    // Note: called directly!
    static uint32_t REGSEL ( void )
    {
-      return m_reg_sel;
+      return STATE()->m_reg_sel;
    }
    static uint32_t PRGMODE ( void )
    {
-      return m_prg_mode;
+      return STATE()->m_prg_mode;
    }
    static uint32_t PRGSIZE ( void )
    {
-      return m_prg_size;
+      return STATE()->m_prg_size;
    }
    static uint32_t PRGOUTERBANK ( void )
    {
-      return m_prg_outer_bank;
+      return STATE()->m_prg_outer_bank;
    }
    static uint32_t PRGINNERBANK ( void )
    {
-      return m_prg_inner_bank;
+      return STATE()->m_prg_inner_bank;
    }
    static uint32_t CHRBANK ( void )
    {
-      return m_chr_bank;
+      return STATE()->m_chr_bank;
    }
 
 protected:
-   // Streemerz Collection mapper
-   static uint8_t m_reg_sel;	//register select S: supervisor=1/user=0 (D7),  R: register select (D0)
-   //In a multicart, registers $00 and $01 change the bank within a game, and registers $80 and $81
-   //remain constant throughout a given game's execution.
+   friend struct NESContext;
+   struct State
+   {
+      // Streemerz Collection mapper
+      uint8_t m_reg_sel = 0x00;	//register select S: supervisor=1/user=0 (D7),  R: register select (D0)
+      //In a multicart, registers $00 and $01 change the bank within a game, and registers $80 and $81
+      //remain constant throughout a given game's execution.
 
-   //$00 CHR bank:	used for CNROM, and one screen mirroring
-   static uint8_t m_chr_bank;	//D1-0 set CHR RAM A14-13
+      //$00 CHR bank:	used for CNROM, and one screen mirroring
+      uint8_t m_chr_bank = 0x00;	//D1-0 set CHR RAM A14-13
 
-   //$01 Inner bank: prg bank for A/B/UxROM etc.
-   static uint8_t m_prg_inner_bank;	//D4-0 set PRG ROM A14/15 and up for single game in game use
+      //$01 Inner bank: prg bank for A/B/UxROM etc.
+      uint8_t m_prg_inner_bank = 0x00;	//D4-0 set PRG ROM A14/15 and up for single game in game use
 
-   //$80 Mode: used by multicart supervisor software
-   static uint8_t m_prg_size;	//D5-4	0: 32KB, 1: 64KB, 2:128KB, 3:256KB
-   static uint8_t m_prg_mode;	//D3-2	0,1: current 32KB @ $8000, 2: UNROM standard, 3: UNROM #180
-   static uint8_t m_mirror;	//D1-0	0: 1scn lower, 1: 1scn upper, 2: vert, 3: horiz
+      //$80 Mode: used by multicart supervisor software
+      uint8_t m_prg_size = 0x00;	//D5-4	0: 32KB, 1: 64KB, 2:128KB, 3:256KB
+      uint8_t m_prg_mode = 0x00;	//D3-2	0,1: current 32KB @ $8000, 2: UNROM standard, 3: UNROM #180
+      uint8_t m_mirror = 0x00;	//D1-0	0: 1scn lower, 1: 1scn upper, 2: vert, 3: horiz
 
-   //$81 Outer bank: sets the upper PRG ROM bits to select current game
-   static uint8_t m_prg_outer_bank;	//sets PRG ROM A15-20
+      //$81 Outer bank: sets the upper PRG ROM bits to select current game
+      uint8_t m_prg_outer_bank = 0x00;	//sets PRG ROM A15-20
 
-   static uint8_t m_bank_size_mask[4];
+      uint8_t m_bank_size_mask[4] = { 0x1, 0x3, 0x7, 0xF };
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -18,6 +18,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 033 Registers
 static CBitfieldData* tbl8000Bitfields [] =
@@ -85,8 +86,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,8,8,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper033::m_reg[8] = { 0x00, };
-
 CROMMapper033::CROMMapper033()
 {
 }
@@ -97,16 +96,16 @@ CROMMapper033::~CROMMapper033()
 
 void CROMMapper033::RESET ( bool soft )
 {
-   m_mapper = 33;
+   CROM::STATE()->m_mapper = 33;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
@@ -116,28 +115,28 @@ uint32_t CROMMapper033::DEBUGINFO ( uint32_t addr )
    switch ( addr&0xA003 )
    {
    case 0x8000:
-      return m_reg[0];
+      return STATE()->m_reg[0];
       break;
    case 0x8001:
-      return m_reg[1];
+      return STATE()->m_reg[1];
       break;
    case 0x8002:
-      return m_reg[2];
+      return STATE()->m_reg[2];
       break;
    case 0x8003:
-      return m_reg[3];
+      return STATE()->m_reg[3];
       break;
    case 0xA000:
-      return m_reg[4];
+      return STATE()->m_reg[4];
       break;
    case 0xA001:
-      return m_reg[5];
+      return STATE()->m_reg[5];
       break;
    case 0xA002:
-      return m_reg[6];
+      return STATE()->m_reg[6];
       break;
    case 0xA003:
-      return m_reg[7];
+      return STATE()->m_reg[7];
       break;
    }
    return 0;
@@ -150,8 +149,8 @@ void CROMMapper033::HMAPPER ( uint32_t addr, uint8_t data )
    switch ( addr&0xA003 )
    {
    case 0x8000:
-      m_reg[0] = data;
-      if ( m_reg[0]&0x40 )
+      STATE()->m_reg[0] = data;
+      if ( STATE()->m_reg[0]&0x40 )
       {
          CPPU::MIRRORHORIZ ();
       }
@@ -159,39 +158,39 @@ void CROMMapper033::HMAPPER ( uint32_t addr, uint8_t data )
       {
          CPPU::MIRRORVERT ();
       }
-      bank = (m_reg[0]&0x3F)%m_numPrgBanks;
-      m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ bank ];
+      bank = (STATE()->m_reg[0]&0x3F)%CROM::STATE()->m_numPrgBanks;
+      CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ bank ];
       break;
    case 0x8001:
-      m_reg[1] = data;
-      bank = (m_reg[1]&0x3F)%m_numPrgBanks;
-      m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ bank ];
+      STATE()->m_reg[1] = data;
+      bank = (STATE()->m_reg[1]&0x3F)%CROM::STATE()->m_numPrgBanks;
+      CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ bank ];
       break;
    case 0x8002:
-      m_reg[2] = data;
-      m_pCHRmemory [ 0 ] = m_CHRmemory [ (m_reg[2]<<1)+0 ];
-      m_pCHRmemory [ 1 ] = m_CHRmemory [ (m_reg[2]<<1)+1 ];
+      STATE()->m_reg[2] = data;
+      CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg[2]<<1)+0 ];
+      CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg[2]<<1)+1 ];
       break;
    case 0x8003:
-      m_reg[3] = data;
-      m_pCHRmemory [ 2 ] = m_CHRmemory [ (m_reg[3]<<1)+0 ];
-      m_pCHRmemory [ 3 ] = m_CHRmemory [ (m_reg[3]<<1)+1 ];
+      STATE()->m_reg[3] = data;
+      CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg[3]<<1)+0 ];
+      CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ (STATE()->m_reg[3]<<1)+1 ];
       break;
    case 0xA000:
-      m_reg[4] = data;
-      m_pCHRmemory [ 4 ] = m_CHRmemory [ m_reg[4] ];
+      STATE()->m_reg[4] = data;
+      CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_reg[4] ];
       break;
    case 0xA001:
-      m_reg[5] = data;
-      m_pCHRmemory [ 5 ] = m_CHRmemory [ m_reg[5] ];
+      STATE()->m_reg[5] = data;
+      CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_reg[5] ];
       break;
    case 0xA002:
-      m_reg[6] = data;
-      m_pCHRmemory [ 6 ] = m_CHRmemory [ m_reg[6] ];
+      STATE()->m_reg[6] = data;
+      CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_reg[6] ];
       break;
    case 0xA003:
-      m_reg[7] = data;
-      m_pCHRmemory [ 7 ] = m_CHRmemory [ m_reg[7] ];
+      STATE()->m_reg[7] = data;
+      CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_reg[7] ];
       break;
    }
 
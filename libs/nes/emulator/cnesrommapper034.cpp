@@ -17,6 +17,7 @@
 #include "cnesrommapper034.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 034 Registers
 static CBitfieldData* tbl8000_FFFFBitfields [] =
@@ -62,8 +63,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,4,4,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper034::m_reg[] = { 0x00, };
-
 CROMMapper034::CROMMapper034()
 {
 }
@@ -74,16 +73,16 @@ CROMMapper034::~CROMMapper034()
 
 void CROMMapper034::RESET ( bool soft )
 {
-   m_mapper = 34;
+   CROM::STATE()->m_mapper = 34;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ 2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ 3 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ 2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ 3 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
@@ -92,7 +91,7 @@ uint32_t CROMMapper034::LMAPPER ( uint32_t addr )
 {
    if ( (addr >= 0x7ffd) && (addr < 0x8000) )
    {
-      return m_reg[addr-0x7ffd];
+      return STATE()->m_reg[addr-0x7ffd];
    }
    else if ( addr >= 0x6000 )
    {
@@ -106,33 +105,33 @@ void CROMMapper034::LMAPPER ( uint32_t addr, uint8_t data )
 
    if ( (addr >= 0x7ffd) && (addr < 0x8000) )
    {
-      m_reg[addr-0x7ffd] = data;
+      STATE()->m_reg[addr-0x7ffd] = data;
 
       switch ( addr )
       {
       case 0x7ffd:
-         bank = (m_reg[0]&(m_numPrgBanks-1))<<2;
+         bank = (STATE()->m_reg[0]&(CROM::STATE()->m_numPrgBanks-1))<<2;
 
-         m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ bank+0 ];
-         m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ bank+1 ];
-         m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ bank+2 ];
-         m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ bank+3 ];
+         CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ bank+0 ];
+         CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ bank+1 ];
+         CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ bank+2 ];
+         CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ bank+3 ];
          break;
       case 0x7ffe:
-         bank = (m_reg[1]&((m_numChrBanks<<1)-1));
+         bank = (STATE()->m_reg[1]&((CROM::STATE()->m_numChrBanks<<1)-1));
 
-         m_pCHRmemory [ 0 ] = m_CHRmemory [ (bank<<2)+0 ];
-         m_pCHRmemory [ 1 ] = m_CHRmemory [ (bank<<2)+1 ];
-         m_pCHRmemory [ 2 ] = m_CHRmemory [ (bank<<2)+2 ];
-         m_pCHRmemory [ 3 ] = m_CHRmemory [ (bank<<2)+3 ];
+         CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ (bank<<2)+0 ];
+         CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ (bank<<2)+1 ];
+         CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ (bank<<2)+2 ];
+         CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ (bank<<2)+3 ];
          break;
       case 0x7fff:
-         bank = (m_reg[2]&((m_numChrBanks<<1)-1));
+         bank = (STATE()->m_reg[2]&((CROM::STATE()->m_numChrBanks<<1)-1));
 
-         m_pCHRmemory [ 4 ] = m_CHRmemory [ (bank<<2)+0 ];
-         m_pCHRmemory [ 5 ] = m_CHRmemory [ (bank<<2)+1 ];
-         m_pCHRmemory [ 6 ] = m_CHRmemory [ (bank<<2)+2 ];
-         m_pCHRmemory [ 7 ] = m_CHRmemory [ (bank<<2)+3 ];
+         CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ (bank<<2)+0 ];
+         CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ (bank<<2)+1 ];
+         CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ (bank<<2)+2 ];
+         CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ (bank<<2)+3 ];
          break;
       }
 
@@ -150,21 +149,21 @@ void CROMMapper034::LMAPPER ( uint32_t addr, uint8_t data )
 
 uint32_t CROMMapper034::DEBUGINFO ( uint32_t addr )
 {
-   return m_reg[3];
+   return STATE()->m_reg[3];
 }
 
 void CROMMapper034::HMAPPER ( uint32_t addr, uint8_t data )
 {
    uint8_t bank;
 
-   m_reg[3] = data%m_numPrgBanks;
+   STATE()->m_reg[3] = data%CROM::STATE()->m_numPrgBanks;
 
-   bank = m_reg[3]<<2;
+   bank = STATE()->m_reg[3]<<2;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ bank ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ bank+1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ bank+2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ bank+3 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ bank ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ bank+1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ bank+2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ bank+3 ];
 
    if ( nesIsDebuggable() )
    {
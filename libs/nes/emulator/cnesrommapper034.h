@@ -16,7 +16,12 @@ public:
    static uint32_t DEBUGINFO ( uint32_t addr );
 
 protected:
-   static uint8_t  m_reg[4];
+   friend struct NESContext;
+   struct State
+   {
+      uint8_t  m_reg[4] = { 0x00, };
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -18,6 +18,7 @@
 
 #include "cnes6502.h"
 #include "cnesppu.h"
+#include "cnescontext.h"
 
 // Mapper 068 Registers
 static CBitfieldData* tbl8000Bitfields [] =
@@ -87,12 +88,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,16,16,tblRegisters,rowHeadings,columnHeadings);
 
-// Irem H-3001 stuff
-uint8_t  CROMMapper065::m_reg [] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
-uint8_t  CROMMapper065::m_irqCounter = 0x00;
-bool           CROMMapper065::m_irqEnable = false;
-uint16_t CROMMapper065::m_irqReload = 0;
-
 CROMMapper065::CROMMapper065()
 {
 }
@@ -103,30 +98,30 @@ CROMMapper065::~CROMMapper065()
 
 void CROMMapper065::RESET ( bool soft )
 {
-   m_mapper = 65;
+   CROM::STATE()->m_mapper = 65;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_irqCounter = 0x00;
-   m_irqEnable = false;
+   STATE()->m_irqCounter = 0x00;
+   STATE()->m_irqEnable = false;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
 
 void CROMMapper065::SYNCCPU ( void )
 {
-   if ( m_irqEnable )
+   if ( STATE()->m_irqEnable )
    {
-      if ( m_irqCounter == 0 )
+      if ( STATE()->m_irqCounter == 0 )
       {
-         m_irqEnable = false;
+         STATE()->m_irqEnable = false;
          C6502::ASSERTIRQ ( eNESSource_Mapper );
 
          if ( nesIsDebuggable() )
@@ -137,7 +132,7 @@ void CROMMapper065::SYNCCPU ( void )
       }
       else
       {
-         m_irqCounter--;
+         STATE()->m_irqCounter--;
       }
    }
 }
@@ -147,52 +142,52 @@ uint32_t CROMMapper065::DEBUGINFO ( uint32_t addr )
    switch ( addr )
    {
       case 0x8000:
-         return m_reg [ 0 ];
+         return STATE()->m_reg [ 0 ];
          break;
       case 0x9001:
-         return m_reg [ 1 ];
+         return STATE()->m_reg [ 1 ];
          break;
       case 0x9003:
-         return m_reg [ 2 ];
+         return STATE()->m_reg [ 2 ];
          break;
       case 0x9004:
-         return m_reg [ 3 ];
+         return STATE()->m_reg [ 3 ];
          break;
       case 0x9005:
-         return m_reg [ 4 ];
+         return STATE()->m_reg [ 4 ];
          break;
       case 0x9006:
-         return m_reg [ 5 ];
+         return STATE()->m_reg [ 5 ];
          break;
       case 0xA000:
-         return m_reg [ 6 ];
+         return STATE()->m_reg [ 6 ];
          break;
       case 0xB000:
-         return m_reg [ 7 ];
+         return STATE()->m_reg [ 7 ];
          break;
       case 0xB001:
-         return m_reg [ 8 ];
+         return STATE()->m_reg [ 8 ];
          break;
       case 0xB002:
-         return m_reg [ 9 ];
+         return STATE()->m_reg [ 9 ];
          break;
       case 0xB003:
-         return m_reg [ 10 ];
+         return STATE()->m_reg [ 10 ];
          break;
       case 0xB004:
-         return m_reg [ 11 ];
+         return STATE()->m_reg [ 11 ];
          break;
       case 0xB005:
-         return m_reg [ 12 ];
+         return STATE()->m_reg [ 12 ];
          break;
       case 0xB006:
-         return m_reg [ 13 ];
+         return STATE()->m_reg [ 13 ];
          break;
       case 0xB007:
-         return m_reg [ 14 ];
+         return STATE()->m_reg [ 14 ];
          break;
       case 0xC000:
-         return m_reg [ 15 ];
+         return STATE()->m_reg [ 15 ];
          break;
    }
 
@@ -204,11 +199,11 @@ void CROMMapper065::HMAPPER ( uint32_t addr, uint8_t data )
    switch ( addr )
    {
       case 0x8000:
-         m_reg [ 0 ] = data;
-         m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ data ];
+         STATE()->m_reg [ 0 ] = data;
+         CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ data ];
          break;
       case 0x9001:
-         m_reg [ 1 ] = data;
+         STATE()->m_reg [ 1 ] = data;
          if ( data&0x80 )
          {
             CPPU::MIRRORHORIZ();
@@ -219,62 +214,62 @@ void CROMMapper065::HMAPPER ( uint32_t addr, uint8_t data )
          }
          break;
       case 0x9003:
-         m_reg [ 2 ] = data;
-         m_irqEnable = (data&0x80);
+         STATE()->m_reg [ 2 ] = data;
+         STATE()->m_irqEnable = (data&0x80);
          break;
       case 0x9004:
-         m_reg [ 3 ] = data;
-         m_irqCounter = m_irqReload;
+         STATE()->m_reg [ 3 ] = data;
+         STATE()->m_irqCounter = STATE()->m_irqReload;
          break;
       case 0x9005:
-         m_reg [ 4 ] = data;
-         m_irqReload &= 0x00FF;
-         m_irqReload |= (data<<8);
+         STATE()->m_reg [ 4 ] = data;
+         STATE()->m_irqReload &= 0x00FF;
+         STATE()->m_irqReload |= (data<<8);
          break;
       case 0x9006:
-         m_reg [ 5 ] = data;
-         m_irqReload &= 0xFF00;
-         m_irqReload |= data;
+         STATE()->m_reg [ 5 ] = data;
+         STATE()->m_irqReload &= 0xFF00;
+         STATE()->m_irqReload |= data;
          break;
       case 0xA000:
-         m_reg [ 6 ] = data;
-         m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ data ];
+         STATE()->m_reg [ 6 ] = data;
+         CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ data ];
          break;
       case 0xB000:
-         m_reg [ 7 ] = data;
-         m_pCHRmemory [ 0 ] = m_CHRmemory [ data ];
+         STATE()->m_reg [ 7 ] = data;
+         CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ data ];
          break;
       case 0xB001:
-         m_reg [ 8 ] = data;
-         m_pCHRmemory [ 1 ] = m_CHRmemory [ data ];
+         STATE()->m_reg [ 8 ] = data;
+         CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ data ];
          break;
       case 0xB002:
-         m_reg [ 9 ] = data;
-         m_pCHRmemory [ 2 ] = m_CHRmemory [ data ];
+         STATE()->m_reg [ 9 ] = data;
+         CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ data ];
          break;
       case 0xB003:
-         m_reg [ 10 ] = data;
-         m_pCHRmemory [ 3 ] = m_CHRmemory [ data ];
+         STATE()->m_reg [ 10 ] = data;
+         CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ data ];
          break;
       case 0xB004:
-         m_reg [ 11 ] = data;
-         m_pCHRmemory [ 4 ] = m_CHRmemory [ data ];
+         STATE()->m_reg [ 11 ] = data;
+         CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ data ];
          break;
       case 0xB005:
-         m_reg [ 12 ] = data;
-         m_pCHRmemory [ 5 ] = m_CHRmemory [ data ];
+         STATE()->m_reg [ 12 ] = data;
+         CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ data ];
          break;
       case 0xB006:
-         m_reg [ 13 ] = data;
-         m_pCHRmemory [ 6 ] = m_CHRmemory [ data ];
+         STATE()->m_reg [ 13 ] = data;
+         CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ data ];
          break;
       case 0xB007:
-         m_reg [ 14 ] = data;
-         m_pCHRmemory [ 7 ] = m_CHRmemory [ data ];
+         STATE()->m_reg [ 14 ] = data;
+         CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ data ];
          break;
       case 0xC000:
-         m_reg [ 15 ] = data;
-         m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ data ];
+         STATE()->m_reg [ 15 ] = data;
+         CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ data ];
          break;
    }
 }
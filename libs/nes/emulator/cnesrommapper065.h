@@ -15,11 +15,16 @@ public:
    static uint32_t DEBUGINFO ( uint32_t addr );
 
 protected:
-   // Irem H-3001
-   static uint8_t  m_reg [ 16 ];
-   static uint8_t  m_irqCounter;
-   static bool           m_irqEnable;
-   static uint16_t m_irqReload;
+   friend struct NESContext;
+   struct State
+   {
+      // Irem H-3001
+      uint8_t  m_reg [ 16 ] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+      uint8_t  m_irqCounter = 0x00;
+      bool           m_irqEnable = false;
+      uint16_t m_irqReload = 0;
+   };
+   static inline State* STATE ();
 };
 
 #endif
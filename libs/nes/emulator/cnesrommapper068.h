@@ -14,8 +14,13 @@ public:
    static uint32_t DEBUGINFO ( uint32_t addr );
 
 protected:
-   // Sunsoft Mapper #4
-   static uint8_t  m_reg [ 8 ];
+   friend struct NESContext;
+   struct State
+   {
+      // Sunsoft Mapper #4
+      uint8_t  m_reg [ 8 ] = { 0x00, };
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -19,6 +19,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 069 Registers
 static CBitfieldData* tbl8000Bitfields [] =
@@ -61,17 +62,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,4,4,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper069::m_reg [] = { 0x00, 0x00, 0x00, 0x00 };
-uint8_t  CROMMapper069::m_subReg [];
-bool           CROMMapper069::m_irqAsserted = false;
-uint16_t  CROMMapper069::m_irqCounter = 0x0000;
-bool           CROMMapper069::m_irqEnable = false;
-bool           CROMMapper069::m_irqCountEnable = false;
-uint8_t  CROMMapper069::m_prg [ 4 ] = { 0, 0, 0, 0 };
-uint8_t  CROMMapper069::m_chr [ 8 ] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-bool     CROMMapper069::m_sramAreaIsSram = false;
-bool     CROMMapper069::m_sramAreaEnabled = false;
-
 CROMMapper069::CROMMapper069()
 {
 }
@@ -84,52 +74,52 @@ void CROMMapper069::RESET ( bool soft )
 {
    int32_t idx;
 
-   m_mapper = 69;
+   CROM::STATE()->m_mapper = 69;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
    for ( idx = 0; idx < 4; idx++ )
    {
-      m_reg [ idx ] = 0x00;
-      m_prg [ idx ] = 0;
+      STATE()->m_reg [ idx ] = 0x00;
+      STATE()->m_prg [ idx ] = 0;
    }
 
    for ( idx = 0; idx < 8; idx++ )
    {
-      m_chr [ idx ] = 0;
+      STATE()->m_chr [ idx ] = 0;
    }
 
-   m_irqCounter = 0x0000;
-   m_irqEnable = false;
-   m_irqCountEnable = false;
-   m_irqAsserted = false;
+   STATE()->m_irqCounter = 0x0000;
+   STATE()->m_irqEnable = false;
+   STATE()->m_irqCountEnable = false;
+   STATE()->m_irqAsserted = false;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
-   m_sramAreaIsSram = false;
-   m_sramAreaEnabled = false;
+   STATE()->m_sramAreaIsSram = false;
+   STATE()->m_sramAreaEnabled = false;
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
 
 void CROMMapper069::SYNCCPU ( void )
 {
-   uint32_t prevCounter = m_irqCounter;
+   uint32_t prevCounter = STATE()->m_irqCounter;
 
-   if ( m_irqCountEnable )
+   if ( STATE()->m_irqCountEnable )
    {
-      m_irqCounter--;
+      STATE()->m_irqCounter--;
    }
 
-   if ( m_irqEnable && (!prevCounter) )
+   if ( STATE()->m_irqEnable && (!prevCounter) )
    {
       C6502::ASSERTIRQ ( eNESSource_Mapper );
-      m_irqAsserted = true;
+      STATE()->m_irqAsserted = true;
 
       if ( nesIsDebuggable() )
       {
@@ -141,39 +131,39 @@ void CROMMapper069::SYNCCPU ( void )
 
 void CROMMapper069::SETCPU ( void )
 {
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ m_prg[1] ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ m_prg[2] ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_prg[3] ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ STATE()->m_prg[1] ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ STATE()->m_prg[2] ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ STATE()->m_prg[3] ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 }
 
 void CROMMapper069::SETPPU ( void )
 {
-   m_pCHRmemory [ 0 ] = m_CHRmemory [ m_chr[0] ];
-   m_pCHRmemory [ 1 ] = m_CHRmemory [ m_chr[1] ];
-   m_pCHRmemory [ 2 ] = m_CHRmemory [ m_chr[2] ];
-   m_pCHRmemory [ 3 ] = m_CHRmemory [ m_chr[3] ];
-   m_pCHRmemory [ 4 ] = m_CHRmemory [ m_chr[4] ];
-   m_pCHRmemory [ 5 ] = m_CHRmemory [ m_chr[5] ];
-   m_pCHRmemory [ 6 ] = m_CHRmemory [ m_chr[6] ];
-   m_pCHRmemory [ 7 ] = m_CHRmemory [ m_chr[7] ];
+   CROM::STATE()->m_pCHRmemory [ 0 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_chr[0] ];
+   CROM::STATE()->m_pCHRmemory [ 1 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_chr[1] ];
+   CROM::STATE()->m_pCHRmemory [ 2 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_chr[2] ];
+   CROM::STATE()->m_pCHRmemory [ 3 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_chr[3] ];
+   CROM::STATE()->m_pCHRmemory [ 4 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_chr[4] ];
+   CROM::STATE()->m_pCHRmemory [ 5 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_chr[5] ];
+   CROM::STATE()->m_pCHRmemory [ 6 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_chr[6] ];
+   CROM::STATE()->m_pCHRmemory [ 7 ] = CROM::STATE()->m_CHRmemory [ STATE()->m_chr[7] ];
 }
 
 uint32_t CROMMapper069::DEBUGINFO ( uint32_t addr )
 {
-   return m_reg [ ((addr-MEM_32KB)/MEM_8KB) ];
+   return STATE()->m_reg [ ((addr-MEM_32KB)/MEM_8KB) ];
 }
 
 void CROMMapper069::HMAPPER ( uint32_t addr, uint8_t data )
 {
    int32_t reg = ((addr-0x8000)/MEM_8KB);
-   m_reg [ reg ] = data;
+   STATE()->m_reg [ reg ] = data;
 
    switch ( addr&0xE000 )
    {
       case 0xA000:
-         m_subReg [ m_reg[0]&0xF ] = data;
-         switch ( m_reg[0]&0xF )
+         STATE()->m_subReg [ STATE()->m_reg[0]&0xF ] = data;
+         switch ( STATE()->m_reg[0]&0xF )
          {
             case 0x00:
             case 0x01:
@@ -183,26 +173,26 @@ void CROMMapper069::HMAPPER ( uint32_t addr, uint8_t data )
             case 0x05:
             case 0x06:
             case 0x07:
-               m_chr [ m_reg[0]&0xF ] = data;
+               STATE()->m_chr [ STATE()->m_reg[0]&0xF ] = data;
                SETPPU ();
                break;
             case 0x08:
-               m_sramAreaIsSram = (data&0x40);
-               m_sramAreaEnabled = (data&0x80);
-               if ( m_sramAreaIsSram )
+               STATE()->m_sramAreaIsSram = (data&0x40);
+               STATE()->m_sramAreaEnabled = (data&0x80);
+               if ( STATE()->m_sramAreaIsSram )
                {
-                  m_prg[0] = (data&0x3F)%NUM_SRAM_BANKS;
-                  CROM::REMAPSRAM(0x6000,m_prg[0]);
+                  STATE()->m_prg[0] = (data&0x3F)%NUM_SRAM_BANKS;
+                  CROM::REMAPSRAM(0x6000,STATE()->m_prg[0]);
                }
                else
                {
-                  m_prg[0] = (data&0x3F)%m_numPrgBanks;
+                  STATE()->m_prg[0] = (data&0x3F)%CROM::STATE()->m_numPrgBanks;
                }
                break;
             case 0x09:
             case 0x0A:
             case 0x0B:
-               m_prg [ (m_reg[0]&0xF)-8 ] = data%m_numPrgBanks;
+               STATE()->m_prg [ (STATE()->m_reg[0]&0xF)-8 ] = data%CROM::STATE()->m_numPrgBanks;
                SETCPU ();
                break;
             case 0x0C:
@@ -223,21 +213,21 @@ void CROMMapper069::HMAPPER ( uint32_t addr, uint8_t data )
                }
                break;
             case 0x0D:
-               m_irqEnable = (data&0x01);
-               if ( !m_irqEnable )
+               STATE()->m_irqEnable = (data&0x01);
+               if ( !STATE()->m_irqEnable )
                {
-                  m_irqAsserted = false;
+                  STATE()->m_irqAsserted = false;
                   C6502::RELEASEIRQ(eNESSource_Mapper);
                }
-               m_irqCountEnable = (data&0x80);
+               STATE()->m_irqCountEnable = (data&0x80);
                break;
             case 0x0E:
-               m_irqCounter &= 0xFF00;
-               m_irqCounter |= data;
+               STATE()->m_irqCounter &= 0xFF00;
+               STATE()->m_irqCounter |= data;
                break;
             case 0x0F:
-               m_irqCounter &= 0x00FF;
-               m_irqCounter |= (data<<8);
+               STATE()->m_irqCounter &= 0x00FF;
+               STATE()->m_irqCounter |= (data<<8);
                break;
          }
 
@@ -260,13 +250,13 @@ uint32_t CROMMapper069::LMAPPER ( uint32_t addr )
 
    if ( addr >= 0x6000 )
    {
-      if ( m_sramAreaIsSram && m_sramAreaEnabled )
+      if ( STATE()->m_sramAreaIsSram && STATE()->m_sramAreaEnabled )
       {
          data = CROM::SRAMVIRT(addr);
       }
-      else if ( !m_sramAreaIsSram )
+      else if ( !STATE()->m_sramAreaIsSram )
       {
-         data = CROM::PRGROMPHYS((m_prg[0]*MEM_8KB)+(addr-0x6000));
+         data = CROM::PRGROMPHYS((STATE()->m_prg[0]*MEM_8KB)+(addr-0x6000));
       }
    }
 
@@ -277,7 +267,7 @@ void CROMMapper069::LMAPPER ( uint32_t addr, uint8_t data )
 {
    if ( addr >= 0x6000 )
    {
-      if ( m_sramAreaIsSram && m_sramAreaEnabled )
+      if ( STATE()->m_sramAreaIsSram && STATE()->m_sramAreaEnabled )
       {
          CROM::SRAMVIRT(addr,data);
       }
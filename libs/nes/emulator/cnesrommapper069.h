@@ -22,53 +22,58 @@ public:
    // Note: called directly!
    static uint32_t IRQENABLED ( void )
    {
-      return m_irqEnable;
+      return STATE()->m_irqEnable;
    }
    static uint32_t IRQCOUNTENABLED ( void )
    {
-      return m_irqCountEnable;
+      return STATE()->m_irqCountEnable;
    }
    static uint32_t IRQASSERTED ( void )
    {
-      return m_irqAsserted;
+      return STATE()->m_irqAsserted;
    }
    static uint32_t IRQCOUNTER ( void )
    {
-      return m_irqCounter;
+      return STATE()->m_irqCounter;
    }
    static uint32_t SRAMENABLED ( void )
    {
-      return m_sramAreaEnabled;
+      return STATE()->m_sramAreaEnabled;
    }
    static uint32_t ISSRAM ( void )
    {
-      return m_sramAreaIsSram;
+      return STATE()->m_sramAreaIsSram;
    }
    static uint32_t SRAMPRGBANK ( void )
    {
-      return m_prg[0];
+      return STATE()->m_prg[0];
    }
    static uint32_t REGSELECTED ( void )
    {
-      return m_reg[0]&0x0F;
+      return STATE()->m_reg[0]&0x0F;
    }
    static uint32_t REGVALUE ( void )
    {
-      return m_subReg[m_reg[0]&0x0F];
+      return STATE()->m_subReg[STATE()->m_reg[0]&0x0F];
    }
 
 protected:
-   // MMC3
-   static uint8_t  m_reg [ 4 ];
-   static uint8_t  m_subReg [ 16 ];
-   static bool           m_irqAsserted;
-   static uint16_t  m_irqCounter;
-   static bool           m_irqEnable;
-   static bool           m_irqCountEnable;
-   static uint8_t  m_prg [ 4 ];
-   static uint8_t  m_chr [ 8 ];
-   static bool m_sramAreaIsSram;
-   static bool m_sramAreaEnabled;
+   friend struct NESContext;
+   struct State
+   {
+      // MMC3
+      uint8_t  m_reg [ 4 ] = { 0x00, 0x00, 0x00, 0x00 };
+      uint8_t  m_subReg [ 16 ] = { 0, };
+      bool           m_irqAsserted = false;
+      uint16_t  m_irqCounter = 0x0000;
+      bool           m_irqEnable = false;
+      bool           m_irqCountEnable = false;
+      uint8_t  m_prg [ 4 ] = { 0, 0, 0, 0 };
+      uint8_t  m_chr [ 8 ] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+      bool m_sramAreaIsSram = false;
+      bool m_sramAreaEnabled = false;
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -19,6 +19,7 @@
 #include "cnesppu.h"
 
 #include "cregisterdata.h"
+#include "cnescontext.h"
 
 // Mapper 073 Registers
 static CBitfieldData* tbl8000Bitfields [] =
@@ -81,11 +82,6 @@ static const char* columnHeadings [] =
 
 static CRegisterDatabase* dbRegisters = new CRegisterDatabase(eMemory_cartMapper,1,7,7,tblRegisters,rowHeadings,columnHeadings);
 
-uint8_t  CROMMapper073::m_reg [] = { 0x00, };
-uint16_t CROMMapper073::m_irqReload = 0;
-uint16_t CROMMapper073::m_irqCounter = 0;
-bool     CROMMapper073::m_irqEnabled = false;
-
 CROMMapper073::CROMMapper073()
 {
 }
@@ -98,20 +94,20 @@ void CROMMapper073::RESET ( bool soft )
 {
    int32_t idx;
 
-   m_mapper = 73;
+   CROM::STATE()->m_mapper = 73;
 
-   m_dbRegisters = dbRegisters;
+   CROM::STATE()->m_dbRegisters = dbRegisters;
 
-   CROM::RESET ( m_mapper, soft );
+   CROM::RESET ( CROM::STATE()->m_mapper, soft );
 
-   m_irqReload = 0;
-   m_irqCounter = 0;
-   m_irqEnabled = false;
+   STATE()->m_irqReload = 0;
+   STATE()->m_irqCounter = 0;
+   STATE()->m_irqEnabled = false;
 
-   m_pPRGROMmemory [ 0 ] = m_PRGROMmemory [ 0 ];
-   m_pPRGROMmemory [ 1 ] = m_PRGROMmemory [ 1 ];
-   m_pPRGROMmemory [ 2 ] = m_PRGROMmemory [ m_numPrgBanks-2 ];
-   m_pPRGROMmemory [ 3 ] = m_PRGROMmemory [ m_numPrgBanks-1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 0 ] = CROM::STATE()->m_PRGROMmemory [ 0 ];
+   CROM::STATE()->m_pPRGROMmemory [ 1 ] = CROM::STATE()->m_PRGROMmemory [ 1 ];
+   CROM::STATE()->m_pPRGROMmemory [ 2 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-2 ];
+   CROM::STATE()->m_pPRGROMmemory [ 3 ] = CROM::STATE()->m_PRGROMmemory [ CROM::STATE()->m_numPrgBanks-1 ];
 
    // CHR ROM/RAM already set up in CROM::RESET()...
 }
@@ -121,10 +117,10 @@ void CROMMapper073::SYNCCPU ( void )
    uint16_t counterMask;
    uint16_t counter;
 
-   if ( m_irqEnabled )
+   if ( STATE()->m_irqEnabled )
    {
       // Get relevant counter bits.
-      if ( (m_reg[4]&0x04) == 0 )
+      if ( (STATE()->m_reg[4]&0x04) == 0 )
       {
          // 16 bits
          counterMask = 0xFFFF;
@@ -135,16 +131,16 @@ void CROMMapper073::SYNCCPU ( void )
          counterMask = 0x00FF;
       }
 
-      counter = m_irqCounter&counterMask;
+      counter = STATE()->m_irqCounter&counterMask;
       counter++;
-      m_irqCounter &= (~counterMask);
-      m_irqCounter |= (counter&counterMask);
+      STATE()->m_irqCounter &= (~counterMask);
+      STATE()->m_irqCounter |= (counter&counterMask);
 
-      if ( (m_irqCounter&counterMask) == 0 )
+      if ( (STATE()->m_irqCounter&counterMask) == 0 )
       {
          // Reload!
-         m_irqCounter &= (~counterMask);
-         m_irqCounter |= m_irqReload&counterMask;
+         STATE()->m_irqCounter &= (~counterMask);
+         STATE()->m_irqCounter |= STATE()->m_irqReload&counterMask;
 
          C6502::ASSERTIRQ(eNESSource_Mapper);
 
@@ -162,25 +158,25 @@ uint32_t CROMMapper073::DEBUGINFO ( uint32_t addr )
    switch ( addr )
    {
    case 0x8000:
-      return m_reg[0];
+      return STATE()->m_reg[0];
       break;
    case 0x9000:
-      return m_reg[1];
+      return STATE()->m_reg[1];
       break;
    case 0xA000:
-      return m_reg[2];
+      return STATE()->m_reg[2];
       break;
    case 0xB000:
-      return m_reg[3];
+      return STATE()->m_reg[3];
       break;
    case 0xC000:
-      return m_reg[4];
+      return STATE()->m_reg[4];
       break;
    case 0xD000:
-      return m_reg[5];
+      return STATE()->m_reg[5];
       break;
    case 0xF000:
-      return m_reg[6];
+      return STATE()->m_reg[6];
       break;
    }
 }
@@ -193,55 +189,55 @@ void CROMMapper073::HMAPPER ( uint32_t addr, uint8_t data )
    {
    case 0x8000:
       reg = 0;
-      m_reg[0] = data;
-      m_irqReload &= 0xFFF0;
-      m_irqReload |= (data&0x0F);
+      STATE()->m_reg[0] = data;
+      STATE()->m_irqReload &= 0xFFF0;
+      STATE()->m_irqReload |= (data&0x0F);
       break;
    case 0x9000:
       reg = 1;
-      m_reg[1] = data;
-      m_irqReload &= 0xFF0F;
-      m_irqReload |= ((data&0x0F)<<4);
+      STATE()->m_reg[1] = data;
+      STATE()->m_irqReload &= 0xFF0F;
+      STATE()->m_irqReload |= ((data&0x0F)<<4);
       break;
    case 0xA000:
       reg = 2;
-      m_reg[2] = data;
-      m_irqReload &= 0xF0FF;
-      m_irqReload |= ((data&0x0F)<<8);
+      STATE()->m_reg[2] = data;
+      STATE()->m_irqReload &= 0xF0FF;
+      STATE()->m_irqReload |= ((data&0x0F)<<8);
       break;
    case 0xB000:
       reg = 3;
-      m_reg[3] = data;
-      m_irqReload &= 0x0FFF;
-      m_irqReload |= ((data&0x0F)<<12);
+      STATE()->m_reg[3] = data;
+      STATE()->m_irqReload &= 0x0FFF;
+      STATE()->m_irqReload |= ((data&0x0F)<<12);
       break;
    case 0xC000:
       reg = 4;
-      m_reg[4] = data;
-      m_irqCounter = m_irqReload;
-      m_irqEnabled = data&0x02;
+      STATE()->m_reg[4] = data;
+      STATE()->m_irqCounter = STATE()->m_irqReload;
+      STATE()->m_irqEnabled = data&0x02;
       C6502::RELEASEIRQ(eNESSource_Mapper);
       break;
    case 0xD000:
       reg = 5;
-      m_reg[5] = data;
-      m_reg[4] &= 0xFD;
-      m_reg[4] |= ((m_reg[4]&0x01)<<1);
-      if ( m_reg[4]&0x02 )
+      STATE()->m_reg[5] = data;
+      STATE()->m_reg[4] &= 0xFD;
+      STATE()->m_reg[4] |= ((STATE()->m_reg[4]&0x01)<<1);
+      if ( STATE()->m_reg[4]&0x02 )
       {
-         m_irqEnabled = true;
+         STATE()->m_irqEnabled = true;
       }
       else
       {
-         m_irqEnabled = false;
+         STATE()->m_irqEnabled = false;
       }
       C6502::RELEASEIRQ(eNESSource_Mapper);
       break;
    case 0xF000:
       reg = 6;
-      m_reg[6] = data;
-      m_pPRGROMmemory[0] = m_PRGROMmemory[((data<<1)%m_numPrgBanks)+0];
-      m_pPRGROMmemory[1] = m_PRGROMmemory[((data<<1)%m_numPrgBanks)+1];
+      STATE()->m_reg[6] = data;
+      CROM::STATE()->m_pPRGROMmemory[0] = CROM::STATE()->m_PRGROMmemory[((data<<1)%CROM::STATE()->m_numPrgBanks)+0];
+      CROM::STATE()->m_pPRGROMmemory[1] = CROM::STATE()->m_PRGROMmemory[((data<<1)%CROM::STATE()->m_numPrgBanks)+1];
       break;
    }
 
@@ -15,11 +15,16 @@ public:
    static uint32_t DEBUGINFO ( uint32_t addr );
 
 protected:
-   // VRC3
-   static uint8_t  m_reg [ 7 ];
-   static uint16_t m_irqReload;
-   static uint16_t m_irqCounter;
-   static bool     m_irqEnabled;
+   friend struct NESContext;
+   struct State
+   {
+      // VRC3
+      uint8_t  m_reg [ 7 ] = { 0x00, };
+      uint16_t m_irqReload = 0;
+      uint16_t m_irqCounter = 0;
+      bool     m_irqEnabled = false;
+   };
+   static inline State* STATE ();
 };
 
 #endif
@@ -0,0 +1,284 @@
+//    NESICIDE - an IDE for the 8-bit NES.
+//    Copyright (C) 2009  Christopher S. Pow
+
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "cnesstate.h"
+
+CNESStateWriter::CNESStateWriter ( uint8_t* buffer, uint32_t size, bool pack )
+   : m_buffer(buffer),
+     m_size(size),
+     m_pos(STATE_HEADER_SIZE),
+     m_chunk(0),
+     m_pack(pack),
+     m_overflow(false)
+{
+   if ( m_buffer && (m_size < STATE_HEADER_SIZE) )
+   {
+      m_overflow = true;
+   }
+}
+
+void CNESStateWriter::BYTES ( const void* data, uint32_t size )
+{
+   if ( m_buffer && !m_overflow )
+   {
+      if ( m_pos+size <= m_size )
+      {
+         memcpy(m_buffer+m_pos,data,size);
+      }
+      else
+      {
+         m_overflow = true;
+      }
+   }
+   m_pos += size;
+}
+
+void CNESStateWriter::BEGIN ( const char* id, uint16_t version )
+{
+   m_chunk = m_pos;
+   BYTES ( id, 4 );
+   VALUE<uint16_t> ( version );
+   VALUE<uint16_t> ( m_pack?STATE_CHUNK_PACKED:0 );
+   VALUE<uint32_t> ( 0 ); // Length, filled in by END.
+}
+
+void CNESStateWriter::END ( void )
+{
+   uint32_t length = m_pos-m_chunk-STATE_CHUNK_HEADER_SIZE;
+
+   if ( m_buffer && !m_overflow )
+   {
+      memcpy(m_buffer+m_chunk+8,&length,sizeof(length));
+   }
+}
+
+void CNESStateWriter::MEMORY ( const uint8_t* data, uint32_t size )
+{
+   if ( !m_buffer )
+   {
+      // Worst case for PackBits is one control byte per 128 literals.
+      m_pos += size+((size+127)>>7);
+   }
+   else if ( m_pack )
+   {
+      PACK ( data, size );
+   }
+   else
+   {
+      BYTES ( data, size );
+   }
+}
+
+// PackBits: a control byte n of 0-127 is followed by n+1 literal bytes;
+// a control byte n of 129-255 is followed by one byte to repeat 257-n times.
+void CNESStateWriter::PACK ( const uint8_t* data, uint32_t size )
+{
+   uint32_t idx = 0;
+   uint32_t run;
+   uint32_t lit;
+   uint8_t  control;
+
+   while ( idx < size )
+   {
+      run = 1;
+      while ( (idx+run < size) && (run < 128) && (data[idx+run] == data[idx]) )
+      {
+         run++;
+      }
+
+      if ( run >= 3 )
+      {
+         control = 257-run;
+         BYTES ( &control, 1 );
+         BYTES ( data+idx, 1 );
+         idx += run;
+      }
+      else
+      {
+         // Take literals up to the next run worth encoding.
+         lit = idx;
+         while ( (lit < size) && (lit-idx < 128) )
+         {
+            if ( (lit+2 < size) && (data[lit] == data[lit+1]) && (data[lit] == data[lit+2]) )
+            {
+               break;
+            }
+            lit++;
+         }
+         control = lit-idx-1;
+         BYTES ( &control, 1 );
+         BYTES ( data+idx, lit-idx );
+         idx = lit;
+      }
+   }
+}
+
+uint32_t CNESStateWriter::FINISH ( void )
+{
+   uint32_t formatVersion = STATE_FORMAT_VERSION;
+
+   if ( !m_buffer )
+   {
+      return m_pos;
+   }
+   if ( m_overflow )
+   {
+      return 0;
+   }
+
+   memcpy(m_buffer,STATE_MAGIC,4);
+   memcpy(m_buffer+4,&formatVersion,sizeof(formatVersion));
+   memcpy(m_buffer+8,&m_pos,sizeof(m_pos));
+
+   return m_pos;
+}
+
+CNESStateReader::CNESStateReader ( const uint8_t* buffer, uint32_t size )
+   : m_buffer(buffer),
+     m_size(0),
+     m_pos(0),
+     m_end(0),
+     m_flags(0),
+     m_valid(false),
+     m_good(false)
+{
+   uint32_t formatVersion;
+   uint32_t total;
+   uint32_t length;
+   uint32_t pos;
+
+   if ( (!buffer) || (size < STATE_HEADER_SIZE) || memcmp(buffer,STATE_MAGIC,4) )
+   {
+      return;
+   }
+   memcpy(&formatVersion,buffer+4,sizeof(formatVersion));
+   memcpy(&total,buffer+8,sizeof(total));
+   if ( (formatVersion != STATE_FORMAT_VERSION) || (total > size) || (total < STATE_HEADER_SIZE) )
+   {
+      return;
+   }
+
+   // Make sure the chunks tile the state exactly so FIND can trust them.
+   for ( pos = STATE_HEADER_SIZE; pos < total; pos += STATE_CHUNK_HEADER_SIZE+length )
+   {
+      if ( total-pos < STATE_CHUNK_HEADER_SIZE )
+      {
+         return;
+      }
+      memcpy(&length,buffer+pos+8,sizeof(length));
+      if ( length > total-pos-STATE_CHUNK_HEADER_SIZE )
+      {
+         return;
+      }
+   }
+
+   m_size = total;
+   m_valid = true;
+}
+
+bool CNESStateReader::FIND ( const char* id, uint16_t* version )
+{
+   uint32_t length;
+   uint32_t pos;
+
+   m_good = false;
+   m_pos = m_end = 0;
+
+   if ( !m_valid )
+   {
+      return false;
+   }
+
+   for ( pos = STATE_HEADER_SIZE; pos < m_size; pos += STATE_CHUNK_HEADER_SIZE+length )
+   {
+      memcpy(&length,m_buffer+pos+8,sizeof(length));
+      if ( !memcmp(m_buffer+pos,id,4) )
+      {
+         memcpy(version,m_buffer+pos+4,sizeof(uint16_t));
+         memcpy(&m_flags,m_buffer+pos+6,sizeof(uint16_t));
+         m_pos = pos+STATE_CHUNK_HEADER_SIZE;
+         m_end = m_pos+length;
+         m_good = true;
+         return true;
+      }
+   }
+
+   return false;
+}
+
+void CNESStateReader::BYTES ( void* data, uint32_t size )
+{
+   if ( m_good && (size <= m_end-m_pos) )
+   {
+      memcpy(data,m_buffer+m_pos,size);
+      m_pos += size;
+   }
+   else
+   {
+      m_good = false;
+   }
+}
+
+void CNESStateReader::MEMORY ( uint8_t* data, uint32_t size )
+{
+   if ( m_flags&STATE_CHUNK_PACKED )
+   {
+      UNPACK ( data, size );
+   }
+   else
+   {
+      BYTES ( data, size );
+   }
+}
+
+void CNESStateReader::UNPACK ( uint8_t* data, uint32_t size )
+{
+   uint32_t idx = 0;
+   uint32_t count;
+   uint8_t  control;
+
+   while ( m_good && (idx < size) )
+   {
+      if ( m_pos >= m_end )
+      {
+         m_good = false;
+         break;
+      }
+      control = m_buffer[m_pos++];
+      if ( control < 128 )
+      {
+         count = control+1;
+         if ( (count > size-idx) || (count > m_end-m_pos) )
+         {
+            m_good = false;
+            break;
+         }
+         memcpy(data+idx,m_buffer+m_pos,count);
+         m_pos += count;
+      }
+      else
+      {
+         count = 257-control;
+         if ( (control == 128) || (count > size-idx) || (m_pos >= m_end) )
+         {
+            m_good = false;
+            break;
+         }
+         memset(data+idx,m_buffer[m_pos++],count);
+      }
+      idx += count;
+   }
+}
@@ -0,0 +1,116 @@
+#if !defined ( NESSTATE_H )
+#define NESSTATE_H
+
+#include "nes_emulator_core.h"
+
+#include <string.h>
+
+// Binary save state format.  A save state is a small header followed by
+// a sequence of chunks, one per emulator component.  Each chunk carries
+// its own version so a component can change what it saves without
+// invalidating the chunks of the others.  Large memory blocks (RAM, VRAM,
+// SRAM, CHR-RAM) may be PackBits-compressed; a chunk flag says whether
+// they are.  All values are stored in host byte order, so a save state
+// is only good on the machine type that wrote it.
+//
+// Header:
+//    'NESS'            4 bytes
+//    format version    uint32_t
+//    total size        uint32_t (header included)
+// Chunk:
+//    id                4 characters
+//    version           uint16_t
+//    flags             uint16_t (STATE_CHUNK_PACKED)
+//    length            uint32_t (data only)
+//    data              length bytes
+#define STATE_MAGIC            "NESS"
+#define STATE_FORMAT_VERSION   1
+#define STATE_HEADER_SIZE      12
+#define STATE_CHUNK_HEADER_SIZE 12
+
+#define STATE_CHUNK_PACKED     0x0001
+
+// The CNESStateWriter class fills a caller-supplied buffer with a save state.
+// Given a NULL buffer it only counts, returning from SIZE() the number of bytes
+// the state could need: memory blocks are counted at their worst-case packed
+// size so the count is big enough whether or not packing is asked for.
+class CNESStateWriter
+{
+public:
+   CNESStateWriter ( uint8_t* buffer, uint32_t size, bool pack );
+
+   // Chunk delimiters.  Everything written between them belongs to the chunk.
+   void BEGIN ( const char* id, uint16_t version );
+   void END ( void );
+
+   // Fixed-size data.
+   template <class T> void VALUE ( T value )
+   {
+      BYTES ( &value, sizeof(T) );
+   }
+   void BYTES ( const void* data, uint32_t size );
+
+   // A memory block; packed if the writer was asked to pack.
+   void MEMORY ( const uint8_t* data, uint32_t size );
+
+   // Finishes the header and returns the size of the save state, or 0 if it
+   // did not fit in the buffer.
+   uint32_t FINISH ( void );
+
+protected:
+   void PACK ( const uint8_t* data, uint32_t size );
+
+   uint8_t* m_buffer;
+   uint32_t m_size;
+   uint32_t m_pos;
+   uint32_t m_chunk;
+   bool     m_pack;
+   bool     m_overflow;
+};
+
+// The CNESStateReader class walks a save state written by CNESStateWriter.
+// Reads past the end of a chunk, or of a chunk that is missing, fail and
+// make the reader bad; the components check GOOD() once they've read
+// everything rather than after each value.
+class CNESStateReader
+{
+public:
+   CNESStateReader ( const uint8_t* buffer, uint32_t size );
+
+   // Is the header sane and are all chunks contained within the buffer?
+   bool VALID ( void ) const
+   {
+      return m_valid;
+   }
+
+   // Positions the reader at the start of the named chunk.  Returns false
+   // if there isn't one; otherwise the chunk's version is returned in version.
+   bool FIND ( const char* id, uint16_t* version );
+
+   template <class T> void VALUE ( T& value )
+   {
+      BYTES ( &value, sizeof(T) );
+   }
+   void BYTES ( void* data, uint32_t size );
+   void MEMORY ( uint8_t* data, uint32_t size );
+
+   // Has everything read so far been read successfully, and has the current
+   // chunk been read exactly to its end?
+   bool GOOD ( void ) const
+   {
+      return m_good && (m_pos == m_end);
+   }
+
+protected:
+   void UNPACK ( uint8_t* data, uint32_t size );
+
+   const uint8_t* m_buffer;
+   uint32_t m_size;
+   uint32_t m_pos;
+   uint32_t m_end;
+   uint16_t m_flags;
+   bool     m_valid;
+   bool     m_good;
+};
+
+#endif
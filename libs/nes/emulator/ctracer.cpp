@@ -16,6 +16,51 @@
 
 #include "ctracer.h"
 
+#include <string.h>
+
+#if defined ( _WIN32 )
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// Deepest capture file allowed.  Keeps the file under 4GB.
+#define TRACER_MAX_DEPTH (1<<26)
+
+// Capture files start with this header.  The columns follow it in the
+// order they're laid out in CTracer::Layout, each starting on an eight
+// byte boundary.  The counts are written when the file is unmapped.
+#define TRACER_FILE_MAGIC   "NESTRACE"
+#define TRACER_FILE_VERSION 1
+
+typedef struct _TracerFileHeader
+{
+   char     magic [ 8 ];
+   uint32_t version;
+   uint32_t depth;
+   uint32_t cursor;
+   uint32_t samples;
+   uint32_t cpuCursor;
+   uint32_t cpuSamples;
+   uint32_t ppuCursor;
+   uint32_t ppuSamples;
+   uint32_t reserved [ 6 ];
+} TracerFileHeader;
+
+static inline uint32_t ROUNDUPPOW2 ( uint32_t depth )
+{
+   uint32_t pow2 = 2;
+
+   while ( (pow2 < depth) && (pow2 < TRACER_MAX_DEPTH) )
+   {
+      pow2 <<= 1;
+   }
+
+   return pow2;
+}
+
 CTracer::CTracer()
 {
    m_frame = 0;
@@ -28,123 +73,312 @@ CTracer::CTracer()
    m_ppuCursor = 0;
    m_ppuSamples = 0;
 
-   m_pSamples = new TracerInfo [ TRACER_DEFAULT_DEPTH ];
+   m_lastCPUSample = TRACER_NO_SAMPLE;
+
+   m_bEnabled = true;
+   m_sourceMask = TRACER_SOURCE_ALL;
+   m_typeMask = TRACER_TYPE_ALL;
+   m_addrLow = 0x0000;
+   m_addrHigh = 0xFFFF;
+
+   m_pMemory = NULL;
+   m_pMapping = NULL;
+   m_mappingSize = 0;
+   m_bWrap = true;
+   m_bFull = false;
+#if defined ( _WIN32 )
+   m_hFile = NULL;
+   m_hMapping = NULL;
+#else
+   m_fd = -1;
+#endif
+
+   m_heapDepth = ROUNDUPPOW2 ( TRACER_DEFAULT_DEPTH );
+   Allocate ( m_heapDepth, NULL );
+
+   UpdateFilter ();
+}
 
-   m_sampleBufferDepth = TRACER_DEFAULT_DEPTH;
+CTracer::~CTracer()
+{
+   if ( m_pMapping )
+   {
+      UnmapTracerFile ();
+   }
+
+   delete [] m_pMemory;
 }
 
+uint32_t CTracer::Layout ( uint32_t depth, uint8_t* pMemory, CTracer* pTracer )
+{
+   uint32_t offset = sizeof(TracerFileHeader);
+   uint32_t column;
+
+   // Lays out one column of the given number of bytes per sample.
+#define COLUMN(member,type,bytes) \
+   column = offset; \
+   offset += (((depth*(bytes))+7)&(~7)); \
+   if ( pTracer ) pTracer->member = (type*)(pMemory+column)
+
+   COLUMN ( m_pFrame, uint32_t, sizeof(uint32_t) );
+   COLUMN ( m_pCycle, uint32_t, sizeof(uint32_t) );
+   COLUMN ( m_pEA, uint32_t, sizeof(uint32_t) );
+   COLUMN ( m_pAddr, uint16_t, sizeof(uint16_t) );
+   COLUMN ( m_pData, uint8_t, sizeof(uint8_t) );
+   COLUMN ( m_pType, int8_t, sizeof(int8_t) );
+   COLUMN ( m_pSource, int8_t, sizeof(int8_t) );
+   COLUMN ( m_pTarget, int8_t, sizeof(int8_t) );
+   COLUMN ( m_pRegisters, uint8_t, 8 );
+   COLUMN ( m_pDisassemble, uint8_t, 4 );
+   COLUMN ( m_pCPUSamples, uint32_t, sizeof(uint32_t) );
+   COLUMN ( m_pPPUSamples, uint32_t, sizeof(uint32_t) );
+
+#undef COLUMN
+
+   return offset;
+}
 
-CTracer::~CTracer()
+bool CTracer::Allocate ( uint32_t depth, uint8_t* pMemory )
 {
-   delete m_pSamples;
+   if ( !pMemory )
+   {
+      delete [] m_pMemory;
+      m_pMemory = new uint8_t [ Layout(depth,NULL,NULL) ];
+      pMemory = m_pMemory;
+   }
+
+   Layout ( depth, pMemory, this );
+
+   m_sampleBufferDepth = depth;
+   m_sampleMask = depth-1;
+
+   ClearSampleBuffer ();
+
+   return pMemory != NULL;
 }
 
 bool CTracer::ReallocateTracerMemory(int32_t newDepth)
 {
-   bool ok = true;
+   m_heapDepth = ROUNDUPPOW2 ( newDepth );
+
+   // The new depth is picked up when the capture file is unmapped.
+   if ( m_pMapping )
+   {
+      return true;
+   }
+
+   return Allocate ( m_heapDepth, NULL );
+}
+
+bool CTracer::MapTracerFile ( const char* fileName, uint32_t depth, bool wrap )
+{
+   uint32_t size;
+   void*    pMapping = NULL;
 
-   delete m_pSamples;
+   if ( m_pMapping )
+   {
+      UnmapTracerFile ();
+   }
 
-   m_pSamples = new TracerInfo [ newDepth ];
+   depth = ROUNDUPPOW2 ( depth );
+   size = Layout ( depth, NULL, NULL );
 
-   m_sampleBufferDepth = newDepth;
+#if defined ( _WIN32 )
+   HANDLE hFile;
+   HANDLE hMapping;
 
-   if ( !m_pSamples )
+   hFile = CreateFileA ( fileName, GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL );
+   if ( hFile == INVALID_HANDLE_VALUE )
    {
-      ok = false;
+      return false;
+   }
+   hMapping = CreateFileMappingA ( hFile, NULL, PAGE_READWRITE, 0, size, NULL );
+   if ( hMapping )
+   {
+      pMapping = MapViewOfFile ( hMapping, FILE_MAP_ALL_ACCESS, 0, 0, size );
+   }
+   if ( !pMapping )
+   {
+      if ( hMapping )
+      {
+         CloseHandle ( hMapping );
+      }
+      CloseHandle ( hFile );
+      return false;
    }
+   m_hFile = hFile;
+   m_hMapping = hMapping;
+#else
+   int fd;
+
+   fd = open ( fileName, O_RDWR|O_CREAT|O_TRUNC, 0644 );
+   if ( fd < 0 )
+   {
+      return false;
+   }
+   if ( ftruncate(fd,size) == 0 )
+   {
+      pMapping = mmap ( NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0 );
+      if ( pMapping == MAP_FAILED )
+      {
+         pMapping = NULL;
+      }
+   }
+   if ( !pMapping )
+   {
+      close ( fd );
+      return false;
+   }
+   m_fd = fd;
+#endif
+
+   m_pMapping = pMapping;
+   m_mappingSize = size;
+   m_bWrap = wrap;
+
+   // The heap ring isn't needed while the file is mapped.
+   delete [] m_pMemory;
+   m_pMemory = NULL;
+
+   memset ( m_pMapping, 0, sizeof(TracerFileHeader) );
+   memcpy ( ((TracerFileHeader*)m_pMapping)->magic, TRACER_FILE_MAGIC, 8 );
+   ((TracerFileHeader*)m_pMapping)->version = TRACER_FILE_VERSION;
+   ((TracerFileHeader*)m_pMapping)->depth = depth;
 
-   return ok;
+   return Allocate ( depth, (uint8_t*)m_pMapping );
 }
 
-TracerInfo* CTracer::AddSample(uint32_t cycle, int8_t type, int8_t source, int8_t target, uint16_t addr, uint8_t data)
+void CTracer::UnmapTracerFile ( void )
 {
-   TracerInfo* pSample = m_pSamples + m_cursor;
-   TracerInfo* pTargetSample = NULL;
-   int8_t      overwrittenSource;
+   TracerFileHeader* pHeader = (TracerFileHeader*)m_pMapping;
 
-   // Save overwritten sample's type to adjust
-   // sample counts later on...
-   overwrittenSource = pSample->source;
+   if ( !pHeader )
+   {
+      return;
+   }
 
-   // Set frame from emulator.
-   pSample->frame = m_frame;
+   pHeader->cursor = m_cursor;
+   pHeader->samples = m_samples;
+   pHeader->cpuCursor = m_cpuCursor;
+   pHeader->cpuSamples = m_cpuSamples;
+   pHeader->ppuCursor = m_ppuCursor;
+   pHeader->ppuSamples = m_ppuSamples;
+
+#if defined ( _WIN32 )
+   UnmapViewOfFile ( m_pMapping );
+   CloseHandle ( (HANDLE)m_hMapping );
+   CloseHandle ( (HANDLE)m_hFile );
+   m_hMapping = NULL;
+   m_hFile = NULL;
+#else
+   munmap ( m_pMapping, m_mappingSize );
+   close ( m_fd );
+   m_fd = -1;
+#endif
+
+   m_pMapping = NULL;
+   m_mappingSize = 0;
+   m_bWrap = true;
+
+   Allocate ( m_heapDepth, NULL );
+}
 
-   pSample->cycle = cycle;
-   pSample->type = type;
-   pSample->source = source;
-   pSample->target = target;
-   pSample->addr = addr;
-   pSample->data = data;
-   *(pSample->disassemble+3) = 0xFF;
-   pSample->ea = 0xFFFFFFFF;
-   pSample->regsset = 0;
+void CTracer::SetFilter ( uint32_t sourceMask, uint32_t typeMask, uint32_t addrLow, uint32_t addrHigh )
+{
+   m_sourceMask = sourceMask;
+   m_typeMask = typeMask;
+   m_addrLow = addrLow;
+   m_addrHigh = addrHigh;
 
-   m_cursor++;
-   m_cursor %= m_sampleBufferDepth;
+   UpdateFilter ();
+}
+
+void CTracer::UpdateFilter ( void )
+{
+   m_acceptSources = (m_bEnabled && (!m_bFull)) ? m_sourceMask : 0;
+
+   m_bAcceptAll = (m_acceptSources == TRACER_SOURCE_ALL) &&
+                  (m_typeMask == TRACER_TYPE_ALL) &&
+                  (m_addrLow == 0x0000) &&
+                  (m_addrHigh >= 0xFFFF);
+}
+
+uint32_t CTracer::WriteSample(uint32_t cycle, int8_t type, int8_t source, int8_t target, uint16_t addr, uint8_t data)
+{
+   uint32_t sample = m_cursor.load(std::memory_order_relaxed);
+   uint32_t samples = m_samples.load(std::memory_order_relaxed);
+   uint32_t slot = sample&m_sampleMask;
+   int8_t   overwrittenSource;
+   uint32_t cursor;
+
+   // One slot of the ring is always kept free.  It's the one being
+   // written, so a reader never sees a sample that is being overwritten
+   // as valid.  Once the ring is full each new sample pushes the oldest
+   // one, the one in the slot after this one, out.
+   overwrittenSource = m_pSource[(sample+1)&m_sampleMask];
+
+   m_pFrame[slot] = m_frame;
+   m_pCycle[slot] = cycle;
+   m_pType[slot] = type;
+   m_pSource[slot] = source;
+   m_pTarget[slot] = target;
+   m_pAddr[slot] = addr;
+   m_pData[slot] = data;
+   m_pEA[slot] = 0xFFFFFFFF;
+   (*(m_pDisassemble+(slot<<2)+3)) = 0xFF;
+   (*(m_pRegisters+(slot<<3)+eTracerReg_Set)) = 0;
 
    if ( source == eNESSource_PPU )
    {
-      pTargetSample = m_pSamples + m_ppuCursor;
-      pTargetSample->pPPUSample = pSample;
+      cursor = m_ppuCursor.load(std::memory_order_relaxed);
+      m_pPPUSamples[cursor&m_sampleMask] = sample;
+      m_ppuCursor.store(cursor+1,std::memory_order_release);
+   }
+   else
+   {
+      cursor = m_cpuCursor.load(std::memory_order_relaxed);
+      m_pCPUSamples[cursor&m_sampleMask] = sample;
+      m_cpuCursor.store(cursor+1,std::memory_order_release);
 
-      m_ppuCursor++;
-      m_ppuCursor %= m_sampleBufferDepth;
+      m_lastCPUSample = sample;
+   }
 
-      if ( m_samples < m_sampleBufferDepth )
+   if ( samples < m_sampleMask )
+   {
+      m_samples.store(samples+1,std::memory_order_release);
+      if ( source == eNESSource_PPU )
       {
-         m_samples++;
-         m_ppuSamples++;
+         m_ppuSamples.fetch_add(1,std::memory_order_release);
       }
       else
       {
-         if ( m_ppuSamples < m_sampleBufferDepth )
-         {
-            m_ppuSamples++;
-         }
-
-         if ( overwrittenSource == eNESSource_PPU )
-         {
-            m_ppuSamples--;
-         }
-         else
-         {
-            m_cpuSamples--;
-         }
+         m_cpuSamples.fetch_add(1,std::memory_order_release);
       }
    }
-   else
+   else if ( (source == eNESSource_PPU) != (overwrittenSource == eNESSource_PPU) )
    {
-      pTargetSample = m_pSamples + m_cpuCursor;
-      pTargetSample->pCPUSample = pSample;
-
-      m_cpuCursor++;
-      m_cpuCursor %= m_sampleBufferDepth;
-
-      if ( m_samples < m_sampleBufferDepth )
+      if ( source == eNESSource_PPU )
       {
-         m_samples++;
-         m_cpuSamples++;
+         m_ppuSamples.fetch_add(1,std::memory_order_release);
+         m_cpuSamples.fetch_sub(1,std::memory_order_release);
       }
       else
       {
-         if ( m_cpuSamples < m_sampleBufferDepth )
-         {
-            m_cpuSamples++;
-         }
-
-         if ( overwrittenSource == eNESSource_PPU )
-         {
-            m_ppuSamples--;
-         }
-         else
-         {
-            m_cpuSamples--;
-         }
+         m_cpuSamples.fetch_add(1,std::memory_order_release);
+         m_ppuSamples.fetch_sub(1,std::memory_order_release);
       }
    }
 
-   return pSample;
+   m_cursor.store(sample+1,std::memory_order_release);
+
+   // A capture that doesn't wrap stops here once the file is full.
+   if ( (!m_bWrap) && (samples+1 >= m_sampleMask) )
+   {
+      m_bFull = true;
+      UpdateFilter ();
+   }
+
+   return sample;
 }
 
 void CTracer::ClearSampleBuffer(void)
@@ -158,90 +392,72 @@ void CTracer::ClearSampleBuffer(void)
    m_cpuSamples = 0;
    m_ppuCursor = 0;
    m_ppuSamples = 0;
-}
 
-TracerInfo* CTracer::GetLastSample ( void )
-{
-   int getsample = m_cursor-1;
+   m_lastCPUSample = TRACER_NO_SAMPLE;
 
-   if ( getsample < 0 )
-   {
-      getsample = m_sampleBufferDepth-1;
-   }
-
-   return m_pSamples+getsample;
-}
-
-TracerInfo* CTracer::GetLastCPUSample ( void )
-{
-   int getsample = m_cpuCursor-1;
-
-   if ( getsample < 0 )
-   {
-      getsample = m_sampleBufferDepth-1;
-   }
-
-   return (m_pSamples+getsample)->pCPUSample;
+   m_bFull = false;
+   UpdateFilter ();
 }
 
-TracerInfo* CTracer::GetSample ( uint32_t sample )
+uint32_t CTracer::GetSample ( uint32_t row ) const
 {
-   int32_t getsample = m_cursor-(sample+1);
-
-   if ( getsample < 0 )
-   {
-      getsample = m_sampleBufferDepth+getsample;
-   }
-
-   return m_pSamples+getsample;
+   return m_cursor.load(std::memory_order_acquire)-(row+1);
 }
 
-TracerInfo* CTracer::GetCPUSample ( uint32_t sample )
+uint32_t CTracer::GetCPUSample ( uint32_t row ) const
 {
-   int32_t getsample = m_cpuCursor-(sample+1);
-
-   if ( getsample < 0 )
-   {
-      getsample = m_sampleBufferDepth+getsample;
-   }
+   uint32_t cursor = m_cpuCursor.load(std::memory_order_acquire);
 
-   return (m_pSamples+getsample)->pCPUSample;
+   return m_pCPUSamples[(cursor-(row+1))&m_sampleMask];
 }
 
-TracerInfo* CTracer::GetPPUSample ( uint32_t sample )
+uint32_t CTracer::GetPPUSample ( uint32_t row ) const
 {
-   int32_t getsample = m_ppuCursor-(sample+1);
-
-   if ( getsample < 0 )
-   {
-      getsample = m_sampleBufferDepth+getsample;
-   }
+   uint32_t cursor = m_ppuCursor.load(std::memory_order_acquire);
 
-   return (m_pSamples+getsample)->pPPUSample;
+   return m_pPPUSamples[(cursor-(row+1))&m_sampleMask];
 }
 
-void CTracer::SetDisassembly ( TracerInfo* pS, uint8_t* szD )
+bool CTracer::GetRecord ( uint32_t sample, TracerInfo* pInfo ) const
 {
-   if ( pS )
+   uint32_t slot = sample&m_sampleMask;
+   uint32_t cursor;
+   uint8_t* pR;
+   uint8_t* pD;
+
+   // The sample is valid if it is one of the last m_samples added.  It
+   // stays valid until the cursor has gone all the way round the ring
+   // to the slot before it.
+   cursor = m_cursor.load(std::memory_order_acquire);
+   if ( (sample == TRACER_NO_SAMPLE) ||
+        ((cursor-sample-1) >= m_samples.load(std::memory_order_acquire)) )
    {
-      (*((pS->disassemble)+0)) = (*szD);
-      szD++;
-      (*((pS->disassemble)+1)) = (*szD);
-      szD++;
-      (*((pS->disassemble)+2)) = (*szD);
-      (*((pS->disassemble)+3)) = 0x00;
+      return false;
    }
-}
 
-void CTracer::SetRegisters ( TracerInfo* pS, uint8_t a, uint8_t x, uint8_t y, uint8_t sp, uint8_t f )
-{
-   if ( pS )
-   {
-      pS->a = a;
-      pS->x = x;
-      pS->y = y;
-      pS->sp = sp;
-      pS->f = f;
-      pS->regsset = 1;
-   }
+   pR = m_pRegisters+(slot<<3);
+   pD = m_pDisassemble+(slot<<2);
+
+   pInfo->frame = m_pFrame[slot];
+   pInfo->cycle = m_pCycle[slot];
+   pInfo->addr = m_pAddr[slot];
+   pInfo->data = m_pData[slot];
+   pInfo->a = (*(pR+eTracerReg_A));
+   pInfo->x = (*(pR+eTracerReg_X));
+   pInfo->y = (*(pR+eTracerReg_Y));
+   pInfo->sp = (*(pR+eTracerReg_SP));
+   pInfo->f = (*(pR+eTracerReg_F));
+   pInfo->regsset = (*(pR+eTracerReg_Set));
+   pInfo->ea = m_pEA[slot];
+   memcpy ( pInfo->disassemble, pD, 4 );
+   pInfo->type = m_pType[slot];
+   pInfo->source = m_pSource[slot];
+   pInfo->target = m_pTarget[slot];
+
+   // Check the emulator didn't get round to the sample while it was
+   // being copied.
+   std::atomic_thread_fence(std::memory_order_acquire);
+   cursor = m_cursor.load(std::memory_order_relaxed);
+
+   return (cursor-sample) < m_sampleBufferDepth;
 }
@@ -3,6 +3,8 @@
 
 #include "nes_emulator_core.h"
 
+#include <atomic>
+
 #define TRACER_DEFAULT_DEPTH 262144
 
 enum
@@ -72,7 +74,9 @@ enum
    eTracerCol_MAX
 };
 
-#pragma pack(1)
+// A copy of one tracer record.  The tracer itself keeps its records in
+// columns (see CTracer) so this is only used to hand a whole record to
+// the debugger.
 typedef struct _TracerInfo
 {
    uint32_t frame;
@@ -90,91 +94,302 @@ typedef struct _TracerInfo
    int8_t   source;
    int8_t   target;
    int8_t   regsset;
-   struct _TracerInfo* pCPUSample;
-   struct _TracerInfo* pPPUSample;
 } TracerInfo;
-#pragma pack()
 
+// Samples are referred to by their sample number, which counts up from
+// zero as samples are added.  A sample number stays valid until the
+// ring has wrapped around onto it.  AddSample returns TRACER_NO_SAMPLE
+// for samples rejected by the filter; the Set* methods ignore it.
+#define TRACER_NO_SAMPLE 0xFFFFFFFF
+
+// The filter masks are bitmasks of eNESSource_* and eTracer_* values.
+#define TRACER_SOURCE_ALL 0xFFFFFFFF
+#define TRACER_TYPE_ALL   0xFFFFFFFF
+#define TRACER_TYPE_BIT(t) (1<<(t))
+
+// Samples of these types don't have an address.  The filter's address
+// range is not applied to them.
+#define TRACER_TYPES_UNADDRESSED ( TRACER_TYPE_BIT(eTracer_RESET) | \
+                                   TRACER_TYPE_BIT(eTracer_NMI) | \
+                                   TRACER_TYPE_BIT(eTracer_IRQ) | \
+                                   TRACER_TYPE_BIT(eTracer_IRQRelease) | \
+                                   TRACER_TYPE_BIT(eTracer_StolenCycle) | \
+                                   TRACER_TYPE_BIT(eTracer_Sprite0Hit) | \
+                                   TRACER_TYPE_BIT(eTracer_StartPPUFrame) | \
+                                   TRACER_TYPE_BIT(eTracer_VBLANKStart) | \
+                                   TRACER_TYPE_BIT(eTracer_VBLANKEnd) | \
+                                   TRACER_TYPE_BIT(eTracer_PreRenderStart) | \
+                                   TRACER_TYPE_BIT(eTracer_PreRenderEnd) | \
+                                   TRACER_TYPE_BIT(eTracer_QuietStart) | \
+                                   TRACER_TYPE_BIT(eTracer_QuietEnd) | \
+                                   TRACER_TYPE_BIT(eTracer_EndPPUFrame) | \
+                                   TRACER_TYPE_BIT(eTracer_StartAPUFrame) | \
+                                   TRACER_TYPE_BIT(eTracer_SequencerStep) | \
+                                   TRACER_TYPE_BIT(eTracer_EndAPUFrame) )
+
+// The CTracer class records what the CPU, PPU and APU do, cycle by cycle,
+// for the execution inspector.  Records are kept one column per field
+// (all the cycles together, all the addresses together, and so on) in a
+// ring whose depth is a power of two.  Two more rings hold the sample
+// numbers of the CPU and PPU samples so the debugger can show either on
+// its own.
+//
+// Only the emulator thread adds samples.  The write cursor is published
+// after a sample has been written so the debugger can read the tracer
+// while the emulator is running without taking a lock.  GetRecord checks
+// after copying a record that it wasn't overwritten in the meantime.
+//
+// A filter set up front decides which samples are recorded at all; a
+// rejected sample costs a couple of compares and nothing is written.
+//
+// The columns normally live on the heap.  MapTracerFile moves them into a
+// memory-mapped file instead so a capture can be made much deeper than
+// would fit comfortably in memory, several seconds of emulation rather
+// than a few frames.  The operating system pages the file in and out as
+// the emulator writes it and as the debugger reads it.
 class CTracer
 {
 public:
    void ClearSampleBuffer ( void );
-   inline TracerInfo* AddRESET ( void )
+   inline uint32_t AddRESET ( void )
    {
       return AddSample ( 0, eTracer_RESET, eNESSource_CPU, 0, 0, 0 );
    }
-   inline TracerInfo* AddNMI ( uint32_t cycle, int8_t source )
+   inline uint32_t AddNMI ( uint32_t cycle, int8_t source )
    {
       return AddSample ( cycle, eTracer_NMI, source, 0, 0, 0 );
    }
-   inline TracerInfo* AddIRQ ( uint32_t cycle, int8_t source )
+   inline uint32_t AddIRQ ( uint32_t cycle, int8_t source )
    {
       return AddSample ( cycle, eTracer_IRQ, source, 0, 0, 0 );
    }
-   inline TracerInfo* AddIRQRelease ( uint32_t cycle, int8_t source )
+   inline uint32_t AddIRQRelease ( uint32_t cycle, int8_t source )
    {
       return AddSample ( cycle, eTracer_IRQRelease, source, 0, 0, 0 );
    }
-   inline TracerInfo* AddStolenCycle ( uint32_t cycle, int8_t source )
+   inline uint32_t AddStolenCycle ( uint32_t cycle, int8_t source )
    {
       return AddSample ( cycle, eTracer_StolenCycle, source, 0, 0, 0 );
    }
-   inline TracerInfo* AddGarbageFetch( uint32_t cycle, int8_t target, uint16_t addr )
+   inline uint32_t AddGarbageFetch( uint32_t cycle, int8_t target, uint16_t addr )
    {
       return AddSample ( cycle, eTracer_GarbageRead, eNESSource_PPU, target, addr, 0 );
    }
-   TracerInfo* AddSample ( uint32_t cycle, int8_t type, int8_t source, int8_t target, uint16_t addr, uint8_t data );
-   bool ReallocateTracerMemory ( int32_t newDepth );
-   unsigned int GetNumSamples ( void ) const
-   {
-      return m_samples;
-   }
-   TracerInfo* GetSample ( uint32_t sample );
-   TracerInfo* GetCPUSample ( uint32_t sample );
-   TracerInfo* GetPPUSample ( uint32_t sample );
-   TracerInfo* GetLastSample ( void );
-   TracerInfo* GetLastCPUSample ( void );
-   void SetDisassembly ( TracerInfo* pS, uint8_t* szD );
-   void SetRegisters ( TracerInfo* pS, uint8_t a, uint8_t x, uint8_t y, uint8_t sp, uint8_t f );
-   void SetEffectiveAddress ( TracerInfo* pS, uint32_t ea )
+   inline uint32_t AddSample ( uint32_t cycle, int8_t type, int8_t source, int8_t target, uint16_t addr, uint8_t data )
    {
-      if ( pS )
+      if ( ACCEPT(type,source,addr) )
       {
-         pS->ea = ea;
+         return WriteSample ( cycle, type, source, target, addr, data );
       }
+
+      // Forget the last CPU sample so the registers and effective
+      // address of a rejected access don't land on an older sample.
+      if ( source != eNESSource_PPU )
+      {
+         m_lastCPUSample = TRACER_NO_SAMPLE;
+      }
+      return TRACER_NO_SAMPLE;
    }
 
-   CTracer();
-   ~CTracer();
+   // Sets up which samples are recorded.  A sample is recorded if its
+   // source and type are in the masks and, if it has an address, the
+   // address is within [addrLow,addrHigh].  Disable turns the tracer off
+   // altogether.
+   void SetFilter ( uint32_t sourceMask, uint32_t typeMask, uint32_t addrLow, uint32_t addrHigh );
+   void Enable ( bool enable )
+   {
+      m_bEnabled = enable;
+      UpdateFilter ();
+   }
+   bool IsEnabled ( void ) const
+   {
+      return m_bEnabled;
+   }
 
+   // Depth is rounded up to a power of two.
+   bool ReallocateTracerMemory ( int32_t newDepth );
+
+   // Moves the tracer into the named file, creating or truncating it,
+   // with room for depth samples.  If wrap is false the capture stops
+   // when the file is full rather than overwriting the oldest samples.
+   // UnmapTracerFile writes the file's header and puts the tracer back
+   // on the heap at its previous depth.
+   bool MapTracerFile ( const char* fileName, uint32_t depth, bool wrap = false );
+   void UnmapTracerFile ( void );
+   bool IsMapped ( void ) const
+   {
+      return m_pMapping != NULL;
+   }
+   bool IsFull ( void ) const
+   {
+      return m_bFull;
+   }
+
+   unsigned int GetNumSamples ( void ) const
+   {
+      return m_samples.load(std::memory_order_acquire);
+   }
    unsigned int GetNumCPUSamples() const
    {
-      return m_cpuSamples;
+      return m_cpuSamples.load(std::memory_order_acquire);
    }
    unsigned int GetNumPPUSamples() const
    {
-      return m_ppuSamples;
+      return m_ppuSamples.load(std::memory_order_acquire);
+   }
+   uint32_t GetDepth ( void ) const
+   {
+      return m_sampleBufferDepth;
+   }
+
+   // Sample number of the given row, with row 0 the newest sample.
+   uint32_t GetSample ( uint32_t row ) const;
+   uint32_t GetCPUSample ( uint32_t row ) const;
+   uint32_t GetPPUSample ( uint32_t row ) const;
+   uint32_t GetLastSample ( void ) const
+   {
+      return m_cursor.load(std::memory_order_relaxed)-1;
+   }
+   uint32_t GetLastCPUSample ( void ) const
+   {
+      return m_lastCPUSample;
    }
 
+   // Copies a sample out of the tracer.  Returns false if the sample
+   // has been overwritten.
+   bool GetRecord ( uint32_t sample, TracerInfo* pInfo ) const;
+
+   void SetDisassembly ( uint32_t sample, uint8_t* szD )
+   {
+      if ( sample != TRACER_NO_SAMPLE )
+      {
+         uint8_t* pD = m_pDisassemble+((sample&m_sampleMask)<<2);
+         (*(pD+0)) = (*(szD+0));
+         (*(pD+1)) = (*(szD+1));
+         (*(pD+2)) = (*(szD+2));
+         (*(pD+3)) = 0x00;
+      }
+   }
+   void SetRegisters ( uint32_t sample, uint8_t a, uint8_t x, uint8_t y, uint8_t sp, uint8_t f )
+   {
+      if ( sample != TRACER_NO_SAMPLE )
+      {
+         uint8_t* pR = m_pRegisters+((sample&m_sampleMask)<<3);
+         (*(pR+eTracerReg_A)) = a;
+         (*(pR+eTracerReg_X)) = x;
+         (*(pR+eTracerReg_Y)) = y;
+         (*(pR+eTracerReg_SP)) = sp;
+         (*(pR+eTracerReg_F)) = f;
+         (*(pR+eTracerReg_Set)) = 1;
+      }
+   }
+   void SetEffectiveAddress ( uint32_t sample, uint32_t ea )
+   {
+      if ( sample != TRACER_NO_SAMPLE )
+      {
+         m_pEA[sample&m_sampleMask] = ea;
+      }
+   }
+   void SetTarget ( uint32_t sample, int8_t target )
+   {
+      if ( sample != TRACER_NO_SAMPLE )
+      {
+         m_pTarget[sample&m_sampleMask] = target;
+      }
+   }
+
+   CTracer();
+   ~CTracer();
+
    void SetFrame(uint32_t frame)
    {
       m_frame = frame;
    }
 
 protected:
+   enum
+   {
+      eTracerReg_A = 0,
+      eTracerReg_X,
+      eTracerReg_Y,
+      eTracerReg_SP,
+      eTracerReg_F,
+      eTracerReg_Set
+   };
+
+   inline bool ACCEPT ( int8_t type, int8_t source, uint16_t addr ) const
+   {
+      if ( m_bAcceptAll )
+      {
+         return true;
+      }
+      if ( !((m_acceptSources>>source)&(m_typeMask>>type)&1) )
+      {
+         return false;
+      }
+      return ( (TRACER_TYPES_UNADDRESSED>>type)&1 ) ||
+             ( (uint32_t)(addr-m_addrLow) <= (m_addrHigh-m_addrLow) );
+   }
+   uint32_t WriteSample ( uint32_t cycle, int8_t type, int8_t source, int8_t target, uint16_t addr, uint8_t data );
+   void UpdateFilter ( void );
+   bool Allocate ( uint32_t depth, uint8_t* pMemory );
+   static uint32_t Layout ( uint32_t depth, uint8_t* pMemory, CTracer* pTracer );
+
    // Frame # is set by emulator so it doesn't have to be passed in all the time...
    uint32_t    m_frame;
 
-   uint32_t    m_cursor;
-   uint32_t    m_samples;
+   // Sample number of the next sample, and how many samples are in the
+   // ring.  The CPU and PPU cursors index the CPU and PPU rings, which
+   // hold sample numbers.
+   std::atomic<uint32_t> m_cursor;
+   std::atomic<uint32_t> m_samples;
+   std::atomic<uint32_t> m_cpuCursor;
+   std::atomic<uint32_t> m_cpuSamples;
+   std::atomic<uint32_t> m_ppuCursor;
+   std::atomic<uint32_t> m_ppuSamples;
    uint32_t    m_sampleBufferDepth;
+   uint32_t    m_sampleMask;
+   uint32_t    m_heapDepth;
+   uint32_t    m_lastCPUSample;
 
-   uint32_t    m_cpuCursor;
-   uint32_t    m_cpuSamples;
-   uint32_t    m_ppuCursor;
-   uint32_t    m_ppuSamples;
+   // Filter.  m_bAcceptAll short-circuits it when nothing is filtered.
+   // m_acceptSources is the source mask in effect, which is zero while
+   // the tracer is disabled or a capture file is full.
+   bool        m_bEnabled;
+   bool        m_bAcceptAll;
+   uint32_t    m_sourceMask;
+   uint32_t    m_acceptSources;
+   uint32_t    m_typeMask;
+   uint32_t    m_addrLow;
+   uint32_t    m_addrHigh;
 
-   TracerInfo* m_pSamples;
+   // Columns.  The registers column has eight bytes per sample and the
+   // disassembly column four; the rest one value per sample.
+   uint8_t*    m_pMemory;
+   uint32_t*   m_pFrame;
+   uint32_t*   m_pCycle;
+   uint32_t*   m_pEA;
+   uint16_t*   m_pAddr;
+   uint8_t*    m_pData;
+   int8_t*     m_pType;
+   int8_t*     m_pSource;
+   int8_t*     m_pTarget;
+   uint8_t*    m_pRegisters;
+   uint8_t*    m_pDisassemble;
+   uint32_t*   m_pCPUSamples;
+   uint32_t*   m_pPPUSamples;
+
+   // Memory-mapped capture file.
+   void*       m_pMapping;
+   uint32_t    m_mappingSize;
+   bool        m_bWrap;
+   bool        m_bFull;
+#if defined ( _WIN32 )
+   void*       m_hFile;
+   void*       m_hMapping;
+#else
+   int         m_fd;
+#endif
 };
 
 CTracer* nesGetExecutionTracerDatabase ( void );
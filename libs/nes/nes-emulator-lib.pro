@@ -25,6 +25,7 @@ CONFIG(release, debug|release) {
 
 # Remove crap we don't need!
 CONFIG -= rtti exceptions
+CONFIG += c++11
 
 OBJECTS_DIR = $$DESTDIR
 MOC_DIR = $$DESTDIR
@@ -67,6 +68,7 @@ INCLUDEPATH += . \
                $$TOP/common
 
 SOURCES += \
+   $$TOP/common/cbreakpointexpression.cpp \
    $$TOP/common/cbreakpointinfo.cpp \
    emulator/cnesrommapper068.cpp \
    emulator/cnesrommapper065.cpp \
@@ -80,6 +82,9 @@ SOURCES += \
    emulator/cnesrommapper002.cpp \
    emulator/cnesrommapper001.cpp \
    emulator/cnesrom.cpp \
+   emulator/cnescontext.cpp \
+   emulator/cnesstate.cpp \
+   emulator/cnesrewind.cpp \
    emulator/cnesppu.cpp \
    emulator/cnesmappers.cpp \
    emulator/cnesio.cpp \
@@ -89,6 +94,7 @@ SOURCES += \
    common/cnessystempalette.cpp \
    nes_emulator_core.cpp \
    emulator/cmarker.cpp \
+   emulator/ccallprofiler.cpp \
    emulator/cjoypadlogger.cpp \
    emulator/ccodedatalogger.cpp \
    emulator/ctracer.cpp \
@@ -124,6 +130,9 @@ HEADERS +=\
    emulator/cnesrommapper002.h \
    emulator/cnesrommapper001.h \
    emulator/cnesrom.h \
+   emulator/cnescontext.h \
+   emulator/cnesstate.h \
+   emulator/cnesrewind.h \
    emulator/cnesppu.h \
    emulator/cnesmappers.h \
    emulator/cnesio.h \
@@ -133,6 +142,7 @@ HEADERS +=\
    nes_emulator_core.h \
    common/cnessystempalette.h \
    emulator/cmarker.h \
+   emulator/ccallprofiler.h \
    emulator/cjoypadlogger.h \
    emulator/ccodedatalogger.h \
    emulator/ctracer.h \
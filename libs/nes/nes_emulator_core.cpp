@@ -5,6 +5,8 @@
 #include "cnesppu.h"
 #include "cnesapu.h"
 #include "cnes6502.h"
+#include "cnesstate.h"
+#include "cnesrewind.h"
 #include "cnesrommapper001.h"
 #include "cnesrommapper004.h"
 #include "cnesrommapper009.h"
@@ -14,6 +16,7 @@
 #include "cnesrommapper069.h"
 
 #include "common/cnessystempalette.h"
+#include "cnescontext.h"
 
 static char __emu_version__ [] = "v2.0.0"
 #if defined ( QT_NO_DEBUG )
@@ -26,20 +29,142 @@ char* nesGetVersion()
 {
    return __emu_version__;
 }
-extern int32_t apuDataAvailable;
 
 const char* hex_char = "0123456789ABCDEF";
 
-bool __nesdebug = false;
+// The debugger snapshot the calling thread has acquired and the context it
+// belongs to, if any.
+#if defined ( _MSC_VER )
+static __declspec(thread) NESContext* __nessnapshotcontext = NULL;
+static __declspec(thread) int32_t __nessnapshot = -1;
+#else
+static __thread NESContext* __nessnapshotcontext = NULL;
+static __thread int32_t __nessnapshot = -1;
+#endif
+
+// The context the calling thread is changing, if any.
+#if defined ( _MSC_VER )
+static __declspec(thread) NESContext* __neschangingcontext = NULL;
+#else
+static __thread NESContext* __neschangingcontext = NULL;
+#endif
+
+// Holds the bound context while the NES is changed in its scope, unless the
+// calling thread already is.  An edit is a change the debuggers' snapshots
+// are to be brought up to date with; a frame isn't, the emulator thread
+// publishes one after it when the debuggers are to see it.
+class NESChange
+{
+public:
+   NESChange ( bool edit )
+      : m_pContext(__nescontext),
+        m_pPrevious(__neschangingcontext),
+        m_edit(edit)
+   {
+      if ( m_pPrevious != m_pContext )
+      {
+         m_pContext->changing.lock();
+         __neschangingcontext = m_pContext;
+      }
+   }
+   ~NESChange ()
+   {
+      if ( m_edit )
+      {
+         m_pContext->edits++;
+      }
+      if ( m_pPrevious != m_pContext )
+      {
+         __neschangingcontext = m_pPrevious;
+         m_pContext->changing.unlock();
+      }
+   }
+
+private:
+   NESContext* m_pContext;
+   NESContext* m_pPrevious;
+   bool        m_edit;
+};
+
+// The snapshot the debugger getters read on the calling thread, or NULL if
+// they should read the NES.
+static inline const nesDebuggerSnapshot* debuggerSnapshot ( void )
+{
+   NESContext* pContext = __nescontext;
+
+   if ( __nessnapshotcontext != pContext )
+   {
+      return NULL;
+   }
+
+   // If the NES was changed outside of a frame since the snapshot was taken
+   // and nothing is changing it now, take one showing the changes.
+   if ( (pContext->snapshotEdits[__nessnapshot] != pContext->edits) &&
+        (__neschangingcontext != pContext) &&
+        pContext->changing.try_lock() )
+   {
+      nesPublishDebuggerSnapshot();
+      pContext->changing.unlock();
+      nesAcquireDebuggerSnapshot();
+   }
+
+   return pContext->snapshots+__nessnapshot;
+}
+
+static inline void debuggerEdit ( void )
+{
+   __nescontext->edits++;
+}
+
+NESContext* nesCreateContext ( void )
+{
+   return new NESContext();
+}
+
+void nesDestroyContext ( NESContext* pContext )
+{
+   if ( pContext == nesDefaultContext() )
+   {
+      return;
+   }
+   if ( pContext == __nescontext )
+   {
+      __nescontext = nesDefaultContext();
+   }
+   delete pContext;
+}
+
+void nesSetContext ( NESContext* pContext )
+{
+   if ( pContext )
+   {
+      __nescontext = pContext;
+   }
+   else
+   {
+      __nescontext = nesDefaultContext();
+   }
+}
+
+NESContext* nesGetContext ( void )
+{
+   return __nescontext;
+}
 
 void nesEnableDebug ( void )
 {
-   __nesdebug = true;
+   __nescontext->debug = true;
 }
 
 void nesDisableDebug ( void )
 {
-   __nesdebug = false;
+   __nescontext->debug = false;
+}
+
+// The parentheses keep the core's nesIsDebuggable() macro from expanding here.
+bool (nesIsDebuggable) ( void )
+{
+   return __nescontext->debug;
 }
 
 void nesSetBreakOnKIL ( bool breakOnKIL )
@@ -47,33 +172,218 @@ void nesSetBreakOnKIL ( bool breakOnKIL )
    C6502::BREAKONKIL(breakOnKIL);
 }
 
-static void (*breakpointHook)(void) = NULL;
-
 void nesSetBreakpointHook ( void (*hook)(void) )
 {
-   breakpointHook = hook;
+   __nescontext->breakpointHook = hook;
 }
 
-static void (*audioHook)(void) = NULL;
-
 void nesSetAudioHook ( void (*hook)(void) )
 {
-   audioHook = hook;
+   __nescontext->audioHook = hook;
 }
 
 void nesBreak ( void )
 {
-   if ( breakpointHook )
+   NESContext* pContext = __nescontext;
+   bool        changing = (__neschangingcontext == pContext);
+
+   if ( pContext->breakpointHook )
    {
-      breakpointHook();
+      // Let the debuggers see the NES as it stopped.
+      if ( nesIsDebuggable() )
+      {
+         nesPublishDebuggerSnapshot();
+      }
+
+      // Nothing changes the NES while it's stopped but the debuggers, so let
+      // them bring their snapshots up to date with what they change.
+      if ( changing )
+      {
+         __neschangingcontext = NULL;
+         pContext->changing.unlock();
+      }
+      pContext->breakpointHook();
+      if ( changing )
+      {
+         pContext->changing.lock();
+         __neschangingcontext = pContext;
+      }
    }
 }
 
 void nesBreakAudio ( void )
 {
-   if ( audioHook )
+   if ( __nescontext->audioHook )
+   {
+      __nescontext->audioHook();
+   }
+}
+
+// Copies size of a code/data logger's entries from offset on into a snapshot,
+// or clears them if there's no logger.
+static void publishCodeDataLog ( nesDebuggerLogEntry* pEntry, CCodeDataLogger* pLogger, uint32_t offset, uint32_t size )
+{
+   LoggerInfo* pLogEntry;
+   uint32_t addr;
+
+   for ( addr = 0; addr < size; addr++ )
    {
-      audioHook();
+      if ( pLogger )
+      {
+         pLogEntry = pLogger->GetLogEntry(offset+addr);
+         pEntry[addr].cycle = pLogEntry->cycle;
+         pEntry[addr].type = pLogEntry->type;
+         pEntry[addr].source = pLogEntry->source;
+         pEntry[addr].accessed = (pLogEntry->count != 0);
+      }
+      else
+      {
+         pEntry[addr].cycle = 0;
+         pEntry[addr].type = 0;
+         pEntry[addr].source = 0;
+         pEntry[addr].accessed = 0;
+      }
+   }
+}
+
+static void publishCodeDataLogger ( nesDebuggerSnapshot* pSnapshot )
+{
+   uint32_t addr;
+
+   pSnapshot->logCycle = CCodeDataLogger::GetCurCycle();
+
+   publishCodeDataLog(pSnapshot->cpuLog,C6502::LOGGER(),0,MEM_2KB);
+   publishCodeDataLog(pSnapshot->cpuLog+MEM_2KB,NULL,0,MEM_8KB-MEM_2KB);
+   publishCodeDataLog(pSnapshot->cpuLog+MEM_8KB,C6502::LOGGER(),MEM_8KB,EXRAM_START-MEM_8KB);
+   publishCodeDataLog(pSnapshot->cpuLog+EXRAM_START,CROM::EXRAMLOGGER(),0,MEM_1KB);
+   publishCodeDataLog(pSnapshot->cpuLog+SRAM_START,CROM::SRAMLOGGERVIRT(SRAM_START),0,MEM_8KB);
+   for ( addr = MEM_32KB; addr < MEM_64KB; addr += MEM_8KB )
+   {
+      publishCodeDataLog(pSnapshot->cpuLog+addr,CROM::LOGGERVIRT(addr),0,MEM_8KB);
+   }
+   publishCodeDataLog(pSnapshot->ppuLog,CPPU::LOGGER(),0,MEM_16KB);
+}
+
+void nesPublishDebuggerSnapshot ( void )
+{
+   NESContext* pContext = __nescontext;
+   nesDebuggerSnapshot* pSnapshot;
+   CRegisterDatabase* pRegisters = CROM::REGISTERS();
+   uint32_t users;
+   uint32_t edits;
+   uint32_t addr;
+   int32_t reg;
+   int32_t marker;
+   int32_t idx;
+
+   // The emulator thread publishes the first snapshot, before any other
+   // thread can have acquired one.  Other threads only publish to bring the
+   // one they hold up to date, so they never get here.
+   if ( !pContext->snapshots )
+   {
+      pContext->snapshots = new nesDebuggerSnapshot [ NUM_DEBUGGER_SNAPSHOTS ];
+   }
+
+   // Write over a snapshot nobody is reading and that isn't the latest.  If
+   // they're all being read the readers keep what they have until the next
+   // snapshot is published.
+   for ( idx = 0; idx < NUM_DEBUGGER_SNAPSHOTS; idx++ )
+   {
+      users = 0;
+      if ( pContext->snapshotUsers[idx].compare_exchange_strong(users,DEBUGGER_SNAPSHOT_WRITING) )
+      {
+         if ( pContext->snapshotLatest != idx )
+         {
+            break;
+         }
+         pContext->snapshotUsers[idx] -= DEBUGGER_SNAPSHOT_WRITING;
+      }
+   }
+   if ( idx == NUM_DEBUGGER_SNAPSHOTS )
+   {
+      return;
+   }
+
+   edits = pContext->edits;
+   pSnapshot = pContext->snapshots+idx;
+
+   nesGetCpuSnapshot(&pSnapshot->cpu);
+   nesGetPpuSnapshot(&pSnapshot->ppu);
+   nesGetApuSnapshot(&pSnapshot->apu);
+   for ( addr = 0; addr < MEM_8KB; addr++ )
+   {
+      pSnapshot->sram[addr] = CROM::SRAMVIRT(SRAM_START+addr);
+   }
+   for ( addr = 0; addr < MEM_1KB; addr++ )
+   {
+      pSnapshot->exram[addr] = CROM::EXRAM(EXRAM_START+addr);
+   }
+   for ( reg = 0; pRegisters && (reg < pRegisters->GetNumRegisters()) && (reg < NUM_DEBUGGER_SNAPSHOT_MAPPER_REGS); reg++ )
+   {
+      pSnapshot->mapper[reg] = MAPPERFUNC->debuginfo(pRegisters->GetRegister(reg)->GetAddr());
+   }
+   for ( marker = 0; marker < MAX_MARKER_SETS; marker++ )
+   {
+      pSnapshot->markers[marker] = *(C6502::MARKERS()->GetMarker(marker));
+   }
+   publishCodeDataLogger(pSnapshot);
+   pSnapshot->sequence = ++pContext->snapshotSequence;
+   pContext->snapshotEdits[idx] = edits;
+
+   // Readers only take the latest, so it has to be whole before it is.
+   pContext->snapshotLatest = idx;
+   pContext->snapshotUsers[idx] -= DEBUGGER_SNAPSHOT_WRITING;
+}
+
+const nesDebuggerSnapshot* nesAcquireDebuggerSnapshot ( void )
+{
+   NESContext* pContext = __nescontext;
+   int32_t latest;
+
+   // Nothing to do if the thread already has the latest.
+   if ( (__nessnapshotcontext == pContext) &&
+        (pContext->snapshotLatest == __nessnapshot) )
+   {
+      return pContext->snapshots+__nessnapshot;
+   }
+
+   nesReleaseDebuggerSnapshot();
+
+   do
+   {
+      latest = pContext->snapshotLatest;
+      if ( latest < 0 )
+      {
+         return NULL;
+      }
+
+      // Claim it, then check it wasn't replaced and written over meanwhile.
+      pContext->snapshotUsers[latest]++;
+      if ( pContext->snapshotLatest == latest )
+      {
+         break;
+      }
+      pContext->snapshotUsers[latest]--;
+   } while ( 1 );
+
+   __nessnapshotcontext = pContext;
+   __nessnapshot = latest;
+
+   return pContext->snapshots+latest;
+}
+
+const nesDebuggerSnapshot* nesGetDebuggerSnapshot ( void )
+{
+   return debuggerSnapshot();
+}
+
+void nesReleaseDebuggerSnapshot ( void )
+{
+   if ( __nessnapshotcontext )
+   {
+      __nessnapshotcontext->snapshotUsers[__nessnapshot]--;
+      __nessnapshotcontext = NULL;
+      __nessnapshot = -1;
    }
 }
 
@@ -189,6 +499,22 @@ CMarker* nesGetExecutionMarkerDatabase ( void )
    return C6502::MARKERS();
 }
 
+const MarkerSetInfo* nesGetExecutionMarker ( int32_t marker )
+{
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->markers+marker;
+   }
+   return C6502::MARKERS()->GetMarker(marker);
+}
+
+CCallProfiler* nesGetCallProfilerDatabase ( void )
+{
+   return C6502::PROFILER();
+}
+
 void nesClearCodeDataLoggerDatabases ( void )
 {
    unsigned int addr;
@@ -396,11 +722,29 @@ void nesSetOpcodeMask ( uint32_t addr, uint8_t mask )
 
 void nesSetTVOut ( int8_t* tv )
 {
+   CPPU::TVQUEUE ( NULL, NULL, NULL );
    CPPU::TV ( tv );
 }
 
+void nesSetTVOutQueue ( int8_t* tv0, int8_t* tv1, int8_t* tv2 )
+{
+   CPPU::TVQUEUE ( tv0, tv1, tv2 );
+}
+
+int8_t* nesAcquireTVOut ( void )
+{
+   return CPPU::ACQUIRETV();
+}
+
+void nesGetVideoInformation ( nesVideoInfo* pInfo )
+{
+   CPPU::VIDEOINFORMATION(pInfo);
+}
+
 void nesUnloadROM ( void )
 {
+   NESChange change ( true );
+
    CROM::ClearPRGBanks ();
    CROM::ClearCHRBanks ();
    CROM::RESET(0);
@@ -418,6 +762,8 @@ void nesLoadCHRROMBank ( uint32_t bank, uint8_t* bankData )
 
 void nesLoadROM ( void )
 {
+   NESChange change ( true );
+
    CROM::DoneLoadingBanks();
 }
 
@@ -426,6 +772,83 @@ bool nesROMIsLoaded ( void )
    return ( (CROM::NUMPRGROMBANKS()>0)?true:false );
 }
 
+uint32_t nesGetStateSize ( void )
+{
+   CNESStateWriter writer ( NULL, 0, false );
+
+   CNES::SAVESTATE ( writer );
+
+   return writer.FINISH();
+}
+
+uint32_t nesSaveState ( uint8_t* buffer, uint32_t size, bool compress )
+{
+   CNESStateWriter writer ( buffer, size, compress );
+
+   CNES::SAVESTATE ( writer );
+
+   return writer.FINISH();
+}
+
+bool nesLoadState ( const uint8_t* buffer, uint32_t size )
+{
+   NESChange change ( true );
+   CNESStateReader reader ( buffer, size );
+   uint8_t* backup;
+   uint32_t backupSize;
+   bool     loaded;
+
+   if ( !reader.VALID() )
+   {
+      return false;
+   }
+
+   // A state that fails part way through loading leaves the NES in a mess,
+   // so keep the current state to go back to.
+   backupSize = nesGetStateSize();
+   backup = new uint8_t[backupSize];
+   backupSize = nesSaveState(backup,backupSize,false);
+
+   loaded = CNES::LOADSTATE(reader);
+   if ( !loaded )
+   {
+      CNESStateReader restore ( backup, backupSize );
+
+      CNES::LOADSTATE ( restore );
+   }
+   else
+   {
+      // The rewind history doesn't lead up to the loaded state.
+      CNESRewind::CLEAR ();
+   }
+
+   delete [] backup;
+
+   return loaded;
+}
+
+bool nesRewindEnable ( uint32_t arenaSize, uint32_t interval )
+{
+   return CNESRewind::ENABLE(arenaSize,interval);
+}
+
+void nesRewindDisable ( void )
+{
+   CNESRewind::DISABLE();
+}
+
+bool nesRewindStepBack ( uint32_t frames )
+{
+   NESChange change ( true );
+
+   return CNESRewind::STEPBACK(frames);
+}
+
+void nesRewindGetInformation ( nesRewindInfo* pInfo )
+{
+   CNESRewind::INFORMATION(pInfo);
+}
+
 void nesSetHorizontalMirroring ( void )
 {
    CPPU::MIRRORHORIZ();
@@ -443,16 +866,22 @@ void nesSetFourScreen ( void )
 
 void nesReset ( bool soft )
 {
+   NESChange change ( true );
+
    CNES::RESET(CROM::MAPPER(),soft);
 }
 
 void nesResetInitial ( uint32_t mapper )
 {
+   NESChange change ( true );
+
    CNES::RESET(mapper,false);
 }
 
 void nesRun ( uint32_t* joypads )
 {
+   NESChange change ( false );
+
    CNES::RUN(joypads);
 }
 
@@ -463,16 +892,42 @@ uint8_t* nesGetAudioSamples ( uint16_t samples )
 
 int32_t nesGetAudioSamplesAvailable ( void )
 {
-   return apuDataAvailable;
+   return CAPU::SAMPLESAVAILABLE();
 }
 
 void nesClearAudioSamplesAvailable ( void )
 {
-   apuDataAvailable = 0;
+   CAPU::CLEARSAMPLESAVAILABLE();
+}
+
+int32_t nesReadAudioSamples ( int16_t* buffer, int32_t samples )
+{
+   return CAPU::READ(buffer,samples);
+}
+
+void nesSetAudioLatency ( int32_t samples )
+{
+   CAPU::LATENCY(samples);
+}
+
+void nesSetAudioSampleRate ( int32_t rate )
+{
+   CAPU::SAMPLERATE(rate);
+}
+
+void nesGetAudioInformation ( nesAudioInfo* pInfo )
+{
+   CAPU::INFORMATION(pInfo);
 }
 
 uint32_t nesGetCPUCycle ( void )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->cpu.cycle;
+   }
    return C6502::_CYCLES();
 }
 
@@ -535,6 +990,8 @@ uint32_t nesGetCPUProgramCounterOfLastSync( void )
 
 void nesSetCPURegister ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
+
    switch ( addr )
    {
    case CPU_PC:
@@ -569,6 +1026,27 @@ void nesSetCPURegister ( uint32_t addr, uint32_t data )
 
 uint32_t nesGetCPURegister( uint32_t addr )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      switch ( addr )
+      {
+      case CPU_PC:
+         return pSnapshot->cpu.pc;
+      case CPU_SP:
+         return 0x100|pSnapshot->cpu.sp;
+      case CPU_A:
+         return pSnapshot->cpu.a;
+      case CPU_X:
+         return pSnapshot->cpu.x;
+      case CPU_Y:
+         return pSnapshot->cpu.y;
+      case CPU_F:
+         return pSnapshot->cpu.f;
+      }
+   }
+
    switch ( addr )
    {
    case CPU_PC:
@@ -674,16 +1152,31 @@ void nesSetCPUFlagCarry ( uint32_t set )
 
 uint32_t nesGetPPUMemory ( uint32_t addr )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->ppu.memory[addr&0x3FFF];
+   }
    return CPPU::_MEM(addr);
 }
 
 void nesSetPPUMemory ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
    CPPU::_MEM(addr,data);
 }
 
 uint32_t nesGetCPUMemory ( uint32_t addr )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   // Only the RAM is in the snapshot; the rest is ROM or goes through the
+   // mapper, which decides what's there.
+   if ( pSnapshot && (addr < 0x2000) )
+   {
+      return pSnapshot->cpu.memory[addr&MASK_2KB];
+   }
    return C6502::_MEM(addr);
 }
 
@@ -694,6 +1187,7 @@ uint8_t* nesGetCPUMemoryPtr ( void )
 
 void nesSetCPUMemory ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
    C6502::_MEM(addr,data);
 }
 
@@ -704,16 +1198,29 @@ uint8_t nesGetMemory ( uint32_t addr )
 
 uint32_t nesGetPPUCycle ( void )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->ppu.cycle;
+   }
    return CPPU::_CYCLES();
 }
 
 uint32_t nesGetPPURegister ( uint32_t addr )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->ppu.reg[addr&0x0007];
+   }
    return CPPU::_PPU(addr);
 }
 
 void nesSetPPURegister ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
    CPPU::_PPU(addr,data);
 }
 
@@ -756,11 +1263,18 @@ uint32_t nesGetAPUCycle ( void )
 
 uint32_t nesGetAPURegister ( uint32_t addr )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->apu.reg[addr&0x1F];
+   }
    return CAPU::_APU(addr);
 }
 
 void nesSetAPURegister ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
    CAPU::_APU(addr,data);
 }
 
@@ -836,38 +1350,72 @@ uint8_t nesGetMapper ( void )
    return CROM::MAPPER();
 }
 
-uint32_t nesMapperLowRead ( uint32_t addr )
+// The snapshot's value of a cartridge register, or the mapper's if the
+// thread has no snapshot.
+static uint32_t mapperRegister ( uint32_t addr )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+   CRegisterDatabase* pRegisters = CROM::REGISTERS();
+   int32_t reg;
+
+   if ( pSnapshot && pRegisters )
+   {
+      reg = pRegisters->GetRegisterAt(addr);
+      if ( (reg >= 0) && (reg < NUM_DEBUGGER_SNAPSHOT_MAPPER_REGS) )
+      {
+         return pSnapshot->mapper[reg];
+      }
+   }
    return MAPPERFUNC->debuginfo(addr);
 }
 
+uint32_t nesMapperLowRead ( uint32_t addr )
+{
+   return mapperRegister(addr);
+}
+
 void nesMapperLowWrite ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
    MAPPERFUNC->lowwrite(addr,data);
 }
 
 uint32_t nesMapperHighRead ( uint32_t addr )
 {
-   return MAPPERFUNC->debuginfo(addr);
+   return mapperRegister(addr);
 }
 
 void nesMapperHighWrite ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
    MAPPERFUNC->highwrite(addr,data);
 }
 
 uint32_t nesGetPPUOAM ( uint32_t addr )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->ppu.oamMemory[addr&0xFF];
+   }
    return CPPU::_OAM(addr&3,addr>>2);
 }
 
 void nesSetPPUOAM ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
    CPPU::_OAM(addr&3,addr>>2,data);
 }
 
 uint32_t nesGetPPUFrame ( void )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->ppu.frame;
+   }
    return CPPU::_FRAME();
 }
 
@@ -913,11 +1461,18 @@ uint32_t nesGetPRGROMData ( uint32_t addr )
 
 uint32_t nesGetCHRMEMData ( uint32_t addr )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->ppu.memory[addr&MASK_8KB];
+   }
    return CROM::CHRMEM(addr);
 }
 
 void nesSetCHRMEMData ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
    CROM::CHRMEM(addr,data);
 }
 
@@ -928,11 +1483,18 @@ uint32_t nesGetSRAMAbsoluteAddress ( uint32_t addr )
 
 uint32_t nesGetSRAMDataVirtual ( uint32_t addr )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->sram[(addr-SRAM_START)&MASK_8KB];
+   }
    return CROM::SRAMVIRT(addr);
 }
 
 void nesSetSRAMDataVirtual ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
    CROM::SRAMVIRT(addr,data);
 }
 
@@ -963,11 +1525,18 @@ uint32_t nesGetEXRAMAbsoluteAddress ( uint32_t addr )
 
 uint32_t nesGetEXRAMData ( uint32_t addr )
 {
+   const nesDebuggerSnapshot* pSnapshot = debuggerSnapshot();
+
+   if ( pSnapshot )
+   {
+      return pSnapshot->exram[(addr-EXRAM_START)&MASK_1KB];
+   }
    return CROM::EXRAM(addr);
 }
 
 void nesSetEXRAMData ( uint32_t addr, uint32_t data )
 {
+   debuggerEdit();
    CROM::EXRAM(addr,data);
 }
 
@@ -1103,7 +1672,7 @@ void nesGetCpuSnapshot(NESCpuStateSnapshot* pSnapshot)
 void nesGetPpuSnapshot(PpuStateSnapshot* pSnapshot)
 {
    int idx;
-   int x,y;
+   int x;
    pSnapshot->frame = CPPU::_FRAME();
    pSnapshot->cycle = CPPU::_CYCLES();
    for ( idx = 0; idx < NUM_PPU_REGS; idx++ )
@@ -1118,17 +1687,16 @@ void nesGetPpuSnapshot(PpuStateSnapshot* pSnapshot)
    {
       *(pSnapshot->paletteMemory+idx) = CPPU::_PALETTE(idx);
    }
-   for ( idx = 0; idx < MEM_32KB; idx++ )
+   // The PPU only decodes 14 address bits; the top half is a mirror.
+   for ( idx = 0; idx < MEM_16KB; idx++ )
    {
       *(pSnapshot->memory+idx) = CPPU::_MEM(idx);
    }
-   for ( y = 0; y < 240; y++ )
+   memcpy(pSnapshot->memory+MEM_16KB,pSnapshot->memory,MEM_16KB);
+   for ( x = 0; x < 256; x++ )
    {
-      for ( x = 0; x < 256; x++ )
-      {
-         *(*(pSnapshot->xOffset+x)+y) = CPPU::_SCROLLX(x,y);
-         *(*(pSnapshot->yOffset+x)+y) = CPPU::_SCROLLY(x,y);
-      }
+      memcpy(*(pSnapshot->xOffset+x),CPPU::_SCROLLXCOLUMN(x),sizeof(*pSnapshot->xOffset));
+      memcpy(*(pSnapshot->yOffset+x),CPPU::_SCROLLYCOLUMN(x),sizeof(*pSnapshot->yOffset));
    }
 }
 
@@ -1,6 +1,10 @@
 #ifndef NES_EMULATOR_CORE_H
 #define NES_EMULATOR_CORE_H
 
+// The breakpoint database is a C++ header; it can't go in the extern "C"
+// block.
+#include "cbreakpointinfo.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -12,7 +16,7 @@ extern "C" {
 #include "cmemorydata.h"
 #include "cregisterdata.h"
 #include "cmarker.h"
-#include "cbreakpointinfo.h"
+#include "ccallprofiler.h"
 
 // Common enumerations for emulated items.
 typedef enum
@@ -136,6 +140,7 @@ enum
 
 #define NUM_ROM_BANKS 128
 #define NUM_CHR_BANKS 256+32 // 32 extra banks for CHR-ROM+CHR-RAM mappers like N106.
+#define NUM_CHRRAM_BANKS 32 // CHR-RAM carts use the first banks; none have more than 32KB.
 #define NUM_SRAM_BANKS 8
 
 #define PATTERN_SIZE 8
@@ -472,8 +477,9 @@ char* nesGetVersion();
 // The following interfaces are to be used by a UI to interact with the emulation
 // core and perform the necessary steps to emulate a NES game.  Those steps are:
 // 1. Set the NES system mode to MODE_NTSC or MODE_PAL using nesSetSystemMode().
-// 2. Provide a 256x256x3-byte chunk of memory to the emulator core for it to
-//    render the NES TV surface onto, using nesSetTVOut().
+// 2. Provide a 256x256x4-byte chunk of memory to the emulator core for it to
+//    render the NES TV surface onto, using nesSetTVOut(), or three of them to be
+//    used as a frame queue, using nesSetTVOutQueue() (see below).
 // 3. Clear any emulation state by using nesUnloadROM().
 // 4. Pass 16KB PRG-ROM banks in order and 8KB CHR-ROM banks in order to the emulation
 //    core by using nesLoadPRGROMBank() and nesLoadCHRROMBank() respectively.  If no
@@ -489,11 +495,30 @@ char* nesGetVersion();
 // 8. Run a PPU (video) frame's worth of NES emulation, which generates a full
 //    rendered video frame and an appropriate amount of audio data, by using
 //    nesRun().  Pass in collected joypad input data.
-// 9. If the emulator supports sound output, the number of audio samples available
-//    can be retrieved by using nesGetAudioSamplesAvailable().  A pointer to the
-//    next buffer of audio samples to play can be retrieved using nesGetAudioSamples().
-//    Once retrieved, the number of available audio samples should be reset using
-//    nesClearAudioSamplesAvailable.
+// 9. If the emulator supports sound output, the audio callback should fetch the
+//    samples to play by using nesReadAudioSamples().  The samples are passed from
+//    the emulator thread to the audio thread through a lock-free ring, so the
+//    callback never has to wait on the emulator.  Set a target fill level with
+//    nesSetAudioLatency() and the emulator will call the audio hook (see
+//    nesSetAudioHook()) whenever the ring holds that many samples, so the hook
+//    can pace the emulator to the audio device; the output sample rate is also
+//    adjusted by up to half a percent to keep the ring near that level.
+//    nesGetAudioSamplesAvailable(), nesGetAudioSamples() and
+//    nesClearAudioSamplesAvailable() are the older interface to the same ring.
+
+// Emulation contexts.
+// Each NESContext is a complete, independent emulated NES.  Every other
+// interface in this file operates on the context bound to the calling thread.
+// Threads start out bound to a default context that always exists, so a UI that
+// only ever emulates one NES need not use these interfaces at all.  To run
+// several NESes at once, create a context per NES and bind it with nesSetContext()
+// in the thread that drives it.  A context must not be run by two threads at once.
+// nesSetContext(NULL) rebinds the calling thread to the default context.
+typedef struct NESContext NESContext;
+NESContext* nesCreateContext ( void );
+void nesDestroyContext ( NESContext* pContext );
+void nesSetContext ( NESContext* pContext );
+NESContext* nesGetContext ( void );
 
 // Emulation interfaces.
 void nesSetSystemMode ( uint32_t mode );
@@ -512,14 +537,95 @@ void nesRun ( uint32_t* joypads );
 int32_t nesGetAudioSamplesAvailable ( void );
 void nesClearAudioSamplesAvailable ( void );
 uint8_t* nesGetAudioSamples ( uint16_t samples );
+
+// Audio output interfaces.
+// nesReadAudioSamples() fills buffer with the requested number of signed 16-bit mono
+// samples and returns how many of them came from the emulator.
+// If the emulator hasn't produced enough the rest of buffer is filled with the
+// last sample faded towards silence.  Call it from one thread only, with the same
+// emulation context bound as the thread running the emulator (the default context
+// unless nesSetContext() is used).  nesSetAudioLatency() sets the fill level, in
+// samples, the ring is kept at; 0 restores the default of APU_BUFFER_PRERENDER
+// with no rate control.  nesSetAudioSampleRate() changes the output sample rate
+// from SDL_SAMPLE_RATE.  The output is synthesized band-limited at whatever rate
+// is set, so it needs no further filtering or resampling.
+typedef struct _nesAudioInfo
+{
+   int32_t  bufferSize;       // Samples the ring can hold.
+   int32_t  fill;             // Samples in the ring now.
+   int32_t  fillAverage;      // Samples in the ring at recent reads, averaged.
+   int32_t  latency;          // Target fill, or 0 if there is none.
+   int32_t  rateAdjust;       // Current output rate adjustment, parts per million.
+   uint32_t underruns;        // Reads the emulator couldn't fill while running.
+   uint32_t overruns;         // Samples dropped because the ring was full.
+} nesAudioInfo;
+int32_t nesReadAudioSamples ( int16_t* buffer, int32_t samples );
+void nesSetAudioLatency ( int32_t samples );
+void nesSetAudioSampleRate ( int32_t rate );
+void nesGetAudioInformation ( nesAudioInfo* pInfo );
+
+// Frame queue interfaces.
+// With a single surface the PPU draws each frame over the last while the UI may
+// be showing it.  Given three surfaces with nesSetTVOutQueue() the PPU instead
+// draws into one the UI isn't using and publishes it when the frame is done.
+// nesAcquireTVOut() hands the UI the most recently published frame, which is
+// left alone by the PPU until the UI acquires another, so the UI can show it
+// without copying it.  nesGetTVOut() still returns the surface the PPU is
+// drawing, or has just finished drawing when between frames, which is what
+// the debuggers want.  nesSetTVOut() goes back to a single surface.
+typedef struct _nesVideoInfo
+{
+   uint32_t frames;           // Frames published.
+   uint32_t dropped;          // Frames published over before the UI acquired them.
+   uint32_t duplicated;       // Acquires with no new frame, showing the last one again.
+} nesVideoInfo;
+void nesSetTVOutQueue ( int8_t* tv0, int8_t* tv1, int8_t* tv2 );
+int8_t* nesAcquireTVOut ( void );
+void nesGetVideoInformation ( nesVideoInfo* pInfo );
 void nesSetControllerType ( int32_t port, int32_t type );
 void nesSetControllerScreenPosition ( int32_t port, int32_t px, int32_t py, int32_t wx1, int32_t wy1, int32_t wx2, int32_t wy2 );
 void nesSetControllerSpecial ( int32_t port, int32_t special );
 bool nesROMIsLoaded ( void );
 
+// Save state interfaces.
+// nesSaveState() writes the complete state of the emulated NES into buffer and
+// returns the number of bytes written, or 0 if buffer is too small.  A buffer of
+// nesGetStateSize() bytes is always big enough.  If compress is set the larger
+// memories (RAM, VRAM, SRAM, CHR-RAM) are run-length packed.  nesLoadState() puts
+// the NES back into a state saved while the same ROM was loaded; if the state
+// cannot be loaded the NES is left as it was and false is returned.  The cartridge
+// ROM, debugger databases and any audio not yet played are not part of a state.
+uint32_t nesGetStateSize ( void );
+uint32_t nesSaveState ( uint8_t* buffer, uint32_t size, bool compress );
+bool nesLoadState ( const uint8_t* buffer, uint32_t size );
+
+// Rewind interfaces.
+// nesRewindEnable() preallocates arenaSize bytes of history and from then on a
+// snapshot of the NES is taken every interval frames.  Snapshots are stored as
+// the difference from the next one, so a typical frame costs a few hundred bytes
+// to a few KB.  When the arena is full the oldest snapshots are dropped.
+// nesRewindStepBack() puts the emulation back the given number of frames; it
+// must only be called between frames, never while stopped at a breakpoint in the
+// middle of one.  It returns false if the history doesn't go back that far.
+// The history is cleared by a reset or nesLoadState().
+typedef struct _nesRewindInfo
+{
+   uint32_t arenaSize;        // Bytes allocated for the history.
+   uint32_t arenaUsed;        // Bytes the history is using.
+   uint32_t stateSize;        // Bytes in a whole snapshot.
+   uint32_t interval;         // Frames between snapshots.
+   uint32_t snapshots;        // Snapshots in the history.
+   uint32_t framesAvailable;  // Frames nesRewindStepBack() can go back.
+   uint32_t lastSnapshotSize; // Bytes of history the last snapshot took.
+   uint32_t captureTime;      // Average nanoseconds spent taking a snapshot.
+} nesRewindInfo;
+bool nesRewindEnable ( uint32_t arenaSize, uint32_t interval );
+void nesRewindDisable ( void );
+bool nesRewindStepBack ( uint32_t frames );
+void nesRewindGetInformation ( nesRewindInfo* pInfo );
+
 // Internal debug interfaces.
-extern bool __nesdebug;
-#define nesIsDebuggable() ( __nesdebug )
+bool nesIsDebuggable ( void );
 void nesBreak ( void );
 void nesBreakAudio ( void );
 
@@ -548,6 +654,8 @@ CRegisterDatabase* nesGetApuRegisterDatabase ( void );
 CRegisterDatabase* nesGetCartridgeRegisterDatabase ( void );
 
 CMarker* nesGetExecutionMarkerDatabase ( void );
+const MarkerSetInfo* nesGetExecutionMarker ( int32_t marker );
+CCallProfiler* nesGetCallProfilerDatabase ( void );
 
 // General debug interfaces.
 void nesEnableDebug ( void );
@@ -749,6 +857,70 @@ typedef struct
 
 void nesGetNesSnapshot(NesStateSnapshot* pSnapshot);
 
+// Debugger snapshot interfaces.
+// The debuggers run on other threads than the emulator, so reading the NES while
+// it runs gives them views torn across a frame.  Instead the emulator thread
+// publishes a snapshot of the NES with nesPublishDebuggerSnapshot() wherever the
+// debuggers are to be updated, at the end of a frame or when stopped.  nesBreak()
+// publishes one itself before calling the breakpoint hook.  Published snapshots
+// are never changed; a few are kept so publishing never waits on a reader.
+//
+// A thread showing the NES takes the most recently published snapshot with
+// nesAcquireDebuggerSnapshot(), which lets go of the one it had before, and
+// nesGetDebuggerSnapshot() returns it again.  Until the thread takes another the
+// getters the register and memory databases use (nesGetCPUMemory,
+// nesGetPPURegister, nesMapperHighRead and the like) read the snapshot on that
+// thread instead of the NES, so everything it shows is from the same moment.
+// Threads that never take one, such as the emulator thread, see the NES itself.
+// The code/data loggers and execution markers are in the snapshot too, for the
+// inspectors that show them.
+//
+// Running a frame, resetting, loading a ROM or state and stepping back all hold
+// the context while they change the NES; nesBreak() lets go of it while the
+// breakpoint hook runs.  A thread whose snapshot is behind changes made outside
+// of a frame, be they through those databases' setters or a reset or load, has
+// it brought up to date the next time it reads one, as long as nothing holds
+// the context then.  While a frame is running it keeps what it has until the
+// emulator thread publishes another.
+//
+// A snapshot is only written over once no thread holds it, so there must be more
+// snapshots than threads that hold one at a time or publishing can be skipped.
+#define NUM_DEBUGGER_SNAPSHOTS 8
+#define NUM_DEBUGGER_SNAPSHOT_MAPPER_REGS 64
+
+typedef struct
+{
+   uint32_t cycle;
+   int8_t type;
+   int8_t source;
+   // Whether it has been accessed since the logger was last cleared.
+   uint8_t accessed;
+} nesDebuggerLogEntry;
+
+typedef struct
+{
+   // Goes up by one with every snapshot published.
+   uint32_t sequence;
+   NESCpuStateSnapshot cpu;
+   PpuStateSnapshot ppu;
+   ApuStateSnapshot apu;
+   uint8_t sram[MEM_8KB];
+   uint8_t exram[MEM_1KB];
+   // The cartridge register database's registers, in its order.
+   uint32_t mapper[NUM_DEBUGGER_SNAPSHOT_MAPPER_REGS];
+   MarkerSetInfo markers[MAX_MARKER_SETS];
+   // The code/data logger entries for what the CPU sees at each address,
+   // with the RAM mirrors left out, and for the PPU's address space.
+   uint32_t logCycle;
+   nesDebuggerLogEntry cpuLog[MEM_64KB];
+   nesDebuggerLogEntry ppuLog[MEM_16KB];
+} nesDebuggerSnapshot;
+
+void nesPublishDebuggerSnapshot ( void );
+const nesDebuggerSnapshot* nesAcquireDebuggerSnapshot ( void );
+const nesDebuggerSnapshot* nesGetDebuggerSnapshot ( void );
+void nesReleaseDebuggerSnapshot ( void );
+
 // Mapper-specific debug interfaces
 typedef struct _nesMapper001Info
 {